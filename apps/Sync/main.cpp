@@ -35,11 +35,69 @@
 
 #include <ghoul/fmt.h>
 #include <ghoul/ghoul.h>
+#include <ghoul/cmdparser/commandlineparser.h>
+#include <ghoul/cmdparser/singlecommand.h>
 #include <ghoul/filesystem/filesystem.h>
 #include <ghoul/logging/logmanager.h>
 #include <ghoul/logging/consolelog.h>
 
-int main(int, char**) {
+#ifdef OPENSPACE_MODULE_SYNC_ENABLED
+#include <modules/sync/contentstore.h>
+#include <modules/sync/syncmodule.h>
+#endif // OPENSPACE_MODULE_SYNC_ENABLED
+
+namespace {
+#ifdef OPENSPACE_MODULE_SYNC_ENABLED
+    // Performs the requested operations on the content store without any network access
+    void maintainContentStore(openspace::ContentStore& store,
+                              const std::string& importFolder,
+                              const std::string& deduplicateFolder, bool verify)
+    {
+        using namespace openspace;
+
+        auto report = [](const std::string& folder, ContentStore::ImportResult r) {
+            LINFOC(
+                "Sync",
+                fmt::format(
+                    "Imported {}: {} files, {} new, {} duplicate bytes, {} failed",
+                    folder, r.nFiles, r.nNewObjects, r.nDuplicateBytes, r.nFailed
+                )
+            );
+        };
+
+        if (!importFolder.empty()) {
+            report(
+                importFolder,
+                store.importDirectory(
+                    absPath(importFolder),
+                    ContentStore::ReplaceWithView::No
+                )
+            );
+        }
+        if (!deduplicateFolder.empty()) {
+            report(
+                deduplicateFolder,
+                store.importDirectory(
+                    absPath(deduplicateFolder),
+                    ContentStore::ReplaceWithView::Yes
+                )
+            );
+        }
+        if (verify) {
+            ContentStore::VerifyResult r = store.verifyAll();
+            LINFOC(
+                "Sync",
+                fmt::format(
+                    "Verified {} objects, removed {} corrupted objects",
+                    r.nObjects, r.nCorrupt
+                )
+            );
+        }
+    }
+#endif // OPENSPACE_MODULE_SYNC_ENABLED
+} // namespace
+
+int main(int argc, char** argv) {
     using namespace openspace;
 
     ghoul::initialize();
@@ -48,6 +106,62 @@ int main(int, char**) {
     global::configuration = configuration::loadConfigurationFromFile(configFile);
     global::openSpaceEngine.initialize();
 
+    ghoul::cmdparser::CommandlineParser commandlineParser(
+        "OpenSpace Sync",
+        ghoul::cmdparser::CommandlineParser::AllowUnknownCommands::Yes
+    );
+
+    std::string importFolder;
+    commandlineParser.addCommand(
+        std::make_unique<ghoul::cmdparser::SingleCommand<std::string>>(
+            importFolder,
+            "--import",
+            "-i",
+            "Copies all files in the provided folder into the content store without "
+            "downloading anything, for example to pre-populate the store from removable "
+            "media"
+        )
+    );
+    std::string deduplicateFolder;
+    commandlineParser.addCommand(
+        std::make_unique<ghoul::cmdparser::SingleCommand<std::string>>(
+            deduplicateFolder,
+            "--deduplicate",
+            "-d",
+            "Adds all files in the provided folder to the content store and replaces them "
+            "with links to the stored files. Use this on an existing synchronization "
+            "folder to deduplicate it"
+        )
+    );
+    bool verify = false;
+    commandlineParser.addCommand(
+        std::make_unique<ghoul::cmdparser::SingleCommandZeroArguments>(
+            verify,
+            "--verify",
+            "-v",
+            "Verifies the integrity of all files in the content store and removes the "
+            "ones that are corrupted"
+        )
+    );
+    commandlineParser.setCommandLine({ argv, argv + argc });
+    commandlineParser.execute();
+
+    if (!importFolder.empty() || !deduplicateFolder.empty() || verify) {
+#ifdef OPENSPACE_MODULE_SYNC_ENABLED
+        SyncModule* module = global::moduleEngine->module<SyncModule>();
+        ContentStore* store = module->contentStore();
+        if (!store) {
+            LERRORC("Sync", "The content store is disabled in the configuration");
+            return 1;
+        }
+        maintainContentStore(*store, importFolder, deduplicateFolder, verify);
+        return 0;
+#else // ^^^ OPENSPACE_MODULE_SYNC_ENABLED / !OPENSPACE_MODULE_SYNC_ENABLED vvv
+        LERRORC("Sync", "The content store requires the Sync module");
+        return 1;
+#endif // OPENSPACE_MODULE_SYNC_ENABLED
+    }
+
 
     TaskLoader taskLoader;
     std::vector<std::unique_ptr<Task>> tasks = taskLoader.tasksFromFile(
@@ -22,8 +22,10 @@
  * OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                                         *
  ****************************************************************************************/
 
+#include <algorithm>
 #include <iostream>
 #include <string>
+#include <thread>
 #include <ghoul/glm.h>
 
 #include <ghoul/ghoul.h>
@@ -45,6 +47,7 @@
 #include <openspace/rendering/dashboarditem.h>
 #include <openspace/util/progressbar.h>
 #include <openspace/engine/openspaceengine.h>
+#include <openspace/util/taskgraph.h>
 #include <openspace/util/taskloader.h>
 #include <openspace/util/factorymanager.h>
 #include <openspace/util/resourcesynchronization.h>
@@ -62,32 +65,48 @@ namespace {
     const std::string _loggerCat = "TaskRunner Main";
 }
 
-void performTasks(const std::string& path) {
+void performTasks(const std::string& path, unsigned int nThreads) {
     using namespace openspace;
 
     TaskLoader taskLoader;
-    std::vector<std::unique_ptr<Task>> tasks = taskLoader.tasksFromFile(path);
+    TaskGraph tasks = taskLoader.taskGraphFromFile(path);
 
-    size_t nTasks = tasks.size();
+    size_t nTasks = tasks.nTasks();
     if (nTasks == 1) {
         LINFO("Task queue has 1 item");
     }
     else {
-        LINFO(fmt::format("Task queue has {} items", tasks.size()));
-    }
-
-    for (size_t i = 0; i < tasks.size(); i++) {
-        Task& task = *tasks[i].get();
         LINFO(fmt::format(
-            "Performing task {} out of {}: {}", i + 1, tasks.size(), task.description()
+            "Task queue has {} items, running up to {} at a time", nTasks, nThreads
         ));
+    }
+
+    std::vector<TaskGraph::Result> results;
+    {
         ProgressBar progressBar(100);
         auto onProgress = [&progressBar](float progress) {
             progressBar.print(static_cast<int>(progress * 100.f));
         };
-        task.perform(onProgress);
+        results = tasks.perform(nThreads, onProgress);
     }
+
     std::cout << "Done performing tasks" << std::endl;
+    for (const TaskGraph::Result& res : results) {
+        std::string status;
+        switch (res.status) {
+            case TaskGraph::Status::Succeeded: status = "Done"; break;
+            case TaskGraph::Status::Failed: status = "Failed"; break;
+            case TaskGraph::Status::Skipped: status = "Skipped"; break;
+        }
+        std::cout << fmt::format(
+            "{:8} {:10.2f} s {:10.1f} MB  {}",
+            status, res.duration.count(),
+            static_cast<double>(res.peakMemory) / (1024.0 * 1024.0), res.description
+        ) << std::endl;
+        if (!res.error.empty()) {
+            std::cout << "    " << res.error << std::endl;
+        }
+    }
 }
 
 int main(int argc, char** argv) {
@@ -150,13 +169,26 @@ int main(int argc, char** argv) {
         )
     );
 
+    int nThreads = 1;
+    commandlineParser.addCommand(
+        std::make_unique<ghoul::cmdparser::SingleCommand<int>>(
+            nThreads,
+            "--threads",
+            "-j",
+            "The maximum number of tasks that are performed at the same time, which is 1 "
+            "by default. Tasks that depend on each other and tasks that are not "
+            "thread-safe are always performed on their own"
+        )
+    );
+
     commandlineParser.setCommandLine({ argv, argv + argc });
     commandlineParser.execute();
 
     //FileSys.setCurrentDirectory(launchDirectory);
 
+    const unsigned int nWorkers = static_cast<unsigned int>(std::max(nThreads, 1));
     if (!tasksPath.empty()) {
-        performTasks(tasksPath);
+        performTasks(tasksPath, nWorkers);
         return 0;
     }
 
@@ -167,7 +199,7 @@ int main(int argc, char** argv) {
 
     std::cout << "TASK > ";
     while (std::cin >> tasksPath) {
-        performTasks(tasksPath);
+        performTasks(tasksPath, nWorkers);
         std::cout << "TASK > ";
     }
 
@@ -304,6 +304,21 @@ TestResult testSpecification(const Documentation& documentation,
 void testSpecificationAndThrow(const Documentation& documentation,
     const ghoul::Dictionary& dictionary, std::string component);
 
+/**
+ * While an object of this class exists, #testSpecificationAndThrow does not test the
+ * dictionaries that are passed to it on the thread that created the object. This must
+ * only be used for dictionaries that are known to have passed the same tests before,
+ * for example the scene graph nodes that are contained in a SceneSnapshot.
+ */
+class SkipSpecificationTests {
+public:
+    SkipSpecificationTests();
+    ~SkipSpecificationTests();
+
+    SkipSpecificationTests(const SkipSpecificationTests&) = delete;
+    SkipSpecificationTests& operator=(const SkipSpecificationTests&) = delete;
+};
+
 } // namespace openspace::documentation
 
 // Make the overload for std::to_string available for the Offense::Reason for easier
@@ -76,6 +76,7 @@ struct Configuration {
     Logging logging;
 
     std::string scriptLog;
+    std::string startupTrace;
 
     struct DocumentationInfo {
         std::string path;
@@ -84,6 +85,7 @@ struct Configuration {
 
     std::string versionCheckUrl;
     bool useMultithreadedInitialization = false;
+    bool useSceneSnapshot = false;
 
     struct LoadingScreen {
         bool isShowingMessages = true;
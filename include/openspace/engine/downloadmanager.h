@@ -99,6 +99,9 @@ public:
     // timeout_secs - timeout in seconds before giving up on download (0 = no timeout)
     // finishedCallback - callback when download finished (happens on different thread)
     // progressCallback - callback for status during (happens on different thread)
+    // If the DownloadManager is synchronous, this function must not be called from one of
+    // the callbacks, as that thread is needed to finish the download. Such a call fails
+    // with an error message instead of blocking
     std::shared_ptr<FileFuture> downloadFile(const std::string& url,
         const std::filesystem::path& file,
         OverrideFile overrideFile = OverrideFile::Yes,
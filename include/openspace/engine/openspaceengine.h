@@ -48,6 +48,7 @@ namespace openspace {
 class AssetManager;
 class LoadingScreen;
 class Scene;
+class StartupTrace;
 
 namespace scripting { struct LuaLibrary; }
 
@@ -128,6 +129,10 @@ public:
     AssetManager& assetManager();
     LoadingScreen* loadingScreen();
 
+    // Returns the trace that records the loading of the assets or nullptr if no assets
+    // are currently being loaded
+    StartupTrace* startupTrace();
+
     void writeDocumentation();
     void createUserDirectoriesIfNecessary();
 
@@ -140,6 +145,7 @@ public:
 private:
     void loadAssets();
     void loadFonts();
+    void writeStartupTrace();
 
     void runGlobalCustomizationScripts();
     void resetPropertyChangeFlagsOfSubowners(openspace::properties::PropertyOwner* po);
@@ -154,6 +160,7 @@ private:
     std::unique_ptr<AssetManager> _assetManager;
     bool _shouldAbortLoading = false;
     std::unique_ptr<LoadingScreen> _loadingScreen;
+    std::unique_ptr<StartupTrace> _startupTrace;
     std::unique_ptr<VersionChecker> _versionChecker;
 
     glm::vec2 _mousePosition = glm::vec2(0.f);
@@ -28,13 +28,18 @@
 #include <openspace/properties/propertyowner.h>
 
 #include <openspace/navigation/keyframenavigator.h>
+#include <openspace/network/camerakeyframecodec.h>
+#include <openspace/properties/optionproperty.h>
 #include <openspace/properties/scalar/boolproperty.h>
 #include <openspace/scripting/lualibrary.h>
+#include <memory>
 #include <vector>
 #include <chrono>
 
 namespace openspace::interaction {
 
+class SessionRecordingWriter;
+
 struct ConversionError : public ghoul::RuntimeError {
     explicit ConversionError(std::string msg);
 };
@@ -50,6 +55,7 @@ public:
     inline static const char HeaderCameraBinary = 'c';
     inline static const char HeaderTimeBinary = 't';
     inline static const char HeaderScriptBinary = 's';
+    inline static const char HeaderCameraCompressedBinary = 'k';
     inline static const std::string FileExtensionBinary = ".osrec";
     inline static const std::string FileExtensionAscii = ".osrectxt";
 
@@ -85,8 +91,11 @@ public:
     };
 
     static const size_t FileHeaderVersionLength = 5;
-    char FileHeaderVersion[FileHeaderVersionLength+1] = "01.00";
-    char TargetConvertVersion[FileHeaderVersionLength+1] = "01.00";
+    char FileHeaderVersion[FileHeaderVersionLength+1] = "01.01";
+    char TargetConvertVersion[FileHeaderVersionLength+1] = "01.01";
+    // Version 01.01 only adds the compressed camera keyframes. Recordings without them
+    // are written as 01.00 so that they can still be played back by older versions
+    char FileHeaderVersionUncompressed[FileHeaderVersionLength+1] = "01.00";
     static const char DataFormatAsciiTag = 'A';
     static const char DataFormatBinaryTag = 'B';
     static const size_t keyframeHeaderSize_bytes = 33;
@@ -180,7 +189,8 @@ public:
 
     /**
      * Used to stop a recording in progress. If open, the recording file will be closed,
-     * and all keyframes deleted from memory.
+     * and all keyframes deleted from memory. This function returns once the recording
+     * file has been written completely.
      */
     void stopRecording();
 
@@ -411,21 +421,37 @@ public:
      * \param times reference to a timestamps structure which contains recorded times
      * \param kf reference to a camera keyframe which contains the camera details
      * \param kfBuffer a buffer temporarily used for preparing data to be written
-     * \param file an ofstream reference to the recording file being written-to
+     * \param file an ostream reference to the recording file being written-to
      */
-    void saveCameraKeyframeBinary(Timestamps& times,
+    static void saveCameraKeyframeBinary(Timestamps& times,
         datamessagestructures::CameraKeyframe& kf, unsigned char* kfBuffer,
-        std::ofstream& file);
+        std::ostream& file);
+
+    /**
+     * Writes a camera keyframe to a binary format recording file using the compact
+     * encoding of the CameraKeyframeEncoder. All camera keyframes of a recording have to
+     * be passed through the same \p encoder in the order in which they are written
+     *
+     * \param times reference to a timestamps structure which contains recorded times
+     * \param kf reference to a camera keyframe which contains the camera details
+     * \param encoder the encoder that holds the state of the previous camera keyframes
+     * \param kfBuffer a buffer temporarily used for preparing data to be written
+     * \param file an ostream reference to the recording file being written-to
+     */
+    static void saveCameraKeyframeCompressed(Timestamps& times,
+        datamessagestructures::CameraKeyframe& kf,
+        datamessagestructures::CameraKeyframeEncoder& encoder, unsigned char* kfBuffer,
+        std::ostream& file);
 
     /**
      * Writes a camera keyframe to an ascii format recording file using a CameraKeyframe
      *
      * \param times reference to a timestamps structure which contains recorded times
      * \param kf reference to a camera keyframe which contains the camera details
-     * \param file an ofstream reference to the recording file being written-to
+     * \param file an ostream reference to the recording file being written-to
      */
-    void saveCameraKeyframeAscii(Timestamps& times,
-        datamessagestructures::CameraKeyframe& kf, std::ofstream& file);
+    static void saveCameraKeyframeAscii(Timestamps& times,
+        datamessagestructures::CameraKeyframe& kf, std::ostream& file);
 
     /**
      * Writes a time keyframe to a binary format recording file using a TimeKeyframe
@@ -433,21 +459,21 @@ public:
      * \param times reference to a timestamps structure which contains recorded times
      * \param kf reference to a time keyframe which contains the time details
      * \param kfBuffer a buffer temporarily used for preparing data to be written
-     * \param file an ofstream reference to the recording file being written-to
+     * \param file an ostream reference to the recording file being written-to
      */
-    void saveTimeKeyframeBinary(Timestamps& times,
+    static void saveTimeKeyframeBinary(Timestamps& times,
         datamessagestructures::TimeKeyframe& kf, unsigned char* kfBuffer,
-        std::ofstream& file);
+        std::ostream& file);
 
     /**
      * Writes a time keyframe to an ascii format recording file using a TimeKeyframe
      *
      * \param times reference to a timestamps structure which contains recorded times
      * \param kf reference to a time keyframe which contains the time details
-     * \param file an ofstream reference to the recording file being written-to
+     * \param file an ostream reference to the recording file being written-to
      */
-    void saveTimeKeyframeAscii(Timestamps& times,
-        datamessagestructures::TimeKeyframe& kf, std::ofstream& file);
+    static void saveTimeKeyframeAscii(Timestamps& times,
+        datamessagestructures::TimeKeyframe& kf, std::ostream& file);
 
     /**
      * Writes a script keyframe to a binary format recording file using a ScriptMessage
@@ -455,21 +481,21 @@ public:
      * \param times reference to a timestamps structure which contains recorded times
      * \param sm reference to a ScriptMessage object which contains the script details
      * \param smBuffer a buffer temporarily used for preparing data to be written
-     * \param file an ofstream reference to the recording file being written-to
+     * \param file an ostream reference to the recording file being written-to
      */
-    void saveScriptKeyframeBinary(Timestamps& times,
+    static void saveScriptKeyframeBinary(Timestamps& times,
         datamessagestructures::ScriptMessage& sm, unsigned char* smBuffer,
-        std::ofstream& file);
+        std::ostream& file);
 
     /**
      * Writes a script keyframe to an ascii format recording file using a ScriptMessage
      *
      * \param times reference to a timestamps structure which contains recorded times
      * \param sm reference to a ScriptMessage which contains the script details
-     * \param file an ofstream reference to the recording file being written-to
+     * \param file an ostream reference to the recording file being written-to
      */
-    void saveScriptKeyframeAscii(Timestamps& times,
-        datamessagestructures::ScriptMessage& sm, std::ofstream& file);
+    static void saveScriptKeyframeAscii(Timestamps& times,
+        datamessagestructures::ScriptMessage& sm, std::ostream& file);
 
     /**
      * Since session recordings only record changes, the initial conditions aren't
@@ -528,9 +554,9 @@ public:
      * Saves a keyframe to an ascii recording file
      *
      * \param entry the ascii string version of the keyframe (any type)
-     * \param file ofstream object to write to
+     * \param file ostream object to write to
      */
-    static void saveKeyframeToFile(std::string entry, std::ofstream& file);
+    static void saveKeyframeToFile(std::string entry, std::ostream& file);
 
     /**
      * Checks if a specified recording file ends with a particular file extension
@@ -592,6 +618,16 @@ public:
      */
     virtual std::string targetFileFormatVersion();
 
+    /*
+     * Determines whether a file with the provided file format version can be read by
+     * this class without converting it first.
+     *
+     * \param version The file format version of the file
+     *
+     * \return true if the file can be read without a conversion
+     */
+    virtual bool isNativeFileFormatVersion(const std::string& version);
+
     /*
      * Determines a filename for the conversion result based on the original filename
      * and the file format version number.
@@ -605,6 +641,8 @@ public:
 protected:
     properties::BoolProperty _renderPlaybackInformation;
     properties::BoolProperty _ignoreRecordedScale;
+    properties::OptionProperty _fileSyncPolicy;
+    properties::BoolProperty _compressCameraKeyframes;
 
     enum class RecordedType {
         Camera = 0,
@@ -632,6 +670,7 @@ protected:
     static bool isPath(std::string& filename);
     void removeTrailingPathSlashes(std::string& filename);
     bool playbackCamera();
+    bool playbackCompressedCamera();
     bool playbackTimeChange();
     bool playbackScript();
     bool playbackAddEntriesToTimeline();
@@ -641,9 +680,9 @@ protected:
     bool findFirstCameraKeyframeInTimeline();
     Timestamps generateCurrentTimestamp3(double keyframeTime);
     static void saveStringToFile(const std::string& s, unsigned char* kfBuffer,
-        size_t& idx, std::ofstream& file);
+        size_t& idx, std::ostream& file);
     static void saveKeyframeToFileBinary(unsigned char* bufferSource, size_t size,
-        std::ofstream& file);
+        std::ostream& file);
 
     bool addKeyframe(Timestamps t3stamps,
         interaction::KeyframeNavigator::CameraPose keyframe, int lineNum);
@@ -700,6 +739,8 @@ protected:
         DataMode mode, int lineNum, std::ofstream& outFile);
     virtual bool convertCamera(std::stringstream& inStream, DataMode mode, int lineNum,
         std::string& inputLine, std::ofstream& outFile, unsigned char* buff);
+    bool convertCompressedCamera(std::stringstream& inStream, int lineNum,
+        std::ofstream& outFile, unsigned char* buff);
     virtual bool convertTimeChange(std::stringstream& inStream, DataMode mode,
         int lineNum, std::string& inputLine, std::ofstream& outFile, unsigned char* buff);
     virtual bool convertScript(std::stringstream& inStream, DataMode mode, int lineNum,
@@ -731,7 +772,9 @@ protected:
     std::string _playbackFilename;
     std::ifstream _playbackFile;
     std::string _playbackLineParsing;
-    std::ofstream _recordFile;
+    std::unique_ptr<SessionRecordingWriter> _recordWriter;
+    datamessagestructures::CameraKeyframeDecoder _playbackCameraDecoder;
+    datamessagestructures::CameraKeyframeDecoder _conversionCameraDecoder;
     int _playbackLineNum = 1;
     int _recordingEntryNum = 1;
     KeyframeTimeRef _playbackTimeReferenceMode;
@@ -860,6 +903,9 @@ public:
     std::string targetFileFormatVersion() override {
         return std::string(TargetConvertVersion);
     }
+    bool isNativeFileFormatVersion(const std::string& version) override {
+        return version == fileFormatVersion();
+    }
     std::string getLegacyConversionResult(std::string filename, int depth) override;
 
     struct ScriptMessage_legacy_0085 : public datamessagestructures::ScriptMessage {
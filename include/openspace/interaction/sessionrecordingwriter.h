@@ -0,0 +1,182 @@
+/*****************************************************************************************
+ *                                                                                       *
+ * OpenSpace                                                                             *
+ *                                                                                       *
+ * Copyright (c) 2014-2023                                                               *
+ *                                                                                       *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this  *
+ * software and associated documentation files (the "Software"), to deal in the Software *
+ * without restriction, including without limitation the rights to use, copy, modify,    *
+ * merge, publish, distribute, sublicense, and/or sell copies of the Software, and to    *
+ * permit persons to whom the Software is furnished to do so, subject to the following   *
+ * conditions:                                                                           *
+ *                                                                                       *
+ * The above copyright notice and this permission notice shall be included in all copies *
+ * or substantial portions of the Software.                                              *
+ *                                                                                       *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,   *
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A         *
+ * PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT    *
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF  *
+ * CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE  *
+ * OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                                         *
+ ****************************************************************************************/
+
+#ifndef __OPENSPACE_CORE___SESSIONRECORDINGWRITER___H__
+#define __OPENSPACE_CORE___SESSIONRECORDINGWRITER___H__
+
+#include <openspace/interaction/sessionrecording.h>
+#include <openspace/navigation/keyframenavigator.h>
+#include <openspace/util/lockfreequeue.h>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdio>
+#include <deque>
+#include <filesystem>
+#include <mutex>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace openspace::interaction {
+
+/**
+ * Writes the keyframes of a session recording to disk on a dedicated thread. The
+ * recording thread pushes entries into a lock-free queue that is drained by the writer
+ * thread, which serializes the entries and writes them in large chunks to a spool file
+ * next to the final recording. As the property baselines have to be located at the
+ * beginning of a recording, but are only known once the recording has ended, the final
+ * file is assembled from the header, the baseline entries and the spool file when the
+ * recording is finished. The resulting file is byte-identical to a file that is written
+ * synchronously with the SessionRecording::save* functions.
+ */
+class SessionRecordingWriter {
+public:
+    /// Determines when the written data is forced to be committed to the storage device
+    enum class SyncPolicy {
+        /// The data is never explicitly synchronized and left to the operating system
+        None = 0,
+        /// The final recording is synchronized once after it has been written
+        OnFinish,
+        /// The spool file is synchronized periodically and the final file once at the end
+        Periodic
+    };
+
+    struct Entry {
+        enum class Type {
+            Camera = 0,
+            Time,
+            Script
+        };
+
+        Type type = Type::Camera;
+        SessionRecording::Timestamps timestamps = { 0.0, 0.0, 0.0 };
+        KeyframeNavigator::CameraPose camera;
+        datamessagestructures::TimeKeyframe time;
+        std::string script;
+
+        /// The time at which this entry was handed to the writer
+        std::chrono::steady_clock::time_point queueTime;
+    };
+
+    /**
+     * Creates a writer whose queue can hold \p queueCapacity entries that have not been
+     * written yet.
+     */
+    explicit SessionRecordingWriter(size_t queueCapacity = 4096);
+    ~SessionRecordingWriter();
+
+    /**
+     * Starts the writer thread that spools entries for the recording that will be
+     * written to \p file. Any previous recording that is still being finalized is
+     * completed first.
+     *
+     * \param file The path of the final recording file
+     * \param mode The data mode in which the entries are serialized
+     * \param policy The policy that determines when the written data is synchronized
+     * \param compressCameraKeyframes If \c true, camera keyframes are delta encoded in
+     *        binary recordings
+     * \return \c true if the spool file could be created, \c false otherwise
+     */
+    bool start(std::filesystem::path file, SessionRecording::DataMode mode,
+        SyncPolicy policy, bool compressCameraKeyframes = false);
+
+    /**
+     * Hands the \p entry to the writer thread. This function must only be called from a
+     * single thread and never blocks. If the queue is full, camera entries are dropped
+     * while all other entries are retained and retried on the next call.
+     *
+     * \return \c false if the entry was dropped, \c true otherwise
+     */
+    bool push(Entry entry);
+
+    /**
+     * Requests the writer thread to finish the recording. The final file will consist of
+     * the \p header followed by the \p prefix entries and all entries that have been
+     * pushed since the last call to #start. This function does not wait for the file to
+     * be written; use #waitForFinish for that.
+     */
+    void finish(std::string header, std::vector<Entry> prefix);
+
+    /**
+     * Blocks until a previously requested #finish has completed and the writer thread
+     * has been joined.
+     */
+    void waitForFinish();
+
+    /// Returns the number of camera entries that were dropped because the queue was full
+    uint64_t nDroppedEntries() const;
+
+    /// Returns the number of entries that were written more than a second after they
+    /// were pushed
+    uint64_t nLateEntries() const;
+
+    /// Returns the number of entries that have been written to disk so far
+    uint64_t nWrittenEntries() const;
+
+    /// Returns whether the camera keyframes of the current recording are delta encoded
+    bool isCompressingCameraKeyframes() const;
+
+private:
+    void threadMain();
+    void drainQueue();
+    void serializeEntry(Entry& entry, std::ostream& out);
+    void flushPending(bool forceSync);
+    bool assembleFinalFile();
+
+    LockFreeQueue<Entry> _queue;
+    // Entries that did not fit into the queue. Only accessed by the producer thread
+    std::deque<Entry> _overflow;
+
+    std::thread _thread;
+    std::mutex _mutex;
+    std::condition_variable _condition;
+    std::atomic_bool _finishRequested = false;
+    // Set if the writer is destroyed without finishing, in which case the spool is
+    // removed instead of creating an incomplete recording
+    std::atomic_bool _discard = false;
+    std::string _header;
+    std::vector<Entry> _prefix;
+
+    std::filesystem::path _file;
+    std::filesystem::path _spoolFile;
+    std::FILE* _spool = nullptr;
+    SessionRecording::DataMode _mode = SessionRecording::DataMode::Binary;
+    SyncPolicy _syncPolicy = SyncPolicy::OnFinish;
+    bool _compressCameraKeyframes = false;
+    datamessagestructures::CameraKeyframeEncoder _cameraKeyframeEncoder;
+    std::chrono::steady_clock::time_point _lastSync;
+
+    std::ostringstream _pending;
+    std::vector<unsigned char> _buffer;
+
+    std::atomic<uint64_t> _nDropped = 0;
+    std::atomic<uint64_t> _nLate = 0;
+    std::atomic<uint64_t> _nWritten = 0;
+};
+
+} // namespace openspace::interaction
+
+#endif // __OPENSPACE_CORE___SESSIONRECORDINGWRITER___H__
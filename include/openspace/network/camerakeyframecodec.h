@@ -0,0 +1,100 @@
+/*****************************************************************************************
+ *                                                                                       *
+ * OpenSpace                                                                             *
+ *                                                                                       *
+ * Copyright (c) 2014-2023                                                               *
+ *                                                                                       *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this  *
+ * software and associated documentation files (the "Software"), to deal in the Software *
+ * without restriction, including without limitation the rights to use, copy, modify,    *
+ * merge, publish, distribute, sublicense, and/or sell copies of the Software, and to    *
+ * permit persons to whom the Software is furnished to do so, subject to the following   *
+ * conditions:                                                                           *
+ *                                                                                       *
+ * The above copyright notice and this permission notice shall be included in all copies *
+ * or substantial portions of the Software.                                              *
+ *                                                                                       *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,   *
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A         *
+ * PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT    *
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF  *
+ * CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE  *
+ * OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                                         *
+ ****************************************************************************************/
+
+#ifndef __OPENSPACE_CORE___CAMERAKEYFRAMECODEC___H__
+#define __OPENSPACE_CORE___CAMERAKEYFRAMECODEC___H__
+
+#include <openspace/network/messagestructures.h>
+#include <map>
+#include <optional>
+#include <string>
+#include <vector>
+
+namespace openspace::datamessagestructures {
+
+/**
+ * Encodes a stream of CameraKeyframes into a compact representation. Every
+ * \c keyframeInterval frames, and whenever the focus node or the rotation following
+ * changes, a full keyframe is emitted that can be decoded on its own. All other frames
+ * store the position as a quantized delta to the previously encoded frame, the rotation
+ * packed into 64 bits using the smallest-three method, and the timestamp as a delta in
+ * microseconds. Focus node names are interned and only transmitted the first time they
+ * are used and with every full keyframe, so that decoders that join a stream late can
+ * resynchronize on the next full keyframe.
+ *
+ * The quantized positions are relative to the position that the decoder reconstructs,
+ * so the quantization error does not accumulate over time.
+ */
+class CameraKeyframeEncoder {
+public:
+    explicit CameraKeyframeEncoder(int keyframeInterval = 60);
+
+    /**
+     * Appends the encoded representation of \p kf to the end of the \p buffer.
+     */
+    void encode(const CameraKeyframe& kf, std::vector<char>& buffer);
+
+    /**
+     * Forces the next encoded frame to be a full keyframe.
+     */
+    void reset();
+
+private:
+    int _keyframeInterval;
+    int _nFramesSinceKeyframe = 0;
+
+    /// The keyframe as it is reconstructed by the decoder
+    std::optional<CameraKeyframe> _reference;
+    std::map<std::string, uint32_t> _nodeIds;
+};
+
+/**
+ * Decodes the stream of frames that were created by a CameraKeyframeEncoder. The frames
+ * have to be passed to the decoder in the same order in which they were encoded.
+ */
+class CameraKeyframeDecoder {
+public:
+    /**
+     * Decodes the frame that starts at \p offset in the \p buffer into \p kf and advances
+     * the \p offset to the end of the frame.
+     *
+     * \return \c true if the frame was decoded. \c false if the frame is a delta frame
+     *         that refers to a keyframe that this decoder has not seen, for example
+     *         because the decoder joined the stream late, or if the frame is malformed
+     */
+    bool decode(const std::vector<char>& buffer, size_t& offset, CameraKeyframe& kf);
+
+    /**
+     * Discards the reference frame so that decoding resumes with the next keyframe.
+     */
+    void reset();
+
+private:
+    std::optional<CameraKeyframe> _reference;
+    std::map<uint32_t, std::string> _nodeNames;
+};
+
+} // namespace openspace::datamessagestructures
+
+#endif // __OPENSPACE_CORE___CAMERAKEYFRAMECODEC___H__
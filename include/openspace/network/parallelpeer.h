@@ -27,8 +27,10 @@
 
 #include <openspace/properties/propertyowner.h>
 
+#include <openspace/network/camerakeyframecodec.h>
 #include <openspace/network/messagestructures.h>
 #include <openspace/network/parallelconnection.h>
+#include <openspace/properties/scalar/boolproperty.h>
 #include <openspace/properties/scalar/floatproperty.h>
 #include <openspace/properties/stringproperty.h>
 #include <openspace/util/timemanager.h>
@@ -82,6 +84,7 @@ private:
 
     void handleMessage(const ParallelConnection::Message&);
     void dataMessageReceived(const std::vector<char>& message);
+    void addCameraKeyframe(const datamessagestructures::CameraKeyframe& kf);
     void connectionStatusMessageReceived(const std::vector<char>& message);
     void nConnectionsMessageReceived(const std::vector<char>& message);
 
@@ -106,6 +109,10 @@ private:
     properties::FloatProperty _bufferTime;
     properties::FloatProperty _timeKeyframeInterval;
     properties::FloatProperty _cameraKeyframeInterval;
+    properties::BoolProperty _compressCameraKeyframes;
+
+    datamessagestructures::CameraKeyframeEncoder _cameraKeyframeEncoder;
+    datamessagestructures::CameraKeyframeDecoder _cameraKeyframeDecoder;
 
     double _lastTimeKeyframeTimestamp = 0.0;
     double _lastCameraKeyframeTimestamp = 0.0;
@@ -0,0 +1,154 @@
+/*****************************************************************************************
+ *                                                                                       *
+ * OpenSpace                                                                             *
+ *                                                                                       *
+ * Copyright (c) 2014-2023                                                               *
+ *                                                                                       *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this  *
+ * software and associated documentation files (the "Software"), to deal in the Software *
+ * without restriction, including without limitation the rights to use, copy, modify,    *
+ * merge, publish, distribute, sublicense, and/or sell copies of the Software, and to    *
+ * permit persons to whom the Software is furnished to do so, subject to the following   *
+ * conditions:                                                                           *
+ *                                                                                       *
+ * The above copyright notice and this permission notice shall be included in all copies *
+ * or substantial portions of the Software.                                              *
+ *                                                                                       *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,   *
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A         *
+ * PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT    *
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF  *
+ * CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE  *
+ * OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                                         *
+ ****************************************************************************************/
+
+
+#ifndef __OPENSPACE_CORE___LABELLAYOUT___H__
+#define __OPENSPACE_CORE___LABELLAYOUT___H__
+
+#include <ghoul/glm.h>
+#include <cstdint>
+#include <functional>
+#include <limits>
+#include <vector>
+
+namespace openspace {
+
+/**
+ * Decides which labels of a potentially very large, static set of labels are drawn in a
+ * frame. The labels are stored in a bounding volume hierarchy that is only rebuilt when
+ * the labels change, so the view frustum and distance culling work on entire groups of
+ * labels instead of testing every single one of them each frame. The labels that survive
+ * the culling can optionally be placed into a screen-space occupancy grid in the order
+ * of their priority, which discards every label that would overlap a label that has
+ * already been placed, and the number of emitted labels can be limited.
+ */
+class LabelLayout {
+public:
+    struct Label {
+        /// The position of the label's anchor point in model coordinates
+        glm::dvec3 position = glm::dvec3(0.0);
+        /// Labels with a higher priority are placed before labels with a lower priority
+        float priority = 0.f;
+        /// The number of characters in the label, used to estimate its width on screen
+        int textLength = 0;
+    };
+
+    struct Settings {
+        /// The matrix that transforms the label positions into clip space
+        glm::dmat4 modelViewProjection = glm::dmat4(1.0);
+        /// The size of the viewport in pixels
+        glm::ivec2 viewportSize = glm::ivec2(0);
+
+        /// If this is `false`, labels are not culled against the view frustum
+        bool frustumCulling = true;
+        /// The number of pixels by which the view frustum is enlarged on every side, so
+        /// that labels whose anchor point lies just outside the screen are still kept
+        float margin = 0.f;
+
+        /// The camera position in model coordinates, only used for the distance culling
+        glm::dvec3 cameraPosition = glm::dvec3(0.0);
+        /// Labels that are further away from the `cameraPosition` are culled
+        double maxDistance = std::numeric_limits<double>::infinity();
+
+        /// If this is `true`, labels that overlap an already placed label are discarded
+        bool cullOverlapping = false;
+        /// The maximum number of labels that are emitted, or 0 for no limit
+        int maxLabels = 0;
+
+        /// The up direction of the text in model coordinates. Together with the
+        /// `textHeight` it is used to estimate the height of a label on screen
+        glm::dvec3 textUp = glm::dvec3(0.0, 1.0, 0.0);
+        /// The height of the text in model units
+        double textHeight = 0.0;
+        /// The estimated height of a label on screen is clamped to this range of pixels
+        glm::vec2 minMaxTextHeight = glm::vec2(0.f, std::numeric_limits<float>::max());
+        /// The width of a single character relative to the height of the text
+        float characterAspectRatio = 0.6f;
+        /// The size of a cell in the occupancy grid in pixels
+        int cellSize = 4;
+    };
+
+    /**
+     * Replaces the current labels with \p labels and rebuilds the hierarchy. The indices
+     * returned from #layout refer to the position of a label in this vector.
+     */
+    void setLabels(std::vector<Label> labels);
+
+    const std::vector<Label>& labels() const;
+
+    /**
+     * Returns the indices of the labels that should be drawn with the provided
+     * \p settings. If neither overlapping labels are culled nor the number of labels is
+     * limited, the indices are returned in an unspecified order. Otherwise they are
+     * ordered by descending priority; ties are broken in favor of labels that were
+     * placed in the previous call and then by the distance to the camera. The returned
+     * reference is valid until the next call of this function.
+     *
+     * \param settings The camera and viewport settings of the current frame
+     * \param isEnabled If this is provided, only labels for which it returns `true` are
+     *        considered
+     */
+    const std::vector<size_t>& layout(const Settings& settings,
+        const std::function<bool(size_t)>& isEnabled = nullptr);
+
+private:
+    struct Node {
+        glm::dvec3 min;
+        glm::dvec3 max;
+        /// The range [begin, end) of the _order vector that is spanned by this node
+        uint32_t begin;
+        uint32_t end;
+        /// The index of the right child or 0 for leaf nodes. The left child directly
+        /// follows its parent
+        uint32_t right;
+    };
+
+    struct Candidate {
+        size_t index;
+        float priority;
+        bool wasPlaced;
+        glm::dvec2 screen;
+        double depth;
+    };
+
+    void build(uint32_t begin, uint32_t end);
+    bool place(const Settings& settings, const Candidate& candidate);
+
+    std::vector<Label> _labels;
+    /// The label indices ordered such that every node spans a contiguous range
+    std::vector<uint32_t> _order;
+    std::vector<Node> _nodes;
+
+    /// Set for all labels that have been placed by the last call of #layout
+    std::vector<uint8_t> _wasPlaced;
+    std::vector<Candidate> _candidates;
+    std::vector<uint8_t> _occupancy;
+    glm::ivec2 _gridSize = glm::ivec2(0);
+    std::vector<size_t> _result;
+    std::vector<size_t> _previousResult;
+};
+
+} // namespace openspace
+
+#endif // __OPENSPACE_CORE___LABELLAYOUT___H__
@@ -221,6 +221,14 @@ public:
      */
     void require(Asset* child);
 
+    /**
+     * Returns the assets that are required by this Asset, which are the edges of the
+     * dependency graph between all assets.
+     *
+     * \return The assets that are required by this Asset
+     */
+    const std::vector<Asset*>& requiredAssets() const;
+
     /**
      * Returns `true` if the loading of the Asset has failed in any way so that
      * recovering from the error is impossible.
@@ -58,6 +58,7 @@ enum class PropertyValueType {
 using ProfilePropertyLua = std::variant<bool, float, std::string, ghoul::lua::nil_t>;
 
 class SceneInitializer;
+class SceneSnapshot;
 
 // Notifications:
 // SceneGraphFinishedLoading
@@ -166,6 +167,24 @@ public:
      */
     bool isInitializing() const;
 
+    /**
+     * Sets the \p snapshot of a previous load of the same scene. A node that is loaded
+     * through #loadNode with a dictionary that is contained in the snapshot is created
+     * without testing the dictionary against its Documentation again. All other nodes are
+     * tested as usual. Passing `nullptr` tests all nodes.
+     *
+     * \param snapshot The snapshot of a previous load or `nullptr`
+     */
+    void setVerifiedSnapshot(const SceneSnapshot* snapshot);
+
+    /**
+     * Sets the \p snapshot into which the dictionaries of all nodes that are successfully
+     * loaded through #loadNode are recorded. Passing `nullptr` stops the recording.
+     *
+     * \param snapshot The snapshot that records the nodes or `nullptr`
+     */
+    void setSnapshotRecorder(SceneSnapshot* snapshot);
+
     /**
      * Adds an interpolation request for the passed \p prop that will run for
      * \p durationSeconds seconds. Every time the #updateInterpolations method is called
@@ -353,6 +372,9 @@ private:
     std::vector<PropertyInterpolationInfo> _propertyInterpolationInfos;
 
     ghoul::MemoryPool<4096> _memoryPool;
+
+    const SceneSnapshot* _verifiedSnapshot = nullptr;
+    SceneSnapshot* _snapshotRecorder = nullptr;
 };
 
 // Convert the input string to a format that is valid as an identifier
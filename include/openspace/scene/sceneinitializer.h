@@ -26,6 +26,8 @@
 #define __OPENSPACE_CORE___SCENEINITIALIZER___H__
 
 #include <openspace/util/threadpool.h>
+#include <condition_variable>
+#include <mutex>
 #include <unordered_set>
 #include <vector>
 
@@ -62,8 +64,12 @@ public:
 private:
     std::vector<SceneGraphNode*> _initializedNodes;
     std::unordered_set<SceneGraphNode*> _initializingNodes;
-    ThreadPool _threadPool;
     mutable std::mutex _mutex;
+    /// Notified whenever a node has finished its initialization
+    std::condition_variable _nodeInitialized;
+    // The thread pool is declared last so that its worker threads are joined before any
+    // of the other members that they access are destroyed
+    ThreadPool _threadPool;
 };
 
 } // namespace openspace
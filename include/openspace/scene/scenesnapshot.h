@@ -0,0 +1,153 @@
+/*****************************************************************************************
+ *                                                                                       *
+ * OpenSpace                                                                             *
+ *                                                                                       *
+ * Copyright (c) 2014-2023                                                               *
+ *                                                                                       *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this  *
+ * software and associated documentation files (the "Software"), to deal in the Software *
+ * without restriction, including without limitation the rights to use, copy, modify,    *
+ * merge, publish, distribute, sublicense, and/or sell copies of the Software, and to    *
+ * permit persons to whom the Software is furnished to do so, subject to the following   *
+ * conditions:                                                                           *
+ *                                                                                       *
+ * The above copyright notice and this permission notice shall be included in all copies *
+ * or substantial portions of the Software.                                              *
+ *                                                                                       *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,   *
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A         *
+ * PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT    *
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF  *
+ * CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE  *
+ * OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                                         *
+ ****************************************************************************************/
+
+
+#ifndef __OPENSPACE_CORE___SCENESNAPSHOT___H__
+#define __OPENSPACE_CORE___SCENESNAPSHOT___H__
+
+#include <filesystem>
+#include <optional>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace ghoul { class Dictionary; }
+
+namespace openspace {
+
+/**
+ * A SceneSnapshot records the result of loading a profile. It contains the asset files
+ * that were loaded, each with the hash of its contents, and the hashes of the
+ * dictionaries of all scene graph nodes that were created successfully. When the same
+ * profile is loaded again and none of the asset files has changed (see #isUpToDate), a
+ * node whose dictionary is contained in the snapshot (see #containsNode) has already
+ * passed the specification tests of its Documentation and can be created without
+ * testing its dictionary again.
+ *
+ * The assets are still executed as usual and any dictionary that is not contained in the
+ * snapshot is tested as before, so an outdated snapshot cannot change the scene.
+ */
+class SceneSnapshot {
+public:
+    struct Asset {
+        std::filesystem::path path;
+        std::string hash;
+    };
+
+    struct Node {
+        std::string identifier;
+        /// The hash of the node's dictionary, see #hashDictionary
+        std::string hash;
+        /// The files and directories that the dictionary refers to
+        std::vector<std::filesystem::path> files;
+    };
+
+    /**
+     * Creates an empty snapshot for the profile whose contents are \p profile and that is
+     * loaded by the OpenSpace version \p version.
+     *
+     * \param version The version of OpenSpace that creates this snapshot
+     * \param profile The contents of the profile that is loaded
+     */
+    SceneSnapshot(std::string version, const std::string& profile);
+
+    /**
+     * Loads a snapshot from the file at \p path that was previously created by #save.
+     *
+     * \param path The path to the file that contains the snapshot
+     * \return The loaded snapshot or `std::nullopt` if the file does not exist or could
+     *         not be read
+     */
+    static std::optional<SceneSnapshot> load(const std::filesystem::path& path);
+
+    /**
+     * Saves this snapshot to the file at \p path, overwriting any existing file.
+     *
+     * \param path The path to the file that is written
+     * \throw ghoul::RuntimeError If the file could not be written
+     */
+    void save(const std::filesystem::path& path) const;
+
+    /**
+     * Adds the asset file at \p path to this snapshot and computes the hash of its
+     * contents.
+     *
+     * \param path The path to the asset file
+     * \throw ghoul::RuntimeError If the file could not be read
+     * \pre \p path must be an existing file
+     */
+    void addAsset(std::filesystem::path path);
+
+    /**
+     * Adds the \p dictionary of a scene graph node that was created successfully while
+     * loading the profile.
+     *
+     * \param dictionary The dictionary from which the node was created
+     * \pre \p dictionary must contain an `Identifier` key
+     */
+    void addNode(const ghoul::Dictionary& dictionary);
+
+    /**
+     * Returns `true` if this snapshot was created by the OpenSpace version \p version for
+     * a profile with the contents \p profile and if all of the asset files still exist
+     * with the same contents as when the snapshot was created.
+     *
+     * \param version The version of the currently running OpenSpace
+     * \param profile The contents of the profile that is loaded
+     * \return `true` if this snapshot describes the scene that is about to be loaded
+     */
+    bool isUpToDate(const std::string& version, const std::string& profile) const;
+
+    /**
+     * Returns `true` if a node with the same \p dictionary was added to this snapshot and
+     * all of the files and directories that the dictionary refers to still exist.
+     *
+     * \param dictionary The dictionary of the node that is about to be created
+     * \return `true` if the \p dictionary has already been tested successfully
+     */
+    bool containsNode(const ghoul::Dictionary& dictionary) const;
+
+    const std::vector<Asset>& assets() const;
+    const std::vector<Node>& nodes() const;
+
+    /**
+     * Returns the hash of the provided \p dictionary that is used to compare node
+     * dictionaries with each other.
+     */
+    static std::string hashDictionary(const ghoul::Dictionary& dictionary);
+
+private:
+    SceneSnapshot() = default;
+
+    std::string _version;
+    std::string _profileHash;
+    std::vector<Asset> _assets;
+    std::vector<Node> _nodes;
+    /// Maps the hash of each node's dictionary to its index in #_nodes
+    std::unordered_map<std::string, size_t> _nodeIndices;
+};
+
+} // namespace openspace
+
+#endif // __OPENSPACE_CORE___SCENESNAPSHOT___H__
@@ -53,6 +53,17 @@ public:
 
     virtual glm::dvec3 position(const UpdateData& data) const = 0;
 
+    /**
+     * Returns whether #position(const UpdateData&) can be called from a worker thread
+     * while this translation is used on the main thread at the same time, for example to
+     * sample a trail in the background. Translations that evaluate Lua scripts or compute
+     * members lazily are not thread-safe, which is the default. A thread-safe translation
+     * has to call #notifyObservers before it changes any state that is read in
+     * #position(const UpdateData&), as observers stop and wait for their background
+     * work in response to that notification.
+     */
+    virtual bool isThreadSafe() const;
+
     // Registers a callback that gets called when a significant change has been made that
     // invalidates potentially stored points, for example in trails
     void onParameterChange(std::function<void()> callback);
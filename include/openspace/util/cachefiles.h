@@ -0,0 +1,59 @@
+/*****************************************************************************************
+ *                                                                                       *
+ * OpenSpace                                                                             *
+ *                                                                                       *
+ * Copyright (c) 2014-2023                                                               *
+ *                                                                                       *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this  *
+ * software and associated documentation files (the "Software"), to deal in the Software *
+ * without restriction, including without limitation the rights to use, copy, modify,    *
+ * merge, publish, distribute, sublicense, and/or sell copies of the Software, and to    *
+ * permit persons to whom the Software is furnished to do so, subject to the following   *
+ * conditions:                                                                           *
+ *                                                                                       *
+ * The above copyright notice and this permission notice shall be included in all copies *
+ * or substantial portions of the Software.                                              *
+ *                                                                                       *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,   *
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A         *
+ * PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT    *
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF  *
+ * CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE  *
+ * OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                                         *
+ ****************************************************************************************/
+
+#ifndef __OPENSPACE_CORE___CACHEFILES___H__
+#define __OPENSPACE_CORE___CACHEFILES___H__
+
+#include <filesystem>
+#include <mutex>
+
+namespace openspace {
+
+/**
+ * Returns the mutex that serializes all accesses to the cache manager of the file system.
+ * The cache manager is not thread-safe, but it is used by objects that are initialized
+ * concurrently, so it must only be accessed through the #cachedFilename and
+ * #removeCacheFile functions.
+ */
+std::mutex& cacheManagerMutex();
+
+/**
+ * Calls the `cachedFilename` function of the file system's cache manager with the
+ * provided \p args while holding the #cacheManagerMutex.
+ */
+template <typename... Args>
+std::filesystem::path cachedFilename(Args&&... args);
+
+/**
+ * Calls the `removeCacheFile` function of the file system's cache manager with the
+ * provided \p args while holding the #cacheManagerMutex.
+ */
+template <typename... Args>
+void removeCacheFile(Args&&... args);
+
+} // namespace openspace
+
+#include <openspace/util/cachefiles.inl>
+
+#endif // __OPENSPACE_CORE___CACHEFILES___H__
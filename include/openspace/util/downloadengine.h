@@ -0,0 +1,230 @@
+/*****************************************************************************************
+ *                                                                                       *
+ * OpenSpace                                                                             *
+ *                                                                                       *
+ * Copyright (c) 2014-2023                                                               *
+ *                                                                                       *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this  *
+ * software and associated documentation files (the "Software"), to deal in the Software *
+ * without restriction, including without limitation the rights to use, copy, modify,    *
+ * merge, publish, distribute, sublicense, and/or sell copies of the Software, and to    *
+ * permit persons to whom the Software is furnished to do so, subject to the following   *
+ * conditions:                                                                           *
+ *                                                                                       *
+ * The above copyright notice and this permission notice shall be included in all copies *
+ * or substantial portions of the Software.                                              *
+ *                                                                                       *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,   *
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A         *
+ * PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT    *
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF  *
+ * CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE  *
+ * OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                                         *
+ ****************************************************************************************/
+
+
+#ifndef __OPENSPACE_CORE___DOWNLOADENGINE___H__
+#define __OPENSPACE_CORE___DOWNLOADENGINE___H__
+
+#include <array>
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace openspace {
+
+/**
+ * This class performs any number of HTTP transfers on a single event thread using curl's
+ * multi interface. Transfers are queued with #enqueue and at most
+ * Settings::maxActiveTransfers of them are active at the same time, which also bounds the
+ * number of open sockets and file handles. Connections to the same host are reused
+ * (keep-alive and HTTP/2 multiplexing where the server supports it) and limited by
+ * Settings::maxConnectionsPerHost. Transfers with a Priority::Blocking priority are
+ * always started before transfers with a Priority::Background priority.
+ *
+ * Transfers that fail because of a network error or because the server responded with a
+ * status code that signals a temporary problem (408, 429, 500, 502-504) are retried with
+ * an exponential backoff. If parts of the body have already been received, the retry
+ * requests the remaining bytes with a range request. If the server ignores the range,
+ * the bytes that were already delivered are skipped, so the Transfer::onData callback
+ * always sees every byte of the body exactly once.
+ *
+ * All callbacks of a Transfer are called on the event thread and must not block.
+ */
+class DownloadEngine {
+public:
+    enum class Priority {
+        /// Transfers that something is waiting for, for example to finish loading an
+        /// asset
+        Blocking = 0,
+        /// Transfers that can happen whenever there is bandwidth available
+        Background
+    };
+
+    struct Settings {
+        /// The maximum number of transfers that are active at the same time
+        int maxActiveTransfers = 32;
+
+        /// The maximum number of connections that are opened to a single host
+        int maxConnectionsPerHost = 6;
+
+        /// The number of times a transfer is retried before it fails
+        int maxRetries = 3;
+
+        /// The time to wait before the first retry. Each consecutive retry waits twice
+        /// as long as the previous one
+        std::chrono::milliseconds retryDelay = std::chrono::milliseconds(500);
+    };
+
+    /// The callbacks have the same meaning as the ones in HttpRequest
+    using HeaderCallback = std::function<bool(char* buffer, size_t size)>;
+    using DataCallback = std::function<bool(char* buffer, size_t size)>;
+    using ProgressCallback = std::function<
+        bool(size_t downloadedBytes, std::optional<size_t> totalBytes)
+    >;
+
+    struct Result {
+        bool success = false;
+
+        /// The HTTP response code or 0 if no response was received
+        long responseCode = 0;
+
+        /// The content type reported by the server, if any
+        std::string contentType;
+
+        /// A description of the error if the transfer failed
+        std::string error;
+    };
+
+    struct Transfer {
+        std::string url;
+        Priority priority = Priority::Blocking;
+
+        /// The timeout for each attempt of this transfer or 0 if there is no timeout
+        std::chrono::milliseconds timeout = std::chrono::milliseconds(0);
+
+        /// If this is `true`, only the headers of the URL are requested
+        bool headersOnly = false;
+
+        /// Whether the certificate of the server is verified for HTTPS connections
+        bool verifyPeer = true;
+
+        /// If this is `true`, responses with a status code of 400 or above count as
+        /// failures and their body is not passed to the #onData callback. Otherwise they
+        /// are treated like any other response
+        bool failOnHttpError = true;
+
+        /// Called right before the transfer becomes active. If this returns `false`, the
+        /// transfer fails without being started
+        std::function<bool()> onStart;
+
+        HeaderCallback onHeader;
+        DataCallback onData;
+        ProgressCallback onProgress;
+
+        /// Called exactly once when the transfer has finished, failed, or was cancelled
+        std::function<void(const Result& result)> onFinish;
+    };
+
+    using TransferId = uint64_t;
+
+    struct Statistics {
+        size_t nQueued = 0;
+        size_t nActive = 0;
+        size_t nSucceeded = 0;
+        size_t nFailed = 0;
+        size_t nRetries = 0;
+        size_t nBytes = 0;
+        size_t peakActive = 0;
+    };
+
+    /**
+     * Creates the DownloadEngine instance that is shared by all HttpDownloads. This
+     * function must be called before any HttpDownload is started.
+     */
+    static void initialize();
+
+    /**
+     * Destroys the shared DownloadEngine instance. All transfers that have not finished
+     * yet are aborted and their Transfer::onFinish callbacks are called before this
+     * function returns, so it has to be called while the objects that these callbacks
+     * refer to are still alive.
+     */
+    static void deinitialize();
+
+    /// Returns whether the shared DownloadEngine instance has been initialized
+    static bool isInitialized();
+
+    /**
+     * Returns the DownloadEngine instance that is shared by all HttpDownloads.
+     *
+     * \pre The shared instance must have been initialized
+     */
+    static DownloadEngine& shared();
+
+    DownloadEngine();
+    explicit DownloadEngine(Settings settings);
+
+    /// Cancels all transfers that have not finished yet and stops the event thread
+    ~DownloadEngine();
+
+    /**
+     * Adds the \p transfer to the queue of transfers and returns immediately.
+     *
+     * \return An identifier that can be passed to #cancel
+     */
+    TransferId enqueue(Transfer transfer);
+
+    /**
+     * Cancels the transfer with the provided \p id. If the transfer has not been started
+     * yet or is waiting for a retry, its Transfer::onFinish callback is called before
+     * this function returns. An active transfer is removed on the event thread, which
+     * calls its Transfer::onFinish callback once the transfer has been stopped.
+     */
+    void cancel(TransferId id);
+
+    Statistics statistics() const;
+
+    /**
+     * Returns whether this function is called on the event thread, which is the thread
+     * that calls all of the Transfer callbacks. Waiting for a transfer on this thread
+     * would never return.
+     */
+    bool isEventThread() const;
+
+private:
+    struct State;
+
+    void run();
+    void startTransfers();
+    void cancelTransfers();
+    void finishTransfer(std::unique_ptr<State> state, int curlCode);
+
+    Settings _settings;
+    void* _multiHandle = nullptr;
+
+    mutable std::mutex _mutex;
+    std::condition_variable _condition;
+    std::array<std::deque<std::unique_ptr<State>>, 2> _queued;
+    std::vector<std::unique_ptr<State>> _retrying;
+    std::vector<std::unique_ptr<State>> _active;
+    std::vector<TransferId> _cancelled;
+    TransferId _nextId = 1;
+    bool _shouldStop = false;
+    Statistics _statistics;
+
+    std::thread _thread;
+
+    static DownloadEngine* _instance;
+};
+
+} // namespace openspace
+
+#endif // __OPENSPACE_CORE___DOWNLOADENGINE___H__
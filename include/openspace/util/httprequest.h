@@ -25,15 +25,17 @@
 #ifndef __OPENSPACE_CORE___HTTPREQUEST___H__
 #define __OPENSPACE_CORE___HTTPREQUEST___H__
 
+#include <openspace/util/downloadengine.h>
+
 #include <ghoul/misc/boolean.h>
 #include <atomic>
 #include <condition_variable>
 #include <filesystem>
 #include <fstream>
 #include <functional>
+#include <mutex>
 #include <optional>
 #include <string>
-#include <thread>
 #include <vector>
 #include <chrono>
 
@@ -191,7 +193,7 @@ private:
 };
 
 /**
- * This abstract base class uses the HttpRequest class to perform an asynchronous
+ * This abstract base class uses the shared DownloadEngine to perform an asynchronous
  * download. Every subclass needs to implement at least the #handleData function that will
  * be called every time a chunk of data has been received from the request. The download
  * is started through the #start function and it is possible to turn this into a
@@ -230,10 +232,18 @@ public:
     void onProgress(HttpRequest::ProgressCallback progressCallback);
 
     /**
-     * Starts the asynchronous download of the file by starting a new thread that will
-     * take care of the download, meaning that this function will return almost
-     * instantaneously. If the HttpDownload is already downloading a file this function
-     * does nothing.
+     * Sets the priority with which the download is queued in the DownloadEngine. The
+     * default is DownloadEngine::Priority::Blocking. Changing the priority only affects
+     * downloads that are #start ed afterwards.
+     *
+     * \param priority The priority of the download
+     */
+    void setPriority(DownloadEngine::Priority priority);
+
+    /**
+     * Starts the asynchronous download of the file by queueing it in the shared
+     * DownloadEngine, meaning that this function will return almost instantaneously. If
+     * the HttpDownload is already downloading a file this function does nothing.
      *
      * \param timeout The number of milliseconds that the download will be kept alive
      *        while waiting for a reply from the server. If this value is 0, the
@@ -242,7 +252,8 @@ public:
     void start(std::chrono::milliseconds timeout = std::chrono::milliseconds(0));
 
     /**
-     * Cancels the ongoing download. Because of the underlying library that is used, the
+     * Cancels the ongoing download. A download that is still queued is removed from the
+     * queue immediately. Because of the underlying library that is used, an active
      * transfer will only be aborted the next time any piece of data is received or the
      * library reports any progress.
      */
@@ -250,7 +261,8 @@ public:
 
     /**
      * This function will wait until the download has completed and will return the
-     * success of the download back to the caller.
+     * success of the download back to the caller. If the download was never started,
+     * this function returns immediately.
      *
      * \return `true` if the downloaded succeeded or `false` if the download failed
      */
@@ -288,8 +300,8 @@ protected:
      * the callbacks responsibility to store the contents of the buffer before the
      * callback returns. If the return value is `true`, the download continues, if it is
      * `false`, this signals to the library that an error has occurred from which
-     * recovery is not possible. This function will be called on a different thread from
-     * the one that called the #start method.
+     * recovery is not possible. This function will be called on the event thread of the
+     * DownloadEngine and should not block.
      *
      * \param buffer The beginning of the buffer of this chunk of data
      * \param size The number of bytes that the \p buffer contains
@@ -305,8 +317,9 @@ protected:
      * to perform one-time setup functions, such as opening a file, reserving a block of
      * storage, etc. This function guaranteed to be only called once per HttpDownload.
      * The return value determines if the setup operation completed successfully or if an
-     * error occurred that will cause the download to be terminated. This function will be
-     * called on a different thread from the one that called the #start method.
+     * error occurred that will cause the download to be terminated. This function is
+     * called on the event thread of the DownloadEngine right before the transfer becomes
+     * active, so that only active transfers hold on to resources.
      *
      * \return `true` if the setup completed successfully and `false` if the setup
      *         failed unrecoverably
@@ -318,37 +331,51 @@ protected:
      * call to #wait is performed. This function can be used by a subclass to perform
      * one-time operations that are required when the downloading fininshes, such as
      * closing file handles, committing some memory etc. The return value of this function
-     * signals whether the teardown completed successfully. This function will be called
-     * on a different thread from the one that called the #start method.
+     * signals whether the teardown completed successfully. This function will only be
+     * called if #setup has been called and is called on the event thread of the
+     * DownloadEngine.
      *
      * \return `true` if the teardown completed successfully and `false` if it failed
      */
     virtual bool teardown();
 
 private:
+    /// Called by the DownloadEngine when the transfer has finished or failed
+    void finish(bool success);
+
     /// The callback that will be called whenever there is some progress to be reported
     HttpRequest::ProgressCallback _onProgress;
 
+    /// The URL that this HttpDownload is going to download
+    std::string _url;
+
+    /// The priority that is used when queueing the download in the DownloadEngine
+    DownloadEngine::Priority _priority = DownloadEngine::Priority::Blocking;
+
+    /// The identifier of the transfer in the DownloadEngine if the download was started
+    std::optional<DownloadEngine::TransferId> _transferId;
+
     /// Value indicating whether the HttpDownload is currently downloading a file
     bool _isDownloading = false;
 
     /// Value indicating whether the download is finished
-    bool _isFinished = false;
+    std::atomic_bool _isFinished = false;
 
     /// Value indicated whether the download was successful
-    bool _isSuccessful = false;
+    std::atomic_bool _isSuccessful = false;
 
-    /// Marker telling the downloading thread that the download should be cancelled
-    bool _shouldCancel = false;
+    /// Value indicating whether #setup was called for the current download
+    bool _isSetUp = false;
 
-    /// The HttpRequest class that will be used for the download
-    HttpRequest _httpRequest;
+    /// Marker telling the DownloadEngine that the download should be cancelled
+    std::atomic_bool _shouldCancel = false;
 
-    /// The thread that contains the HttpRequest to download the file
-    std::thread _downloadThread;
+    /// Protects the state of the download against concurrent access from the event
+    /// thread of the DownloadEngine
+    std::mutex _mutex;
 
     /// This condition variable is used by the #wait function to be able to wait for
-    /// completion of the downloading thread
+    /// completion of the download
     std::condition_variable _downloadFinishCondition;
 };
 
@@ -387,23 +414,18 @@ public:
 
 private:
     /// Will create all directories that are necessary to reach _destination and then
-    /// fight with other HttpFileDownloads to get one of a limited number of file handles
-    /// to open _file
+    /// open the _file. As this is only called for active transfers, the number of open
+    /// file handles is bounded by DownloadEngine::Settings::maxActiveTransfers
     bool setup() override;
 
-    /// Closes the _file and returns the handle back to the pool of available handles
+    /// Closes the _file
     bool teardown() override;
 
     /// Stores the chunk of data into the _file handle
     bool handleData(char* buffer, size_t size) override;
 
-    /// A flag whether this HttpFileDownload got a handle from the limited supply of
-    /// handles. This limit is used to prevent all HttpFileDownloads from getting file
-    /// handles from the operating system as that resource is limited and downloads would
-    /// fail unrecoverably if no handles are available. So we limit the maximum number and
-    /// if that number is exceeded, the HttpFileDownload will wait until a handle is
-    /// available.
-    std::atomic_bool _hasHandle = false;
+    /// A flag whether this HttpFileDownload has opened the _file
+    bool _hasHandle = false;
 
     /// The destination path where the contents of the URL provided in the constructor
     /// will be saved to
@@ -415,12 +437,6 @@ private:
     /// Mutex that will be prevent multiple HttpFileDownloads to simultaneously try to
     /// create the necessary intermediate directories, which would cause issues
     static std::mutex _directoryCreationMutex;
-
-    /// The maximum number of file handles that all HttpFileDownloads combined can use up
-    static constexpr int MaxFileHandles = 32;
-
-    /// Stores the number of currently open file handles across all HttpFileDownloads
-    static std::atomic_int nCurrentFileHandles;
 };
 
 /**
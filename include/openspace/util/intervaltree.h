@@ -0,0 +1,97 @@
+/*****************************************************************************************
+ *                                                                                       *
+ * OpenSpace                                                                             *
+ *                                                                                       *
+ * Copyright (c) 2014-2023                                                               *
+ *                                                                                       *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this  *
+ * software and associated documentation files (the "Software"), to deal in the Software *
+ * without restriction, including without limitation the rights to use, copy, modify,    *
+ * merge, publish, distribute, sublicense, and/or sell copies of the Software, and to    *
+ * permit persons to whom the Software is furnished to do so, subject to the following   *
+ * conditions:                                                                           *
+ *                                                                                       *
+ * The above copyright notice and this permission notice shall be included in all copies *
+ * or substantial portions of the Software.                                              *
+ *                                                                                       *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,   *
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A         *
+ * PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT    *
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF  *
+ * CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE  *
+ * OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                                         *
+ ****************************************************************************************/
+
+
+#ifndef __OPENSPACE_CORE___INTERVALTREE___H__
+#define __OPENSPACE_CORE___INTERVALTREE___H__
+
+#include <cstddef>
+#include <vector>
+
+namespace openspace {
+
+/**
+ * A static interval tree that answers which of its closed intervals `[start, end]`
+ * contain a point in time. The intervals are stored sorted by their start time in a
+ * single array, which doubles as an implicit balanced binary search tree in which every
+ * node additionally stores the latest end time of its subtree. This makes a query cost
+ * O(log n + k) for k matching intervals, instead of O(n) for a linear scan. The tree is
+ * built once and cannot be modified afterwards.
+ */
+template <typename T>
+class IntervalTree {
+public:
+    struct Interval {
+        double start;
+        double end;
+        T data;
+    };
+
+    IntervalTree() = default;
+
+    /**
+     * Creates the tree from the provided \p intervals, which do not have to be sorted.
+     * Intervals whose end lies before their start are never returned by any query.
+     */
+    explicit IntervalTree(std::vector<Interval> intervals);
+
+    /**
+     * Calls \p callback with every interval that contains \p time in the order of their
+     * start time. If the \p callback returns `true`, the search stops.
+     *
+     * \return `true` if the \p callback stopped the search, `false` otherwise
+     */
+    template <typename Callback>
+    bool query(double time, Callback&& callback) const;
+
+    /**
+     * Returns the interval with the earliest start time that contains \p time and that
+     * satisfies the \p predicate, or `nullptr` if there is none.
+     */
+    template <typename Predicate>
+    const Interval* findFirst(double time, Predicate&& predicate) const;
+
+    /// Returns all intervals sorted by their start time
+    const std::vector<Interval>& intervals() const;
+
+    size_t size() const;
+    bool empty() const;
+
+private:
+    /// Computes the latest end time of the subtree spanning [begin, end)
+    double build(size_t begin, size_t end);
+
+    template <typename Callback>
+    bool query(size_t begin, size_t end, double time, Callback& callback) const;
+
+    std::vector<Interval> _intervals;
+    /// The latest end time of the subtree whose root is at the same index
+    std::vector<double> _maxEnd;
+};
+
+} // namespace openspace
+
+#include "intervaltree.inl"
+
+#endif // __OPENSPACE_CORE___INTERVALTREE___H__
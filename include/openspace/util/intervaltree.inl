@@ -0,0 +1,128 @@
+/*****************************************************************************************
+ *                                                                                       *
+ * OpenSpace                                                                             *
+ *                                                                                       *
+ * Copyright (c) 2014-2023                                                               *
+ *                                                                                       *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this  *
+ * software and associated documentation files (the "Software"), to deal in the Software *
+ * without restriction, including without limitation the rights to use, copy, modify,    *
+ * merge, publish, distribute, sublicense, and/or sell copies of the Software, and to    *
+ * permit persons to whom the Software is furnished to do so, subject to the following   *
+ * conditions:                                                                           *
+ *                                                                                       *
+ * The above copyright notice and this permission notice shall be included in all copies *
+ * or substantial portions of the Software.                                              *
+ *                                                                                       *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,   *
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A         *
+ * PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT    *
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF  *
+ * CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE  *
+ * OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                                         *
+ ****************************************************************************************/
+
+
+#include <algorithm>
+
+namespace openspace {
+
+template <typename T>
+IntervalTree<T>::IntervalTree(std::vector<Interval> intervals)
+    : _intervals(std::move(intervals))
+{
+    std::stable_sort(
+        _intervals.begin(),
+        _intervals.end(),
+        [](const Interval& a, const Interval& b) { return a.start < b.start; }
+    );
+    _maxEnd.resize(_intervals.size());
+    build(0, _intervals.size());
+}
+
+template <typename T>
+double IntervalTree<T>::build(size_t begin, size_t end) {
+    // The root of each subtree is the middle element of its range, so the sorted array
+    // forms a balanced binary search tree without storing any child pointers
+    const size_t mid = begin + (end - begin) / 2;
+    double maxEnd = _intervals[mid].end;
+    if (begin < mid) {
+        maxEnd = std::max(maxEnd, build(begin, mid));
+    }
+    if (mid + 1 < end) {
+        maxEnd = std::max(maxEnd, build(mid + 1, end));
+    }
+    _maxEnd[mid] = maxEnd;
+    return maxEnd;
+}
+
+template <typename T>
+template <typename Callback>
+bool IntervalTree<T>::query(double time, Callback&& callback) const {
+    if (_intervals.empty()) {
+        return false;
+    }
+    return query(0, _intervals.size(), time, callback);
+}
+
+template <typename T>
+template <typename Callback>
+bool IntervalTree<T>::query(size_t begin, size_t end, double time,
+                            Callback& callback) const
+{
+    const size_t mid = begin + (end - begin) / 2;
+    if (_maxEnd[mid] < time) {
+        // Every interval in this subtree ended before the requested time
+        return false;
+    }
+
+    if (begin < mid && query(begin, mid, time, callback)) {
+        return true;
+    }
+
+    const Interval& interval = _intervals[mid];
+    if (interval.start > time) {
+        // All intervals in the right subtree start even later
+        return false;
+    }
+    if (time <= interval.end && callback(interval)) {
+        return true;
+    }
+
+    return mid + 1 < end && query(mid + 1, end, time, callback);
+}
+
+template <typename T>
+template <typename Predicate>
+const typename IntervalTree<T>::Interval*
+IntervalTree<T>::findFirst(double time, Predicate&& predicate) const
+{
+    const Interval* result = nullptr;
+    query(time, [&result, &predicate](const Interval& interval) {
+        if (predicate(interval.data)) {
+            result = &interval;
+            return true;
+        }
+        return false;
+    });
+    return result;
+}
+
+template <typename T>
+const std::vector<typename IntervalTree<T>::Interval>&
+IntervalTree<T>::intervals() const
+{
+    return _intervals;
+}
+
+template <typename T>
+size_t IntervalTree<T>::size() const {
+    return _intervals.size();
+}
+
+template <typename T>
+bool IntervalTree<T>::empty() const {
+    return _intervals.empty();
+}
+
+} // namespace openspace
@@ -0,0 +1,88 @@
+/*****************************************************************************************
+ *                                                                                       *
+ * OpenSpace                                                                             *
+ *                                                                                       *
+ * Copyright (c) 2014-2023                                                               *
+ *                                                                                       *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this  *
+ * software and associated documentation files (the "Software"), to deal in the Software *
+ * without restriction, including without limitation the rights to use, copy, modify,    *
+ * merge, publish, distribute, sublicense, and/or sell copies of the Software, and to    *
+ * permit persons to whom the Software is furnished to do so, subject to the following   *
+ * conditions:                                                                           *
+ *                                                                                       *
+ * The above copyright notice and this permission notice shall be included in all copies *
+ * or substantial portions of the Software.                                              *
+ *                                                                                       *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,   *
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A         *
+ * PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT    *
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF  *
+ * CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE  *
+ * OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                                         *
+ ****************************************************************************************/
+
+#ifndef __OPENSPACE_CORE___LOCKFREEQUEUE___H__
+#define __OPENSPACE_CORE___LOCKFREEQUEUE___H__
+
+#include <atomic>
+#include <cstddef>
+#include <vector>
+
+namespace openspace {
+
+/**
+ * Bounded, lock-free queue for exactly one producer thread and one consumer thread. The
+ * storage is a ring buffer that is allocated once at construction so neither pushing nor
+ * popping allocate memory or take a lock. If more than one thread pushes or more than
+ * one thread pops concurrently, the behavior is undefined.
+ */
+template <typename T>
+class LockFreeQueue {
+public:
+    /**
+     * Creates a queue that can hold at most \p capacity elements at the same time.
+     *
+     * \pre \p capacity must be bigger than 0
+     */
+    explicit LockFreeQueue(size_t capacity);
+
+    /**
+     * Tries to add the \p item to the end of the queue. This function must only be
+     * called from the producer thread.
+     *
+     * \return \c true if the item was added, \c false if the queue was full, in which
+     *         case \p item is left untouched
+     */
+    bool tryPush(T&& item);
+
+    /**
+     * Tries to remove the first item of the queue and move it into \p item. This
+     * function must only be called from the consumer thread.
+     *
+     * \return \c true if an item was removed, \c false if the queue was empty
+     */
+    bool tryPop(T& item);
+
+    /**
+     * Returns the number of elements that are currently in the queue. As the other thread
+     * might be modifying the queue at the same time, this value is only a snapshot.
+     */
+    size_t size() const;
+
+    bool empty() const;
+
+    size_t capacity() const;
+
+private:
+    // One more slot than the capacity to distinguish between a full and an empty queue
+    std::vector<T> _buffer;
+    alignas(64) std::atomic<size_t> _head = 0;
+    alignas(64) std::atomic<size_t> _tail = 0;
+};
+
+} // namespace openspace
+
+#include "lockfreequeue.inl"
+
+#endif // __OPENSPACE_CORE___LOCKFREEQUEUE___H__
@@ -0,0 +1,80 @@
+/*****************************************************************************************
+ *                                                                                       *
+ * OpenSpace                                                                             *
+ *                                                                                       *
+ * Copyright (c) 2014-2023                                                               *
+ *                                                                                       *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this  *
+ * software and associated documentation files (the "Software"), to deal in the Software *
+ * without restriction, including without limitation the rights to use, copy, modify,    *
+ * merge, publish, distribute, sublicense, and/or sell copies of the Software, and to    *
+ * permit persons to whom the Software is furnished to do so, subject to the following   *
+ * conditions:                                                                           *
+ *                                                                                       *
+ * The above copyright notice and this permission notice shall be included in all copies *
+ * or substantial portions of the Software.                                              *
+ *                                                                                       *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,   *
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A         *
+ * PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT    *
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF  *
+ * CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE  *
+ * OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                                         *
+ ****************************************************************************************/
+
+#include <ghoul/misc/assert.h>
+
+namespace openspace {
+
+template <typename T>
+LockFreeQueue<T>::LockFreeQueue(size_t capacity)
+    : _buffer(capacity + 1)
+{
+    ghoul_assert(capacity > 0, "Capacity must be positive");
+}
+
+template <typename T>
+bool LockFreeQueue<T>::tryPush(T&& item) {
+    const size_t tail = _tail.load(std::memory_order_relaxed);
+    const size_t next = (tail + 1) % _buffer.size();
+    if (next == _head.load(std::memory_order_acquire)) {
+        // The queue is full
+        return false;
+    }
+
+    _buffer[tail] = std::move(item);
+    _tail.store(next, std::memory_order_release);
+    return true;
+}
+
+template <typename T>
+bool LockFreeQueue<T>::tryPop(T& item) {
+    const size_t head = _head.load(std::memory_order_relaxed);
+    if (head == _tail.load(std::memory_order_acquire)) {
+        // The queue is empty
+        return false;
+    }
+
+    item = std::move(_buffer[head]);
+    _head.store((head + 1) % _buffer.size(), std::memory_order_release);
+    return true;
+}
+
+template <typename T>
+size_t LockFreeQueue<T>::size() const {
+    const size_t head = _head.load(std::memory_order_acquire);
+    const size_t tail = _tail.load(std::memory_order_acquire);
+    return tail >= head ? tail - head : _buffer.size() - head + tail;
+}
+
+template <typename T>
+bool LockFreeQueue<T>::empty() const {
+    return size() == 0;
+}
+
+template <typename T>
+size_t LockFreeQueue<T>::capacity() const {
+    return _buffer.size() - 1;
+}
+
+} // namespace openspace
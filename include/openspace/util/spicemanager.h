@@ -31,10 +31,12 @@
 #include <ghoul/misc/boolean.h>
 #include <ghoul/misc/exception.h>
 #include <array>
+#include <filesystem>
 #include <map>
+#include <mutex>
 #include <string>
-#include <vector>
 #include <set>
+#include <vector>
 
 #ifdef __clang__
 #pragma clang diagnostic push
@@ -59,6 +61,11 @@ namespace scripting { struct LuaLibrary; }
 
 void throwSpiceError(const std::string& errorMessage);
 
+/**
+ * The SpiceManager wraps the CSPICE library, which is not thread-safe. All member
+ * functions are serialized through an internal mutex, so that the SpiceManager can be
+ * used from worker threads, for example to sample trails in the background.
+ */
 class SpiceManager {
 public:
     BooleanType(UseException);
@@ -234,6 +241,14 @@ public:
      */
     void unloadKernel(std::string filePath);
 
+    /**
+     * Returns the paths of all kernels that are currently loaded in the order in which
+     * they were loaded.
+     *
+     * \return The paths of all loaded kernels
+     */
+    std::vector<std::filesystem::path> loadedKernels() const;
+
     /**
      * Returns whether a given \p target has an Spk kernel covering it at the designated
      * \p et ephemeris time.
@@ -557,6 +572,7 @@ public:
         static_assert(N != 0, "Format must not be empty");
         ghoul_assert(N >= bufferSize - 1, "Buffer size too small");
 
+        std::lock_guard lock(_mutex);
         timout_c(ephemerisTime, format, bufferSize, outBuf);
         if (failed_c()) {
             throwSpiceError(fmt::format(
@@ -1100,6 +1116,9 @@ private:
     /// The last assigned kernel-id, used to determine the next free kernel id
     KernelHandle _lastAssignedKernel = KernelHandle(0);
 
+    /// Serializes all calls into CSPICE and all accesses to the kernel information
+    mutable std::recursive_mutex _mutex;
+
     static SpiceManager* _instance;
 };
 
@@ -0,0 +1,198 @@
+/*****************************************************************************************
+ *                                                                                       *
+ * OpenSpace                                                                             *
+ *                                                                                       *
+ * Copyright (c) 2014-2023                                                               *
+ *                                                                                       *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this  *
+ * software and associated documentation files (the "Software"), to deal in the Software *
+ * without restriction, including without limitation the rights to use, copy, modify,    *
+ * merge, publish, distribute, sublicense, and/or sell copies of the Software, and to    *
+ * permit persons to whom the Software is furnished to do so, subject to the following   *
+ * conditions:                                                                           *
+ *                                                                                       *
+ * The above copyright notice and this permission notice shall be included in all copies *
+ * or substantial portions of the Software.                                              *
+ *                                                                                       *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,   *
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A         *
+ * PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT    *
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF  *
+ * CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE  *
+ * OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                                         *
+ ****************************************************************************************/
+
+
+#ifndef __OPENSPACE_CORE___STARTUPTRACE___H__
+#define __OPENSPACE_CORE___STARTUPTRACE___H__
+
+#include <array>
+#include <chrono>
+#include <filesystem>
+#include <map>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace openspace {
+
+/**
+ * This class records a timeline of the loading of a scene. For each item, which usually
+ * is the path of an asset, the time spans of the individual loading phases (see #Phase)
+ * are recorded. Together with the dependencies between items, which are registered with
+ * #addDependency, this information is used to compute the critical path through the
+ * loading process, that is, the chain of phases that determined how long the loading
+ * took in total.
+ *
+ * Scene graph nodes are attributed to the item that was active (see #setActiveItem) when
+ * they were added with #addNode. Their phases are merged into the phases of that item.
+ *
+ * The timeline can be saved as a JSON file in the Trace Event Format which can be opened
+ * with `chrome://tracing` or https://ui.perfetto.dev.
+ *
+ * All functions of this class are thread-safe.
+ */
+class StartupTrace {
+public:
+    using Clock = std::chrono::steady_clock;
+
+    enum class Phase {
+        /// The execution of the asset file
+        Parse = 0,
+        /// The synchronization of the resources of the asset and of all of the assets it
+        /// requires
+        Synchronize,
+        /// The `onInitialize` function of the asset and the initialization of the scene
+        /// graph nodes that were created by it
+        Initialize,
+        /// The initialization of the OpenGL resources of the scene graph nodes that were
+        /// created by the asset
+        InitializeGL
+    };
+    static constexpr int NPhases = 4;
+
+    /// A single phase of an item on the critical path
+    struct Segment {
+        std::string item;
+        Phase phase;
+        Clock::duration begin;
+        Clock::duration end;
+    };
+
+    StartupTrace();
+
+    /**
+     * Marks the beginning of the \p phase for the \p item. If the phase has already been
+     * started for this item, the earlier time is kept.
+     *
+     * \param item The identifier of the item, usually the path of an asset
+     * \param phase The phase that begins
+     */
+    void begin(const std::string& item, Phase phase);
+
+    /**
+     * Marks the end of the \p phase for the \p item. If the phase has already been ended
+     * for this item, the later time is kept. If the phase has not been started, the
+     * phase is assumed to begin and end at the same time.
+     *
+     * \param item The identifier of the item, usually the path of an asset
+     * \param phase The phase that ends
+     */
+    void end(const std::string& item, Phase phase);
+
+    /**
+     * Registers that the \p item depends on the \p dependency, which means that each
+     * phase other than Phase::Parse of the \p item can only finish after the same phase
+     * of the \p dependency has finished.
+     *
+     * \param item The item that depends on \p dependency
+     * \param dependency The item that \p item depends on
+     */
+    void addDependency(const std::string& item, const std::string& dependency);
+
+    /**
+     * Sets the item to which all scene graph nodes that are added with #addNode are
+     * attributed until this function is called again. An empty \p item stops the
+     * attribution.
+     *
+     * \param item The identifier of the item that is currently active
+     */
+    void setActiveItem(std::string item);
+
+    /**
+     * Attributes the scene graph node with the identifier \p node to the currently
+     * active item. If no item is active, the node is ignored.
+     *
+     * \param node The identifier of the scene graph node
+     */
+    void addNode(const std::string& node);
+
+    /**
+     * Marks the beginning of the \p phase for the item that owns the scene graph node
+     * \p node. If the node has not been added through #addNode, nothing happens.
+     */
+    void beginNode(const std::string& node, Phase phase);
+
+    /**
+     * Marks the end of the \p phase for the item that owns the scene graph node \p node.
+     * If the node has not been added through #addNode, nothing happens.
+     */
+    void endNode(const std::string& node, Phase phase);
+
+    /**
+     * Returns the critical path, starting with the first and ending with the last phase
+     * that finished. The path is found by starting at the phase that finished last and
+     * repeatedly stepping to the predecessor that finished last. The predecessors of a
+     * phase are the previous phase of the same item and the same phase of all of the
+     * item's dependencies.
+     *
+     * \return The segments on the critical path in chronological order
+     */
+    std::vector<Segment> criticalPath() const;
+
+    /**
+     * Returns the time that has passed between the creation of this StartupTrace and the
+     * last end of any phase.
+     */
+    Clock::duration duration() const;
+
+    /**
+     * Saves the recorded timeline and the critical path to the file at \p path in the
+     * Trace Event Format.
+     *
+     * \param path The path to the file that will be created. An existing file is
+     *        overwritten
+     * \throw ghoul::RuntimeError If the file could not be written
+     */
+    void save(const std::filesystem::path& path) const;
+
+    /**
+     * Returns the name of the provided \p phase.
+     */
+    static std::string_view nameForPhase(Phase phase);
+
+private:
+    struct Item {
+        std::array<std::optional<Clock::duration>, NPhases> begin;
+        std::array<std::optional<Clock::duration>, NPhases> end;
+        std::vector<std::string> dependencies;
+        /// The order in which the item was first seen, used as the row in the trace file
+        size_t index = 0;
+    };
+
+    Item& item(const std::string& identifier);
+    std::vector<Segment> criticalPathLocked() const;
+
+    const Clock::time_point _start;
+
+    std::map<std::string, Item> _items;
+    std::unordered_map<std::string, std::string> _nodeOwners;
+    std::string _activeItem;
+    mutable std::mutex _mutex;
+};
+
+} // namespace openspace
+
+#endif // __OPENSPACE_CORE___STARTUPTRACE___H__
@@ -42,6 +42,14 @@ public:
     virtual void perform(const ProgressCallback& onProgress) = 0;
     virtual std::string description() = 0;
 
+    /**
+     * Returns whether this task can be performed at the same time as other tasks. Tasks
+     * that use global state, for example by loading kernels into the SpiceManager, are
+     * not thread-safe, which is the default. A task that is not thread-safe is never
+     * performed concurrently with any other task.
+     */
+    virtual bool isThreadSafe() const;
+
     static std::unique_ptr<Task> createFromDictionary(
         const ghoul::Dictionary& dictionary
     );
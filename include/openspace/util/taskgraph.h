@@ -0,0 +1,117 @@
+/*****************************************************************************************
+ *                                                                                       *
+ * OpenSpace                                                                             *
+ *                                                                                       *
+ * Copyright (c) 2014-2023                                                               *
+ *                                                                                       *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this  *
+ * software and associated documentation files (the "Software"), to deal in the Software *
+ * without restriction, including without limitation the rights to use, copy, modify,    *
+ * merge, publish, distribute, sublicense, and/or sell copies of the Software, and to    *
+ * permit persons to whom the Software is furnished to do so, subject to the following   *
+ * conditions:                                                                           *
+ *                                                                                       *
+ * The above copyright notice and this permission notice shall be included in all copies *
+ * or substantial portions of the Software.                                              *
+ *                                                                                       *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,   *
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A         *
+ * PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT    *
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF  *
+ * CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE  *
+ * OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                                         *
+ ****************************************************************************************/
+
+#ifndef __OPENSPACE_CORE___TASKGRAPH___H__
+#define __OPENSPACE_CORE___TASKGRAPH___H__
+
+#include <openspace/util/task.h>
+#include <chrono>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace openspace {
+
+/**
+ * A TaskGraph contains a number of Task%s together with the dependencies between them.
+ * When the graph is performed, each task is started as soon as all of the tasks it
+ * depends on have finished, so that independent tasks are performed concurrently on up
+ * to a specified number of worker threads. Tasks that are not thread-safe (see
+ * Task::isThreadSafe) are always performed on their own. If a task fails, all tasks that
+ * depend on it, directly or indirectly, are skipped, but all other tasks are still
+ * performed.
+ */
+class TaskGraph {
+public:
+    enum class Status {
+        Succeeded,
+        Failed,
+        /// The task was not performed as one of its dependencies did not succeed
+        Skipped
+    };
+
+    struct Result {
+        std::string description;
+        Status status = Status::Skipped;
+        /// The error message if the task failed or the reason why it was skipped
+        std::string error;
+        std::chrono::duration<double> duration = std::chrono::duration<double>(0.0);
+        /// The highest memory usage of the entire process while the task was running,
+        /// in bytes. As tasks run concurrently, this value is an upper bound
+        size_t peakMemory = 0;
+    };
+
+    /**
+     * Adds the provided \p task to the graph and returns its index, which can be used
+     * to refer to the task in #addDependency and in the results of #perform.
+     *
+     * \param task The task that is added
+     * \return The index of the added task
+     * \pre \p task must not be nullptr
+     */
+    size_t addTask(std::unique_ptr<Task> task);
+
+    /**
+     * Specifies that the task with the index \p task can only be performed after the
+     * task with the index \p dependency has finished successfully.
+     *
+     * \param task The index of the task that has the dependency
+     * \param dependency The index of the task that \p task depends on
+     * \pre \p task and \p dependency must be valid indices and must be different
+     */
+    void addDependency(size_t task, size_t dependency);
+
+    size_t nTasks() const;
+
+    /**
+     * Returns the indices of all tasks that the task with the index \p task depends on.
+     */
+    const std::vector<size_t>& dependencies(size_t task) const;
+
+    /**
+     * Performs all tasks in this graph, with at most \p nWorkers tasks running at the
+     * same time, and returns once all tasks have finished or have been skipped. Tasks
+     * that are part of a dependency cycle are skipped. The \p onProgress callback is
+     * called with the combined progress of all tasks. It is only called by one thread
+     * at a time, but not necessarily by the thread that called this function.
+     *
+     * \param nWorkers The maximum number of tasks that are performed concurrently
+     * \param onProgress The callback that is called with the overall progress
+     * \return The results of all tasks, in the same order as they were added
+     * \pre \p nWorkers must be positive
+     */
+    std::vector<Result> perform(unsigned int nWorkers,
+        const Task::ProgressCallback& onProgress = Task::ProgressCallback());
+
+private:
+    struct Node {
+        std::unique_ptr<Task> task;
+        std::vector<size_t> dependencies;
+    };
+    std::vector<Node> _nodes;
+};
+
+} // namespace openspace
+
+#endif // __OPENSPACE_CORE___TASKGRAPH___H__
@@ -25,6 +25,7 @@
 #ifndef __OPENSPACE_CORE___TASKLOADER___H__
 #define __OPENSPACE_CORE___TASKLOADER___H__
 
+#include <openspace/util/taskgraph.h>
 #include <memory>
 #include <string>
 #include <vector>
@@ -33,14 +34,24 @@ namespace ghoul { class Dictionary; }
 
 namespace openspace {
 
-class Task;
-
 class TaskLoader {
 public:
     std::vector<std::unique_ptr<Task>> tasksFromDictionary(
         const ghoul::Dictionary& tasksDictionary);
 
     std::vector<std::unique_ptr<Task>> tasksFromFile(const std::string& path);
+
+    /**
+     * Loads all tasks from the task file at \p path into a TaskGraph. A task depends on
+     * the tasks that are listed in its `Dependencies` and on every earlier task in the
+     * file with `Outputs` that contain, or are contained in, one of the paths listed in
+     * the task's `Inputs` or `Outputs`.
+     *
+     * \param path The path to the task file
+     * \return The graph of all tasks in the file, which is empty if the file could not
+     *         be loaded
+     */
+    TaskGraph taskGraphFromFile(const std::string& path);
 };
 
 } // namespace openspace
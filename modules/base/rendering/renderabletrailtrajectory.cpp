@@ -27,13 +27,19 @@
 #include <openspace/documentation/documentation.h>
 #include <openspace/documentation/verifier.h>
 #include <openspace/scene/translation.h>
+#include <openspace/util/cachefiles.h>
 #include <openspace/util/spicemanager.h>
 #include <openspace/util/updatestructures.h>
+#include <ghoul/filesystem/filesystem.h>
+#include <ghoul/logging/logmanager.h>
+#include <algorithm>
 #include <optional>
 
 // This class creates the entire trajectory at once and keeps it in memory the entire
-// time. This means that there is no need for updating the trail at runtime, but also that
-// the whole trail has to fit in memory.
+// time. The trajectory is sampled by a TrajectorySampler, on a worker thread if the
+// translation supports it, and the samples are cached on disk. While the sampling is
+// running, the coarse samples are shown. This means that there is no need for updating
+// the trail at runtime, but also that the whole trail has to fit in memory.
 // Opposed to the RenderableTrailOrbit, no index buffer is needed as the vertex can be
 // written into the vertex buffer object continuously and then selected by using the
 // count variable from the RenderInformation struct to toggle rendering of the entire path
@@ -44,6 +50,15 @@
 // _endTime. This buffer is updated every frame.
 
 namespace {
+    constexpr std::string_view _loggerCat = "RenderableTrailTrajectory";
+
+    // The maximum number of vertices of the trail
+    constexpr size_t MaxNumberOfVertices = 1000000;
+
+    // The number of positions that the worker thread evaluates between checking whether
+    // the sampling was cancelled
+    constexpr size_t WorkerChunkSize = 256;
+
     constexpr openspace::properties::Property::PropertyInfo StartTimeInfo = {
         "StartTime",
         "Start Time",
@@ -92,13 +107,34 @@ namespace {
     constexpr openspace::properties::Property::PropertyInfo SweepChunkSizeInfo = {
         "SweepChunkSize",
         "Sweep Chunk Size",
-        "The number of vertices that will be calculated each frame whenever the trail "
-        "needs to be recalculated. "
+        "The number of positions that will be calculated each frame whenever the trail "
+        "needs to be recalculated on the main thread, which is the case if the "
+        "translation cannot be evaluated on a worker thread. "
         "A greater value will result in more calculations per frame.",
         // @VISIBILITY(?)
         openspace::properties::Property::Visibility::AdvancedUser
     };
 
+    constexpr openspace::properties::Property::PropertyInfo AdaptiveSamplingInfo = {
+        "AdaptiveSampling",
+        "Adaptive Sampling",
+        "If this value is 'true', the trajectory is sampled more densely where it bends "
+        "and more sparsely where it is straight, but never more densely than once every "
+        "'SampleInterval' / 'TimeStampSubsampleFactor' seconds. The points that are "
+        "drawn along the trail are then no longer equally far apart in time. If it is "
+        "'false', which is the default, the samples are spaced evenly in time",
+        openspace::properties::Property::Visibility::AdvancedUser
+    };
+
+    constexpr openspace::properties::Property::PropertyInfo MaximumErrorInfo = {
+        "MaximumError",
+        "Maximum Error",
+        "The maximum distance between the rendered trail and the actual trajectory if "
+        "the trajectory is sampled adaptively, relative to the length of each line "
+        "segment of the trail. Smaller values result in more vertices",
+        openspace::properties::Property::Visibility::AdvancedUser
+    };
+
     struct [[codegen::Dictionary(RenderableTrailTrajectory)]] Parameters {
         // [[codegen::verbatim(StartTimeInfo.description)]]
         std::string startTime [[codegen::annotation("A valid date in ISO 8601 format")]];
@@ -117,6 +153,12 @@ namespace {
 
         // [[codegen::verbatim(SweepChunkSizeInfo.description)]]
         std::optional<int> sweepChunkSize;
+
+        // [[codegen::verbatim(AdaptiveSamplingInfo.description)]]
+        std::optional<bool> adaptiveSampling;
+
+        // [[codegen::verbatim(MaximumErrorInfo.description)]]
+        std::optional<double> maximumError [[codegen::greater(0.0)]];
     };
 #include "renderabletrailtrajectory_codegen.cpp"
 } // namespace
@@ -137,8 +179,8 @@ RenderableTrailTrajectory::RenderableTrailTrajectory(const ghoul::Dictionary& di
     , _sampleInterval(SampleIntervalInfo, 2.0, 2.0, 1e6)
     , _timeStampSubsamplingFactor(TimeSubSampleInfo, 1, 1, 1000000000)
     , _renderFullTrail(RenderFullPathInfo, false)
-    , _maxVertex(glm::vec3(-std::numeric_limits<float>::max()))
-    , _minVertex(glm::vec3(std::numeric_limits<float>::max()))
+    , _adaptiveSampling(AdaptiveSamplingInfo, false)
+    , _maximumError(MaximumErrorInfo, 1e-3, 1e-7, 0.1)
 {
     const Parameters p = codegen::bake<Parameters>(dictionary);
 
@@ -164,12 +206,25 @@ RenderableTrailTrajectory::RenderableTrailTrajectory(const ghoul::Dictionary& di
     _renderFullTrail = p.showFullTrail.value_or(_renderFullTrail);
     addProperty(_renderFullTrail);
 
+    _adaptiveSampling = p.adaptiveSampling.value_or(_adaptiveSampling);
+    _adaptiveSampling.onChange([this] { reset(); });
+    addProperty(_adaptiveSampling);
+
+    _maximumError = p.maximumError.value_or(_maximumError);
+    _maximumError.onChange([this] { reset(); });
+    addProperty(_maximumError);
+
     _sweepChunkSize = p.sweepChunkSize.value_or(_sweepChunkSize);
 
     // We store the vertices with ascending temporal order
     _primaryRenderInformation.sorting = RenderInformation::VertexSorting::OldestFirst;
 }
 
+RenderableTrailTrajectory::~RenderableTrailTrajectory() {
+    // The worker thread uses the translation, so it has to finish before it is destroyed
+    cancelSweep();
+}
+
 void RenderableTrailTrajectory::initializeGL() {
     RenderableTrail::initializeGL();
 
@@ -185,6 +240,9 @@ void RenderableTrailTrajectory::initializeGL() {
 }
 
 void RenderableTrailTrajectory::deinitializeGL() {
+    cancelSweep();
+    _needsFullSweep = true;
+
     glDeleteVertexArrays(1, &_primaryRenderInformation._vaoID);
     glDeleteBuffers(1, &_primaryRenderInformation._vBufferID);
 
@@ -195,105 +253,210 @@ void RenderableTrailTrajectory::deinitializeGL() {
 }
 
 void RenderableTrailTrajectory::reset() {
+    cancelSweep();
     _needsFullSweep = true;
-    _sweepIteration = 0;
-    _maxVertex = glm::vec3(-std::numeric_limits<float>::max());
-    _minVertex = glm::vec3(std::numeric_limits<float>::max());
 }
 
-void RenderableTrailTrajectory::update(const UpdateData& data) {
-    if (_needsFullSweep) {
+void RenderableTrailTrajectory::cancelSweep() {
+    if (_sweep) {
+        _sweep->isCancelled = true;
+    }
+    if (_sweepWorker.valid()) {
+        _sweepWorker.wait();
+    }
+    _sweep = nullptr;
+    _sampler = nullptr;
+}
 
-        if (_sweepIteration == 0) {
-            // Max number of vertices
-            constexpr unsigned int maxNumberOfVertices = 1000000;
-
-            // Convert the start and end time from string representations to J2000 seconds
-            _start = SpiceManager::ref().ephemerisTimeFromDate(_startTime);
-            _end = SpiceManager::ref().ephemerisTimeFromDate(_endTime);
-            double timespan = _end - _start;
-
-            _totalSampleInterval = _sampleInterval / _timeStampSubsamplingFactor;
-
-            // Cap _numberOfVertices in order to prevent overflow and extreme performance
-            // degredation/RAM usage
-            _numberOfVertices = std::min(
-                static_cast<unsigned int>(std::ceil(timespan / _totalSampleInterval)),
-                maxNumberOfVertices
-            );
-
-            // We need to recalcuate the _totalSampleInterval if _numberOfVertices eqals
-            // maxNumberOfVertices. If we don't do this the position for each vertex
-            // will not be correct for the number of vertices we are doing along the trail
-            _totalSampleInterval = (_numberOfVertices == maxNumberOfVertices) ?
-                (timespan / _numberOfVertices) : _totalSampleInterval;
-
-            // Make space for the vertices
-            _vertexArray.clear();
-            _vertexArray.resize(_numberOfVertices + 1);
-        }
+void RenderableTrailTrajectory::startSweep() {
+    TrajectorySampler::Settings settings;
+    // Convert the start and end time from string representations to J2000 seconds
+    settings.start = SpiceManager::ref().ephemerisTimeFromDate(_startTime);
+    settings.end = SpiceManager::ref().ephemerisTimeFromDate(_endTime);
+    settings.minimumInterval = _sampleInterval / _timeStampSubsamplingFactor;
+    settings.maximumError = _maximumError;
+    settings.isAdaptive = _adaptiveSampling;
+    settings.maximumSamples = MaxNumberOfVertices;
+
+    Translation* translation = _translation.get();
+    TrajectorySampler::PositionFunction position = [translation](double time) {
+        return translation->position({ {}, Time(time), Time(0.0) });
+    };
 
-        // Calculate sweeping range for this iteration
-        unsigned int startIndex = _sweepIteration * _sweepChunkSize;
-        unsigned int nextIndex = (_sweepIteration + 1) * _sweepChunkSize;
-        unsigned int stopIndex = std::min(nextIndex, _numberOfVertices);
-
-        // Calculate all vertex positions
-        for (unsigned int i = startIndex; i < stopIndex; ++i) {
-            const glm::vec3 p = _translation->position({
-                {},
-                Time(_start + i * _totalSampleInterval),
-                Time(0.0)
-            });
-            _vertexArray[i] = { p.x, p.y, p.z };
-
-            // Set max and min vertex for bounding sphere calculations
-            _maxVertex = glm::max(_maxVertex, p);
-            _minVertex = glm::min(_minVertex, p);
-        }
-        ++_sweepIteration;
-
-        // Full sweep is complete here.
-        // Adds the last point in time to the _vertexArray so that we
-        // ensure that points for _start and _end always exists
-        if (stopIndex == _numberOfVertices) {
-            const glm::vec3 p = _translation->position({
-                {},
-                Time(_end),
-                Time(0.0)
-            });
-            _vertexArray[stopIndex] = { p.x, p.y, p.z };
-
-            _sweepIteration = 0;
-            setBoundingSphere(glm::distance(_maxVertex, _minVertex) / 2.f);
+    // The cache is identified by the translation and the sampling settings. A few
+    // positions are included as well so that changes to the data of the translation,
+    // for example a different set of SPICE kernels, invalidate the cache
+    std::string key = fmt::format(
+        "{}|{}|{}|{}|{}|{}",
+        _translation->type(), settings.start, settings.end, settings.minimumInterval,
+        settings.isAdaptive, settings.maximumError
+    );
+    for (const properties::Property* p : _translation->propertiesRecursive()) {
+        key += fmt::format("|{}={}", p->identifier(), p->stringValue());
+    }
+    const double center = (settings.start + settings.end) / 2.0;
+    for (double t : { settings.start, center, settings.end }) {
+        const glm::dvec3 p = position(t);
+        key += fmt::format("|{},{},{}", p.x, p.y, p.z);
+    }
+    _cacheFile = cachedFilename("trailtrajectory.cache", key);
+    _sweepStartTime = std::chrono::steady_clock::now();
+
+    if (!_translation->isThreadSafe()) {
+        std::optional<std::vector<TrajectorySampler::Sample>> cached =
+            TrajectorySampler::loadCache(_cacheFile);
+        if (cached.has_value()) {
+            applySamples(*cached);
         }
         else {
-            // Early return as we don't need to render if we are still
-            // doing full sweep calculations
-            return;
+            _sampler = std::make_unique<TrajectorySampler>(settings, std::move(position));
         }
+        return;
+    }
 
-        // Upload vertices to the GPU
-        glBindVertexArray(_primaryRenderInformation._vaoID);
-        glBindBuffer(GL_ARRAY_BUFFER, _primaryRenderInformation._vBufferID);
-        glBufferData(
-            GL_ARRAY_BUFFER,
-            _vertexArray.size() * sizeof(TrailVBOLayout),
-            _vertexArray.data(),
-            GL_STATIC_DRAW
-        );
+    // The job only captures copies so that it does not depend on the renderable, apart
+    // from the translation, which is kept alive until the job is finished
+    _sweep = std::make_shared<Sweep>();
+    _sweepWorker = std::async(
+        std::launch::async,
+        [sweep = _sweep, settings, position, cacheFile = _cacheFile]() {
+            auto publish = [&sweep](std::vector<TrajectorySampler::Sample> samples,
+                                    bool isFinished)
+            {
+                std::lock_guard lock(sweep->mutex);
+                sweep->samples = std::move(samples);
+                sweep->hasNewSamples = !sweep->samples.empty();
+                sweep->isFinished = isFinished;
+            };
+
+            try {
+                std::optional<std::vector<TrajectorySampler::Sample>> cached =
+                    TrajectorySampler::loadCache(cacheFile);
+                if (cached.has_value()) {
+                    publish(std::move(*cached), true);
+                    return;
+                }
+
+                TrajectorySampler sampler(settings, position);
+                bool hasPublishedCoarseSamples = false;
+                while (!sampler.step(WorkerChunkSize)) {
+                    if (sweep->isCancelled) {
+                        return;
+                    }
+                    if (!hasPublishedCoarseSamples && sampler.hasCoarseSamples()) {
+                        publish(sampler.samples(), false);
+                        hasPublishedCoarseSamples = true;
+                    }
+                }
+                TrajectorySampler::saveCache(cacheFile, sampler.samples());
+                publish(sampler.samples(), true);
+            }
+            catch (const ghoul::RuntimeError& e) {
+                LERRORC(e.component, e.message);
+                publish({}, true);
+            }
+        }
+    );
+}
 
-        glEnableVertexAttribArray(0);
-        glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 0, nullptr);
+void RenderableTrailTrajectory::applySamples(
+                                 const std::vector<TrajectorySampler::Sample>& samples)
+{
+    if (samples.empty()) {
+        return;
+    }
+
+    _vertexArray.resize(samples.size());
+    _timestamps.resize(samples.size());
+
+    // Max and min vertex used to calculate the bounding sphere
+    glm::vec3 maxVertex = glm::vec3(-std::numeric_limits<float>::max());
+    glm::vec3 minVertex = glm::vec3(std::numeric_limits<float>::max());
+    for (size_t i = 0; i < samples.size(); ++i) {
+        const glm::vec3 p = samples[i].position;
+        _vertexArray[i] = { p.x, p.y, p.z };
+        _timestamps[i] = samples[i].time;
 
-        // We clear the indexArray just in case. The base class will take care not to use
-        // it if it is empty
-        _indexArray.clear();
+        maxVertex = glm::max(maxVertex, p);
+        minVertex = glm::min(minVertex, p);
+    }
+    _start = _timestamps.front();
+    _end = _timestamps.back();
+    setBoundingSphere(glm::distance(maxVertex, minVertex) / 2.f);
+
+    // Upload vertices to the GPU
+    glBindVertexArray(_primaryRenderInformation._vaoID);
+    glBindBuffer(GL_ARRAY_BUFFER, _primaryRenderInformation._vBufferID);
+    glBufferData(
+        GL_ARRAY_BUFFER,
+        _vertexArray.size() * sizeof(TrailVBOLayout),
+        _vertexArray.data(),
+        GL_STATIC_DRAW
+    );
+
+    glEnableVertexAttribArray(0);
+    glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 0, nullptr);
+
+    // We clear the indexArray just in case. The base class will take care not to use
+    // it if it is empty
+    _indexArray.clear();
 
-        _subsamplingIsDirty = true;
+    _subsamplingIsDirty = true;
+}
+
+void RenderableTrailTrajectory::update(const UpdateData& data) {
+    if (_needsFullSweep) {
+        startSweep();
         _needsFullSweep = false;
     }
 
+    bool sweepFinished = false;
+    if (_sampler) {
+        // The translation can only be evaluated on the main thread
+        const bool hadCoarseSamples = _sampler->hasCoarseSamples();
+        if (_sampler->step(_sweepChunkSize)) {
+            TrajectorySampler::saveCache(_cacheFile, _sampler->samples());
+            applySamples(_sampler->samples());
+            _sampler = nullptr;
+            sweepFinished = true;
+        }
+        else if (!hadCoarseSamples && _sampler->hasCoarseSamples()) {
+            applySamples(_sampler->samples());
+        }
+    }
+    else if (_sweep) {
+        std::vector<TrajectorySampler::Sample> samples;
+        {
+            std::lock_guard lock(_sweep->mutex);
+            if (_sweep->hasNewSamples) {
+                samples = std::move(_sweep->samples);
+                _sweep->hasNewSamples = false;
+            }
+            sweepFinished = _sweep->isFinished;
+        }
+        applySamples(samples);
+        if (sweepFinished) {
+            _sweepWorker.wait();
+            _sweep = nullptr;
+        }
+    }
+
+    if (sweepFinished) {
+        const double seconds = std::chrono::duration<double>(
+            std::chrono::steady_clock::now() - _sweepStartTime
+        ).count();
+        LDEBUG(fmt::format(
+            "Sampled {} vertices of {} in {:.3f} s",
+            _vertexArray.size(), _cacheFile, seconds
+        ));
+    }
+
+    if (_vertexArray.empty()) {
+        // Nothing to render until the first samples are available
+        glBindVertexArray(0);
+        return;
+    }
+
     // This has to be done every update step;
     if (_renderFullTrail) {
         // If the full trail should be rendered at all times, we can directly render the
@@ -305,22 +468,14 @@ void RenderableTrailTrajectory::update(const UpdateData& data) {
         // If only trail so far should be rendered, we need to find the corresponding time
         // in the array and only render it until then
         _primaryRenderInformation.first = 0;
-        const double t = std::max(
-            0.0,
-            (data.time.j2000Seconds() - _start) / (_end - _start)
+        const auto it = std::upper_bound(
+            _timestamps.begin(),
+            _timestamps.end(),
+            data.time.j2000Seconds()
+        );
+        _primaryRenderInformation.count = static_cast<GLsizei>(
+            std::max<std::ptrdiff_t>(1, std::distance(_timestamps.begin(), it))
         );
-        if (data.time.j2000Seconds() < _end) {
-            _primaryRenderInformation.count = static_cast<GLsizei>(
-                std::max(
-                    1.0,
-                    floor(_vertexArray.size() - 1) * t
-                )
-                );
-        }
-        else {
-            _primaryRenderInformation.count = static_cast<GLsizei>(_vertexArray.size());
-        }
-
     }
 
     // If we are inside the valid time, we additionally want to draw a line from the last
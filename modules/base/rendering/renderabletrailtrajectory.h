@@ -27,11 +27,18 @@
 
 #include <modules/base/rendering/renderabletrail.h>
 
+#include <modules/base/rendering/trajectorysampler.h>
 #include <openspace/properties/stringproperty.h>
 #include <openspace/properties/scalar/boolproperty.h>
 #include <openspace/properties/scalar/doubleproperty.h>
 #include <openspace/properties/scalar/intproperty.h>
 #include <array>
+#include <atomic>
+#include <chrono>
+#include <filesystem>
+#include <future>
+#include <memory>
+#include <mutex>
 
 namespace openspace {
 
@@ -39,9 +46,12 @@ namespace documentation { struct Documentation; }
 
 /**
  * This concrete implementation of a RenderableTrail renders a fixed trail, regardless of
- * its shape. The trail is sampled equitemporal (with an interval of _sampleInterval in
- * seconds) between the _startTime and the _endTime. No further update is needed until any
- * of these three values is changed. If _renderFullTrail is true, the entirety of the
+ * its shape. The trail is sampled between the _startTime and the _endTime, either
+ * adaptively with more samples where the trajectory bends, or equitemporal with an
+ * interval of _sampleInterval in seconds (see TrajectorySampler). If the translation is
+ * thread-safe, the sampling is performed on a worker thread; otherwise it is spread over
+ * multiple frames. The samples are cached on disk. No further update is needed until any
+ * of these values is changed. If _renderFullTrail is true, the entirety of the
  * trail is rendered, regardless of the simulation time. If it is false, the trail is only
  * rendered from the past to the current simulation time, not showing any part of the
  * trail in the future. If _renderFullTrail is false, the current position of the object
@@ -51,6 +61,7 @@ namespace documentation { struct Documentation; }
 class RenderableTrailTrajectory : public RenderableTrail {
 public:
     explicit RenderableTrailTrajectory(const ghoul::Dictionary& dictionary);
+    ~RenderableTrailTrajectory() override;
 
     void initializeGL() override;
     void deinitializeGL() override;
@@ -60,11 +71,31 @@ public:
     static documentation::Documentation Documentation();
 
 private:
+    /// The state of a sampling that is performed on a worker thread
+    struct Sweep {
+        std::atomic_bool isCancelled = false;
+
+        std::mutex mutex;
+        /// The newest samples that have not been picked up by the main thread yet
+        std::vector<TrajectorySampler::Sample> samples;
+        bool hasNewSamples = false;
+        bool isFinished = false;
+    };
 
     /// Reset some variables to default state
     void reset();
 
-    /// The number of vertices that we calculate during each frame of the full sweep pass
+    /// Starts sampling the trajectory, either on a worker thread or on the main thread
+    void startSweep();
+
+    /// Stops a running sampling and waits for the worker thread to finish
+    void cancelSweep();
+
+    /// Replaces the vertices of the trail with \p samples and uploads them to the GPU
+    void applySamples(const std::vector<TrajectorySampler::Sample>& samples);
+
+    /// The number of positions that are evaluated each frame if the trajectory is
+    /// sampled on the main thread
     unsigned int _sweepChunkSize = 200;
 
     /// The start time of the trail
@@ -78,6 +109,10 @@ private:
     properties::IntProperty _timeStampSubsamplingFactor;
     /// Determines whether the full trail should be rendered or the future trail removed
     properties::BoolProperty _renderFullTrail;
+    /// Determines whether the trajectory is sampled adaptively or equitemporal
+    properties::BoolProperty _adaptiveSampling;
+    /// The maximum error relative to the segment length when sampling adaptively
+    properties::DoubleProperty _maximumError;
 
     /// Dirty flag that determines whether the full vertex buffer needs to be resampled
     bool _needsFullSweep = true;
@@ -87,23 +122,23 @@ private:
 
     std::array<TrailVBOLayout, 2> _auxiliaryVboData = {};
 
-    /// The conversion of the _startTime into the internal time format
+    /// The time of the first vertex of the trail
     double _start = 0.0;
-    /// The conversion of the _endTime into the internal time format
+    /// The time of the last vertex of the trail
     double _end = 0.0;
 
-    /// Tracks sweep iteration, is used to calculate which vertices to work on per frame
-    int _sweepIteration = 0;
-
-    /// How many points do we need to compute given the distance between the
-    /// start and end date and the desired sample interval
-    unsigned int _numberOfVertices = 0;
+    /// The time of each vertex in _vertexArray
+    std::vector<double> _timestamps;
 
-    double _totalSampleInterval = 0.0;
+    /// The sampler that is used if the trajectory is sampled on the main thread
+    std::unique_ptr<TrajectorySampler> _sampler;
+    /// The state of the sampling if the trajectory is sampled on a worker thread
+    std::shared_ptr<Sweep> _sweep;
+    std::future<void> _sweepWorker;
 
-    /// Max and min vertex used to calculate the bounding sphere
-    glm::vec3 _maxVertex;
-    glm::vec3 _minVertex;
+    /// The file in which the samples of the current sampling are cached
+    std::filesystem::path _cacheFile;
+    std::chrono::steady_clock::time_point _sweepStartTime;
 };
 
 } // namespace openspace
@@ -0,0 +1,212 @@
+/*****************************************************************************************
+ *                                                                                       *
+ * OpenSpace                                                                             *
+ *                                                                                       *
+ * Copyright (c) 2014-2023                                                               *
+ *                                                                                       *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this  *
+ * software and associated documentation files (the "Software"), to deal in the Software *
+ * without restriction, including without limitation the rights to use, copy, modify,    *
+ * merge, publish, distribute, sublicense, and/or sell copies of the Software, and to    *
+ * permit persons to whom the Software is furnished to do so, subject to the following   *
+ * conditions:                                                                           *
+ *                                                                                       *
+ * The above copyright notice and this permission notice shall be included in all copies *
+ * or substantial portions of the Software.                                              *
+ *                                                                                       *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,   *
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A         *
+ * PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT    *
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF  *
+ * CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE  *
+ * OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                                         *
+ ****************************************************************************************/
+
+
+#include <modules/base/rendering/trajectorysampler.h>
+
+#include <ghoul/misc/assert.h>
+#include <algorithm>
+#include <cmath>
+#include <fstream>
+
+namespace {
+    constexpr int8_t CurrentCacheVersion = 1;
+} // namespace
+
+namespace openspace {
+
+TrajectorySampler::TrajectorySampler(Settings settings, PositionFunction position)
+    : _settings(std::move(settings))
+    , _position(std::move(position))
+{
+    ghoul_precondition(_settings.minimumInterval > 0.0, "Interval must be positive");
+    ghoul_precondition(_settings.maximumSamples > 0, "Must allow samples");
+    ghoul_precondition(_position, "Position function must exist");
+
+    // Samples are taken every minimumInterval seconds, unless this would lead to more
+    // segments than are allowed, in which case the range is split evenly instead
+    const double span = std::max(_settings.end - _settings.start, 0.0);
+    const double nUniformSegments = std::ceil(span / _settings.minimumInterval);
+    const size_t maxSegments =
+        _settings.isAdaptive ? InitialSegments : _settings.maximumSamples;
+    if (nUniformSegments <= static_cast<double>(maxSegments)) {
+        _nGridSegments = static_cast<size_t>(nUniformSegments);
+        _gridInterval = _settings.minimumInterval;
+    }
+    else {
+        _nGridSegments = maxSegments;
+        _gridInterval = span / static_cast<double>(maxSegments);
+    }
+    _grid.reserve(_nGridSegments + 1);
+}
+
+bool TrajectorySampler::step(size_t nEvaluations) {
+    if (_isFinished) {
+        return true;
+    }
+
+    // Sample the coarse grid first. The last sample is always at the end time, even if
+    // the last segment is shorter than the others
+    while (_grid.size() <= _nGridSegments) {
+        if (nEvaluations == 0) {
+            return false;
+        }
+        const size_t i = _grid.size();
+        const double t = i < _nGridSegments ?
+            _settings.start + static_cast<double>(i) * _gridInterval :
+            _settings.end;
+        _grid.push_back({ t, _position(t) });
+        _nEvaluations++;
+        nEvaluations--;
+    }
+
+    if (!_settings.isAdaptive) {
+        _samples = std::move(_grid);
+        _isFinished = true;
+        return true;
+    }
+
+    // Refine one grid segment after the other. The parts of a segment are processed
+    // depth first with the earliest part first, so that the samples are created in
+    // ascending temporal order
+    if (_samples.empty()) {
+        _samples.push_back(_grid.front());
+    }
+    while (true) {
+        if (_stack.empty()) {
+            if (_gridSegment == _nGridSegments) {
+                break;
+            }
+            _stack.push_back({ _grid[_gridSegment], _grid[_gridSegment + 1] });
+            _gridSegment++;
+        }
+
+        const Segment segment = _stack.back();
+        const double center = (segment.begin.time + segment.end.time) / 2.0;
+        const bool canSplit =
+            center - segment.begin.time >= _settings.minimumInterval &&
+            _samples.size() + _stack.size() < _settings.maximumSamples;
+        if (!canSplit) {
+            _samples.push_back(segment.end);
+            _stack.pop_back();
+            continue;
+        }
+
+        if (nEvaluations == 0) {
+            return false;
+        }
+        const Sample centerSample = { center, _position(center) };
+        _nEvaluations++;
+        nEvaluations--;
+
+        _stack.pop_back();
+        if (needsRefinement(segment, centerSample)) {
+            _stack.push_back({ centerSample, segment.end });
+            _stack.push_back({ segment.begin, centerSample });
+        }
+        else {
+            _samples.push_back(segment.end);
+        }
+    }
+
+    _grid = std::vector<Sample>();
+    _isFinished = true;
+    return true;
+}
+
+bool TrajectorySampler::needsRefinement(const Segment& segment,
+                                        const Sample& center) const
+{
+    const glm::dvec3 chord = segment.end.position - segment.begin.position;
+    const glm::dvec3 offset = center.position - segment.begin.position;
+    const double length = glm::length(chord);
+    if (length == 0.0) {
+        // The segment might be a full revolution of an orbit
+        return glm::length(offset) > 0.0;
+    }
+
+    // Distance between the center sample and the closest point on the line segment
+    const double t = std::clamp(glm::dot(offset, chord) / (length * length), 0.0, 1.0);
+    const double deviation = glm::length(offset - t * chord);
+    return deviation > _settings.maximumError * length;
+}
+
+bool TrajectorySampler::isFinished() const {
+    return _isFinished;
+}
+
+bool TrajectorySampler::hasCoarseSamples() const {
+    return _isFinished || (_settings.isAdaptive && _grid.size() > _nGridSegments);
+}
+
+const std::vector<TrajectorySampler::Sample>& TrajectorySampler::samples() const {
+    return _isFinished ? _samples : _grid;
+}
+
+size_t TrajectorySampler::nEvaluations() const {
+    return _nEvaluations;
+}
+
+std::optional<std::vector<TrajectorySampler::Sample>> TrajectorySampler::loadCache(
+                                                       const std::filesystem::path& path)
+{
+    std::ifstream file(path, std::ifstream::binary);
+    if (!file.good()) {
+        return std::nullopt;
+    }
+
+    int8_t version = 0;
+    file.read(reinterpret_cast<char*>(&version), sizeof(int8_t));
+    uint64_t nSamples = 0;
+    file.read(reinterpret_cast<char*>(&nSamples), sizeof(uint64_t));
+    const uint64_t expectedSize =
+        sizeof(int8_t) + sizeof(uint64_t) + nSamples * sizeof(Sample);
+    if (!file.good() || version != CurrentCacheVersion || nSamples == 0 ||
+        std::filesystem::file_size(path) != expectedSize)
+    {
+        return std::nullopt;
+    }
+
+    std::vector<Sample> samples(nSamples);
+    file.read(reinterpret_cast<char*>(samples.data()), nSamples * sizeof(Sample));
+    if (!file.good()) {
+        return std::nullopt;
+    }
+    return samples;
+}
+
+void TrajectorySampler::saveCache(const std::filesystem::path& path,
+                                  const std::vector<Sample>& samples)
+{
+    std::ofstream file(path, std::ofstream::binary | std::ofstream::trunc);
+    file.write(reinterpret_cast<const char*>(&CurrentCacheVersion), sizeof(int8_t));
+    const uint64_t nSamples = samples.size();
+    file.write(reinterpret_cast<const char*>(&nSamples), sizeof(uint64_t));
+    file.write(
+        reinterpret_cast<const char*>(samples.data()),
+        nSamples * sizeof(Sample)
+    );
+}
+
+} // namespace openspace
@@ -0,0 +1,144 @@
+/*****************************************************************************************
+ *                                                                                       *
+ * OpenSpace                                                                             *
+ *                                                                                       *
+ * Copyright (c) 2014-2023                                                               *
+ *                                                                                       *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this  *
+ * software and associated documentation files (the "Software"), to deal in the Software *
+ * without restriction, including without limitation the rights to use, copy, modify,    *
+ * merge, publish, distribute, sublicense, and/or sell copies of the Software, and to    *
+ * permit persons to whom the Software is furnished to do so, subject to the following   *
+ * conditions:                                                                           *
+ *                                                                                       *
+ * The above copyright notice and this permission notice shall be included in all copies *
+ * or substantial portions of the Software.                                              *
+ *                                                                                       *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,   *
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A         *
+ * PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT    *
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF  *
+ * CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE  *
+ * OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                                         *
+ ****************************************************************************************/
+
+
+#ifndef __OPENSPACE_MODULE_BASE___TRAJECTORYSAMPLER___H__
+#define __OPENSPACE_MODULE_BASE___TRAJECTORYSAMPLER___H__
+
+#include <ghoul/glm.h>
+#include <filesystem>
+#include <functional>
+#include <optional>
+#include <vector>
+
+namespace openspace {
+
+/**
+ * Samples the positions of a trajectory between a start and an end time. With uniform
+ * sampling, a sample is taken every `minimumInterval` seconds. With adaptive sampling,
+ * the time range is first split into a coarse grid of at most InitialSegments segments
+ * that are then refined wherever the trajectory bends. A segment is split in half if the
+ * position at its center deviates from the straight line between its end points by more
+ * than `maximumError`, relative to the length of the segment. Since this ratio grows with
+ * the curvature of the trajectory, straight parts are covered by few samples and sharp
+ * turns, such as flybys, by many. Segments are never split below the `minimumInterval`.
+ *
+ * The sampling is performed incrementally through #step, so that it can be spread over
+ * multiple frames on the main thread or be cancelled when it runs on a worker thread.
+ */
+class TrajectorySampler {
+public:
+    struct Sample {
+        double time = 0.0;
+        glm::dvec3 position = glm::dvec3(0.0);
+
+        bool operator==(const Sample&) const = default;
+    };
+
+    struct Settings {
+        double start = 0.0;
+        double end = 0.0;
+        /// The smallest interval (in seconds) between two samples
+        double minimumInterval = 1.0;
+        /// The maximum deviation of the trajectory from the sampled line segments,
+        /// relative to the length of the segments
+        double maximumError = 1e-3;
+        bool isAdaptive = true;
+        /// The maximum number of samples. Once it is reached, no segment is refined
+        size_t maximumSamples = 1000000;
+    };
+
+    /// The maximum number of segments of the coarse grid for adaptive sampling
+    static constexpr size_t InitialSegments = 1024;
+
+    using PositionFunction = std::function<glm::dvec3(double)>;
+
+    TrajectorySampler(Settings settings, PositionFunction position);
+
+    /**
+     * Continues the sampling with at most \p nEvaluations evaluations of the position
+     * function. Returns `true` if the sampling is finished.
+     */
+    bool step(size_t nEvaluations);
+
+    bool isFinished() const;
+
+    /**
+     * Returns whether the coarse grid of samples has been computed. For uniform sampling
+     * this is only the case once the sampling is finished.
+     */
+    bool hasCoarseSamples() const;
+
+    /**
+     * Returns the samples in ascending temporal order, which always include the start and
+     * the end time. Until the sampling is finished, these are the samples of the coarse
+     * grid.
+     */
+    const std::vector<Sample>& samples() const;
+
+    /// Returns the number of times the position function has been evaluated
+    size_t nEvaluations() const;
+
+    /**
+     * Loads a list of samples that was previously stored using #saveCache. Returns an
+     * empty optional if the file does not exist or is not a valid cache file.
+     */
+    static std::optional<std::vector<Sample>> loadCache(
+        const std::filesystem::path& path);
+
+    /// Stores the list of \p samples in the cache file at the provided \p path
+    static void saveCache(const std::filesystem::path& path,
+        const std::vector<Sample>& samples);
+
+private:
+    struct Segment {
+        Sample begin;
+        Sample end;
+    };
+
+    bool needsRefinement(const Segment& segment, const Sample& center) const;
+
+    const Settings _settings;
+    const PositionFunction _position;
+
+    /// The number of segments and the interval between the samples of the grid
+    size_t _nGridSegments = 0;
+    double _gridInterval = 0.0;
+
+    std::vector<Sample> _grid;
+    std::vector<Sample> _samples;
+
+    /// The index of the grid segment that is currently being refined
+    size_t _gridSegment = 0;
+    /// The parts of the current grid segment that still have to be refined, with the
+    /// earliest part at the back
+    std::vector<Segment> _stack;
+
+    size_t _nEvaluations = 0;
+    bool _isFinished = false;
+};
+
+} // namespace openspace
+
+#endif // __OPENSPACE_MODULE_BASE___TRAJECTORYSAMPLER___H__
@@ -59,8 +59,9 @@ StaticTranslation::StaticTranslation()
     addProperty(_position);
 
     _position.onChange([this]() {
-        requireUpdate();
         notifyObservers();
+        _currentPosition = _position;
+        requireUpdate();
     });
     _type = "StaticTranslation";
 }
@@ -74,7 +75,11 @@ StaticTranslation::StaticTranslation(const ghoul::Dictionary& dictionary)
 }
 
 glm::dvec3 StaticTranslation::position(const UpdateData&) const {
-    return _position;
+    return _currentPosition;
+}
+
+bool StaticTranslation::isThreadSafe() const {
+    return true;
 }
 
 } // namespace openspace
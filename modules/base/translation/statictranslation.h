@@ -41,10 +41,14 @@ public:
     StaticTranslation(const ghoul::Dictionary& dictionary);
 
     glm::dvec3 position(const UpdateData& data) const override;
+    bool isThreadSafe() const override;
     static documentation::Documentation Documentation();
 
 private:
     properties::DVec3Property _position;
+    // Copy of _position that is read in position(), which is only changed after the
+    // observers have been notified
+    glm::dvec3 _currentPosition = glm::dvec3(0.0);
 };
 
 } // namespace openspace
@@ -0,0 +1,257 @@
+/*****************************************************************************************
+ *                                                                                       *
+ * OpenSpace                                                                             *
+ *                                                                                       *
+ * Copyright (c) 2014-2023                                                               *
+ *                                                                                       *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this  *
+ * software and associated documentation files (the "Software"), to deal in the Software *
+ * without restriction, including without limitation the rights to use, copy, modify,    *
+ * merge, publish, distribute, sublicense, and/or sell copies of the Software, and to    *
+ * permit persons to whom the Software is furnished to do so, subject to the following   *
+ * conditions:                                                                           *
+ *                                                                                       *
+ * The above copyright notice and this permission notice shall be included in all copies *
+ * or substantial portions of the Software.                                              *
+ *                                                                                       *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,   *
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A         *
+ * PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT    *
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF  *
+ * CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE  *
+ * OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                                         *
+ ****************************************************************************************/
+
+
+#include <modules/exoplanets/exoplanetsindex.h>
+
+#include <ghoul/fmt.h>
+#include <ghoul/misc/exception.h>
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+
+namespace {
+    constexpr int32_t CurrentIndexVersion = 1;
+
+    void sortRecords(std::vector<openspace::exoplanets::ExoplanetsIndex::Record>& rs) {
+        using Record = openspace::exoplanets::ExoplanetsIndex::Record;
+        std::sort(
+            rs.begin(),
+            rs.end(),
+            [](const Record& a, const Record& b) {
+                const std::string_view hostA = std::string_view(a.name).substr(
+                    0,
+                    a.hostLength
+                );
+                const std::string_view hostB = std::string_view(b.name).substr(
+                    0,
+                    b.hostLength
+                );
+                if (hostA != hostB) {
+                    return hostA < hostB;
+                }
+                return a.name < b.name;
+            }
+        );
+    }
+} // namespace
+
+namespace openspace::exoplanets {
+
+ExoplanetsIndex::ExoplanetsIndex(const std::filesystem::path& dataFile,
+                                 const std::filesystem::path& indexFile,
+                                 const std::filesystem::path& lookUpTable)
+    : _data(dataFile)
+{
+    if (std::filesystem::is_regular_file(indexFile)) {
+        readIndex(indexFile);
+    }
+    else {
+        readLookUpTable(lookUpTable);
+    }
+
+    for (const Entry& entry : _entries) {
+        if (entry.dataOffset + sizeof(ExoplanetDataEntry) > _data.size()) {
+            throw ghoul::RuntimeError(
+                fmt::format(
+                    "Entry for '{}' lies outside of data file {}", name(entry), dataFile
+                ),
+                "ExoplanetsIndex"
+            );
+        }
+    }
+}
+
+std::vector<ExoplanetsIndex::Planet> ExoplanetsIndex::system(
+                                                        std::string_view hostName) const
+{
+    auto it = std::lower_bound(
+        _entries.begin(),
+        _entries.end(),
+        hostName,
+        [this](const Entry& entry, std::string_view h) { return host(entry) < h; }
+    );
+
+    std::vector<Planet> result;
+    for (; it != _entries.end() && host(*it) == hostName; it++) {
+        result.push_back(planet(*it));
+    }
+    return result;
+}
+
+std::vector<ExoplanetsIndex::Planet> ExoplanetsIndex::planetsWithPrefix(
+                                                          std::string_view prefix) const
+{
+    auto it = std::lower_bound(
+        _entries.begin(),
+        _entries.end(),
+        prefix,
+        [this](const Entry& entry, std::string_view p) { return host(entry) < p; }
+    );
+
+    std::vector<Planet> result;
+    for (; it != _entries.end() && host(*it).starts_with(prefix); it++) {
+        result.push_back(planet(*it));
+    }
+    return result;
+}
+
+size_t ExoplanetsIndex::size() const {
+    return _entries.size();
+}
+
+void ExoplanetsIndex::writeIndex(const std::filesystem::path& file,
+                                 std::vector<Record> records)
+{
+    sortRecords(records);
+
+    std::ofstream stream(file, std::ofstream::binary);
+    if (!stream.good()) {
+        throw ghoul::RuntimeError(
+            fmt::format("Error when writing to {}", file),
+            "ExoplanetsIndex"
+        );
+    }
+
+    stream.write(reinterpret_cast<const char*>(&CurrentIndexVersion), sizeof(int32_t));
+    uint32_t nRecords = static_cast<uint32_t>(records.size());
+    stream.write(reinterpret_cast<const char*>(&nRecords), sizeof(uint32_t));
+
+    uint32_t nameOffset = 0;
+    for (const Record& r : records) {
+        uint32_t nameLength = static_cast<uint32_t>(r.name.size());
+        stream.write(reinterpret_cast<const char*>(&nameOffset), sizeof(uint32_t));
+        stream.write(reinterpret_cast<const char*>(&nameLength), sizeof(uint32_t));
+        stream.write(reinterpret_cast<const char*>(&r.hostLength), sizeof(uint32_t));
+        stream.write(reinterpret_cast<const char*>(&r.dataOffset), sizeof(uint64_t));
+        nameOffset += nameLength;
+    }
+
+    stream.write(reinterpret_cast<const char*>(&nameOffset), sizeof(uint32_t));
+    for (const Record& r : records) {
+        stream.write(r.name.data(), r.name.size());
+    }
+}
+
+std::string_view ExoplanetsIndex::host(const Entry& entry) const {
+    return std::string_view(_names).substr(entry.nameOffset, entry.hostLength);
+}
+
+std::string_view ExoplanetsIndex::name(const Entry& entry) const {
+    return std::string_view(_names).substr(entry.nameOffset, entry.nameLength);
+}
+
+ExoplanetsIndex::Planet ExoplanetsIndex::planet(const Entry& entry) const {
+    Planet p = { .host = host(entry), .name = name(entry) };
+    // The entries in the data file are not necessarily aligned
+    std::memcpy(&p.data, _data.data() + entry.dataOffset, sizeof(ExoplanetDataEntry));
+    return p;
+}
+
+void ExoplanetsIndex::readIndex(const std::filesystem::path& file) {
+    std::ifstream stream(file, std::ifstream::binary);
+
+    int32_t version = 0;
+    stream.read(reinterpret_cast<char*>(&version), sizeof(int32_t));
+    if (version != CurrentIndexVersion) {
+        throw ghoul::RuntimeError(
+            fmt::format("Unsupported version {} of exoplanets index {}", version, file),
+            "ExoplanetsIndex"
+        );
+    }
+
+    uint32_t nRecords = 0;
+    stream.read(reinterpret_cast<char*>(&nRecords), sizeof(uint32_t));
+    _entries.resize(nRecords);
+    for (Entry& e : _entries) {
+        stream.read(reinterpret_cast<char*>(&e.nameOffset), sizeof(uint32_t));
+        stream.read(reinterpret_cast<char*>(&e.nameLength), sizeof(uint32_t));
+        stream.read(reinterpret_cast<char*>(&e.hostLength), sizeof(uint32_t));
+        stream.read(reinterpret_cast<char*>(&e.dataOffset), sizeof(uint64_t));
+    }
+
+    uint32_t namesSize = 0;
+    stream.read(reinterpret_cast<char*>(&namesSize), sizeof(uint32_t));
+    _names.resize(namesSize);
+    stream.read(_names.data(), namesSize);
+
+    if (!stream.good()) {
+        throw ghoul::RuntimeError(
+            fmt::format("Exoplanets index {} is incomplete", file),
+            "ExoplanetsIndex"
+        );
+    }
+
+    for (const Entry& e : _entries) {
+        if (e.hostLength > e.nameLength ||
+            static_cast<size_t>(e.nameOffset) + e.nameLength > _names.size())
+        {
+            throw ghoul::RuntimeError(
+                fmt::format("Exoplanets index {} is corrupt", file),
+                "ExoplanetsIndex"
+            );
+        }
+    }
+}
+
+void ExoplanetsIndex::readLookUpTable(const std::filesystem::path& file) {
+    std::ifstream lut(file);
+    if (!lut.good()) {
+        throw ghoul::RuntimeError(
+            fmt::format("Failed to open exoplanets look-up table {}", file),
+            "ExoplanetsIndex"
+        );
+    }
+
+    std::vector<Record> records;
+    std::string line;
+    while (std::getline(lut, line)) {
+        const size_t comma = line.find(',');
+        if (comma == std::string::npos) {
+            continue;
+        }
+
+        Record r;
+        r.name = line.substr(0, comma);
+        // The last two characters of the name are the component of the planet
+        r.hostLength = static_cast<uint32_t>(r.name.size() > 2 ? r.name.size() - 2 : 0);
+        r.dataOffset = std::stoull(line.substr(comma + 1));
+        records.push_back(std::move(r));
+    }
+    sortRecords(records);
+
+    _entries.reserve(records.size());
+    for (const Record& r : records) {
+        Entry e = {
+            .nameOffset = static_cast<uint32_t>(_names.size()),
+            .nameLength = static_cast<uint32_t>(r.name.size()),
+            .hostLength = r.hostLength,
+            .dataOffset = r.dataOffset
+        };
+        _entries.push_back(e);
+        _names += r.name;
+    }
+}
+
+} // namespace openspace::exoplanets
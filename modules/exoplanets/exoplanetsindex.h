@@ -0,0 +1,124 @@
+/*****************************************************************************************
+ *                                                                                       *
+ * OpenSpace                                                                             *
+ *                                                                                       *
+ * Copyright (c) 2014-2023                                                               *
+ *                                                                                       *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this  *
+ * software and associated documentation files (the "Software"), to deal in the Software *
+ * without restriction, including without limitation the rights to use, copy, modify,    *
+ * merge, publish, distribute, sublicense, and/or sell copies of the Software, and to    *
+ * permit persons to whom the Software is furnished to do so, subject to the following   *
+ * conditions:                                                                           *
+ *                                                                                       *
+ * The above copyright notice and this permission notice shall be included in all copies *
+ * or substantial portions of the Software.                                              *
+ *                                                                                       *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,   *
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A         *
+ * PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT    *
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF  *
+ * CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE  *
+ * OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                                         *
+ ****************************************************************************************/
+
+
+#ifndef __OPENSPACE_MODULE_EXOPLANETS___EXOPLANETSINDEX___H__
+#define __OPENSPACE_MODULE_EXOPLANETS___EXOPLANETSINDEX___H__
+
+#include <modules/exoplanets/exoplanetshelper.h>
+#include <openspace/util/memorymappedfile.h>
+#include <filesystem>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace openspace::exoplanets {
+
+/**
+ * Provides access to the planets in the binary exoplanets data file through a table that
+ * is sorted by the name of the host star. The data file is memory-mapped once, so
+ * looking up a system or all systems whose host name starts with a specific prefix is a
+ * binary search in the table followed by reading the matching entries directly from the
+ * mapped file.
+ *
+ * The table is read from the binary index file that is written by the
+ * ExoplanetsDataPreparationTask. If that file does not exist, the table is created from
+ * the text look-up table instead.
+ */
+class ExoplanetsIndex {
+public:
+    /// A single row of the index as it is written by #writeIndex
+    struct Record {
+        /// The full name of the planet, consisting of the host name and the component
+        std::string name;
+        /// The number of characters at the beginning of #name that are the host name
+        uint32_t hostLength = 0;
+        /// The location of the planet's ExoplanetDataEntry in the data file
+        uint64_t dataOffset = 0;
+    };
+
+    struct Planet {
+        std::string_view host;
+        std::string_view name;
+        ExoplanetDataEntry data;
+    };
+
+    /**
+     * Maps the \p dataFile and reads the table from the \p indexFile or, if that file
+     * does not exist, from the text \p lookUpTable.
+     *
+     * \throw ghoul::RuntimeError If the data file could not be mapped, if neither of the
+     *        tables could be read, or if the table refers to entries outside of the data
+     *        file
+     */
+    ExoplanetsIndex(const std::filesystem::path& dataFile,
+        const std::filesystem::path& indexFile,
+        const std::filesystem::path& lookUpTable);
+
+    /**
+     * Returns all planets of the system with the host star \p hostName in the order of
+     * their names. The returned names stay valid as long as this object exists.
+     */
+    std::vector<Planet> system(std::string_view hostName) const;
+
+    /**
+     * Returns all planets whose host name starts with \p prefix, ordered by host and
+     * planet name. The returned names stay valid as long as this object exists.
+     */
+    std::vector<Planet> planetsWithPrefix(std::string_view prefix) const;
+
+    /// Returns the total number of planets
+    size_t size() const;
+
+    /**
+     * Sorts the \p records and writes them to the binary index \p file.
+     *
+     * \throw ghoul::RuntimeError If the file could not be written
+     */
+    static void writeIndex(const std::filesystem::path& file,
+        std::vector<Record> records);
+
+private:
+    struct Entry {
+        uint32_t nameOffset;
+        uint32_t nameLength;
+        uint32_t hostLength;
+        uint64_t dataOffset;
+    };
+
+    std::string_view host(const Entry& entry) const;
+    std::string_view name(const Entry& entry) const;
+    Planet planet(const Entry& entry) const;
+
+    void readIndex(const std::filesystem::path& file);
+    void readLookUpTable(const std::filesystem::path& file);
+
+    MemoryMappedFile _data;
+    std::vector<Entry> _entries;
+    std::string _names;
+};
+
+} // namespace openspace::exoplanets
+
+#endif // __OPENSPACE_MODULE_EXOPLANETS___EXOPLANETSINDEX___H__
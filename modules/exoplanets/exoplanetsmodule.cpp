@@ -25,6 +25,7 @@
 #include <modules/exoplanets/exoplanetsmodule.h>
 
 #include <modules/exoplanets/exoplanetshelper.h>
+#include <modules/exoplanets/exoplanetsindex.h>
 #include <modules/exoplanets/rendering/renderableorbitdisc.h>
 #include <modules/exoplanets/tasks/exoplanetsdatapreparationtask.h>
 #include <openspace/engine/globals.h>
@@ -43,6 +44,7 @@
 #include <ghoul/glm.h>
 #include <ghoul/logging/logmanager.h>
 #include <ghoul/misc/assert.h>
+#include <ghoul/misc/exception.h>
 #include <filesystem>
 #include <fstream>
 #include <sstream>
@@ -147,6 +149,7 @@ namespace {
 
     constexpr std::string_view ExoplanetsDataFileName = "exoplanets_data.bin";
     constexpr std::string_view LookupTableFileName = "lookup.txt";
+    constexpr std::string_view IndexFileName = "lookup.idx";
     constexpr std::string_view TeffToBvConversionFileName = "teff_bv.txt";
 
     struct [[codegen::Dictionary(ExoplanetsModule)]] Parameters {
@@ -227,6 +230,8 @@ ExoplanetsModule::ExoplanetsModule()
     addProperty(_habitableZoneOpacity);
 }
 
+ExoplanetsModule::~ExoplanetsModule() = default;
+
 bool ExoplanetsModule::hasDataFiles() const {
     return !_exoplanetsDataFolder.value().empty();
 }
@@ -247,6 +252,14 @@ std::string ExoplanetsModule::lookUpTablePath() const {
     ).string();
 }
 
+std::string ExoplanetsModule::indexPath() const {
+    ghoul_assert(hasDataFiles(), "Data files not loaded");
+
+    return absPath(
+        fmt::format("{}/{}", _exoplanetsDataFolder.value(), IndexFileName)
+    ).string();
+}
+
 std::string ExoplanetsModule::teffToBvConversionFilePath() const {
     ghoul_assert(hasDataFiles(), "Data files not loaded");
 
@@ -295,6 +308,25 @@ float ExoplanetsModule::habitableZoneOpacity() const {
     return _habitableZoneOpacity;
 }
 
+const ExoplanetsIndex* ExoplanetsModule::index() const {
+    // The data folder cannot change after the module has been initialized, so the index
+    // only has to be loaded once
+    if (!_hasTriedLoadingIndex && hasDataFiles()) {
+        _hasTriedLoadingIndex = true;
+        try {
+            _index = std::make_unique<ExoplanetsIndex>(
+                exoplanetsDataPath(),
+                indexPath(),
+                lookUpTablePath()
+            );
+        }
+        catch (const ghoul::RuntimeError& e) {
+            LERROR(e.message);
+        }
+    }
+    return _index.get();
+}
+
 void ExoplanetsModule::internalInitialize(const ghoul::Dictionary& dict) {
     const Parameters p = codegen::bake<Parameters>(dict);
 
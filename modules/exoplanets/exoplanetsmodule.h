@@ -31,19 +31,23 @@
 #include <openspace/properties/scalar/boolproperty.h>
 #include <openspace/properties/scalar/floatproperty.h>
 #include <openspace/properties/stringproperty.h>
+#include <memory>
 
 namespace openspace {
 
+namespace exoplanets { class ExoplanetsIndex; }
+
 class ExoplanetsModule : public OpenSpaceModule {
 public:
     constexpr static const char* Name = "Exoplanets";
 
     ExoplanetsModule();
-    ~ExoplanetsModule() override = default;
+    ~ExoplanetsModule() override;
 
     bool hasDataFiles() const;
     std::string exoplanetsDataPath() const;
     std::string lookUpTablePath() const;
+    std::string indexPath() const;
     std::string teffToBvConversionFilePath() const;
     std::string bvColormapPath() const;
     std::string starTexturePath() const;
@@ -56,6 +60,13 @@ public:
     bool useOptimisticZone() const;
     float habitableZoneOpacity() const;
 
+    /**
+     * Returns the index of the exoplanets data files. The data files are opened the
+     * first time this function is called and stay open for the lifetime of the module.
+     * Returns `nullptr` if no data files are configured or if they could not be opened.
+     */
+    const exoplanets::ExoplanetsIndex* index() const;
+
     scripting::LuaLibrary luaLibrary() const override;
     std::vector<documentation::Documentation> documentations() const override;
 
@@ -76,6 +87,9 @@ protected:
     properties::BoolProperty _useOptimisticZone;
 
     properties::FloatProperty _habitableZoneOpacity;
+
+    mutable std::unique_ptr<exoplanets::ExoplanetsIndex> _index;
+    mutable bool _hasTriedLoadingIndex = false;
 };
 
 } // namespace openspace
@@ -22,6 +22,7 @@
  * OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                                         *
  ****************************************************************************************/
 
+#include <modules/exoplanets/exoplanetsindex.h>
 #include <openspace/scene/scene.h>
 #include <ghoul/misc/csvreader.h>
 #include <algorithm>
@@ -49,55 +50,26 @@ openspace::exoplanets::ExoplanetSystem findExoplanetSystemInData(
     using namespace exoplanets;
 
     const ExoplanetsModule* module = global::moduleEngine->module<ExoplanetsModule>();
-
-    const std::string binPath = module->exoplanetsDataPath();
-    std::ifstream data(absPath(binPath), std::ios::in | std::ios::binary);
-    if (!data.good()) {
-        LERROR(fmt::format("Failed to open exoplanets data file: '{}'", binPath));
-        return ExoplanetSystem();
-    }
-
-    const std::string lutPath = module->lookUpTablePath();
-    std::ifstream lut(absPath(lutPath));
-    if (!lut.good()) {
-        LERROR(fmt::format("Failed to open exoplanets look-up table: '{}'", lutPath));
+    const ExoplanetsIndex* index = module->index();
+    if (!index) {
+        LERROR("Failed to open exoplanets data files");
         return ExoplanetSystem();
     }
 
     ExoplanetSystem system;
-
-    // 1. search lut for the starname and return the corresponding location
-    // 2. go to that location in the data file
-    // 3. read sizeof(exoplanet) bytes into an exoplanet object.
-    ExoplanetDataEntry p;
-    std::string line;
-    while (std::getline(lut, line)) {
-        std::istringstream ss(line);
-        std::string name;
-        std::getline(ss, name, ',');
-
-        if (name.substr(0, name.length() - 2) != starName) {
-            continue;
-        }
-
-        std::string location_s;
-        std::getline(ss, location_s);
-        long location = std::stol(location_s.c_str());
-
-        data.seekg(location);
-        data.read(reinterpret_cast<char*>(&p), sizeof(ExoplanetDataEntry));
-
+    for (ExoplanetsIndex::Planet& planet : index->system(starName)) {
+        std::string name = std::string(planet.name);
         sanitizeNameString(name);
 
-        if (!hasSufficientData(p)) {
+        if (!hasSufficientData(planet.data)) {
             LWARNING(fmt::format("Insufficient data for exoplanet: '{}'", name));
             continue;
         }
 
         system.planetNames.push_back(name);
-        system.planetsData.push_back(p);
+        system.planetsData.push_back(planet.data);
 
-        updateStarDataFromNewPlanet(system.starData, p);
+        updateStarDataFromNewPlanet(system.starData, planet.data);
     }
 
     system.starName = starName;
@@ -544,7 +516,7 @@ void createExoplanetSystem(const std::string& starName,
     }
 }
 
-std::vector<std::string> hostStarsWithSufficientData() {
+std::vector<std::string> hostStarsWithSufficientData(std::string_view prefix = "") {
     using namespace openspace;
     using namespace exoplanets;
     const ExoplanetsModule* module = global::moduleEngine->module<ExoplanetsModule>();
@@ -555,57 +527,24 @@ std::vector<std::string> hostStarsWithSufficientData() {
         return {};
     }
 
-    const std::string lutPath = module->lookUpTablePath();
-    std::ifstream lookupTableFile(absPath(lutPath));
-    if (!lookupTableFile.good()) {
-        LERROR(fmt::format("Failed to open lookup table file '{}'", lutPath));
-        return {};
-    }
-
-    const std::string binPath = module->exoplanetsDataPath();
-    std::ifstream data(absPath(binPath), std::ios::in | std::ios::binary);
-    if (!data.good()) {
-        LERROR(fmt::format("Failed to open data file '{}'", binPath));
+    const ExoplanetsIndex* index = module->index();
+    if (!index) {
+        LERROR("Failed to open exoplanets data files");
         return {};
     }
 
+    // The planets are sorted by their host names, so the names are already sorted and
+    // duplicates are next to each other
     std::vector<std::string> names;
-    std::string line;
-
-    // Read number of lines
-    int nExoplanets = 0;
-    while (std::getline(lookupTableFile, line)) {
-        ++nExoplanets;
-    }
-    lookupTableFile.clear();
-    lookupTableFile.seekg(0);
-    names.reserve(nExoplanets);
-
-    ExoplanetDataEntry p;
-    while (std::getline(lookupTableFile, line)) {
-        std::stringstream ss(line);
-        std::string name;
-        std::getline(ss, name, ',');
-        // Remove the last two characters, that specify the planet
-        name = name.substr(0, name.size() - 2);
-
-        // Don't want to list systems where there is not enough data to visualize.
-        // So, test if there is before adding the name to the list.
-        std::string location_s;
-        std::getline(ss, location_s);
-        long location = std::stol(location_s.c_str());
-
-        data.seekg(location);
-        data.read(reinterpret_cast<char*>(&p), sizeof(ExoplanetDataEntry));
-
-        if (hasSufficientData(p)) {
-            names.push_back(name);
+    for (const ExoplanetsIndex::Planet& planet : index->planetsWithPrefix(prefix)) {
+        // Don't want to list systems where there is not enough data to visualize
+        if (!hasSufficientData(planet.data)) {
+            continue;
+        }
+        if (names.empty() || names.back() != planet.host) {
+            names.emplace_back(planet.host);
         }
     }
-
-    // For easier read, sort by names and remove duplicates
-    std::sort(names.begin(), names.end());
-    names.erase(std::unique(names.begin(), names.end()), names.end());
     return names;
 }
 
@@ -658,10 +597,13 @@ std::vector<std::string> hostStarsWithSufficientData() {
 /**
  * Returns a list with names of the host star of all the exoplanet systems
  * that have sufficient data for generating a visualization, based on the
- * module's loaded data file.
+ * module's loaded data file. If a prefix is provided, only the names of the host stars
+ * that start with the prefix are returned.
  */
-[[codegen::luawrap]] std::vector<std::string> listOfExoplanets() {
-    std::vector<std::string> names = hostStarsWithSufficientData();
+[[codegen::luawrap]] std::vector<std::string> listOfExoplanets(
+                                                        std::optional<std::string> prefix)
+{
+    std::vector<std::string> names = hostStarsWithSufficientData(prefix.value_or(""));
     return names;
 }
 
@@ -676,7 +618,7 @@ listOfExoplanetsDeprecated()
         "'getListOfExoplanets' function is deprecated and should be replaced with "
         "'listOfExoplanets'"
     );
-    return listOfExoplanets();
+    return listOfExoplanets(std::nullopt);
 }
 
 [[codegen::luawrap]] void listAvailableExoplanetSystems() {
@@ -729,18 +671,22 @@ listOfExoplanetsDeprecated()
         ExoplanetsDataPreparationTask::readFirstDataRow(inputDataFile);
 
     const ExoplanetsModule* module = global::moduleEngine->module<ExoplanetsModule>();
-    const std::string teffBvConversionPath = module->teffToBvConversionFilePath();
+    const ExoplanetsDataPreparationTask::TeffToBvTable teffToBv =
+        ExoplanetsDataPreparationTask::readTeffToBvTable(
+            module->teffToBvConversionFilePath()
+        );
 
     std::map<std::string, ExoplanetSystem> hostNameToSystemDataMap;
 
-    // Parse the file line by line to compose system information
+    // Parse the file line by line to compose system information. No star positions are
+    // provided, so the positions from the CSV file are used
     std::string row;
     while (std::getline(inputDataFile, row)) {
         PlanetData planetData = ExoplanetsDataPreparationTask::parseDataRow(
             row,
             columnNames,
-            "",
-            module->teffToBvConversionFilePath()
+            ExoplanetsDataPreparationTask::StarPositions(),
+            teffToBv
         );
 
         LINFO(fmt::format("Reading data for planet: '{}' ", planetData.name));
@@ -25,6 +25,7 @@
 #include <modules/exoplanets/tasks/exoplanetsdatapreparationtask.h>
 
 #include <modules/exoplanets/exoplanetshelper.h>
+#include <modules/exoplanets/exoplanetsindex.h>
 #include <openspace/documentation/documentation.h>
 #include <openspace/documentation/verifier.h>
 #include <openspace/util/coordinateconversion.h>
@@ -33,9 +34,19 @@
 #include <ghoul/glm.h>
 #include <ghoul/logging/logmanager.h>
 #include <ghoul/misc/dictionary.h>
+#include <ghoul/misc/exception.h>
+#include <algorithm>
+#include <atomic>
 #include <charconv>
+#include <cstring>
+#include <exception>
 #include <filesystem>
 #include <fstream>
+#include <iterator>
+#include <mutex>
+#include <new>
+#include <sstream>
+#include <thread>
 
 namespace {
     constexpr std::string_view _loggerCat = "ExoplanetsDataPreparationTask";
@@ -53,11 +64,33 @@ namespace {
         // The txt file to write look-up table into
         std::string outputLUT [[codegen::annotation("A valid filepath")]];
 
+        // The binary file to write the sorted index of the planets into. If this value
+        // is not specified, the path of the look-up table with the extension '.idx' is
+        // used
+        std::optional<std::string> outputIndex
+            [[codegen::annotation("A valid filepath")]];
+
         // The path to a teff to bv conversion file. Should be a txt file where each line
         // has the format 'teff,bv'
         std::string teffToBvFile;
+
+        // The number of threads that are used to parse the input data file. If this
+        // value is not specified, one thread per core is used
+        std::optional<int> threads [[codegen::greater(0)]];
     };
 #include "exoplanetsdatapreparationtask_codegen.cpp"
+
+    // Splits the content into the same rows that std::getline would return
+    std::vector<std::string_view> splitRows(std::string_view content) {
+        std::vector<std::string_view> rows;
+        size_t position = 0;
+        while (position < content.size()) {
+            const size_t end = std::min(content.find('\n', position), content.size());
+            rows.push_back(content.substr(position, end - position));
+            position = end + 1;
+        }
+        return rows;
+    }
 } // namespace
 
 namespace openspace::exoplanets {
@@ -75,7 +108,17 @@ ExoplanetsDataPreparationTask::ExoplanetsDataPreparationTask(
     _inputSpeckPath = absPath(p.inputSPECK);
     _outputBinPath = absPath(p.outputBIN);
     _outputLutPath = absPath(p.outputLUT);
+    if (p.outputIndex.has_value()) {
+        _outputIndexPath = absPath(*p.outputIndex);
+    }
+    else {
+        _outputIndexPath = _outputLutPath;
+        _outputIndexPath.replace_extension(".idx");
+    }
     _teffToBvFilePath = absPath(p.teffToBvFile);
+    _nThreads = static_cast<unsigned int>(
+        p.threads.value_or(std::max(std::thread::hardware_concurrency(), 1u))
+    );
 }
 
 std::string ExoplanetsDataPreparationTask::description() {
@@ -87,6 +130,11 @@ std::string ExoplanetsDataPreparationTask::description() {
     );
 }
 
+bool ExoplanetsDataPreparationTask::isThreadSafe() const {
+    // Only reads and writes the files that are specified in the task
+    return true;
+}
+
 void ExoplanetsDataPreparationTask::perform(
                                            const Task::ProgressCallback& progressCallback)
 {
@@ -122,37 +170,95 @@ void ExoplanetsDataPreparationTask::perform(
     // later access
     std::vector<std::string> columnNames = readFirstDataRow(inputDataFile);
 
-    // Read total number of items
-    int total = 0;
-    std::string row;
-    while (std::getline(inputDataFile, row)) {
-        ++total;
-    }
-    inputDataFile.clear();
-    inputDataFile.seekg(0);
-
-    // The reading is restarted, so we need to read past the first line,
-    // containing the data names, again
-    readFirstDataRow(inputDataFile);
+    // The remaining rows are read at once so that they can be parsed concurrently
+    const std::string content = std::string(
+        std::istreambuf_iterator<char>(inputDataFile),
+        std::istreambuf_iterator<char>()
+    );
+    const std::vector<std::string_view> rows = splitRows(content);
+    const size_t total = rows.size();
 
     LINFO(fmt::format("Loading {} exoplanets", total));
 
-    int exoplanetCount = 0;
-    while (std::getline(inputDataFile, row)) {
-        ++exoplanetCount;
-        progressCallback(static_cast<float>(exoplanetCount) / static_cast<float>(total));
+    // The lookup tables are the same for all rows, so they are only read once
+    const StarPositions starPositions = readStarPositions(_inputSpeckPath);
+    const TeffToBvTable teffToBv = readTeffToBvTable(_teffToBvFilePath);
+
+    // The rows are handed out in chunks to reduce the contention on the counter. Each
+    // row is parsed into its own slot, so the output is written in the original order
+    constexpr size_t ChunkSize = 64;
+    std::vector<PlanetData> planets(total);
+    std::atomic<size_t> nextRow = 0;
+    std::atomic<size_t> nParsedRows = 0;
+    std::mutex exceptionMutex;
+    std::exception_ptr exception;
+
+    auto parseRows = [&](bool reportProgress) {
+        while (true) {
+            const size_t begin = nextRow.fetch_add(ChunkSize);
+            if (begin >= total) {
+                return;
+            }
+            const size_t end = std::min(begin + ChunkSize, total);
+
+            try {
+                for (size_t i = begin; i < end; i++) {
+                    planets[i] = parseDataRow(
+                        rows[i],
+                        columnNames,
+                        starPositions,
+                        teffToBv
+                    );
+                }
+            }
+            catch (...) {
+                std::lock_guard lock(exceptionMutex);
+                if (!exception) {
+                    exception = std::current_exception();
+                }
+                // Skip all remaining rows as the task fails anyway
+                nextRow = total;
+                return;
+            }
 
-        PlanetData planetData = parseDataRow(
-            row,
-            columnNames,
-            _inputSpeckPath,
-            _teffToBvFilePath
-        );
+            const size_t nParsed = nParsedRows += end - begin;
+            if (reportProgress) {
+                progressCallback(
+                    static_cast<float>(nParsed) / static_cast<float>(total + 1)
+                );
+            }
+        }
+    };
 
+    // The calling thread is also parsing rows and is the only one reporting progress
+    const size_t nChunks = (total + ChunkSize - 1) / ChunkSize;
+    const unsigned int nThreads = static_cast<unsigned int>(
+        std::clamp<size_t>(nChunks, 1, _nThreads)
+    );
+    std::vector<std::thread> threads;
+    for (unsigned int i = 1; i < nThreads; i++) {
+        threads.emplace_back(parseRows, false);
+    }
+    parseRows(true);
+    for (std::thread& t : threads) {
+        t.join();
+    }
+    if (exception) {
+        std::rethrow_exception(exception);
+    }
+
+    std::vector<ExoplanetsIndex::Record> records;
+    records.reserve(total);
+    for (PlanetData& planetData : planets) {
         // Create look-up table
         long pos = static_cast<long>(binFile.tellp());
         std::string planetName = planetData.host + " " + planetData.component;
-        lutFile << planetName << "," << pos << std::endl;
+        lutFile << planetName << "," << pos << '\n';
+        records.push_back({
+            .name = std::move(planetName),
+            .hostLength = static_cast<uint32_t>(planetData.host.size()),
+            .dataOffset = static_cast<uint64_t>(pos)
+        });
 
         binFile.write(
             reinterpret_cast<char*>(&planetData.dataEntry),
@@ -160,6 +266,13 @@ void ExoplanetsDataPreparationTask::perform(
         );
     }
 
+    try {
+        ExoplanetsIndex::writeIndex(_outputIndexPath, std::move(records));
+    }
+    catch (const ghoul::RuntimeError& e) {
+        LERROR(e.message);
+    }
+
     progressCallback(1.f);
 }
 
@@ -188,12 +301,12 @@ ExoplanetsDataPreparationTask::readFirstDataRow(std::ifstream& file)
 };
 
 ExoplanetsDataPreparationTask::PlanetData
-ExoplanetsDataPreparationTask::parseDataRow(std::string row,
+ExoplanetsDataPreparationTask::parseDataRow(std::string_view row,
                                             const std::vector<std::string>& columnNames,
-                                            std::filesystem::path positionSourceFile,
-                                          std::filesystem::path bvFromTeffConversionFile)
+                                            const StarPositions& starPositions,
+                                            const TeffToBvTable& teffToBv)
 {
-    auto readFloatData = [](const std::string& str) -> float {
+    auto readFloatData = [](std::string_view str) -> float {
 #ifdef WIN32
         float result;
         auto [p, ec] = std::from_chars(str.data(), str.data() + str.size(), result);
@@ -203,11 +316,11 @@ ExoplanetsDataPreparationTask::parseDataRow(std::string row,
         return std::numeric_limits<float>::quiet_NaN();
 #else
         // clang is missing float support for std::from_chars
-        return !str.empty() ? std::stof(str.c_str(), nullptr) : NAN;
+        return !str.empty() ? std::stof(std::string(str), nullptr) : NAN;
 #endif
 };
 
-    auto readDoubleData = [](const std::string& str) -> double {
+    auto readDoubleData = [](std::string_view str) -> double {
 #ifdef WIN32
         double result;
         auto [p, ec] = std::from_chars(str.data(), str.data() + str.size(), result);
@@ -217,11 +330,11 @@ ExoplanetsDataPreparationTask::parseDataRow(std::string row,
         return std::numeric_limits<double>::quiet_NaN();
 #else
         // clang is missing double support for std::from_chars
-        return !str.empty() ? std::stod(str.c_str(), nullptr) : NAN;
+        return !str.empty() ? std::stod(std::string(str), nullptr) : NAN;
 #endif
     };
 
-    auto readIntegerData = [](const std::string& str) -> int {
+    auto readIntegerData = [](std::string_view str) -> int {
         int result;
         auto [p, ec] = std::from_chars(str.data(), str.data() + str.size(), result);
         if (ec == std::errc()) {
@@ -230,8 +343,8 @@ ExoplanetsDataPreparationTask::parseDataRow(std::string row,
         return -1;
     };
 
-    auto readStringData = [](const std::string& str) -> std::string {
-        std::string result = str;
+    auto readStringData = [](std::string_view str) -> std::string {
+        std::string result = std::string(str);
         result.erase(std::remove(result.begin(), result.end(), '\"'), result.end());
         return result;
     };
@@ -240,16 +353,24 @@ ExoplanetsDataPreparationTask::parseDataRow(std::string row,
     float dec = std::numeric_limits<float>::quiet_NaN(); // decimal degrees
     float distanceInParsec = std::numeric_limits<float>::quiet_NaN();
 
-    std::istringstream lineStream(row);
-    int columnIndex = 0;
-
+    // The entry is written to the binary file as-is, so its padding bytes are zeroed to
+    // make the output independent of the previous content of the memory
     ExoplanetDataEntry p;
+    std::memset(&p, 0, sizeof(ExoplanetDataEntry));
+    new (&p) ExoplanetDataEntry;
     std::string component;
     std::string starName;
     std::string name;
 
-    std::string data;
-    while (std::getline(lineStream, data, ',')) {
+    // Splitting the row at the commas results in the same columns as reading it with
+    // std::getline, which does not return an empty value after a trailing comma
+    size_t columnIndex = 0;
+    size_t position = 0;
+    while (position < row.size() && columnIndex < columnNames.size()) {
+        const size_t comma = std::min(row.find(',', position), row.size());
+        const std::string_view data = row.substr(position, comma - position);
+        position = comma + 1;
+
         const std::string& column = columnNames[columnIndex];
         columnIndex++;
 
@@ -332,10 +453,12 @@ ExoplanetsDataPreparationTask::parseDataRow(std::string row,
         // Star - name and position
         else if (column == "hostname") {
             starName = readStringData(data);
-            glm::vec3 position = starPosition(starName, positionSourceFile);
-            p.positionX = position[0];
-            p.positionY = position[1];
-            p.positionZ = position[2];
+            auto it = starPositions.find(starName);
+            if (it != starPositions.end()) {
+                p.positionX = it->second[0];
+                p.positionY = it->second[1];
+                p.positionZ = it->second[2];
+            }
         }
         else if (column == "ra") {
             ra = readFloatData(data);
@@ -360,7 +483,7 @@ ExoplanetsDataPreparationTask::parseDataRow(std::string row,
         // (B-V color index computed from star's effective temperature)
         else if (column == "st_teff") {
             p.teff = readFloatData(data);
-            p.bmv = bvFromTeff(p.teff, bvFromTeffConversionFile);
+            p.bmv = bvFromTeff(p.teff, teffToBv);
         }
         else if (column == "st_tefferr1") {
             p.teffUpper = readFloatData(data);
@@ -420,19 +543,20 @@ ExoplanetsDataPreparationTask::parseDataRow(std::string row,
     };
 }
 
-glm::vec3 ExoplanetsDataPreparationTask::starPosition(const std::string& starName,
-                                                      const std::filesystem::path& sourceFile)
+ExoplanetsDataPreparationTask::StarPositions
+ExoplanetsDataPreparationTask::readStarPositions(const std::filesystem::path& sourceFile)
 {
-    glm::vec3 position = glm::vec3(std::numeric_limits<float>::quiet_NaN());
+    StarPositions positions;
 
     if (sourceFile.empty()) {
-        // No file specified => return NaN position
-        return position;
+        // No file specified => no star has a position
+        return positions;
     }
 
     std::ifstream exoplanetsFile(sourceFile);
     if (!exoplanetsFile) {
         LERROR(fmt::format("Error opening file {}", sourceFile));
+        return positions;
     }
 
     std::string line;
@@ -453,8 +577,14 @@ glm::vec3 ExoplanetsDataPreparationTask::starPosition(const std::string& starNam
         std::getline(linestream, name);
         name.erase(0, 1);
 
-        std::string coord;
-        if (name == starName) {
+        if (positions.find(name) != positions.end()) {
+            // Only the first position of each star is used
+            continue;
+        }
+
+        try {
+            glm::vec3 position;
+            std::string coord;
             std::stringstream dataStream(data);
             std::getline(dataStream, coord, ' ');
             position[0] = std::stof(coord.c_str(), nullptr);
@@ -462,33 +592,27 @@ glm::vec3 ExoplanetsDataPreparationTask::starPosition(const std::string& starNam
             position[1] = std::stof(coord.c_str(), nullptr);
             std::getline(dataStream, coord, ' ');
             position[2] = std::stof(coord.c_str(), nullptr);
-            break;
+            positions[std::move(name)] = position;
+        }
+        catch (const std::logic_error&) {
+            LWARNING(fmt::format("Could not read position of star '{}'", name));
         }
     }
 
-    return position;
+    return positions;
 }
 
-float ExoplanetsDataPreparationTask::bvFromTeff(float teff,
+ExoplanetsDataPreparationTask::TeffToBvTable
+ExoplanetsDataPreparationTask::readTeffToBvTable(
                                               const std::filesystem::path& conversionFile)
 {
-    if (std::isnan(teff)) {
-        return std::numeric_limits<float>::quiet_NaN();
-    }
-
     std::ifstream teffToBvFile(conversionFile);
     if (!teffToBvFile.good()) {
         LERROR(fmt::format("Failed to open file {}", conversionFile));
-        return std::numeric_limits<float>::quiet_NaN();
+        return TeffToBvTable();
     }
 
-    // Find the line in the file that most closely corresponds to the specified teff,
-    // and finally interpolate the value
-    float bv = 0.f;
-    float bvUpper = 0.f;
-    float bvLower = 0.f;
-    float teffLower = 0.f;
-    float teffUpper;
+    TeffToBvTable table;
     std::string row;
     while (std::getline(teffToBvFile, row)) {
         std::istringstream lineStream(row);
@@ -497,8 +621,34 @@ float ExoplanetsDataPreparationTask::bvFromTeff(float teff,
         std::string bvString;
         std::getline(lineStream, bvString);
 
-        float teffCurrent = std::stof(teffString.c_str(), nullptr);
-        float bvCurrent = std::stof(bvString.c_str(), nullptr);
+        try {
+            float teff = std::stof(teffString.c_str(), nullptr);
+            float bv = std::stof(bvString.c_str(), nullptr);
+            table.emplace_back(teff, bv);
+        }
+        catch (const std::logic_error&) {
+            LWARNING(fmt::format("Could not read line '{}' in {}", row, conversionFile));
+        }
+    }
+    return table;
+}
+
+float ExoplanetsDataPreparationTask::bvFromTeff(float teff, const TeffToBvTable& teffToBv)
+{
+    if (std::isnan(teff) || teffToBv.empty()) {
+        return std::numeric_limits<float>::quiet_NaN();
+    }
+
+    // Find the line in the file that most closely corresponds to the specified teff,
+    // and finally interpolate the value
+    float bv = 0.f;
+    float bvUpper = 0.f;
+    float bvLower = 0.f;
+    float teffLower = 0.f;
+    float teffUpper = 0.f;
+    for (const std::pair<float, float>& entry : teffToBv) {
+        const float teffCurrent = entry.first;
+        const float bvCurrent = entry.second;
 
         if (teff > teffCurrent) {
             teffLower = teffCurrent;
@@ -32,6 +32,10 @@
 #include <openspace/properties/vector/vec3property.h>
 #include <filesystem>
 #include <string>
+#include <string_view>
+#include <unordered_map>
+#include <utility>
+#include <vector>
 
 namespace openspace::exoplanets {
 
@@ -44,9 +48,16 @@ public:
         ExoplanetDataEntry dataEntry;
     };
 
+    /// Maps the names of stars to their position in galactic XYZ coordinates
+    using StarPositions = std::unordered_map<std::string, glm::vec3>;
+
+    /// Pairs of effective temperature (teff) and B-V color index, in file order
+    using TeffToBvTable = std::vector<std::pair<float, float>>;
+
     ExoplanetsDataPreparationTask(const ghoul::Dictionary& dictionary);
     std::string description() override;
     void perform(const Task::ProgressCallback& progressCallback) override;
+    bool isThreadSafe() const override;
     static documentation::Documentation documentation();
 
     /**
@@ -66,40 +77,50 @@ public:
      *
      * \param row The row to parse, given as a string
      * \param columnNames The list of column names in the file, from the CSV header
-     * \param positionSourceFile A SPECK file to use for getting the position of the star.
-     *        This is used to make sure the position of the star matches those of other star
-     *        datasets. If no file is provided, the position from the CSV data file is read
-     *        and used instead
-     * \param bvFromTeffConversionFile A text file containing a mapping between effective
-     *        temperature (teff) values and B-V color index values. Each line should include
-     *        two values separated by a comma: first the teff value and hten the B-V value
+     * \param starPositions The star positions from a SPECK file (see
+     *        #readStarPositions). This is used to make sure the position of the star
+     *        matches those of other star datasets. If the star is not part of the map,
+     *        the position from the CSV data file is read and used instead
+     * \param teffToBv The mapping between effective temperature (teff) values and B-V
+     *        color index values (see #readTeffToBvTable)
      * \return An object containing the parsed information.
      */
-    static PlanetData parseDataRow(std::string row,
-        const std::vector<std::string>& columnNames,
-        std::filesystem::path positionSourceFile,
-        std::filesystem::path bvFromTeffConversionFile);
+    static PlanetData parseDataRow(std::string_view row,
+        const std::vector<std::string>& columnNames, const StarPositions& starPositions,
+        const TeffToBvTable& teffToBv);
+
+    /**
+     * Reads the positions of all stars in the provided SPECK file. If the same star
+     * occurs multiple times, the first position is used.
+     *
+     * \param sourceFile The SPECK file to read. If the path is empty, an empty map is
+     *        returned
+     * \return The star positions, given in galactic XYZ
+     */
+    static StarPositions readStarPositions(const std::filesystem::path& sourceFile);
+
+    /**
+     * Reads a text file containing a mapping between effective temperature (teff) values
+     * and B-V color index values. Each line should include two values separated by a
+     * comma: first the teff value and then the B-V value.
+     *
+     * \param conversionFile The file to read
+     * \return The mapping in the order of the file, or an empty table if the file could
+     *         not be read
+     */
+    static TeffToBvTable readTeffToBvTable(const std::filesystem::path& conversionFile);
 
 private:
     std::filesystem::path _inputDataPath;
     std::filesystem::path _inputSpeckPath;
     std::filesystem::path _outputBinPath;
     std::filesystem::path _outputLutPath;
+    std::filesystem::path _outputIndexPath;
     std::filesystem::path _teffToBvFilePath;
+    unsigned int _nThreads = 1;
 
-    /**
-     * Try to find the star position from an input speck file. If not found, the
-     * returned position will contain NaN values.
-     *
-     * \param starName The name of the star to look for in the file
-     * \param sourceFile The name of the file in which to look
-     * \return The resulting star position, given in galactix XYZ
-     */
-    static glm::vec3 starPosition(const std::string& starName,
-        const std::filesystem::path& sourceFile);
-
-    // Compute b-v color from teff value using a conversion file
-    static float bvFromTeff(float teff, const std::filesystem::path& conversionFile);
+    // Compute b-v color from teff value using a conversion table
+    static float bvFromTeff(float teff, const TeffToBvTable& teffToBv);
 };
 
 } // namespace openspace::exoplanets
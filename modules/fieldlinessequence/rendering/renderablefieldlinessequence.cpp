@@ -25,6 +25,7 @@
 #include <modules/fieldlinessequence/rendering/renderablefieldlinessequence.h>
 
 #include <modules/fieldlinessequence/fieldlinessequencemodule.h>
+#include <modules/fieldlinessequence/util/fieldlinesstateloader.h>
 #include <modules/fieldlinessequence/util/kameleonfieldlinehelper.h>
 #include <openspace/engine/globals.h>
 #include <openspace/engine/windowdelegate.h>
@@ -39,8 +40,11 @@
 #include <ghoul/opengl/openglstatecache.h>
 #include <ghoul/opengl/programobject.h>
 #include <ghoul/opengl/textureunit.h>
+#include <algorithm>
+#include <chrono>
 #include <filesystem>
 #include <fstream>
+#include <limits>
 #include <map>
 #include <optional>
 #include <thread>
@@ -192,6 +196,40 @@ namespace {
         "Performs a time jump to the start of the sequence",
         openspace::properties::Property::Visibility::NoviceUser
     };
+    constexpr openspace::properties::Property::PropertyInfo PreloadedStatesInfo = {
+        "PreloadedStates",
+        "Preloaded States",
+        "When loading states at runtime, this is the number of states around the current "
+        "one that are loaded in the background. Most of them are loaded in the "
+        "direction in which the time is moving",
+        openspace::properties::Property::Visibility::AdvancedUser
+    };
+    constexpr openspace::properties::Property::PropertyInfo AverageLoadTimeInfo = {
+        "AverageLoadTime",
+        "Average Load Time (ms)",
+        "The average time between requesting a state and it being loaded from disk",
+        openspace::properties::Property::Visibility::Developer
+    };
+    constexpr openspace::properties::Property::PropertyInfo MaxLoadTimeInfo = {
+        "MaxLoadTime",
+        "Maximum Load Time (ms)",
+        "The longest time between requesting a state and it being loaded from disk",
+        openspace::properties::Property::Visibility::Developer
+    };
+    constexpr openspace::properties::Property::PropertyInfo DisplayLatencyInfo = {
+        "DisplayLatency",
+        "Display Latency (ms)",
+        "The time between the most recent change of the current state and that state "
+        "being shown. This is close to 0 if the state had already been loaded in the "
+        "background",
+        openspace::properties::Property::Visibility::Developer
+    };
+    constexpr openspace::properties::Property::PropertyInfo CancelledLoadsInfo = {
+        "CancelledLoads",
+        "Cancelled Loads",
+        "The number of states that were no longer needed before they had been loaded",
+        openspace::properties::Property::Visibility::Developer
+    };
 
     struct [[codegen::Dictionary(RenderableFieldlinesSequence)]] Parameters {
         enum class SourceFileType {
@@ -226,6 +264,9 @@ namespace {
         // Set to true if you are streaming data during runtime
         std::optional<bool> loadAtRuntime;
 
+        // [[codegen::verbatim(PreloadedStatesInfo.description)]]
+        std::optional<int> preloadedStates [[codegen::greaterequal(0)]];
+
         // [[codegen::verbatim(ColorUniformInfo.description)]]
         std::optional<glm::vec4> color [[codegen::color()]];
 
@@ -351,6 +392,12 @@ RenderableFieldlinesSequence::RenderableFieldlinesSequence(
     )
     , _lineWidth(LineWidthInfo, 1.f, 1.f, 20.f)
     , _jumpToStartBtn(TimeJumpButtonInfo)
+    , _streamingGroup({ "Streaming" })
+    , _preloadedStates(PreloadedStatesInfo, 8, 0, 64)
+    , _averageLoadTime(AverageLoadTimeInfo, 0.f, 0.f, std::numeric_limits<float>::max())
+    , _maxLoadTime(MaxLoadTimeInfo, 0.f, 0.f, std::numeric_limits<float>::max())
+    , _displayLatency(DisplayLatencyInfo, 0.f, 0.f, std::numeric_limits<float>::max())
+    , _cancelledLoads(CancelledLoadsInfo, 0, 0, std::numeric_limits<int>::max())
 {
     const Parameters p = codegen::bake<Parameters>(dictionary);
 
@@ -484,6 +531,7 @@ RenderableFieldlinesSequence::RenderableFieldlinesSequence(
         LWARNING("Load at run time is only supported for osfls file type");
         _loadingStatesDynamically = false;
     }
+    _preloadedStates = p.preloadedStates.value_or(_preloadedStates);
 
     if (p.maskingRanges.has_value()) {
         _maskingRanges = *p.maskingRanges;
@@ -503,6 +551,8 @@ RenderableFieldlinesSequence::RenderableFieldlinesSequence(
     _scalingFactor = p.scaleToMeters.value_or(_scalingFactor);
 }
 
+RenderableFieldlinesSequence::~RenderableFieldlinesSequence() {}
+
 void RenderableFieldlinesSequence::initialize() {
     _transferFunction = std::make_unique<TransferFunction>(
         absPath(_colorTablePaths[0]).string()
@@ -612,6 +662,21 @@ bool RenderableFieldlinesSequence::prepareForOsflsStreaming() {
         _loadingStatesDynamically = false;
     }
     _activeStateIndex = 0;
+
+    if (_loadingStatesDynamically) {
+        // The first state is only used to set up the properties, but its buffers are
+        // recycled for the states that are loaded later
+        _loadedStateIndex = -1;
+        // There has to be room for the current state, the preloaded states and the
+        // loads that keep running after they were cancelled
+        const unsigned int nWorkers =
+            std::clamp(std::thread::hardware_concurrency() / 2, 1u, 4u);
+        _stateLoader = std::make_unique<FieldlinesStateLoader>(
+            _sourceFiles,
+            nWorkers,
+            static_cast<size_t>(_preloadedStates.maxValue()) + 1 + nWorkers
+        );
+    }
     return true;
 }
 
@@ -645,6 +710,19 @@ void RenderableFieldlinesSequence::setupProperties() {
     addProperty(_lineWidth);
     addProperty(_jumpToStartBtn);
 
+    if (_loadingStatesDynamically) {
+        addPropertySubOwner(_streamingGroup);
+        _streamingGroup.addProperty(_preloadedStates);
+        _averageLoadTime.setReadOnly(true);
+        _streamingGroup.addProperty(_averageLoadTime);
+        _maxLoadTime.setReadOnly(true);
+        _streamingGroup.addProperty(_maxLoadTime);
+        _displayLatency.setReadOnly(true);
+        _streamingGroup.addProperty(_displayLatency);
+        _cancelledLoads.setReadOnly(true);
+        _streamingGroup.addProperty(_cancelledLoads);
+    }
+
     // Add Property Groups
     addPropertySubOwner(_colorGroup);
     addPropertySubOwner(_domainGroup);
@@ -704,6 +782,8 @@ void RenderableFieldlinesSequence::setupProperties() {
 
         _maskingQuantity = _maskingQuantityTemp;
         _maskingMinMax = _maskingRanges[_colorQuantity];
+
+        updateCopiedExtraQuantities();
     }
 }
 
@@ -713,6 +793,7 @@ void RenderableFieldlinesSequence::definePropertyCallbackFunctions() {
     if (hasExtras) {
         _colorQuantity.onChange([this]() {
             _shouldUpdateColorBuffer = true;
+            updateCopiedExtraQuantities();
             _colorQuantityMinMax = _colorTableRanges[_colorQuantity];
             _colorTablePath = _colorTablePaths[_colorQuantity];
         });
@@ -727,6 +808,7 @@ void RenderableFieldlinesSequence::definePropertyCallbackFunctions() {
 
         _maskingQuantity.onChange([this]() {
             _shouldUpdateMaskingBuffer = true;
+            updateCopiedExtraQuantities();
             _maskingMinMax = _maskingRanges[_maskingQuantity];
         });
 
@@ -968,15 +1050,8 @@ void RenderableFieldlinesSequence::deinitializeGL() {
         _shaderProgram = nullptr;
     }
 
-    // Stall main thread until thread that's loading states is done
-    bool printedWarning = false;
-    while (_isLoadingStateFromDisk) {
-        if (!printedWarning) {
-            LWARNING("Trying to destroy class when an active thread is still using it");
-            printedWarning = true;
-        }
-        std::this_thread::sleep_for(std::chrono::milliseconds(5));
-    }
+    // Waits for the states that are currently being loaded
+    _stateLoader = nullptr;
 }
 
 bool RenderableFieldlinesSequence::isReady() const {
@@ -1125,22 +1200,28 @@ void RenderableFieldlinesSequence::update(const UpdateData& data) {
     }
 
     if (mustLoadNewStateFromDisk) {
-        if (!_isLoadingStateFromDisk && !_newStateIsReady) {
-            _isLoadingStateFromDisk = true;
-            mustLoadNewStateFromDisk  = false;
-            std::string filePath = _sourceFiles[_activeTriggerTimeIndex];
-            std::thread readBinaryThread([this, f = std::move(filePath)]() {
-                readNewState(f);
-            });
-            readBinaryThread.detach();
-        }
+        _stateLoader->request(preloadedStateIndices());
+        _stateChangeTime = std::chrono::steady_clock::now();
     }
 
-    if (needUpdate || _newStateIsReady) {
-        if (_loadingStatesDynamically) {
-            _states[0] = std::move(*_newState);
+    bool hasNewState = false;
+    if (_loadingStatesDynamically && _activeTriggerTimeIndex != -1 &&
+        _loadedStateIndex != _activeTriggerTimeIndex)
+    {
+        // The previous state is handed back to the loader so that it stays available
+        // when stepping back in time and so that its buffers are reused
+        hasNewState = _stateLoader->swap(
+            _activeTriggerTimeIndex,
+            _states[0],
+            _loadedStateIndex
+        );
+        if (hasNewState) {
+            _loadedStateIndex = _activeTriggerTimeIndex;
+            updateStreamingMetrics();
         }
+    }
 
+    if (needUpdate || hasNewState) {
         updateVertexPositionBuffer();
 
         if (_states[_activeStateIndex].nExtraQuantities() > 0) {
@@ -1150,7 +1231,6 @@ void RenderableFieldlinesSequence::update(const UpdateData& data) {
 
         // Everything is set and ready for rendering
         needUpdate = false;
-        _newStateIsReady = false;
     }
 
     if (_colorMethod == 1) { //By quantity
@@ -1167,6 +1247,18 @@ void RenderableFieldlinesSequence::update(const UpdateData& data) {
 }
 
 // Assumes we already know that currentTime is within the sequence interval
+void RenderableFieldlinesSequence::updateCopiedExtraQuantities() {
+    if (!_stateLoader) {
+        return;
+    }
+    // The values of these quantities are uploaded to the GPU on the render thread, so
+    // they are read from disk by the loader instead of on first access
+    _stateLoader->setCopiedExtraQuantities({
+        static_cast<size_t>(_colorQuantity.value()),
+        static_cast<size_t>(_maskingQuantity.value())
+    });
+}
+
 void RenderableFieldlinesSequence::updateActiveTriggerTimeIndex(double currentTime) {
     auto iter = std::upper_bound(_startTimes.begin(), _startTimes.end(), currentTime);
     if (iter != _startTimes.end()) {
@@ -1187,13 +1279,41 @@ void RenderableFieldlinesSequence::updateActiveTriggerTimeIndex(double currentTi
     }
 }
 
-// Reading state from disk. Must be thread safe
-void RenderableFieldlinesSequence::readNewState(const std::string& filePath) {
-    _newState = std::make_unique<FieldlinesState>();
-    if (_newState->loadStateFromOsfls(filePath)) {
-        _newStateIsReady = true;
+std::vector<int> RenderableFieldlinesSequence::preloadedStateIndices() const {
+    // If the time is moving, three quarters of the preloaded states are ahead of the
+    // current state in the direction of time. Otherwise they are split evenly
+    const double deltaTime = global::timeManager->deltaTime();
+    const int direction = deltaTime < 0.0 ? -1 : 1;
+    const int nAhead = deltaTime == 0.0 ?
+        _preloadedStates - _preloadedStates / 2 :
+        _preloadedStates - _preloadedStates / 4;
+    const int nBehind = _preloadedStates - nAhead;
+
+    // The current state comes first as it is needed right away, the following ones are
+    // alternating ahead and behind, closest first
+    std::vector<int> indices = { _activeTriggerTimeIndex };
+    for (int i = 1; i <= std::max(nAhead, nBehind); i++) {
+        if (i <= nAhead) {
+            indices.push_back(_activeTriggerTimeIndex + direction * i);
+        }
+        if (i <= nBehind) {
+            indices.push_back(_activeTriggerTimeIndex - direction * i);
+        }
     }
-    _isLoadingStateFromDisk = false;
+    return indices;
+}
+
+void RenderableFieldlinesSequence::updateStreamingMetrics() {
+    using namespace std::chrono;
+
+    const FieldlinesStateLoader::Statistics stats = _stateLoader->statistics();
+    _averageLoadTime = static_cast<float>(stats.averageLatency.count()) / 1000.f;
+    _maxLoadTime = static_cast<float>(stats.maxLatency.count()) / 1000.f;
+    _cancelledLoads = stats.nCancelled;
+    const microseconds latency = duration_cast<microseconds>(
+        steady_clock::now() - _stateChangeTime
+    );
+    _displayLatency = static_cast<float>(latency.count()) / 1000.f;
 }
 
 // Unbind buffers and arrays
@@ -1228,7 +1348,7 @@ void RenderableFieldlinesSequence::updateVertexColorBuffer() {
     glBindBuffer(GL_ARRAY_BUFFER, _vertexColorBuffer);
 
     bool isSuccessful;
-    const std::vector<float>& quantities = _states[_activeStateIndex].extraQuantity(
+    std::span<const float> quantities = _states[_activeStateIndex].extraQuantity(
         _colorQuantity,
         isSuccessful
     );
@@ -1254,7 +1374,7 @@ void RenderableFieldlinesSequence::updateVertexMaskingBuffer() {
     glBindBuffer(GL_ARRAY_BUFFER, _vertexMaskingBuffer);
 
     bool isSuccessful;
-    const std::vector<float>& maskings = _states[_activeStateIndex].extraQuantity(
+    std::span<const float> maskings = _states[_activeStateIndex].extraQuantity(
         _maskingQuantity,
         isSuccessful
     );
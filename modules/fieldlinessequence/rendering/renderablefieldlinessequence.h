@@ -31,17 +31,21 @@
 #include <openspace/properties/optionproperty.h>
 #include <openspace/properties/stringproperty.h>
 #include <openspace/properties/triggerproperty.h>
+#include <openspace/properties/scalar/floatproperty.h>
 #include <openspace/properties/scalar/intproperty.h>
 #include <openspace/properties/vector/vec2property.h>
 #include <openspace/properties/vector/vec4property.h>
 #include <openspace/rendering/transferfunction.h>
-#include <atomic>
+#include <chrono>
 
 namespace openspace {
 
+class FieldlinesStateLoader;
+
 class RenderableFieldlinesSequence : public Renderable {
 public:
     RenderableFieldlinesSequence(const ghoul::Dictionary& dictionary);
+    ~RenderableFieldlinesSequence() override;
     void initialize() override;
     void initializeGL() override;
     void deinitializeGL() override;
@@ -65,7 +69,11 @@ private:
     void setupProperties();
     bool prepareForOsflsStreaming();
 
-    void readNewState(const std::string& filePath);
+    /// Returns the indices of the states that should be loaded in order of priority
+    std::vector<int> preloadedStateIndices() const;
+    void updateStreamingMetrics();
+    /// Makes the state loader copy the extra quantities that are used for rendering
+    void updateCopiedExtraQuantities();
     void updateActiveTriggerTimeIndex(double currentTime);
     void updateVertexPositionBuffer();
     void updateVertexColorBuffer();
@@ -93,15 +101,13 @@ private:
     // optional except when using json input
     std::string _modelStr;
 
-    // Used for 'runtime-states'. True when loading a new state from disk on another
-    // thread.
-    std::atomic_bool _isLoadingStateFromDisk = false;
     // False => states are stored in RAM (using 'in-RAM-states'), True => states are
     // loaded from disk during runtime (using 'runtime-states')
     bool _loadingStatesDynamically  = false;
-    // Used for 'runtime-states'. True when finished loading a new state from disk on
-    // another thread.
-    std::atomic_bool _newStateIsReady = false;
+    // Used for 'runtime-states'. The index of the state that is stored in _states[0]
+    int _loadedStateIndex = -1;
+    // Used for 'runtime-states'. The time at which the active state last changed
+    std::chrono::steady_clock::time_point _stateChangeTime;
     // True when new state is loaded or user change which quantity to color the lines by
     bool _shouldUpdateColorBuffer   = false;
     // True when new state is loaded or user change which quantity used for masking out
@@ -139,9 +145,8 @@ private:
     // OpenGL Vertex Buffer Object containing the vertex positions
     GLuint _vertexPositionBuffer = 0;
 
-    // The Lua-Modfile-Dictionary used during initialization
-    // Used for 'runtime-states' when switching out current state to a new state
-    std::unique_ptr<FieldlinesState> _newState;
+    // Used for 'runtime-states' to load the states around the current one
+    std::unique_ptr<FieldlinesStateLoader> _stateLoader;
     std::unique_ptr<ghoul::opengl::ProgramObject> _shaderProgram;
     // Transfer function used to color lines when _pColorMethod is set to BY_QUANTITY
     std::unique_ptr<TransferFunction> _transferFunction;
@@ -222,6 +227,19 @@ private:
     properties::FloatProperty _lineWidth;
     // Button which executes a time jump to start of sequence
     properties::TriggerProperty _jumpToStartBtn;
+
+    // Group to hold the properties for 'runtime-states'
+    properties::PropertyOwner _streamingGroup;
+    // Number of states around the current one that are loaded in the background
+    properties::IntProperty _preloadedStates;
+    // Average time it took to load a state in milliseconds
+    properties::FloatProperty _averageLoadTime;
+    // Longest time it took to load a state in milliseconds
+    properties::FloatProperty _maxLoadTime;
+    // Time between the last state change and showing the new state in milliseconds
+    properties::FloatProperty _displayLatency;
+    // Number of loads that were cancelled because their state was no longer needed
+    properties::IntProperty _cancelledLoads;
 };
 
 } // namespace openspace
@@ -0,0 +1,127 @@
+/*****************************************************************************************
+ *                                                                                       *
+ * OpenSpace                                                                             *
+ *                                                                                       *
+ * Copyright (c) 2014-2023                                                               *
+ *                                                                                       *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this  *
+ * software and associated documentation files (the "Software"), to deal in the Software *
+ * without restriction, including without limitation the rights to use, copy, modify,    *
+ * merge, publish, distribute, sublicense, and/or sell copies of the Software, and to    *
+ * permit persons to whom the Software is furnished to do so, subject to the following   *
+ * conditions:                                                                           *
+ *                                                                                       *
+ * The above copyright notice and this permission notice shall be included in all copies *
+ * or substantial portions of the Software.                                              *
+ *                                                                                       *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,   *
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A         *
+ * PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT    *
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF  *
+ * CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE  *
+ * OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                                         *
+ ****************************************************************************************/
+
+
+#include <modules/fieldlinessequence/tasks/fieldlinesjsontoosflstask.h>
+
+#include <modules/fieldlinessequence/util/fieldlinesstate.h>
+#include <openspace/documentation/verifier.h>
+#include <ghoul/fmt.h>
+#include <ghoul/filesystem/filesystem.h>
+#include <ghoul/logging/logmanager.h>
+#include <algorithm>
+#include <chrono>
+#include <vector>
+
+namespace {
+    constexpr std::string_view _loggerCat = "FieldlinesJsonToOsflsTask";
+
+    struct [[codegen::Dictionary(FieldlinesJsonToOsflsTask)]] Parameters {
+        // The folder containing the json files that are converted
+        std::filesystem::path inputFolder [[codegen::directory()]];
+
+        // The folder into which the .osfls files are written. The folder is created if
+        // it does not exist
+        std::string outputFolder [[codegen::annotation("A valid folder path")]];
+
+        // Currently supports: batsrus, enlil & pfss
+        std::string simulationModel;
+
+        // Convert the models distance unit, ex. AU for Enlil, to meters. 1.0 is default,
+        // assuming meters as input
+        std::optional<float> scaleToMeters;
+    };
+#include "fieldlinesjsontoosflstask_codegen.cpp"
+} // namespace
+
+namespace openspace {
+
+documentation::Documentation FieldlinesJsonToOsflsTask::documentation() {
+    return codegen::doc<Parameters>("fieldlinessequence_json_to_osfls_task");
+}
+
+FieldlinesJsonToOsflsTask::FieldlinesJsonToOsflsTask(const ghoul::Dictionary& dictionary)
+{
+    const Parameters p = codegen::bake<Parameters>(dictionary);
+    _inputFolder = absPath(p.inputFolder.string());
+    _outputFolder = absPath(p.outputFolder);
+    _model = fls::stringToModel(p.simulationModel);
+    _scaleToMeters = p.scaleToMeters.value_or(_scaleToMeters);
+}
+
+std::string FieldlinesJsonToOsflsTask::description() {
+    return fmt::format(
+        "Convert the field line json files in {} to .osfls files in {}",
+        _inputFolder, _outputFolder
+    );
+}
+
+bool FieldlinesJsonToOsflsTask::isThreadSafe() const {
+    // Only reads and writes the files that are specified in the task
+    return true;
+}
+
+void FieldlinesJsonToOsflsTask::perform(const Task::ProgressCallback& progressCallback) {
+    std::vector<std::filesystem::path> files;
+    for (const std::filesystem::directory_entry& e :
+         std::filesystem::directory_iterator(_inputFolder))
+    {
+        if (e.is_regular_file() && e.path().extension() == ".json") {
+            files.push_back(e.path());
+        }
+    }
+    std::sort(files.begin(), files.end());
+    std::filesystem::create_directories(_outputFolder);
+
+    // saveStateToOsfls expects the folder to end with a separator
+    const std::string outputFolder = (_outputFolder / "").string();
+
+    const auto start = std::chrono::steady_clock::now();
+    size_t nBytes = 0;
+    size_t nConverted = 0;
+    for (size_t i = 0; i < files.size(); ++i) {
+        FieldlinesState state;
+        if (state.loadStateFromJson(files[i].string(), _model, _scaleToMeters)) {
+            state.saveStateToOsfls(outputFolder);
+            nBytes += std::filesystem::file_size(files[i]);
+            nConverted++;
+        }
+        else {
+            LWARNING(fmt::format("Failed to convert {}", files[i]));
+        }
+        progressCallback(static_cast<float>(i + 1) / static_cast<float>(files.size()));
+    }
+
+    const double seconds = std::chrono::duration<double>(
+        std::chrono::steady_clock::now() - start
+    ).count();
+    const double megabytes = static_cast<double>(nBytes) / (1024.0 * 1024.0);
+    LINFO(fmt::format(
+        "Converted {} of {} files ({:.1f} MB) in {:.2f} s ({:.1f} MB/s)",
+        nConverted, files.size(), megabytes, seconds,
+        seconds > 0.0 ? megabytes / seconds : 0.0
+    ));
+}
+
+} // namespace openspace
@@ -0,0 +1,61 @@
+/*****************************************************************************************
+ *                                                                                       *
+ * OpenSpace                                                                             *
+ *                                                                                       *
+ * Copyright (c) 2014-2023                                                               *
+ *                                                                                       *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this  *
+ * software and associated documentation files (the "Software"), to deal in the Software *
+ * without restriction, including without limitation the rights to use, copy, modify,    *
+ * merge, publish, distribute, sublicense, and/or sell copies of the Software, and to    *
+ * permit persons to whom the Software is furnished to do so, subject to the following   *
+ * conditions:                                                                           *
+ *                                                                                       *
+ * The above copyright notice and this permission notice shall be included in all copies *
+ * or substantial portions of the Software.                                              *
+ *                                                                                       *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,   *
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A         *
+ * PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT    *
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF  *
+ * CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE  *
+ * OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                                         *
+ ****************************************************************************************/
+
+
+#ifndef __OPENSPACE_MODULE_FIELDLINESSEQUENCE___FIELDLINESJSONTOOSFLSTASK___H__
+#define __OPENSPACE_MODULE_FIELDLINESSEQUENCE___FIELDLINESJSONTOOSFLSTASK___H__
+
+#include <openspace/util/task.h>
+
+#include <modules/fieldlinessequence/util/commons.h>
+#include <filesystem>
+#include <string>
+
+namespace openspace {
+
+/**
+ * Converts all field line states in a folder of CCMC json files into the binary .osfls
+ * format, which can be streamed by the RenderableFieldlinesSequence. The throughput of
+ * the conversion is logged when the task is finished.
+ */
+class FieldlinesJsonToOsflsTask : public Task {
+public:
+    FieldlinesJsonToOsflsTask(const ghoul::Dictionary& dictionary);
+
+    std::string description() override;
+    void perform(const Task::ProgressCallback& progressCallback) override;
+    bool isThreadSafe() const override;
+
+    static documentation::Documentation documentation();
+
+private:
+    std::filesystem::path _inputFolder;
+    std::filesystem::path _outputFolder;
+    fls::Model _model = fls::Model::Invalid;
+    float _scaleToMeters = 1.f;
+};
+
+} // namespace openspace
+
+#endif // __OPENSPACE_MODULE_FIELDLINESSEQUENCE___FIELDLINESJSONTOOSFLSTASK___H__
@@ -25,16 +25,230 @@
 #include <modules/fieldlinessequence/util/fieldlinesstate.h>
 
 #include <openspace/json.h>
+#include <openspace/util/memorymappedfile.h>
 #include <openspace/util/time.h>
 #include <ghoul/fmt.h>
 #include <ghoul/logging/logmanager.h>
+#include <ghoul/misc/assert.h>
+#include <ghoul/misc/exception.h>
+#include <algorithm>
+#include <array>
+#include <cstring>
 #include <fstream>
 #include <iomanip>
 
 namespace {
     constexpr std::string_view _loggerCat = "FieldlinesState";
-    constexpr int CurrentVersion = 0;
+    constexpr int CurrentVersion = 1;
     using json = nlohmann::json;
+
+    // The sections of a version 1 file start at a multiple of this many bytes, so that
+    // the arrays are correctly aligned when they are used directly from a mapped file
+    constexpr size_t SectionAlignment = 16;
+
+    // The fixed size header at the beginning of a version 1 file. It is followed by the
+    // offset table, which contains the byte offset of each section from the beginning of
+    // the file in the order: lineStart, lineCount, vertexPositions, one section for each
+    // extra quantity, and the extra quantity names
+    struct HeaderV1 {
+        int32_t version;
+        int32_t model;
+        double triggerTime;
+        uint64_t isMorphable;
+        uint64_t nLines;
+        uint64_t nPoints;
+        uint64_t nExtras;
+        uint64_t nStringBytes;
+    };
+    static_assert(sizeof(HeaderV1) == 56);
+
+    size_t alignedSize(size_t size) {
+        return (size + SectionAlignment - 1) / SectionAlignment * SectionAlignment;
+    }
+
+    // Builds the contents of a field line state while a CCMC json file is parsed (see
+    // the description of the file structure above saveStateToJson), which means that
+    // the file never has to be held in memory as a json object. Only the 'time' and
+    // 'trace' keys of each line are used; everything else is skipped. The trigger time
+    // and the names of the columns are taken from the first line in the file
+    class JsonStateReader : public nlohmann::json_sax<json> {
+    public:
+        explicit JsonStateReader(float coordToMeters) : _coordToMeters(coordToMeters) {}
+
+        bool null() override { return true; }
+        bool boolean(bool) override { return true; }
+        bool binary(binary_t&) override { return true; }
+
+        bool number_integer(number_integer_t value) override {
+            return addValue(static_cast<float>(value));
+        }
+
+        bool number_unsigned(number_unsigned_t value) override {
+            return addValue(static_cast<float>(value));
+        }
+
+        bool number_float(number_float_t value, const string_t&) override {
+            return addValue(static_cast<float>(value));
+        }
+
+        bool string(string_t& value) override {
+            if (_nLines > 0 || _stack.empty()) {
+                return true;
+            }
+
+            if (_stack.back() == Context::Columns) {
+                columns.push_back(std::move(value));
+            }
+            else if (_stack.back() == Context::Line && _key == "time") {
+                time = std::move(value);
+            }
+            return true;
+        }
+
+        bool key(string_t& value) override {
+            _key = std::move(value);
+            return true;
+        }
+
+        bool start_object(std::size_t) override {
+            return push(true);
+        }
+
+        bool end_object() override {
+            return pop();
+        }
+
+        bool start_array(std::size_t) override {
+            return push(false);
+        }
+
+        bool end_array() override {
+            return pop();
+        }
+
+        bool parse_error(std::size_t, const std::string&,
+                         const nlohmann::detail::exception& e) override
+        {
+            error = e.what();
+            return false;
+        }
+
+        std::string time;
+        std::vector<std::string> columns;
+        std::vector<GLint> lineStart;
+        std::vector<GLsizei> lineCount;
+        std::vector<glm::vec3> positions;
+        std::vector<std::vector<float>> extras;
+        // The number of values per point, which is determined by the first point
+        size_t nValues = 0;
+        std::string error;
+
+    private:
+        enum class Context { Root, Line, Trace, Columns, Data, Point, Ignored };
+
+        bool push(bool isObject) {
+            Context context = Context::Ignored;
+            if (_stack.empty()) {
+                if (!isObject) {
+                    error = "The file must contain an object of field lines";
+                    return false;
+                }
+                context = Context::Root;
+            }
+            else {
+                switch (_stack.back()) {
+                    case Context::Root:
+                        context = isObject ? Context::Line : Context::Ignored;
+                        break;
+                    case Context::Line:
+                        if (isObject && _key == "trace") {
+                            context = Context::Trace;
+                        }
+                        break;
+                    case Context::Trace:
+                        if (!isObject && _key == "columns") {
+                            context = Context::Columns;
+                        }
+                        else if (!isObject && _key == "data") {
+                            context = Context::Data;
+                        }
+                        break;
+                    case Context::Data:
+                        context = isObject ? Context::Ignored : Context::Point;
+                        break;
+                    default:
+                        break;
+                }
+            }
+
+            if (context == Context::Line) {
+                _lineStart = positions.size();
+            }
+            else if (context == Context::Point) {
+                _point.clear();
+            }
+            _stack.push_back(context);
+            return true;
+        }
+
+        bool pop() {
+            const Context context = _stack.back();
+            _stack.pop_back();
+
+            if (context == Context::Line) {
+                lineStart.push_back(static_cast<GLint>(_lineStart));
+                lineCount.push_back(static_cast<GLsizei>(positions.size() - _lineStart));
+                _nLines++;
+            }
+            else if (context == Context::Point) {
+                return addPoint();
+            }
+            return true;
+        }
+
+        bool addValue(float value) {
+            if (!_stack.empty() && _stack.back() == Context::Point) {
+                _point.push_back(value);
+            }
+            return true;
+        }
+
+        bool addPoint() {
+            if (nValues == 0) {
+                // Expects the x, y and z variables to be stored first!
+                if (_point.size() < 3) {
+                    error = "Each point must at least contain the x, y and z variables";
+                    return false;
+                }
+                nValues = _point.size();
+                extras.resize(nValues - 3);
+            }
+            else if (_point.size() != nValues) {
+                error = fmt::format(
+                    "Point {} has {} values, but previous points had {}",
+                    positions.size(), _point.size(), nValues
+                );
+                return false;
+            }
+
+            positions.push_back(
+                _coordToMeters * glm::vec3(_point[0], _point[1], _point[2])
+            );
+            // Add the extra quantites. Stored in the same array as the x,y,z variables.
+            // Hence index of the first extra quantity = 3
+            for (size_t i = 0; i < extras.size(); ++i) {
+                extras[i].push_back(_point[i + 3]);
+            }
+            return true;
+        }
+
+        const float _coordToMeters;
+        std::vector<Context> _stack;
+        std::string _key;
+        std::vector<float> _point;
+        size_t _lineStart = 0;
+        size_t _nLines = 0;
+    };
 } // namespace
 
 namespace openspace {
@@ -61,7 +275,9 @@ void FieldlinesState::scalePositions(float scale) {
     }
 }
 
-bool FieldlinesState::loadStateFromOsfls(const std::string& pathToOsflsFile) {
+bool FieldlinesState::loadStateFromOsfls(const std::string& pathToOsflsFile,
+                                         const std::vector<size_t>& copiedExtraQuantities)
+{
     std::ifstream ifs(pathToOsflsFile, std::ifstream::binary);
     if (!ifs.is_open()) {
         LERROR("Couldn't open file: " + pathToOsflsFile);
@@ -73,12 +289,19 @@ bool FieldlinesState::loadStateFromOsfls(const std::string& pathToOsflsFile) {
 
     switch (binFileVersion) {
         case 0:
-            // No need to put everything in this scope now, as only version 0 exists!
-            break;
+            return loadStateFromOsflsV0(ifs);
+        case 1:
+            ifs.close();
+            return loadStateFromOsflsV1(pathToOsflsFile, copiedExtraQuantities);
         default:
             LERROR("VERSION OF BINARY FILE WAS NOT RECOGNIZED");
             return false;
     }
+}
+
+bool FieldlinesState::loadStateFromOsflsV0(std::ifstream& ifs) {
+    _mappedFile = nullptr;
+    _mappedExtraQuantities.clear();
 
     // Define tmp variables to store meta data in
     size_t nLines;
@@ -133,114 +356,211 @@ bool FieldlinesState::loadStateFromOsfls(const std::string& pathToOsflsFile) {
     return true;
 }
 
-bool FieldlinesState::loadStateFromJson(const std::string& pathToJsonFile,
-                                        fls::Model Model, float coordToMeters)
+bool FieldlinesState::loadStateFromOsflsV1(const std::string& pathToOsflsFile,
+                                       const std::vector<size_t>& copiedExtraQuantities)
 {
-    // --------------------- ENSURE FILE IS VALID, THEN PARSE IT --------------------- //
-    std::ifstream ifs(pathToJsonFile);
+    std::shared_ptr<const MemoryMappedFile> file;
+    try {
+        file = std::make_shared<const MemoryMappedFile>(pathToOsflsFile);
+    }
+    catch (const ghoul::RuntimeError& e) {
+        LERROR(e.message);
+        return false;
+    }
+    const char* data = file->data();
+    const size_t size = file->size();
 
-    if (!ifs.is_open()) {
-        LERROR(fmt::format("FAILED TO OPEN FILE: {}", pathToJsonFile));
+    HeaderV1 header;
+    if (size < sizeof(HeaderV1)) {
+        LERROR(fmt::format("The file {} is corrupt", pathToOsflsFile));
         return false;
     }
+    std::memcpy(&header, data, sizeof(HeaderV1));
 
-    json jFile;
-    ifs >> jFile;
-    // -------------------------------------------------------------------------------- //
+    // A corrupt header could otherwise lead to overflows when computing section sizes
+    if (header.nLines > size || header.nPoints > size || header.nExtras > size ||
+        header.nStringBytes > size)
+    {
+        LERROR(fmt::format("The file {} is corrupt", pathToOsflsFile));
+        return false;
+    }
 
-    _model = Model;
+    const size_t nSections = 4 + header.nExtras;
+    if (size < sizeof(HeaderV1) + nSections * sizeof(uint64_t)) {
+        LERROR(fmt::format("The file {} is corrupt", pathToOsflsFile));
+        return false;
+    }
+    std::vector<uint64_t> offsets(nSections);
+    std::memcpy(
+        offsets.data(),
+        data + sizeof(HeaderV1),
+        nSections * sizeof(uint64_t)
+    );
 
-    const char* sData  = "data";
-    const char* sTrace = "trace";
+    std::vector<const char*> sections(nSections);
+    for (size_t i = 0; i < nSections; ++i) {
+        size_t nBytes = header.nPoints * sizeof(float);
+        if (i < 2) {
+            nBytes = header.nLines * sizeof(GLint);
+        }
+        else if (i == 2) {
+            nBytes = header.nPoints * sizeof(glm::vec3);
+        }
+        else if (i == nSections - 1) {
+            nBytes = header.nStringBytes;
+        }
 
-    // ----- EXTRACT THE EXTRA QUANTITY NAMES & TRIGGER TIME (same for all lines) ----- //
-    {
-        const char* sTime = "time";
-        const json& jTmp = *(jFile.begin()); // First field line in the file
-        _triggerTime = Time::convertTime(jTmp[sTime]);
-
-        const char* sColumns = "columns";
-        const json::value_type& variableNameVec = jTmp[sTrace][sColumns];
-        const size_t nVariables = variableNameVec.size();
-        const size_t nPosComponents = 3; // x,y,z
-
-        if (nVariables < nPosComponents) {
-            LERROR(
-                pathToJsonFile + ": Each field '" + sColumns +
-                "' must contain the variables: 'x', 'y' and 'z' (order is important)"
-            );
+        if (offsets[i] % SectionAlignment != 0 || offsets[i] > size ||
+            nBytes > size - offsets[i])
+        {
+            LERROR(fmt::format("The file {} is corrupt", pathToOsflsFile));
             return false;
         }
+        sections[i] = data + offsets[i];
+    }
 
-        for (size_t i = nPosComponents ; i < nVariables ; ++i) {
-            _extraQuantityNames.push_back(variableNameVec[i]);
+    _triggerTime = header.triggerTime;
+    _model = static_cast<fls::Model>(header.model);
+    _isMorphable = header.isMorphable != 0;
+
+    const GLint* lineStart = reinterpret_cast<const GLint*>(sections[0]);
+    _lineStart.assign(lineStart, lineStart + header.nLines);
+    const GLsizei* lineCount = reinterpret_cast<const GLsizei*>(sections[1]);
+    _lineCount.assign(lineCount, lineCount + header.nLines);
+    const glm::vec3* positions = reinterpret_cast<const glm::vec3*>(sections[2]);
+    _vertexPositions.assign(positions, positions + header.nPoints);
+
+    // Only the requested extra quantities are copied, as usually only one or two of them
+    // are used at the same time. Copying them here means that their pages are read from
+    // disk on the loading thread rather than when they are first accessed. The vectors
+    // are cleared rather than destroyed so that their memory is reused by the next load
+    _extraQuantities.resize(header.nExtras);
+    _mappedExtraQuantities.resize(header.nExtras);
+    for (size_t i = 0; i < header.nExtras; ++i) {
+        const float* values = reinterpret_cast<const float*>(sections[3 + i]);
+        _mappedExtraQuantities[i] = values;
+
+        const bool isCopied = std::find(
+            copiedExtraQuantities.begin(),
+            copiedExtraQuantities.end(),
+            i
+        ) != copiedExtraQuantities.end();
+        if (isCopied) {
+            _extraQuantities[i].assign(values, values + header.nPoints);
+        }
+        else {
+            _extraQuantities[i].clear();
         }
     }
 
-    const size_t nExtras = _extraQuantityNames.size();
-    _extraQuantities.resize(nExtras);
+    // The names are stored as consecutive c-strings
+    _extraQuantityNames.resize(header.nExtras);
+    std::string_view allNamesInOne(sections.back(), header.nStringBytes);
+    for (size_t i = 0; i < header.nExtras; ++i) {
+        const size_t end = std::min(allNamesInOne.find('\0'), allNamesInOne.size());
+        _extraQuantityNames[i] = allNamesInOne.substr(0, end);
+        allNamesInOne.remove_prefix(std::min(end + 1, allNamesInOne.size()));
+    }
 
-    size_t lineStartIdx = 0;
-    // Loop through all fieldlines
-    for (json::iterator lineIter = jFile.begin(); lineIter != jFile.end(); ++lineIter) {
-        // The 'data' field in the 'trace' variable contains all vertex positions and the
-        // extra quantities. Each element is an array related to one vertex point.
-        const std::vector<std::vector<float>>& jData = (*lineIter)[sTrace][sData];
-        const size_t nPoints = jData.size();
-
-        for (size_t j = 0; j < nPoints; ++j) {
-            const std::vector<float>& variables = jData[j];
-
-            // Expects the x, y and z variables to be stored first!
-            const size_t xIdx = 0;
-            const size_t yIdx = 1;
-            const size_t zIdx = 2;
-            _vertexPositions.push_back(
-                coordToMeters * glm::vec3(
-                    variables[xIdx],
-                    variables[yIdx],
-                    variables[zIdx]
-                )
-            );
+    _mappedFile = std::move(file);
+    return true;
+}
 
-            // Add the extra quantites. Stored in the same array as the x,y,z variables.
-            // Hence index of the first extra quantity = 3
-            for (size_t xtraIdx = 3, k = 0 ; k < nExtras; ++k, ++xtraIdx) {
-                _extraQuantities[k].push_back(variables[xtraIdx]);
-            }
-        }
-        _lineCount.push_back(static_cast<GLsizei>(nPoints));
-        _lineStart.push_back(static_cast<GLsizei>(lineStartIdx));
-        lineStartIdx += nPoints;
+bool FieldlinesState::loadStateFromJson(const std::string& pathToJsonFile,
+                                        fls::Model Model, float coordToMeters)
+{
+    // The file is mapped into memory and parsed incrementally, so the memory that is
+    // needed is only the size of the resulting state rather than a full json object
+    std::unique_ptr<MemoryMappedFile> file;
+    try {
+        file = std::make_unique<MemoryMappedFile>(pathToJsonFile);
+    }
+    catch (const ghoul::RuntimeError&) {
+        LERROR(fmt::format("FAILED TO OPEN FILE: {}", pathToJsonFile));
+        return false;
+    }
+
+    JsonStateReader reader(coordToMeters);
+    const bool success = file->size() > 0 && json::sax_parse(
+        file->data(),
+        file->data() + file->size(),
+        &reader
+    );
+    if (!success) {
+        LERROR(fmt::format(
+            "Failed to parse {}: {}",
+            pathToJsonFile, reader.error.empty() ? "Empty file" : reader.error
+        ));
+        return false;
+    }
+
+    const size_t nPosComponents = 3; // x,y,z
+    if (reader.columns.size() < nPosComponents) {
+        LERROR(
+            pathToJsonFile + ": Each field 'columns' must contain the variables: " +
+            "'x', 'y' and 'z' (order is important)"
+        );
+        return false;
     }
+    if (reader.nValues > 0 && reader.nValues != reader.columns.size()) {
+        LERROR(fmt::format(
+            "{}: There are {} columns but each point has {} values",
+            pathToJsonFile, reader.columns.size(), reader.nValues
+        ));
+        return false;
+    }
+    if (reader.time.empty()) {
+        LERROR(fmt::format("{}: The field lines are missing the 'time'", pathToJsonFile));
+        return false;
+    }
+
+    _model = Model;
+    _triggerTime = Time::convertTime(reader.time);
+    _extraQuantityNames.assign(
+        std::make_move_iterator(reader.columns.begin() + nPosComponents),
+        std::make_move_iterator(reader.columns.end())
+    );
+    _extraQuantities = std::move(reader.extras);
+    _extraQuantities.resize(_extraQuantityNames.size());
+    _lineStart = std::move(reader.lineStart);
+    _lineCount = std::move(reader.lineCount);
+    _vertexPositions = std::move(reader.positions);
+    _mappedFile = nullptr;
+    _mappedExtraQuantities.clear();
     return true;
 }
 
 /**
  * \param absPath must be the path to the file (incl. filename but excl. extension!)
  * Directory must exist! File is created (or overwritten if already existing).
- * File is structured like this: (for version 0)
- *  0. int                    - version number of binary state file! (in case something
+ * File is structured like this: (for version 1)
+ *  0. int32_t                - version number of binary state file! (in case something
  *                              needs to be altered in the future, then increase
  *                              CurrentVersion)
- *  1. double                 - _triggerTime
- *  2. int                    - _model
- *  3. bool                   - _isMorphable
- *  4. size_t                 - Number of lines in the state  == _lineStart.size()
+ *  1. int32_t                - _model
+ *  2. double                 - _triggerTime
+ *  3. uint64_t               - _isMorphable
+ *  4. uint64_t               - Number of lines in the state  == _lineStart.size()
  *                                                            == _lineCount.size()
- *  5. size_t                 - Total number of vertex points == _vertexPositions.size()
- *                                                           == _extraQuantities[i].size()
- *  6. size_t                 - Number of extra quantites     == _extraQuantities.size()
+ *  5. uint64_t               - Total number of vertex points == _vertexPositions.size()
+ *                                                   == extraQuantity(i).size()
+ *  6. uint64_t               - Number of extra quantites     == nExtraQuantities()
  *                                                           == _extraQuantityNames.size()
- *  7. site_t                 - Number of total bytes that ALL _extraQuantityNames
+ *  7. uint64_t               - Number of total bytes that ALL _extraQuantityNames
  *                              consists of (Each such name is stored as a c_str which
  *                              means it ends with the null char '\0' )
- *  7. std::vector<GLint>     - _lineStart
- *  8. std::vector<GLsizei>   - _lineCount
- *  9. std::vector<glm::vec3> - _vertexPositions
- * 10. std::vector<float>     - _extraQuantities
- * 11. array of c_str         - Strings naming the extra quantities (elements of
+ *  8. uint64_t[4 + nExtras]  - Offset table containing the byte offset of each of the
+ *                              following sections, relative to the start of the file.
+ *                              Each offset is a multiple of SectionAlignment
+ *  9. std::vector<GLint>     - _lineStart
+ * 10. std::vector<GLsizei>   - _lineCount
+ * 11. std::vector<glm::vec3> - _vertexPositions
+ * 12. std::vector<float>     - One contiguous array for each extra quantity
+ * 13. array of c_str         - Strings naming the extra quantities (elements of
  *                              _extraQuantityNames). Each string ends with null char '\0'
+ *
+ * Version 0 files did not contain the offset table and stored the sections without any
+ * padding. They can still be loaded, but the extra quantities are then read into memory
  */
 void FieldlinesState::saveStateToOsfls(const std::string& absPath) {
     // ------------------------------- Create the file ------------------------------- //
@@ -266,35 +586,55 @@ void FieldlinesState::saveStateToOsfls(const std::string& absPath) {
 
     const size_t nLines = _lineStart.size();
     const size_t nPoints = _vertexPositions.size();
-    const size_t nExtras = _extraQuantities.size();
+    const size_t nExtras = nExtraQuantities();
     const size_t nStringBytes = allExtraQuantityNamesInOne.size();
 
+    HeaderV1 header;
+    header.version = CurrentVersion;
+    header.model = static_cast<int32_t>(_model);
+    header.triggerTime = _triggerTime;
+    header.isMorphable = _isMorphable ? 1 : 0;
+    header.nLines = nLines;
+    header.nPoints = nPoints;
+    header.nExtras = nExtras;
+    header.nStringBytes = nStringBytes;
+
+    //---------------------------- COMPUTE SECTION OFFSETS ------------------------------
+    std::vector<const char*> sections;
+    std::vector<size_t> sectionSizes;
+    auto addSection = [&sections, &sectionSizes](const void* data, size_t nBytes) {
+        sections.push_back(reinterpret_cast<const char*>(data));
+        sectionSizes.push_back(nBytes);
+    };
+    addSection(_lineStart.data(), sizeof(GLint) * nLines);
+    addSection(_lineCount.data(), sizeof(GLsizei) * nLines);
+    addSection(_vertexPositions.data(), sizeof(glm::vec3) * nPoints);
+    for (size_t i = 0; i < nExtras; ++i) {
+        bool isSuccessful;
+        addSection(extraQuantity(i, isSuccessful).data(), sizeof(float) * nPoints);
+    }
+    addSection(allExtraQuantityNamesInOne.data(), nStringBytes);
+
+    std::vector<uint64_t> offsets(sections.size());
+    size_t offset = alignedSize(sizeof(HeaderV1) + offsets.size() * sizeof(uint64_t));
+    for (size_t i = 0; i < sections.size(); ++i) {
+        offsets[i] = offset;
+        offset = alignedSize(offset + sectionSizes[i]);
+    }
+
     //----------------------------- WRITE EVERYTHING TO FILE -----------------------------
-    // VERSION OF BINARY FIELDLINES STATE FILE - IN CASE STRUCTURE CHANGES IN THE FUTURE
-    ofs.write(reinterpret_cast<const char*>(&CurrentVersion), sizeof(int));
-
-    //-------------------- WRITE META DATA FOR STATE --------------------------------
-    ofs.write(reinterpret_cast<const char*>(&_triggerTime), sizeof(_triggerTime));
-    ofs.write(reinterpret_cast<const char*>(&_model), sizeof(int32_t));
-    ofs.write(reinterpret_cast<const char*>(&_isMorphable), sizeof(bool));
-
-    ofs.write(reinterpret_cast<const char*>(&nLines), sizeof(uint64_t));
-    ofs.write(reinterpret_cast<const char*>(&nPoints), sizeof(uint64_t));
-    ofs.write(reinterpret_cast<const char*>(&nExtras), sizeof(uint64_t));
-    ofs.write(reinterpret_cast<const char*>(&nStringBytes), sizeof(uint64_t));
-
-    //---------------------- WRITE ALL ARRAYS OF DATA --------------------------------
-    ofs.write(reinterpret_cast<char*>(_lineStart.data()), sizeof(int32_t) * nLines);
-    ofs.write(reinterpret_cast<char*>(_lineCount.data()), sizeof(uint32_t) * nLines);
+    ofs.write(reinterpret_cast<const char*>(&header), sizeof(HeaderV1));
     ofs.write(
-        reinterpret_cast<char*>(_vertexPositions.data()),
-        3 * sizeof(float) * nPoints
+        reinterpret_cast<const char*>(offsets.data()),
+        offsets.size() * sizeof(uint64_t)
     );
-    // Write the data for each vector in _extraQuantities
-    for (std::vector<float>& vec : _extraQuantities) {
-        ofs.write(reinterpret_cast<char*>(vec.data()), sizeof(float) * nPoints);
+    size_t position = sizeof(HeaderV1) + offsets.size() * sizeof(uint64_t);
+    constexpr std::array<char, SectionAlignment> Padding = {};
+    for (size_t i = 0; i < sections.size(); ++i) {
+        ofs.write(Padding.data(), offsets[i] - position);
+        ofs.write(sections[i], sectionSizes[i]);
+        position = offsets[i] + sectionSizes[i];
     }
-    ofs.write(allExtraQuantityNamesInOne.c_str(), nStringBytes);
 }
 
 // TODO: This should probably be rewritten, but this is the way the files were structured
@@ -343,7 +683,12 @@ void FieldlinesState::saveStateToJson(const std::string& absPath) {
     std::string_view timeStr = Time(_triggerTime).ISO8601();
     const size_t nLines = _lineStart.size();
     // const size_t nPoints      = _vertexPositions.size();
-    const size_t nExtras = _extraQuantities.size();
+    const size_t nExtras = nExtraQuantities();
+    std::vector<std::span<const float>> extras(nExtras);
+    for (size_t i = 0; i < nExtras; ++i) {
+        bool isSuccessful;
+        extras[i] = extraQuantity(i, isSuccessful);
+    }
 
     size_t pointIndex = 0;
     for (size_t lineIndex = 0; lineIndex < nLines; ++lineIndex) {
@@ -353,7 +698,7 @@ void FieldlinesState::saveStateToJson(const std::string& absPath) {
             json jDataElement = { pos.x, pos.y, pos.z };
 
             for (size_t extraIndex = 0; extraIndex < nExtras; ++extraIndex) {
-                jDataElement.push_back(_extraQuantities[extraIndex][pointIndex]);
+                jDataElement.push_back(extras[extraIndex][pointIndex]);
             }
             jData.push_back(jDataElement);
         }
@@ -382,12 +727,17 @@ void FieldlinesState::setTriggerTime(double t) {
     _triggerTime = t;
 }
 
-// Returns one of the extra quantity vectors, _extraQuantities[index].
-// If index is out of scope an empty vector is returned and the referenced bool is false.
-std::vector<float> FieldlinesState::extraQuantity(size_t index, bool& isSuccessful) const
+// Returns the values of one of the extra quantities, either from _extraQuantities or from
+// the memory mapped file. If index is out of scope an empty span is returned and the
+// referenced bool is false.
+std::span<const float> FieldlinesState::extraQuantity(size_t index,
+                                                      bool& isSuccessful) const
 {
-    if (index < _extraQuantities.size()) {
+    if (index < nExtraQuantities()) {
         isSuccessful = true;
+        if (_mappedFile && _extraQuantities[index].size() != _vertexPositions.size()) {
+            return { _mappedExtraQuantities[index], _vertexPositions.size() };
+        }
         return _extraQuantities[index];
     }
     else {
@@ -415,6 +765,7 @@ void FieldlinesState::addLine(std::vector<glm::vec3>& line) {
 }
 
 void FieldlinesState::appendToExtra(size_t idx, float val) {
+    ghoul_assert(!_mappedFile, "Memory mapped extra quantities cannot be changed");
     _extraQuantities[idx].push_back(val);
 }
 
@@ -423,10 +774,6 @@ void FieldlinesState::setExtraQuantityNames(std::vector<std::string> names) {
     _extraQuantities.resize(_extraQuantityNames.size());
 }
 
-const std::vector<std::vector<float>>& FieldlinesState::extraQuantities() const {
-    return _extraQuantities;
-}
-
 const std::vector<std::string>& FieldlinesState::extraQuantityNames() const {
     return _extraQuantityNames;
 }
@@ -444,7 +791,7 @@ fls::Model FieldlinesState::FieldlinesState::model() const {
 }
 
 size_t FieldlinesState::nExtraQuantities() const {
-    return _extraQuantities.size();
+    return _mappedFile ? _mappedExtraQuantities.size() : _extraQuantities.size();
 }
 
 double FieldlinesState::triggerTime() const {
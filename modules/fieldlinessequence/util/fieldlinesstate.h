@@ -28,24 +28,32 @@
 #include <modules/fieldlinessequence/util/commons.h>
 #include <ghoul/glm.h>
 #include <ghoul/opengl/ghoul_gl.h>
+#include <iosfwd>
+#include <memory>
+#include <span>
 #include <string>
 #include <vector>
 
 namespace openspace {
 
+class MemoryMappedFile;
+
 class FieldlinesState {
 public:
     void convertLatLonToCartesian(float scale = 1.f);
     void scalePositions(float scale);
 
-    bool loadStateFromOsfls(const std::string& pathToOsflsFile);
+    // The extra quantities whose indices are in \p copiedExtraQuantities are copied out
+    // of a version 1 .osfls file while loading, all others are only read from the file
+    // once they are accessed
+    bool loadStateFromOsfls(const std::string& pathToOsflsFile,
+        const std::vector<size_t>& copiedExtraQuantities = {});
     void saveStateToOsfls(const std::string& pathToOsflsFile);
 
     bool loadStateFromJson(const std::string& pathToJsonFile, fls::Model model,
         float coordToMeters);
     void saveStateToJson(const std::string& pathToJsonFile);
 
-    const std::vector<std::vector<float>>& extraQuantities() const;
     const std::vector<std::string>& extraQuantityNames() const;
     const std::vector<GLsizei>& lineCount() const;
     const std::vector<GLint>& lineStart() const;
@@ -55,8 +63,11 @@ public:
     double triggerTime() const;
     const std::vector<glm::vec3>& vertexPositions() const;
 
-    // Special getter. Returns extraQuantities[index].
-    std::vector<float> extraQuantity(size_t index, bool& isSuccesful) const;
+    // Special getter. Returns the values of the extra quantity at \p index. If the state
+    // was loaded from a version 1 .osfls file and the quantity was not copied while
+    // loading, the values are read directly from the memory mapped file and are only
+    // paged in from disk when they are accessed
+    std::span<const float> extraQuantity(size_t index, bool& isSuccesful) const;
 
     void setModel(fls::Model m);
     void setTriggerTime(double t);
@@ -66,6 +77,10 @@ public:
     void appendToExtra(size_t idx, float val);
 
 private:
+    bool loadStateFromOsflsV0(std::ifstream& ifs);
+    bool loadStateFromOsflsV1(const std::string& pathToOsflsFile,
+        const std::vector<size_t>& copiedExtraQuantities);
+
     bool _isMorphable = false;
     double _triggerTime = -1.0;
     fls::Model _model;
@@ -75,6 +90,12 @@ private:
     std::vector<GLsizei> _lineCount;
     std::vector<GLint> _lineStart;
     std::vector<glm::vec3> _vertexPositions;
+
+    // If the state was loaded from a version 1 .osfls file, only the copied extra
+    // quantities are stored in _extraQuantities, while the others are empty and point
+    // into this mapping instead
+    std::shared_ptr<const MemoryMappedFile> _mappedFile;
+    std::vector<const float*> _mappedExtraQuantities;
 };
 
 } // namespace openspace
@@ -0,0 +1,247 @@
+/*****************************************************************************************
+ *                                                                                       *
+ * OpenSpace                                                                             *
+ *                                                                                       *
+ * Copyright (c) 2014-2023                                                               *
+ *                                                                                       *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this  *
+ * software and associated documentation files (the "Software"), to deal in the Software *
+ * without restriction, including without limitation the rights to use, copy, modify,    *
+ * merge, publish, distribute, sublicense, and/or sell copies of the Software, and to    *
+ * permit persons to whom the Software is furnished to do so, subject to the following   *
+ * conditions:                                                                           *
+ *                                                                                       *
+ * The above copyright notice and this permission notice shall be included in all copies *
+ * or substantial portions of the Software.                                              *
+ *                                                                                       *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,   *
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A         *
+ * PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT    *
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF  *
+ * CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE  *
+ * OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                                         *
+ ****************************************************************************************/
+
+
+#include <modules/fieldlinessequence/util/fieldlinesstateloader.h>
+
+#include <ghoul/misc/assert.h>
+#include <algorithm>
+#include <utility>
+
+namespace openspace {
+
+FieldlinesStateLoader::FieldlinesStateLoader(std::vector<std::string> files,
+                                             unsigned int nWorkers, size_t nSlots)
+    : _files(std::move(files))
+    , _slots(nSlots)
+{
+    ghoul_precondition(nWorkers > 0, "At least one worker is required");
+    ghoul_precondition(nSlots > 0, "At least one slot is required");
+
+    for (unsigned int i = 0; i < nWorkers; i++) {
+        _workers.emplace_back([this]() { work(); });
+    }
+}
+
+FieldlinesStateLoader::~FieldlinesStateLoader() {
+    {
+        std::lock_guard lock(_mutex);
+        _isStopping = true;
+    }
+    _condition.notify_all();
+    for (std::thread& worker : _workers) {
+        worker.join();
+    }
+}
+
+void FieldlinesStateLoader::request(const std::vector<int>& indices) {
+    using Status = Slot::Status;
+
+    {
+        std::lock_guard lock(_mutex);
+
+        // Update the priorities of the slots that are still needed and cancel the others
+        for (Slot& slot : _slots) {
+            if (slot.status == Status::Empty) {
+                continue;
+            }
+
+            auto it = std::find(indices.begin(), indices.end(), slot.index);
+            if (it != indices.end()) {
+                slot.priority = static_cast<size_t>(std::distance(indices.begin(), it));
+                slot.isObsolete = false;
+                continue;
+            }
+
+            switch (slot.status) {
+                case Status::Queued:
+                    slot.status = Status::Empty;
+                    slot.index = -1;
+                    _statistics.nCancelled++;
+                    break;
+                case Status::Loading:
+                    // The load cannot be interrupted, but its result is discarded
+                    if (!slot.isObsolete) {
+                        slot.isObsolete = true;
+                        _statistics.nCancelled++;
+                    }
+                    break;
+                case Status::Ready:
+                    slot.status = Status::Empty;
+                    slot.index = -1;
+                    break;
+                case Status::Empty:
+                    break;
+            }
+        }
+
+        // Queue the states that are not loaded yet in the order of their priority
+        const auto now = std::chrono::steady_clock::now();
+        for (size_t i = 0; i < indices.size(); i++) {
+            const int index = indices[i];
+            if (index < 0 || index >= static_cast<int>(_files.size())) {
+                continue;
+            }
+
+            const bool isPresent = std::any_of(
+                _slots.begin(),
+                _slots.end(),
+                [index](const Slot& s) {
+                    return s.status != Status::Empty && s.index == index;
+                }
+            );
+            if (isPresent) {
+                continue;
+            }
+
+            auto empty = std::find_if(
+                _slots.begin(),
+                _slots.end(),
+                [](const Slot& s) { return s.status == Status::Empty; }
+            );
+            if (empty == _slots.end()) {
+                break;
+            }
+            empty->status = Status::Queued;
+            empty->index = index;
+            empty->priority = i;
+            empty->isObsolete = false;
+            empty->requestTime = now;
+        }
+    }
+    _condition.notify_all();
+}
+
+bool FieldlinesStateLoader::swap(int index, FieldlinesState& state, int stateIndex) {
+    using Status = Slot::Status;
+
+    std::lock_guard lock(_mutex);
+    auto slot = std::find_if(
+        _slots.begin(),
+        _slots.end(),
+        [index](const Slot& s) { return s.status == Status::Ready && s.index == index; }
+    );
+    if (slot == _slots.end()) {
+        return false;
+    }
+
+    // Exchanging the states only exchanges the buffers, no data is copied
+    std::swap(*slot->state, state);
+
+    bool isDuplicate = false;
+    for (Slot& s : _slots) {
+        if (&s == &*slot || s.status == Status::Empty || s.index != stateIndex) {
+            continue;
+        }
+        // The state that was returned might have been requested again in the meantime
+        if (s.status == Status::Queued) {
+            s.status = Status::Empty;
+            s.index = -1;
+        }
+        else if (s.status == Status::Loading) {
+            s.isObsolete = true;
+        }
+        else {
+            isDuplicate = true;
+        }
+    }
+
+    if (stateIndex >= 0 && !isDuplicate) {
+        slot->index = stateIndex;
+    }
+    else {
+        slot->status = Status::Empty;
+        slot->index = -1;
+    }
+    return true;
+}
+
+void FieldlinesStateLoader::setCopiedExtraQuantities(std::vector<size_t> indices) {
+    std::lock_guard lock(_mutex);
+    _copiedExtraQuantities = std::move(indices);
+}
+
+FieldlinesStateLoader::Statistics FieldlinesStateLoader::statistics() const {
+    std::lock_guard lock(_mutex);
+    return _statistics;
+}
+
+void FieldlinesStateLoader::work() {
+    using Status = Slot::Status;
+
+    auto isQueued = [](const Slot& s) { return s.status == Status::Queued; };
+
+    while (true) {
+        Slot* slot = nullptr;
+        int index = -1;
+        FieldlinesState* state = nullptr;
+        std::vector<size_t> copiedExtraQuantities;
+        {
+            std::unique_lock lock(_mutex);
+            _condition.wait(lock, [this, &isQueued]() {
+                return _isStopping || std::any_of(_slots.begin(), _slots.end(), isQueued);
+            });
+            if (_isStopping) {
+                return;
+            }
+
+            // Pick the most important of the queued states
+            for (Slot& s : _slots) {
+                if (isQueued(s) && (!slot || s.priority < slot->priority)) {
+                    slot = &s;
+                }
+            }
+            slot->status = Status::Loading;
+            index = slot->index;
+            state = slot->state.get();
+            copiedExtraQuantities = _copiedExtraQuantities;
+        }
+
+        // The slot's state is only exchanged while it is ready, so it is safe to load
+        // into it without holding the lock
+        const bool success = state->loadStateFromOsfls(
+            _files[index],
+            copiedExtraQuantities
+        );
+
+        std::lock_guard lock(_mutex);
+        if (!success || slot->isObsolete) {
+            slot->status = Status::Empty;
+            slot->index = -1;
+            slot->isObsolete = false;
+            continue;
+        }
+
+        slot->status = Status::Ready;
+        const auto latency = std::chrono::duration_cast<std::chrono::microseconds>(
+            std::chrono::steady_clock::now() - slot->requestTime
+        );
+        _statistics.nLoaded++;
+        _totalLatency += latency;
+        _statistics.averageLatency = _totalLatency / _statistics.nLoaded;
+        _statistics.maxLatency = std::max(_statistics.maxLatency, latency);
+    }
+}
+
+} // namespace openspace
@@ -0,0 +1,133 @@
+/*****************************************************************************************
+ *                                                                                       *
+ * OpenSpace                                                                             *
+ *                                                                                       *
+ * Copyright (c) 2014-2023                                                               *
+ *                                                                                       *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this  *
+ * software and associated documentation files (the "Software"), to deal in the Software *
+ * without restriction, including without limitation the rights to use, copy, modify,    *
+ * merge, publish, distribute, sublicense, and/or sell copies of the Software, and to    *
+ * permit persons to whom the Software is furnished to do so, subject to the following   *
+ * conditions:                                                                           *
+ *                                                                                       *
+ * The above copyright notice and this permission notice shall be included in all copies *
+ * or substantial portions of the Software.                                              *
+ *                                                                                       *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,   *
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A         *
+ * PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT    *
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF  *
+ * CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE  *
+ * OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                                         *
+ ****************************************************************************************/
+
+
+#ifndef __OPENSPACE_MODULE_FIELDLINESSEQUENCE___FIELDLINESSTATELOADER___H__
+#define __OPENSPACE_MODULE_FIELDLINESSEQUENCE___FIELDLINESSTATELOADER___H__
+
+#include <modules/fieldlinessequence/util/fieldlinesstate.h>
+#include <chrono>
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace openspace {
+
+/**
+ * Loads .osfls states on a fixed number of worker threads into a fixed number of slots.
+ * The owner requests the states it is going to need with #request and exchanges a
+ * loaded state for the state it currently shows with #swap. The FieldlinesState objects
+ * are never destroyed while the loader lives, so their buffers are reused by the
+ * following loads instead of being reallocated for every state.
+ */
+class FieldlinesStateLoader {
+public:
+    struct Statistics {
+        /// The number of states that have finished loading
+        int nLoaded = 0;
+        /// The number of requested states that were no longer needed before they were
+        /// loaded or before their load finished
+        int nCancelled = 0;
+        /// The average and maximum time between requesting a state and it being loaded
+        std::chrono::microseconds averageLatency = std::chrono::microseconds(0);
+        std::chrono::microseconds maxLatency = std::chrono::microseconds(0);
+    };
+
+    /**
+     * Creates a loader for the states stored in the \p files.
+     *
+     * \param files The paths to the .osfls files of all states
+     * \param nWorkers The number of threads that load states
+     * \param nSlots The maximum number of states that are kept loaded
+     *
+     * \pre \p nWorkers must be positive
+     * \pre \p nSlots must be positive
+     */
+    FieldlinesStateLoader(std::vector<std::string> files, unsigned int nWorkers,
+        size_t nSlots);
+
+    /**
+     * Stops the worker threads. Loads that have already started are finished first.
+     */
+    ~FieldlinesStateLoader();
+
+    /**
+     * Requests that the states with the provided \p indices are loaded, with the first
+     * index having the highest priority. Loaded states and loads that are not in the
+     * list are cancelled and their slots are reused. If there are more indices than
+     * slots, the indices with the lowest priority are ignored.
+     */
+    void request(const std::vector<int>& indices);
+
+    /**
+     * If the state with the index \p index has been loaded, it is exchanged with
+     * \p state and `true` is returned. The slot then holds the previous content of
+     * \p state as the state with index \p stateIndex, or as an unused buffer if
+     * \p stateIndex is -1. Otherwise, \p state is not changed and `false` is returned.
+     */
+    bool swap(int index, FieldlinesState& state, int stateIndex);
+
+    /**
+     * Sets the extra quantities that are copied out of the files while loading, which
+     * should be the quantities that are rendered, so that their values are read from disk
+     * on the worker threads. Loads that have already started are not affected.
+     */
+    void setCopiedExtraQuantities(std::vector<size_t> indices);
+
+    Statistics statistics() const;
+
+private:
+    struct Slot {
+        enum class Status { Empty, Queued, Loading, Ready };
+
+        Status status = Status::Empty;
+        int index = -1;
+        // The position of the index in the last request, lower is more important
+        size_t priority = 0;
+        // Set when a running load is no longer needed
+        bool isObsolete = false;
+        std::chrono::steady_clock::time_point requestTime;
+        std::unique_ptr<FieldlinesState> state = std::make_unique<FieldlinesState>();
+    };
+
+    void work();
+
+    const std::vector<std::string> _files;
+    std::vector<size_t> _copiedExtraQuantities;
+    std::vector<Slot> _slots;
+    Statistics _statistics;
+    std::chrono::microseconds _totalLatency = std::chrono::microseconds(0);
+
+    mutable std::mutex _mutex;
+    std::condition_variable _condition;
+    bool _isStopping = false;
+    std::vector<std::thread> _workers;
+};
+
+} // namespace openspace
+
+#endif // __OPENSPACE_MODULE_FIELDLINESSEQUENCE___FIELDLINESSTATELOADER___H__
@@ -33,11 +33,11 @@
 #include <openspace/rendering/renderable.h>
 #include <openspace/rendering/renderengine.h>
 #include <openspace/util/boxgeometry.h>
+#include <openspace/util/cachefiles.h>
 #include <openspace/util/distanceconstants.h>
 #include <openspace/util/updatestructures.h>
 #include <ghoul/fmt.h>
 #include <ghoul/glm.h>
-#include <ghoul/filesystem/cachemanager.h>
 #include <ghoul/filesystem/filesystem.h>
 #include <ghoul/io/texture/texturereader.h>
 #include <ghoul/logging/logmanager.h>
@@ -351,7 +351,7 @@ void RenderableGalaxy::initialize() {
     );
     _volume = reader.read();
 
-    std::filesystem::path cachedPointsFile = FileSys.cacheManager()->cachedFilename(
+    std::filesystem::path cachedPointsFile = cachedFilename(
         _pointsFilename
     );
     const bool hasCachedFile = std::filesystem::is_regular_file(cachedPointsFile);
@@ -366,7 +366,7 @@ void RenderableGalaxy::initialize() {
             _pointColorsCache = std::move(res.color);
         }
         else {
-            FileSys.cacheManager()->removeCacheFile(_pointsFilename);
+            removeCacheFile(_pointsFilename);
             Result resPoint = loadPointFile();
             _pointPositionsCache = std::move(resPoint.positions);
             _pointColorsCache = std::move(resPoint.color);
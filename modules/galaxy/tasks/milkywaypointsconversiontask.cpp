@@ -44,6 +44,11 @@ std::string MilkywayPointsConversionTask::description() {
     return std::string();
 }
 
+bool MilkywayPointsConversionTask::isThreadSafe() const {
+    // Only reads and writes the files that are specified in the task
+    return true;
+}
+
 void MilkywayPointsConversionTask::perform(const Task::ProgressCallback& progressCallback)
 {
     std::ifstream in(_inFilename, std::ios::in);
@@ -46,6 +46,7 @@ public:
 
     std::string description() override;
     void perform(const Task::ProgressCallback& progressCallback) override;
+    bool isThreadSafe() const override;
 
     static documentation::Documentation Documentation();
 
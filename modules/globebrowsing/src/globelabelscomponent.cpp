@@ -32,8 +32,8 @@
 #include <openspace/engine/globals.h>
 #include <openspace/engine/moduleengine.h>
 #include <openspace/engine/windowdelegate.h>
+#include <openspace/util/cachefiles.h>
 #include <openspace/util/updatestructures.h>
-#include <ghoul/filesystem/cachemanager.h>
 #include <ghoul/filesystem/filesystem.h>
 #include <ghoul/font/fontmanager.h>
 #include <ghoul/font/fontrenderer.h>
@@ -42,6 +42,7 @@
 #include <ghoul/misc/profiling.h>
 #include <ghoul/opengl/programobject.h>
 #include <cstdlib>
+#include <cstring>
 #include <filesystem>
 #include <fstream>
 #include <locale>
@@ -154,6 +155,24 @@ namespace {
         openspace::properties::Property::Visibility::User
     };
 
+    constexpr openspace::properties::Property::PropertyInfo HideOverlappingInfo = {
+        "HideOverlapping",
+        "Hide Overlapping",
+        "If enabled, labels that would overlap another label on screen are not rendered. "
+        "Labels of features with a larger diameter are preferred over smaller ones. The "
+        "size of a label on screen is estimated from its text and the label size",
+        openspace::properties::Property::Visibility::User
+    };
+
+    constexpr openspace::properties::Property::PropertyInfo MaxLabelsInfo = {
+        "MaxLabels",
+        "Max Number of Labels",
+        "The maximum number of labels that are rendered at the same time, preferring the "
+        "labels of features with a larger diameter. If this value is 0, the number of "
+        "labels is not limited",
+        openspace::properties::Property::Visibility::AdvancedUser
+    };
+
     struct [[codegen::Dictionary(GlobeLabelsComponent)]] Parameters {
         // The path to the labels file
         std::optional<std::filesystem::path> fileName;
@@ -200,6 +219,12 @@ namespace {
         };
         // [[codegen::verbatim(AlignmentOptionInfo.description)]]
         std::optional<Alignment> alignmentOption;
+
+        // [[codegen::verbatim(HideOverlappingInfo.description)]]
+        std::optional<bool> hideOverlapping;
+
+        // [[codegen::verbatim(MaxLabelsInfo.description)]]
+        std::optional<int> maxLabels [[codegen::greaterequal(0)]];
     };
 #include "globelabelscomponent_codegen.cpp"
 } // namespace
@@ -232,6 +257,8 @@ GlobeLabelsComponent::GlobeLabelsComponent()
         AlignmentOptionInfo,
         properties::OptionProperty::DisplayType::Dropdown
     )
+    , _hideOverlapping(HideOverlappingInfo, false)
+    , _maxLabels(MaxLabelsInfo, 0, 0, 100000)
 {
     addProperty(_enabled);
     addProperty(_color);
@@ -257,6 +284,9 @@ GlobeLabelsComponent::GlobeLabelsComponent()
     _alignmentOption.addOption(Circularly, "Circularly");
     _alignmentOption = Horizontally;
     addProperty(_alignmentOption);
+
+    addProperty(_hideOverlapping);
+    addProperty(_maxLabels);
 }
 
 void GlobeLabelsComponent::initialize(const ghoul::Dictionary& dictionary,
@@ -299,6 +329,10 @@ void GlobeLabelsComponent::initialize(const ghoul::Dictionary& dictionary,
     if (p.alignmentOption.has_value()) {
         _alignmentOption = codegen::map<LabelRenderingAlignmentType>(*p.alignmentOption);
     }
+    _hideOverlapping = p.hideOverlapping.value_or(_hideOverlapping);
+    _maxLabels = p.maxLabels.value_or(_maxLabels);
+
+    updateLayout();
 
     initializeFonts();
 }
@@ -313,7 +347,7 @@ void GlobeLabelsComponent::initializeFonts() {
 }
 
 bool GlobeLabelsComponent::loadLabelsData(const std::filesystem::path& file) {
-    std::filesystem::path cachedFile = FileSys.cacheManager()->cachedFilename(
+    std::filesystem::path cachedFile = cachedFilename(
         file,
         "GlobeLabelsComponent|" + identifier()
     );
@@ -327,7 +361,7 @@ bool GlobeLabelsComponent::loadLabelsData(const std::filesystem::path& file) {
             return true;
         }
         else {
-            FileSys.cacheManager()->removeCacheFile(file);
+            removeCacheFile(file);
             // Intentional fall-through to the 'else' to generate the cache
             // file for the next run
         }
@@ -490,6 +524,19 @@ bool GlobeLabelsComponent::saveCachedFile(const std::filesystem::path& file) con
     return fileStream.good();
 }
 
+void GlobeLabelsComponent::updateLayout() {
+    std::vector<LabelLayout::Label> labels;
+    labels.reserve(_labels.labelsArray.size());
+    for (const LabelEntry& entry : _labels.labelsArray) {
+        labels.push_back({
+            .position = glm::dvec3(entry.geoPosition),
+            .priority = entry.diameter,
+            .textLength = static_cast<int>(std::strlen(entry.feature))
+        });
+    }
+    _layout.setLabels(std::move(labels));
+}
+
 void GlobeLabelsComponent::draw(const RenderData& data) {
     if (!_enabled) {
         return;
@@ -551,9 +598,6 @@ void GlobeLabelsComponent::renderLabels(const RenderData& data,
         opacity() * fadeInVariable
     );
 
-    glm::dmat4 VP = glm::dmat4(data.camera.sgctInternal.projectionMatrix()) *
-                    data.camera.combinedViewMatrix();
-
     glm::dmat4 invModelMatrix = glm::inverse(_globe->modelTransform());
 
     glm::dvec3 cameraViewDirectionObj = glm::dvec3(
@@ -575,141 +619,84 @@ void GlobeLabelsComponent::renderLabels(const RenderData& data,
     }
     glm::dvec3 orthoUp = glm::normalize(glm::cross(orthoRight, cameraViewDirectionObj));
 
-    for (const LabelEntry& lEntry : _labels.labelsArray) {
+    glm::dvec3 cameraPositionObj = glm::dvec3(
+        invModelMatrix * glm::dvec4(data.camera.positionVec3(), 1.0)
+    );
+
+    ghoul::fontrendering::FontRenderer::ProjectedLabelsInformation labelInfo;
+    labelInfo.orthoRight = orthoRight;
+    labelInfo.orthoUp = orthoUp;
+    labelInfo.minSize = _minMaxSize.value().x;
+    labelInfo.maxSize = _minMaxSize.value().y;
+    labelInfo.cameraPos = data.camera.positionVec3();
+    labelInfo.cameraLookUp = data.camera.lookUpVectorWorldSpace();
+    labelInfo.renderType = 0;
+    labelInfo.mvpMatrix = modelViewProjectionMatrix;
+    labelInfo.scale = powf(2.f, _size);
+    labelInfo.enableDepth = true;
+    labelInfo.enableFalseDepth = true;
+    labelInfo.disableTransmittance = true;
+
+    // Testing
+    glm::dmat4 modelviewTransform = glm::dmat4(data.camera.combinedViewMatrix()) *
+                                    _globe->modelTransform();
+    labelInfo.modelViewMatrix = modelviewTransform;
+    labelInfo.projectionMatrix = glm::dmat4(
+        data.camera.sgctInternal.projectionMatrix()
+    );
+
+    LabelLayout::Settings settings;
+    settings.modelViewProjection = modelViewProjectionMatrix;
+    settings.viewportSize = global::windowDelegate->currentDrawBufferResolution();
+    settings.frustumCulling = !_disableCulling;
+    if (!_disableCulling) {
+        // Only labels that are closer to the camera than the center of the globe are
+        // rendered, which removes most labels on the far side of the globe. The distance
+        // is measured in world space, but the labels are in model space
+        const double scale = glm::length(glm::dvec3(_globe->modelTransform()[0]));
+        settings.cameraPosition = cameraPositionObj;
+        settings.maxDistance = (distToCamera - _distanceEPS) / scale;
+    }
+    settings.cullOverlapping = _hideOverlapping;
+    settings.maxLabels = _maxLabels;
+    settings.textUp = orthoUp;
+    settings.textHeight = labelInfo.scale * _fontSize.value();
+    settings.minMaxTextHeight = glm::vec2(_minMaxSize.value());
+
+    for (size_t i : _layout.layout(settings)) {
+        const LabelEntry& lEntry = _labels.labelsArray[i];
         glm::vec3 position = lEntry.geoPosition;
-        glm::dvec3 locationPositionWorld =
-            glm::dvec3(_globe->modelTransform() * glm::dvec4(position, 1.0));
-        double distanceCameraToLabelWorld =
-            glm::length(locationPositionWorld - data.camera.positionVec3());
-
-        if (_disableCulling ||
-            ((distToCamera > (distanceCameraToLabelWorld + _distanceEPS)) &&
-            isLabelInFrustum(VP, locationPositionWorld)))
-        {
-            if (_alignmentOption == Circularly) {
-                glm::dvec3 labelNormalObj = glm::dvec3(
-                    invModelMatrix * glm::dvec4(data.camera.positionVec3(), 1.0)
-                ) - glm::dvec3(position);
-
-                glm::dvec3 labelUpDirectionObj = glm::dvec3(position);
-
-                orthoRight = glm::normalize(
-                    glm::cross(labelUpDirectionObj, labelNormalObj)
+
+        if (_alignmentOption == Circularly) {
+            glm::dvec3 labelNormalObj = cameraPositionObj - glm::dvec3(position);
+            glm::dvec3 labelUpDirectionObj = glm::dvec3(position);
+
+            orthoRight = glm::normalize(glm::cross(labelUpDirectionObj, labelNormalObj));
+            if (orthoRight == glm::dvec3(0.0)) {
+                glm::dvec3 otherVector(
+                    labelUpDirectionObj.y,
+                    labelUpDirectionObj.x,
+                    labelUpDirectionObj.z
                 );
-                if (orthoRight == glm::dvec3(0.0)) {
-                    glm::dvec3 otherVector(
-                        labelUpDirectionObj.y,
-                        labelUpDirectionObj.x,
-                        labelUpDirectionObj.z
-                    );
-                    orthoRight = glm::normalize(glm::cross(otherVector, labelNormalObj));
-                }
-                orthoUp = glm::normalize(glm::cross(labelNormalObj, orthoRight));
+                orthoRight = glm::normalize(glm::cross(otherVector, labelNormalObj));
             }
+            orthoUp = glm::normalize(glm::cross(labelNormalObj, orthoRight));
 
-            // Move the position along the normal. Note that position is in model space
-            position += _heightOffset.value() * glm::normalize(position);
-
-            ghoul::fontrendering::FontRenderer::ProjectedLabelsInformation labelInfo;
             labelInfo.orthoRight = orthoRight;
             labelInfo.orthoUp = orthoUp;
-            labelInfo.minSize = _minMaxSize.value().x;
-            labelInfo.maxSize = _minMaxSize.value().y;
-            labelInfo.cameraPos = data.camera.positionVec3();
-            labelInfo.cameraLookUp = data.camera.lookUpVectorWorldSpace();
-            labelInfo.renderType = 0;
-            labelInfo.mvpMatrix = modelViewProjectionMatrix;
-            labelInfo.scale = powf(2.f, _size);
-            labelInfo.enableDepth = true;
-            labelInfo.enableFalseDepth = true;
-            labelInfo.disableTransmittance = true;
-
-            // Testing
-            glm::dmat4 modelviewTransform = glm::dmat4(data.camera.combinedViewMatrix()) *
-                                            _globe->modelTransform();
-            labelInfo.modelViewMatrix = modelviewTransform;
-            labelInfo.projectionMatrix = glm::dmat4(
-                data.camera.sgctInternal.projectionMatrix()
-            );
-
-            ghoul::fontrendering::FontRenderer::defaultProjectionRenderer().render(
-                *_font,
-                position,
-                lEntry.feature,
-                textColor,
-                labelInfo
-            );
         }
-    }
-}
 
-bool GlobeLabelsComponent::isLabelInFrustum(const glm::dmat4& MVMatrix,
-                                            const glm::dvec3& position) const
-{
-    // Frustum Planes
-    glm::dvec3 col1(MVMatrix[0][0], MVMatrix[1][0], MVMatrix[2][0]);
-    glm::dvec3 col2(MVMatrix[0][1], MVMatrix[1][1], MVMatrix[2][1]);
-    glm::dvec3 col3(MVMatrix[0][2], MVMatrix[1][2], MVMatrix[2][2]);
-    glm::dvec3 col4(MVMatrix[0][3], MVMatrix[1][3], MVMatrix[2][3]);
-
-    glm::dvec3 leftNormal = col4 + col1;
-    glm::dvec3 rightNormal = col4 - col1;
-    glm::dvec3 bottomNormal = col4 + col2;
-    glm::dvec3 topNormal = col4 - col2;
-    glm::dvec3 nearNormal = col3 + col4;
-    glm::dvec3 farNormal = col4 - col3;
-
-    // Plane Distances
-    double leftDistance = MVMatrix[3][3] + MVMatrix[3][0];
-    double rightDistance = MVMatrix[3][3] - MVMatrix[3][0];
-    double bottomDistance = MVMatrix[3][3] + MVMatrix[3][1];
-    double topDistance = MVMatrix[3][3] - MVMatrix[3][1];
-    double nearDistance = MVMatrix[3][3] + MVMatrix[3][2];
-    // double farDistance = MVMatrix[3][3] - MVMatrix[3][2];
-
-    // Normalize Planes
-    const double invMagLeft = 1.0 / glm::length(leftNormal);
-    leftNormal *= invMagLeft;
-    leftDistance *= invMagLeft;
-
-    const double invMagRight = 1.0 / glm::length(rightNormal);
-    rightNormal *= invMagRight;
-    rightDistance *= invMagRight;
-
-    const double invMagBottom = 1.0 / glm::length(bottomNormal);
-    bottomNormal *= invMagBottom;
-    bottomDistance *= invMagBottom;
-
-    const double invMagTop = 1.0 / glm::length(topNormal);
-    topNormal *= invMagTop;
-    topDistance *= invMagTop;
-
-    const double invMagNear = 1.0 / glm::length(nearNormal);
-    nearNormal *= invMagNear;
-    nearDistance *= invMagNear;
-
-    const double invMagFar = 1.0 / glm::length(farNormal);
-    farNormal *= invMagFar;
-    // farDistance *= invMagFar;
-
-    constexpr float Radius = 1.0;
-    if ((glm::dot(leftNormal, position) + leftDistance) < -Radius) {
-        return false;
-    }
-    else if ((glm::dot(rightNormal, position) + rightDistance) < -Radius) {
-        return false;
-    }
-    else if ((glm::dot(bottomNormal, position) + bottomDistance) < -Radius) {
-        return false;
-    }
-    else if ((glm::dot(topNormal, position) + topDistance) < -Radius) {
-        return false;
-    }
-    else if ((glm::dot(nearNormal, position) + nearDistance) < -Radius) {
-        return false;
-    }
+        // Move the position along the normal. Note that position is in model space
+        position += _heightOffset.value() * glm::normalize(position);
 
-    return true;
+        ghoul::fontrendering::FontRenderer::defaultProjectionRenderer().render(
+            *_font,
+            position,
+            lEntry.feature,
+            textColor,
+            labelInfo
+        );
+    }
 }
 
 } // namespace openspace
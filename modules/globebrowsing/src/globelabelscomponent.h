@@ -35,6 +35,7 @@
 #include <openspace/properties/vector/ivec2property.h>
 #include <openspace/properties/vector/vec2property.h>
 #include <openspace/properties/vector/vec3property.h>
+#include <openspace/rendering/labellayout.h>
 #include <ghoul/font/fontrenderer.h>
 #include <ghoul/glm.h>
 
@@ -67,9 +68,9 @@ private:
     bool readLabelsFile(const std::filesystem::path& file);
     bool loadCachedFile(const std::filesystem::path& file);
     bool saveCachedFile(const std::filesystem::path& file) const;
+    void updateLayout();
     void renderLabels(const RenderData& data, const glm::dmat4& modelViewProjectionMatrix,
         float distToCamera, float fadeInVariable);
-    bool isLabelInFrustum(const glm::dmat4& MVMatrix, const glm::dvec3& position) const;
 
     // Labels Structures
     struct LabelEntry {
@@ -97,8 +98,11 @@ private:
     properties::BoolProperty _disableCulling;
     properties::FloatProperty _distanceEPS;
     properties::OptionProperty _alignmentOption;
+    properties::BoolProperty _hideOverlapping;
+    properties::IntProperty _maxLabels;
 
     Labels _labels;
+    LabelLayout _layout;
 
     // Font
     std::shared_ptr<ghoul::fontrendering::Font> _font;
@@ -37,7 +37,7 @@
 #include <openspace/rendering/renderengine.h>
 #include <openspace/scene/scene.h>
 #include <openspace/scripting/scriptengine.h>
-#include <ghoul/filesystem/cachemanager.h>
+#include <openspace/util/cachefiles.h>
 #include <ghoul/filesystem/filesystem.h>
 #include <ghoul/opengl/textureunit.h>
 
@@ -280,7 +280,7 @@ void ImGUIModule::internalDeinitialize() {
 }
 
 void ImGUIModule::internalInitializeGL() {
-    std::filesystem::path file = FileSys.cacheManager()->cachedFilename("imgui.ini", "");
+    std::filesystem::path file = cachedFilename("imgui.ini", "");
     LDEBUG(fmt::format("Using {} as ImGUI cache location", file));
 
     _iniFileBuffer.resize(file.string().size() + 1);
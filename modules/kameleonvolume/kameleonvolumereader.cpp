@@ -30,8 +30,13 @@
 #include <ghoul/filesystem/file.h>
 #include <ghoul/filesystem/filesystem.h>
 #include <ghoul/logging/logmanager.h>
+#include <ghoul/misc/assert.h>
 #include <ghoul/misc/dictionary.h>
+#include <atomic>
+#include <exception>
 #include <filesystem>
+#include <mutex>
+#include <thread>
 
 #ifdef WIN32
 #pragma warning (push)
@@ -76,7 +81,10 @@ namespace {
 
 namespace openspace::kameleonvolume {
 
-KameleonVolumeReader::KameleonVolumeReader(std::string path) : _path(std::move(path)) {
+KameleonVolumeReader::KameleonVolumeReader(std::string path)
+    : _path(std::move(path))
+    , _kameleon(std::make_unique<ccmc::Kameleon>())
+{
     if (!std::filesystem::is_regular_file(_path)) {
         throw ghoul::FileNotFoundError(_path);
     }
@@ -86,11 +94,6 @@ KameleonVolumeReader::KameleonVolumeReader(std::string path) : _path(std::move(p
         LERROR(fmt::format("Failed to open file '{}' with Kameleon", _path));
         throw ghoul::RuntimeError("Failed to open file: " + _path + " with Kameleon");
     }
-
-    // Possibly use a kameleon interpolator instead of a model interpolator?
-    _interpolator = std::unique_ptr<ccmc::Interpolator>(
-        _kameleon->model->createNewInterpolator()
-    );
 }
 
 KameleonVolumeReader::~KameleonVolumeReader() {}
@@ -120,31 +123,109 @@ std::unique_ptr<volume::RawVolume<float>> KameleonVolumeReader::readFloatVolume(
                                                                           float& minValue,
                                                                     float& maxValue) const
 {
-    minValue = std::numeric_limits<float>::max();
-    maxValue = -std::numeric_limits<float>::max();
+    std::vector<FloatVolume> volumes = readFloatVolumes(
+        dimensions,
+        { variable },
+        lowerBound,
+        upperBound,
+        std::max(std::thread::hardware_concurrency(), 1u)
+    );
+    minValue = volumes.front().minValue;
+    maxValue = volumes.front().maxValue;
+    return std::move(volumes.front().volume);
+}
 
-    auto volume = std::make_unique<volume::RawVolume<float>>(dimensions);
+std::vector<KameleonVolumeReader::FloatVolume> KameleonVolumeReader::readFloatVolumes(
+                                                            const glm::uvec3& dimensions,
+                                               const std::vector<std::string>& variables,
+                                                              const glm::vec3& lowerBound,
+                                                              const glm::vec3& upperBound,
+                                                              unsigned int nThreads) const
+{
+    ghoul_precondition(nThreads > 0, "At least one thread is required");
 
-    const glm::vec3 dims = volume->dimensions();
-    const glm::vec3 diff = upperBound - lowerBound;
+    // The variables are loaded up front as the interpolators are not allowed to load
+    // them concurrently
+    for (const std::string& variable : variables) {
+        _kameleon->loadVariable(variable);
+    }
 
-    auto interpolate = [this](const std::string& var, const glm::vec3& coords) {
-        return _interpolator->interpolate(var, coords[0], coords[1], coords[2]);
-    };
+    std::vector<FloatVolume> volumes(variables.size());
+    for (FloatVolume& v : volumes) {
+        v.volume = std::make_unique<volume::RawVolume<float>>(dimensions);
+        v.minValue = std::numeric_limits<float>::max();
+        v.maxValue = -std::numeric_limits<float>::max();
+    }
+
+    const unsigned int nSlabs = dimensions.z;
+    nThreads = std::max(std::min(nThreads, nSlabs), 1u);
+
+    // Each interpolator caches the cell of the last lookup, so they cannot be shared
+    std::vector<std::unique_ptr<ccmc::Interpolator>> interpolators;
+    for (unsigned int i = 0; i < nThreads; i++) {
+        interpolators.emplace_back(_kameleon->model->createNewInterpolator());
+    }
 
-    float* data = volume->data();
-    for (size_t index = 0; index < volume->nCells(); ++index) {
-        const glm::vec3 coords = volume->indexToCoords(index);
-        const glm::vec3 coordsZeroToOne = coords / dims;
-        const glm::vec3 volumeCoords = lowerBound + diff * coordsZeroToOne;
+    const glm::vec3 dims = glm::vec3(dimensions);
+    const glm::vec3 diff = upperBound - lowerBound;
+    const size_t slabSize = static_cast<size_t>(dimensions.x) * dimensions.y;
+
+    std::atomic<unsigned int> nextSlab = 0;
+    std::mutex mutex;
+    std::exception_ptr exception;
+    auto sampleSlabs = [&](ccmc::Interpolator& interpolator) {
+        constexpr float Max = std::numeric_limits<float>::max();
+        std::vector<glm::vec2> ranges(variables.size(), glm::vec2(Max, -Max));
+
+        try {
+            for (unsigned int z = nextSlab++; z < nSlabs; z = nextSlab++) {
+                const float zc = lowerBound.z + diff.z * (static_cast<float>(z) / dims.z);
+                for (unsigned int y = 0; y < dimensions.y; y++) {
+                    const float yc =
+                        lowerBound.y + diff.y * (static_cast<float>(y) / dims.y);
+                    const size_t row =
+                        z * slabSize + static_cast<size_t>(y) * dimensions.x;
+                    for (unsigned int x = 0; x < dimensions.x; x++) {
+                        const float xc =
+                            lowerBound.x + diff.x * (static_cast<float>(x) / dims.x);
+                        for (size_t v = 0; v < variables.size(); v++) {
+                            const float value =
+                                interpolator.interpolate(variables[v], xc, yc, zc);
+                            volumes[v].volume->data()[row + x] = value;
+                            ranges[v].x = std::min(ranges[v].x, value);
+                            ranges[v].y = std::max(ranges[v].y, value);
+                        }
+                    }
+                }
+            }
+        }
+        catch (...) {
+            std::lock_guard lock(mutex);
+            exception = std::current_exception();
+            // Prevent the other threads from starting new slabs
+            nextSlab = nSlabs;
+        }
 
-        data[index] = interpolate(variable, volumeCoords);
+        std::lock_guard lock(mutex);
+        for (size_t v = 0; v < variables.size(); v++) {
+            volumes[v].minValue = std::min(volumes[v].minValue, ranges[v].x);
+            volumes[v].maxValue = std::max(volumes[v].maxValue, ranges[v].y);
+        }
+    };
 
-        minValue = glm::min(minValue, data[index]);
-        maxValue = glm::max(maxValue, data[index]);
+    std::vector<std::thread> threads;
+    for (unsigned int i = 1; i < nThreads; i++) {
+        threads.emplace_back(sampleSlabs, std::ref(*interpolators[i]));
+    }
+    sampleSlabs(*interpolators[0]);
+    for (std::thread& thread : threads) {
+        thread.join();
     }
 
-    return volume;
+    if (exception) {
+        std::rethrow_exception(exception);
+    }
+    return volumes;
 }
 
 std::vector<std::string> KameleonVolumeReader::variableNames() const {
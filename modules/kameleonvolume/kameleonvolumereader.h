@@ -43,6 +43,12 @@ namespace openspace::kameleonvolume {
 
 class KameleonVolumeReader {
 public:
+    struct FloatVolume {
+        std::unique_ptr<volume::RawVolume<float>> volume;
+        float minValue = 0.f;
+        float maxValue = 0.f;
+    };
+
     KameleonVolumeReader(std::string path);
     ~KameleonVolumeReader();
 
@@ -55,6 +61,25 @@ public:
         const glm::vec3& lowerBound, const glm::vec3& upperBound, float& minValue,
         float& maxValue) const;
 
+    /**
+     * Samples all of the \p variables on a regular grid with the provided \p dimensions
+     * that spans from \p lowerBound to \p upperBound in a single pass. The grid is split
+     * into slabs along the z axis that are sampled concurrently by up to \p nThreads
+     * threads, each of which is using its own interpolator.
+     *
+     * \param dimensions The number of voxels in each dimension
+     * \param variables The names of the variables that are sampled
+     * \param lowerBound The lower bound of the domain in the native grid units
+     * \param upperBound The upper bound of the domain in the native grid units
+     * \param nThreads The maximum number of threads that are used to sample the volume
+     * \return One volume for each of the \p variables, in the same order, together with
+     *         the smallest and largest sampled value
+     * \pre \p nThreads must be positive
+     */
+    std::vector<FloatVolume> readFloatVolumes(const glm::uvec3& dimensions,
+        const std::vector<std::string>& variables, const glm::vec3& lowerBound,
+        const glm::vec3& upperBound, unsigned int nThreads) const;
+
     ghoul::Dictionary readMetaData() const;
 
     std::string time() const;
@@ -77,7 +102,6 @@ private:
 
     std::string _path;
     std::unique_ptr<ccmc::Kameleon> _kameleon;
-    std::unique_ptr<ccmc::Interpolator> _interpolator;
 };
 
 } // namespace openspace::kameleonvolume
@@ -39,8 +39,8 @@
 #include <openspace/engine/globals.h>
 #include <openspace/rendering/renderengine.h>
 #include <openspace/rendering/raycastermanager.h>
+#include <openspace/util/cachefiles.h>
 #include <openspace/util/updatestructures.h>
-#include <ghoul/filesystem/cachemanager.h>
 #include <ghoul/filesystem/file.h>
 #include <ghoul/filesystem/filesystem.h>
 #include <ghoul/logging/logmanager.h>
@@ -346,7 +346,7 @@ void RenderableKameleonVolume::load() {
         loadFromPath(_sourcePath);
         return;
     }
-    std::filesystem::path cachePath = FileSys.cacheManager()->cachedFilename(
+    std::filesystem::path cachePath = cachedFilename(
         std::filesystem::path(_sourcePath.value()).stem(),
         cacheSuffix()
     );
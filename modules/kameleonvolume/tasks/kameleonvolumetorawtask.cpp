@@ -22,31 +22,62 @@
  * OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                                         *
  ****************************************************************************************/
 
+
 #include <modules/kameleonvolume/tasks/kameleonvolumetorawtask.h>
 
 #include <modules/kameleonvolume/kameleonvolumereader.h>
+#include <modules/volume/rawvolume.h>
 #include <modules/volume/rawvolumewriter.h>
 #include <openspace/documentation/verifier.h>
 #include <ghoul/fmt.h>
 #include <ghoul/filesystem/filesystem.h>
+#include <ghoul/logging/logmanager.h>
 #include <ghoul/misc/dictionaryluaformatter.h>
+#include <ghoul/misc/exception.h>
+#include <algorithm>
 #include <array>
+#include <chrono>
 #include <filesystem>
+#include <fstream>
 #include <optional>
+#include <set>
+#include <thread>
 
 namespace {
-    struct [[codegen::Dictionary(KameleonVolumeToRawTask)]] Parameters {
-        // The cdf file to extract data from
-        std::filesystem::path input;
+    constexpr std::string_view _loggerCat = "KameleonVolumeToRawTask";
 
-        // The raw volume file to export data to
+    // The placeholders in the output paths that are replaced by the variable name and by
+    // the name of the input file
+    constexpr std::string_view VariableToken = "{variable}";
+    constexpr std::string_view FileToken = "{file}";
+
+    struct [[codegen::Dictionary(KameleonVolumeToRawTask)]] Parameters {
+        // The cdf file to extract data from. Either this value or 'InputFolder' has to be
+        // specified
+        std::optional<std::filesystem::path> input;
+
+        // A folder containing a time series of cdf files. Every cdf file in this folder
+        // is converted, in alphabetical order. The output paths have to contain the
+        // placeholder '{file}', which is replaced by the name of each cdf file
+        std::optional<std::filesystem::path> inputFolder [[codegen::directory()]];
+
+        // The raw volume file to export data to. If more than one variable is extracted,
+        // the path has to contain the placeholder '{variable}', which is replaced by the
+        // name of the variable
         std::string rawVolumeOutput [[codegen::annotation("A valid filepath")]];
 
-        // The Lua dictionary file to export metadata to
+        // The Lua dictionary file to export metadata to. The same placeholders as for the
+        // 'RawVolumeOutput' have to be used
         std::string dictionaryOutput [[codegen::annotation("A valid filepath")]];
 
         // The variable name to read from the kameleon dataset
-        std::string variable [[codegen::annotation("A valid kameleon variable")]];
+        std::optional<std::string> variable
+            [[codegen::annotation("A valid kameleon variable")]];
+
+        // A list of variable names that are all read from the kameleon dataset in the
+        // same pass over the volume. This value is used in addition to 'Variable'
+        std::optional<std::vector<std::string>> variables
+            [[codegen::annotation("A list of valid kameleon variables")]];
 
         // A vector representing the number of cells in each dimension
         glm::ivec3 dimensions;
@@ -62,8 +93,41 @@ namespace {
         // The unit of the data
         std::optional<std::string> visUnit
             [[codegen::annotation("A valid kameleon unit")]];
+
+        // The number of threads that are used to sample the volume. If this value is not
+        // specified, one thread per core is used
+        std::optional<int> threads [[codegen::greater(0)]];
+
+        // A file in which each converted cdf file is recorded. If the conversion of a
+        // time series is interrupted, the files that are listed in this file are skipped
+        // when the task is performed again, provided that their output files still exist
+        std::optional<std::string> checkpoint;
     };
 #include "kameleonvolumetorawtask_codegen.cpp"
+
+    std::string replaceAll(std::string s, std::string_view token,
+                           const std::string& value)
+    {
+        size_t pos = s.find(token);
+        while (pos != std::string::npos) {
+            s.replace(pos, token.size(), value);
+            pos = s.find(token, pos + value.size());
+        }
+        return s;
+    }
+
+    // Writes the file through a temporary file so that an interrupted conversion never
+    // leaves a partial output file behind
+    template <typename Func>
+    void writeAtomically(const std::filesystem::path& path, Func write) {
+        if (path.has_parent_path()) {
+            std::filesystem::create_directories(path.parent_path());
+        }
+        std::filesystem::path tmp = path;
+        tmp += ".tmp";
+        write(tmp);
+        std::filesystem::rename(tmp, path);
+    }
 } // namespace
 
 namespace openspace::kameleonvolume {
@@ -75,10 +139,22 @@ documentation::Documentation KameleonVolumeToRawTask::documentation() {
 KameleonVolumeToRawTask::KameleonVolumeToRawTask(const ghoul::Dictionary& dictionary) {
     const Parameters p = codegen::bake<Parameters>(dictionary);
 
-    _inputPath = absPath(p.input.string());
-    _rawVolumeOutputPath = absPath(p.rawVolumeOutput);
-    _dictionaryOutputPath = absPath(p.dictionaryOutput);
-    _variable = p.variable;
+    if (p.input.has_value()) {
+        _inputPath = absPath(p.input->string());
+    }
+    if (p.inputFolder.has_value()) {
+        _inputFolder = absPath(p.inputFolder->string());
+    }
+
+    _rawVolumeOutputPath = absPath(p.rawVolumeOutput).string();
+    _dictionaryOutputPath = absPath(p.dictionaryOutput).string();
+
+    if (p.variable.has_value()) {
+        _variables.push_back(*p.variable);
+    }
+    if (p.variables.has_value()) {
+        _variables.insert(_variables.end(), p.variables->begin(), p.variables->end());
+    }
     _dimensions = p.dimensions;
 
     if (p.lowerDomainBound.has_value()) {
@@ -94,51 +170,169 @@ KameleonVolumeToRawTask::KameleonVolumeToRawTask(const ghoul::Dictionary& dictio
     else {
         _autoDomainBounds = true;
     }
+
+    _nThreads = static_cast<unsigned int>(
+        p.threads.value_or(std::max(std::thread::hardware_concurrency(), 1u))
+    );
+    if (p.checkpoint.has_value()) {
+        _checkpointPath = absPath(*p.checkpoint);
+    }
 }
 
 std::string KameleonVolumeToRawTask::description() {
     return fmt::format(
         "Extract volumetric data from cdf file {}. Write raw volume data into {} "
         "and dictionary with metadata to {}",
-        _inputPath, _rawVolumeOutputPath, _dictionaryOutputPath
+        _inputPath.empty() ? _inputFolder : _inputPath,
+        _rawVolumeOutputPath, _dictionaryOutputPath
     );
 }
 
 void KameleonVolumeToRawTask::perform(const Task::ProgressCallback& progressCallback) {
-    KameleonVolumeReader reader(_inputPath.string());
+    if (_inputPath.empty() == _inputFolder.empty()) {
+        throw ghoul::RuntimeError(
+            "Exactly one of 'Input' and 'InputFolder' has to be specified",
+            "KameleonVolumeToRawTask"
+        );
+    }
+    if (_variables.empty()) {
+        throw ghoul::RuntimeError(
+            "At least one variable has to be specified", "KameleonVolumeToRawTask"
+        );
+    }
 
-    std::array<std::string, 3> variables = reader.gridVariableNames();
+    std::vector<std::filesystem::path> inputs;
+    if (!_inputPath.empty()) {
+        inputs.push_back(_inputPath);
+    }
+    else {
+        namespace fs = std::filesystem;
+        for (const fs::directory_entry& e : fs::directory_iterator(_inputFolder)) {
+            if (e.is_regular_file() && e.path().extension() == ".cdf") {
+                inputs.push_back(e.path());
+            }
+        }
+        std::sort(inputs.begin(), inputs.end());
+    }
+
+    if (inputs.empty()) {
+        throw ghoul::RuntimeError(
+            fmt::format("Could not find any cdf files in {}", _inputFolder),
+            "KameleonVolumeToRawTask"
+        );
+    }
+
+    // Make sure that no two outputs end up in the same file
+    for (const std::string& output : { _rawVolumeOutputPath, _dictionaryOutputPath }) {
+        if (inputs.size() > 1 && output.find(FileToken) == std::string::npos) {
+            throw ghoul::RuntimeError(
+                fmt::format("Output path '{}' has to contain '{}'", output, FileToken),
+                "KameleonVolumeToRawTask"
+            );
+        }
+        if (_variables.size() > 1 && output.find(VariableToken) == std::string::npos) {
+            throw ghoul::RuntimeError(
+                fmt::format(
+                    "Output path '{}' has to contain '{}'", output, VariableToken
+                ),
+                "KameleonVolumeToRawTask"
+            );
+        }
+    }
+
+    std::set<std::string> completed;
+    std::ofstream checkpoint;
+    if (!_checkpointPath.empty()) {
+        std::ifstream previous(_checkpointPath);
+        std::string line;
+        while (std::getline(previous, line)) {
+            completed.insert(line);
+        }
+        previous.close();
+
+        if (_checkpointPath.has_parent_path()) {
+            std::filesystem::create_directories(_checkpointPath.parent_path());
+        }
+        checkpoint.open(_checkpointPath, std::ios::app);
+    }
+
+    for (size_t i = 0; i < inputs.size(); i++) {
+        const std::filesystem::path& input = inputs[i];
+        auto onProgress = [&progressCallback, i, n = inputs.size()](float p) {
+            progressCallback((static_cast<float>(i) + p) / static_cast<float>(n));
+        };
+
+        if (completed.find(input.string()) != completed.end()) {
+            const bool hasOutputs = std::all_of(
+                _variables.begin(),
+                _variables.end(),
+                [this, &input](const std::string& variable) {
+                    return
+                        std::filesystem::is_regular_file(
+                            outputPath(_rawVolumeOutputPath, input, variable)
+                        ) &&
+                        std::filesystem::is_regular_file(
+                            outputPath(_dictionaryOutputPath, input, variable)
+                        );
+                }
+            );
+            if (hasOutputs) {
+                LINFO(fmt::format("Skipping {} which was converted previously", input));
+                continue;
+            }
+        }
+
+        convert(input, onProgress);
+
+        if (checkpoint.is_open()) {
+            checkpoint << input.string() << std::endl;
+        }
+    }
+
+    progressCallback(1.0f);
+}
+
+void KameleonVolumeToRawTask::convert(const std::filesystem::path& input,
+                                      const Task::ProgressCallback& onProgress) const
+{
+    KameleonVolumeReader reader(input.string());
 
+    glm::vec3 lowerDomainBound = _lowerDomainBound;
+    glm::vec3 upperDomainBound = _upperDomainBound;
     if (_autoDomainBounds) {
-        _lowerDomainBound = glm::vec3(
+        std::array<std::string, 3> variables = reader.gridVariableNames();
+
+        lowerDomainBound = glm::vec3(
             reader.minValue(variables[0]),
             reader.minValue(variables[1]),
             reader.minValue(variables[2])
         );
 
-        _upperDomainBound = glm::vec3(
+        upperDomainBound = glm::vec3(
             reader.maxValue(variables[0]),
             reader.maxValue(variables[1]),
             reader.maxValue(variables[2])
         );
     }
 
-    std::unique_ptr<volume::RawVolume<float>> rawVolume = reader.readFloatVolume(
+    const auto begin = std::chrono::steady_clock::now();
+    std::vector<KameleonVolumeReader::FloatVolume> volumes = reader.readFloatVolumes(
         _dimensions,
-        _variable,
-        _lowerDomainBound,
-        _upperDomainBound
+        _variables,
+        lowerDomainBound,
+        upperDomainBound,
+        _nThreads
     );
+    const std::chrono::duration<double> duration =
+        std::chrono::steady_clock::now() - begin;
+    const double nVoxels = static_cast<double>(volumes.front().volume->nCells());
+    LINFO(fmt::format(
+        "Sampled {} variables on {} voxels of {} in {:.2f} s ({:.0f} voxels/s)",
+        _variables.size(), nVoxels, input.filename(), duration.count(),
+        nVoxels * _variables.size() / duration.count()
+    ));
 
-    progressCallback(0.5f);
-
-    volume::RawVolumeWriter<float> writer(_rawVolumeOutputPath.string());
-    writer.write(*rawVolume);
-
-    progressCallback(0.9f);
-
-    ghoul::Dictionary inputMetadata = reader.readMetaData();
-    ghoul::Dictionary outputMetadata;
+    onProgress(0.5f);
 
     std::string time = reader.time();
 
@@ -147,22 +341,47 @@ void KameleonVolumeToRawTask::perform(const Task::ProgressCallback& progressCall
         time.pop_back();
     }
 
-    outputMetadata.setValue("Time", time);
-    outputMetadata.setValue("Dimensions", glm::dvec3(_dimensions));
-    outputMetadata.setValue("LowerDomainBound", glm::dvec3(_lowerDomainBound));
-    outputMetadata.setValue("UpperDomainBound", glm::dvec3(_upperDomainBound));
+    for (size_t i = 0; i < _variables.size(); i++) {
+        const std::string& variable = _variables[i];
 
-    outputMetadata.setValue("MinValue", reader.minValue(_variable));
-    outputMetadata.setValue("MaxValue", reader.maxValue(_variable));
-    outputMetadata.setValue("VisUnit", reader.getVisUnit(_variable));
+        writeAtomically(
+            outputPath(_rawVolumeOutputPath, input, variable),
+            [&volume = *volumes[i].volume](const std::filesystem::path& path) {
+                volume::RawVolumeWriter<float> writer(path);
+                writer.write(volume);
+            }
+        );
 
-    std::string metadataString = ghoul::formatLua(outputMetadata);
+        ghoul::Dictionary outputMetadata;
+        outputMetadata.setValue("Time", time);
+        outputMetadata.setValue("Dimensions", glm::dvec3(_dimensions));
+        outputMetadata.setValue("LowerDomainBound", glm::dvec3(lowerDomainBound));
+        outputMetadata.setValue("UpperDomainBound", glm::dvec3(upperDomainBound));
+
+        outputMetadata.setValue("MinValue", reader.minValue(variable));
+        outputMetadata.setValue("MaxValue", reader.maxValue(variable));
+        outputMetadata.setValue("VisUnit", reader.getVisUnit(variable));
+
+        const std::string metadataString = ghoul::formatLua(outputMetadata);
+        writeAtomically(
+            outputPath(_dictionaryOutputPath, input, variable),
+            [&metadataString](const std::filesystem::path& path) {
+                std::fstream f(path, std::ios::out);
+                f << "return " << metadataString;
+            }
+        );
 
-    std::fstream f(_dictionaryOutputPath, std::ios::out);
-    f << "return " << metadataString;
-    f.close();
+        onProgress(0.5f + 0.5f * static_cast<float>(i + 1) / _variables.size());
+    }
+}
 
-    progressCallback(1.0f);
+std::filesystem::path KameleonVolumeToRawTask::outputPath(const std::string& pattern,
+                                                    const std::filesystem::path& input,
+                                                    const std::string& variable) const
+{
+    std::string path = replaceAll(pattern, VariableToken, variable);
+    path = replaceAll(std::move(path), FileToken, input.stem().string());
+    return path;
 }
 
 } // namespace openspace::kameleonvolume
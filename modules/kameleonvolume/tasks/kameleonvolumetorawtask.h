@@ -30,6 +30,7 @@
 #include <ghoul/glm.h>
 #include <filesystem>
 #include <string>
+#include <vector>
 
 namespace openspace::kameleonvolume {
 
@@ -43,16 +44,27 @@ public:
     static documentation::Documentation documentation();
 
 private:
+    /// Converts all variables of a single cdf file
+    void convert(const std::filesystem::path& input,
+        const Task::ProgressCallback& onProgress) const;
+
+    /// Replaces the placeholders in the output path \p pattern
+    std::filesystem::path outputPath(const std::string& pattern,
+        const std::filesystem::path& input, const std::string& variable) const;
+
     std::filesystem::path _inputPath;
-    std::filesystem::path _rawVolumeOutputPath;
-    std::filesystem::path _dictionaryOutputPath;
+    std::filesystem::path _inputFolder;
+    std::string _rawVolumeOutputPath;
+    std::string _dictionaryOutputPath;
+    std::filesystem::path _checkpointPath;
 
-    std::string _variable;
+    std::vector<std::string> _variables;
     std::string _units;
     glm::uvec3 _dimensions = glm::uvec3(0);
     bool _autoDomainBounds = false;
     glm::vec3 _lowerDomainBound = glm::vec3(0.f);
     glm::vec3 _upperDomainBound = glm::vec3(0.f);
+    unsigned int _nThreads = 1;
 };
 
 } // namespace openspace::kameleon
@@ -39,12 +39,12 @@
 #include <openspace/rendering/renderengine.h>
 #include <openspace/rendering/raycastermanager.h>
 #include <openspace/rendering/transferfunction.h>
+#include <openspace/util/cachefiles.h>
 #include <openspace/util/spicemanager.h>
 #include <openspace/util/time.h>
 #include <openspace/util/updatestructures.h>
 #include <ghoul/fmt.h>
 #include <ghoul/glm.h>
-#include <ghoul/filesystem/cachemanager.h>
 #include <ghoul/filesystem/file.h>
 #include <ghoul/filesystem/filesystem.h>
 #include <ghoul/io/texture/texturereader.h>
@@ -473,7 +473,7 @@ bool RenderableMultiresVolume::initializeSelector() {
     switch (_selector) {
         case Selector::TF:
             if (_errorHistogramManager) {
-                 std::filesystem::path cached = FileSys.cacheManager()->cachedFilename(
+                 std::filesystem::path cached = cachedFilename(
                      fmt::format(
                          "{}_{}_errorHistograms",
                          std::filesystem::path(_filename).stem().string(), nHistograms
@@ -513,7 +513,7 @@ bool RenderableMultiresVolume::initializeSelector() {
 
         case Selector::SIMPLE:
             if (_histogramManager) {
-                std::filesystem::path cached = FileSys.cacheManager()->cachedFilename(
+                std::filesystem::path cached = cachedFilename(
                     fmt::format("{}_{}_histogram",
                         std::filesystem::path(_filename).stem().string(), nHistograms
                     ),
@@ -544,7 +544,7 @@ bool RenderableMultiresVolume::initializeSelector() {
 
         case Selector::LOCAL:
             if (_localErrorHistogramManager) {
-                 std::filesystem::path cached = FileSys.cacheManager()->cachedFilename(
+                 std::filesystem::path cached = cachedFilename(
                     fmt::format(
                         "{}_{}_localErrorHistograms",
                         std::filesystem::path(_filename).stem().string(), nHistograms
@@ -24,6 +24,7 @@
 
 #include <modules/multiresvolume/rendering/tsp.h>
 
+#include <openspace/util/cachefiles.h>
 #include <ghoul/fmt.h>
 #include <ghoul/glm.h>
 #include <ghoul/filesystem/file.h>
@@ -507,7 +508,7 @@ bool TSP::readCache() {
     if (!FileSys.cacheManager())
         return false;
 
-    std::filesystem::path cacheFilename = FileSys.cacheManager()->cachedFilename(
+    std::filesystem::path cacheFilename = cachedFilename(
         std::filesystem::path(_filename).stem(),
         ""
     );
@@ -545,7 +546,7 @@ bool TSP::writeCache() {
         return false;
     }
 
-    std::filesystem::path cacheFilename = FileSys.cacheManager()->cachedFilename(
+    std::filesystem::path cacheFilename = cachedFilename(
         std::filesystem::path(_filename).stem(),
         ""
     );
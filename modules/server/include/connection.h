@@ -25,9 +25,16 @@
 #ifndef __OPENSPACE_MODULE_SERVER___CONNECTION___H__
 #define __OPENSPACE_MODULE_SERVER___CONNECTION___H__
 
-#include <ghoul/misc/templatefactory.h>
+#include <modules/server/include/messageencoding.h>
+#include <modules/server/include/messagesender.h>
 #include <openspace/json.h>
+#include <openspace/util/lockfreequeue.h>
+#include <ghoul/misc/templatefactory.h>
+#include <atomic>
+#include <chrono>
 #include <memory>
+#include <mutex>
+#include <optional>
 #include <string>
 #include <thread>
 
@@ -51,29 +58,97 @@ class Topic;
 // message doesn't go anywhere since noone is listening, but it's better than a crash.
 class Connection : public std::enable_shared_from_this<Connection> {
 public:
+    static constexpr size_t DefaultInboxCapacity = 256;
+
     Connection(std::unique_ptr<ghoul::io::Socket> s, std::string address,
-        bool authorized = false, const std::string& password = "");
+        bool authorized = false, const std::string& password = "",
+        size_t inboxCapacity = DefaultInboxCapacity);
+
+    /**
+     * Reads messages from the socket until it disconnects. Each message is parsed into
+     * JSON on the calling thread and placed in the inbox, from where #handleInbox picks
+     * it up. If the inbox is full, reading from the socket is paused until the main
+     * thread has caught up, which pushes the backpressure onto the client rather than
+     * growing an unbounded queue. This function is meant to be run on the connection's
+     * own thread and is the only producer for the inbox.
+     */
+    void receiveMessages();
+
+    /**
+     * Handles all messages that have been parsed and queued by #receiveMessages so far.
+     * This function must be called from the main thread.
+     *
+     * \return The number of messages that were handled
+     */
+    size_t handleInbox();
+
+    /**
+     * Returns \c true while #receiveMessages is still running, \c false once the socket
+     * has disconnected and the thread set by #setThread can be joined without blocking.
+     */
+    bool isReceiving() const;
 
     void handleMessage(const std::string& message);
     void sendMessage(const std::string& message);
     void handleJson(const nlohmann::json& json);
     void sendJson(const nlohmann::json& json);
+
+    /**
+     * Queues a message that will be created by calling \p generator on the server's
+     * sender thread. All messages that are queued during a frame are written to the
+     * socket together at the end of the frame. The \p generator must not reference any
+     * object that is owned by the main thread.
+     */
+    void queueJson(MessageSender::JsonGenerator generator);
+
+    /**
+     * Returns all messages that have been queued with #queueJson since the last call and
+     * clears the queue. This function must be called from the main thread.
+     */
+    MessageSender::Batch takeQueuedJson();
+    bool hasQueuedJson() const;
+
     void setAuthorized(bool status);
 
     bool isAuthorized() const;
 
+    /**
+     * Sets the encoding that is used for all messages that are sent from now on. Binary
+     * encodings are only supported by raw TCP sockets, as WebSocket messages are sent as
+     * text frames.
+     */
+    void setEncoding(MessageEncoding encoding);
+    MessageEncoding encoding() const;
+    bool supportsBinaryEncoding() const;
+
     ghoul::io::Socket* socket();
     std::thread& thread();
     void setThread(std::thread&& thread);
 
 private:
+    std::optional<nlohmann::json> parseMessage(const std::string& message);
+
     ghoul::TemplateFactory<Topic> _topicFactory;
     std::map<TopicId, std::unique_ptr<Topic>> _topics;
-    std::unique_ptr<ghoul::io::Socket> _socket;
+    std::shared_ptr<ghoul::io::Socket> _socket;
+    // Serializes writes to the _socket between the main thread and the sender thread,
+    // which receives this mutex with every batch returned by #takeQueuedJson
+    std::shared_ptr<std::mutex> _socketWriteMutex = std::make_shared<std::mutex>();
     std::thread _thread;
+    bool _isTcpSocket = false;
+    MessageEncoding _encoding = MessageEncoding::Json;
+    std::vector<MessageSender::JsonGenerator> _queuedJson;
+
+    LockFreeQueue<nlohmann::json> _inbox;
+    std::atomic_bool _isReceiving = true;
+
+    // Statistics about the work done on the main thread, reported by the receiving thread
+    // when disconnecting
+    std::atomic<size_t> _nHandledMessages = 0;
+    std::atomic<std::chrono::microseconds::rep> _handlingTime = 0;
 
     std::string _address;
-    bool _isAuthorized = false;
+    std::atomic_bool _isAuthorized = false;
     std::map<TopicId, std::string> _messageQueue;
     std::map<TopicId, std::chrono::system_clock::time_point> _sentMessages;
 };
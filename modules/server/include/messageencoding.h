@@ -0,0 +1,130 @@
+/*****************************************************************************************
+ *                                                                                       *
+ * OpenSpace                                                                             *
+ *                                                                                       *
+ * Copyright (c) 2014-2023                                                               *
+ *                                                                                       *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this  *
+ * software and associated documentation files (the "Software"), to deal in the Software *
+ * without restriction, including without limitation the rights to use, copy, modify,    *
+ * merge, publish, distribute, sublicense, and/or sell copies of the Software, and to    *
+ * permit persons to whom the Software is furnished to do so, subject to the following   *
+ * conditions:                                                                           *
+ *                                                                                       *
+ * The above copyright notice and this permission notice shall be included in all copies *
+ * or substantial portions of the Software.                                              *
+ *                                                                                       *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,   *
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A         *
+ * PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT    *
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF  *
+ * CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE  *
+ * OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                                         *
+ ****************************************************************************************/
+
+
+#ifndef __OPENSPACE_MODULE_SERVER___MESSAGEENCODING___H__
+#define __OPENSPACE_MODULE_SERVER___MESSAGEENCODING___H__
+
+#include <openspace/json.h>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace openspace::properties {
+    class Property;
+    class PropertyOwner;
+} // namespace openspace::properties
+
+namespace openspace {
+
+/**
+ * The encodings that a client can request for the messages that the server sends. Binary
+ * encodings are supported by nlohmann::json and are both smaller and faster to parse than
+ * the textual JSON representation.
+ */
+enum class MessageEncoding {
+    Json = 0,
+    Cbor,
+    MessagePack
+};
+
+std::optional<MessageEncoding> messageEncodingFromString(std::string_view name);
+std::string_view messageEncodingName(MessageEncoding encoding);
+
+/**
+ * Prepares the serialized \p payload for being sent over a socket. As the message
+ * delimiter of the socket can appear inside binary data, binary encodings are prefixed
+ * with the payload size as a 32-bit little-endian integer. JSON payloads are returned
+ * unchanged.
+ */
+std::string frameMessage(std::string payload, MessageEncoding encoding);
+
+/**
+ * Serializes the \p json using the \p encoding and frames the result using
+ * #frameMessage.
+ */
+std::string encodeMessage(const nlohmann::json& json, MessageEncoding encoding);
+
+/**
+ * Writes a document directly into its serialized form without first building an
+ * nlohmann::json document of the whole content. The number of entries of each object and
+ * array has to be known up front, as MessagePack does not support containers of
+ * indeterminate length. Each #beginObject and #beginArray call has to be matched with a
+ * #endObject and #endArray call respectively and inside an object each value has to be
+ * preceded by a call to #key.
+ */
+class StreamingSerializer {
+public:
+    explicit StreamingSerializer(MessageEncoding encoding);
+
+    void beginObject(size_t nEntries);
+    void endObject();
+    void beginArray(size_t nElements);
+    void endArray();
+    void key(std::string_view key);
+    void stringValue(std::string_view value);
+    void value(const nlohmann::json& value);
+
+    /**
+     * Adds a value that is already serialized as JSON \p text. For the JSON encoding the
+     * text is copied verbatim, the binary encodings have to parse it first.
+     */
+    void jsonText(std::string_view text);
+
+    MessageEncoding encoding() const;
+
+    /// Returns the serialized document and leaves the serializer empty
+    std::string finish();
+
+private:
+    void prepareValue();
+    void writeHeader(unsigned char major, size_t n);
+    void writeString(std::string_view string);
+
+    MessageEncoding _encoding;
+    std::string _buffer;
+
+    // Only used for JSON to place the separators between values. Each entry is for one
+    // of the currently open containers and is \c true if no value has been written yet
+    std::vector<bool> _isFirstInContainer;
+    bool _hasKey = false;
+};
+
+/**
+ * Writes the Property \p prop in the same structure that the to_json conversion of a
+ * Property produces. For the JSON encoding, the description and value strings of the
+ * property are used directly without parsing them.
+ */
+void serialize(StreamingSerializer& serializer, const properties::Property& prop);
+
+/**
+ * Writes the PropertyOwner \p owner including all of its properties and subowners in the
+ * same structure that the to_json conversion of a PropertyOwner produces.
+ */
+void serialize(StreamingSerializer& serializer, const properties::PropertyOwner& owner);
+
+} // namespace openspace
+
+#endif // __OPENSPACE_MODULE_SERVER___MESSAGEENCODING___H__
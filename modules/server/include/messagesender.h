@@ -0,0 +1,88 @@
+/*****************************************************************************************
+ *                                                                                       *
+ * OpenSpace                                                                             *
+ *                                                                                       *
+ * Copyright (c) 2014-2023                                                               *
+ *                                                                                       *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this  *
+ * software and associated documentation files (the "Software"), to deal in the Software *
+ * without restriction, including without limitation the rights to use, copy, modify,    *
+ * merge, publish, distribute, sublicense, and/or sell copies of the Software, and to    *
+ * permit persons to whom the Software is furnished to do so, subject to the following   *
+ * conditions:                                                                           *
+ *                                                                                       *
+ * The above copyright notice and this permission notice shall be included in all copies *
+ * or substantial portions of the Software.                                              *
+ *                                                                                       *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,   *
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A         *
+ * PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT    *
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF  *
+ * CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE  *
+ * OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                                         *
+ ****************************************************************************************/
+
+
+#ifndef __OPENSPACE_MODULE_SERVER___MESSAGESENDER___H__
+#define __OPENSPACE_MODULE_SERVER___MESSAGESENDER___H__
+
+#include <modules/server/include/messageencoding.h>
+#include <openspace/json.h>
+#include <condition_variable>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace ghoul::io { class Socket; }
+
+namespace openspace {
+
+/**
+ * Creates, serializes, and writes outgoing messages on a background thread. The main
+ * thread only captures the data that is needed for a message and hands it over once per
+ * frame, which keeps the cost of JSON construction and serialization off the main thread.
+ */
+class MessageSender {
+public:
+    /// Called on the sender thread to create the JSON for a single message
+    using JsonGenerator = std::function<nlohmann::json()>;
+
+    struct Batch {
+        std::shared_ptr<ghoul::io::Socket> socket;
+
+        // Guards all writes to the #socket. The same mutex is locked by the Connection
+        // that owns the socket whenever it writes a message directly from the main thread
+        std::shared_ptr<std::mutex> writeMutex;
+
+        // If this is \c true, all messages of the batch are joined into a single write to
+        // the socket. This requires the socket to use a delimiter-based protocol
+        bool joinMessages = false;
+
+        MessageEncoding encoding = MessageEncoding::Json;
+        std::vector<JsonGenerator> messages;
+    };
+
+    MessageSender();
+    ~MessageSender();
+
+    /**
+     * Hands the \p batches over to the sender thread. This function does not block for
+     * any serialization or socket operations.
+     */
+    void send(std::vector<Batch> batches);
+
+private:
+    void run();
+
+    std::thread _thread;
+    std::mutex _mutex;
+    std::condition_variable _condition;
+    std::vector<Batch> _queue;
+    bool _shouldStop = false;
+};
+
+} // namespace openspace
+
+#endif // __OPENSPACE_MODULE_SERVER___MESSAGESENDER___H__
@@ -27,6 +27,8 @@
 
 #include <modules/server/include/topics/topic.h>
 
+namespace openspace::properties { class PropertyOwner; }
+
 namespace openspace {
 
 class GetPropertyTopic : public Topic {
@@ -38,7 +40,8 @@ public:
     bool isDone() const override;
 
 private:
-    nlohmann::json allProperties();
+    std::string allProperties();
+    std::string propertyOwner(const properties::PropertyOwner& owner);
     nlohmann::json propertyFromKey(const std::string& key);
 };
 
@@ -26,6 +26,7 @@
 #define __OPENSPACE_MODULE_SERVER___SUBSCRIPTION_TOPIC___H__
 
 #include <modules/server/include/topics/topic.h>
+#include <chrono>
 
 namespace openspace::properties { class Property; }
 
@@ -41,6 +42,7 @@ public:
 
 private:
     void resetCallbacks();
+    void queueValue();
 
     const int UnsetCallbackHandle = -1;
 
@@ -48,7 +50,15 @@ private:
     bool _isSubscribedTo = false;
     int _onChangeHandle = UnsetCallbackHandle;
     int _onDeleteHandle = UnsetCallbackHandle;
+    int _preSyncHandle = UnsetCallbackHandle;
     properties::Property* _prop = nullptr;
+
+    // Changes are only recorded when they happen and are sent at most once per frame
+    // and not more often than the minimum interval that the client asked for
+    bool _hasChanged = false;
+    std::chrono::steady_clock::duration _minimumInterval =
+        std::chrono::steady_clock::duration(0);
+    std::chrono::steady_clock::time_point _lastSendTime;
 };
 
 } // namespace openspace
@@ -0,0 +1,199 @@
+# coding=utf-8
+
+"""
+OpenSpace
+
+Copyright (c) 2014-2023
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of this
+software and associated documentation files (the "Software"), to deal in the Software
+without restriction, including without limitation the rights to use, copy, modify,
+merge, publish, distribute, sublicense, and/or sell copies of the Software, and to
+permit persons to whom the Software is furnished to do so, subject to the following
+conditions:
+
+The above copyright notice and this permission notice shall be included in all copies
+or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A
+PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF
+CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE
+OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+
+This script is a load test for the Server module. It opens a number of simultaneous
+connections to the raw TCP socket interface of a running OpenSpace instance and sends
+'bounce' messages that the server echoes back. Each connection keeps a fixed number of
+messages in flight. At the end, the number of round-trips per second and the latency
+percentiles are printed.
+
+With --subscriptions, the connections instead subscribe to a property (for example one
+that changes every frame) and the number of updates that arrive per second is printed.
+Each subscription can optionally be rate limited with --max-rate.
+
+The time the main thread of OpenSpace spent handling the messages of each connection is
+written to the OpenSpace log (at the Debug level) when the connection closes.
+
+Examples:
+  python server_load_test.py --connections 32 --duration 10 --window 16
+  python server_load_test.py --connections 4 --subscriptions 1000 --max-rate 30 \
+      --property Scene.Earth.Rotation.Rotation
+"""
+
+import argparse
+import asyncio
+import json
+import statistics
+import time
+
+async def run_connection(host, port, duration, window, topic, latencies):
+    reader, writer = await asyncio.open_connection(host, port)
+
+    sent = {}
+    counter = 0
+    end_time = time.perf_counter() + duration
+
+    def send():
+        nonlocal counter
+        message = {
+            "topic": topic,
+            "type": "bounce",
+            "payload": { "id": counter }
+        }
+        sent[counter] = time.perf_counter()
+        writer.write((json.dumps(message) + "\n").encode())
+        counter += 1
+
+    for _ in range(window):
+        send()
+    await writer.drain()
+
+    n_received = 0
+    while sent:
+        line = await reader.readline()
+        if not line:
+            break
+        now = time.perf_counter()
+        id = json.loads(line)["payload"]["id"]
+        latencies.append(now - sent.pop(id))
+        n_received += 1
+        if now < end_time:
+            send()
+            await writer.drain()
+
+    writer.close()
+    await writer.wait_closed()
+    return n_received
+
+async def run_subscriptions(host, port, duration, property, max_rate, topics):
+    reader, writer = await asyncio.open_connection(host, port)
+
+    for topic in topics:
+        payload = { "event": "start_subscription", "property": property }
+        if max_rate > 0:
+            payload["maxRate"] = max_rate
+        message = { "topic": topic, "type": "subscribe", "payload": payload }
+        writer.write((json.dumps(message) + "\n").encode())
+    await writer.drain()
+
+    n_received = 0
+    end_time = time.perf_counter() + duration
+    while True:
+        remaining = end_time - time.perf_counter()
+        if remaining <= 0:
+            break
+        try:
+            line = await asyncio.wait_for(reader.readline(), remaining)
+        except asyncio.TimeoutError:
+            break
+        if not line:
+            break
+        n_received += 1
+
+    for topic in topics:
+        message = {
+            "topic": topic,
+            "payload": { "event": "stop_subscription" }
+        }
+        writer.write((json.dumps(message) + "\n").encode())
+    await writer.drain()
+    writer.close()
+    await writer.wait_closed()
+    return n_received
+
+async def main():
+    parser = argparse.ArgumentParser(description="Load test for the OpenSpace server")
+    parser.add_argument("--host", default="localhost")
+    parser.add_argument("--port", type=int, default=4681)
+    parser.add_argument("--connections", type=int, default=16)
+    parser.add_argument("--duration", type=float, default=10.0, help="In seconds")
+    parser.add_argument(
+        "--window",
+        type=int,
+        default=8,
+        help="Number of messages in flight per connection"
+    )
+    parser.add_argument(
+        "--subscriptions",
+        type=int,
+        default=0,
+        help="Total number of subscriptions, spread over all connections"
+    )
+    parser.add_argument(
+        "--property",
+        help="The URI of the property that is subscribed to"
+    )
+    parser.add_argument(
+        "--max-rate",
+        type=float,
+        default=0,
+        help="Maximum number of updates per second for each subscription"
+    )
+    args = parser.parse_args()
+
+    if args.subscriptions > 0:
+        if not args.property:
+            parser.error("--property is required when using --subscriptions")
+
+        start = time.perf_counter()
+        results = await asyncio.gather(*[
+            run_subscriptions(
+                args.host,
+                args.port,
+                args.duration,
+                args.property,
+                args.max_rate,
+                range(i, args.subscriptions, args.connections)
+            )
+            for i in range(args.connections)
+        ])
+        elapsed = time.perf_counter() - start
+        total = sum(results)
+        print(f"Subscriptions: {args.subscriptions} on {args.connections} connections")
+        print(f"Updates:       {total} in {elapsed:.2f} s")
+        print(f"Throughput:    {total / elapsed:.0f} updates/s")
+        return
+
+    latencies = []
+    start = time.perf_counter()
+    results = await asyncio.gather(*[
+        run_connection(args.host, args.port, args.duration, args.window, i, latencies)
+        for i in range(args.connections)
+    ])
+    elapsed = time.perf_counter() - start
+
+    total = sum(results)
+    print(f"Connections:  {args.connections}")
+    print(f"Messages:     {total} in {elapsed:.2f} s")
+    print(f"Throughput:   {total / elapsed:.0f} messages/s")
+    if len(latencies) > 1:
+        latencies.sort()
+        ms = lambda p: latencies[int(p * (len(latencies) - 1))] * 1000.0
+        print(f"Latency mean: {statistics.mean(latencies) * 1000.0:.2f} ms")
+        print(f"Latency p50:  {ms(0.50):.2f} ms")
+        print(f"Latency p99:  {ms(0.99):.2f} ms")
+
+if __name__ == "__main__":
+    asyncio.run(main())
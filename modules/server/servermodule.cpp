@@ -41,7 +41,10 @@
 #include <ghoul/misc/templatefactory.h>
 
 namespace {
+    constexpr std::string_view _loggerCat = "ServerModule";
+
     constexpr std::string_view KeyInterfaces = "Interfaces";
+    constexpr std::string_view KeyInboxCapacity = "InboxCapacity";
 } // namespace
 
 namespace openspace {
@@ -53,6 +56,8 @@ ServerModule::ServerModule()
     addPropertySubOwner(_interfaceOwner);
 
     global::callback::preSync->emplace_back([this]() {
+        ZoneScopedN("ServerModule callbacks");
+
         // Trigger callbacks
         using K = CallbackHandle;
         using V = CallbackFunction;
@@ -126,6 +131,17 @@ void ServerModule::internalInitialize(const ghoul::Dictionary& configuration) {
             configuration.value<double>("SkyBrowserUpdateTime")
         );
     }
+    if (configuration.hasValue<double>(KeyInboxCapacity)) {
+        const double capacity = configuration.value<double>(KeyInboxCapacity);
+        if (capacity >= 1.0) {
+            _inboxCapacity = static_cast<size_t>(capacity);
+        }
+        else {
+            LWARNING(fmt::format(
+                "{} must be at least 1, using {}", KeyInboxCapacity, _inboxCapacity
+            ));
+        }
+    }
 }
 
 void ServerModule::preSync() {
@@ -153,10 +169,11 @@ void ServerModule::preSync() {
                 std::move(socket),
                 address,
                 false,
-                serverInterface->password()
+                serverInterface->password(),
+                _inboxCapacity
             );
             connection->setThread(std::thread(
-                [this, connection] () { handleConnection(connection); }
+                [connection] () { connection->receiveMessages(); }
             ));
             if (serverInterface->clientHasAccessWithoutPassword(address)) {
                 connection->setAuthorized(true);
@@ -165,9 +182,12 @@ void ServerModule::preSync() {
         }
     }
 
-    // Consume all messages put into the message queue by the socket threads.
+    // Consume all messages that the socket threads have parsed into the inboxes.
     consumeMessages();
 
+    // Hand the messages that were queued during this frame to the sender thread
+    sendQueuedMessages();
+
     // Join threads for sockets that disconnected.
     cleanUpFinishedThreads();
 }
@@ -177,7 +197,11 @@ void ServerModule::cleanUpFinishedThreads() {
 
     for (ConnectionData& connectionData : _connections) {
         Connection& connection = *connectionData.connection;
-        if (!connection.socket() || !connection.socket()->isConnected()) {
+        // A thread that is still in its read loop while the socket has been disconnected
+        // will leave it with the next call to getMessage, so joining it is cheap
+        if (!connection.isReceiving() ||
+            !connection.socket() || !connection.socket()->isConnected())
+        {
             if (connection.thread().joinable()) {
                 connection.thread().join();
                 connectionData.isMarkedForRemoval = true;
@@ -210,27 +234,25 @@ void ServerModule::disconnectAll() {
     }
 }
 
-void ServerModule::handleConnection(std::shared_ptr<Connection> connection) {
+void ServerModule::consumeMessages() {
     ZoneScoped;
 
-    std::string messageString;
-    messageString.reserve(256);
-    while (connection->socket()->getMessage(messageString)) {
-        std::lock_guard lock(_messageQueueMutex);
-        _messageQueue.push_back({ connection, messageString });
+    for (ConnectionData& connectionData : _connections) {
+        connectionData.connection->handleInbox();
     }
 }
 
-void ServerModule::consumeMessages() {
+void ServerModule::sendQueuedMessages() {
     ZoneScoped;
 
-    std::lock_guard lock(_messageQueueMutex);
-    while (!_messageQueue.empty()) {
-        const Message& m = _messageQueue.front();
-        if (std::shared_ptr<Connection> c = m.connection.lock()) {
-            c->handleMessage(m.messageString);
+    std::vector<MessageSender::Batch> batches;
+    for (ConnectionData& connectionData : _connections) {
+        if (connectionData.connection->hasQueuedJson()) {
+            batches.push_back(connectionData.connection->takeQueuedJson());
         }
-        _messageQueue.pop_front();
+    }
+    if (!batches.empty()) {
+        _messageSender.send(std::move(batches));
     }
 }
 
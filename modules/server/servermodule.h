@@ -27,25 +27,19 @@
 
 #include <openspace/util/openspacemodule.h>
 
+#include <modules/server/include/messagesender.h>
 #include <modules/server/include/serverinterface.h>
 
-#include <deque>
 #include <memory>
-#include <mutex>
 
 namespace openspace {
 
 constexpr int SOCKET_API_VERSION_MAJOR = 0;
-constexpr int SOCKET_API_VERSION_MINOR = 1;
+constexpr int SOCKET_API_VERSION_MINOR = 2;
 constexpr int SOCKET_API_VERSION_PATCH = 0;
 
 class Connection;
 
-struct Message {
-    std::weak_ptr<Connection> connection;
-    std::string messageString;
-};
-
 class ServerModule : public OpenSpaceModule {
 public:
     static constexpr const char* Name = "Server";
@@ -71,19 +65,18 @@ private:
         bool isMarkedForRemoval = false;
     };
 
-    void handleConnection(std::shared_ptr<Connection> connection);
     void cleanUpFinishedThreads();
     void consumeMessages();
+    void sendQueuedMessages();
     void disconnectAll();
     void preSync();
 
-    std::mutex _messageQueueMutex;
-    std::deque<Message> _messageQueue;
-
     std::vector<ConnectionData> _connections;
+    MessageSender _messageSender;
     std::vector<std::unique_ptr<ServerInterface>> _interfaces;
     properties::PropertyOwner _interfaceOwner;
     int _skyBrowserUpdateTime = 100;
+    size_t _inboxCapacity = 256;
 
     // Callbacks for tiggering topic
     int _nextCallbackHandle = 0;
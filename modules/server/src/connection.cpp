@@ -28,6 +28,7 @@
 #include <modules/server/include/topics/bouncetopic.h>
 #include <modules/server/include/topics/cameratopic.h>
 #include <modules/server/include/topics/documentationtopic.h>
+#include <modules/server/include/topics/encodingtopic.h>
 #include <modules/server/include/topics/enginemodetopic.h>
 #include <modules/server/include/topics/flightcontrollertopic.h>
 #include <modules/server/include/topics/getpropertytopic.h>
@@ -45,6 +46,7 @@
 #include <openspace/engine/configuration.h>
 #include <openspace/engine/globals.h>
 #include <ghoul/io/socket/socket.h>
+#include <ghoul/io/socket/tcpsocket.h>
 #include <ghoul/io/socket/tcpsocketserver.h>
 #include <ghoul/io/socket/websocketserver.h>
 #include <ghoul/logging/logmanager.h>
@@ -63,13 +65,19 @@ namespace {
 namespace openspace {
 
 Connection::Connection(std::unique_ptr<ghoul::io::Socket> s, std::string address,
-                       bool authorized, const std::string& password)
+                       bool authorized, const std::string& password,
+                       size_t inboxCapacity)
     : _socket(std::move(s))
+    , _inbox(inboxCapacity)
     , _address(std::move(address))
     , _isAuthorized(authorized)
 {
     ghoul_assert(_socket, "Socket must not be nullptr");
 
+    // Raw TCP sockets delimit messages with a newline, so a batch of messages can be
+    // written in one go. A WebSocket needs a separate frame for each message
+    _isTcpSocket = dynamic_cast<ghoul::io::TcpSocket*>(_socket.get()) != nullptr;
+
     _topicFactory.registerClass(
         "authorize",
         [password](bool, const ghoul::Dictionary&, ghoul::MemoryPoolBase* pool) {
@@ -87,6 +95,7 @@ Connection::Connection(std::unique_ptr<ghoul::io::Socket> s, std::string address
     _topicFactory.registerClass<DocumentationTopic>("documentation");
     _topicFactory.registerClass<GetPropertyTopic>("get");
     _topicFactory.registerClass<LuaScriptTopic>("luascript");
+    _topicFactory.registerClass<EncodingTopic>("encoding");
     _topicFactory.registerClass<EngineModeTopic>("engineMode");
     _topicFactory.registerClass<SessionRecordingTopic>("sessionRecording");
     _topicFactory.registerClass<SetPropertyTopic>("set");
@@ -101,31 +110,85 @@ Connection::Connection(std::unique_ptr<ghoul::io::Socket> s, std::string address
     _topicFactory.registerClass<CameraTopic>("camera");
 }
 
-void Connection::handleMessage(const std::string& message) {
+void Connection::receiveMessages() {
     ZoneScoped;
 
-    try {
-        nlohmann::json j = nlohmann::json::parse(message.c_str());
+    std::string messageString;
+    messageString.reserve(256);
+    while (_socket->getMessage(messageString)) {
+        std::optional<nlohmann::json> json = parseMessage(messageString);
+        if (!json.has_value()) {
+            continue;
+        }
+
+        bool hasWarned = false;
+        while (!_inbox.tryPush(std::move(*json))) {
+            if (!_socket->isConnected()) {
+                break;
+            }
+            if (!hasWarned) {
+                LWARNING(fmt::format(
+                    "Inbox for connection '{}' is full. Pausing reading until the "
+                    "queued messages have been handled", _address
+                ));
+                hasWarned = true;
+            }
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+    }
+
+    _isReceiving = false;
+    LDEBUG(fmt::format(
+        "Connection '{}' closed. Handled {} messages in {} ms on the main thread",
+        _address, _nHandledMessages.load(), _handlingTime.load() / 1000
+    ));
+}
+
+size_t Connection::handleInbox() {
+    ZoneScoped;
+
+    const auto start = std::chrono::steady_clock::now();
+
+    size_t nMessages = 0;
+    nlohmann::json json;
+    while (_inbox.tryPop(json)) {
         try {
-            handleJson(j);
+            handleJson(json);
         }
-        catch (const std::domain_error& e) {
-            LERROR(fmt::format("JSON handling error from: {}. {}", message, e.what()));
+        catch (const std::exception& e) {
+            LERROR(fmt::format(
+                "JSON handling error from: {}. {}", json.dump(), e.what()
+            ));
         }
+        nMessages++;
     }
-    catch (const std::out_of_range& e) {
-        LERROR(fmt::format("JSON handling error from: {}. {}", message, e.what()));
+
+    if (nMessages > 0) {
+        _nHandledMessages += nMessages;
+        _handlingTime += std::chrono::duration_cast<std::chrono::microseconds>(
+            std::chrono::steady_clock::now() - start
+        ).count();
+    }
+    return nMessages;
+}
+
+bool Connection::isReceiving() const {
+    return _isReceiving;
+}
+
+std::optional<nlohmann::json> Connection::parseMessage(const std::string& message) {
+    ZoneScoped;
+
+    try {
+        return nlohmann::json::parse(message.c_str());
     }
     catch (const std::exception& e) {
-        LERROR(e.what());
-    } catch (...) {
         if (!isAuthorized()) {
             _socket->disconnect();
             LERROR(fmt::format(
                 "Could not parse JSON: '{}'. Connection is unauthorized. Disconnecting",
                 message
             ));
-            return;
         }
         else {
             std::string sanitizedString = message;
@@ -137,8 +200,27 @@ void Connection::handleMessage(const std::string& message) {
                     return std::isprint(c, std::locale("")) ? char(c) : ' ';
                 }
             );
-            LERROR(fmt::format("Could not parse JSON: '{}'", sanitizedString));
+            LERROR(fmt::format(
+                "Could not parse JSON: '{}'. {}", sanitizedString, e.what()
+            ));
         }
+        return std::nullopt;
+    }
+}
+
+void Connection::handleMessage(const std::string& message) {
+    ZoneScoped;
+
+    std::optional<nlohmann::json> j = parseMessage(message);
+    if (!j.has_value()) {
+        return;
+    }
+
+    try {
+        handleJson(*j);
+    }
+    catch (const std::exception& e) {
+        LERROR(fmt::format("JSON handling error from: {}. {}", message, e.what()));
     }
 }
 
@@ -201,19 +283,60 @@ void Connection::handleJson(const nlohmann::json& json) {
 void Connection::sendMessage(const std::string& message) {
     ZoneScoped;
 
+    std::lock_guard lock(*_socketWriteMutex);
     _socket->putMessage(message);
 }
 
 void Connection::sendJson(const nlohmann::json& json) {
     ZoneScoped;
 
-    sendMessage(json.dump());
+    sendMessage(encodeMessage(json, _encoding));
+}
+
+void Connection::queueJson(MessageSender::JsonGenerator generator) {
+    if (!_socket->isConnected()) {
+        // Nobody is collecting the queue for a closed connection anymore
+        return;
+    }
+    _queuedJson.push_back(std::move(generator));
+}
+
+MessageSender::Batch Connection::takeQueuedJson() {
+    MessageSender::Batch batch = {
+        .socket = _socket,
+        .writeMutex = _socketWriteMutex,
+        .joinMessages = _isTcpSocket,
+        .encoding = _encoding,
+        .messages = std::move(_queuedJson)
+    };
+    _queuedJson.clear();
+    return batch;
+}
+
+bool Connection::hasQueuedJson() const {
+    return !_queuedJson.empty();
 }
 
 bool Connection::isAuthorized() const {
     return _isAuthorized;
 }
 
+void Connection::setEncoding(MessageEncoding encoding) {
+    ghoul_assert(
+        encoding == MessageEncoding::Json || supportsBinaryEncoding(),
+        "Binary encodings are not supported by this connection"
+    );
+    _encoding = encoding;
+}
+
+MessageEncoding Connection::encoding() const {
+    return _encoding;
+}
+
+bool Connection::supportsBinaryEncoding() const {
+    return _isTcpSocket;
+}
+
 void Connection::setThread(std::thread&& thread) {
     _thread = std::move(thread);
 }
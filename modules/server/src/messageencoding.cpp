@@ -0,0 +1,375 @@
+/*****************************************************************************************
+ *                                                                                       *
+ * OpenSpace                                                                             *
+ *                                                                                       *
+ * Copyright (c) 2014-2023                                                               *
+ *                                                                                       *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this  *
+ * software and associated documentation files (the "Software"), to deal in the Software *
+ * without restriction, including without limitation the rights to use, copy, modify,    *
+ * merge, publish, distribute, sublicense, and/or sell copies of the Software, and to    *
+ * permit persons to whom the Software is furnished to do so, subject to the following   *
+ * conditions:                                                                           *
+ *                                                                                       *
+ * The above copyright notice and this permission notice shall be included in all copies *
+ * or substantial portions of the Software.                                              *
+ *                                                                                       *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,   *
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A         *
+ * PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT    *
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF  *
+ * CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE  *
+ * OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                                         *
+ ****************************************************************************************/
+
+
+#include <modules/server/include/messageencoding.h>
+
+#include <openspace/properties/property.h>
+#include <openspace/properties/propertyowner.h>
+#include <ghoul/misc/assert.h>
+#include <ghoul/misc/exception.h>
+#include <ghoul/misc/profiling.h>
+#include <cstdint>
+
+namespace {
+    // CBOR major types (RFC 8949, Section 3.1)
+    constexpr unsigned char CborTextString = 3;
+    constexpr unsigned char CborArray = 4;
+    constexpr unsigned char CborMap = 5;
+
+    // MessagePack type bytes for types where the size is not encoded in the first byte
+    constexpr unsigned char MsgPackStr8 = 0xd9;
+    constexpr unsigned char MsgPackStr16 = 0xda;
+    constexpr unsigned char MsgPackStr32 = 0xdb;
+    constexpr unsigned char MsgPackArray16 = 0xdc;
+    constexpr unsigned char MsgPackArray32 = 0xdd;
+    constexpr unsigned char MsgPackMap16 = 0xde;
+    constexpr unsigned char MsgPackMap32 = 0xdf;
+
+    void appendBigEndian(std::string& buffer, uint64_t value, int nBytes) {
+        for (int i = nBytes - 1; i >= 0; i--) {
+            buffer.push_back(static_cast<char>((value >> (i * 8)) & 0xff));
+        }
+    }
+} // namespace
+
+namespace openspace {
+
+std::optional<MessageEncoding> messageEncodingFromString(std::string_view name) {
+    if (name == "json") {
+        return MessageEncoding::Json;
+    }
+    else if (name == "cbor") {
+        return MessageEncoding::Cbor;
+    }
+    else if (name == "msgpack") {
+        return MessageEncoding::MessagePack;
+    }
+    else {
+        return std::nullopt;
+    }
+}
+
+std::string_view messageEncodingName(MessageEncoding encoding) {
+    switch (encoding) {
+        case MessageEncoding::Json:        return "json";
+        case MessageEncoding::Cbor:        return "cbor";
+        case MessageEncoding::MessagePack: return "msgpack";
+        default:                           throw ghoul::MissingCaseException();
+    }
+}
+
+std::string frameMessage(std::string payload, MessageEncoding encoding) {
+    if (encoding == MessageEncoding::Json) {
+        return payload;
+    }
+
+    const uint32_t size = static_cast<uint32_t>(payload.size());
+    std::string result;
+    result.reserve(sizeof(uint32_t) + payload.size());
+    for (size_t i = 0; i < sizeof(uint32_t); i++) {
+        result.push_back(static_cast<char>((size >> (i * 8)) & 0xff));
+    }
+    result += payload;
+    return result;
+}
+
+std::string encodeMessage(const nlohmann::json& json, MessageEncoding encoding) {
+    ZoneScoped;
+
+    std::string payload;
+    switch (encoding) {
+        case MessageEncoding::Json:
+            return json.dump();
+        case MessageEncoding::Cbor:
+            nlohmann::json::to_cbor(json, payload);
+            break;
+        case MessageEncoding::MessagePack:
+            nlohmann::json::to_msgpack(json, payload);
+            break;
+        default:
+            throw ghoul::MissingCaseException();
+    }
+    return frameMessage(std::move(payload), encoding);
+}
+
+StreamingSerializer::StreamingSerializer(MessageEncoding encoding)
+    : _encoding(encoding)
+{}
+
+void StreamingSerializer::beginObject(size_t nEntries) {
+    prepareValue();
+    switch (_encoding) {
+        case MessageEncoding::Json:
+            _buffer.push_back('{');
+            _isFirstInContainer.push_back(true);
+            break;
+        case MessageEncoding::Cbor:
+            writeHeader(CborMap, nEntries);
+            break;
+        case MessageEncoding::MessagePack:
+            if (nEntries < 16) {
+                _buffer.push_back(static_cast<char>(0x80 | nEntries));
+            }
+            else if (nEntries <= 0xffff) {
+                _buffer.push_back(static_cast<char>(MsgPackMap16));
+                appendBigEndian(_buffer, nEntries, 2);
+            }
+            else {
+                _buffer.push_back(static_cast<char>(MsgPackMap32));
+                appendBigEndian(_buffer, nEntries, 4);
+            }
+            break;
+    }
+}
+
+void StreamingSerializer::endObject() {
+    if (_encoding == MessageEncoding::Json) {
+        ghoul_assert(!_isFirstInContainer.empty(), "No open object");
+        _buffer.push_back('}');
+        _isFirstInContainer.pop_back();
+    }
+}
+
+void StreamingSerializer::beginArray(size_t nElements) {
+    prepareValue();
+    switch (_encoding) {
+        case MessageEncoding::Json:
+            _buffer.push_back('[');
+            _isFirstInContainer.push_back(true);
+            break;
+        case MessageEncoding::Cbor:
+            writeHeader(CborArray, nElements);
+            break;
+        case MessageEncoding::MessagePack:
+            if (nElements < 16) {
+                _buffer.push_back(static_cast<char>(0x90 | nElements));
+            }
+            else if (nElements <= 0xffff) {
+                _buffer.push_back(static_cast<char>(MsgPackArray16));
+                appendBigEndian(_buffer, nElements, 2);
+            }
+            else {
+                _buffer.push_back(static_cast<char>(MsgPackArray32));
+                appendBigEndian(_buffer, nElements, 4);
+            }
+            break;
+    }
+}
+
+void StreamingSerializer::endArray() {
+    if (_encoding == MessageEncoding::Json) {
+        ghoul_assert(!_isFirstInContainer.empty(), "No open array");
+        _buffer.push_back(']');
+        _isFirstInContainer.pop_back();
+    }
+}
+
+void StreamingSerializer::key(std::string_view key) {
+    ghoul_assert(!_hasKey, "Key must be followed by a value");
+    prepareValue();
+    writeString(key);
+    if (_encoding == MessageEncoding::Json) {
+        _buffer.push_back(':');
+    }
+    _hasKey = true;
+}
+
+void StreamingSerializer::stringValue(std::string_view value) {
+    prepareValue();
+    writeString(value);
+}
+
+void StreamingSerializer::value(const nlohmann::json& value) {
+    prepareValue();
+    switch (_encoding) {
+        case MessageEncoding::Json:
+            _buffer += value.dump();
+            break;
+        case MessageEncoding::Cbor:
+            nlohmann::json::to_cbor(value, _buffer);
+            break;
+        case MessageEncoding::MessagePack:
+            nlohmann::json::to_msgpack(value, _buffer);
+            break;
+    }
+}
+
+void StreamingSerializer::jsonText(std::string_view text) {
+    if (_encoding == MessageEncoding::Json) {
+        prepareValue();
+        _buffer += text;
+    }
+    else {
+        value(nlohmann::json::parse(text));
+    }
+}
+
+MessageEncoding StreamingSerializer::encoding() const {
+    return _encoding;
+}
+
+std::string StreamingSerializer::finish() {
+    ghoul_assert(_isFirstInContainer.empty(), "Unclosed object or array");
+    std::string result = std::move(_buffer);
+    _buffer.clear();
+    _hasKey = false;
+    return result;
+}
+
+void StreamingSerializer::prepareValue() {
+    if (_hasKey) {
+        // The value belongs to the key that was just written
+        _hasKey = false;
+        return;
+    }
+    if (_encoding == MessageEncoding::Json && !_isFirstInContainer.empty()) {
+        if (!_isFirstInContainer.back()) {
+            _buffer.push_back(',');
+        }
+        _isFirstInContainer.back() = false;
+    }
+}
+
+void StreamingSerializer::writeHeader(unsigned char major, size_t n) {
+    ghoul_assert(_encoding == MessageEncoding::Cbor, "Only used for CBOR");
+
+    const unsigned char type = static_cast<unsigned char>(major << 5);
+    if (n < 24) {
+        _buffer.push_back(static_cast<char>(type | n));
+    }
+    else if (n <= 0xff) {
+        _buffer.push_back(static_cast<char>(type | 24));
+        appendBigEndian(_buffer, n, 1);
+    }
+    else if (n <= 0xffff) {
+        _buffer.push_back(static_cast<char>(type | 25));
+        appendBigEndian(_buffer, n, 2);
+    }
+    else if (n <= 0xffffffff) {
+        _buffer.push_back(static_cast<char>(type | 26));
+        appendBigEndian(_buffer, n, 4);
+    }
+    else {
+        _buffer.push_back(static_cast<char>(type | 27));
+        appendBigEndian(_buffer, n, 8);
+    }
+}
+
+void StreamingSerializer::writeString(std::string_view string) {
+    const size_t n = string.size();
+    switch (_encoding) {
+        case MessageEncoding::Json:
+            _buffer += nlohmann::json(std::string(string)).dump();
+            return;
+        case MessageEncoding::Cbor:
+            writeHeader(CborTextString, n);
+            break;
+        case MessageEncoding::MessagePack:
+            if (n < 32) {
+                _buffer.push_back(static_cast<char>(0xa0 | n));
+            }
+            else if (n <= 0xff) {
+                _buffer.push_back(static_cast<char>(MsgPackStr8));
+                appendBigEndian(_buffer, n, 1);
+            }
+            else if (n <= 0xffff) {
+                _buffer.push_back(static_cast<char>(MsgPackStr16));
+                appendBigEndian(_buffer, n, 2);
+            }
+            else {
+                _buffer.push_back(static_cast<char>(MsgPackStr32));
+                appendBigEndian(_buffer, n, 4);
+            }
+            break;
+    }
+    _buffer += string;
+}
+
+void serialize(StreamingSerializer& serializer, const properties::Property& prop) {
+    serializer.beginObject(2);
+
+    serializer.key("Description");
+    std::string description = prop.generateJsonDescription();
+    if (serializer.encoding() == MessageEncoding::Json) {
+        // The description is a JSON object into which the free-text description of the
+        // property is spliced before the closing brace
+        ghoul_assert(description.back() == '}', "Description must be a JSON object");
+        description.pop_back();
+        description += ",\"description\":";
+        description += nlohmann::json(prop.description()).dump();
+        description.push_back('}');
+        serializer.jsonText(description);
+    }
+    else {
+        nlohmann::json desc = nlohmann::json::parse(description);
+        desc["description"] = prop.description();
+        serializer.value(desc);
+    }
+
+    serializer.key("Value");
+    serializer.jsonText(prop.jsonValue());
+
+    serializer.endObject();
+}
+
+void serialize(StreamingSerializer& serializer, const properties::PropertyOwner& owner) {
+    // The keys are written in the same, sorted order that nlohmann::json uses
+    serializer.beginObject(6);
+
+    serializer.key("description");
+    serializer.stringValue(owner.description());
+    serializer.key("guiName");
+    serializer.stringValue(owner.guiName());
+    serializer.key("identifier");
+    serializer.stringValue(owner.identifier());
+
+    serializer.key("properties");
+    const std::vector<properties::Property*>& props = owner.properties();
+    serializer.beginArray(props.size());
+    for (const properties::Property* prop : props) {
+        serialize(serializer, *prop);
+    }
+    serializer.endArray();
+
+    serializer.key("subowners");
+    const std::vector<properties::PropertyOwner*>& subowners = owner.propertySubOwners();
+    serializer.beginArray(subowners.size());
+    for (const properties::PropertyOwner* subowner : subowners) {
+        serialize(serializer, *subowner);
+    }
+    serializer.endArray();
+
+    serializer.key("tag");
+    const std::vector<std::string>& tags = owner.tags();
+    serializer.beginArray(tags.size());
+    for (const std::string& tag : tags) {
+        serializer.stringValue(tag);
+    }
+    serializer.endArray();
+
+    serializer.endObject();
+}
+
+} // namespace openspace
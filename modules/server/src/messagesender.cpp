@@ -0,0 +1,120 @@
+/*****************************************************************************************
+ *                                                                                       *
+ * OpenSpace                                                                             *
+ *                                                                                       *
+ * Copyright (c) 2014-2023                                                               *
+ *                                                                                       *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this  *
+ * software and associated documentation files (the "Software"), to deal in the Software *
+ * without restriction, including without limitation the rights to use, copy, modify,    *
+ * merge, publish, distribute, sublicense, and/or sell copies of the Software, and to    *
+ * permit persons to whom the Software is furnished to do so, subject to the following   *
+ * conditions:                                                                           *
+ *                                                                                       *
+ * The above copyright notice and this permission notice shall be included in all copies *
+ * or substantial portions of the Software.                                              *
+ *                                                                                       *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,   *
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A         *
+ * PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT    *
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF  *
+ * CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE  *
+ * OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                                         *
+ ****************************************************************************************/
+
+
+#include <modules/server/include/messagesender.h>
+
+#include <ghoul/fmt.h>
+#include <ghoul/io/socket/socket.h>
+#include <ghoul/logging/logmanager.h>
+#include <ghoul/misc/profiling.h>
+
+namespace {
+    constexpr std::string_view _loggerCat = "ServerModule: MessageSender";
+} // namespace
+
+namespace openspace {
+
+MessageSender::MessageSender() {
+    _thread = std::thread([this]() { run(); });
+}
+
+MessageSender::~MessageSender() {
+    {
+        std::lock_guard lock(_mutex);
+        _shouldStop = true;
+    }
+    _condition.notify_one();
+    if (_thread.joinable()) {
+        _thread.join();
+    }
+}
+
+void MessageSender::send(std::vector<Batch> batches) {
+    ZoneScoped;
+
+    {
+        std::lock_guard lock(_mutex);
+        if (_queue.empty()) {
+            _queue = std::move(batches);
+        }
+        else {
+            std::move(batches.begin(), batches.end(), std::back_inserter(_queue));
+        }
+    }
+    _condition.notify_one();
+}
+
+void MessageSender::run() {
+    std::vector<Batch> batches;
+    std::string joined;
+    while (true) {
+        {
+            std::unique_lock lock(_mutex);
+            _condition.wait(lock, [this]() { return _shouldStop || !_queue.empty(); });
+            if (_shouldStop) {
+                return;
+            }
+            std::swap(batches, _queue);
+        }
+
+        for (Batch& batch : batches) {
+            ZoneScopedN("Send batch");
+
+            if (!batch.socket || !batch.writeMutex || !batch.socket->isConnected()) {
+                continue;
+            }
+
+            joined.clear();
+            for (const JsonGenerator& generator : batch.messages) {
+                std::string message;
+                try {
+                    message = encodeMessage(generator(), batch.encoding);
+                }
+                catch (const std::exception& e) {
+                    LERROR(fmt::format("Error creating message: {}", e.what()));
+                    continue;
+                }
+
+                if (batch.joinMessages) {
+                    if (!joined.empty()) {
+                        joined += '\n';
+                    }
+                    joined += message;
+                }
+                else {
+                    std::lock_guard writeLock(*batch.writeMutex);
+                    batch.socket->putMessage(message);
+                }
+            }
+            if (batch.joinMessages && !joined.empty()) {
+                std::lock_guard writeLock(*batch.writeMutex);
+                batch.socket->putMessage(joined);
+            }
+        }
+        batches.clear();
+    }
+}
+
+} // namespace openspace
@@ -0,0 +1,65 @@
+/*****************************************************************************************
+ *                                                                                       *
+ * OpenSpace                                                                             *
+ *                                                                                       *
+ * Copyright (c) 2014-2023                                                               *
+ *                                                                                       *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this  *
+ * software and associated documentation files (the "Software"), to deal in the Software *
+ * without restriction, including without limitation the rights to use, copy, modify,    *
+ * merge, publish, distribute, sublicense, and/or sell copies of the Software, and to    *
+ * permit persons to whom the Software is furnished to do so, subject to the following   *
+ * conditions:                                                                           *
+ *                                                                                       *
+ * The above copyright notice and this permission notice shall be included in all copies *
+ * or substantial portions of the Software.                                              *
+ *                                                                                       *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,   *
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A         *
+ * PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT    *
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF  *
+ * CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE  *
+ * OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                                         *
+ ****************************************************************************************/
+
+
+#include <modules/server/include/topics/encodingtopic.h>
+
+#include <modules/server/include/connection.h>
+#include <ghoul/fmt.h>
+#include <ghoul/logging/logmanager.h>
+
+namespace {
+    constexpr std::string_view _loggerCat = "EncodingTopic";
+} // namespace
+
+namespace openspace {
+
+bool EncodingTopic::isDone() const {
+    return true;
+}
+
+void EncodingTopic::handleJson(const nlohmann::json& json) {
+    const std::string name = json.at("encoding").get<std::string>();
+
+    std::optional<MessageEncoding> encoding = messageEncodingFromString(name);
+    if (!encoding.has_value()) {
+        LERROR(fmt::format("Unknown encoding '{}'", name));
+        _connection->sendJson(
+            wrappedError(fmt::format("Unknown encoding '{}'", name), 400)
+        );
+        return;
+    }
+
+    if (*encoding != MessageEncoding::Json && !_connection->supportsBinaryEncoding()) {
+        _connection->sendJson(wrappedError(
+            fmt::format("Encoding '{}' is not supported on this connection", name), 400
+        ));
+        return;
+    }
+
+    _connection->sendJson(wrappedPayload({ { "encoding", name } }));
+    _connection->setEncoding(*encoding);
+}
+
+} // namespace openspace
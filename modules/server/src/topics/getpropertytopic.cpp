@@ -26,6 +26,7 @@
 
 #include <modules/server/include/connection.h>
 #include <modules/server/include/jsonconverters.h>
+#include <modules/server/include/messageencoding.h>
 #include <modules/volume/transferfunctionhandler.h>
 #include <openspace/engine/globals.h>
 #include <openspace/engine/windowdelegate.h>
@@ -37,6 +38,8 @@
 #include <openspace/rendering/screenspacerenderable.h>
 #include <openspace/scene/scene.h>
 #include <ghoul/logging/logmanager.h>
+#include <ghoul/misc/profiling.h>
+#include <array>
 
 using nlohmann::json;
 
@@ -56,7 +59,8 @@ void GetPropertyTopic::handleJson(const nlohmann::json& json) {
     LDEBUG("Getting property '" + requestedKey + "'...");
     nlohmann::json response;
     if (requestedKey == AllPropertiesValue) {
-        response = allProperties();
+        _connection->sendMessage(allProperties());
+        return;
     }
     else if (requestedKey == AllNodesValue) {
         response = wrappedPayload(sceneGraph()->allSceneGraphNodes());
@@ -67,7 +71,8 @@ void GetPropertyTopic::handleJson(const nlohmann::json& json) {
         });
     }
     else if (requestedKey == RootPropertyOwner) {
-        response = wrappedPayload(global::rootPropertyOwner);
+        _connection->sendMessage(propertyOwner(*global::rootPropertyOwner));
+        return;
     }
     else {
         response = propertyFromKey(requestedKey);
@@ -79,19 +84,46 @@ bool GetPropertyTopic::isDone() const {
     return true;
 }
 
-json GetPropertyTopic::allProperties() {
-    json payload {
-        {
-            "value",
-            {
-                global::renderEngine,
-                global::luaConsole,
-                global::parallelPeer,
-                global::navigationHandler
-            }
-        }
+std::string GetPropertyTopic::allProperties() {
+    ZoneScoped;
+
+    // The property tree can contain many thousands of properties, so the message is
+    // serialized directly rather than building the whole document in memory first
+    const std::array<const properties::PropertyOwner*, 4> owners = {
+        global::renderEngine,
+        global::luaConsole,
+        global::parallelPeer,
+        global::navigationHandler
     };
-    return wrappedPayload(payload);
+
+    StreamingSerializer serializer(_connection->encoding());
+    serializer.beginObject(2);
+    serializer.key("payload");
+    serializer.beginObject(1);
+    serializer.key("value");
+    serializer.beginArray(owners.size());
+    for (const properties::PropertyOwner* owner : owners) {
+        serialize(serializer, *owner);
+    }
+    serializer.endArray();
+    serializer.endObject();
+    serializer.key("topic");
+    serializer.value(_topicId);
+    serializer.endObject();
+    return frameMessage(serializer.finish(), serializer.encoding());
+}
+
+std::string GetPropertyTopic::propertyOwner(const properties::PropertyOwner& owner) {
+    ZoneScoped;
+
+    StreamingSerializer serializer(_connection->encoding());
+    serializer.beginObject(2);
+    serializer.key("payload");
+    serialize(serializer, owner);
+    serializer.key("topic");
+    serializer.value(_topicId);
+    serializer.endObject();
+    return frameMessage(serializer.finish(), serializer.encoding());
 }
 
 json GetPropertyTopic::propertyFromKey(const std::string& key) {
@@ -26,17 +26,24 @@
 
 #include <modules/server/include/connection.h>
 #include <modules/server/include/jsonconverters.h>
+#include <modules/server/servermodule.h>
+#include <openspace/engine/globals.h>
+#include <openspace/engine/moduleengine.h>
 #include <openspace/properties/property.h>
 #include <openspace/query/query.h>
 #include <openspace/util/timemanager.h>
 #include <ghoul/fmt.h>
 #include <ghoul/logging/logmanager.h>
+#include <ghoul/misc/profiling.h>
 
 namespace {
     constexpr std::string_view _loggerCat = "SubscriptionTopic";
 
     constexpr std::string_view StartSubscription = "start_subscription";
     constexpr std::string_view StopSubscription = "stop_subscription";
+
+    // Optional maximum number of updates per second that the client wants to receive
+    constexpr std::string_view MaxRate = "maxRate";
 } // namespace
 
 using nlohmann::json;
@@ -52,6 +59,13 @@ bool SubscriptionTopic::isDone() const {
 }
 
 void SubscriptionTopic::resetCallbacks() {
+    if (_preSyncHandle != UnsetCallbackHandle) {
+        ServerModule* module = global::moduleEngine->module<ServerModule>();
+        if (module) {
+            module->removePreSyncCallback(_preSyncHandle);
+        }
+        _preSyncHandle = UnsetCallbackHandle;
+    }
     if (!_prop) {
         return;
     }
@@ -77,19 +91,36 @@ void SubscriptionTopic::handleJson(const nlohmann::json& json) {
         if (_prop) {
             _requestedResourceIsSubscribable = true;
             _isSubscribedTo = true;
-            auto onChange = [this, k = std::move(key)]() {
-                _connection->sendJson(wrappedPayload(_prop));
-            };
 
-            _onChangeHandle = _prop->onChange(onChange);
+            auto maxRate = json.find(MaxRate);
+            if (maxRate != json.end() && maxRate->is_number() && *maxRate > 0.0) {
+                _minimumInterval =
+                    std::chrono::duration_cast<std::chrono::steady_clock::duration>(
+                        std::chrono::duration<double>(1.0 / maxRate->get<double>())
+                    );
+            }
+
+            _onChangeHandle = _prop->onChange([this]() { _hasChanged = true; });
             _onDeleteHandle = _prop->onDelete([this]() {
                 _onChangeHandle = UnsetCallbackHandle;
                 _onDeleteHandle = UnsetCallbackHandle;
                 _isSubscribedTo = false;
+                _hasChanged = false;
+            });
+
+            ServerModule* module = global::moduleEngine->module<ServerModule>();
+            _preSyncHandle = module->addPreSyncCallback([this]() {
+                if (!_hasChanged || !_isSubscribedTo) {
+                    return;
+                }
+                const auto now = std::chrono::steady_clock::now();
+                if (now - _lastSendTime >= _minimumInterval) {
+                    queueValue();
+                }
             });
 
             // immediately send the value
-            onChange();
+            queueValue();
         }
         else {
             LWARNING(fmt::format("Could not subscribe. Property '{}' not found", key));
@@ -108,4 +139,30 @@ void SubscriptionTopic::handleJson(const nlohmann::json& json) {
     }
 }
 
+void SubscriptionTopic::queueValue() {
+    ZoneScoped;
+
+    // Only the strings are captured here as the property must be accessed on the main
+    // thread. Parsing and building the message happens on the sender thread
+    _connection->queueJson(
+        [topicId = _topicId, description = _prop->generateJsonDescription(),
+         value = _prop->jsonValue(), text = _prop->description()]()
+        {
+            nlohmann::json desc = nlohmann::json::parse(description);
+            desc["description"] = text;
+            return nlohmann::json({
+                { "topic", topicId },
+                {
+                    "payload", {
+                        { "Description", std::move(desc) },
+                        { "Value", nlohmann::json::parse(value) }
+                    }
+                }
+            });
+        }
+    );
+    _hasChanged = false;
+    _lastSendTime = std::chrono::steady_clock::now();
+}
+
 } // namespace openspace
@@ -0,0 +1,150 @@
+/*****************************************************************************************
+ *                                                                                       *
+ * OpenSpace                                                                             *
+ *                                                                                       *
+ * Copyright (c) 2014-2023                                                               *
+ *                                                                                       *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this  *
+ * software and associated documentation files (the "Software"), to deal in the Software *
+ * without restriction, including without limitation the rights to use, copy, modify,    *
+ * merge, publish, distribute, sublicense, and/or sell copies of the Software, and to    *
+ * permit persons to whom the Software is furnished to do so, subject to the following   *
+ * conditions:                                                                           *
+ *                                                                                       *
+ * The above copyright notice and this permission notice shall be included in all copies *
+ * or substantial portions of the Software.                                              *
+ *                                                                                       *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,   *
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A         *
+ * PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT    *
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF  *
+ * CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE  *
+ * OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                                         *
+ ****************************************************************************************/
+
+
+#include <modules/space/fluxnodesstates.h>
+
+#include <ghoul/fmt.h>
+#include <ghoul/misc/assert.h>
+#include <ghoul/misc/exception.h>
+#include <cstring>
+#include <fstream>
+
+namespace {
+    struct Header {
+        uint32_t nNodesPerState = 0;
+        uint32_t nStates = 0;
+    };
+
+    void requireSize(const std::filesystem::path& path, size_t size, size_t expected) {
+        if (size < expected) {
+            throw ghoul::RuntimeError(fmt::format(
+                "File {} contains {} bytes, but {} bytes were expected",
+                path, size, expected
+            ));
+        }
+    }
+
+    void readFile(const std::filesystem::path& path, size_t offset, char* destination,
+                  size_t size)
+    {
+        std::ifstream file(path, std::ifstream::binary);
+        if (!file.good()) {
+            throw ghoul::RuntimeError(fmt::format("Could not read file {}", path));
+        }
+        file.seekg(offset);
+        file.read(destination, size);
+        requireSize(path, offset + static_cast<size_t>(file.gcount()), offset + size);
+    }
+} // namespace
+
+namespace openspace {
+
+FluxNodesStates::FluxNodesStates(const std::filesystem::path& positionsFile,
+                                 const std::filesystem::path& fluxesFile,
+                                 const std::filesystem::path& radiiFile, bool memoryMap)
+{
+    Header header;
+    if (memoryMap) {
+        _files.reserve(3);
+        _files.emplace_back(positionsFile);
+        _files.emplace_back(fluxesFile);
+        _files.emplace_back(radiiFile);
+        requireSize(positionsFile, _files[0].size(), sizeof(Header));
+        std::memcpy(&header, _files[0].data(), sizeof(Header));
+    }
+    else {
+        readFile(positionsFile, 0, reinterpret_cast<char*>(&header), sizeof(Header));
+    }
+
+    _nStates = header.nStates;
+    _nNodesPerState = header.nNodesPerState;
+    const size_t nValues = _nStates * _nNodesPerState;
+    const size_t positionsSize = nValues * sizeof(glm::vec3);
+    const size_t valuesSize = nValues * sizeof(float);
+
+    if (memoryMap) {
+        requireSize(positionsFile, _files[0].size(), sizeof(Header) + positionsSize);
+        requireSize(fluxesFile, _files[1].size(), valuesSize);
+        requireSize(radiiFile, _files[2].size(), valuesSize);
+
+        const char* positions = _files[0].data() + sizeof(Header);
+        _positions = reinterpret_cast<const glm::vec3*>(positions);
+        _fluxes = reinterpret_cast<const float*>(_files[1].data());
+        _radii = reinterpret_cast<const float*>(_files[2].data());
+    }
+    else {
+        // Three floats per position followed by one flux and one radius value
+        _data.resize(5 * nValues);
+        float* positions = _data.data();
+        float* fluxes = positions + 3 * nValues;
+        float* radii = fluxes + nValues;
+
+        readFile(
+            positionsFile,
+            sizeof(Header),
+            reinterpret_cast<char*>(positions),
+            positionsSize
+        );
+        readFile(fluxesFile, 0, reinterpret_cast<char*>(fluxes), valuesSize);
+        readFile(radiiFile, 0, reinterpret_cast<char*>(radii), valuesSize);
+
+        _positions = reinterpret_cast<const glm::vec3*>(positions);
+        _fluxes = fluxes;
+        _radii = radii;
+    }
+}
+
+size_t FluxNodesStates::nStates() const {
+    return _nStates;
+}
+
+size_t FluxNodesStates::nNodesPerState() const {
+    return _nNodesPerState;
+}
+
+std::span<const glm::vec3> FluxNodesStates::positions(size_t state) const {
+    ghoul_assert(state < _nStates, "State index out of bounds");
+    return { _positions + state * _nNodesPerState, _nNodesPerState };
+}
+
+std::span<const float> FluxNodesStates::fluxes(size_t state) const {
+    ghoul_assert(state < _nStates, "State index out of bounds");
+    return { _fluxes + state * _nNodesPerState, _nNodesPerState };
+}
+
+std::span<const float> FluxNodesStates::radii(size_t state) const {
+    ghoul_assert(state < _nStates, "State index out of bounds");
+    return { _radii + state * _nNodesPerState, _nNodesPerState };
+}
+
+size_t FluxNodesStates::sizeInBytes() const {
+    return _nStates * _nNodesPerState * (sizeof(glm::vec3) + 2 * sizeof(float));
+}
+
+bool FluxNodesStates::isMemoryMapped() const {
+    return !_files.empty();
+}
+
+} // namespace openspace
@@ -0,0 +1,101 @@
+/*****************************************************************************************
+ *                                                                                       *
+ * OpenSpace                                                                             *
+ *                                                                                       *
+ * Copyright (c) 2014-2023                                                               *
+ *                                                                                       *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this  *
+ * software and associated documentation files (the "Software"), to deal in the Software *
+ * without restriction, including without limitation the rights to use, copy, modify,    *
+ * merge, publish, distribute, sublicense, and/or sell copies of the Software, and to    *
+ * permit persons to whom the Software is furnished to do so, subject to the following   *
+ * conditions:                                                                           *
+ *                                                                                       *
+ * The above copyright notice and this permission notice shall be included in all copies *
+ * or substantial portions of the Software.                                              *
+ *                                                                                       *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,   *
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A         *
+ * PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT    *
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF  *
+ * CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE  *
+ * OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                                         *
+ ****************************************************************************************/
+
+
+#ifndef __OPENSPACE_MODULE_SPACE___FLUXNODESSTATES___H__
+#define __OPENSPACE_MODULE_SPACE___FLUXNODESSTATES___H__
+
+#include <openspace/util/memorymappedfile.h>
+#include <ghoul/glm.h>
+#include <filesystem>
+#include <span>
+#include <vector>
+
+namespace openspace {
+
+/**
+ * The node positions, flux values, and radii of all time steps of a flux nodes sequence.
+ * The data is read from three binary files. The positions file starts with the number of
+ * nodes per time step and the number of time steps as two `uint32_t` followed by the
+ * positions of all time steps, whereas the flux and radius files only contain one
+ * `float` value per node and time step.
+ *
+ * All time steps are stored back-to-back in a single block of memory, or are accessed
+ * directly in the memory mapped files, and the values for a single time step are
+ * returned as views into that memory without copying them.
+ */
+class FluxNodesStates {
+public:
+    /**
+     * Loads the node data from the provided files.
+     *
+     * \param positionsFile The file containing the header and the node positions
+     * \param fluxesFile The file containing the flux values of the nodes
+     * \param radiiFile The file containing the radii of the nodes
+     * \param memoryMap If `true`, the files are mapped into memory instead of being read
+     *        in their entirety, so only the time steps that are accessed are loaded
+     *
+     * \throw ghoul::RuntimeError If one of the files cannot be read or is smaller than
+     *        what is specified in the header of the \p positionsFile
+     */
+    FluxNodesStates(const std::filesystem::path& positionsFile,
+        const std::filesystem::path& fluxesFile, const std::filesystem::path& radiiFile,
+        bool memoryMap);
+
+    FluxNodesStates(const FluxNodesStates&) = delete;
+    FluxNodesStates& operator=(const FluxNodesStates&) = delete;
+
+    size_t nStates() const;
+    size_t nNodesPerState() const;
+
+    std::span<const glm::vec3> positions(size_t state) const;
+    std::span<const float> fluxes(size_t state) const;
+    std::span<const float> radii(size_t state) const;
+
+    /**
+     * Returns the size of the node data of all time steps in bytes. If the files are
+     * memory mapped, only the parts that have been accessed are actually held in memory.
+     */
+    size_t sizeInBytes() const;
+
+    bool isMemoryMapped() const;
+
+private:
+    size_t _nStates = 0;
+    size_t _nNodesPerState = 0;
+
+    // Only used if the files are memory mapped, in the order positions, fluxes, radii
+    std::vector<MemoryMappedFile> _files;
+    // Only used if the files are read into memory. Contains the positions of all time
+    // steps followed by the fluxes and radii of all time steps
+    std::vector<float> _data;
+
+    const glm::vec3* _positions = nullptr;
+    const float* _fluxes = nullptr;
+    const float* _radii = nullptr;
+};
+
+} // namespace openspace
+
+#endif // __OPENSPACE_MODULE_SPACE___FLUXNODESSTATES___H__
@@ -1,4 +1,5 @@
 set(DEFAULT_MODULE ON)
 set (OPENSPACE_DEPENDENCIES
   base
+  volume
 )
@@ -24,19 +24,22 @@
 
 #include <modules/space/kepler.h>
 
-#include <ghoul/filesystem/cachemanager.h>
+#include <openspace/util/cachefiles.h>
 #include <ghoul/filesystem/filesystem.h>
 #include <ghoul/logging/logmanager.h>
 #include <ghoul/misc/misc.h>
 #include <scn/scn.h>
 #include <scn/tuple_return.h>
 #include <fstream>
+#include <future>
+#include <map>
+#include <mutex>
 #include <optional>
 #include <sstream>
 
 namespace {
     constexpr std::string_view _loggerCat = "Kepler";
-    constexpr int8_t CurrentCacheVersion = 1;
+    constexpr int8_t CurrentCacheVersion = 2;
 
     // The list of leap years only goes until 2056 as we need to touch this file then
     // again anyway ;)
@@ -425,6 +428,8 @@ std::vector<Parameters> readTleFile(std::filesystem::path file) {
                 "Malformed TLE file '{}' at line {}", file, lineNum + 1
             ));
         }
+        p.noradId = std::atoi(firstLine.substr(2, 5).c_str());
+
         // The id only contains the last two digits of the launch year, so we have to
         // patch it to the full year
         {
@@ -559,6 +564,9 @@ std::vector<Parameters> readOmmFile(std::filesystem::path file) {
         else if (parts[0] == "OBJECT_ID") {
             current->id = parts[1];
         }
+        else if (parts[0] == "NORAD_CAT_ID") {
+            current->noradId = std::stoi(parts[1]);
+        }
         else if (parts[0] == "EPOCH") {
             current->epoch = epochFromOmmString(parts[1]);
         }
@@ -674,6 +682,9 @@ void saveCache(const std::vector<Parameters>& params, std::filesystem::path file
         stream.write(reinterpret_cast<const char*>(&idLength), sizeof(uint32_t));
         stream.write(param.id.data(), idLength * sizeof(char));
 
+        int32_t noradId = static_cast<int32_t>(param.noradId);
+        stream.write(reinterpret_cast<const char*>(&noradId), sizeof(int32_t));
+
         stream.write(reinterpret_cast<const char*>(&param.inclination), sizeof(double));
         stream.write(reinterpret_cast<const char*>(&param.semiMajorAxis), sizeof(double));
         stream.write(reinterpret_cast<const char*>(&param.ascendingNode), sizeof(double));
@@ -715,6 +726,10 @@ std::optional<std::vector<Parameters>> loadCache(std::filesystem::path file) {
         param.id.resize(idLength);
         stream.read(param.id.data(), idLength * sizeof(char));
 
+        int32_t noradId = 0;
+        stream.read(reinterpret_cast<char*>(&noradId), sizeof(int32_t));
+        param.noradId = noradId;
+
         stream.read(reinterpret_cast<char*>(&param.inclination), sizeof(double));
         stream.read(reinterpret_cast<char*>(&param.semiMajorAxis), sizeof(double));
         stream.read(reinterpret_cast<char*>(&param.ascendingNode), sizeof(double));
@@ -731,7 +746,16 @@ std::optional<std::vector<Parameters>> loadCache(std::filesystem::path file) {
 }
 
 std::vector<Parameters> readFile(std::filesystem::path file, Format format) {
-    std::filesystem::path cachedFile = FileSys.cacheManager()->cachedFilename(file);
+    // The same file might be read with different formats and the cache has to be
+    // invalidated whenever the file changes
+    std::filesystem::path cachedFile = cachedFilename(
+        file,
+        fmt::format(
+            "{}|{}",
+            static_cast<int>(format),
+            std::filesystem::last_write_time(file).time_since_epoch().count()
+        )
+    );
     if (std::filesystem::is_regular_file(cachedFile)) {
         LINFO(fmt::format(
             "Cached file {} used for Kepler file {}", cachedFile, file
@@ -765,4 +789,97 @@ std::vector<Parameters> readFile(std::filesystem::path file, Format format) {
     return res;
 }
 
+Catalog::Catalog(std::vector<Parameters> parameters)
+    : _parameters(std::move(parameters))
+{
+    _nameIndex.reserve(_parameters.size());
+    _idIndex.reserve(_parameters.size());
+    _noradIdIndex.reserve(_parameters.size());
+    for (size_t i = 0; i < _parameters.size(); i++) {
+        const Parameters& p = _parameters[i];
+        // emplace does not overwrite existing entries, so the first object wins
+        _nameIndex.emplace(p.name, i);
+        if (!p.id.empty()) {
+            _idIndex.emplace(p.id, i);
+        }
+        if (p.noradId != 0) {
+            _noradIdIndex.emplace(p.noradId, i);
+        }
+    }
+}
+
+const std::vector<Parameters>& Catalog::parameters() const {
+    return _parameters;
+}
+
+const Parameters* Catalog::findByName(std::string_view name) const {
+    auto it = _nameIndex.find(name);
+    return it != _nameIndex.end() ? &_parameters[it->second] : nullptr;
+}
+
+const Parameters* Catalog::findById(std::string_view id) const {
+    auto it = _idIndex.find(id);
+    return it != _idIndex.end() ? &_parameters[it->second] : nullptr;
+}
+
+const Parameters* Catalog::findByNoradId(int noradId) const {
+    auto it = _noradIdIndex.find(noradId);
+    return it != _noradIdIndex.end() ? &_parameters[it->second] : nullptr;
+}
+
+std::shared_ptr<const Catalog> loadCatalog(std::filesystem::path file, Format format) {
+    ghoul_assert(std::filesystem::is_regular_file(file), "File must exist");
+
+    struct Entry {
+        std::filesystem::file_time_type lastModified;
+        std::shared_future<std::shared_ptr<const Catalog>> catalog;
+    };
+    static std::mutex Mutex;
+    static std::map<std::pair<std::string, Format>, Entry> Catalogs;
+
+    const std::pair<std::string, Format> key = {
+        std::filesystem::weakly_canonical(file).string(),
+        format
+    };
+    const std::filesystem::file_time_type lastModified =
+        std::filesystem::last_write_time(file);
+
+    // Only the first caller reads the file. Everyone else waits for its result, which
+    // happens outside of the lock so that different files can be loaded concurrently
+    std::promise<std::shared_ptr<const Catalog>> promise;
+    std::shared_future<std::shared_ptr<const Catalog>> catalog;
+    bool isLoading = false;
+    {
+        std::lock_guard lock(Mutex);
+        auto it = Catalogs.find(key);
+        if (it != Catalogs.end() && it->second.lastModified == lastModified) {
+            catalog = it->second.catalog;
+        }
+        else {
+            catalog = promise.get_future().share();
+            Catalogs[key] = { lastModified, catalog };
+            isLoading = true;
+        }
+    }
+
+    if (isLoading) {
+        try {
+            promise.set_value(std::make_shared<const Catalog>(readFile(file, format)));
+        }
+        catch (...) {
+            // Remove the entry so that the next request tries to load the file again
+            {
+                std::lock_guard lock(Mutex);
+                auto it = Catalogs.find(key);
+                if (it != Catalogs.end() && it->second.lastModified == lastModified) {
+                    Catalogs.erase(it);
+                }
+            }
+            promise.set_exception(std::current_exception());
+        }
+    }
+
+    return catalog.get();
+}
+
 } // namespace openspace::kepler
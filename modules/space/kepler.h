@@ -26,7 +26,10 @@
 #define __OPENSPACE_MODULE_SPACE___KEPLER___H__
 
 #include <filesystem>
+#include <memory>
 #include <string>
+#include <string_view>
+#include <unordered_map>
 #include <vector>
 
 namespace openspace::kepler {
@@ -38,6 +41,9 @@ struct Parameters {
     // Some form of unique identifier for the object represented by this data
     std::string id;
 
+    // The NORAD catalog number of the object or 0 if the file does not provide it
+    int noradId = 0;
+
     double inclination = 0.0;
     double semiMajorAxis = 0.0;
     double ascendingNode = 0.0;
@@ -105,6 +111,56 @@ enum class Format {
  */
 std::vector<Parameters> readFile(std::filesystem::path file, Format format);
 
+/**
+ * The objects that were read from a single file, together with indices that make it
+ * possible to look up individual objects by their name, identifier, or NORAD catalog
+ * number in constant time. If multiple objects share the same key, the first of them is
+ * returned.
+ */
+class Catalog {
+public:
+    explicit Catalog(std::vector<Parameters> parameters);
+
+    // The indices refer to the strings owned by the parameters
+    Catalog(const Catalog&) = delete;
+    Catalog& operator=(const Catalog&) = delete;
+
+    /// Returns all objects in the order in which they appear in the file
+    const std::vector<Parameters>& parameters() const;
+
+    /// Returns the object with the provided \p name or `nullptr` if there is none
+    const Parameters* findByName(std::string_view name) const;
+
+    /// Returns the object with the provided \p id or `nullptr` if there is none
+    const Parameters* findById(std::string_view id) const;
+
+    /// Returns the object with the provided \p noradId or `nullptr` if there is none
+    const Parameters* findByNoradId(int noradId) const;
+
+private:
+    std::vector<Parameters> _parameters;
+    std::unordered_map<std::string_view, size_t> _nameIndex;
+    std::unordered_map<std::string_view, size_t> _idIndex;
+    std::unordered_map<int, size_t> _noradIdIndex;
+};
+
+/**
+ * Returns the catalog of all objects in the provided \p file. The catalogs are shared
+ * throughout the application, so a file is only read once, regardless of how many scene
+ * graph nodes request objects from it. A catalog is reloaded if the file has been
+ * modified since it was read. This function can be called from multiple threads
+ * concurrently; callers that request a catalog which is currently being loaded wait for
+ * it instead of reading the file themselves.
+ *
+ * \param file The file containing the information about the objects
+ * \param format The format of the provided \p file
+ * \return The catalog of all objects in the \p file
+ *
+ * \pre \p file must be a file and must exist
+ * \throw ghoul::RuntimeError If the provided \p file is not in the provided \p format
+ */
+std::shared_ptr<const Catalog> loadCatalog(std::filesystem::path file, Format format);
+
 } // namespace openspace::kepler
 
 #endif // __OPENSPACE_MODULE_SPACE___KEPLER___H__
@@ -92,6 +92,24 @@ namespace {
         openspace::properties::Property::Visibility::AdvancedUser
     };
 
+    constexpr openspace::properties::Property::PropertyInfo HideOverlappingInfo = {
+        "HideOverlapping",
+        "Hide Overlapping",
+        "If enabled, labels that would overlap another label on screen are not rendered. "
+        "Labels that are closer to the camera are preferred over labels further away. "
+        "The size of a label on screen is estimated from its text and the label size",
+        openspace::properties::Property::Visibility::AdvancedUser
+    };
+
+    constexpr openspace::properties::Property::PropertyInfo MaxLabelsInfo = {
+        "MaxLabels",
+        "Max Number of Labels",
+        "The maximum number of labels that are rendered at the same time, preferring the "
+        "labels that are closest to the camera. If this value is 0, the number of labels "
+        "is not limited",
+        openspace::properties::Property::Visibility::AdvancedUser
+    };
+
     constexpr openspace::properties::Property::PropertyInfo TransformationMatrixInfo = {
         "TransformationMatrix",
         "Transformation Matrix",
@@ -136,6 +154,12 @@ namespace {
         // [[codegen::verbatim(FaceCameraInfo.description)]]
         std::optional<bool> faceCamera;
 
+        // [[codegen::verbatim(HideOverlappingInfo.description)]]
+        std::optional<bool> hideOverlapping;
+
+        // [[codegen::verbatim(MaxLabelsInfo.description)]]
+        std::optional<int> maxLabels [[codegen::greaterequal(0)]];
+
         // [[codegen::verbatim(TransformationMatrixInfo.description)]]
         std::optional<glm::dmat4x4> transformationMatrix;
     };
@@ -161,6 +185,8 @@ LabelsComponent::LabelsComponent(const ghoul::Dictionary& dictionary)
         glm::ivec2(1000)
     )
     , _faceCamera(FaceCameraInfo, true)
+    , _hideOverlapping(HideOverlappingInfo, false)
+    , _maxLabels(MaxLabelsInfo, 0, 0, 100000)
 {
     const Parameters p = codegen::bake<Parameters>(dictionary);
 
@@ -213,10 +239,19 @@ LabelsComponent::LabelsComponent(const ghoul::Dictionary& dictionary)
     }
     addProperty(_faceCamera);
 
+    _hideOverlapping = p.hideOverlapping.value_or(_hideOverlapping);
+    addProperty(_hideOverlapping);
+
+    _maxLabels = p.maxLabels.value_or(_maxLabels);
+    addProperty(_maxLabels);
+
     _transformationMatrix = p.transformationMatrix.value_or(_transformationMatrix);
 }
 
 speck::Labelset& LabelsComponent::labelSet() {
+    // The caller might change the labels, so the layout has to be updated before the
+    // next time the labels are rendered
+    _layoutIsDirty = true;
     return _labelset;
 }
 
@@ -236,6 +271,7 @@ void LabelsComponent::initialize() {
 void LabelsComponent::loadLabels() {
     LINFO(fmt::format("Loading label file {}", _labelFile));
     _labelset = speck::label::loadFileWithCache(_labelFile);
+    _layoutIsDirty = true;
 }
 
 bool LabelsComponent::isReady() const {
@@ -254,7 +290,6 @@ void LabelsComponent::render(const RenderData& data,
     if (!_enabled) {
         return;
     }
-    float scale = static_cast<float>(toMeter(_unit));
 
     int renderOption = _faceCamera ? RenderOptionFaceCamera : RenderOptionPositionNormal;
 
@@ -273,24 +308,55 @@ void LabelsComponent::render(const RenderData& data,
 
     glm::vec4 textColor = glm::vec4(glm::vec3(_color), opacity() * fadeInVariable);
 
-    for (const speck::Labelset::Entry& e : _labelset.entries) {
-        if (!e.isEnabled) {
-            continue;
-        }
-
-        // Transform and scale the labels
-        glm::vec3 transformedPos(_transformationMatrix * glm::dvec4(e.position, 1.0));
-        glm::vec3 scaledPos(transformedPos);
-        scaledPos *= scale;
+    if (_layoutIsDirty) {
+        updateLayout();
+    }
 
+    LabelLayout::Settings settings;
+    settings.modelViewProjection = modelViewProjectionMatrix;
+    settings.viewportSize = global::windowDelegate->currentDrawBufferResolution();
+    // The text extends from the anchor point, so labels whose anchor point is just
+    // outside of the screen might still be partially visible
+    settings.margin = static_cast<float>(_minMaxSize.value().y);
+    settings.cullOverlapping = _hideOverlapping;
+    settings.maxLabels = _maxLabels;
+    settings.textUp = glm::dvec3(orthoUp);
+    settings.textHeight = labelInfo.scale * _fontSize.value();
+    settings.minMaxTextHeight = glm::vec2(_minMaxSize.value());
+
+    const std::vector<size_t>& visibleLabels = _layout.layout(
+        settings,
+        [this](size_t i) { return _labelset.entries[i].isEnabled; }
+    );
+    for (size_t i : visibleLabels) {
         ghoul::fontrendering::FontRenderer::defaultProjectionRenderer().render(
             *_font,
-            scaledPos,
-            e.text,
+            glm::vec3(_layout.labels()[i].position),
+            _labelset.entries[i].text,
             textColor,
             labelInfo
         );
     }
 }
 
+void LabelsComponent::updateLayout() {
+    float scale = static_cast<float>(toMeter(_unit));
+
+    std::vector<LabelLayout::Label> labels;
+    labels.reserve(_labelset.entries.size());
+    for (const speck::Labelset::Entry& e : _labelset.entries) {
+        // Transform and scale the labels
+        glm::vec3 transformedPos(_transformationMatrix * glm::dvec4(e.position, 1.0));
+        glm::vec3 scaledPos(transformedPos);
+        scaledPos *= scale;
+
+        labels.push_back({
+            .position = glm::dvec3(scaledPos),
+            .textLength = static_cast<int>(e.text.size())
+        });
+    }
+    _layout.setLabels(std::move(labels));
+    _layoutIsDirty = false;
+}
+
 } // namespace openspace
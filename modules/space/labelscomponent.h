@@ -31,8 +31,10 @@
 #include <modules/space/speckloader.h>
 #include <openspace/properties/scalar/boolproperty.h>
 #include <openspace/properties/scalar/floatproperty.h>
+#include <openspace/properties/scalar/intproperty.h>
 #include <openspace/properties/vector/ivec2property.h>
 #include <openspace/properties/vector/vec3property.h>
+#include <openspace/rendering/labellayout.h>
 #include <openspace/util/distanceconversion.h>
 #include <ghoul/glm.h>
 #include <filesystem>
@@ -66,10 +68,15 @@ public:
     static documentation::Documentation Documentation();
 
 private:
+    void updateLayout();
+
     std::filesystem::path _labelFile;
     DistanceUnit _unit = DistanceUnit::Parsec;
     speck::Labelset _labelset;
 
+    LabelLayout _layout;
+    bool _layoutIsDirty = true;
+
     std::shared_ptr<ghoul::fontrendering::Font> _font = nullptr;
 
     glm::dmat4 _transformationMatrix = glm::dmat4(1.0);
@@ -81,6 +88,8 @@ private:
     properties::FloatProperty _fontSize;
     properties::IVec2Property _minMaxSize;
     properties::BoolProperty _faceCamera;
+    properties::BoolProperty _hideOverlapping;
+    properties::IntProperty _maxLabels;
 };
 
 } // namespace openspace
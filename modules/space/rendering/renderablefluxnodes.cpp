@@ -24,6 +24,7 @@
 
 #include <modules/space/rendering/renderablefluxnodes.h>
 
+#include <modules/space/fluxnodesstates.h>
 #include <openspace/engine/globals.h>
 #include <openspace/engine/windowdelegate.h>
 #include <openspace/navigation/navigationhandler.h>
@@ -39,6 +40,7 @@
 #include <ghoul/logging/visualstudiooutputlog.h>
 #include <ghoul/opengl/programobject.h>
 #include <ghoul/opengl/textureunit.h>
+#include <chrono>
 #include <fstream>
 #include <functional>
 #include <optional>
@@ -276,6 +278,45 @@ namespace {
         openspace::properties::Property::Visibility::User
     };
 
+    constexpr openspace::properties::Property::PropertyInfo MemoryUsageInfo = {
+        "MemoryUsage",
+        "Memory Usage (MB)",
+        "The size of the node data of all time steps in the selected energy bin. If the "
+        "data is memory mapped, only the time steps that have been shown are actually "
+        "read into memory",
+        openspace::properties::Property::Visibility::Developer
+    };
+
+    constexpr openspace::properties::Property::PropertyInfo UpdateTimeInfo = {
+        "UpdateTime",
+        "Update Time (ms)",
+        "The time it took to update the node data in the last frame. This includes "
+        "uploading a new time step to the GPU when scrubbing through time",
+        openspace::properties::Property::Visibility::Developer
+    };
+
+    std::shared_ptr<const openspace::FluxNodesStates> loadStates(
+                                                    const std::filesystem::path& folder,
+                                                    int energybinOption, bool memoryMap)
+    {
+        std::string energybin;
+        switch (energybinOption) {
+            case 0:
+                energybin = "_emin01";
+                break;
+            case 1:
+                energybin = "_emin03";
+                break;
+        }
+
+        return std::make_shared<const openspace::FluxNodesStates>(
+            folder / ("positions" + energybin),
+            folder / ("fluxes" + energybin),
+            folder / ("radiuses" + energybin),
+            memoryMap
+        );
+    }
+
     struct [[codegen::Dictionary(RenderableFluxNodes)]] Parameters {
         // path to source folder with the 3 binary files in it
         std::filesystem::path sourceFolder [[codegen::directory()]];
@@ -285,6 +326,10 @@ namespace {
         std::optional<int> energyBin;
         // [[codegen::verbatim(colorTableRangeInfo.description)]]
         std::optional<glm::vec2> colorTableRange;
+        // If this value is true, the binary files are mapped into memory instead of
+        // being read in their entirety, which reduces the loading time and the memory
+        // footprint for large sequences
+        std::optional<bool> memoryMapStates;
     };
 #include "renderablefluxnodes_codegen.cpp"
 
@@ -337,6 +382,9 @@ RenderableFluxNodes::RenderableFluxNodes(const ghoul::Dictionary& dictionary)
     , _perspectiveDistanceFactor(PerspectiveDistanceFactorInfo, 2.67f, 1.f, 20.f)
     , _pulseEnabled(pulseEnabledInfo, false)
     , _gaussianPulseEnabled(gaussianPulseEnabledInfo, false)
+    , _statisticsGroup({ "Statistics" })
+    , _memoryUsage(MemoryUsageInfo, 0.f, 0.f, std::numeric_limits<float>::max())
+    , _updateTime(UpdateTimeInfo, 0.f, 0.f, std::numeric_limits<float>::max())
 {
     const Parameters p = codegen::bake<Parameters>(dictionary);
 
@@ -345,6 +393,7 @@ RenderableFluxNodes::RenderableFluxNodes(const ghoul::Dictionary& dictionary)
     _colorTableRange = p.colorTableRange.value_or(_colorTableRange);
 
     _binarySourceFolderPath = p.sourceFolder;
+    _memoryMapStates = p.memoryMapStates.value_or(_memoryMapStates);
     if (std::filesystem::is_directory(_binarySourceFolderPath)) {
         // Extract all file paths from the provided folder
         namespace fs = std::filesystem;
@@ -396,7 +445,17 @@ RenderableFluxNodes::RenderableFluxNodes(const ghoul::Dictionary& dictionary)
 
 void RenderableFluxNodes::initialize() {
     populateStartTimes();
-    loadNodeData(_goesEnergyBins.option().value);
+    LDEBUG("Loading in binary files directly from sync folder");
+    try {
+        setStates(loadStates(
+            _binarySourceFolderPath,
+            _goesEnergyBins.option().value,
+            _memoryMapStates
+        ));
+    }
+    catch (const ghoul::RuntimeError& e) {
+        LERROR(e.message);
+    }
     computeSequenceEndTime();
 }
 
@@ -427,47 +486,15 @@ void RenderableFluxNodes::initializeGL() {
 void RenderableFluxNodes::definePropertyCallbackFunctions() {
     // Add Property Callback Functions
     _goesEnergyBins.onChange([this] {
-        loadNodeData(_goesEnergyBins.option().value);
+        _requestedEnergyBin = _goesEnergyBins.option().value;
     });
     _colorTablePath.onChange([this]() {
         _transferFunction->setPath(_colorTablePath);
     });
 }
 
-void RenderableFluxNodes::loadNodeData(int energybinOption) {
-    LDEBUG("Loading in binary files directly from sync folder");
-
-    std::string energybin;
-    switch (energybinOption) {
-        case 0:
-            energybin = "_emin01";
-            break;
-        case 1:
-            energybin = "_emin03";
-            break;
-    }
-
-    std::string file = _binarySourceFolderPath.string() + "\\positions" + energybin;
-    std::string file2 = _binarySourceFolderPath.string() + "\\fluxes" + energybin;
-    std::string file3 = _binarySourceFolderPath.string() + "\\radiuses" + energybin;
-
-    std::ifstream fileStream(file, std::ifstream::binary);
-    std::ifstream fileStream2(file2, std::ifstream::binary);
-    std::ifstream fileStream3(file3, std::ifstream::binary);
-
-    if (!fileStream.good()) {
-        LERROR(fmt::format("Could not read file '{}'", file));
-        return;
-    }
-
-    uint32_t nNodesPerTimestep = 0;
-    fileStream.read(reinterpret_cast<char*>(&nNodesPerTimestep), sizeof(uint32_t));
-
-    uint32_t nTimeSteps = 0;
-    fileStream.read(reinterpret_cast<char*>(&nTimeSteps), sizeof(uint32_t));
-    _nStates = nTimeSteps;
-
-    if (_nStates != _startTimes.size()) {
+void RenderableFluxNodes::setStates(std::shared_ptr<const FluxNodesStates> states) {
+    if (states->nStates() != _startTimes.size()) {
         LERROR(
             "Number of states, _nStates, and number of start times, _startTimes, "
             "do not match"
@@ -475,36 +502,36 @@ void RenderableFluxNodes::loadNodeData(int energybinOption) {
         return;
     }
 
-    _statesColor.clear();
-    _statesPos.clear();
-    _statesRadius.clear();
-
-    for (unsigned int i = 0; i < _nStates; ++i) {
-        _vertexPositions.resize(nNodesPerTimestep);
-        fileStream.read(reinterpret_cast<char*>(
-            _vertexPositions.data()), nNodesPerTimestep * sizeof(glm::vec3)
-        );
+    _states = std::move(states);
+    _nStates = static_cast<uint32_t>(_states->nStates());
+    _memoryUsage = static_cast<float>(_states->sizeInBytes()) / (1024.f * 1024.f);
+    // Force the active state to be uploaded from the new data
+    _uploadedStateIndex = -1;
+}
 
-        _statesPos.push_back(_vertexPositions);
-        _vertexPositions.clear();
+void RenderableFluxNodes::updateStates() {
+    // The previous states are rendered until the states of a newly selected energy bin
+    // have finished loading, at which point they are swapped in
+    if (_statesLoader.valid() &&
+        _statesLoader.wait_for(std::chrono::seconds(0)) == std::future_status::ready)
+    {
+        try {
+            setStates(_statesLoader.get());
+        }
+        catch (const ghoul::RuntimeError& e) {
+            LERROR(e.message);
+        }
     }
-    for (unsigned int i = 0; i < _nStates; ++i) {
-        _vertexColor.resize(nNodesPerTimestep);
-        fileStream2.read(reinterpret_cast<char*>(
-            _vertexColor.data()), nNodesPerTimestep * sizeof(float)
-        );
 
-        _statesColor.push_back(_vertexColor);
-        _vertexColor.clear();
-    }
-    for (unsigned int i = 0; i < _nStates; ++i) {
-        _vertexRadius.resize(nNodesPerTimestep);
-        fileStream3.read(reinterpret_cast<char*>(
-            _vertexRadius.data()), nNodesPerTimestep * sizeof(float)
+    if (!_statesLoader.valid() && _requestedEnergyBin.has_value()) {
+        _statesLoader = std::async(
+            std::launch::async,
+            loadStates,
+            _binarySourceFolderPath,
+            *_requestedEnergyBin,
+            _memoryMapStates
         );
-
-        _statesRadius.push_back(_vertexRadius);
-        _vertexRadius.clear();
+        _requestedEnergyBin = std::nullopt;
     }
 }
 
@@ -552,6 +579,12 @@ void RenderableFluxNodes::setupProperties() {
     _styleGroup.addProperty(_streamColor);
     _styleGroup.addProperty(_fluxColorAlpha);
 
+    addPropertySubOwner(_statisticsGroup);
+    _memoryUsage.setReadOnly(true);
+    _statisticsGroup.addProperty(_memoryUsage);
+    _updateTime.setReadOnly(true);
+    _statisticsGroup.addProperty(_updateTime);
+
     definePropertyCallbackFunctions();
 }
 
@@ -670,7 +703,7 @@ void RenderableFluxNodes::updateActiveTriggerTimeIndex(double currentTime) {
     }
 }
 void RenderableFluxNodes::render(const RenderData& data, RendererTasks&) {
-    if (_activeTriggerTimeIndex == -1) {
+    if (_activeTriggerTimeIndex == -1 || _uploadedStateIndex == -1) {
         return;
     }
     _shaderProgram->activate();
@@ -758,11 +791,7 @@ void RenderableFluxNodes::render(const RenderData& data, RendererTasks&) {
 
     glBindVertexArray(_vertexArrayObject);
 
-    glDrawArrays(
-        GL_POINTS,
-        0,
-        static_cast<GLsizei>(_vertexPositions.size())
-    );
+    glDrawArrays(GL_POINTS, 0, _nUploadedNodes);
 
     glBindVertexArray(0);
     _shaderProgram->deactivate();
@@ -789,9 +818,17 @@ void RenderableFluxNodes::update(const UpdateData& data) {
     if (!_enabled) {
         return;
     }
+    const auto start = std::chrono::steady_clock::now();
+
     if (_shaderProgram->isDirty()) {
         _shaderProgram->rebuildFromFile();
     }
+
+    updateStates();
+    if (!_states) {
+        return;
+    }
+
     bool needsUpdate = true;
     //Everything below is for updating depending on time
     const double currentTime = data.time.j2000Seconds();
@@ -816,14 +853,15 @@ void RenderableFluxNodes::update(const UpdateData& data) {
         needsUpdate = false;
     }
 
-    if (needsUpdate && !_statesPos[_activeTriggerTimeIndex].empty()) {
-        _vertexPositions = _statesPos[_activeTriggerTimeIndex];
-        _vertexColor = _statesColor[_activeTriggerTimeIndex];
-        _vertexRadius = _statesRadius[_activeTriggerTimeIndex];
-        needsUpdate = false;
-        updatePositionBuffer();
-        updateVertexColorBuffer();
-        updateVertexFilteringBuffer();
+    // The vertex buffers only have to be updated when a different state became active.
+    // The data is uploaded directly from the loaded states without copying it first
+    if (needsUpdate && _activeTriggerTimeIndex != _uploadedStateIndex) {
+        const size_t idx = static_cast<size_t>(_activeTriggerTimeIndex);
+        updatePositionBuffer(_states->positions(idx));
+        updateVertexColorBuffer(_states->fluxes(idx));
+        updateVertexFilteringBuffer(_states->radii(idx));
+        _nUploadedNodes = static_cast<GLsizei>(_states->nNodesPerState());
+        _uploadedStateIndex = _activeTriggerTimeIndex;
     }
 
     if (_shaderProgram->isDirty()) {
@@ -834,17 +872,20 @@ void RenderableFluxNodes::update(const UpdateData& data) {
             UniformNames
         );
     }
+
+    const auto end = std::chrono::steady_clock::now();
+    _updateTime = std::chrono::duration<float, std::milli>(end - start).count();
 }
 
-void RenderableFluxNodes::updatePositionBuffer() {
+void RenderableFluxNodes::updatePositionBuffer(std::span<const glm::vec3> positions) {
     glBindVertexArray(_vertexArrayObject);
     glBindBuffer(GL_ARRAY_BUFFER, _vertexPositionBuffer);
 
     glBufferData(
         GL_ARRAY_BUFFER,
-        _vertexPositions.size() * sizeof(glm::vec3),
-        _vertexPositions.data(),
-        GL_STATIC_DRAW
+        positions.size_bytes(),
+        positions.data(),
+        GL_DYNAMIC_DRAW
     );
 
     glEnableVertexAttribArray(0);
@@ -855,15 +896,15 @@ void RenderableFluxNodes::updatePositionBuffer() {
     glBindVertexArray(0);
 }
 
-void RenderableFluxNodes::updateVertexColorBuffer() {
+void RenderableFluxNodes::updateVertexColorBuffer(std::span<const float> fluxes) {
     glBindVertexArray(_vertexArrayObject);
     glBindBuffer(GL_ARRAY_BUFFER, _vertexColorBuffer);
 
     glBufferData(
         GL_ARRAY_BUFFER,
-        _vertexColor.size() * sizeof(float),
-        _vertexColor.data(),
-        GL_STATIC_DRAW
+        fluxes.size_bytes(),
+        fluxes.data(),
+        GL_DYNAMIC_DRAW
     );
 
     glEnableVertexAttribArray(1);
@@ -873,15 +914,15 @@ void RenderableFluxNodes::updateVertexColorBuffer() {
     glBindVertexArray(0);
 }
 
-void RenderableFluxNodes::updateVertexFilteringBuffer() {
+void RenderableFluxNodes::updateVertexFilteringBuffer(std::span<const float> radii) {
     glBindVertexArray(_vertexArrayObject);
     glBindBuffer(GL_ARRAY_BUFFER, _vertexFilteringBuffer);
 
     glBufferData(
         GL_ARRAY_BUFFER,
-        _vertexRadius.size() * sizeof(float),
-        _vertexRadius.data(),
-        GL_STATIC_DRAW
+        radii.size_bytes(),
+        radii.data(),
+        GL_DYNAMIC_DRAW
     );
 
     glEnableVertexAttribArray(2);
@@ -28,6 +28,7 @@
 #include <openspace/rendering/renderable.h>
 
 #include <openspace/properties/optionproperty.h>
+#include <openspace/properties/scalar/floatproperty.h>
 #include <openspace/properties/scalar/intproperty.h>
 #include <openspace/properties/stringproperty.h>
 #include <openspace/properties/triggerproperty.h>
@@ -36,9 +37,15 @@
 #include <openspace/rendering/transferfunction.h>
 #include <ghoul/opengl/uniformcache.h>
 #include <atomic>
+#include <future>
+#include <memory>
+#include <optional>
+#include <span>
 
 namespace openspace {
 
+class FluxNodesStates;
+
 class RenderableFluxNodes : public Renderable {
 public:
     RenderableFluxNodes(const ghoul::Dictionary& dictionary);
@@ -61,10 +68,11 @@ private:
     void setupProperties();
     void updateActiveTriggerTimeIndex(double currentTime);
 
-    void loadNodeData(int energybinOption);
-    void updatePositionBuffer();
-    void updateVertexColorBuffer();
-    void updateVertexFilteringBuffer();
+    void setStates(std::shared_ptr<const FluxNodesStates> states);
+    void updateStates();
+    void updatePositionBuffer(std::span<const glm::vec3> positions);
+    void updateVertexColorBuffer(std::span<const float> fluxes);
+    void updateVertexFilteringBuffer(std::span<const float> radii);
 
     std::vector<GLsizei> _lineCount;
     std::vector<GLint> _lineStart;
@@ -109,6 +117,10 @@ private:
 
     // Active index of _startTimes
     int _activeTriggerTimeIndex = -1;
+    // Index of the state that is currently stored in the vertex buffers
+    int _uploadedStateIndex = -1;
+    // Number of nodes that are currently stored in the vertex buffers
+    GLsizei _nUploadedNodes = 0;
     // Number of states in the sequence
     uint32_t _nStates = 0;
 
@@ -132,18 +144,15 @@ private:
     std::vector<std::string> _binarySourceFiles;
     // Contains the _triggerTimes for all streams in the sequence
     std::vector<double> _startTimes;
-    // Contains vertexPositions
-    std::vector<glm::vec3> _vertexPositions;
-    // Contains vertex flux values for color
-    std::vector<float> _vertexColor;
-    // Contains radius of vertices
-    std::vector<float> _vertexRadius;
-    // Stores the states position
-    std::vector<std::vector<glm::vec3>> _statesPos;
-    // Stores the states color
-    std::vector<std::vector<float>> _statesColor;
-    // Stores the states radius
-    std::vector<std::vector<float>> _statesRadius;
+    // Positions, flux values, and radii of all states of the selected energy bin
+    std::shared_ptr<const FluxNodesStates> _states;
+    // Loads the states of a newly selected energy bin while the previous states are
+    // still being rendered
+    std::future<std::shared_ptr<const FluxNodesStates>> _statesLoader;
+    // Energy bin that should be loaded as soon as the current load has finished
+    std::optional<int> _requestedEnergyBin;
+    // Map the binary files into memory instead of reading them
+    bool _memoryMapStates = false;
 
     // Group to hold properties regarding distance to earth
     properties::PropertyOwner _earthdistGroup;
@@ -210,6 +219,10 @@ private:
     properties::FloatProperty _perspectiveDistanceFactor;
     properties::BoolProperty _pulseEnabled;
     properties::BoolProperty _gaussianPulseEnabled;
+
+    properties::PropertyOwner _statisticsGroup;
+    properties::FloatProperty _memoryUsage;
+    properties::FloatProperty _updateTime;
 };
 
 } // namespace openspace
@@ -25,6 +25,7 @@
 #include <modules/space/rendering/renderableorbitalkepler.h>
 
 #include <modules/space/translation/keplertranslation.h>
+#include <modules/space/sgp4.h>
 #include <modules/space/spacemodule.h>
 #include <openspace/engine/openspaceengine.h>
 #include <openspace/rendering/renderengine.h>
@@ -39,9 +40,12 @@
 #include <ghoul/opengl/programobject.h>
 #include <ghoul/logging/logmanager.h>
 #include <chrono>
+#include <cmath>
 #include <fstream>
 #include <math.h>
+#include <numeric>
 #include <random>
+#include <thread>
 #include <vector>
 
 namespace {
@@ -147,6 +151,21 @@ namespace {
 
         // [[codegen::verbatim(ContiguousModeInfo.description)]]
         std::optional<bool> contiguousMode;
+
+        enum class Propagator {
+            TwoBody,
+            SGP4
+        };
+        // Determines how the orbits are computed. 'TwoBody' (the default) treats the
+        // elements in the file as fixed Keplerian elements. 'SGP4' propagates the
+        // elements with the SGP4/SDP4 model, which includes the drag and the
+        // perturbations by the Earth, Moon, and Sun, and draws the osculating orbits at
+        // the current time instead. This is only available for TLE and OMM files
+        std::optional<Propagator> propagator;
+
+        // The simulation time in seconds after which the orbits are propagated again if
+        // the 'SGP4' propagator is used. Defaults to one hour
+        std::optional<double> propagationInterval [[codegen::greater(0.0)]];
     };
 #include "renderableorbitalkepler_codegen.cpp"
 } // namespace
@@ -209,8 +228,20 @@ RenderableOrbitalKepler::RenderableOrbitalKepler(const ghoul::Dictionary& dict)
     _contiguousMode = p.contiguousMode.value_or(false);
     _contiguousMode.onChange([this]() { _updateDataBuffersAtNextRender = true; });
     addProperty(_contiguousMode);
+
+    if (p.propagator.value_or(Parameters::Propagator::TwoBody) ==
+        Parameters::Propagator::SGP4)
+    {
+        if (_format == kepler::Format::SBDB) {
+            throw ghoul::RuntimeError("The SGP4 propagator requires a TLE or OMM file");
+        }
+        _propagator = sgp4::loadPropagator(p.path, _format);
+        _propagationInterval = p.propagationInterval.value_or(3600.0);
+    }
 }
 
+RenderableOrbitalKepler::~RenderableOrbitalKepler() = default;
+
 void RenderableOrbitalKepler::initializeGL() {
     ghoul_assert(_vertexArray == 0, "Vertex array object already existed");
     ghoul_assert(_vertexBuffer == 0, "Vertex buffer object already existed");
@@ -255,7 +286,17 @@ bool RenderableOrbitalKepler::isReady() const {
     return _programObject != nullptr;
 }
 
-void RenderableOrbitalKepler::update(const UpdateData&) {
+void RenderableOrbitalKepler::update(const UpdateData& data) {
+    if (_propagator) {
+        const double now = data.time.j2000Seconds();
+        if (!_propagationTime.has_value() ||
+            std::abs(now - *_propagationTime) > _propagationInterval)
+        {
+            _propagationTime = now;
+            _updateDataBuffersAtNextRender = true;
+        }
+    }
+
     if (_updateDataBuffersAtNextRender) {
         _updateDataBuffersAtNextRender = false;
         updateBuffers();
@@ -304,12 +345,11 @@ void RenderableOrbitalKepler::render(const RenderData& data, RendererTasks&) {
 }
 
 void RenderableOrbitalKepler::updateBuffers() {
-    std::vector<kepler::Parameters> parameters = kepler::readFile(
-       _path.value(),
-        _format
-    );
+    std::shared_ptr<const kepler::Catalog> catalog =
+        kepler::loadCatalog(_path.value(), _format);
+    const std::vector<kepler::Parameters>& allParameters = catalog->parameters();
 
-    _numObjects = parameters.size();
+    _numObjects = allParameters.size();
 
     if (_startRenderIdx >= _numObjects) {
         throw ghoul::RuntimeError(fmt::format(
@@ -331,32 +371,76 @@ void RenderableOrbitalKepler::updateBuffers() {
         _sizeRender = static_cast<unsigned int>(_numObjects);
     }
 
+    std::vector<size_t> indices(allParameters.size());
+    std::iota(indices.begin(), indices.end(), 0);
     if (_contiguousMode) {
-        if (_startRenderIdx >= parameters.size() ||
-            (_startRenderIdx + _sizeRender) >= parameters.size())
+        if (_startRenderIdx >= allParameters.size() ||
+            (_startRenderIdx + _sizeRender) >= allParameters.size())
         {
             throw ghoul::RuntimeError(fmt::format(
                 "Tried to load {} objects but only {} are available",
-                _startRenderIdx + _sizeRender, parameters.size()
+                _startRenderIdx + _sizeRender, allParameters.size()
             ));
         }
 
         // Extract subset that starts at _startRenderIdx and contains _sizeRender obejcts
-        parameters = std::vector<kepler::Parameters>(
-            parameters.begin() + _startRenderIdx,
-            parameters.begin() + _startRenderIdx + _sizeRender
+        indices = std::vector<size_t>(
+            indices.begin() + _startRenderIdx,
+            indices.begin() + _startRenderIdx + _sizeRender
         );
     }
     else {
         // First shuffle the whole array
         std::default_random_engine rng;
-        std::shuffle(parameters.begin(), parameters.end(), rng);
+        std::shuffle(indices.begin(), indices.end(), rng);
 
         // Then take the first _sizeRender values
-        parameters = std::vector<kepler::Parameters>(
-            parameters.begin(),
-            parameters.begin() + _sizeRender
+        indices = std::vector<size_t>(indices.begin(), indices.begin() + _sizeRender);
+    }
+
+    std::vector<kepler::Parameters> parameters;
+    parameters.reserve(indices.size());
+    for (size_t i : indices) {
+        parameters.push_back(allParameters[i]);
+    }
+
+    if (_propagator && _propagationTime.has_value()) {
+        // The path might have changed since the last time
+        _propagator = sgp4::loadPropagator(_path.value(), _format);
+        if (_propagator->size() != allParameters.size()) {
+            throw ghoul::RuntimeError(fmt::format(
+                "Expected {} objects for SGP4 but found {}",
+                allParameters.size(), _propagator->size()
+            ));
+        }
+
+        // Replace the elements with the osculating orbits at the propagation time. The
+        // whole catalog is propagated at once as that is distributed over all cores
+        const double time = *_propagationTime;
+        std::vector<sgp4::Propagator::State> states(_propagator->size());
+        _propagator->propagate(
+            std::span<const double>(&time, 1),
+            states,
+            std::max(std::thread::hardware_concurrency(), 1u)
         );
+        // The states are in the TEME frame of the elements, but the orbits are drawn in
+        // the J2000 frame
+        const glm::dmat3 rotation = sgp4::temeToJ2000(time);
+        for (size_t i = 0; i < indices.size(); i++) {
+            const sgp4::Propagator::State& state = states[indices[i]];
+            // Objects for which the model breaks down keep their two-body orbit
+            if (state.status == sgp4::Propagator::Status::Success) {
+                kepler::Parameters osculating = sgp4::osculatingElements(
+                    rotation * state.position,
+                    rotation * state.velocity,
+                    time
+                );
+                osculating.name = parameters[i].name;
+                osculating.id = parameters[i].id;
+                osculating.noradId = parameters[i].noradId;
+                parameters[i] = std::move(osculating);
+            }
+        }
     }
 
     _segmentSize.clear();
@@ -35,14 +35,18 @@
 #include <ghoul/glm.h>
 #include <ghoul/misc/objectmanager.h>
 #include <ghoul/opengl/programobject.h>
+#include <memory>
+#include <optional>
 
 namespace openspace {
 
 namespace documentation { struct Documentation; }
+namespace sgp4 { class Propagator; }
 
 class RenderableOrbitalKepler : public Renderable {
 public:
     RenderableOrbitalKepler(const ghoul::Dictionary& dictionary);
+    ~RenderableOrbitalKepler() override;
 
     void initializeGL() override;
     void deinitializeGL() override;
@@ -86,6 +90,12 @@ private:
     kepler::Format _format;
     RenderableTrail::Appearance _appearance;
 
+    /// If this is set, the orbits are replaced with the osculating orbits at the
+    /// propagation time, which is moved along with the simulation time
+    std::shared_ptr<sgp4::Propagator> _propagator;
+    std::optional<double> _propagationTime;
+    double _propagationInterval = 0.0;
+
     UniformCache(modelView, projection, lineFade, inGameTime, color, opacity,
         numberOfSegments) _uniformCache;
 };
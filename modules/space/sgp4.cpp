@@ -0,0 +1,1690 @@
+/*****************************************************************************************
+ *                                                                                       *
+ * OpenSpace                                                                             *
+ *                                                                                       *
+ * Copyright (c) 2014-2023                                                               *
+ *                                                                                       *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this  *
+ * software and associated documentation files (the "Software"), to deal in the Software *
+ * without restriction, including without limitation the rights to use, copy, modify,    *
+ * merge, publish, distribute, sublicense, and/or sell copies of the Software, and to    *
+ * permit persons to whom the Software is furnished to do so, subject to the following   *
+ * conditions:                                                                           *
+ *                                                                                       *
+ * The above copyright notice and this permission notice shall be included in all copies *
+ * or substantial portions of the Software.                                              *
+ *                                                                                       *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,   *
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A         *
+ * PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT    *
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF  *
+ * CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE  *
+ * OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                                         *
+ ****************************************************************************************/
+
+
+#include <modules/space/sgp4.h>
+
+#include <ghoul/fmt.h>
+#include <ghoul/logging/logmanager.h>
+#include <ghoul/misc/assert.h>
+#include <ghoul/misc/exception.h>
+#include <ghoul/misc/misc.h>
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <charconv>
+#include <cmath>
+#include <cstdio>
+#include <fstream>
+#include <future>
+#include <map>
+#include <mutex>
+#include <optional>
+#include <thread>
+
+namespace {
+    constexpr std::string_view _loggerCat = "SGP4";
+
+    // WGS-72 constants, which were used to generate the elements
+    constexpr double Mu = 398600.8; // km^3 / s^2
+    constexpr double RadiusEarth = 6378.135; // km
+    constexpr double J2 = 0.001082616;
+    constexpr double J3 = -0.00000253881;
+    constexpr double J4 = -0.00000165597;
+    constexpr double J3oJ2 = J3 / J2;
+
+    constexpr double Pi = 3.14159265358979323846;
+    constexpr double TwoPi = 2.0 * Pi;
+    constexpr double Deg2Rad = Pi / 180.0;
+    constexpr double X2o3 = 2.0 / 3.0;
+    constexpr double MinutesPerDay = 1440.0;
+
+    // Earth rotation rate in radians per minute
+    constexpr double Rptim = 4.37526908801129966e-3;
+
+    // Objects are split into chunks of this size when propagating on multiple threads
+    constexpr size_t ChunkSize = 256;
+
+    // sqrt(Mu / RadiusEarth^3) in 1/min
+    double xke() {
+        static const double Xke =
+            60.0 / std::sqrt(RadiusEarth * RadiusEarth * RadiusEarth / Mu);
+        return Xke;
+    }
+
+    // The difference between TAI and UTC and the date from which it applies. List taken
+    // from: https://www.ietf.org/timezones/data/leap-seconds.list
+    struct LeapSecond {
+        int year;
+        int month;
+        int deltaAt;
+    };
+    constexpr std::array<LeapSecond, 28> LeapSeconds = {
+        LeapSecond { 1972, 1, 10 }, LeapSecond { 1972, 7, 11 },
+        LeapSecond { 1973, 1, 12 }, LeapSecond { 1974, 1, 13 },
+        LeapSecond { 1975, 1, 14 }, LeapSecond { 1976, 1, 15 },
+        LeapSecond { 1977, 1, 16 }, LeapSecond { 1978, 1, 17 },
+        LeapSecond { 1979, 1, 18 }, LeapSecond { 1980, 1, 19 },
+        LeapSecond { 1981, 7, 20 }, LeapSecond { 1982, 7, 21 },
+        LeapSecond { 1983, 7, 22 }, LeapSecond { 1985, 7, 23 },
+        LeapSecond { 1988, 1, 24 }, LeapSecond { 1990, 1, 25 },
+        LeapSecond { 1991, 1, 26 }, LeapSecond { 1992, 7, 27 },
+        LeapSecond { 1993, 7, 28 }, LeapSecond { 1994, 7, 29 },
+        LeapSecond { 1996, 1, 30 }, LeapSecond { 1997, 7, 31 },
+        LeapSecond { 1999, 1, 32 }, LeapSecond { 2006, 1, 33 },
+        LeapSecond { 2009, 1, 34 }, LeapSecond { 2012, 7, 35 },
+        LeapSecond { 2015, 7, 36 }, LeapSecond { 2017, 1, 37 }
+    };
+
+    double julianDate(int year, int month, int day, double fractionOfDay) {
+        return 367.0 * year -
+            std::floor((7 * (year + std::floor((month + 9) / 12.0))) * 0.25) +
+            std::floor(275 * month / 9.0) + day + 1721013.5 + fractionOfDay;
+    }
+
+    // Converts a Julian date in UTC into seconds past the J2000 epoch
+    double j2000Seconds(double julianDateUtc) {
+        int deltaAt = LeapSeconds.front().deltaAt;
+        for (const LeapSecond& leapSecond : LeapSeconds) {
+            if (julianDateUtc >= julianDate(leapSecond.year, leapSecond.month, 1, 0.0)) {
+                deltaAt = leapSecond.deltaAt;
+            }
+        }
+        // TT = TAI + 32.184 s and TDB differs from TT by less than 2 ms
+        return (julianDateUtc - 2451545.0) * 86400.0 + deltaAt + 32.184;
+    }
+
+    // Greenwich mean sidereal time in radians according to IAU-82
+    double greenwichSiderealTime(double julianDateUt1) {
+        const double t = (julianDateUt1 - 2451545.0) / 36525.0;
+        double res = -6.2e-6 * t * t * t + 0.093104 * t * t +
+            (876600.0 * 3600.0 + 8640184.812866) * t + 67310.54841;
+        res = std::fmod(res * Deg2Rad / 240.0, TwoPi);
+        return res < 0.0 ? res + TwoPi : res;
+    }
+
+    constexpr double ArcSec2Rad = Deg2Rad / 3600.0;
+
+    // The largest terms of the IAU-1980 nutation series. The multipliers of the
+    // fundamental arguments l, l', F, D, and Omega are followed by the coefficients of
+    // the nutation in longitude and in obliquity in units of 0.0001 arcseconds. The
+    // omitted terms are smaller than 0.005 arcseconds, which is less than a meter for
+    // objects in Earth orbit
+    struct NutationTerm {
+        int l;
+        int lPrime;
+        int f;
+        int d;
+        int omega;
+        double longitude;
+        double longitudeRate;
+        double obliquity;
+        double obliquityRate;
+    };
+    constexpr std::array<NutationTerm, 18> NutationTerms = {
+        NutationTerm {  0,  0, 0,  0, 1, -171996.0, -174.2, 92025.0,  8.9 },
+        NutationTerm {  0,  0, 2, -2, 2,  -13187.0,   -1.6,  5736.0, -3.1 },
+        NutationTerm {  0,  0, 2,  0, 2,   -2274.0,   -0.2,   977.0, -0.5 },
+        NutationTerm {  0,  0, 0,  0, 2,    2062.0,    0.2,  -895.0,  0.5 },
+        NutationTerm {  0,  1, 0,  0, 0,    1426.0,   -3.4,    54.0, -0.1 },
+        NutationTerm {  1,  0, 0,  0, 0,     712.0,    0.1,    -7.0,  0.0 },
+        NutationTerm {  0,  1, 2, -2, 2,    -517.0,    1.2,   224.0, -0.6 },
+        NutationTerm {  0,  0, 2,  0, 1,    -386.0,   -0.4,   200.0,  0.0 },
+        NutationTerm {  1,  0, 2,  0, 2,    -301.0,    0.0,   129.0, -0.1 },
+        NutationTerm {  0, -1, 2, -2, 2,     217.0,   -0.5,   -95.0,  0.3 },
+        NutationTerm {  1,  0, 0, -2, 0,    -158.0,    0.0,     0.0,  0.0 },
+        NutationTerm {  0,  0, 2, -2, 1,     129.0,    0.1,   -70.0,  0.0 },
+        NutationTerm { -1,  0, 2,  0, 2,     123.0,    0.0,   -53.0,  0.0 },
+        NutationTerm {  1,  0, 0,  0, 1,      63.0,    0.1,   -33.0,  0.0 },
+        NutationTerm {  0,  0, 0,  2, 0,      63.0,    0.0,     0.0,  0.0 },
+        NutationTerm { -1,  0, 2,  2, 2,     -59.0,    0.0,    26.0,  0.0 },
+        NutationTerm { -1,  0, 0,  0, 1,     -58.0,   -0.1,    32.0,  0.0 },
+        NutationTerm {  1,  0, 2,  0, 1,     -51.0,    0.0,    27.0,  0.0 }
+    };
+
+    // The matrices that rotate the coordinate axes by the provided angle around the x,
+    // y, and z axis. Note that glm matrices are constructed column by column
+    glm::dmat3 rotationX(double angle) {
+        const double c = std::cos(angle);
+        const double s = std::sin(angle);
+        return glm::dmat3(1.0, 0.0, 0.0, 0.0, c, -s, 0.0, s, c);
+    }
+
+    glm::dmat3 rotationY(double angle) {
+        const double c = std::cos(angle);
+        const double s = std::sin(angle);
+        return glm::dmat3(c, 0.0, s, 0.0, 1.0, 0.0, -s, 0.0, c);
+    }
+
+    glm::dmat3 rotationZ(double angle) {
+        const double c = std::cos(angle);
+        const double s = std::sin(angle);
+        return glm::dmat3(c, -s, 0.0, s, c, 0.0, 0.0, 0.0, 1.0);
+    }
+
+    std::string_view trim(std::string_view str) {
+        const size_t begin = str.find_first_not_of(" \t\r\n");
+        if (begin == std::string_view::npos) {
+            return std::string_view();
+        }
+        const size_t end = str.find_last_not_of(" \t\r\n");
+        return str.substr(begin, end - begin + 1);
+    }
+
+    double parseDouble(std::string_view str, std::string_view field) {
+        std::string_view s = trim(str);
+        if (!s.empty() && s.front() == '+') {
+            s.remove_prefix(1);
+        }
+        double value = 0.0;
+        auto [ptr, ec] = std::from_chars(s.data(), s.data() + s.size(), value);
+        if (s.empty() || ec != std::errc() || ptr != s.data() + s.size()) {
+            throw ghoul::RuntimeError(fmt::format("Invalid {} '{}'", field, str));
+        }
+        return value;
+    }
+
+    // Parses values with an assumed leading decimal point and an exponent, such as
+    // '-11606-4', which represents -0.11606e-4
+    double parseExponent(std::string_view str, std::string_view field) {
+        const std::string_view s = trim(str);
+        if (s.empty()) {
+            return 0.0;
+        }
+        const size_t exponentSign = s.find_last_of("+-");
+        if (exponentSign == std::string_view::npos || exponentSign == 0) {
+            throw ghoul::RuntimeError(fmt::format("Invalid {} '{}'", field, str));
+        }
+        std::string_view mantissa = s.substr(0, exponentSign);
+        const bool isNegative = mantissa.front() == '-';
+        if (mantissa.front() == '-' || mantissa.front() == '+') {
+            mantissa.remove_prefix(1);
+        }
+        const double exponent = parseDouble(s.substr(exponentSign), field);
+        const double value =
+            parseDouble(fmt::format("0.{}", mantissa), field) * std::pow(10.0, exponent);
+        return isNegative ? -value : value;
+    }
+
+    // Parses a catalog number, which can use the Alpha-5 scheme in which the first digit
+    // is replaced by a letter for numbers above 99999
+    int parseCatalogNumber(std::string_view str) {
+        std::string_view s = trim(str);
+        if (s.empty()) {
+            return 0;
+        }
+        int prefix = 0;
+        if (s.front() >= 'A' && s.front() <= 'Z') {
+            // The letters I and O are skipped to avoid confusion with 1 and 0
+            const char c = s.front();
+            prefix = 10 + (c - 'A') - (c > 'I' ? 1 : 0) - (c > 'O' ? 1 : 0);
+            s.remove_prefix(1);
+        }
+        int value = 0;
+        auto [ptr, ec] = std::from_chars(s.data(), s.data() + s.size(), value);
+        if (ec != std::errc()) {
+            return 0;
+        }
+        return prefix * 10000 + value;
+    }
+
+    // Parses an epoch in the form YYYY-MM-DDTHH:MM:SS.ssssss
+    double julianDateFromIso(std::string_view str) {
+        int year = 0;
+        int month = 0;
+        int day = 0;
+        int hour = 0;
+        int minute = 0;
+        double second = 0.0;
+        const int n = std::sscanf(
+            std::string(str).c_str(),
+            "%d-%d-%dT%d:%d:%lf",
+            &year, &month, &day, &hour, &minute, &second
+        );
+        if (n < 3) {
+            throw ghoul::RuntimeError(fmt::format("Invalid epoch '{}'", str));
+        }
+        const double fraction = (hour + (minute + second / 60.0) / 60.0) / 24.0;
+        return julianDate(year, month, day, fraction);
+    }
+} // namespace
+
+namespace openspace::sgp4 {
+
+// The variable names follow those of the reference implementation by Vallado et al. to
+// make it possible to compare the two
+struct Record {
+    bool isDeepSpace = false;
+    bool isSimple = false;
+    int irez = 0;
+
+    // The mean elements at epoch in radians and radians per minute
+    double bstar = 0.0;
+    double ecco = 0.0;
+    double inclo = 0.0;
+    double nodeo = 0.0;
+    double argpo = 0.0;
+    double mo = 0.0;
+    double no = 0.0;
+
+    // Near earth terms
+    double aycof = 0.0;
+    double con41 = 0.0;
+    double cc1 = 0.0;
+    double cc4 = 0.0;
+    double cc5 = 0.0;
+    double d2 = 0.0;
+    double d3 = 0.0;
+    double d4 = 0.0;
+    double delmo = 0.0;
+    double eta = 0.0;
+    double argpdot = 0.0;
+    double omgcof = 0.0;
+    double sinmao = 0.0;
+    double t2cof = 0.0;
+    double t3cof = 0.0;
+    double t4cof = 0.0;
+    double t5cof = 0.0;
+    double x1mth2 = 0.0;
+    double x7thm1 = 0.0;
+    double mdot = 0.0;
+    double nodedot = 0.0;
+    double xlcof = 0.0;
+    double xmcof = 0.0;
+    double nodecf = 0.0;
+
+    // Deep space terms
+    double gsto = 0.0;
+    double d2201 = 0.0;
+    double d2211 = 0.0;
+    double d3210 = 0.0;
+    double d3222 = 0.0;
+    double d4410 = 0.0;
+    double d4422 = 0.0;
+    double d5220 = 0.0;
+    double d5232 = 0.0;
+    double d5421 = 0.0;
+    double d5433 = 0.0;
+    double dedt = 0.0;
+    double del1 = 0.0;
+    double del2 = 0.0;
+    double del3 = 0.0;
+    double didt = 0.0;
+    double dmdt = 0.0;
+    double dnodt = 0.0;
+    double domdt = 0.0;
+    double e3 = 0.0;
+    double ee2 = 0.0;
+    double peo = 0.0;
+    double pgho = 0.0;
+    double pho = 0.0;
+    double pinco = 0.0;
+    double plo = 0.0;
+    double se2 = 0.0;
+    double se3 = 0.0;
+    double sgh2 = 0.0;
+    double sgh3 = 0.0;
+    double sgh4 = 0.0;
+    double sh2 = 0.0;
+    double sh3 = 0.0;
+    double si2 = 0.0;
+    double si3 = 0.0;
+    double sl2 = 0.0;
+    double sl3 = 0.0;
+    double sl4 = 0.0;
+    double xfact = 0.0;
+    double xgh2 = 0.0;
+    double xgh3 = 0.0;
+    double xgh4 = 0.0;
+    double xh2 = 0.0;
+    double xh3 = 0.0;
+    double xi2 = 0.0;
+    double xi3 = 0.0;
+    double xl2 = 0.0;
+    double xl3 = 0.0;
+    double xl4 = 0.0;
+    double xlamo = 0.0;
+    double zmol = 0.0;
+    double zmos = 0.0;
+
+    // The state of the integrator for the resonance effects
+    double atime = 0.0;
+    double xli = 0.0;
+    double xni = 0.0;
+};
+
+namespace {
+    // Intermediate values of the lunar and solar terms that are only needed during the
+    // initialization of deep space objects
+    struct DeepSpaceCommon {
+        double snodm, cnodm, sinim, cosim, sinomm, cosomm;
+        double day, em, emsq, gam, rtemsq, nm;
+        double s1, s2, s3, s4, s5, s6, s7;
+        double ss1, ss2, ss3, ss4, ss5, ss6, ss7;
+        double sz1, sz2, sz3, sz11, sz12, sz13, sz21, sz22, sz23, sz31, sz32, sz33;
+        double z1, z2, z3, z11, z12, z13, z21, z22, z23, z31, z32, z33;
+    };
+
+    // Computes the lunar and solar terms at the epoch
+    DeepSpaceCommon dscom(double epoch, double ep, double argpp, double tc, double inclp,
+                          double nodep, double np, Record& rec)
+    {
+        constexpr double Zes = 0.01675;
+        constexpr double Zel = 0.05490;
+        constexpr double C1ss = 2.9864797e-6;
+        constexpr double C1l = 4.7968065e-7;
+        constexpr double Zsinis = 0.39785416;
+        constexpr double Zcosis = 0.91744867;
+        constexpr double Zcosgs = 0.1945905;
+        constexpr double Zsings = -0.98088458;
+
+        DeepSpaceCommon c;
+        c.nm = np;
+        c.em = ep;
+        c.snodm = std::sin(nodep);
+        c.cnodm = std::cos(nodep);
+        c.sinomm = std::sin(argpp);
+        c.cosomm = std::cos(argpp);
+        c.sinim = std::sin(inclp);
+        c.cosim = std::cos(inclp);
+        c.emsq = c.em * c.em;
+        const double betasq = 1.0 - c.emsq;
+        c.rtemsq = std::sqrt(betasq);
+
+        // Initialize the lunar and solar terms
+        rec.peo = 0.0;
+        rec.pinco = 0.0;
+        rec.plo = 0.0;
+        rec.pgho = 0.0;
+        rec.pho = 0.0;
+        c.day = epoch + 18261.5 + tc / MinutesPerDay;
+        const double xnodce = std::fmod(4.5236020 - 9.2422029e-4 * c.day, TwoPi);
+        const double stem = std::sin(xnodce);
+        const double ctem = std::cos(xnodce);
+        const double zcosil = 0.91375164 - 0.03568096 * ctem;
+        const double zsinil = std::sqrt(1.0 - zcosil * zcosil);
+        const double zsinhl = 0.089683511 * stem / zsinil;
+        const double zcoshl = std::sqrt(1.0 - zsinhl * zsinhl);
+        c.gam = 5.8351514 + 0.0019443680 * c.day;
+        double zx = 0.39785416 * stem / zsinil;
+        const double zy = zcoshl * ctem + 0.91744867 * zsinhl * stem;
+        zx = std::atan2(zx, zy);
+        zx = c.gam + zx - xnodce;
+        const double zcosgl = std::cos(zx);
+        const double zsingl = std::sin(zx);
+
+        // Do the solar terms first and the lunar terms second
+        double zcosg = Zcosgs;
+        double zsing = Zsings;
+        double zcosi = Zcosis;
+        double zsini = Zsinis;
+        double zcosh = c.cnodm;
+        double zsinh = c.snodm;
+        double cc = C1ss;
+        const double xnoi = 1.0 / c.nm;
+
+        for (int lsflg = 1; lsflg <= 2; lsflg++) {
+            const double a1 = zcosg * zcosh + zsing * zcosi * zsinh;
+            const double a3 = -zsing * zcosh + zcosg * zcosi * zsinh;
+            const double a7 = -zcosg * zsinh + zsing * zcosi * zcosh;
+            const double a8 = zsing * zsini;
+            const double a9 = zsing * zsinh + zcosg * zcosi * zcosh;
+            const double a10 = zcosg * zsini;
+            const double a2 = c.cosim * a7 + c.sinim * a8;
+            const double a4 = c.cosim * a9 + c.sinim * a10;
+            const double a5 = -c.sinim * a7 + c.cosim * a8;
+            const double a6 = -c.sinim * a9 + c.cosim * a10;
+
+            const double x1 = a1 * c.cosomm + a2 * c.sinomm;
+            const double x2 = a3 * c.cosomm + a4 * c.sinomm;
+            const double x3 = -a1 * c.sinomm + a2 * c.cosomm;
+            const double x4 = -a3 * c.sinomm + a4 * c.cosomm;
+            const double x5 = a5 * c.sinomm;
+            const double x6 = a6 * c.sinomm;
+            const double x7 = a5 * c.cosomm;
+            const double x8 = a6 * c.cosomm;
+
+            c.z31 = 12.0 * x1 * x1 - 3.0 * x3 * x3;
+            c.z32 = 24.0 * x1 * x2 - 6.0 * x3 * x4;
+            c.z33 = 12.0 * x2 * x2 - 3.0 * x4 * x4;
+            c.z1 = 3.0 * (a1 * a1 + a2 * a2) + c.z31 * c.emsq;
+            c.z2 = 6.0 * (a1 * a3 + a2 * a4) + c.z32 * c.emsq;
+            c.z3 = 3.0 * (a3 * a3 + a4 * a4) + c.z33 * c.emsq;
+            c.z11 = -6.0 * a1 * a5 + c.emsq * (-24.0 * x1 * x7 - 6.0 * x3 * x5);
+            c.z12 = -6.0 * (a1 * a6 + a3 * a5) +
+                c.emsq * (-24.0 * (x2 * x7 + x1 * x8) - 6.0 * (x3 * x6 + x4 * x5));
+            c.z13 = -6.0 * a3 * a6 + c.emsq * (-24.0 * x2 * x8 - 6.0 * x4 * x6);
+            c.z21 = 6.0 * a2 * a5 + c.emsq * (24.0 * x1 * x5 - 6.0 * x3 * x7);
+            c.z22 = 6.0 * (a4 * a5 + a2 * a6) +
+                c.emsq * (24.0 * (x2 * x5 + x1 * x6) - 6.0 * (x4 * x7 + x3 * x8));
+            c.z23 = 6.0 * a4 * a6 + c.emsq * (24.0 * x2 * x6 - 6.0 * x4 * x8);
+            c.z1 = c.z1 + c.z1 + betasq * c.z31;
+            c.z2 = c.z2 + c.z2 + betasq * c.z32;
+            c.z3 = c.z3 + c.z3 + betasq * c.z33;
+            c.s3 = cc * xnoi;
+            c.s2 = -0.5 * c.s3 / c.rtemsq;
+            c.s4 = c.s3 * c.rtemsq;
+            c.s1 = -15.0 * c.em * c.s4;
+            c.s5 = x1 * x3 + x2 * x4;
+            c.s6 = x2 * x3 + x1 * x4;
+            c.s7 = x2 * x4 - x1 * x3;
+
+            if (lsflg == 1) {
+                c.ss1 = c.s1;
+                c.ss2 = c.s2;
+                c.ss3 = c.s3;
+                c.ss4 = c.s4;
+                c.ss5 = c.s5;
+                c.ss6 = c.s6;
+                c.ss7 = c.s7;
+                c.sz1 = c.z1;
+                c.sz2 = c.z2;
+                c.sz3 = c.z3;
+                c.sz11 = c.z11;
+                c.sz12 = c.z12;
+                c.sz13 = c.z13;
+                c.sz21 = c.z21;
+                c.sz22 = c.z22;
+                c.sz23 = c.z23;
+                c.sz31 = c.z31;
+                c.sz32 = c.z32;
+                c.sz33 = c.z33;
+                zcosg = zcosgl;
+                zsing = zsingl;
+                zcosi = zcosil;
+                zsini = zsinil;
+                zcosh = zcoshl * c.cnodm + zsinhl * c.snodm;
+                zsinh = c.snodm * zcoshl - c.cnodm * zsinhl;
+                cc = C1l;
+            }
+        }
+
+        rec.zmol = std::fmod(4.7199672 + 0.22997150 * c.day - c.gam, TwoPi);
+        rec.zmos = std::fmod(6.2565837 + 0.017201977 * c.day, TwoPi);
+
+        // Solar terms
+        rec.se2 = 2.0 * c.ss1 * c.ss6;
+        rec.se3 = 2.0 * c.ss1 * c.ss7;
+        rec.si2 = 2.0 * c.ss2 * c.sz12;
+        rec.si3 = 2.0 * c.ss2 * (c.sz13 - c.sz11);
+        rec.sl2 = -2.0 * c.ss3 * c.sz2;
+        rec.sl3 = -2.0 * c.ss3 * (c.sz3 - c.sz1);
+        rec.sl4 = -2.0 * c.ss3 * (-21.0 - 9.0 * c.emsq) * Zes;
+        rec.sgh2 = 2.0 * c.ss4 * c.sz32;
+        rec.sgh3 = 2.0 * c.ss4 * (c.sz33 - c.sz31);
+        rec.sgh4 = -18.0 * c.ss4 * Zes;
+        rec.sh2 = -2.0 * c.ss2 * c.sz22;
+        rec.sh3 = -2.0 * c.ss2 * (c.sz23 - c.sz21);
+
+        // Lunar terms
+        rec.ee2 = 2.0 * c.s1 * c.s6;
+        rec.e3 = 2.0 * c.s1 * c.s7;
+        rec.xi2 = 2.0 * c.s2 * c.z12;
+        rec.xi3 = 2.0 * c.s2 * (c.z13 - c.z11);
+        rec.xl2 = -2.0 * c.s3 * c.z2;
+        rec.xl3 = -2.0 * c.s3 * (c.z3 - c.z1);
+        rec.xl4 = -2.0 * c.s3 * (-21.0 - 9.0 * c.emsq) * Zel;
+        rec.xgh2 = 2.0 * c.s4 * c.z32;
+        rec.xgh3 = 2.0 * c.s4 * (c.z33 - c.z31);
+        rec.xgh4 = -18.0 * c.s4 * Zel;
+        rec.xh2 = -2.0 * c.s2 * c.z22;
+        rec.xh3 = -2.0 * c.s2 * (c.z23 - c.z21);
+
+        return c;
+    }
+
+    // Applies the lunar and solar periodic terms to the elements
+    void dpper(const Record& rec, double t, double& ep, double& inclp, double& nodep,
+               double& argpp, double& mp)
+    {
+        constexpr double Zns = 1.19459e-5;
+        constexpr double Zes = 0.01675;
+        constexpr double Znl = 1.5835218e-4;
+        constexpr double Zel = 0.05490;
+
+        // Solar terms
+        double zm = rec.zmos + Zns * t;
+        double zf = zm + 2.0 * Zes * std::sin(zm);
+        double sinzf = std::sin(zf);
+        double f2 = 0.5 * sinzf * sinzf - 0.25;
+        double f3 = -0.5 * sinzf * std::cos(zf);
+        const double ses = rec.se2 * f2 + rec.se3 * f3;
+        const double sis = rec.si2 * f2 + rec.si3 * f3;
+        const double sls = rec.sl2 * f2 + rec.sl3 * f3 + rec.sl4 * sinzf;
+        const double sghs = rec.sgh2 * f2 + rec.sgh3 * f3 + rec.sgh4 * sinzf;
+        const double shs = rec.sh2 * f2 + rec.sh3 * f3;
+
+        // Lunar terms
+        zm = rec.zmol + Znl * t;
+        zf = zm + 2.0 * Zel * std::sin(zm);
+        sinzf = std::sin(zf);
+        f2 = 0.5 * sinzf * sinzf - 0.25;
+        f3 = -0.5 * sinzf * std::cos(zf);
+        const double sel = rec.ee2 * f2 + rec.e3 * f3;
+        const double sil = rec.xi2 * f2 + rec.xi3 * f3;
+        const double sll = rec.xl2 * f2 + rec.xl3 * f3 + rec.xl4 * sinzf;
+        const double sghl = rec.xgh2 * f2 + rec.xgh3 * f3 + rec.xgh4 * sinzf;
+        const double shll = rec.xh2 * f2 + rec.xh3 * f3;
+
+        const double pe = ses + sel - rec.peo;
+        const double pinc = sis + sil - rec.pinco;
+        const double pl = sls + sll - rec.plo;
+        double pgh = sghs + sghl - rec.pgho;
+        double ph = shs + shll - rec.pho;
+
+        inclp = inclp + pinc;
+        ep = ep + pe;
+        const double sinip = std::sin(inclp);
+        const double cosip = std::cos(inclp);
+
+        if (inclp >= 0.2) {
+            // Apply the periodics directly
+            ph = ph / sinip;
+            pgh = pgh - cosip * ph;
+            argpp = argpp + pgh;
+            nodep = nodep + ph;
+            mp = mp + pl;
+        }
+        else {
+            // Apply the periodics with the Lyddane modification for small inclinations
+            const double sinop = std::sin(nodep);
+            const double cosop = std::cos(nodep);
+            double alfdp = sinip * sinop;
+            double betdp = sinip * cosop;
+            const double dalf = ph * cosop + pinc * cosip * sinop;
+            const double dbet = -ph * sinop + pinc * cosip * cosop;
+            alfdp = alfdp + dalf;
+            betdp = betdp + dbet;
+            nodep = std::fmod(nodep, TwoPi);
+            double xls = mp + argpp + cosip * nodep;
+            const double dls = pl + pgh - pinc * nodep * sinip;
+            xls = xls + dls;
+            const double xnoh = nodep;
+            nodep = std::atan2(alfdp, betdp);
+            if (std::abs(xnoh - nodep) > Pi) {
+                nodep = nodep < xnoh ? nodep + TwoPi : nodep - TwoPi;
+            }
+            mp = mp + pl;
+            argpp = xls - mp - cosip * nodep;
+        }
+    }
+
+    // Computes the secular rates of the lunar and solar terms and the coefficients of
+    // the resonance terms for objects with a period of 12 hours or 24 hours
+    void dsinit(Record& rec, const DeepSpaceCommon& c, double mdot, double nodedot,
+                double xpidot, double eccsq, double& nm)
+    {
+        constexpr double Q22 = 1.7891679e-6;
+        constexpr double Q31 = 2.1460748e-6;
+        constexpr double Q33 = 2.2123015e-7;
+        constexpr double Root22 = 1.7891679e-6;
+        constexpr double Root44 = 7.3636953e-9;
+        constexpr double Root54 = 2.1765803e-9;
+        constexpr double Root32 = 3.7393792e-7;
+        constexpr double Root52 = 1.1428639e-7;
+        constexpr double Znl = 1.5835218e-4;
+        constexpr double Zns = 1.19459e-5;
+
+        const double em = c.em;
+        const double emsq = c.emsq;
+        const double inclm = rec.inclo;
+
+        // Determine whether the object is in resonance
+        rec.irez = 0;
+        if (nm < 0.0052359877 && nm > 0.0034906585) {
+            rec.irez = 1;
+        }
+        if (nm >= 8.26e-3 && nm <= 9.24e-3 && em >= 0.5) {
+            rec.irez = 2;
+        }
+
+        // Solar terms
+        const double ses = c.ss1 * Zns * c.ss5;
+        const double sis = c.ss2 * Zns * (c.sz11 + c.sz13);
+        const double sls = -Zns * c.ss3 * (c.sz1 + c.sz3 - 14.0 - 6.0 * emsq);
+        const double sghs = c.ss4 * Zns * (c.sz31 + c.sz33 - 6.0);
+        double shs = -Zns * c.ss2 * (c.sz21 + c.sz23);
+        if (inclm < 5.2359877e-2 || inclm > Pi - 5.2359877e-2) {
+            shs = 0.0;
+        }
+        if (c.sinim != 0.0) {
+            shs = shs / c.sinim;
+        }
+        const double sgs = sghs - c.cosim * shs;
+
+        // Lunar terms
+        rec.dedt = ses + c.s1 * Znl * c.s5;
+        rec.didt = sis + c.s2 * Znl * (c.z11 + c.z13);
+        rec.dmdt = sls - Znl * c.s3 * (c.z1 + c.z3 - 14.0 - 6.0 * emsq);
+        const double sghl = c.s4 * Znl * (c.z31 + c.z33 - 6.0);
+        double shll = -Znl * c.s2 * (c.z21 + c.z23);
+        if (inclm < 5.2359877e-2 || inclm > Pi - 5.2359877e-2) {
+            shll = 0.0;
+        }
+        rec.domdt = sgs + sghl;
+        rec.dnodt = shs;
+        if (c.sinim != 0.0) {
+            rec.domdt = rec.domdt - c.cosim / c.sinim * shll;
+            rec.dnodt = rec.dnodt + shll / c.sinim;
+        }
+
+        if (rec.irez == 0) {
+            return;
+        }
+
+        const double theta = rec.gsto;
+        const double aonv = std::pow(nm / xke(), X2o3);
+
+        if (rec.irez == 2) {
+            // Geopotential resonance for 12 hour orbits
+            const double cosisq = c.cosim * c.cosim;
+            const double e = rec.ecco;
+            const double esq = eccsq;
+            const double eoc = e * esq;
+            const double g201 = -0.306 - (e - 0.64) * 0.440;
+
+            double g211 = 0.0;
+            double g310 = 0.0;
+            double g322 = 0.0;
+            double g410 = 0.0;
+            double g422 = 0.0;
+            double g520 = 0.0;
+            if (e <= 0.65) {
+                g211 = 3.616 - 13.2470 * e + 16.2900 * esq;
+                g310 = -19.302 + 117.3900 * e - 228.4190 * esq + 156.5910 * eoc;
+                g322 = -18.9068 + 109.7927 * e - 214.6334 * esq + 146.5816 * eoc;
+                g410 = -41.122 + 242.6940 * e - 471.0940 * esq + 313.9530 * eoc;
+                g422 = -146.407 + 841.8800 * e - 1629.014 * esq + 1083.4350 * eoc;
+                g520 = -532.114 + 3017.977 * e - 5740.032 * esq + 3708.2760 * eoc;
+            }
+            else {
+                g211 = -72.099 + 331.819 * e - 508.738 * esq + 266.724 * eoc;
+                g310 = -346.844 + 1582.851 * e - 2415.925 * esq + 1246.113 * eoc;
+                g322 = -342.585 + 1554.908 * e - 2366.899 * esq + 1215.972 * eoc;
+                g410 = -1052.797 + 4758.686 * e - 7193.992 * esq + 3651.957 * eoc;
+                g422 = -3581.690 + 16178.110 * e - 24462.770 * esq + 12422.520 * eoc;
+                if (e > 0.715) {
+                    g520 = -5149.66 + 29936.92 * e - 54087.36 * esq + 31324.56 * eoc;
+                }
+                else {
+                    g520 = 1464.74 - 4664.75 * e + 3763.64 * esq;
+                }
+            }
+
+            double g533 = 0.0;
+            double g521 = 0.0;
+            double g532 = 0.0;
+            if (e < 0.7) {
+                g533 = -919.22770 + 4988.6100 * e - 9064.7700 * esq + 5542.21 * eoc;
+                g521 = -822.71072 + 4568.6173 * e - 8491.4146 * esq + 5337.524 * eoc;
+                g532 = -853.66600 + 4690.2500 * e - 8624.7700 * esq + 5341.4 * eoc;
+            }
+            else {
+                g533 = -37995.780 + 161616.52 * e - 229838.20 * esq + 109377.94 * eoc;
+                g521 = -51752.104 + 218913.95 * e - 309468.16 * esq + 146349.42 * eoc;
+                g532 = -40023.880 + 170470.89 * e - 242699.48 * esq + 115605.82 * eoc;
+            }
+
+            const double sini2 = c.sinim * c.sinim;
+            const double f220 = 0.75 * (1.0 + 2.0 * c.cosim + cosisq);
+            const double f221 = 1.5 * sini2;
+            const double f321 = 1.875 * c.sinim * (1.0 - 2.0 * c.cosim - 3.0 * cosisq);
+            const double f322 = -1.875 * c.sinim * (1.0 + 2.0 * c.cosim - 3.0 * cosisq);
+            const double f441 = 35.0 * sini2 * f220;
+            const double f442 = 39.3750 * sini2 * sini2;
+            const double f522 = 9.84375 * c.sinim * (sini2 * (1.0 - 2.0 * c.cosim -
+                5.0 * cosisq) + 0.33333333 * (-2.0 + 4.0 * c.cosim + 6.0 * cosisq));
+            const double f523 = c.sinim * (4.92187512 * sini2 * (-2.0 - 4.0 * c.cosim +
+                10.0 * cosisq) + 6.56250012 * (1.0 + 2.0 * c.cosim - 3.0 * cosisq));
+            const double f542 = 29.53125 * c.sinim * (2.0 - 8.0 * c.cosim + cosisq *
+                (-12.0 + 8.0 * c.cosim + 10.0 * cosisq));
+            const double f543 = 29.53125 * c.sinim * (-2.0 - 8.0 * c.cosim + cosisq *
+                (12.0 + 8.0 * c.cosim - 10.0 * cosisq));
+
+            const double xno2 = nm * nm;
+            const double ainv2 = aonv * aonv;
+            double temp1 = 3.0 * xno2 * ainv2;
+            double temp = temp1 * Root22;
+            rec.d2201 = temp * f220 * g201;
+            rec.d2211 = temp * f221 * g211;
+            temp1 = temp1 * aonv;
+            temp = temp1 * Root32;
+            rec.d3210 = temp * f321 * g310;
+            rec.d3222 = temp * f322 * g322;
+            temp1 = temp1 * aonv;
+            temp = 2.0 * temp1 * Root44;
+            rec.d4410 = temp * f441 * g410;
+            rec.d4422 = temp * f442 * g422;
+            temp1 = temp1 * aonv;
+            temp = temp1 * Root52;
+            rec.d5220 = temp * f522 * g520;
+            rec.d5232 = temp * f523 * g532;
+            temp = 2.0 * temp1 * Root54;
+            rec.d5421 = temp * f542 * g521;
+            rec.d5433 = temp * f543 * g533;
+            rec.xlamo = std::fmod(rec.mo + rec.nodeo + rec.nodeo - theta - theta, TwoPi);
+            rec.xfact =
+                mdot + rec.dmdt + 2.0 * (nodedot + rec.dnodt - Rptim) - rec.no;
+        }
+        else {
+            // Synchronous resonance terms
+            const double g200 = 1.0 + emsq * (-2.5 + 0.8125 * emsq);
+            const double g310 = 1.0 + 2.0 * emsq;
+            const double g300 = 1.0 + emsq * (-6.0 + 6.60937 * emsq);
+            const double f220 = 0.75 * (1.0 + c.cosim) * (1.0 + c.cosim);
+            const double f311 = 0.9375 * c.sinim * c.sinim * (1.0 + 3.0 * c.cosim) -
+                0.75 * (1.0 + c.cosim);
+            double f330 = 1.0 + c.cosim;
+            f330 = 1.875 * f330 * f330 * f330;
+            const double del = 3.0 * nm * nm * aonv * aonv;
+            rec.del2 = 2.0 * del * f220 * g200 * Q22;
+            rec.del3 = 3.0 * del * f330 * g300 * Q33 * aonv;
+            rec.del1 = del * f311 * g310 * Q31 * aonv;
+            rec.xlamo = std::fmod(rec.mo + rec.nodeo + rec.argpo - theta, TwoPi);
+            rec.xfact = mdot + xpidot - Rptim + rec.dmdt + rec.domdt + rec.dnodt - rec.no;
+        }
+
+        // Initialize the integrator
+        rec.xli = rec.xlamo;
+        rec.xni = rec.no;
+        rec.atime = 0.0;
+    }
+
+    // Applies the secular lunar and solar terms and integrates the resonance effects
+    void dspace(Record& rec, double t, double& em, double& argpm, double& inclm,
+                double& mm, double& nodem, double& nm)
+    {
+        constexpr double Fasx2 = 0.13130908;
+        constexpr double Fasx4 = 2.8843198;
+        constexpr double Fasx6 = 0.37448087;
+        constexpr double G22 = 5.7686396;
+        constexpr double G32 = 0.95240898;
+        constexpr double G44 = 1.8014998;
+        constexpr double G52 = 1.0508330;
+        constexpr double G54 = 4.4108898;
+        constexpr double StepP = 720.0;
+        constexpr double StepN = -720.0;
+        constexpr double Step2 = 259200.0;
+
+        const double theta = std::fmod(rec.gsto + t * Rptim, TwoPi);
+        em = em + rec.dedt * t;
+        inclm = inclm + rec.didt * t;
+        argpm = argpm + rec.domdt * t;
+        nodem = nodem + rec.dnodt * t;
+        mm = mm + rec.dmdt * t;
+
+        if (rec.irez == 0) {
+            return;
+        }
+
+        // Restart the integration at the epoch if the requested time lies in the other
+        // direction or closer to the epoch than the last integration step
+        if (rec.atime == 0.0 || t * rec.atime <= 0.0 || std::abs(t) < std::abs(rec.atime))
+        {
+            rec.atime = 0.0;
+            rec.xni = rec.no;
+            rec.xli = rec.xlamo;
+        }
+        const double delt = t > 0.0 ? StepP : StepN;
+
+        double xndt = 0.0;
+        double xldot = 0.0;
+        double xnddt = 0.0;
+        double ft = 0.0;
+        while (true) {
+            // Compute the dot terms
+            if (rec.irez != 2) {
+                // Near-synchronous resonance terms
+                xndt = rec.del1 * std::sin(rec.xli - Fasx2) +
+                    rec.del2 * std::sin(2.0 * (rec.xli - Fasx4)) +
+                    rec.del3 * std::sin(3.0 * (rec.xli - Fasx6));
+                xldot = rec.xni + rec.xfact;
+                xnddt = rec.del1 * std::cos(rec.xli - Fasx2) +
+                    2.0 * rec.del2 * std::cos(2.0 * (rec.xli - Fasx4)) +
+                    3.0 * rec.del3 * std::cos(3.0 * (rec.xli - Fasx6));
+                xnddt = xnddt * xldot;
+            }
+            else {
+                // Near-half-day resonance terms
+                const double xomi = rec.argpo + rec.argpdot * rec.atime;
+                const double x2omi = xomi + xomi;
+                const double x2li = rec.xli + rec.xli;
+                xndt = rec.d2201 * std::sin(x2omi + rec.xli - G22) +
+                    rec.d2211 * std::sin(rec.xli - G22) +
+                    rec.d3210 * std::sin(xomi + rec.xli - G32) +
+                    rec.d3222 * std::sin(-xomi + rec.xli - G32) +
+                    rec.d4410 * std::sin(x2omi + x2li - G44) +
+                    rec.d4422 * std::sin(x2li - G44) +
+                    rec.d5220 * std::sin(xomi + rec.xli - G52) +
+                    rec.d5232 * std::sin(-xomi + rec.xli - G52) +
+                    rec.d5421 * std::sin(xomi + x2li - G54) +
+                    rec.d5433 * std::sin(-xomi + x2li - G54);
+                xldot = rec.xni + rec.xfact;
+                xnddt = rec.d2201 * std::cos(x2omi + rec.xli - G22) +
+                    rec.d2211 * std::cos(rec.xli - G22) +
+                    rec.d3210 * std::cos(xomi + rec.xli - G32) +
+                    rec.d3222 * std::cos(-xomi + rec.xli - G32) +
+                    rec.d5220 * std::cos(xomi + rec.xli - G52) +
+                    rec.d5232 * std::cos(-xomi + rec.xli - G52) +
+                    2.0 * (rec.d4410 * std::cos(x2omi + x2li - G44) +
+                    rec.d4422 * std::cos(x2li - G44) +
+                    rec.d5421 * std::cos(xomi + x2li - G54) +
+                    rec.d5433 * std::cos(-xomi + x2li - G54));
+                xnddt = xnddt * xldot;
+            }
+
+            if (std::abs(t - rec.atime) < StepP) {
+                ft = t - rec.atime;
+                break;
+            }
+
+            // Integrate one more step
+            rec.xli = rec.xli + xldot * delt + xndt * Step2;
+            rec.xni = rec.xni + xndt * delt + xnddt * Step2;
+            rec.atime = rec.atime + delt;
+        }
+
+        nm = rec.xni + xndt * ft + xnddt * ft * ft * 0.5;
+        const double xl = rec.xli + xldot * ft + xndt * ft * ft * 0.5;
+        if (rec.irez != 1) {
+            mm = xl - 2.0 * nodem + 2.0 * theta;
+        }
+        else {
+            mm = xl - nodem - argpm + theta;
+        }
+    }
+
+    Record initialize(const Elements& elements) {
+        constexpr double Temp4 = 1.5e-12;
+
+        Record rec;
+        rec.bstar = elements.bstar;
+        rec.ecco = elements.eccentricity;
+        rec.inclo = elements.inclination * Deg2Rad;
+        rec.nodeo = elements.ascendingNode * Deg2Rad;
+        rec.argpo = elements.argumentOfPerigee * Deg2Rad;
+        rec.mo = elements.meanAnomaly * Deg2Rad;
+        // Revolutions per day to radians per minute
+        const double no = elements.meanMotion * TwoPi / MinutesPerDay;
+        if (no <= 0.0) {
+            throw ghoul::RuntimeError(fmt::format(
+                "Invalid mean motion {} for object '{}'",
+                elements.meanMotion, elements.name
+            ));
+        }
+        if (rec.ecco < 0.0 || rec.ecco >= 1.0) {
+            throw ghoul::RuntimeError(fmt::format(
+                "Invalid eccentricity {} for object '{}'", rec.ecco, elements.name
+            ));
+        }
+
+        // Days since 1950 Jan 0.0
+        const double epoch = elements.julianDate - 2433281.5;
+        const double ss = 78.0 / RadiusEarth + 1.0;
+        const double qzms2t = std::pow((120.0 - 78.0) / RadiusEarth, 4.0);
+
+        // Recover the original mean motion and semi-major axis from the elements
+        const double eccsq = rec.ecco * rec.ecco;
+        const double omeosq = 1.0 - eccsq;
+        const double rteosq = std::sqrt(omeosq);
+        const double cosio = std::cos(rec.inclo);
+        const double cosio2 = cosio * cosio;
+        const double ak = std::pow(xke() / no, X2o3);
+        const double d1 = 0.75 * J2 * (3.0 * cosio2 - 1.0) / (rteosq * omeosq);
+        double delta = d1 / (ak * ak);
+        const double adel = ak * (1.0 - delta * delta - delta *
+            (1.0 / 3.0 + 134.0 * delta * delta / 81.0));
+        delta = d1 / (adel * adel);
+        rec.no = no / (1.0 + delta);
+
+        const double ao = std::pow(xke() / rec.no, X2o3);
+        const double sinio = std::sin(rec.inclo);
+        const double po = ao * omeosq;
+        const double con42 = 1.0 - 5.0 * cosio2;
+        rec.con41 = -con42 - cosio2 - cosio2;
+        const double posq = po * po;
+        const double rp = ao * (1.0 - rec.ecco);
+        rec.gsto = greenwichSiderealTime(epoch + 2433281.5);
+
+        // Use the simplified model if the perigee is less than 220 km
+        rec.isSimple = rp < (220.0 / RadiusEarth + 1.0);
+
+        // For perigees below 156 km, the values of s and qoms2t are altered
+        double sfour = ss;
+        double qzms24 = qzms2t;
+        const double perige = (rp - 1.0) * RadiusEarth;
+        if (perige < 156.0) {
+            sfour = perige < 98.0 ? 20.0 : perige - 78.0;
+            qzms24 = std::pow((120.0 - sfour) / RadiusEarth, 4.0);
+            sfour = sfour / RadiusEarth + 1.0;
+        }
+        const double pinvsq = 1.0 / posq;
+
+        const double tsi = 1.0 / (ao - sfour);
+        rec.eta = ao * rec.ecco * tsi;
+        const double etasq = rec.eta * rec.eta;
+        const double eeta = rec.ecco * rec.eta;
+        const double psisq = std::abs(1.0 - etasq);
+        const double coef = qzms24 * std::pow(tsi, 4.0);
+        const double coef1 = coef / std::pow(psisq, 3.5);
+        const double cc2 = coef1 * rec.no * (ao * (1.0 + 1.5 * etasq + eeta *
+            (4.0 + etasq)) + 0.375 * J2 * tsi / psisq * rec.con41 *
+            (8.0 + 3.0 * etasq * (8.0 + etasq)));
+        rec.cc1 = rec.bstar * cc2;
+        double cc3 = 0.0;
+        if (rec.ecco > 1.0e-4) {
+            cc3 = -2.0 * coef * tsi * J3oJ2 * rec.no * sinio / rec.ecco;
+        }
+        rec.x1mth2 = 1.0 - cosio2;
+        rec.cc4 = 2.0 * rec.no * coef1 * ao * omeosq * (rec.eta * (2.0 + 0.5 * etasq) +
+            rec.ecco * (0.5 + 2.0 * etasq) - J2 * tsi / (ao * psisq) *
+            (-3.0 * rec.con41 * (1.0 - 2.0 * eeta + etasq * (1.5 - 0.5 * eeta)) +
+            0.75 * rec.x1mth2 * (2.0 * etasq - eeta * (1.0 + etasq)) *
+            std::cos(2.0 * rec.argpo)));
+        rec.cc5 = 2.0 * coef1 * ao * omeosq *
+            (1.0 + 2.75 * (etasq + eeta) + eeta * etasq);
+        const double cosio4 = cosio2 * cosio2;
+        const double temp1 = 1.5 * J2 * pinvsq * rec.no;
+        const double temp2 = 0.5 * temp1 * J2 * pinvsq;
+        const double temp3 = -0.46875 * J4 * pinvsq * pinvsq * rec.no;
+        rec.mdot = rec.no + 0.5 * temp1 * rteosq * rec.con41 +
+            0.0625 * temp2 * rteosq * (13.0 - 78.0 * cosio2 + 137.0 * cosio4);
+        rec.argpdot = -0.5 * temp1 * con42 +
+            0.0625 * temp2 * (7.0 - 114.0 * cosio2 + 395.0 * cosio4) +
+            temp3 * (3.0 - 36.0 * cosio2 + 49.0 * cosio4);
+        const double xhdot1 = -temp1 * cosio;
+        rec.nodedot = xhdot1 + (0.5 * temp2 * (4.0 - 19.0 * cosio2) +
+            2.0 * temp3 * (3.0 - 7.0 * cosio2)) * cosio;
+        const double xpidot = rec.argpdot + rec.nodedot;
+        rec.omgcof = rec.bstar * cc3 * std::cos(rec.argpo);
+        rec.xmcof = 0.0;
+        if (rec.ecco > 1.0e-4) {
+            rec.xmcof = -X2o3 * coef * rec.bstar / eeta;
+        }
+        rec.nodecf = 3.5 * omeosq * xhdot1 * rec.cc1;
+        rec.t2cof = 1.5 * rec.cc1;
+        // Avoid a division by zero for an inclination of 180 degrees
+        const double cosio1 = std::abs(cosio + 1.0) > 1.5e-12 ? 1.0 + cosio : Temp4;
+        rec.xlcof = -0.25 * J3oJ2 * sinio * (3.0 + 5.0 * cosio) / cosio1;
+        rec.aycof = -0.5 * J3oJ2 * sinio;
+        rec.delmo = std::pow(1.0 + rec.eta * std::cos(rec.mo), 3.0);
+        rec.sinmao = std::sin(rec.mo);
+        rec.x7thm1 = 7.0 * cosio2 - 1.0;
+
+        // Deep space initialization for periods of 225 minutes or more
+        if (TwoPi / rec.no >= 225.0) {
+            rec.isDeepSpace = true;
+            rec.isSimple = true;
+            const DeepSpaceCommon c = dscom(
+                epoch,
+                rec.ecco,
+                rec.argpo,
+                0.0,
+                rec.inclo,
+                rec.nodeo,
+                rec.no,
+                rec
+            );
+            double nm = c.nm;
+            dsinit(rec, c, rec.mdot, rec.nodedot, xpidot, eccsq, nm);
+        }
+
+        // Set the variables that are only needed for the full near earth model
+        if (!rec.isSimple) {
+            const double cc1sq = rec.cc1 * rec.cc1;
+            rec.d2 = 4.0 * ao * tsi * cc1sq;
+            const double temp = rec.d2 * tsi * rec.cc1 / 3.0;
+            rec.d3 = (17.0 * ao + sfour) * temp;
+            rec.d4 = 0.5 * temp * ao * tsi * (221.0 * ao + 31.0 * sfour) * rec.cc1;
+            rec.t3cof = rec.d2 + 2.0 * cc1sq;
+            rec.t4cof = 0.25 * (3.0 * rec.d3 + rec.cc1 * (12.0 * rec.d2 + 10.0 * cc1sq));
+            rec.t5cof = 0.2 * (3.0 * rec.d4 + 12.0 * rec.cc1 * rec.d3 +
+                6.0 * rec.d2 * rec.d2 + 15.0 * cc1sq * (2.0 * rec.d2 + cc1sq));
+        }
+
+        return rec;
+    }
+
+    Propagator::State propagate(Record& rec, double t) {
+        using Status = Propagator::Status;
+        constexpr double Temp4 = 1.5e-12;
+        const double vkmpersec = RadiusEarth * xke() / 60.0;
+
+        Propagator::State state;
+
+        // Update for secular gravity and atmospheric drag
+        const double xmdf = rec.mo + rec.mdot * t;
+        const double argpdf = rec.argpo + rec.argpdot * t;
+        const double nodedf = rec.nodeo + rec.nodedot * t;
+        double argpm = argpdf;
+        double mm = xmdf;
+        const double t2 = t * t;
+        double nodem = nodedf + rec.nodecf * t2;
+        double tempa = 1.0 - rec.cc1 * t;
+        double tempe = rec.bstar * rec.cc4 * t;
+        double templ = rec.t2cof * t2;
+
+        if (!rec.isSimple) {
+            const double delomg = rec.omgcof * t;
+            const double delm = rec.xmcof *
+                (std::pow(1.0 + rec.eta * std::cos(xmdf), 3.0) - rec.delmo);
+            const double temp = delomg + delm;
+            mm = xmdf + temp;
+            argpm = argpdf - temp;
+            const double t3 = t2 * t;
+            const double t4 = t3 * t;
+            tempa = tempa - rec.d2 * t2 - rec.d3 * t3 - rec.d4 * t4;
+            tempe = tempe + rec.bstar * rec.cc5 * (std::sin(mm) - rec.sinmao);
+            templ = templ + rec.t3cof * t3 + t4 * (rec.t4cof + t * rec.t5cof);
+        }
+
+        double nm = rec.no;
+        double em = rec.ecco;
+        double inclm = rec.inclo;
+        if (rec.isDeepSpace) {
+            dspace(rec, t, em, argpm, inclm, mm, nodem, nm);
+        }
+
+        if (nm <= 0.0) {
+            state.status = Status::InvalidMeanMotion;
+            return state;
+        }
+        const double am = std::pow(xke() / nm, X2o3) * tempa * tempa;
+        nm = xke() / std::pow(am, 1.5);
+        em = em - tempe;
+
+        if (em >= 1.0 || em < -0.001) {
+            state.status = Status::InvalidEccentricity;
+            return state;
+        }
+        // Avoid a division by zero
+        em = std::max(em, 1.0e-6);
+        mm = mm + rec.no * templ;
+        double xlm = mm + argpm + nodem;
+        nodem = std::fmod(nodem, TwoPi);
+        argpm = std::fmod(argpm, TwoPi);
+        xlm = std::fmod(xlm, TwoPi);
+        mm = std::fmod(xlm - argpm - nodem, TwoPi);
+
+        // Compute the extra mean quantities
+        double ep = em;
+        double xincp = inclm;
+        double argpp = argpm;
+        double nodep = nodem;
+        double mp = mm;
+        double sinip = std::sin(inclm);
+        double cosip = std::cos(inclm);
+
+        // Add the lunar and solar periodics
+        double aycof = rec.aycof;
+        double xlcof = rec.xlcof;
+        if (rec.isDeepSpace) {
+            dpper(rec, t, ep, xincp, nodep, argpp, mp);
+            if (xincp < 0.0) {
+                xincp = -xincp;
+                nodep = nodep + Pi;
+                argpp = argpp - Pi;
+            }
+            if (ep < 0.0 || ep > 1.0) {
+                state.status = Status::InvalidPerturbedEccentricity;
+                return state;
+            }
+
+            // The long period periodics depend on the perturbed inclination
+            sinip = std::sin(xincp);
+            cosip = std::cos(xincp);
+            aycof = -0.5 * J3oJ2 * sinip;
+            const double cosip1 = std::abs(cosip + 1.0) > 1.5e-12 ? 1.0 + cosip : Temp4;
+            xlcof = -0.25 * J3oJ2 * sinip * (3.0 + 5.0 * cosip) / cosip1;
+        }
+
+        // Long period periodics
+        const double axnl = ep * std::cos(argpp);
+        double temp = 1.0 / (am * (1.0 - ep * ep));
+        const double aynl = ep * std::sin(argpp) + temp * aycof;
+        const double xl = mp + argpp + nodep + temp * xlcof * axnl;
+
+        // Solve Kepler's equation
+        const double u = std::fmod(xl - nodep, TwoPi);
+        double eo1 = u;
+        double tem5 = 9999.9;
+        double sineo1 = 0.0;
+        double coseo1 = 0.0;
+        for (int ktr = 1; std::abs(tem5) >= 1.0e-12 && ktr <= 10; ktr++) {
+            sineo1 = std::sin(eo1);
+            coseo1 = std::cos(eo1);
+            tem5 = 1.0 - coseo1 * axnl - sineo1 * aynl;
+            tem5 = (u - aynl * coseo1 + axnl * sineo1 - eo1) / tem5;
+            tem5 = std::clamp(tem5, -0.95, 0.95);
+            eo1 = eo1 + tem5;
+        }
+
+        // Short period preliminary quantities
+        const double ecose = axnl * coseo1 + aynl * sineo1;
+        const double esine = axnl * sineo1 - aynl * coseo1;
+        const double el2 = axnl * axnl + aynl * aynl;
+        const double pl = am * (1.0 - el2);
+        if (pl < 0.0) {
+            state.status = Status::InvalidSemiLatusRectum;
+            return state;
+        }
+
+        const double rl = am * (1.0 - ecose);
+        const double rdotl = std::sqrt(am) * esine / rl;
+        const double rvdotl = std::sqrt(pl) / rl;
+        const double betal = std::sqrt(1.0 - el2);
+        temp = esine / (1.0 + betal);
+        const double sinu = am / rl * (sineo1 - aynl - axnl * temp);
+        const double cosu = am / rl * (coseo1 - axnl + aynl * temp);
+        double su = std::atan2(sinu, cosu);
+        const double sin2u = (cosu + cosu) * sinu;
+        const double cos2u = 1.0 - 2.0 * sinu * sinu;
+        temp = 1.0 / pl;
+        const double temp1 = 0.5 * J2 * temp;
+        const double temp2 = temp1 * temp;
+
+        double con41 = rec.con41;
+        double x1mth2 = rec.x1mth2;
+        double x7thm1 = rec.x7thm1;
+        if (rec.isDeepSpace) {
+            const double cosisq = cosip * cosip;
+            con41 = 3.0 * cosisq - 1.0;
+            x1mth2 = 1.0 - cosisq;
+            x7thm1 = 7.0 * cosisq - 1.0;
+        }
+
+        // Update for short period periodics
+        const double mrt = rl * (1.0 - 1.5 * temp2 * betal * con41) +
+            0.5 * temp1 * x1mth2 * cos2u;
+        su = su - 0.25 * temp2 * x7thm1 * sin2u;
+        const double xnode = nodep + 1.5 * temp2 * cosip * sin2u;
+        const double xinc = xincp + 1.5 * temp2 * cosip * sinip * cos2u;
+        const double mvt = rdotl - nm * temp1 * x1mth2 * sin2u / xke();
+        const double rvdot = rvdotl + nm * temp1 * (x1mth2 * cos2u + 1.5 * con41) / xke();
+
+        // Orientation vectors
+        const double sinsu = std::sin(su);
+        const double cossu = std::cos(su);
+        const double snod = std::sin(xnode);
+        const double cnod = std::cos(xnode);
+        const double sini = std::sin(xinc);
+        const double cosi = std::cos(xinc);
+        const double xmx = -snod * cosi;
+        const double xmy = cnod * cosi;
+        const glm::dvec3 uv = glm::dvec3(
+            xmx * sinsu + cnod * cossu,
+            xmy * sinsu + snod * cossu,
+            sini * sinsu
+        );
+        const glm::dvec3 vv = glm::dvec3(
+            xmx * cossu - cnod * sinsu,
+            xmy * cossu - snod * sinsu,
+            sini * cossu
+        );
+
+        state.position = mrt * uv * RadiusEarth;
+        state.velocity = (mvt * uv + rvdot * vv) * vkmpersec;
+        if (mrt < 1.0) {
+            state.status = Status::Decayed;
+        }
+        return state;
+    }
+
+    std::vector<Elements> readTleFile(const std::filesystem::path& file) {
+        std::ifstream f(file);
+        std::vector<std::string> lines;
+        std::string line;
+        while (std::getline(f, line)) {
+            std::string_view l = trim(line);
+            if (!l.empty()) {
+                lines.emplace_back(l);
+            }
+        }
+
+        std::vector<Elements> result;
+        size_t i = 0;
+        while (i < lines.size()) {
+            // The name line is optional and is prefixed by '0 ' in the 3LE format
+            std::string_view name;
+            if (lines[i].starts_with("1 ") && i + 1 < lines.size() &&
+                lines[i + 1].starts_with("2 "))
+            {
+                i += 2;
+            }
+            else {
+                name = lines[i];
+                if (name.starts_with("0 ")) {
+                    name.remove_prefix(2);
+                }
+                i += 3;
+            }
+            if (i > lines.size()) {
+                throw ghoul::RuntimeError(fmt::format(
+                    "Incomplete element set at the end of TLE file '{}'", file
+                ));
+            }
+
+            try {
+                result.push_back(parseTle(name, lines[i - 2], lines[i - 1]));
+            }
+            catch (const ghoul::RuntimeError& e) {
+                throw ghoul::RuntimeError(fmt::format(
+                    "Malformed TLE file '{}' at line {}: {}", file, i - 1, e.message
+                ));
+            }
+        }
+        return result;
+    }
+
+    std::vector<Elements> readOmmFile(const std::filesystem::path& file) {
+        std::ifstream f(file);
+
+        std::vector<Elements> result;
+        std::optional<Elements> current;
+        std::string line;
+        int lineNumber = 0;
+        while (std::getline(f, line)) {
+            lineNumber++;
+            const std::string_view l = trim(line);
+            if (l.empty() || l.starts_with("COMMENT")) {
+                continue;
+            }
+
+            const size_t separator = l.find('=');
+            if (separator == std::string_view::npos) {
+                throw ghoul::RuntimeError(fmt::format(
+                    "Malformed line '{}' in OMM file '{}' at {}", l, file, lineNumber
+                ));
+            }
+            const std::string_view key = trim(l.substr(0, separator));
+            std::string_view value = trim(l.substr(separator + 1));
+            // Remove optional units, for example '15.5 [rev/day]'
+            if (const size_t unit = value.find('['); unit != std::string_view::npos) {
+                value = trim(value.substr(0, unit));
+            }
+
+            if (key == "CCSDS_OMM_VERS") {
+                if (current.has_value()) {
+                    result.push_back(std::move(*current));
+                }
+                current = Elements();
+                continue;
+            }
+            if (!current.has_value()) {
+                throw ghoul::RuntimeError(fmt::format(
+                    "OMM file '{}' does not start with CCSDS_OMM_VERS", file
+                ));
+            }
+
+            if (key == "OBJECT_NAME") {
+                current->name = value;
+            }
+            else if (key == "OBJECT_ID") {
+                current->id = value;
+            }
+            else if (key == "NORAD_CAT_ID") {
+                current->noradId = parseCatalogNumber(value);
+            }
+            else if (key == "EPOCH") {
+                current->julianDate = julianDateFromIso(value);
+                current->epoch = j2000Seconds(current->julianDate);
+            }
+            else if (key == "MEAN_MOTION") {
+                current->meanMotion = parseDouble(value, key);
+            }
+            else if (key == "ECCENTRICITY") {
+                current->eccentricity = parseDouble(value, key);
+            }
+            else if (key == "INCLINATION") {
+                current->inclination = parseDouble(value, key);
+            }
+            else if (key == "RA_OF_ASC_NODE") {
+                current->ascendingNode = parseDouble(value, key);
+            }
+            else if (key == "ARG_OF_PERICENTER") {
+                current->argumentOfPerigee = parseDouble(value, key);
+            }
+            else if (key == "MEAN_ANOMALY") {
+                current->meanAnomaly = parseDouble(value, key);
+            }
+            else if (key == "BSTAR") {
+                current->bstar = parseDouble(value, key);
+            }
+        }
+
+        if (current.has_value()) {
+            result.push_back(std::move(*current));
+        }
+        return result;
+    }
+} // namespace
+
+Elements parseTle(std::string_view name, std::string_view line1, std::string_view line2)
+{
+    line1 = trim(line1);
+    line2 = trim(line2);
+    if (line1.size() < 61 || line1[0] != '1') {
+        throw ghoul::RuntimeError(fmt::format("Invalid first line '{}'", line1));
+    }
+    if (line2.size() < 63 || line2[0] != '2') {
+        throw ghoul::RuntimeError(fmt::format("Invalid second line '{}'", line2));
+    }
+
+    Elements res;
+    res.name = trim(name);
+    res.noradId = parseCatalogNumber(line1.substr(2, 5));
+
+    // The international designator only contains the last two digits of the year
+    const std::string_view designator = trim(line1.substr(9, 8));
+    if (designator.size() >= 5) {
+        const int year = static_cast<int>(parseDouble(designator.substr(0, 2), "year"));
+        res.id = fmt::format(
+            "{}-{}", year < 57 ? 2000 + year : 1900 + year, designator.substr(2)
+        );
+    }
+
+    // Two-digit years from 57 to 99 correspond to 1957 to 1999 and those from 00 to 56
+    // correspond to 2000 to 2056
+    const int yy = static_cast<int>(parseDouble(line1.substr(18, 2), "epoch year"));
+    const int year = yy < 57 ? 2000 + yy : 1900 + yy;
+    const double days = parseDouble(line1.substr(20, 12), "epoch day");
+    res.julianDate = julianDate(year, 1, 1, 0.0) + days - 1.0;
+    res.epoch = j2000Seconds(res.julianDate);
+    res.bstar = parseExponent(line1.substr(53, 8), "drag term");
+
+    res.inclination = parseDouble(line2.substr(8, 8), "inclination");
+    res.ascendingNode = parseDouble(line2.substr(17, 8), "ascending node");
+    res.eccentricity =
+        parseDouble(fmt::format("0.{}", trim(line2.substr(26, 7))), "eccentricity");
+    res.argumentOfPerigee = parseDouble(line2.substr(34, 8), "argument of perigee");
+    res.meanAnomaly = parseDouble(line2.substr(43, 8), "mean anomaly");
+    res.meanMotion = parseDouble(line2.substr(52, 11), "mean motion");
+    return res;
+}
+
+std::vector<Elements> readFile(const std::filesystem::path& file, kepler::Format format)
+{
+    ghoul_assert(std::filesystem::is_regular_file(file), "File must exist");
+
+    switch (format) {
+        case kepler::Format::TLE:
+            return readTleFile(file);
+        case kepler::Format::OMM:
+            return readOmmFile(file);
+        case kepler::Format::SBDB:
+            throw ghoul::RuntimeError(fmt::format(
+                "Cannot use SBDB file '{}' with SGP4, which requires TLE or OMM files",
+                file
+            ));
+        default:
+            throw ghoul::MissingCaseException();
+    }
+}
+
+Propagator::Propagator(std::vector<Elements> elements)
+    : _elements(std::move(elements))
+{
+    _records.reserve(_elements.size());
+    _nameIndex.reserve(_elements.size());
+    _noradIdIndex.reserve(_elements.size());
+    for (size_t i = 0; i < _elements.size(); i++) {
+        const Elements& e = _elements[i];
+        _records.push_back(initialize(e));
+        // emplace does not overwrite existing entries, so the first object wins
+        _nameIndex.emplace(e.name, static_cast<int>(i));
+        if (e.noradId != 0) {
+            _noradIdIndex.emplace(e.noradId, static_cast<int>(i));
+        }
+    }
+}
+
+Propagator::~Propagator() = default;
+
+size_t Propagator::size() const {
+    return _elements.size();
+}
+
+const Elements& Propagator::elements(size_t index) const {
+    ghoul_precondition(index < _elements.size(), "Index out of range");
+    return _elements[index];
+}
+
+int Propagator::findByName(std::string_view name) const {
+    auto it = _nameIndex.find(name);
+    return it != _nameIndex.end() ? it->second : -1;
+}
+
+int Propagator::findByNoradId(int noradId) const {
+    auto it = _noradIdIndex.find(noradId);
+    return it != _noradIdIndex.end() ? it->second : -1;
+}
+
+Propagator::State Propagator::propagate(size_t index, double minutes) {
+    ghoul_precondition(index < _records.size(), "Index out of range");
+    return sgp4::propagate(_records[index], minutes);
+}
+
+void Propagator::propagate(std::span<const double> times, std::span<State> states,
+                           unsigned int nThreads)
+{
+    ghoul_precondition(states.size() == times.size() * size(), "Wrong number of states");
+    ghoul_precondition(nThreads > 0, "At least one thread is required");
+
+    // All times of an object are handled by the same thread, as the integrator state of
+    // each object must only be used by one thread
+    auto propagateObjects = [&](size_t begin, size_t end) {
+        for (size_t i = begin; i < end; i++) {
+            const double epoch = _elements[i].epoch;
+            for (size_t t = 0; t < times.size(); t++) {
+                const double minutes = (times[t] - epoch) / 60.0;
+                states[t * size() + i] = sgp4::propagate(_records[i], minutes);
+            }
+        }
+    };
+
+    const size_t nChunks = (size() + ChunkSize - 1) / ChunkSize;
+    nThreads = static_cast<unsigned int>(
+        std::min<size_t>(nThreads, std::max<size_t>(nChunks, 1))
+    );
+    if (nThreads == 1) {
+        propagateObjects(0, size());
+        return;
+    }
+
+    std::atomic<size_t> nextChunk = 0;
+    auto propagateChunks = [&]() {
+        for (size_t c = nextChunk++; c < nChunks; c = nextChunk++) {
+            propagateObjects(c * ChunkSize, std::min((c + 1) * ChunkSize, size()));
+        }
+    };
+    std::vector<std::thread> threads;
+    threads.reserve(nThreads - 1);
+    for (unsigned int i = 1; i < nThreads; i++) {
+        threads.emplace_back(propagateChunks);
+    }
+    propagateChunks();
+    for (std::thread& thread : threads) {
+        thread.join();
+    }
+}
+
+std::shared_ptr<Propagator> loadPropagator(const std::filesystem::path& file,
+                                           kepler::Format format)
+{
+    ghoul_assert(std::filesystem::is_regular_file(file), "File must exist");
+
+    struct Entry {
+        std::filesystem::file_time_type lastModified;
+        std::shared_future<std::shared_ptr<Propagator>> propagator;
+    };
+    static std::mutex Mutex;
+    static std::map<std::pair<std::string, kepler::Format>, Entry> Propagators;
+
+    const std::pair<std::string, kepler::Format> key = {
+        std::filesystem::weakly_canonical(file).string(),
+        format
+    };
+    const std::filesystem::file_time_type lastModified =
+        std::filesystem::last_write_time(file);
+
+    // Only the first caller reads the file, everyone else waits for its result
+    std::promise<std::shared_ptr<Propagator>> promise;
+    std::shared_future<std::shared_ptr<Propagator>> propagator;
+    bool isLoading = false;
+    {
+        std::lock_guard lock(Mutex);
+        auto it = Propagators.find(key);
+        if (it != Propagators.end() && it->second.lastModified == lastModified) {
+            propagator = it->second.propagator;
+        }
+        else {
+            propagator = promise.get_future().share();
+            Propagators[key] = { lastModified, propagator };
+            isLoading = true;
+        }
+    }
+
+    if (isLoading) {
+        try {
+            LINFO(fmt::format("Loading SGP4 elements from '{}'", file));
+            promise.set_value(std::make_shared<Propagator>(sgp4::readFile(file, format)));
+        }
+        catch (...) {
+            // Remove the entry so that the next request tries to load the file again
+            {
+                std::lock_guard lock(Mutex);
+                auto it = Propagators.find(key);
+                if (it != Propagators.end() && it->second.lastModified == lastModified) {
+                    Propagators.erase(it);
+                }
+            }
+            promise.set_exception(std::current_exception());
+        }
+    }
+
+    return propagator.get();
+}
+
+kepler::Parameters osculatingElements(const glm::dvec3& position,
+                                      const glm::dvec3& velocity, double epoch)
+{
+    constexpr double Epsilon = 1e-10;
+
+    const double r = glm::length(position);
+    const double vsq = glm::dot(velocity, velocity);
+    const glm::dvec3 h = glm::cross(position, velocity);
+    const glm::dvec3 hHat = glm::normalize(h);
+    const glm::dvec3 eVec =
+        ((vsq - Mu / r) * position - glm::dot(position, velocity) * velocity) / Mu;
+    const double e = glm::length(eVec);
+    ghoul_precondition(e < 1.0, "Orbit must be elliptical");
+    const double a = 1.0 / (2.0 / r - vsq / Mu);
+
+    // The ascending node is undefined for equatorial orbits, in which case the x axis is
+    // used as the reference direction
+    const glm::dvec3 node = glm::dvec3(-h.y, h.x, 0.0);
+    const double nodeLength = glm::length(node);
+    const glm::dvec3 nodeHat =
+        nodeLength > Epsilon * glm::length(h) ? node / nodeLength : glm::dvec3(1, 0, 0);
+    const glm::dvec3 q = glm::cross(hHat, nodeHat);
+
+    // Likewise, the periapsis is undefined for circular orbits
+    const double argumentOfPeriapsis =
+        e > Epsilon ? std::atan2(glm::dot(eVec, q), glm::dot(eVec, nodeHat)) : 0.0;
+    const double argumentOfLatitude =
+        std::atan2(glm::dot(position, q), glm::dot(position, nodeHat));
+    const double trueAnomaly = argumentOfLatitude - argumentOfPeriapsis;
+    const double eccentricAnomaly = 2.0 * std::atan2(
+        std::sqrt(1.0 - e) * std::sin(trueAnomaly / 2.0),
+        std::sqrt(1.0 + e) * std::cos(trueAnomaly / 2.0)
+    );
+
+    auto degrees = [](double radians) {
+        const double d = std::fmod(radians / Deg2Rad, 360.0);
+        return d < 0.0 ? d + 360.0 : d;
+    };
+
+    kepler::Parameters res;
+    res.semiMajorAxis = a;
+    res.eccentricity = e;
+    res.inclination = degrees(std::acos(std::clamp(hHat.z, -1.0, 1.0)));
+    res.ascendingNode = degrees(std::atan2(nodeHat.y, nodeHat.x));
+    res.argumentOfPeriapsis = degrees(argumentOfPeriapsis);
+    res.meanAnomaly = degrees(eccentricAnomaly - e * std::sin(eccentricAnomaly));
+    res.epoch = epoch;
+    res.period = TwoPi * std::sqrt(a * a * a / Mu);
+    return res;
+}
+
+glm::dmat3 temeToJ2000(double time) {
+    // Julian centuries of terrestrial time past the J2000 epoch
+    const double t = time / (86400.0 * 36525.0);
+    const double t2 = t * t;
+    const double t3 = t2 * t;
+
+    // IAU-1976 precession from the J2000 equator and equinox to the mean ones of date
+    const double zeta = (2306.2181 * t + 0.30188 * t2 + 0.017998 * t3) * ArcSec2Rad;
+    const double theta = (2004.3109 * t - 0.42665 * t2 - 0.041833 * t3) * ArcSec2Rad;
+    const double z = (2306.2181 * t + 1.09468 * t2 + 0.018203 * t3) * ArcSec2Rad;
+    const glm::dmat3 precession = rotationZ(-z) * rotationY(theta) * rotationZ(-zeta);
+
+    // IAU-1980 nutation from the mean equator and equinox of date to the true ones
+    constexpr double Revolution = 1296000.0; // arcseconds
+    const double l = (485866.733 + (1325.0 * Revolution + 715922.633) * t +
+        31.31 * t2 + 0.064 * t3) * ArcSec2Rad;
+    const double lPrime = (1287099.804 + (99.0 * Revolution + 1292581.224) * t -
+        0.577 * t2 - 0.012 * t3) * ArcSec2Rad;
+    const double f = (335778.877 + (1342.0 * Revolution + 295263.137) * t -
+        13.257 * t2 + 0.011 * t3) * ArcSec2Rad;
+    const double d = (1072261.307 + (1236.0 * Revolution + 1105601.328) * t -
+        6.891 * t2 + 0.019 * t3) * ArcSec2Rad;
+    const double omega = (450160.28 - (5.0 * Revolution + 482890.539) * t +
+        7.455 * t2 + 0.008 * t3) * ArcSec2Rad;
+
+    double deltaPsi = 0.0;
+    double deltaEpsilon = 0.0;
+    for (const NutationTerm& term : NutationTerms) {
+        const double argument = term.l * l + term.lPrime * lPrime + term.f * f +
+            term.d * d + term.omega * omega;
+        deltaPsi += (term.longitude + term.longitudeRate * t) * std::sin(argument);
+        deltaEpsilon += (term.obliquity + term.obliquityRate * t) * std::cos(argument);
+    }
+    deltaPsi *= 0.0001 * ArcSec2Rad;
+    deltaEpsilon *= 0.0001 * ArcSec2Rad;
+
+    const double meanObliquity =
+        (84381.448 - 46.815 * t - 0.00059 * t2 + 0.001813 * t3) * ArcSec2Rad;
+    const double trueObliquity = meanObliquity + deltaEpsilon;
+    const glm::dmat3 nutation = rotationX(-trueObliquity) * rotationZ(-deltaPsi) *
+        rotationX(meanObliquity);
+
+    // TEME shares the true equator of date but measures from the mean equinox, which
+    // lies on the true equator at the equation of the equinoxes from the true equinox
+    const double equationOfEquinoxes = deltaPsi * std::cos(meanObliquity);
+    const glm::dmat3 temeToTrueOfDate = rotationZ(-equationOfEquinoxes);
+
+    return glm::transpose(precession) * glm::transpose(nutation) * temeToTrueOfDate;
+}
+
+} // namespace openspace::sgp4
@@ -0,0 +1,219 @@
+/*****************************************************************************************
+ *                                                                                       *
+ * OpenSpace                                                                             *
+ *                                                                                       *
+ * Copyright (c) 2014-2023                                                               *
+ *                                                                                       *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this  *
+ * software and associated documentation files (the "Software"), to deal in the Software *
+ * without restriction, including without limitation the rights to use, copy, modify,    *
+ * merge, publish, distribute, sublicense, and/or sell copies of the Software, and to    *
+ * permit persons to whom the Software is furnished to do so, subject to the following   *
+ * conditions:                                                                           *
+ *                                                                                       *
+ * The above copyright notice and this permission notice shall be included in all copies *
+ * or substantial portions of the Software.                                              *
+ *                                                                                       *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,   *
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A         *
+ * PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT    *
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF  *
+ * CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE  *
+ * OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                                         *
+ ****************************************************************************************/
+
+
+#ifndef __OPENSPACE_MODULE_SPACE___SGP4___H__
+#define __OPENSPACE_MODULE_SPACE___SGP4___H__
+
+#include <modules/space/kepler.h>
+#include <ghoul/glm.h>
+#include <filesystem>
+#include <memory>
+#include <span>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+namespace openspace::sgp4 {
+
+/**
+ * The mean orbital elements of a single object as they are provided by two-line element
+ * sets or Orbit Mean-Elements Messages. Contrary to the kepler::Parameters, these are not
+ * classical Keplerian elements but the mean elements that the SGP4 model expects.
+ */
+struct Elements {
+    // Some human-readable name for the object
+    std::string name;
+
+    // The international designator of the object
+    std::string id;
+
+    // The NORAD catalog number of the object or 0 if the file does not provide it
+    int noradId = 0;
+
+    // The epoch of the elements as a Julian date in UTC
+    double julianDate = 0.0;
+
+    // The epoch of the elements in seconds past the J2000 epoch
+    double epoch = 0.0;
+
+    // The drag term in inverse earth radii
+    double bstar = 0.0;
+
+    double inclination = 0.0; // in degrees
+    double ascendingNode = 0.0; // in degrees
+    double eccentricity = 0.0;
+    double argumentOfPerigee = 0.0; // in degrees
+    double meanAnomaly = 0.0; // in degrees
+    double meanMotion = 0.0; // in revolutions per day
+};
+
+/**
+ * Parses a single two-line element set.
+ *
+ * \param name The name of the object, which is usually provided in the line preceding
+ *        the two lines of the element set
+ * \param line1 The first line of the element set
+ * \param line2 The second line of the element set
+ * \return The elements of the object
+ *
+ * \throw ghoul::RuntimeError If the lines are not a valid two-line element set
+ */
+Elements parseTle(std::string_view name, std::string_view line1, std::string_view line2);
+
+/**
+ * Reads the elements of all objects in the provided \p file.
+ *
+ * \param file The file containing the information about the objects
+ * \param format The format of the provided \p file, which must be either TLE or OMM
+ * \return The elements of all objects in the order in which they appear in the \p file
+ *
+ * \pre \p file must be a file and must exist
+ * \throw ghoul::RuntimeError If the \p file is not in the provided \p format or if the
+ *        \p format is not supported
+ */
+std::vector<Elements> readFile(const std::filesystem::path& file, kepler::Format format);
+
+/// The constants of a single object that only depend on its elements
+struct Record;
+
+/**
+ * Propagates the position and velocity of a catalog of objects using the SGP4 model for
+ * objects with orbital periods of less than 225 minutes and the SDP4 model, which adds
+ * the lunar and solar perturbations and the resonance effects of the Earth's gravity
+ * field, for all other objects. The implementation follows the revised version of
+ * Spacetrack Report #3 by Vallado et al. (2006) using the WGS-72 constants. All
+ * positions and velocities are provided in the True Equator Mean Equinox (TEME) frame
+ * that the elements refer to and have to be rotated with #temeToJ2000 before they are
+ * used in the J2000 frame of the rest of the application.
+ *
+ * The constants that only depend on the elements are computed once, so that propagating
+ * an object only requires evaluating the time-dependent terms. The objects are
+ * propagated independently, which makes it possible to distribute them over multiple
+ * threads. However, each object keeps the state of the numerical integrator for the
+ * resonance effects between calls, so the same Propagator must not be used by multiple
+ * threads at the same time.
+ */
+class Propagator {
+public:
+    enum class Status {
+        Success = 0,
+        /// The mean eccentricity left the range of valid values
+        InvalidEccentricity,
+        /// The mean motion became negative
+        InvalidMeanMotion,
+        /// The eccentricity including the periodic terms left the range of valid values
+        InvalidPerturbedEccentricity,
+        /// The semi-latus rectum became negative
+        InvalidSemiLatusRectum,
+        /// The object is below the surface of the Earth
+        Decayed
+    };
+
+    struct State {
+        /// The position in kilometers
+        glm::dvec3 position = glm::dvec3(0.0);
+        /// The velocity in kilometers per second
+        glm::dvec3 velocity = glm::dvec3(0.0);
+        Status status = Status::Success;
+    };
+
+    explicit Propagator(std::vector<Elements> elements);
+    ~Propagator();
+
+    /// Returns the number of objects
+    size_t size() const;
+
+    /// Returns the elements of the object with the provided \p index
+    const Elements& elements(size_t index) const;
+
+    /// Returns the index of the object with the provided \p name or -1 if there is none
+    int findByName(std::string_view name) const;
+
+    /// Returns the index of the object with the \p noradId or -1 if there is none
+    int findByNoradId(int noradId) const;
+
+    /**
+     * Propagates the object with the provided \p index to the time that lies the
+     * provided number of \p minutes after the epoch of its elements.
+     */
+    State propagate(size_t index, double minutes);
+
+    /**
+     * Propagates all objects to all of the provided \p times, which are given in seconds
+     * past the J2000 epoch. The states are stored grouped by time, so the state of the
+     * object `i` at time `t` is stored in `states[t * size() + i]`. The objects are
+     * distributed over \p nThreads threads.
+     *
+     * \pre \p states must contain `times.size() * size()` elements
+     * \pre \p nThreads must be positive
+     */
+    void propagate(std::span<const double> times, std::span<State> states,
+        unsigned int nThreads = 1);
+
+private:
+    std::vector<Elements> _elements;
+    std::vector<Record> _records;
+    std::unordered_map<std::string_view, int> _nameIndex;
+    std::unordered_map<int, int> _noradIdIndex;
+};
+
+/**
+ * Returns the propagator for all objects in the provided \p file. Just as the catalogs
+ * returned by kepler::loadCatalog, the propagators are shared throughout the application
+ * and are reloaded if the file has been modified since it was read.
+ *
+ * \pre \p file must be a file and must exist
+ * \throw ghoul::RuntimeError If the \p file is not in the provided \p format or if the
+ *        \p format is not supported
+ */
+std::shared_ptr<Propagator> loadPropagator(const std::filesystem::path& file,
+    kepler::Format format);
+
+/**
+ * Computes the osculating Keplerian elements of the orbit that passes through the
+ * provided \p position with the provided \p velocity, both given in kilometers and
+ * kilometers per second respectively. The returned elements use the same units as the
+ * kepler::Parameters read from files and their epoch is set to \p epoch.
+ *
+ * \pre The orbit described by the \p position and \p velocity must be elliptical
+ */
+kepler::Parameters osculatingElements(const glm::dvec3& position,
+    const glm::dvec3& velocity, double epoch);
+
+/**
+ * Returns the rotation from the True Equator Mean Equinox (TEME) frame of the provided
+ * \p time, which is the frame of the states computed by the Propagator, into the J2000
+ * frame. The rotation uses the IAU-1976 precession and the largest terms of the IAU-1980
+ * nutation models, which is the same reduction that was used to define the TEME frame.
+ *
+ * \param time The time in seconds past the J2000 epoch
+ * \return The matrix that rotates a vector from the TEME frame into the J2000 frame
+ */
+glm::dmat3 temeToJ2000(double time);
+
+} // namespace openspace::sgp4
+
+#endif // __OPENSPACE_MODULE_SPACE___SGP4___H__
@@ -34,10 +34,12 @@
 #include <modules/space/rendering/renderablerings.h>
 #include <modules/space/rendering/renderablestars.h>
 #include <modules/space/rendering/renderabletravelspeed.h>
+#include <modules/space/tasks/generatedebrisvolumetask.h>
 #include <modules/space/translation/keplertranslation.h>
 #include <modules/space/translation/spicetranslation.h>
 #include <modules/space/translation/gptranslation.h>
 #include <modules/space/translation/horizonstranslation.h>
+#include <modules/space/translation/sgp4translation.h>
 #include <modules/space/rotation/spicerotation.h>
 #include <openspace/documentation/documentation.h>
 #include <openspace/rendering/renderable.h>
@@ -46,6 +48,7 @@
 #include <openspace/util/coordinateconversion.h>
 #include <openspace/util/factorymanager.h>
 #include <openspace/util/spicemanager.h>
+#include <openspace/util/task.h>
 #include <ghoul/misc/assert.h>
 #include <ghoul/misc/templatefactory.h>
 
@@ -102,6 +105,7 @@ void SpaceModule::internalInitialize(const ghoul::Dictionary& dictionary) {
     fTranslation->registerClass<SpiceTranslation>("SpiceTranslation");
     fTranslation->registerClass<GPTranslation>("GPTranslation");
     fTranslation->registerClass<HorizonsTranslation>("HorizonsTranslation");
+    fTranslation->registerClass<SGP4Translation>("SGP4Translation");
 
     ghoul::TemplateFactory<Rotation>* fRotation =
         FactoryManager::ref().factory<Rotation>();
@@ -109,6 +113,11 @@ void SpaceModule::internalInitialize(const ghoul::Dictionary& dictionary) {
 
     fRotation->registerClass<SpiceRotation>("SpiceRotation");
 
+    ghoul::TemplateFactory<Task>* fTask = FactoryManager::ref().factory<Task>();
+    ghoul_assert(fTask, "Task factory was not created");
+
+    fTask->registerClass<volume::GenerateDebrisVolumeTask>("GenerateDebrisVolumeTask");
+
     if (dictionary.hasValue<bool>(SpiceExceptionInfo.identifier)) {
         _showSpiceExceptions = dictionary.value<bool>(SpiceExceptionInfo.identifier);
     }
@@ -134,7 +143,9 @@ std::vector<documentation::Documentation> SpaceModule::documentations() const {
         SpiceRotation::Documentation(),
         SpiceTranslation::Documentation(),
         LabelsComponent::Documentation(),
-        GPTranslation::Documentation()
+        GPTranslation::Documentation(),
+        SGP4Translation::Documentation(),
+        volume::GenerateDebrisVolumeTask::Documentation()
     };
 }
 
@@ -96,13 +96,16 @@ std::vector<ghoul::Dictionary> readKeplerFile(std::filesystem::path p, std::stri
         throw ghoul::lua::LuaError(fmt::format("Unsupported format '{}'", type));
     }
 
-    std::vector<openspace::kepler::Parameters> params = openspace::kepler::readFile(p, f);
+    std::shared_ptr<const openspace::kepler::Catalog> catalog =
+        openspace::kepler::loadCatalog(p, f);
+    const std::vector<openspace::kepler::Parameters>& params = catalog->parameters();
     std::vector<ghoul::Dictionary> res;
     res.reserve(params.size());
     for (const openspace::kepler::Parameters& param : params) {
         ghoul::Dictionary d;
         d.setValue("Name", param.name);
         d.setValue("ID", param.id);
+        d.setValue("NoradID", param.noradId);
         d.setValue("inclination", param.inclination);
         d.setValue("SemiMajorAxis", param.semiMajorAxis);
         d.setValue("AscendingNode", param.ascendingNode);
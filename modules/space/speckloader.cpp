@@ -24,8 +24,8 @@
 
 #include <modules/space/speckloader.h>
 
+#include <openspace/util/cachefiles.h>
 #include <ghoul/fmt.h>
-#include <ghoul/filesystem/cachemanager.h>
 #include <ghoul/filesystem/file.h>
 #include <ghoul/filesystem/filesystem.h>
 #include <ghoul/logging/logmanager.h>
@@ -102,7 +102,7 @@ namespace {
             std::is_same_v<T, openspace::speck::ColorMap>
         );
 
-        std::filesystem::path cached = FileSys.cacheManager()->cachedFilename(speckPath);
+        std::filesystem::path cached = openspace::cachedFilename(speckPath);
 
         if (std::filesystem::exists(cached)) {
             LINFOC(
@@ -116,7 +116,7 @@ namespace {
                 return *dataset;
             }
             else {
-                FileSys.cacheManager()->removeCacheFile(cached);
+                openspace::removeCacheFile(cached);
             }
         }
         LINFOC("SpeckLoader", fmt::format("Loading file {}", speckPath));
@@ -24,444 +24,164 @@
 
 #include <modules/space/tasks/generatedebrisvolumetask.h>
 
-#include <modules/volume/rawvolume.h>
+#include <modules/space/translation/keplertranslation.h>
 #include <modules/volume/rawvolumemetadata.h>
 #include <modules/volume/rawvolumewriter.h>
-#include <openspace/util/spicemanager.h>
+#include <openspace/documentation/documentation.h>
 #include <openspace/documentation/verifier.h>
+#include <openspace/util/spicemanager.h>
+#include <openspace/util/time.h>
+#include <openspace/util/updatestructures.h>
+#include <ghoul/fmt.h>
 #include <ghoul/filesystem/filesystem.h>
-#include <ghoul/filesystem/file.h>
 #include <ghoul/logging/logmanager.h>
 #include <ghoul/misc/defer.h>
 #include <ghoul/misc/dictionaryluaformatter.h>
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <exception>
 #include <fstream>
-#include <queue>
+#include <functional>
+#include <mutex>
+#include <thread>
 
 namespace {
-    constexpr std::string_view ProgramName = "RenderableSatellites";
     constexpr std::string_view _loggerCat = "SpaceDebris";
 
-    constexpr std::string_view KeyRawVolumeOutput = "RawVolumeOutput";
-    constexpr std::string_view KeyDictionaryOutput = "DictionaryOutput";
-    constexpr std::string_view KeyDimensions = "Dimensions";
-    constexpr std::string_view KeyStartTime = "StartTime";
-    constexpr std::string_view KeyTimeStep = "TimeStep";
-    constexpr std::string_view KeyEndTime = "EndTime";
-    constexpr std::string_view KeyInputPath = "InputPath";
-    constexpr std::string_view KeyGridType = "GridType";
-
-     constexpr std::string_view KeyLowerDomainBound = "LowerDomainBound";
-     constexpr std::string_view KeyUpperDomainBound = "UpperDomainBound";
-} // namespace
-
-namespace openspace {
-namespace volume {
-// The list of leap years only goes until 2056 as we need to touch this file then
-// again anyway ;)
-const std::vector<int> LeapYears = {
-    1956, 1960, 1964, 1968, 1972, 1976, 1980, 1984, 1988, 1992, 1996,
-    2000, 2004, 2008, 2012, 2016, 2020, 2024, 2028, 2032, 2036, 2040,
-    2044, 2048, 2052, 2056
-};
-// Count the number of full days since the beginning of 2000 to the beginning of
-// the parameter 'year'
-int countDays(int year) {
-    // Find the position of the current year in the vector, the difference
-    // between its position and the position of 2000 (for J2000) gives the
-    // number of leap years
-    constexpr int Epoch = 2000;
-    constexpr int DaysRegularYear = 365;
-    constexpr int DaysLeapYear = 366;
-
-    if (year == Epoch) {
-        return 0;
-    }
-
-    // Get the position of the most recent leap year
-    const auto lb = std::lower_bound(LeapYears.begin(), LeapYears.end(), year);
-
-    // Get the position of the epoch
-    const auto y2000 = std::find(LeapYears.begin(), LeapYears.end(), Epoch);
-
-    // The distance between the two iterators gives us the number of leap years
-    const int nLeapYears = static_cast<int>(std::abs(std::distance(y2000, lb)));
+    // The number of objects that are propagated or binned by a thread at a time
+    constexpr size_t ObjectChunkSize = 256;
+    // The number of voxels that are combined from the per-thread histograms at a time
+    constexpr size_t VoxelChunkSize = 16384;
 
-    const int nYears = std::abs(year - Epoch);
-    const int nRegularYears = nYears - nLeapYears;
+    struct [[codegen::Dictionary(GenerateDebrisVolumeTask)]] Parameters {
+        // Input path to the TLE-data
+        std::filesystem::path inputPath;
 
-    // Get the total number of days as the sum of leap years + non leap years
-    const int result = nRegularYears * DaysRegularYear + nLeapYears * DaysLeapYear;
-    return result;
-}
-
-// Returns the number of leap seconds that lie between the {year, dayOfYear}
-// time point and { 2000, 1 }
-int countLeapSeconds(int year, int dayOfYear) {
-    // Find the position of the current year in the vector; its position in
-    // the vector gives the number of leap seconds
-    struct LeapSecond {
-        int year;
-        int dayOfYear;
-        bool operator<(const LeapSecond& rhs) const {
-            return std::tie(year, dayOfYear) < std::tie(rhs.year, rhs.dayOfYear);
-        }
-    };
+        // The raw volume file to export data to. The index of each time step is appended
+        // to the name of the file
+        std::string rawVolumeOutput [[codegen::annotation("A valid filepath")]];
 
-    const LeapSecond Epoch = { 2000, 1 };
-
-    // List taken from: https://www.ietf.org/timezones/data/leap-seconds.list
-    static const std::vector<LeapSecond> LeapSeconds = {
-        { 1972,   1 },
-        { 1972, 183 },
-        { 1973,   1 },
-        { 1974,   1 },
-        { 1975,   1 },
-        { 1976,   1 },
-        { 1977,   1 },
-        { 1978,   1 },
-        { 1979,   1 },
-        { 1980,   1 },
-        { 1981, 182 },
-        { 1982, 182 },
-        { 1983, 182 },
-        { 1985, 182 },
-        { 1988,   1 },
-        { 1990,   1 },
-        { 1991,   1 },
-        { 1992, 183 },
-        { 1993, 182 },
-        { 1994, 182 },
-        { 1996,   1 },
-        { 1997, 182 },
-        { 1999,   1 },
-        { 2006,   1 },
-        { 2009,   1 },
-        { 2012, 183 },
-        { 2015, 182 },
-        { 2017,   1 }
-    };
+        // The lua dictionary file to export metadata to. The index of each time step is
+        // appended to the name of the file
+        std::string dictionaryOutput [[codegen::annotation("A valid filepath")]];
 
-    // Get the position of the last leap second before the desired date
-    LeapSecond date { year, dayOfYear };
-    const auto it = std::lower_bound(LeapSeconds.begin(), LeapSeconds.end(), date);
+        // A vector representing the number of cells in each dimension
+        glm::ivec3 dimensions;
 
-    // Get the position of the Epoch
-    const auto y2000 = std::lower_bound(
-        LeapSeconds.begin(),
-        LeapSeconds.end(),
-        Epoch
-    );
+        // The time of the first volume
+        std::string startTime [[codegen::annotation("A valid date in ISO 8601 format")]];
 
-    // The distance between the two iterators gives us the number of leap years
-    const int nLeapSeconds = static_cast<int>(std::abs(std::distance(y2000, it)));
-    return nLeapSeconds;
-}
+        // The time of the last volume
+        std::string endTime [[codegen::annotation("A valid date in ISO 8601 format")]];
 
-double calculateSemiMajorAxis(double meanMotion) {
-    constexpr double GravitationalConstant = 6.6740831e-11;
-    constexpr double MassEarth = 5.9721986e24;
-    constexpr double muEarth = GravitationalConstant * MassEarth;
+        // The number of seconds between two volumes
+        std::string timeStep;
 
-    // Use Kepler's 3rd law to calculate semimajor axis
-    // a^3 / P^2 = mu / (2pi)^2
-    // <=> a = ((mu * P^2) / (2pi^2))^(1/3)
-    // with a = semimajor axis
-    // P = period in seconds
-    // mu = G*M_earth
-    double period = std::chrono::seconds(std::chrono::hours(24)).count() / meanMotion;
+        // The type of grid into which the densities are binned
+        std::string gridType [[codegen::inlist("Cartesian", "Spherical")]];
 
-    const double pisq = glm::pi<double>() * glm::pi<double>();
-    double semiMajorAxis = pow((muEarth * period*period) / (4 * pisq), 1.0 / 3.0);
+        // A vector representing the lower bound of the domain
+        glm::dvec3 lowerDomainBound;
 
-    // We need the semi major axis in km instead of m
-    return semiMajorAxis / 1000.0;
-}
+        // A vector representing the upper bound of the domain
+        glm::dvec3 upperDomainBound;
 
-double epochFromSubstring(const std::string& epochString) {
-    // The epochString is in the form:
-    // YYDDD.DDDDDDDD
-    // With YY being the last two years of the launch epoch, the first DDD the day
-    // of the year and the remaning a fractional part of the day
-
-    // The main overview of this function:
-    // 1. Reconstruct the full year from the YY part
-    // 2. Calculate the number of seconds since the beginning of the year
-    // 2.a Get the number of full days since the beginning of the year
-    // 2.b If the year is a leap year, modify the number of days
-    // 3. Convert the number of days to a number of seconds
-    // 4. Get the number of leap seconds since January 1st, 2000 and remove them
-    // 5. Adjust for the fact the epoch starts on 1st Januaray at 12:00:00, not
-    // midnight
-
-    // According to https://celestrak.com/columns/v04n03/
-    // Apparently, US Space Command sees no need to change the two-line element
-    // set format yet since no artificial earth satellites existed prior to 1957.
-    // By their reasoning, two-digit years from 57-99 correspond to 1957-1999 and
-    // those from 00-56 correspond to 2000-2056. We'll see each other again in 2057!
-
-    // 1. Get the full year
-    std::string yearPrefix = [y = epochString.substr(0, 2)](){
-        int year = std::atoi(y.c_str());
-        return year >= 57 ? "19" : "20";
-    }();
-    const int year = std::atoi((yearPrefix + epochString.substr(0, 2)).c_str());
-    const int daysSince2000 = countDays(year);
-
-    // 2.
-    // 2.a
-    double daysInYear = std::atof(epochString.substr(2).c_str());
-
-    // 2.b
-    const bool isInLeapYear = std::find(
-        LeapYears.begin(),
-        LeapYears.end(),
-        year
-    ) != LeapYears.end();
-    if (isInLeapYear && daysInYear >= 60) {
-        // We are in a leap year, so we have an effective day more if we are
-        // beyond the end of february (= 31+29 days)
-        --daysInYear;
-    }
-
-    // 3
-    using namespace std::chrono;
-    const int SecondsPerDay = static_cast<int>(seconds(hours(24)).count());
-    //Need to subtract 1 from daysInYear since it is not a zero-based count
-    const double nSecondsSince2000 = (daysSince2000 + daysInYear - 1) * SecondsPerDay;
-
-    // 4
-    // We need to remove additionbal leap seconds past 2000 and add them prior to
-    // 2000 to sync up the time zones
-    const double nLeapSecondsOffset = -countLeapSeconds(
-        year,
-        static_cast<int>(std::floor(daysInYear))
-    );
-
-    // 5
-    const double nSecondsEpochOffset = static_cast<double>(
-        seconds(hours(12)).count()
-    );
-
-    // Combine all of the values
-    const double epoch = nSecondsSince2000 + nLeapSecondsOffset - nSecondsEpochOffset;
-    return epoch;
-}
-
-std::vector<KeplerParameters> readTLEFile(const std::string& filename){
-    ghoul_assert(FileSys.fileExists(filename), "The filename must exist");
-
-    std::vector<KeplerParameters> data;
-
-    std::ifstream file;
-    file.exceptions(std::ifstream::failbit | std::ifstream::badbit);
-    file.open(filename);
-
-    int numberOfLines = std::count(std::istreambuf_iterator<char>(file),
-                                   std::istreambuf_iterator<char>(), '\n');
-    file.seekg(std::ios_base::beg); // reset iterator to beginning of file
-
-    // 3 because a TLE has 3 lines per element/ object.
-    int numberOfObjects = numberOfLines/3;
-
-    std::string line = "-";
-    for (int i = 0; i < numberOfObjects; i++) {
-
-        std::getline(file, line); // get rid of title
-
-        KeplerParameters keplerElements;
-
-        std::getline(file, line);
-        if (line[0] == '1') {
-            // First line
-            // Field Columns   Content
-            //     1   01-01   Line number
-            //     2   03-07   Satellite number
-            //     3   08-08   Classification (U = Unclassified)
-            //     4   10-11   International Designator (Last two digits of launch year)
-            //     5   12-14   International Designator (Launch number of the year)
-            //     6   15-17   International Designator(piece of the launch)    A
-            //     7   19-20   Epoch Year(last two digits of year)
-            //     8   21-32   Epoch(day of the year and fractional portion of the day)
-            //     9   34-43   First Time Derivative of the Mean Motion divided by two
-            //    10   45-52   Second Time Derivative of Mean Motion divided by six
-            //    11   54-61   BSTAR drag term(decimal point assumed)[10] - 11606 - 4
-            //    12   63-63   The "Ephemeris type"
-            //    13   65-68   Element set  number.Incremented when a new TLE is generated
-            //    14   69-69   Checksum (modulo 10)
-            keplerElements.epoch = epochFromSubstring(line.substr(18, 14));
-        }
-        else {
-            throw ghoul::RuntimeError(fmt::format(
-                "File {} @ line {} does not have '1' header", filename // linNum + 1
-            ));
-        }
-
-        std::getline(file, line);
-        if (line[0] == '2') {
-            // Second line
-            // Field    Columns   Content
-            //     1      01-01   Line number
-            //     2      03-07   Satellite number
-            //     3      09-16   Inclination (degrees)
-            //     4      18-25   Right ascension of the ascending node (degrees)
-            //     5      27-33   Eccentricity (decimal point assumed)
-            //     6      35-42   Argument of perigee (degrees)
-            //     7      44-51   Mean Anomaly (degrees)
-            //     8      53-63   Mean Motion (revolutions per day)
-            //     9      64-68   Revolution number at epoch (revolutions)
-            //    10      69-69   Checksum (modulo 10)
-
-            std::stringstream stream;
-            stream.exceptions(std::ios::failbit);
-
-            // Get inclination
-            stream.str(line.substr(8, 8));
-            stream >> keplerElements.inclination;
-            stream.clear();
-
-            // Get Right ascension of the ascending node
-            stream.str(line.substr(17, 8));
-            stream >> keplerElements.ascendingNode;
-            stream.clear();
-
-            // Get Eccentricity
-            stream.str("0." + line.substr(26, 7));
-            stream >> keplerElements.eccentricity;
-            stream.clear();
-
-            // Get argument of periapsis
-            stream.str(line.substr(34, 8));
-            stream >> keplerElements.argumentOfPeriapsis;
-            stream.clear();
-
-            // Get mean anomaly
-            stream.str(line.substr(43, 8));
-            stream >> keplerElements.meanAnomaly;
-            stream.clear();
-
-            // Get mean motion
-            stream.str(line.substr(52, 11));
-            stream >> keplerElements.meanMotion;
-        }
-        else {
-            throw ghoul::RuntimeError(fmt::format(
-                "File {} @ line {} does not have '2' header", filename  // , lineNum + 2
-            ));
-        }
-
-        // Calculate the semi major axis based on the mean motion using kepler's laws
-        keplerElements.semiMajorAxis = calculateSemiMajorAxis(keplerElements.meanMotion);
-
-        using namespace std::chrono;
-        double period = seconds(hours(24)).count() / keplerElements.meanMotion;
-        keplerElements.period = period;
-
-        data.push_back(keplerElements);
+        // The number of threads that are used to propagate the objects and to accumulate
+        // their densities. If this value is not specified, all available cores are used
+        std::optional<int> threads [[codegen::greater(0)]];
+    };
+#include "generatedebrisvolumetask_codegen.cpp"
+} // namespace
 
-    } // !for loop
-    file.close();
-    return data;
-}
+namespace openspace::volume {
 
-glm::dvec3 cartesianToSphericalCoord(glm::dvec3 position){
-    glm::dvec3 sphericalPosition;
-    // r [0, MaxApogee]
-    sphericalPosition.x = sqrt(pow(position.x,2)+pow(position.y,2)+pow(position.z,2));
-    // theta [0, pi]
-    sphericalPosition.y = acos(position.z/sphericalPosition.x);
-    // phi [-pi, pi] -> [0, 2*pi]
-    sphericalPosition.z = atan2(position.y,position.x);
-    sphericalPosition.z += glm::pi<double>();
-    return sphericalPosition;
-}
+namespace {
 
-std::vector<glm::dvec3> getPositionBuffer(std::vector<KeplerParameters> tleData,
-                                          double timeInSeconds, std::string gridType)
+// Calls fn(worker, begin, end) for consecutive chunks of the range [0, n) on nThreads
+// threads, including the calling thread. The worker index is in [0, nThreads) and is only
+// used by one thread, so it can be used to access per-thread data. If fn throws an
+// exception, the remaining chunks are skipped and the exception is rethrown
+void forEachChunk(size_t n, size_t chunkSize, unsigned int nThreads,
+                  const std::function<void(unsigned int, size_t, size_t)>& fn)
 {
-    float minTheta = 0.0;
-    float minPhi = 0.0;
-    float maxTheta = 0.0;
-    float maxPhi = 0.0;
-
-    std::vector<glm::dvec3> positionBuffer;
-    for(const auto& orbit : tleData) {
-        KeplerTranslation keplerTranslator;
-        keplerTranslator.setKeplerElements(
-            orbit.eccentricity,
-            orbit.semiMajorAxis,
-            orbit.inclination,
-            orbit.ascendingNode,
-            orbit.argumentOfPeriapsis,
-            orbit.meanAnomaly,
-            orbit.period,
-            orbit.epoch
-        );
-        glm::dvec3 position = keplerTranslator.position({
-            {},
-            Time(timeInSeconds),
-            Time(0.0),
-            false
-        });
-        // LINFO(fmt::format("cart: {} ", position));
-        glm::dvec3 sphPos;
-        if (gridType == "Spherical"){
-            sphPos = cartesianToSphericalCoord(position);
-
-            if (sphPos.y < minTheta){
-                minTheta = sphPos.y;
-            }
-            if (sphPos.z < minPhi){
-                minPhi = sphPos.z;
+    const size_t nChunks = (n + chunkSize - 1) / chunkSize;
+    std::atomic<size_t> nextChunk = 0;
+    std::exception_ptr exception;
+    std::mutex exceptionMutex;
+    auto processChunks = [&](unsigned int worker) {
+        for (size_t c = nextChunk++; c < nChunks; c = nextChunk++) {
+            try {
+                fn(worker, c * chunkSize, std::min((c + 1) * chunkSize, n));
             }
-            if (sphPos.y > maxTheta){
-                maxTheta = sphPos.y;
+            catch (...) {
+                std::lock_guard lock(exceptionMutex);
+                if (!exception) {
+                    exception = std::current_exception();
+                }
+                nextChunk = nChunks;
+                return;
             }
-            if (sphPos.z > maxPhi){
-                maxPhi = sphPos.z;
-            }
-            // LINFO(fmt::format("pos: {} ", sphPos));
-            positionBuffer.push_back(sphPos);
-
         }
-        else
-        {
-            positionBuffer.push_back(position);
-        }
-
+    };
 
+    std::vector<std::thread> threads;
+    for (unsigned int i = 1; i < nThreads; i++) {
+        threads.emplace_back(processChunks, i);
+    }
+    processChunks(0);
+    for (std::thread& thread : threads) {
+        thread.join();
+    }
+    if (exception) {
+        std::rethrow_exception(exception);
     }
-    LINFO(fmt::format("max theta: {} ", maxTheta));
-    LINFO(fmt::format("max phi: {} ", maxPhi));
-    LINFO(fmt::format("min theta: {} ", minTheta));
-    LINFO(fmt::format("min phi: {} ", minPhi));
-
-    return positionBuffer;
 }
 
-// std::vector<glm::dvec3> generatePositions(int numberOfPositions) {
-//     std::vector<glm::dvec3> positions;
-
-//     float radius = 700000;   // meter
-//     float degreeStep = 360 / numberOfPositions;
-
-//     for(int i=0 ; i<= 360 ; i += degreeStep){
-//         glm::dvec3 singlePosition = glm::dvec3(radius* sin(i), radius*cos(i), 0.0);
-//         positions.push_back(singlePosition);
-//     }
-//     return positions;
-// }
-
-float getDensityAt(glm::uvec3 cell,  double* densityArray, RawVolume<float>& raw) {
-    float value;
-    // return value at position cell from _densityPerVoxel
-    size_t index = raw.coordsToIndex(cell);
-    value = static_cast<float>(densityArray[index]);
-    //LINFO(fmt::format("indensity: {} ", index));
-
-    return value;
+// Propagates all objects to all of the provided times in one pass. The orbital elements
+// of each object are only set up once and reused for all time steps. The positions are
+// stored time step by time step, so the position of object i at time step t is located
+// at index t * tleData.size() + i
+std::vector<glm::dvec3> propagatePositions(const std::vector<kepler::Parameters>& tleData,
+                                           std::span<const double> times,
+                                           unsigned int nThreads)
+{
+    const size_t nObjects = tleData.size();
+    std::vector<glm::dvec3> positions(times.size() * nObjects);
+
+    forEachChunk(
+        nObjects,
+        ObjectChunkSize,
+        nThreads,
+        [&](unsigned int, size_t begin, size_t end) {
+            KeplerTranslation keplerTranslator;
+            for (size_t i = begin; i < end; ++i) {
+                const kepler::Parameters& orbit = tleData[i];
+                keplerTranslator.setKeplerElements(
+                    orbit.eccentricity,
+                    orbit.semiMajorAxis,
+                    orbit.inclination,
+                    orbit.ascendingNode,
+                    orbit.argumentOfPeriapsis,
+                    orbit.meanAnomaly,
+                    orbit.period,
+                    orbit.epoch
+                );
+
+                for (size_t t = 0; t < times.size(); ++t) {
+                    positions[t * nObjects + i] = keplerTranslator.position({
+                        {},
+                        Time(times[t]),
+                        Time(0.0)
+                    });
+                }
+            }
+        }
+    );
+    return positions;
 }
 
-float getMaxApogee(std::vector<KeplerParameters> inData){
+float getMaxApogee(const std::vector<kepler::Parameters>& inData) {
     double maxApogee = 0.0;
     for (const auto& dataElement : inData){
         double ah = dataElement.semiMajorAxis * (1 + dataElement.eccentricity);
@@ -472,54 +192,10 @@ float getMaxApogee(std::vector<KeplerParameters> inData){
     return static_cast<float>(maxApogee*1000);  // * 1000 for meters
 }
 
-int getIndexFromPosition(glm::dvec3 position, glm::uvec3 dim, float maxApogee,
-                         std::string gridType)
-{
-    // epsilon is to make sure that for example if newPosition.x/maxApogee = 1,
-    // then the index for that dimension will not exceed the range of the grid.
-    float epsilon = static_cast<float>(0.000000001);
-    if (gridType == "Cartesian"){ //|| gridType == "Spherical"){
-        glm::dvec3 newPosition = glm::dvec3(position.x + maxApogee
-                                        ,position.y + maxApogee
-                                        ,position.z + maxApogee);
-
-        glm::uvec3 coordinateIndex = glm::uvec3(
-            static_cast<int>(newPosition.x * dim.x / (2 * (maxApogee + epsilon))),
-            static_cast<int>(newPosition.y * dim.y / (2 * (maxApogee + epsilon))),
-            static_cast<int>(newPosition.z * dim.z / (2 * (maxApogee + epsilon)))
-        );
-
-
-        return coordinateIndex.z * (dim.x * dim.y) +
-            coordinateIndex.y * dim.x + coordinateIndex.x;
-    }
-    else if (gridType == "Spherical"){
-        if (position.y >= 3.1415926535897932384626433832795028){
-            position.y = 0;
-        }
-        if (position.z >= (2 * 3.1415926535897932384626433832795028)){
-            position.z = 0;
-        }
-
-        glm::uvec3 coordinateIndex = glm::uvec3(
-            static_cast<int>(position.x * dim.x / (maxApogee)),
-            static_cast<int>(position.y * dim.y / glm::pi<double>()),
-            static_cast<int>(position.z * dim.z / glm::two_pi<double>()));
-
-        return coordinateIndex.z * (dim.x * dim.y) +
-            coordinateIndex.y * dim.x + coordinateIndex.x;
-    }
-
-    return -1;
-}
-
-double getVoxelVolume(int index, RawVolume<float>& raw, glm::uvec3 dim, float maxApogee){
-    // get coords from index
-    glm::uvec3 coords = raw.indexToCoords(index);
-
+double getVoxelVolume(glm::uvec3 coords, glm::uvec3 dim, float maxApogee) {
     double rMax = maxApogee / dim.x;
-    double thetaMax = 3.141592 / dim.y;
-    double phiMax = (2 * 3.141592) / dim.z;
+    double thetaMax = glm::pi<double>() / dim.y;
+    double phiMax = glm::two_pi<double>() / dim.z;
     //use coords to calc volume
     //integral(dTheta) * integral(r^2 dr) * integral(sin(phi) dPhi)
     double rIntegral = (pow(((coords.x + 1) * rMax),3) - pow(((coords.x) * rMax),3)) / 3;
@@ -527,57 +203,151 @@ double getVoxelVolume(int index, RawVolume<float>& raw, glm::uvec3 dim, float ma
     double phiIntegral = ((coords.z + 1) - coords.z) * phiMax;
 
     return rIntegral * thetaIntegral * phiIntegral;
-    //return volume
-
 }
 
-double* mapDensityToVoxels(double* densityArray, std::vector<glm::dvec3> positions,
-                           glm::uvec3 dim, float maxApogee, std::string gridType,
-                           RawVolume<float>& raw)
-{
+} // namespace
 
-    for (const glm::dvec3& position : positions) {
-        //LINFO(fmt::format("pos: {} ", position));
-        int index = getIndexFromPosition(position, dim, maxApogee, gridType);
-        //LINFO(fmt::format("index: {} ", index));
-        if (gridType == "Cartesian"){
-            ++densityArray[index];
+void computeVoxelIndices(std::span<const glm::dvec3> positions, glm::uvec3 dim,
+                         float maxApogee, bool isSpherical, uint32_t* indices)
+{
+    const double maxX = static_cast<double>(dim.x - 1);
+    const double maxY = static_cast<double>(dim.y - 1);
+    const double maxZ = static_cast<double>(dim.z - 1);
+    const uint32_t strideZ = dim.x * dim.y;
+
+    if (isSpherical) {
+        // r [0, maxApogee], theta [0, pi], phi [-pi, pi] -> [0, 2pi]
+        const double scaleR = dim.x / static_cast<double>(maxApogee);
+        const double scaleTheta = dim.y / glm::pi<double>();
+        const double scalePhi = dim.z / glm::two_pi<double>();
+        for (size_t i = 0; i < positions.size(); ++i) {
+            const glm::dvec3 p = positions[i];
+            const double r = std::sqrt(p.x * p.x + p.y * p.y + p.z * p.z);
+            const double cosTheta = r > 0.0 ? p.z / r : 1.0;
+            const double theta = std::acos(std::clamp(cosTheta, -1.0, 1.0));
+            const double phi = std::atan2(p.y, p.x) + glm::pi<double>();
+
+            const uint32_t x = static_cast<uint32_t>(std::min(r * scaleR, maxX));
+            const uint32_t y = static_cast<uint32_t>(std::min(theta * scaleTheta, maxY));
+            // phi is periodic, so an angle of 2pi wraps around to the first voxel
+            const uint32_t z = static_cast<uint32_t>(phi * scalePhi);
+            const uint32_t zWrapped = z >= dim.z ? 0 : z;
+            indices[i] = zWrapped * strideZ + y * dim.x + x;
         }
-        else if (gridType == "Spherical"){
-            // something like this
-            double voxelVolume = getVoxelVolume(index, raw, dim, maxApogee);
-            densityArray[index] += 1/voxelVolume;
+    }
+    else {
+        const glm::dvec3 scale = glm::dvec3(dim) / (2.0 * static_cast<double>(maxApogee));
+        for (size_t i = 0; i < positions.size(); ++i) {
+            const glm::dvec3 p = (positions[i] + static_cast<double>(maxApogee)) * scale;
+            const uint32_t x = static_cast<uint32_t>(std::clamp(p.x, 0.0, maxX));
+            const uint32_t y = static_cast<uint32_t>(std::clamp(p.y, 0.0, maxY));
+            const uint32_t z = static_cast<uint32_t>(std::clamp(p.z, 0.0, maxZ));
+            indices[i] = z * strideZ + y * dim.x + x;
         }
     }
+}
 
-    return densityArray;
+std::vector<double> computeInverseVoxelVolumes(glm::uvec3 dim, float maxApogee) {
+    std::vector<double> inverseVolumes(static_cast<size_t>(dim.x) * dim.y);
+    for (unsigned int y = 0; y < dim.y; ++y) {
+        for (unsigned int x = 0; x < dim.x; ++x) {
+            const double volume = getVoxelVolume(glm::uvec3(x, y, 0), dim, maxApogee);
+            inverseVolumes[y * dim.x + x] = 1.0 / volume;
+        }
+    }
+    return inverseVolumes;
 }
 
-GenerateDebrisVolumeTask::GenerateDebrisVolumeTask(const ghoul::Dictionary& dictionary)
+void mapDensityToVoxels(std::span<const glm::dvec3> positions, glm::uvec3 dim,
+                        float maxApogee, bool isSpherical,
+                        const std::vector<double>& inverseVolumes,
+                        std::vector<std::vector<uint32_t>>& histograms,
+                        RawVolume<float>& raw)
 {
-    openspace::documentation::testSpecificationAndThrow(
-        documentation(),
-        dictionary,
-        "GenerateDebrisVolumeTask"
+    for (std::vector<uint32_t>& histogram : histograms) {
+        std::fill(histogram.begin(), histogram.end(), 0);
+    }
+    const unsigned int nThreads = static_cast<unsigned int>(histograms.size());
+
+    forEachChunk(
+        positions.size(),
+        ObjectChunkSize,
+        nThreads,
+        [&](unsigned int worker, size_t begin, size_t end) {
+            std::array<uint32_t, ObjectChunkSize> indices;
+            computeVoxelIndices(
+                positions.subspan(begin, end - begin),
+                dim,
+                maxApogee,
+                isSpherical,
+                indices.data()
+            );
+
+            uint32_t* histogram = histograms[worker].data();
+            for (size_t i = 0; i < end - begin; ++i) {
+                ++histogram[indices[i]];
+            }
+        }
     );
 
-    _rawVolumeOutputPath = absPath(dictionary.value<std::string>(KeyRawVolumeOutput));
-    _dictionaryOutputPath = absPath(dictionary.value<std::string>(KeyDictionaryOutput));
-    // must not be <glm::uvec3> for some reason.
-    _dimensions = dictionary.value<glm::vec3>(KeyDimensions);
-    _startTime = dictionary.value<std::string>(KeyStartTime);
-    // Todo: send KeyTimeStep in as a int or float correctly.
-    _timeStep = dictionary.value<std::string>(KeyTimeStep);
-    _endTime = dictionary.value<std::string>(KeyEndTime);
+    const size_t sliceSize = static_cast<size_t>(dim.x) * dim.y;
+    float* values = raw.data();
+    forEachChunk(
+        raw.nCells(),
+        VoxelChunkSize,
+        nThreads,
+        [&](unsigned int, size_t begin, size_t end) {
+            // The counts of all threads are summed up in the first histogram
+            uint32_t* counts = histograms[0].data();
+            for (size_t h = 1; h < histograms.size(); ++h) {
+                const uint32_t* histogram = histograms[h].data();
+                for (size_t i = begin; i < end; ++i) {
+                    counts[i] += histogram[i];
+                }
+            }
+
+            if (isSpherical) {
+                for (size_t i = begin; i < end; ++i) {
+                    const double inverseVolume = inverseVolumes[i % sliceSize];
+                    values[i] = static_cast<float>(counts[i] * inverseVolume);
+                }
+            }
+            else {
+                for (size_t i = begin; i < end; ++i) {
+                    values[i] = static_cast<float>(counts[i]);
+                }
+            }
+        }
+    );
+}
+
+documentation::Documentation GenerateDebrisVolumeTask::Documentation() {
+    return codegen::doc<Parameters>("generate_debris_volume_task");
+}
+
+GenerateDebrisVolumeTask::GenerateDebrisVolumeTask(const ghoul::Dictionary& dictionary)
+{
+    const Parameters p = codegen::bake<Parameters>(dictionary);
+
+    _rawVolumeOutputPath = absPath(p.rawVolumeOutput);
+    _dictionaryOutputPath = absPath(p.dictionaryOutput);
+    _dimensions = p.dimensions;
+    _startTime = p.startTime;
+    // Todo: send TimeStep in as a int or float correctly.
+    _timeStep = p.timeStep;
+    _endTime = p.endTime;
     // since _inputPath is past from task,
     // there will have to be either one task per dataset,
     // or you need to combine the datasets into one file.
-    _inputPath = absPath(dictionary.value<std::string>(KeyInputPath));
-    _gridType = dictionary.value<std::string>(KeyGridType);
-    _lowerDomainBound = dictionary.value<glm::vec3>(KeyLowerDomainBound);
-    _upperDomainBound = dictionary.value<glm::vec3>(KeyUpperDomainBound);
+    _inputPath = absPath(p.inputPath);
+    _gridType = parseGridType(p.gridType);
+    _lowerDomainBound = p.lowerDomainBound;
+    _upperDomainBound = p.upperDomainBound;
+    _nThreads = static_cast<unsigned int>(
+        p.threads.value_or(std::max(std::thread::hardware_concurrency(), 1u))
+    );
 
-    _TLEDataVector = readTLEFile(_inputPath);
+    _TLEDataVector = kepler::readFile(_inputPath, kepler::Format::TLE);
     _maxApogee = getMaxApogee(_TLEDataVector);
 }
 
@@ -586,63 +356,15 @@ std::string GenerateDebrisVolumeTask::description() {
 }
 
 void GenerateDebrisVolumeTask::perform(const Task::ProgressCallback& progressCallback) {
-    SpiceManager::KernelHandle kernel =
-    SpiceManager::ref().loadKernel(absPath("${DATA}/assets/spice/naif0012.tls"));
+    SpiceManager::KernelHandle kernel = SpiceManager::ref().loadKernel(
+        absPath("${DATA}/assets/spice/naif0012.tls").string()
+    );
 
     defer {
         SpiceManager::ref().unloadKernel(kernel);
     };
 
-    //////////
-    //1. read TLE-data and position of debris elements.
-    // std::vector<KeplerParameters>TLEDataVector = readTLEFile(_inputPath);
-    // std::vector<KeplerParameters>TLEDataVector1 = readTLEFile(_inputPath1);
-    // std::vector<KeplerParameters>TLEDataVector2 = readTLEFile(_inputPath2);
-    // std::vector<KeplerParameters>TLEDataVector3 = readTLEFile(_inputPath3);
-    // std::vector<KeplerParameters>TLEDataVector4 = readTLEFile(_inputPath4);
-
-    // _TLEDataVector.reserve(
-    //     TLEDataVector.size() + TLEDataVector1.size() + TLEDataVector2.size() +
-    //     TLEDataVector3.size() + TLEDataVector4.size()
-    // );
-    // _TLEDataVector.insert(
-    //     _TLEDataVector.end(),
-    //     TLEDataVector.begin(),
-    //     TLEDataVector.end()
-    // );
-    //_TLEDataVector.insert(
-    //    _TLEDataVector.end(),
-    //    TLEDataVector1.begin(),
-    //    TLEDataVector1.end()
-    //);
-    //_TLEDataVector.insert(
-    //    _TLEDataVector.end(),
-    //    TLEDataVector2.begin(),
-    //    TLEDataVector2.end()
-    //);
-    //_TLEDataVector.insert(
-    //    _TLEDataVector.end(),
-    //    TLEDataVector3.begin(),
-    //    TLEDataVector3.end()
-    //);
-    //_TLEDataVector.insert(
-    //    _TLEDataVector.end(),
-    //    TLEDataVector4.begin(),
-    //    TLEDataVector4.end()
-    //);
-    // ----- or ----- if only one
-
-        // _TLEDataVector = readTLEFile(_inputPath);
-
-    //////////
-    VolumeGridType GridType = VolumeGridType::Cartesian;
-    if (_gridType == "Spherical"){
-        GridType = VolumeGridType::Spherical;
-    }
-    else if (_gridType != "Cartesian"){
-        // TODO:: Error message
-        return;
-    }
+    const VolumeGridType GridType = _gridType;
 
     // float maxApogee = getMaxApogee(_TLEDataVector);
     LINFO(fmt::format("Max Apogee: {} ", _maxApogee));
@@ -665,102 +387,89 @@ void GenerateDebrisVolumeTask::perform(const Task::ProgressCallback& progressCal
      int numberOfIterations = static_cast<int>(timeSpan/timeStep);
     LINFO(fmt::format("timestep: {} ", numberOfIterations));
 
-    std::queue<volume::RawVolume<float>> rawVolumeQueue = {};
-    const int size = _dimensions.x *_dimensions.y *_dimensions.z;
-    float minVal = std::numeric_limits<float>::max();
-    float maxVal = std::numeric_limits<float>::min();
+    std::vector<double> times;
+    for (int i = 0; i <= numberOfIterations; ++i) {
+        times.push_back(startTimeInSeconds + (i * timeStep));
+    }
+
+    const size_t nObjects = _TLEDataVector.size();
+    const size_t nChunks = (nObjects + ObjectChunkSize - 1) / ObjectChunkSize;
+    const unsigned int nThreads = static_cast<unsigned int>(
+        std::clamp<size_t>(nChunks, 1, _nThreads)
+    );
+
     // 2.
-    for (int i=0 ; i<=numberOfIterations ; ++i) {
-        std::vector<glm::dvec3> startPositionBuffer = getPositionBuffer(
-            _TLEDataVector,
-            startTimeInSeconds + (i * timeStep),
-            _gridType
-        );   //+(i*timeStep)
-        //LINFO(fmt::format("pos: {} ", startPositionBuffer[4]));
-
-        double *densityArrayp = new double[size]();
-        //densityArrayp = mapDensityToVoxels(
-        //    densityArrayp,
-        //    generatedPositions,
-        //    _dimensions,
-        //    maxApogee
-        //);
-        volume::RawVolume<float> rawVolume(_dimensions);
+    // All time steps are propagated at once, which only sets up each orbit a single time
+    const std::vector<glm::dvec3> positions = propagatePositions(
+        _TLEDataVector,
+        times,
+        nThreads
+    );
+
+    const bool isSpherical = GridType == VolumeGridType::Spherical;
+    const std::vector<double> inverseVolumes =
+        isSpherical ? computeInverseVoxelVolumes(_dimensions, _maxApogee) :
+        std::vector<double>();
+
+    const size_t size = static_cast<size_t>(_dimensions.x) * _dimensions.y *
+        _dimensions.z;
+    std::vector<std::vector<uint32_t>> histograms(
+        nThreads,
+        std::vector<uint32_t>(size)
+    );
 
-        densityArrayp = mapDensityToVoxels(
-            densityArrayp,
-            startPositionBuffer,
+    std::vector<volume::RawVolume<float>> rawVolumes;
+    rawVolumes.reserve(times.size());
+    float minVal = std::numeric_limits<float>::max();
+    float maxVal = std::numeric_limits<float>::lowest();
+    for (size_t i = 0; i < times.size(); ++i) {
+        volume::RawVolume<float> rawVolume(_dimensions);
+        mapDensityToVoxels(
+            std::span<const glm::dvec3>(positions.data() + i * nObjects, nObjects),
             _dimensions,
             _maxApogee,
-            _gridType,
+            isSpherical,
+            inverseVolumes,
+            histograms,
             rawVolume
         );
-        /*std::vector<glm::dvec3> testBuffer;
-        testBuffer.push_back(glm::dvec3(0,0,0));
-        testBuffer.push_back(glm::dvec3(1,1.5,1.5));
-        testBuffer.push_back(glm::dvec3(1,3,3));
-        testBuffer.push_back(glm::dvec3(3,5,3));
-        //testBuffer.push_back(glm::dvec3(10000,1000000000,1000000000));
 
-
-        densityArrayp = mapDensityToVoxels(
-            densityArrayp,
-            testBuffer,
-            _dimensions,
-            _maxApogee,
-            _gridType
+        const auto [min, max] = std::minmax_element(
+            rawVolume.data(),
+            rawVolume.data() + rawVolume.nCells()
         );
-        */
-        // create object rawVolume
-
-        //glm::vec3 domainSize = _upperDomainBound - _lowerDomainBound;
-
-        // TODO: Create a forEachSatallite and set(cell, value) to combine
-        //       mapDensityToVoxel and forEachVoxel for less time complexity.
-        rawVolume.forEachVoxel([&](glm::uvec3 cell, float) {
-        //     glm::vec3 coord = _lowerDomainBound +
-        //        glm::vec3(cell) / glm::vec3(_dimensions) * domainSize;
-            float value = getDensityAt(cell, densityArrayp, rawVolume);   // (coord)
-
-            rawVolume.set(cell, value);
-
-            minVal = std::min(minVal, value);
-            maxVal = std::max(maxVal, value);
-            /*LINFO(fmt::format("min: {} ", minVal));
-            LINFO(fmt::format("max: {} ", maxVal));*/
-        });
-        rawVolumeQueue.push(rawVolume);
-        delete[] densityArrayp;
+        minVal = std::min(minVal, *min);
+        maxVal = std::max(maxVal, *max);
+
+        rawVolumes.push_back(std::move(rawVolume));
+        progressCallback(static_cast<float>(i + 1) / static_cast<float>(times.size()));
     }
 
     // two loops is used to get a global min and max value for voxels.
     for(int i=0 ; i<=numberOfIterations ; ++i){
         // LINFO(fmt::format("raw file output name: {} ", _rawVolumeOutputPath));
 
-        size_t lastIndex = _rawVolumeOutputPath.find_last_of(".");
-        std::string rawOutputName = _rawVolumeOutputPath.substr(0, lastIndex);
-        rawOutputName += std::to_string(i) + ".rawvolume";
+        std::filesystem::path rawOutputName = _rawVolumeOutputPath;
+        rawOutputName.replace_filename(fmt::format(
+            "{}{}.rawvolume", _rawVolumeOutputPath.stem().string(), i
+        ));
 
-        lastIndex = _dictionaryOutputPath.find_last_of(".");
-        std::string dictionaryOutputName = _dictionaryOutputPath.substr(0, lastIndex);
-        dictionaryOutputName += std::to_string(i) + ".dictionary";
+        std::filesystem::path dictionaryOutputName = _dictionaryOutputPath;
+        dictionaryOutputName.replace_filename(fmt::format(
+            "{}{}.dictionary", _dictionaryOutputPath.stem().string(), i
+        ));
 
-        ghoul::filesystem::File file(rawOutputName);
-        const std::string directory = file.directoryName();
-        if (!FileSys.directoryExists(directory)) {
-            FileSys.createDirectory(
-                directory,
-                ghoul::filesystem::FileSystem::Recursive::Yes
-            );
+        const std::filesystem::path directory = rawOutputName.parent_path();
+        if (!std::filesystem::is_directory(directory)) {
+            std::filesystem::create_directories(directory);
         }
 
         volume::RawVolumeWriter<float> writer(rawOutputName);
-        writer.write(rawVolumeQueue.front());
-        rawVolumeQueue.pop();
+        writer.write(rawVolumes[i]);
 
         RawVolumeMetadata metadata;
         // alternatively metadata.hasTime = false;
-        metadata.time = Time::convertTime(_startTime)+(i*timeStep);
+        metadata.time = times[i];
         metadata.dimensions = _dimensions;
         metadata.hasDomainUnit = false;
         metadata.hasValueUnit = false;
@@ -776,8 +485,7 @@ void GenerateDebrisVolumeTask::perform(const Task::ProgressCallback& progressCal
         LINFO(fmt::format("max2: {} ", maxVal));*/
 
         ghoul::Dictionary outputDictionary = metadata.dictionary();
-        ghoul::DictionaryLuaFormatter formatter;
-        std::string metadataString = formatter.format(outputDictionary);
+        std::string metadataString = ghoul::formatLua(outputDictionary);
 
         std::fstream f(dictionaryOutputName, std::ios::out);
         f << "return " << metadataString;
@@ -785,63 +493,4 @@ void GenerateDebrisVolumeTask::perform(const Task::ProgressCallback& progressCal
     }
 }
 
-documentation::Documentation GenerateDebrisVolumeTask::documentation() {
-    using namespace documentation;
-    return {
-        "GenerateDebrisVolumeTask",
-        "generate_debris_volume_task",
-        {
-            {
-                "Type",
-                new StringEqualVerifier("GenerateDebrisVolumeTask"),
-                Optional::No,
-                "The type of this task",
-            },
-            {
-                KeyStartTime,
-                new StringAnnotationVerifier("start time"),
-                Optional::No,
-                "start time",
-            },
-            {
-                KeyInputPath,
-                new StringAnnotationVerifier("A valid filepath"),
-                Optional::No,
-                "Input path to the TLE-data",
-            },
-            {
-                KeyRawVolumeOutput,
-                new StringAnnotationVerifier("A valid filepath"),
-                Optional::No,
-                "The raw volume file to export data to",
-            },
-            {
-                KeyDictionaryOutput,
-                new StringAnnotationVerifier("A valid filepath"),
-                Optional::No,
-                "The lua dictionary file to export metadata to",
-            },
-            {
-                KeyDimensions,
-                new DoubleVector3Verifier,
-                Optional::No,
-                "A vector representing the number of cells in each dimension",
-            },
-             {
-                 KeyLowerDomainBound,
-                 new DoubleVector3Verifier,
-                 Optional::No,
-                 "A vector representing the lower bound of the domain"
-             },
-             {
-                 KeyUpperDomainBound,
-                 new DoubleVector3Verifier,
-                 Optional::No,
-                 "A vector representing the upper bound of the domain"
-             }
-        }
-    };
-}
-
-} // namespace volume
-} // namespace openspace
+} // namespace openspace::volume
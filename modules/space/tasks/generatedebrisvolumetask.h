@@ -26,51 +26,81 @@
 #define __OPENSPACE_MODULE_SPACE___GENERATEDEBRISVOLUMETASK___H__
 
 #include <openspace/util/task.h>
-#include <openspace/util/time.h>
-
-#include <modules/space/rendering/renderableorbitalkepler.h>
-#include <modules/space/translation/keplertranslation.h>
-
 
+#include <modules/space/kepler.h>
+#include <modules/volume/rawvolume.h>
+#include <modules/volume/volumegridtype.h>
 #include <ghoul/glm.h>
-
+#include <cstdint>
+#include <filesystem>
+#include <span>
 #include <string>
 #include <vector>
 
-namespace openspace {
-namespace volume {
-
+namespace openspace::volume {
 
 class GenerateDebrisVolumeTask : public Task {
 public:
     GenerateDebrisVolumeTask(const ghoul::Dictionary& dictionary);
     std::string description() override;
     void perform(const Task::ProgressCallback& progressCallback) override;
-    static documentation::Documentation documentation();
-
-    std::string _gridType;
+    static documentation::Documentation Documentation();
 
 private:
-    std::string _rawVolumeOutputPath;
-    std::string _dictionaryOutputPath;
+    std::filesystem::path _rawVolumeOutputPath;
+    std::filesystem::path _dictionaryOutputPath;
     std::string _startTime;
     std::string _timeStep;
     std::string _endTime;
-    std::string _inputPath;
+    std::filesystem::path _inputPath;
+    VolumeGridType _gridType = VolumeGridType::Cartesian;
 
-    glm::uvec3 _dimensions;
-    glm::vec3 _lowerDomainBound;
-    glm::vec3 _upperDomainBound;
+    glm::uvec3 _dimensions = glm::uvec3(0);
+    glm::vec3 _lowerDomainBound = glm::vec3(0.f);
+    glm::vec3 _upperDomainBound = glm::vec3(0.f);
 
-    std::vector<KeplerParameters> _TLEDataVector;
+    std::vector<kepler::Parameters> _TLEDataVector;
 
-    float _maxApogee;
+    float _maxApogee = 0.f;
 
-    // not sure if it should be local function or hidden function.
-    //std::vector<KeplerParameters> readTLEFile(const std::string& filename);
+    // The number of threads used to propagate the objects and accumulate the densities
+    unsigned int _nThreads = 1;
 };
 
-} // namespace volume
-} // namespace openspace
+/**
+ * Computes the linear index of the voxel that each of the \p positions falls into and
+ * stores it in \p indices. Positions on or outside the boundary of the grid are assigned
+ * to the outermost voxels.
+ *
+ * \param positions The positions of the objects in meters
+ * \param dim The number of voxels in each dimension of the grid
+ * \param maxApogee The largest apogee of all objects in meters, which determines the
+ *        extent of the grid
+ * \param isSpherical Whether the grid is spherical or Cartesian
+ * \param indices The destination that must have space for as many indices as there are
+ *        \p positions
+ */
+void computeVoxelIndices(std::span<const glm::dvec3> positions, glm::uvec3 dim,
+    float maxApogee, bool isSpherical, uint32_t* indices);
+
+/**
+ * Returns the inverse volume of the voxels of one phi slice of a spherical grid with the
+ * dimensions \p dim. As the volume of a voxel does not depend on phi, these are the
+ * inverse volumes of all voxels.
+ */
+std::vector<double> computeInverseVoxelVolumes(glm::uvec3 dim, float maxApogee);
+
+/**
+ * Accumulates the density of the \p positions of a single time step into \p raw. Every
+ * thread counts the objects in its own histogram, so the number of \p histograms
+ * determines the number of threads that are used. Each histogram must have one entry per
+ * voxel. For the spherical grid, each object contributes the inverse volume of its voxel
+ * as provided by \p inverseVolumes.
+ */
+void mapDensityToVoxels(std::span<const glm::dvec3> positions, glm::uvec3 dim,
+    float maxApogee, bool isSpherical, const std::vector<double>& inverseVolumes,
+    std::vector<std::vector<uint32_t>>& histograms, RawVolume<float>& raw);
+
+} // namespace openspace::volume
 
 #endif // __OPENSPACE_MODULE_SPACE___GENERATEDEBRISVOLUMETASK___H__
@@ -28,6 +28,7 @@
 #include <openspace/documentation/verifier.h>
 #include <filesystem>
 #include <optional>
+#include <string>
 
 namespace {
     struct [[codegen::Dictionary(GPTranslation)]] Parameters {
@@ -48,6 +49,15 @@ namespace {
         // Specifies the element within the file that should be used in case the file
         // provides multiple general pertubation elements. Defaults to 1.
         std::optional<int> element [[codegen::greater(0)]];
+
+        // Specifies the name of the object within the file that should be used. If this
+        // value is specified, the 'Element' is ignored
+        std::optional<std::string> objectName;
+
+        // Specifies the NORAD catalog number of the object within the file that should
+        // be used. If this value is specified, the 'Element' and 'ObjectName' are
+        // ignored. This value is only available for TLE and OMM files
+        std::optional<int> noradId [[codegen::greater(0)]];
     };
 #include "gptranslation_codegen.cpp"
 } // namespace
@@ -64,29 +74,52 @@ GPTranslation::GPTranslation(const ghoul::Dictionary& dictionary) {
         throw ghoul::RuntimeError("The provided TLE file must exist");
     }
 
-    int element = p.element.value_or(1);
-
-    std::vector<kepler::Parameters> parameters = kepler::readFile(
+    // The catalog is shared between all nodes that use the same file, so that a file
+    // with thousands of objects is not parsed again for every single one of them
+    std::shared_ptr<const kepler::Catalog> catalog = kepler::loadCatalog(
         p.file,
         codegen::map<kepler::Format>(p.format)
     );
 
-    if (element > static_cast<int>(parameters.size())) {
-        throw ghoul::RuntimeError(fmt::format(
-            "Requested element {} but only {} are available", element, parameters.size()
-        ));
+    const kepler::Parameters* param = nullptr;
+    if (p.noradId.has_value()) {
+        param = catalog->findByNoradId(*p.noradId);
+        if (!param) {
+            throw ghoul::RuntimeError(fmt::format(
+                "Could not find object with NORAD catalog number {} in {}",
+                *p.noradId, p.file
+            ));
+        }
+    }
+    else if (p.objectName.has_value()) {
+        param = catalog->findByName(*p.objectName);
+        if (!param) {
+            throw ghoul::RuntimeError(fmt::format(
+                "Could not find object '{}' in {}", *p.objectName, p.file
+            ));
+        }
+    }
+    else {
+        const int element = p.element.value_or(1);
+        const std::vector<kepler::Parameters>& parameters = catalog->parameters();
+        if (element > static_cast<int>(parameters.size())) {
+            throw ghoul::RuntimeError(fmt::format(
+                "Requested element {} but only {} are available",
+                element, parameters.size()
+            ));
+        }
+        param = &parameters[element - 1];
     }
 
-    kepler::Parameters param = parameters[element - 1];
     setKeplerElements(
-        param.eccentricity,
-        param.semiMajorAxis,
-        param.inclination,
-        param.ascendingNode,
-        param.argumentOfPeriapsis,
-        param.meanAnomaly,
-        param.period,
-        param.epoch
+        param->eccentricity,
+        param->semiMajorAxis,
+        param->inclination,
+        param->ascendingNode,
+        param->argumentOfPeriapsis,
+        param->meanAnomaly,
+        param->period,
+        param->epoch
     );
 }
 
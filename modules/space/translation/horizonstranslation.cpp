@@ -26,9 +26,9 @@
 
 #include <openspace/documentation/documentation.h>
 #include <openspace/documentation/verifier.h>
+#include <openspace/util/cachefiles.h>
 #include <openspace/util/updatestructures.h>
 #include <ghoul/fmt.h>
-#include <ghoul/filesystem/cachemanager.h>
 #include <ghoul/filesystem/filesystem.h>
 #include <ghoul/logging/logmanager.h>
 #include <ghoul/lua/ghoul_lua.h>
@@ -71,8 +71,8 @@ HorizonsTranslation::HorizonsTranslation()
     addProperty(_horizonsTextFiles);
 
     _horizonsTextFiles.onChange([this](){
-        requireUpdate();
         notifyObservers();
+        requireUpdate();
         loadData();
     });
 }
@@ -141,6 +141,12 @@ glm::dvec3 HorizonsTranslation::position(const UpdateData& data) const {
     return interpolatedPos;
 }
 
+bool HorizonsTranslation::isThreadSafe() const {
+    // The timeline is only changed when the files are reloaded, which happens after the
+    // observers have been notified
+    return true;
+}
+
 void HorizonsTranslation::loadData() {
     for (const std::string& filePath : _horizonsTextFiles.value()) {
         std::filesystem::path file = absPath(filePath);
@@ -149,7 +155,7 @@ void HorizonsTranslation::loadData() {
             return;
         }
 
-        std::filesystem::path cachedFile = FileSys.cacheManager()->cachedFilename(file);
+        std::filesystem::path cachedFile = cachedFilename(file);
         bool hasCachedFile = std::filesystem::is_regular_file(cachedFile);
         if (hasCachedFile) {
             LINFO(fmt::format(
@@ -160,7 +166,7 @@ void HorizonsTranslation::loadData() {
                 continue;
             }
             else {
-                FileSys.cacheManager()->removeCacheFile(file);
+                removeCacheFile(file);
                 // Intentional fall-through to the 'else' computation to generate the
                 // cache file for the next run
             }
@@ -220,7 +226,7 @@ bool HorizonsTranslation::loadCachedFile(const std::filesystem::path& file) {
     if (version != CurrentCacheVersion) {
         LINFO("The format of the cached file has changed: deleting old cache");
         fileStream.close();
-        FileSys.cacheManager()->removeCacheFile(file);
+        removeCacheFile(file);
         return false;
     }
 
@@ -0,0 +1,131 @@
+/*****************************************************************************************
+ *                                                                                       *
+ * OpenSpace                                                                             *
+ *                                                                                       *
+ * Copyright (c) 2014-2023                                                               *
+ *                                                                                       *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this  *
+ * software and associated documentation files (the "Software"), to deal in the Software *
+ * without restriction, including without limitation the rights to use, copy, modify,    *
+ * merge, publish, distribute, sublicense, and/or sell copies of the Software, and to    *
+ * permit persons to whom the Software is furnished to do so, subject to the following   *
+ * conditions:                                                                           *
+ *                                                                                       *
+ * The above copyright notice and this permission notice shall be included in all copies *
+ * or substantial portions of the Software.                                              *
+ *                                                                                       *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,   *
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A         *
+ * PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT    *
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF  *
+ * CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE  *
+ * OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                                         *
+ ****************************************************************************************/
+
+
+#include <modules/space/translation/sgp4translation.h>
+
+#include <modules/space/sgp4.h>
+#include <openspace/documentation/documentation.h>
+#include <openspace/documentation/verifier.h>
+#include <openspace/util/updatestructures.h>
+#include <ghoul/fmt.h>
+#include <ghoul/misc/exception.h>
+#include <filesystem>
+#include <optional>
+#include <string>
+
+namespace {
+    struct [[codegen::Dictionary(SGP4Translation)]] Parameters {
+        // Specifies the filename of the general pertubation file
+        std::filesystem::path file;
+
+        enum class [[codegen::map(openspace::kepler::Format)]] Format {
+            // A NORAD-style Two-Line element
+            TLE,
+            // Orbit Mean-Elements Message in the KVN notation
+            OMM
+        };
+        // The file format that is contained in the file
+        Format format;
+
+        // Specifies the element within the file that should be used in case the file
+        // provides multiple general pertubation elements. Defaults to 1.
+        std::optional<int> element [[codegen::greater(0)]];
+
+        // Specifies the name of the object within the file that should be used. If this
+        // value is specified, the 'Element' is ignored
+        std::optional<std::string> objectName;
+
+        // Specifies the NORAD catalog number of the object within the file that should
+        // be used. If this value is specified, the 'Element' and 'ObjectName' are
+        // ignored
+        std::optional<int> noradId [[codegen::greater(0)]];
+    };
+#include "sgp4translation_codegen.cpp"
+} // namespace
+
+namespace openspace {
+
+documentation::Documentation SGP4Translation::Documentation() {
+    return codegen::doc<Parameters>("space_transform_sgp4");
+}
+
+SGP4Translation::SGP4Translation(const ghoul::Dictionary& dictionary) {
+    const Parameters p = codegen::bake<Parameters>(dictionary);
+    if (!std::filesystem::is_regular_file(p.file)) {
+        throw ghoul::RuntimeError("The provided general pertubation file must exist");
+    }
+
+    _propagator = sgp4::loadPropagator(p.file, codegen::map<kepler::Format>(p.format));
+
+    if (p.noradId.has_value()) {
+        const int index = _propagator->findByNoradId(*p.noradId);
+        if (index == -1) {
+            throw ghoul::RuntimeError(fmt::format(
+                "Could not find object with NORAD catalog number {} in {}",
+                *p.noradId, p.file
+            ));
+        }
+        _index = static_cast<size_t>(index);
+    }
+    else if (p.objectName.has_value()) {
+        const int index = _propagator->findByName(*p.objectName);
+        if (index == -1) {
+            throw ghoul::RuntimeError(fmt::format(
+                "Could not find object '{}' in {}", *p.objectName, p.file
+            ));
+        }
+        _index = static_cast<size_t>(index);
+    }
+    else {
+        const int element = p.element.value_or(1);
+        if (element > static_cast<int>(_propagator->size())) {
+            throw ghoul::RuntimeError(fmt::format(
+                "Requested element {} but only {} are available",
+                element, _propagator->size()
+            ));
+        }
+        _index = static_cast<size_t>(element - 1);
+    }
+}
+
+SGP4Translation::~SGP4Translation() = default;
+
+glm::dvec3 SGP4Translation::position(const UpdateData& data) const {
+    const double epoch = _propagator->elements(_index).epoch;
+    const double minutes = (data.time.j2000Seconds() - epoch) / 60.0;
+    const sgp4::Propagator::State state = _propagator->propagate(_index, minutes);
+    // Decayed objects are still placed at their last computed position, but the other
+    // errors mean that the model has broken down and there is no meaningful position
+    if (state.status != sgp4::Propagator::Status::Success &&
+        state.status != sgp4::Propagator::Status::Decayed)
+    {
+        return glm::dvec3(0.0);
+    }
+    // The propagator works in the TEME frame of the elements
+    const glm::dmat3 rotation = sgp4::temeToJ2000(data.time.j2000Seconds());
+    return rotation * state.position * 1000.0;
+}
+
+} // namespace openspace
@@ -0,0 +1,62 @@
+/*****************************************************************************************
+ *                                                                                       *
+ * OpenSpace                                                                             *
+ *                                                                                       *
+ * Copyright (c) 2014-2023                                                               *
+ *                                                                                       *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this  *
+ * software and associated documentation files (the "Software"), to deal in the Software *
+ * without restriction, including without limitation the rights to use, copy, modify,    *
+ * merge, publish, distribute, sublicense, and/or sell copies of the Software, and to    *
+ * permit persons to whom the Software is furnished to do so, subject to the following   *
+ * conditions:                                                                           *
+ *                                                                                       *
+ * The above copyright notice and this permission notice shall be included in all copies *
+ * or substantial portions of the Software.                                              *
+ *                                                                                       *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,   *
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A         *
+ * PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT    *
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF  *
+ * CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE  *
+ * OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                                         *
+ ****************************************************************************************/
+
+
+#ifndef __OPENSPACE_MODULE_SPACE___SGP4TRANSLATION___H__
+#define __OPENSPACE_MODULE_SPACE___SGP4TRANSLATION___H__
+
+#include <openspace/scene/translation.h>
+
+#include <memory>
+
+namespace openspace {
+
+namespace documentation { struct Documentation; }
+namespace sgp4 { class Propagator; }
+
+/**
+ * A translation that propagates the general perturbation elements of a TLE or OMM file
+ * using the SGP4/SDP4 model instead of treating them as fixed Keplerian elements as the
+ * GPTranslation does. This takes the drag and the perturbations by the Earth's
+ * oblateness, the Moon, and the Sun into account, which the elements were generated
+ * with. The position is provided in the True Equator Mean Equinox frame of the elements.
+ */
+class SGP4Translation : public Translation {
+public:
+    explicit SGP4Translation(const ghoul::Dictionary& dictionary);
+    ~SGP4Translation() override;
+
+    glm::dvec3 position(const UpdateData& data) const override;
+
+    static documentation::Documentation Documentation();
+
+private:
+    /// The propagator is shared between all translations that use the same file
+    std::shared_ptr<sgp4::Propagator> _propagator;
+    size_t _index = 0;
+};
+
+} // namespace openspace
+
+#endif // __OPENSPACE_MODULE_SPACE___SGP4TRANSLATION___H__
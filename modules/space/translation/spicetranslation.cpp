@@ -138,33 +138,35 @@ SpiceTranslation::SpiceTranslation(const ghoul::Dictionary& dictionary)
     }
 
     _target.onChange([this]() {
+        notifyObservers();
         _cachedTarget = _target;
         requireUpdate();
-        notifyObservers();
     });
     addProperty(_target);
 
     _observer.onChange([this]() {
+        notifyObservers();
         _cachedObserver = _observer;
         requireUpdate();
-        notifyObservers();
     });
     addProperty(_observer);
 
     _frame.onChange([this]() {
+        notifyObservers();
         _cachedFrame = _frame;
         requireUpdate();
-        notifyObservers();
     });
     addProperty(_frame);
 
     _fixedDate.onChange([this]() {
+        notifyObservers();
         if (_fixedDate.value().empty()) {
             _fixedEphemerisTime = std::nullopt;
         }
         else {
             _fixedEphemerisTime = SpiceManager::ref().ephemerisTimeFromDate(_fixedDate);
         }
+        requireUpdate();
     });
     _fixedDate = p.fixedDate.value_or(_fixedDate);
     addProperty(_fixedDate);
@@ -203,4 +205,10 @@ glm::dvec3 SpiceTranslation::position(const UpdateData& data) const {
     ) * 1000.0;
 }
 
+bool SpiceTranslation::isThreadSafe() const {
+    // The SpiceManager serializes all calls into CSPICE and the cached values are only
+    // changed after the observers have been notified
+    return true;
+}
+
 } // namespace openspace
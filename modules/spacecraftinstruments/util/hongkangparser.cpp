@@ -38,11 +38,13 @@
 #include <fstream>
 
 namespace {
-    double ephemerisTimeFromMissionElapsedTime(double met, double metReference) {
-        const double referenceET = openspace::SpiceManager::ref().ephemerisTimeFromDate(
-            "2015-07-14T11:50:00.00"
-        );
+    constexpr std::string_view _loggerCat = "HongKangParser";
 
+    // The reference time is passed in as converting it through SPICE for every line of
+    // the playbook is a significant part of the parsing time
+    double ephemerisTimeFromMissionElapsedTime(double met, double metReference,
+                                               double referenceET)
+    {
         const double diff = std::abs(met - metReference);
         if (met > metReference) {
             return referenceET + diff;
@@ -53,8 +55,10 @@ namespace {
         return 0.0;
     }
 
-    double ephemerisTimeFromMissionElapsedTime(const std::string& line, double met) {
-        return ephemerisTimeFromMissionElapsedTime(std::stod(line), met);
+    double ephemerisTimeFromMissionElapsedTime(const std::string& line, double met,
+                                               double referenceET)
+    {
+        return ephemerisTimeFromMissionElapsedTime(std::stod(line), met, referenceET);
     }
 } // namespace
 
@@ -155,9 +159,30 @@ bool HongKangParser::create() {
         return true;
     }
 
+    const std::filesystem::path playbook = absPath(_fileName);
+    std::string fingerprint = fmt::format(
+        "{}|{}|{}|{}\n",
+        std::filesystem::file_size(playbook),
+        std::filesystem::last_write_time(playbook).time_since_epoch().count(),
+        _metRef,
+        _defaultCaptureImage
+    );
+    for (const std::string& target : _potentialTargets) {
+        fingerprint += target + '\n';
+    }
+    const std::filesystem::path cachedFile = cacheFile(playbook, fingerprint);
+    if (loadCache(cachedFile)) {
+        LINFO(fmt::format("Cached file {} used for playbook {}", cachedFile, playbook));
+        return true;
+    }
+
     std::ifstream file;
     file.exceptions(std::ofstream::failbit | std::ofstream::badbit);
-    file.open(absPath(_fileName));
+    file.open(playbook);
+
+    const double referenceET = SpiceManager::ref().ephemerisTimeFromDate(
+        "2015-07-14T11:50:00.00"
+    );
 
     constexpr double Exposure = 0.01;
 
@@ -178,7 +203,11 @@ bool HongKangParser::create() {
         const bool foundEvent = (it != _fileTranslation.end());
 
         std::string met = line.substr(25, 9);
-        const double time = ephemerisTimeFromMissionElapsedTime(met, _metRef);
+        const double time = ephemerisTimeFromMissionElapsedTime(
+            met,
+            _metRef,
+            referenceET
+        );
 
         if (foundEvent) {
             // store the time, this is used for nextCaptureTime()
@@ -235,7 +264,8 @@ bool HongKangParser::create() {
                         met = linePeek.substr(25, 9);
                         double scanStop = ephemerisTimeFromMissionElapsedTime(
                             met,
-                            _metRef
+                            _metRef,
+                            referenceET
                         );
                         std::string scannerTarget = findPlaybookSpecifiedTarget(line);
 
@@ -273,6 +303,8 @@ bool HongKangParser::create() {
         }
     }
 
+    LINFO(fmt::format("Saving cache {} for playbook {}", cachedFile, playbook));
+    saveCache(cachedFile);
     return true;
 }
 
@@ -28,6 +28,8 @@
 #include <openspace/util/timemanager.h>
 #include <ghoul/filesystem/filesystem.h>
 #include <ghoul/logging/logmanager.h>
+#include <algorithm>
+#include <cmath>
 
 namespace {
     constexpr std::string_view _loggerCat = "ImageSequencer";
@@ -131,74 +133,57 @@ const std::vector<double>& ImageSequencer::captureProgression() const {
     return _captureProgression;
 }
 
-std::vector<std::pair<std::string, bool>> ImageSequencer::activeInstruments(double time) {
-    // first set all instruments to off
-    for (std::pair<std::string, bool>& i : _switchingMap) {
-        i.second = false;
-    }
-
-    // go over the filetranslaton map
-    using K = std::string;
-    using V = std::unique_ptr<Decoder>;
-    for (const std::pair<const K, V>& key : _fileTranslation) {
-        // for each spice-instrument
-        for (const std::string& instrumentID : key.second->translations()) {
-            // check if the spice-instrument is active
-            if (isInstrumentActive(time, instrumentID)) {
-                // go over switching map
-                for (std::pair<std::string, bool>& instrument : _switchingMap) {
-                    // if instrument is present in switching map
-                    if (instrumentID == instrument.first) {
-                        // set as active
-                        instrument.second = true;
-                    }
-                }
-            }
+const std::vector<std::pair<std::string, bool>>&
+ImageSequencer::activeInstruments(double time)
+{
+    // Mark every instrument of every interval that contains the time as active
+    std::vector<bool> isActive(_instrumentIds.size(), false);
+    _instrumentTree.query(time, [this, &isActive](const IntervalTree<int>::Interval& i) {
+        for (int id : _translationIds[i.data]) {
+            isActive[id] = true;
         }
+        return false;
+    });
+
+    for (std::pair<std::string, bool>& instrument : _switchingMap) {
+        const auto it = _instrumentIds.find(instrument.first);
+        instrument.second = it != _instrumentIds.end() && isActive[it->second];
     }
     // return entire map, seen in GUI
     return _switchingMap;
 }
 
-bool ImageSequencer::isInstrumentActive(double time, const std::string& instrument) const
+const IntervalTree<int>::Interval*
+ImageSequencer::activeInterval(double time, const std::string& instrument) const
 {
-    for (const std::pair<std::string, TimeRange>& i : _instrumentTimes) {
-        // check if this instrument is in range
-        if (!i.second.includes(time)) {
-            continue;
-        }
-
-        // if so, then get the corresponding spiceID
-        const std::vector<std::string>& is = _fileTranslation.at(i.first)->translations();
-        // check which specific subinstrument is firing
-        const auto it = std::find(is.begin(), is.end(), instrument);
-        if (it != is.end()) {
-            return true;
-        }
+    const auto it = _instrumentIds.find(instrument);
+    if (it == _instrumentIds.end()) {
+        return nullptr;
     }
-    return false;
+
+    // Find the first interval in which this specific subinstrument is firing
+    const int id = it->second;
+    return _instrumentTree.findFirst(time, [this, id](int translation) {
+        const std::vector<int>& ids = _translationIds[translation];
+        return std::find(ids.begin(), ids.end(), id) != ids.end();
+    });
+}
+
+bool ImageSequencer::isInstrumentActive(double time, const std::string& instrument) const
+{
+    return activeInterval(time, instrument) != nullptr;
 }
 
 float ImageSequencer::instrumentActiveTime(double time,
                                            const std::string& instrumentID) const
 {
-    for (const std::pair<std::string, TimeRange>& i : _instrumentTimes) {
-        // check if this instrument is in range
-        if (!i.second.includes(time)) {
-            continue;
-        }
-        // if so, then get the corresponding spiceID
-        const std::vector<std::string>& is = _fileTranslation.at(i.first)->translations();
-
-        // check which specific subinstrument is firing
-        const auto it = std::find(is.begin(), is.end(), instrumentID);
-        if (it != is.end()) {
-            return static_cast<float>(
-                (time - i.second.start) / (i.second.end - i.second.start)
-            );
-        }
+    const IntervalTree<int>::Interval* interval = activeInterval(time, instrumentID);
+    if (!interval) {
+        return -1.f;
     }
-    return -1.f;
+    return static_cast<float>(
+        (time - interval->start) / (interval->end - interval->start)
+    );
 }
 
 std::vector<Image> ImageSequencer::imagePaths(const std::string& projectee,
@@ -209,32 +194,28 @@ std::vector<Image> ImageSequencer::imagePaths(const std::string& projectee,
 
     // check if this instance is either in range or
     // a valid candidate to recieve data
+    const auto subset = _subsetMap.find(projectee);
+    if (subset == _subsetMap.end()) {
+        return std::vector<Image>();
+    }
 
-    const bool instrumentActive = isInstrumentActive(time, instrument);
-    const bool hasCurrentTime = _subsetMap[projectee]._range.includes(time);
-    const bool hasSinceTime = _subsetMap[projectee]._range.includes(sinceTime);
-
-    if (!instrumentActive || (!hasCurrentTime && !hasSinceTime)) {
+    const bool hasCurrentTime = subset->second._range.includes(time);
+    const bool hasSinceTime = subset->second._range.includes(sinceTime);
+    if ((!hasCurrentTime && !hasSinceTime) || !isInstrumentActive(time, instrument)) {
         return std::vector<Image>();
     }
 
     // for readability we store the iterators
-    auto begin = _subsetMap[projectee]._subset.begin();
-    auto end = _subsetMap[projectee]._subset.end();
-
-    // create temporary storage
-    std::vector<Image> captures;
-    // what to look for
-    Image findPrevious, findCurrent;
-    findPrevious.timeRange.start = sinceTime;
-    findCurrent.timeRange.start = time;
+    const std::vector<Image>& images = subset->second._subset;
+    auto begin = images.begin();
+    auto end = images.end();
 
     // find the two iterators that correspond to the latest time jump
-    auto compareTime = [](const Image& a, const Image& b) -> bool {
-        return a.timeRange.start < b.timeRange.start;
+    auto compareTime = [](const Image& image, double t) -> bool {
+        return image.timeRange.start < t;
     };
-    auto curr = std::lower_bound(begin, end, findCurrent , compareTime);
-    auto prev = std::lower_bound(begin, end, findPrevious, compareTime);
+    auto curr = std::lower_bound(begin, end, time, compareTime);
+    auto prev = std::lower_bound(begin, end, sinceTime, compareTime);
 
     if (curr == begin || curr == end || prev == begin || prev == end || prev >= curr ||
         curr->timeRange.start < prev->timeRange.start)
@@ -242,46 +223,38 @@ std::vector<Image> ImageSequencer::imagePaths(const std::string& projectee,
         return std::vector<Image>();
     }
 
-    std::copy_if(
-        prev,
-        curr,
-        back_inserter(captures),
-        [instrument](const Image& i) { return i.activeInstruments[0] == instrument; }
-    );
-
-    if (!captures.empty()) {
-        _latestImages[captures.back().activeInstruments.front()] = captures.back();
-    }
-
-    std::vector<int> toDelete;
-    for (std::vector<Image>::iterator it = captures.begin(); it != captures.end(); ++it) {
-        if (!it->isPlaceholder) {
-            continue;
-        }
-
-        double beforeDist = std::numeric_limits<double>::max();
-        if (it != captures.begin()) {
-            beforeDist = std::abs(std::prev(it)->timeRange.start - it->timeRange.start);
-        }
-
-        double nextDist = std::numeric_limits<double>::max();
-        if (it != captures.end() - 1) {
-            nextDist = std::abs(std::next(it)->timeRange.start - it->timeRange.start);
-        }
-
-        if (beforeDist < 1.0 || nextDist < 1.0) {
-            toDelete.push_back(static_cast<int>(std::distance(captures.begin(), it)));
+    // Only refer to the images of the instrument here, so that only the images that are
+    // returned in the end are copied
+    std::vector<const Image*> captures;
+    for (auto it = prev; it != curr; it++) {
+        if (it->activeInstruments[0] == instrument) {
+            captures.push_back(&*it);
         }
     }
 
-    for (size_t i = 0; i < toDelete.size(); ++i) {
-        // We have to subtract i here as we already have deleted i value before this and
-        // we need to adjust the location
-        int v = toDelete[i] - static_cast<int>(i);
-        captures.erase(captures.begin() + v);
+    if (captures.empty()) {
+        return std::vector<Image>();
     }
-
-    return captures;
+    _latestImages[captures.back()->activeInstruments.front()] = *captures.back();
+
+    std::vector<Image> result;
+    result.reserve(captures.size());
+    for (size_t i = 0; i < captures.size(); i++) {
+        const Image& image = *captures[i];
+        if (image.isPlaceholder) {
+            // Skip placeholders that are less than a second away from another image
+            const double start = image.timeRange.start;
+            const bool isCloseToPrevious =
+                i > 0 && std::abs(captures[i - 1]->timeRange.start - start) < 1.0;
+            const bool isCloseToNext = i + 1 < captures.size() &&
+                std::abs(captures[i + 1]->timeRange.start - start) < 1.0;
+            if (isCloseToPrevious || isCloseToNext) {
+                continue;
+            }
+        }
+        result.push_back(image);
+    }
+    return result;
 }
 
 void ImageSequencer::sortData() {
@@ -317,6 +290,35 @@ void ImageSequencer::sortData() {
     );
 }
 
+void ImageSequencer::buildInstrumentIndex() {
+    _instrumentIds.clear();
+    _translationIds.clear();
+
+    std::map<std::string, int> translationIndices;
+    for (const std::pair<const std::string, std::unique_ptr<Decoder>>& t :
+         _fileTranslation)
+    {
+        std::vector<int> ids;
+        for (const std::string& instrument : t.second->translations()) {
+            const int nextId = static_cast<int>(_instrumentIds.size());
+            ids.push_back(_instrumentIds.emplace(instrument, nextId).first->second);
+        }
+        translationIndices[t.first] = static_cast<int>(_translationIds.size());
+        _translationIds.push_back(std::move(ids));
+    }
+
+    std::vector<IntervalTree<int>::Interval> intervals;
+    intervals.reserve(_instrumentTimes.size());
+    for (const std::pair<std::string, TimeRange>& i : _instrumentTimes) {
+        // Intervals of instruments without a decoder can never match any instrument
+        const auto it = translationIndices.find(i.first);
+        if (it != translationIndices.end()) {
+            intervals.push_back({ i.second.start, i.second.end, it->second });
+        }
+    }
+    _instrumentTree = IntervalTree<int>(std::move(intervals));
+}
+
 void ImageSequencer::runSequenceParser(SequenceParser& parser) {
     std::map<std::string, std::unique_ptr<Decoder>>& translations = parser.translations();
     std::map<std::string, ImageSubset>& imageData = parser.subsetMap();
@@ -411,6 +413,8 @@ void ImageSequencer::runSequenceParser(SequenceParser& parser) {
             }
         }
     }
+
+    buildInstrumentIndex();
     _hasData = true;
 }
 
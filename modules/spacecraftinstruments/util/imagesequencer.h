@@ -27,8 +27,10 @@
 
 #include <modules/spacecraftinstruments/util/sequenceparser.h>
 
+#include <openspace/util/intervaltree.h>
 #include <map>
 #include <string>
+#include <unordered_map>
 #include <utility>
 #include <vector>
 
@@ -110,7 +112,7 @@ public:
      * Returns a vector with key instrument names whose value indicate whether an
      * instrument is active or not.
      */
-    std::vector<std::pair<std::string, bool>> activeInstruments(double time);
+    const std::vector<std::pair<std::string, bool>>& activeInstruments(double time);
 
     /**
      * Retrieves the relevant data from a specific subset based on the what instance makes
@@ -137,6 +139,19 @@ public:
 private:
     void sortData();
 
+    /**
+     * Rebuilds the #_instrumentTree from the #_instrumentTimes and resolves the
+     * instrument names of all decoders into the indices used by the tree.
+     */
+    void buildInstrumentIndex();
+
+    /**
+     * Returns the earliest starting interval that contains \p time and in which the
+     * provided \p instrument is active, or `nullptr` if there is none.
+     */
+    const IntervalTree<int>::Interval* activeInterval(double time,
+        const std::string& instrument) const;
+
     /**
      * This handles any types of ambiguities between the data and SPICE calls. This map is
      * composed of a key that is a string in the data to be translated and a Decoder that
@@ -172,6 +187,24 @@ private:
      */
     std::vector<std::pair<std::string, TimeRange>> _instrumentTimes;
 
+    /**
+     * Maps each SPICE instrument name that is used by any of the decoders in
+     * #_fileTranslation to a dense index.
+     */
+    std::unordered_map<std::string, int> _instrumentIds;
+
+    /**
+     * The translations of each decoder in #_fileTranslation with the instrument names
+     * resolved through #_instrumentIds.
+     */
+    std::vector<std::vector<int>> _translationIds;
+
+    /**
+     * The same intervals as in #_instrumentTimes. The data of each interval is the index
+     * into #_translationIds of the instruments that are active during the interval.
+     */
+    IntervalTree<int> _instrumentTree;
+
     /**
      * Each consecutive images capture time, for easier traversal.
      */
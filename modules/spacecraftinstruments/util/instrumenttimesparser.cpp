@@ -31,6 +31,7 @@
 #include <ghoul/filesystem/file.h>
 #include <ghoul/filesystem/filesystem.h>
 #include <ghoul/misc/dictionary.h>
+#include <algorithm>
 #include <filesystem>
 #include <fstream>
 
@@ -70,30 +71,63 @@ InstrumentTimesParser::InstrumentTimesParser(std::string name, std::string seque
 }
 
 bool InstrumentTimesParser::create() {
-    std::filesystem::path sequenceDir = absPath(_fileName);
-    if (!std::filesystem::is_directory(sequenceDir)) {
+    namespace fs = std::filesystem;
+
+    fs::path sequenceDir = absPath(_fileName);
+    if (!fs::is_directory(sequenceDir)) {
         LERROR(fmt::format("Could not load Label Directory {}", sequenceDir));
         return false;
     }
 
+    struct EventFile {
+        std::string instrumentID;
+        fs::path path;
+
+        std::vector<TimeRange> events;
+        bool successfulRead = true;
+    };
+
+    std::vector<EventFile> files;
+    std::string fingerprint = _target + '\n';
     using K = std::string;
     using V = std::vector<std::string>;
     for (const std::pair<const K, V>& p : _instrumentFiles) {
-        const std::string& instrumentID = p.first;
-        for (std::string filename : p.second) {
-            std::filesystem::path filepath = sequenceDir / filename;
+        for (const std::string& filename : p.second) {
+            fs::path filepath = sequenceDir / filename;
 
-            if (!std::filesystem::is_regular_file(filepath)) {
+            if (!fs::is_regular_file(filepath)) {
                 LERROR(fmt::format("Unable to read file {}. Skipping file", filepath));
                 continue;
             }
 
-            // Read file into string
-            std::ifstream inFile(filepath);
+            fingerprint += fmt::format(
+                "{}|{}|{}|{}\n",
+                p.first,
+                filepath,
+                fs::file_size(filepath),
+                fs::last_write_time(filepath).time_since_epoch().count()
+            );
+            files.push_back({ .instrumentID = p.first, .path = std::move(filepath) });
+        }
+    }
+
+    const fs::path cachedFile = cacheFile(sequenceDir, fingerprint);
+    if (loadCache(cachedFile)) {
+        LINFO(fmt::format(
+            "Cached file {} used for instrument times {}", cachedFile, sequenceDir
+        ));
+        return true;
+    }
+
+    // The files are read in parallel and merged in the order in which they are listed
+    parallelFor(
+        files.size(),
+        [&](size_t i) {
+            EventFile& f = files[i];
+
+            std::ifstream inFile(f.path);
             std::string line;
             std::smatch matches;
-            TimeRange instrumentActiveTimeRange;
-            bool successfulRead = true;
             while (std::getline(inFile, line)) {
                 if (!std::regex_match(line, matches, _pattern)) {
                     continue;
@@ -104,7 +138,7 @@ bool InstrumentTimesParser::create() {
                         "Bad event data formatting. Must have regex 3 matches "
                         "(source string, start time, stop time)"
                     );
-                    successfulRead = false;
+                    f.successfulRead = false;
                     break;
                 }
 
@@ -117,30 +151,38 @@ bool InstrumentTimesParser::create() {
                 }
                 catch (const SpiceManager::SpiceException& e) {
                     LERROR(e.what());
-                    successfulRead = false;
+                    f.successfulRead = false;
                     break;
                 }
 
-                instrumentActiveTimeRange.include(tr);
-
-                _targetTimes.emplace_back(tr.start, _target);
-                _captureProgression.push_back(tr.start);
-
-                Image image = {
-                    .timeRange = tr,
-                    .path = std::string(),
-                    .activeInstruments = { instrumentID },
-                    .target = _target,
-                    .isPlaceholder = true,
-                    .projected = false
-                };
-                _subsetMap[_target]._subset.push_back(std::move(image));
-            }
-            if (successfulRead){
-                _subsetMap[_target]._range.include(instrumentActiveTimeRange);
-                _instrumentTimes.emplace_back(instrumentID, instrumentActiveTimeRange);
+                f.events.push_back(tr);
             }
         }
+    );
+
+    for (const EventFile& f : files) {
+        ImageSubset& subset = _subsetMap[_target];
+        TimeRange instrumentActiveTimeRange;
+        for (const TimeRange& tr : f.events) {
+            instrumentActiveTimeRange.include(tr);
+
+            _targetTimes.emplace_back(tr.start, _target);
+            _captureProgression.push_back(tr.start);
+
+            Image image = {
+                .timeRange = tr,
+                .path = std::string(),
+                .activeInstruments = { f.instrumentID },
+                .target = _target,
+                .isPlaceholder = true,
+                .projected = false
+            };
+            subset._subset.push_back(std::move(image));
+        }
+        if (f.successfulRead) {
+            subset._range.include(instrumentActiveTimeRange);
+            _instrumentTimes.emplace_back(f.instrumentID, instrumentActiveTimeRange);
+        }
     }
 
     std::stable_sort(_captureProgression.begin(), _captureProgression.end());
@@ -154,6 +196,10 @@ bool InstrumentTimesParser::create() {
         }
     );
 
+    LINFO(fmt::format(
+        "Saving cache {} for instrument times {}", cachedFile, sequenceDir
+    ));
+    saveCache(cachedFile);
     return true;
 }
 
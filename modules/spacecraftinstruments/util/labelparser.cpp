@@ -31,6 +31,7 @@
 #include <ghoul/io/texture/texturereader.h>
 #include <ghoul/logging/logmanager.h>
 #include <ghoul/misc/dictionary.h>
+#include <algorithm>
 #include <filesystem>
 #include <fstream>
 
@@ -110,12 +111,17 @@ LabelParser::LabelParser(std::string fileName, const ghoul::Dictionary& dictiona
     }
 }
 
-std::string LabelParser::decode(const std::string& line) {
-    for (std::pair<const std::string, std::unique_ptr<Decoder>>& key : _fileTranslation) {
+std::string LabelParser::decode(const std::string& line) const {
+    using K = std::string;
+    using V = std::unique_ptr<Decoder>;
+    for (const std::pair<const K, V>& key : _fileTranslation) {
         std::size_t value = line.find(key.first);
         if (value != std::string::npos) {
-            std::string toTranslate = line.substr(value);
-            return _fileTranslation[toTranslate]->translations()[0];
+            const auto it = _fileTranslation.find(line.substr(value));
+            if (it == _fileTranslation.end()) {
+                return "";
+            }
+            return it->second->translations()[0];
         }
     }
     return "";
@@ -133,204 +139,244 @@ std::string LabelParser::encode(const std::string& line) const {
     return "";
 }
 
-bool LabelParser::create() {
-    std::filesystem::path sequenceDir = absPath(_fileName);
-    if (!std::filesystem::is_directory(sequenceDir)) {
-        LERROR(fmt::format("Could not load Label Directory {}", sequenceDir));
-        return false;
+std::optional<LabelParser::LabelFile> LabelParser::parseFile(const std::string& path,
+                                                 const std::vector<std::string>& files,
+                                       const std::vector<std::string>& extensions) const
+{
+    std::ifstream file(path);
+    if (!file.good()) {
+        return std::nullopt;
     }
 
-    std::string lblName;
-    namespace fs = std::filesystem;
-    for (const fs::directory_entry& e : fs::recursive_directory_iterator(sequenceDir)) {
-        if (!e.is_regular_file()) {
-            continue;
-        }
+    LabelFile result;
+    std::string target;
+    std::string instrumentID;
 
-        std::string path = e.path().string();
+    int count = 0;
 
-        size_t position = path.find_last_of('.') + 1;
-        if (position == 0 || position == std::string::npos) {
-            continue;
-        }
+    // open up label files
+    double startTime = 0.0;
+    double stopTime = 0.0;
+    std::string line;
+    do {
+        std::getline(file, line);
 
-        std::filesystem::path extension = std::filesystem::path(path).extension();
-        if (extension != ".lbl" && extension != ".LBL") {
-            continue;
-        }
+        line.erase(std::remove(line.begin(), line.end(), '"'), line.end());
+        line.erase(std::remove(line.begin(), line.end(), ' '), line.end());
+        line.erase(std::remove(line.begin(), line.end(), '\r'), line.end());
 
-        std::ifstream file(path);
+        std::string read = line.substr(0, line.find_first_of('='));
 
-        if (!file.good()) {
-            LERROR(fmt::format(
-                "Failed to open label file {}", std::filesystem::path(path)
-            ));
-            return false;
+        constexpr std::string_view ErrorMsg =
+            "Unrecognized '{}' in line {} in file {}. The 'Convert' table must "
+            "contain the identity tranformation for all values encountered in the "
+            "label files, for example: ROSETTA = {{ \"ROSETTA\" }}";
+
+        // Add more
+        if (read == "TARGET_NAME") {
+            target = decode(line);
+            if (target.empty()) {
+                LWARNING(fmt::format(ErrorMsg, "TARGET_NAME", line, path));
+            }
+            count++;
+        }
+        if (read == "INSTRUMENT_HOST_NAME") {
+            if (decode(line).empty()) {
+                LWARNING(fmt::format(ErrorMsg, "INSTRUMENT_HOST_NAME", line, path));
+            }
+            count++;
+        }
+        if (read == "INSTRUMENT_ID") {
+            instrumentID = decode(line);
+            if (instrumentID.empty()) {
+                LWARNING(fmt::format(ErrorMsg, "INSTRUMENT_ID", line, path));
+            }
+            result.instrument = encode(line);
+            count++;
+        }
+        if (read == "DETECTOR_TYPE") {
+            if (decode(line).empty()) {
+                LWARNING(fmt::format(ErrorMsg, "DETECTOR_TYPE", line, path));
+            }
+            count++;
         }
 
-        int count = 0;
+        if (read == "START_TIME") {
+            std::string start = line.substr(line.find('=') + 1);
+            start.erase(std::remove(start.begin(), start.end(), ' '), start.end());
+            startTime = SpiceManager::ref().ephemerisTimeFromDate(start);
+            count++;
 
-        // open up label files
-        double startTime = 0.0;
-        double stopTime = 0.0;
-        std::string line;
-        do {
             std::getline(file, line);
-
             line.erase(std::remove(line.begin(), line.end(), '"'), line.end());
             line.erase(std::remove(line.begin(), line.end(), ' '), line.end());
             line.erase(std::remove(line.begin(), line.end(), '\r'), line.end());
 
-            std::string read = line.substr(0, line.find_first_of('='));
-
-            _detectorType = "CAMERA"; // default value
-
-            constexpr std::string_view ErrorMsg =
-                "Unrecognized '{}' in line {} in file {}. The 'Convert' table must "
-                "contain the identity tranformation for all values encountered in the "
-                "label files, for example: ROSETTA = {{ \"ROSETTA\" }}";
-
-            // Add more
-            if (read == "TARGET_NAME") {
-                _target = decode(line);
-                if (_target.empty()) {
-                    LWARNING(fmt::format(ErrorMsg, "TARGET_NAME", line, path));
-                }
-                count++;
-            }
-            if (read == "INSTRUMENT_HOST_NAME") {
-                _instrumentHostID = decode(line);
-                if (_instrumentHostID.empty()) {
-                    LWARNING(fmt::format(ErrorMsg, "INSTRUMENT_HOST_NAME", line, path));
-                }
+            read = line.substr(0, line.find_first_of('='));
+            if (read == "STOP_TIME") {
+                std::string stop = line.substr(line.find('=') + 1);
+                stop.erase(
+                    std::remove_if(
+                        stop.begin(),
+                        stop.end(),
+                        [](char c) { return c == ' ' || c == '\r'; }
+                    ),
+                    stop.end()
+                );
+                stopTime = SpiceManager::ref().ephemerisTimeFromDate(stop);
                 count++;
             }
-            if (read == "INSTRUMENT_ID") {
-                _instrumentID = decode(line);
-                if (_instrumentID.empty()) {
-                    LWARNING(fmt::format(ErrorMsg, "INSTRUMENT_ID", line, path));
-                }
-                lblName = encode(line);
-                count++;
+            else{
+                LERROR(fmt::format(
+                    "Label file {} deviates from generic standard", path
+                ));
+                LINFO(
+                    "Please make sure input data adheres to format from \
+                    https://pds.jpl.nasa.gov/documents/qs/labels.html"
+                );
             }
-            if (read == "DETECTOR_TYPE") {
-                _detectorType = decode(line);
-                if (_detectorType.empty()) {
-                    LWARNING(fmt::format(ErrorMsg, "DETECTOR_TYPE", line, path));
+        }
+        if (count == static_cast<int>(_specsOfInterest.size())) {
+            count = 0;
+
+            using namespace std::literals;
+            std::string p = path.substr(0, path.size() - ("lbl"s).size());
+            for (const std::string& ext : extensions) {
+                std::string imagePath = p + ext;
+                if (std::binary_search(files.begin(), files.end(), imagePath)) {
+                    Image image = {
+                        .timeRange = TimeRange(startTime, stopTime),
+                        .path = std::move(imagePath),
+                        .activeInstruments = { instrumentID },
+                        .target = target,
+                        .isPlaceholder = false,
+                        .projected = false
+                    };
+                    result.images.push_back(std::move(image));
+                    break;
                 }
-                count++;
             }
+        }
+    } while (!file.eof());
 
-            if (read == "START_TIME") {
-                std::string start = line.substr(line.find('=') + 1);
-                start.erase(std::remove(start.begin(), start.end(), ' '), start.end());
-                startTime = SpiceManager::ref().ephemerisTimeFromDate(start);
-                count++;
+    return result;
+}
 
-                std::getline(file, line);
-                line.erase(std::remove(line.begin(), line.end(), '"'), line.end());
-                line.erase(std::remove(line.begin(), line.end(), ' '), line.end());
-                line.erase(std::remove(line.begin(), line.end(), '\r'), line.end());
-
-                read = line.substr(0, line.find_first_of('='));
-                if (read == "STOP_TIME") {
-                    std::string stop = line.substr(line.find('=') + 1);
-                    stop.erase(
-                        std::remove_if(
-                            stop.begin(),
-                            stop.end(),
-                            [](char c) { return c == ' ' || c == '\r'; }
-                        ),
-                        stop.end()
-                    );
-                    stopTime = SpiceManager::ref().ephemerisTimeFromDate(stop);
-                    count++;
-                }
-                else{
-                    LERROR(fmt::format(
-                        "Label file {} deviates from generic standard", path
-                    ));
-                    LINFO(
-                        "Please make sure input data adheres to format from \
-                        https://pds.jpl.nasa.gov/documents/qs/labels.html"
-                    );
-                }
-            }
-            if (count == static_cast<int>(_specsOfInterest.size())) {
-                const std::vector<std::string> extensions =
-                    ghoul::io::TextureReader::ref().supportedExtensions();
-
-                count = 0;
-
-                using namespace std::literals;
-                std::string p = path.substr(0, path.size() - ("lbl"s).size());
-                for (const std::string& ext : extensions) {
-                    std::string imagePath = p + ext;
-                    if (std::filesystem::is_regular_file(imagePath)) {
-                        std::vector<std::string> spiceInstrument;
-                        spiceInstrument.push_back(_instrumentID);
-
-                        Image image = {
-                            .timeRange = TimeRange(startTime, stopTime),
-                            .path = imagePath,
-                            .activeInstruments = spiceInstrument,
-                            .target = _target,
-                            .isPlaceholder = false,
-                            .projected = false
-                        };
-
-                        _subsetMap[image.target]._subset.push_back(image);
-                        _subsetMap[image.target]._range.include(startTime);
-
-                        _captureProgression.push_back(startTime);
-                        std::stable_sort(
-                            _captureProgression.begin(),
-                            _captureProgression.end()
-                        );
-
-                        break;
-                    }
-                }
-            }
-        } while (!file.eof());
+bool LabelParser::create() {
+    namespace fs = std::filesystem;
+
+    fs::path sequenceDir = absPath(_fileName);
+    if (!fs::is_directory(sequenceDir)) {
+        LERROR(fmt::format("Could not load Label Directory {}", sequenceDir));
+        return false;
+    }
+
+    // The images are located next to their label files, so all files in the directory
+    // are needed to find them and all of them contribute to the cache fingerprint
+    std::vector<std::string> files;
+    for (const fs::directory_entry& e : fs::recursive_directory_iterator(sequenceDir)) {
+        if (e.is_regular_file()) {
+            files.push_back(e.path().string());
+        }
+    }
+    std::sort(files.begin(), files.end());
+
+    const std::vector<std::string> extensions =
+        ghoul::io::TextureReader::ref().supportedExtensions();
+
+    std::string fingerprint;
+    for (const std::string& file : files) {
+        fingerprint += fmt::format(
+            "{}|{}|{}\n",
+            file,
+            fs::file_size(file),
+            fs::last_write_time(file).time_since_epoch().count()
+        );
+    }
+    for (const std::string& spec : _specsOfInterest) {
+        fingerprint += spec + '\n';
     }
+    for (const std::string& ext : extensions) {
+        fingerprint += ext + '\n';
+    }
+
+    const fs::path cachedFile = cacheFile(sequenceDir, fingerprint);
+    if (loadCache(cachedFile)) {
+        LINFO(fmt::format(
+            "Cached file {} used for label directory {}", cachedFile, sequenceDir
+        ));
+        return true;
+    }
+
+    std::vector<std::string> labels;
+    for (const std::string& file : files) {
+        const fs::path extension = fs::path(file).extension();
+        if (extension == ".lbl" || extension == ".LBL") {
+            labels.push_back(file);
+        }
+    }
+
+    // Each label file is parsed independently and the results are merged in the sorted
+    // order of the files afterwards so that the result does not depend on the order in
+    // which the worker threads finish
+    std::vector<std::optional<LabelFile>> results(labels.size());
+    parallelFor(
+        labels.size(),
+        [&](size_t i) { results[i] = parseFile(labels[i], files, extensions); }
+    );
+
+    std::string lblName;
+    for (size_t i = 0; i < labels.size(); i++) {
+        if (!results[i].has_value()) {
+            LERROR(fmt::format("Failed to open label file {}", fs::path(labels[i])));
+            return false;
+        }
+
+        LabelFile& label = *results[i];
+        if (label.instrument.has_value()) {
+            lblName = *label.instrument;
+        }
+        for (Image& image : label.images) {
+            ImageSubset& subset = _subsetMap[image.target];
+            subset._range.include(image.timeRange.start);
+            _captureProgression.push_back(image.timeRange.start);
+            subset._subset.push_back(std::move(image));
+        }
+    }
+    std::stable_sort(_captureProgression.begin(), _captureProgression.end());
 
-    std::vector<Image> tmp;
+    std::vector<const Image*> tmp;
     for (const std::pair<const std::string, ImageSubset>& key : _subsetMap) {
         for (const Image& image : key.second._subset) {
-            tmp.push_back(image);
+            tmp.push_back(&image);
         }
     }
-    std::sort(
+    std::stable_sort(
         tmp.begin(),
         tmp.end(),
-        [](const Image& a, const Image& b) -> bool {
-            return a.timeRange.start < b.timeRange.start;
+        [](const Image* a, const Image* b) {
+            return a->timeRange.start < b->timeRange.start;
         }
     );
 
     std::string previousTarget;
-    for (const Image& image : tmp) {
-        if (previousTarget == image.target) {
+    for (const Image* image : tmp) {
+        if (previousTarget == image->target) {
             continue;
         }
 
-        previousTarget = image.target;
-        _targetTimes.emplace_back(image.timeRange.start , image.target);
-        std::sort(
-            _targetTimes.begin(),
-            _targetTimes.end(),
-            [](const std::pair<double, std::string>& a,
-               const std::pair<double, std::string>& b) -> bool
-            {
-                return a.first < b.first;
-            }
-        );
+        previousTarget = image->target;
+        _targetTimes.emplace_back(image->timeRange.start, image->target);
     }
 
     for (const std::pair<const std::string, ImageSubset>& target : _subsetMap) {
-        _instrumentTimes.emplace_back(lblName, _subsetMap[target.first]._range);
+        _instrumentTimes.emplace_back(lblName, target.second._range);
     }
+
+    LINFO(fmt::format(
+        "Saving cache {} for label directory {}", cachedFile, sequenceDir
+    ));
+    saveCache(cachedFile);
     return true;
 }
 
@@ -27,6 +27,8 @@
 
 #include <modules/spacecraftinstruments/util/sequenceparser.h>
 
+#include <optional>
+
 namespace openspace {
 
 class LabelParser : public SequenceParser {
@@ -36,16 +38,27 @@ public:
     bool create() override;
 
 private:
+    struct LabelFile {
+        std::vector<Image> images;
+        /// The last INSTRUMENT_ID that was encountered in the label file
+        std::optional<std::string> instrument;
+    };
+
     std::string encode(const std::string& line) const;
-    std::string decode(const std::string& line);
+    std::string decode(const std::string& line) const;
+
+    /**
+     * Parses a single label file. \p files is the sorted list of all files in the
+     * sequence directory that is used to find the images that belong to the label and
+     * \p extensions are the image extensions that are tried in order. Returns
+     * `std::nullopt` if the label file could not be opened.
+     */
+    std::optional<LabelFile> parseFile(const std::string& path,
+        const std::vector<std::string>& files,
+        const std::vector<std::string>& extensions) const;
 
     std::string _fileName;
     std::vector<std::string> _specsOfInterest;
-
-    std::string _target;
-    std::string _instrumentID;
-    std::string _instrumentHostID;
-    std::string _detectorType;
 };
 
 } // namespace openspace
@@ -39,6 +39,7 @@
 #include <ghoul/opengl/textureunit.h>
 #include <ghoul/opengl/texture.h>
 #include <ghoul/systemcapabilities/openglcapabilitiescomponent.h>
+#include <future>
 #include <optional>
 
 namespace {
@@ -321,10 +322,20 @@ void ProjectionComponent::initialize(const std::string& identifier,
         }
     }
 
+    // The parsers are independent of each other, so they can read their sources at the
+    // same time. The results are handed to the ImageSequencer in the original order
+    std::vector<std::future<bool>> results;
     for (std::unique_ptr<SequenceParser>& parser : parsers) {
-        bool success = parser->create();
+        SequenceParser* ptr = parser.get();
+        results.push_back(
+            std::async(std::launch::async, [ptr]() { return ptr->create(); })
+        );
+    }
+
+    for (size_t i = 0; i < parsers.size(); i++) {
+        bool success = results[i].get();
         if (success) {
-            ImageSequencer::ref().runSequenceParser(*parser);
+            ImageSequencer::ref().runSequenceParser(*parsers[i]);
         }
         else {
             LERROR("One or more sequence loads failed; please check asset files");
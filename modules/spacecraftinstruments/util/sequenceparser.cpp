@@ -25,8 +25,59 @@
 #include <modules/spacecraftinstruments/util/sequenceparser.h>
 
 #include <openspace/engine/globals.h>
+#include <openspace/util/cachefiles.h>
 #include <openspace/util/spicemanager.h>
+#include <ghoul/fmt.h>
+#include <ghoul/filesystem/filesystem.h>
 #include <ghoul/logging/logmanager.h>
+#include <ghoul/misc/crc32.h>
+#include <algorithm>
+#include <atomic>
+#include <exception>
+#include <fstream>
+#include <mutex>
+#include <thread>
+
+namespace {
+    constexpr std::string_view _loggerCat = "SequenceParser";
+
+    constexpr int8_t CurrentCacheVersion = 1;
+
+    void writeString(std::ofstream& stream, const std::string& value) {
+        uint32_t length = static_cast<uint32_t>(value.size());
+        stream.write(reinterpret_cast<const char*>(&length), sizeof(uint32_t));
+        stream.write(value.data(), length * sizeof(char));
+    }
+
+    std::string readString(std::ifstream& stream) {
+        uint32_t length = 0;
+        stream.read(reinterpret_cast<char*>(&length), sizeof(uint32_t));
+        std::string value;
+        if (stream.good()) {
+            value.resize(length);
+            stream.read(value.data(), length * sizeof(char));
+        }
+        return value;
+    }
+
+    void writeTimeRange(std::ofstream& stream, const openspace::TimeRange& range) {
+        stream.write(reinterpret_cast<const char*>(&range.start), sizeof(double));
+        stream.write(reinterpret_cast<const char*>(&range.end), sizeof(double));
+    }
+
+    openspace::TimeRange readTimeRange(std::ifstream& stream) {
+        openspace::TimeRange range;
+        stream.read(reinterpret_cast<char*>(&range.start), sizeof(double));
+        stream.read(reinterpret_cast<char*>(&range.end), sizeof(double));
+        return range;
+    }
+
+    uint32_t readSize(std::ifstream& stream) {
+        uint32_t size = 0;
+        stream.read(reinterpret_cast<char*>(&size), sizeof(uint32_t));
+        return stream.good() ? size : 0;
+    }
+} // namespace
 
 namespace openspace {
 
@@ -51,4 +102,224 @@ std::map<std::string, std::unique_ptr<Decoder>>& SequenceParser::translations()
     return _fileTranslation;
 }
 
+std::filesystem::path SequenceParser::cacheFile(const std::filesystem::path& source,
+                                                std::string_view fingerprint) const
+{
+    // The translation table determines which lines of the source files end up in the
+    // parsed tables, so any change to it has to invalidate the cache as well
+    std::string translation;
+    for (const std::pair<const std::string, std::unique_ptr<Decoder>>& p :
+         _fileTranslation)
+    {
+        translation += fmt::format("{}|{}", p.first, p.second->decoderType());
+        for (const std::string& t : p.second->translations()) {
+            translation += fmt::format("|{}", t);
+        }
+        translation += '\n';
+    }
+
+    // All times in the parsed tables are converted to ephemeris time using the loaded
+    // leapseconds and spacecraft clock kernels, so they are part of the cache key, too
+    std::string kernels;
+    for (const std::filesystem::path& kernel : SpiceManager::ref().loadedKernels()) {
+        std::string extension = kernel.extension().string();
+        std::transform(
+            extension.begin(),
+            extension.end(),
+            extension.begin(),
+            [](char c) { return static_cast<char>(::tolower(c)); }
+        );
+        if (extension != ".tls" && extension != ".tsc") {
+            continue;
+        }
+
+        std::error_code ec;
+        const auto modified = std::filesystem::last_write_time(kernel, ec);
+        kernels += fmt::format(
+            "{}|{}\n",
+            kernel,
+            ec ? 0 : modified.time_since_epoch().count()
+        );
+    }
+
+    return cachedFilename(
+        source,
+        fmt::format(
+            "{}|{}|{}|{}",
+            static_cast<int>(CurrentCacheVersion),
+            ghoul::hashCRC32(fingerprint),
+            ghoul::hashCRC32(translation),
+            ghoul::hashCRC32(kernels)
+        )
+    );
+}
+
+bool SequenceParser::loadCache(const std::filesystem::path& file) {
+    if (!std::filesystem::is_regular_file(file)) {
+        return false;
+    }
+
+    std::ifstream stream(file, std::ifstream::binary);
+
+    int8_t version = 0;
+    stream.read(reinterpret_cast<char*>(&version), sizeof(int8_t));
+    if (version != CurrentCacheVersion) {
+        LINFO("The format of the cached file has changed");
+        return false;
+    }
+
+    const uint32_t nSubsets = readSize(stream);
+    for (uint32_t i = 0; i < nSubsets; i++) {
+        std::string target = readString(stream);
+        ImageSubset& subset = _subsetMap[target];
+        subset._range = readTimeRange(stream);
+
+        const uint32_t nImages = readSize(stream);
+        subset._subset.reserve(nImages);
+        for (uint32_t j = 0; j < nImages; j++) {
+            Image image;
+            image.timeRange = readTimeRange(stream);
+            image.path = readString(stream);
+            const uint32_t nInstruments = readSize(stream);
+            image.activeInstruments.reserve(nInstruments);
+            for (uint32_t k = 0; k < nInstruments; k++) {
+                image.activeInstruments.push_back(readString(stream));
+            }
+            image.target = readString(stream);
+            uint8_t flags = 0;
+            stream.read(reinterpret_cast<char*>(&flags), sizeof(uint8_t));
+            image.isPlaceholder = (flags & 1) != 0;
+            image.projected = (flags & 2) != 0;
+            subset._subset.push_back(std::move(image));
+        }
+    }
+
+    const uint32_t nInstrumentTimes = readSize(stream);
+    _instrumentTimes.reserve(nInstrumentTimes);
+    for (uint32_t i = 0; i < nInstrumentTimes; i++) {
+        std::string instrument = readString(stream);
+        TimeRange range = readTimeRange(stream);
+        _instrumentTimes.emplace_back(std::move(instrument), range);
+    }
+
+    const uint32_t nTargetTimes = readSize(stream);
+    _targetTimes.reserve(nTargetTimes);
+    for (uint32_t i = 0; i < nTargetTimes; i++) {
+        double time = 0.0;
+        stream.read(reinterpret_cast<char*>(&time), sizeof(double));
+        _targetTimes.emplace_back(time, readString(stream));
+    }
+
+    const uint32_t nCaptures = readSize(stream);
+    _captureProgression.resize(nCaptures);
+    stream.read(
+        reinterpret_cast<char*>(_captureProgression.data()),
+        nCaptures * sizeof(double)
+    );
+
+    if (!stream.good()) {
+        LWARNING(fmt::format("Cache file {} is incomplete", file));
+        _subsetMap.clear();
+        _instrumentTimes.clear();
+        _targetTimes.clear();
+        _captureProgression.clear();
+        return false;
+    }
+    return true;
+}
+
+void SequenceParser::saveCache(const std::filesystem::path& file) const {
+    std::ofstream stream(file, std::ofstream::binary);
+
+    stream.write(reinterpret_cast<const char*>(&CurrentCacheVersion), sizeof(int8_t));
+
+    uint32_t nSubsets = static_cast<uint32_t>(_subsetMap.size());
+    stream.write(reinterpret_cast<const char*>(&nSubsets), sizeof(uint32_t));
+    for (const std::pair<const std::string, ImageSubset>& p : _subsetMap) {
+        writeString(stream, p.first);
+        writeTimeRange(stream, p.second._range);
+
+        uint32_t nImages = static_cast<uint32_t>(p.second._subset.size());
+        stream.write(reinterpret_cast<const char*>(&nImages), sizeof(uint32_t));
+        for (const Image& image : p.second._subset) {
+            writeTimeRange(stream, image.timeRange);
+            writeString(stream, image.path);
+            uint32_t nInstruments = static_cast<uint32_t>(image.activeInstruments.size());
+            stream.write(reinterpret_cast<const char*>(&nInstruments), sizeof(uint32_t));
+            for (const std::string& instrument : image.activeInstruments) {
+                writeString(stream, instrument);
+            }
+            writeString(stream, image.target);
+            uint8_t flags = (image.isPlaceholder ? 1 : 0) | (image.projected ? 2 : 0);
+            stream.write(reinterpret_cast<const char*>(&flags), sizeof(uint8_t));
+        }
+    }
+
+    uint32_t nInstrumentTimes = static_cast<uint32_t>(_instrumentTimes.size());
+    stream.write(reinterpret_cast<const char*>(&nInstrumentTimes), sizeof(uint32_t));
+    for (const std::pair<std::string, TimeRange>& p : _instrumentTimes) {
+        writeString(stream, p.first);
+        writeTimeRange(stream, p.second);
+    }
+
+    uint32_t nTargetTimes = static_cast<uint32_t>(_targetTimes.size());
+    stream.write(reinterpret_cast<const char*>(&nTargetTimes), sizeof(uint32_t));
+    for (const std::pair<double, std::string>& p : _targetTimes) {
+        stream.write(reinterpret_cast<const char*>(&p.first), sizeof(double));
+        writeString(stream, p.second);
+    }
+
+    uint32_t nCaptures = static_cast<uint32_t>(_captureProgression.size());
+    stream.write(reinterpret_cast<const char*>(&nCaptures), sizeof(uint32_t));
+    stream.write(
+        reinterpret_cast<const char*>(_captureProgression.data()),
+        nCaptures * sizeof(double)
+    );
+}
+
+void SequenceParser::parallelFor(size_t n, const std::function<void(size_t)>& function) {
+    std::atomic<size_t> next = 0;
+    std::mutex mutex;
+    std::exception_ptr exception;
+
+    auto work = [&]() {
+        while (true) {
+            const size_t i = next++;
+            if (i >= n) {
+                return;
+            }
+
+            try {
+                function(i);
+            }
+            catch (...) {
+                std::lock_guard lock(mutex);
+                if (!exception) {
+                    exception = std::current_exception();
+                }
+                // Skip all remaining items as the result is discarded anyway
+                next = n;
+            }
+        }
+    };
+
+    // The calling thread takes part in the work, too
+    const size_t nThreads = std::min<size_t>(
+        std::max(std::thread::hardware_concurrency(), 1u),
+        n
+    );
+    std::vector<std::thread> threads;
+    for (size_t i = 1; i < nThreads; i++) {
+        threads.emplace_back(work);
+    }
+    work();
+    for (std::thread& t : threads) {
+        t.join();
+    }
+
+    if (exception) {
+        std::rethrow_exception(exception);
+    }
+}
+
 } // namespace openspace
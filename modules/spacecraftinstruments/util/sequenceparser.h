@@ -28,9 +28,12 @@
 #include <modules/spacecraftinstruments/util/decoder.h>
 #include <modules/spacecraftinstruments/util/image.h>
 #include <openspace/util/timerange.h>
+#include <filesystem>
+#include <functional>
 #include <map>
 #include <memory>
 #include <string>
+#include <string_view>
 #include <vector>
 
 namespace openspace {
@@ -47,6 +50,33 @@ public:
     const std::vector<double>& captureProgression() const;
 
 protected:
+    /**
+     * Returns the location of the cache file for the tables parsed from \p source. The
+     * \p fingerprint has to change whenever the contents of the \p source change and
+     * is combined with the fingerprints of the translation table and of the loaded
+     * leapseconds and spacecraft clock kernels.
+     */
+    std::filesystem::path cacheFile(const std::filesystem::path& source,
+        std::string_view fingerprint) const;
+
+    /**
+     * Loads the parsed tables from the provided cache \p file. Returns `false` and
+     * leaves all tables empty if the file does not exist or could not be read.
+     */
+    bool loadCache(const std::filesystem::path& file);
+
+    /**
+     * Stores the parsed tables in the provided cache \p file.
+     */
+    void saveCache(const std::filesystem::path& file) const;
+
+    /**
+     * Calls \p function for all indices in [0, \p n) on all available cores and
+     * returns when all calls have finished. The first exception that is thrown by any
+     * of the calls is rethrown on the calling thread.
+     */
+    static void parallelFor(size_t n, const std::function<void(size_t)>& function);
+
     std::map<std::string, ImageSubset> _subsetMap;
     std::vector<std::pair<std::string, TimeRange>> _instrumentTimes;
     std::vector<std::pair<double, std::string>> _targetTimes;
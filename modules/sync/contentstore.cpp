@@ -0,0 +1,484 @@
+/*****************************************************************************************
+ *                                                                                       *
+ * OpenSpace                                                                             *
+ *                                                                                       *
+ * Copyright (c) 2014-2023                                                               *
+ *                                                                                       *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this  *
+ * software and associated documentation files (the "Software"), to deal in the Software *
+ * without restriction, including without limitation the rights to use, copy, modify,    *
+ * merge, publish, distribute, sublicense, and/or sell copies of the Software, and to    *
+ * permit persons to whom the Software is furnished to do so, subject to the following   *
+ * conditions:                                                                           *
+ *                                                                                       *
+ * The above copyright notice and this permission notice shall be included in all copies *
+ * or substantial portions of the Software.                                              *
+ *                                                                                       *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,   *
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A         *
+ * PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT    *
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF  *
+ * CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE  *
+ * OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                                         *
+ ****************************************************************************************/
+
+
+#include <modules/sync/contentstore.h>
+
+#include <ghoul/fmt.h>
+#include <ghoul/logging/logmanager.h>
+#include <ghoul/misc/assert.h>
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstring>
+#include <fstream>
+#include <vector>
+
+#ifdef __linux__
+#include <fcntl.h>
+#include <linux/fs.h>
+#include <sys/ioctl.h>
+#include <unistd.h>
+#endif // __linux__
+
+#ifdef __APPLE__
+#include <sys/clonefile.h>
+#endif // __APPLE__
+
+namespace {
+    constexpr std::string_view _loggerCat = "ContentStore";
+
+    // The size of the chunks in which files are read while hashing them
+    constexpr size_t ReadBufferSize = 1 << 20;
+
+    // Implementation of SHA-256 as described in FIPS 180-4
+    class Sha256 {
+    public:
+        void update(const char* data, size_t size) {
+            _nBytes += size;
+            while (size > 0) {
+                const size_t n = std::min(size, _block.size() - _blockSize);
+                std::memcpy(_block.data() + _blockSize, data, n);
+                _blockSize += n;
+                data += n;
+                size -= n;
+                if (_blockSize == _block.size()) {
+                    processBlock();
+                    _blockSize = 0;
+                }
+            }
+        }
+
+        std::string finish() {
+            const uint64_t nBits = _nBytes * 8;
+
+            const char Padding = static_cast<char>(0x80);
+            update(&Padding, 1);
+            const char Zero = 0;
+            while (_blockSize != 56) {
+                update(&Zero, 1);
+            }
+            std::array<char, 8> length;
+            for (int i = 0; i < 8; i++) {
+                length[i] = static_cast<char>(nBits >> (56 - 8 * i));
+            }
+            update(length.data(), length.size());
+
+            std::string res;
+            res.reserve(64);
+            for (uint32_t h : _state) {
+                res += fmt::format("{:08x}", h);
+            }
+            return res;
+        }
+
+    private:
+        static uint32_t rotr(uint32_t x, int n) {
+            return (x >> n) | (x << (32 - n));
+        }
+
+        void processBlock() {
+            constexpr std::array<uint32_t, 64> K = {
+                0x428a2f98, 0x71374491, 0xb5c0fbcf, 0xe9b5dba5, 0x3956c25b, 0x59f111f1,
+                0x923f82a4, 0xab1c5ed5, 0xd807aa98, 0x12835b01, 0x243185be, 0x550c7dc3,
+                0x72be5d74, 0x80deb1fe, 0x9bdc06a7, 0xc19bf174, 0xe49b69c1, 0xefbe4786,
+                0x0fc19dc6, 0x240ca1cc, 0x2de92c6f, 0x4a7484aa, 0x5cb0a9dc, 0x76f988da,
+                0x983e5152, 0xa831c66d, 0xb00327c8, 0xbf597fc7, 0xc6e00bf3, 0xd5a79147,
+                0x06ca6351, 0x14292967, 0x27b70a85, 0x2e1b2138, 0x4d2c6dfc, 0x53380d13,
+                0x650a7354, 0x766a0abb, 0x81c2c92e, 0x92722c85, 0xa2bfe8a1, 0xa81a664b,
+                0xc24b8b70, 0xc76c51a3, 0xd192e819, 0xd6990624, 0xf40e3585, 0x106aa070,
+                0x19a4c116, 0x1e376c08, 0x2748774c, 0x34b0bcb5, 0x391c0cb3, 0x4ed8aa4a,
+                0x5b9cca4f, 0x682e6ff3, 0x748f82ee, 0x78a5636f, 0x84c87814, 0x8cc70208,
+                0x90befffa, 0xa4506ceb, 0xbef9a3f7, 0xc67178f2
+            };
+
+            std::array<uint32_t, 64> w;
+            for (int i = 0; i < 16; i++) {
+                const uint8_t* b = reinterpret_cast<const uint8_t*>(&_block[4 * i]);
+                w[i] = (static_cast<uint32_t>(b[0]) << 24) |
+                       (static_cast<uint32_t>(b[1]) << 16) |
+                       (static_cast<uint32_t>(b[2]) << 8) |
+                       static_cast<uint32_t>(b[3]);
+            }
+            for (int i = 16; i < 64; i++) {
+                const uint32_t s0 =
+                    rotr(w[i - 15], 7) ^ rotr(w[i - 15], 18) ^ (w[i - 15] >> 3);
+                const uint32_t s1 =
+                    rotr(w[i - 2], 17) ^ rotr(w[i - 2], 19) ^ (w[i - 2] >> 10);
+                w[i] = w[i - 16] + s0 + w[i - 7] + s1;
+            }
+
+            uint32_t a = _state[0];
+            uint32_t b = _state[1];
+            uint32_t c = _state[2];
+            uint32_t d = _state[3];
+            uint32_t e = _state[4];
+            uint32_t f = _state[5];
+            uint32_t g = _state[6];
+            uint32_t h = _state[7];
+            for (int i = 0; i < 64; i++) {
+                const uint32_t s1 = rotr(e, 6) ^ rotr(e, 11) ^ rotr(e, 25);
+                const uint32_t ch = (e & f) ^ (~e & g);
+                const uint32_t t1 = h + s1 + ch + K[i] + w[i];
+                const uint32_t s0 = rotr(a, 2) ^ rotr(a, 13) ^ rotr(a, 22);
+                const uint32_t maj = (a & b) ^ (a & c) ^ (b & c);
+                const uint32_t t2 = s0 + maj;
+                h = g;
+                g = f;
+                f = e;
+                e = d + t1;
+                d = c;
+                c = b;
+                b = a;
+                a = t1 + t2;
+            }
+            _state[0] += a;
+            _state[1] += b;
+            _state[2] += c;
+            _state[3] += d;
+            _state[4] += e;
+            _state[5] += f;
+            _state[6] += g;
+            _state[7] += h;
+        }
+
+        std::array<uint32_t, 8> _state = {
+            0x6a09e667, 0xbb67ae85, 0x3c6ef372, 0xa54ff53a,
+            0x510e527f, 0x9b05688c, 0x1f83d9ab, 0x5be0cd19
+        };
+        std::array<char, 64> _block = {};
+        size_t _blockSize = 0;
+        uint64_t _nBytes = 0;
+    };
+
+    // Creates a copy-on-write clone of the source file if the file system supports it
+    bool reflink(const std::filesystem::path& source,
+                 const std::filesystem::path& destination)
+    {
+#if defined(__linux__) && defined(FICLONE)
+        const int src = open(source.c_str(), O_RDONLY);
+        if (src < 0) {
+            return false;
+        }
+        const int dst = open(destination.c_str(), O_WRONLY | O_CREAT | O_EXCL, 0644);
+        if (dst < 0) {
+            close(src);
+            return false;
+        }
+        const bool success = ioctl(dst, FICLONE, src) == 0;
+        close(dst);
+        close(src);
+        if (!success) {
+            unlink(destination.c_str());
+        }
+        return success;
+#elif defined(__APPLE__) // ^^^ __linux__ / __APPLE__ vvv
+        return clonefile(source.c_str(), destination.c_str(), 0) == 0;
+#else // ^^^ __APPLE__ / !__linux__ && !__APPLE__ vvv
+        (void)source;
+        (void)destination;
+        return false;
+#endif
+    }
+
+    // Removes the write permissions of an object. A view that is a hard link shares its
+    // contents and permissions with the object, so a synchronization cannot change the
+    // object by writing to one of its files
+    void protectObject(const std::filesystem::path& object) {
+        namespace fs = std::filesystem;
+        std::error_code ec;
+        fs::permissions(
+            object,
+            fs::perms::owner_write | fs::perms::group_write | fs::perms::others_write,
+            fs::perm_options::remove,
+            ec
+        );
+    }
+} // namespace
+
+namespace openspace {
+
+ContentStore::ContentStore(std::filesystem::path root)
+    : _root(std::move(root))
+{
+    std::filesystem::create_directories(_root / "objects");
+    std::filesystem::create_directories(_root / "tmp");
+}
+
+const std::filesystem::path& ContentStore::root() const {
+    return _root;
+}
+
+std::optional<std::string> ContentStore::hashFile(const std::filesystem::path& file) {
+    std::ifstream stream(file, std::ifstream::binary);
+    if (!stream.good()) {
+        return std::nullopt;
+    }
+
+    Sha256 sha;
+    std::vector<char> buffer(ReadBufferSize);
+    while (stream) {
+        stream.read(buffer.data(), buffer.size());
+        sha.update(buffer.data(), static_cast<size_t>(stream.gcount()));
+    }
+    if (stream.bad()) {
+        return std::nullopt;
+    }
+    return sha.finish();
+}
+
+std::string ContentStore::hashBuffer(std::string_view buffer) {
+    Sha256 sha;
+    sha.update(buffer.data(), buffer.size());
+    return sha.finish();
+}
+
+bool ContentStore::isValidHash(std::string_view hash) {
+    if (hash.size() != 64) {
+        return false;
+    }
+    for (char c : hash) {
+        if (!((c >= '0' && c <= '9') || (c >= 'a' && c <= 'f'))) {
+            return false;
+        }
+    }
+    return true;
+}
+
+std::filesystem::path ContentStore::objectPath(std::string_view hash) const {
+    ghoul_assert(isValidHash(hash), "Invalid hash");
+    return _root / "objects" / std::string(hash.substr(0, 2)) / std::string(hash);
+}
+
+bool ContentStore::contains(std::string_view hash) const {
+    return std::filesystem::is_regular_file(objectPath(hash));
+}
+
+bool ContentStore::verify(std::string_view hash) const {
+    const std::filesystem::path object = objectPath(hash);
+    if (!std::filesystem::is_regular_file(object)) {
+        return false;
+    }
+
+    const std::optional<std::string> actual = hashFile(object);
+    if (actual.has_value() && *actual == hash) {
+        return true;
+    }
+
+    LWARNING(fmt::format("Removing corrupted object {} from the content store", hash));
+    std::error_code ec;
+    std::filesystem::remove(object, ec);
+    return false;
+}
+
+std::optional<std::string> ContentStore::insert(const std::filesystem::path& file,
+                                                const std::filesystem::path& destination,
+                                                std::string_view expectedHash)
+{
+    std::optional<std::string> hash = hashFile(file);
+    if (!hash.has_value()) {
+        LERROR(fmt::format("Could not read file {}", file));
+        return std::nullopt;
+    }
+
+    std::error_code ec;
+    if (!expectedHash.empty() && *hash != expectedHash) {
+        LERROR(fmt::format(
+            "Contents of {} do not match the expected hash. Expected {} but got {}",
+            file, expectedHash, *hash
+        ));
+        std::filesystem::remove(file, ec);
+        return std::nullopt;
+    }
+
+    const std::filesystem::path object = objectPath(*hash);
+    // An existing object is verified first, as the views that are created from it might
+    // be hard links. A corrupted object is removed and replaced by the new file
+    if (!contains(*hash) || !verify(*hash)) {
+        std::filesystem::create_directories(object.parent_path(), ec);
+
+        // Renaming is atomic, so concurrent inserts of the same content are harmless
+        std::filesystem::rename(file, object, ec);
+        if (ec) {
+            // The file might be on a different file system than the store
+            const std::filesystem::path tmp = temporaryPath();
+            std::filesystem::copy_file(file, tmp, ec);
+            if (!ec) {
+                std::filesystem::rename(tmp, object, ec);
+            }
+            if (ec) {
+                LERROR(fmt::format(
+                    "Could not add {} to the content store: {}", file, ec.message()
+                ));
+                std::filesystem::remove(tmp, ec);
+                return std::nullopt;
+            }
+            std::filesystem::remove(file, ec);
+        }
+    }
+    else {
+        std::filesystem::remove(file, ec);
+    }
+
+    if (!createView(*hash, destination)) {
+        return std::nullopt;
+    }
+    return hash;
+}
+
+bool ContentStore::createView(std::string_view hash,
+                              const std::filesystem::path& destination) const
+{
+    const std::filesystem::path object = objectPath(hash);
+
+    std::error_code ec;
+    if (destination.has_parent_path()) {
+        std::filesystem::create_directories(destination.parent_path(), ec);
+    }
+    std::filesystem::remove(destination, ec);
+
+    protectObject(object);
+
+    if (reflink(object, destination)) {
+        return true;
+    }
+
+    std::filesystem::create_hard_link(object, destination, ec);
+    if (!ec) {
+        return true;
+    }
+
+    // The store and the destination might be on different file systems
+    std::filesystem::copy_file(
+        object,
+        destination,
+        std::filesystem::copy_options::overwrite_existing,
+        ec
+    );
+    if (!ec) {
+        return true;
+    }
+
+    LERROR(fmt::format(
+        "Could not create {} from the content store: {}", destination, ec.message()
+    ));
+    return false;
+}
+
+ContentStore::ImportResult ContentStore::importDirectory(
+                                                   const std::filesystem::path& directory,
+                                                                  ReplaceWithView replace)
+{
+    ImportResult result;
+
+    // Collect the files first as inserting objects changes the directory contents
+    std::vector<std::filesystem::path> files;
+    const std::filesystem::path root = std::filesystem::weakly_canonical(_root);
+    namespace fs = std::filesystem;
+    for (const fs::directory_entry& e : fs::recursive_directory_iterator(directory)) {
+        if (!e.is_regular_file()) {
+            continue;
+        }
+        const fs::path p = fs::weakly_canonical(e.path());
+        auto it = std::mismatch(root.begin(), root.end(), p.begin(), p.end());
+        if (it.first == root.end()) {
+            // Never import the store into itself
+            continue;
+        }
+        files.push_back(e.path());
+    }
+
+    for (const fs::path& file : files) {
+        result.nFiles++;
+
+        std::optional<std::string> hash = hashFile(file);
+        if (!hash.has_value()) {
+            LWARNING(fmt::format("Could not read file {}", file));
+            result.nFailed++;
+            continue;
+        }
+
+        std::error_code ec;
+        if (contains(*hash)) {
+            result.nDuplicateBytes += fs::file_size(file, ec);
+        }
+        else {
+            result.nNewObjects++;
+        }
+
+        if (replace) {
+            if (!insert(file, file, *hash)) {
+                result.nFailed++;
+            }
+        }
+        else if (!contains(*hash)) {
+            const fs::path object = objectPath(*hash);
+            const fs::path tmp = temporaryPath();
+            fs::create_directories(object.parent_path(), ec);
+            fs::copy_file(file, tmp, ec);
+            if (!ec) {
+                protectObject(tmp);
+                fs::rename(tmp, object, ec);
+            }
+            if (ec) {
+                LWARNING(fmt::format("Could not import file {}: {}", file, ec.message()));
+                fs::remove(tmp, ec);
+                result.nFailed++;
+            }
+        }
+    }
+
+    return result;
+}
+
+ContentStore::VerifyResult ContentStore::verifyAll() const {
+    VerifyResult result;
+
+    namespace fs = std::filesystem;
+    std::vector<std::string> hashes;
+    const fs::path objects = _root / "objects";
+    for (const fs::directory_entry& e : fs::recursive_directory_iterator(objects)) {
+        const std::string name = e.path().filename().string();
+        if (e.is_regular_file() && isValidHash(name)) {
+            hashes.push_back(name);
+        }
+    }
+
+    for (const std::string& hash : hashes) {
+        result.nObjects++;
+        if (!verify(hash)) {
+            result.nCorrupt++;
+        }
+    }
+    return result;
+}
+
+std::filesystem::path ContentStore::temporaryPath() const {
+    static std::atomic_uint64_t Counter = 0;
+    const auto now = std::chrono::steady_clock::now().time_since_epoch().count();
+    return _root / "tmp" / fmt::format("{}-{}", now, Counter++);
+}
+
+} // namespace openspace
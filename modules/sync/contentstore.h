@@ -0,0 +1,151 @@
+/*****************************************************************************************
+ *                                                                                       *
+ * OpenSpace                                                                             *
+ *                                                                                       *
+ * Copyright (c) 2014-2023                                                               *
+ *                                                                                       *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this  *
+ * software and associated documentation files (the "Software"), to deal in the Software *
+ * without restriction, including without limitation the rights to use, copy, modify,    *
+ * merge, publish, distribute, sublicense, and/or sell copies of the Software, and to    *
+ * permit persons to whom the Software is furnished to do so, subject to the following   *
+ * conditions:                                                                           *
+ *                                                                                       *
+ * The above copyright notice and this permission notice shall be included in all copies *
+ * or substantial portions of the Software.                                              *
+ *                                                                                       *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,   *
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A         *
+ * PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT    *
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF  *
+ * CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE  *
+ * OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                                         *
+ ****************************************************************************************/
+
+
+#ifndef __OPENSPACE_MODULE_SYNC___CONTENTSTORE___H__
+#define __OPENSPACE_MODULE_SYNC___CONTENTSTORE___H__
+
+#include <ghoul/misc/boolean.h>
+#include <filesystem>
+#include <optional>
+#include <string>
+#include <string_view>
+
+namespace openspace {
+
+/**
+ * A content-addressed store for the files of all ResourceSynchronizations. Every file is
+ * stored exactly once under the SHA-256 hash of its contents in
+ * `<root>/objects/<first two hex digits>/<hash>`, and the files that appear in the
+ * synchronization directories are views of these objects. A view is a reflink
+ * (copy-on-write clone) where the file system supports it, a hard link otherwise, and a
+ * plain copy if the store and the view are on different file systems. As a hard link
+ * shares its contents with the object, the objects are read-only, and an object is
+ * verified before it is reused for a synchronization (see #verify).
+ *
+ * All functions can be called concurrently from different synchronizations.
+ */
+class ContentStore {
+public:
+    BooleanType(ReplaceWithView);
+
+    struct ImportResult {
+        /// The number of files that were visited
+        size_t nFiles = 0;
+
+        /// The number of files whose contents were not in the store before
+        size_t nNewObjects = 0;
+
+        /// The number of bytes of the files that were already in the store
+        size_t nDuplicateBytes = 0;
+
+        /// The number of files that could not be imported
+        size_t nFailed = 0;
+    };
+
+    struct VerifyResult {
+        size_t nObjects = 0;
+
+        /// The number of objects that did not match their hash and were removed
+        size_t nCorrupt = 0;
+    };
+
+    /**
+     * Creates a ContentStore that keeps its objects in the \p root folder, which is
+     * created if it does not exist.
+     */
+    explicit ContentStore(std::filesystem::path root);
+
+    const std::filesystem::path& root() const;
+
+    /**
+     * Returns the lowercase hexadecimal SHA-256 hash of the contents of \p file or
+     * std::nullopt if the file could not be read.
+     */
+    static std::optional<std::string> hashFile(const std::filesystem::path& file);
+
+    /// Returns the lowercase hexadecimal SHA-256 hash of \p buffer
+    static std::string hashBuffer(std::string_view buffer);
+
+    /// Returns whether \p hash is a valid lowercase hexadecimal SHA-256 hash
+    static bool isValidHash(std::string_view hash);
+
+    /// Returns the path at which the object with the provided \p hash is stored
+    std::filesystem::path objectPath(std::string_view hash) const;
+
+    /// Returns whether an object with the provided \p hash is in the store
+    bool contains(std::string_view hash) const;
+
+    /**
+     * Recomputes the hash of the object with the provided \p hash and removes the object
+     * from the store if it does not match.
+     *
+     * \return `true` if the object exists and matches its hash
+     */
+    bool verify(std::string_view hash) const;
+
+    /**
+     * Moves the \p file into the store and places a view of it at \p destination. If the
+     * \p expectedHash is not empty and the contents of the \p file do not match it, the
+     * \p file is removed and nothing is added to the store. If an object with the same
+     * contents already exists, the \p file is removed and the view refers to the
+     * existing object.
+     *
+     * \return The hash of the contents or std::nullopt if an error occurred
+     */
+    std::optional<std::string> insert(const std::filesystem::path& file,
+        const std::filesystem::path& destination, std::string_view expectedHash = "");
+
+    /**
+     * Places a view of the object with the provided \p hash at \p destination, replacing
+     * any file that already exists there. The object is made read-only.
+     *
+     * \return `true` if the view was created successfully
+     */
+    bool createView(std::string_view hash,
+        const std::filesystem::path& destination) const;
+
+    /**
+     * Adds all files in the \p directory and its subdirectories to the store. If
+     * \p replace is `Yes`, each file is replaced with a view of its object, which
+     * deduplicates existing synchronization folders. Otherwise the files are copied,
+     * which can be used to populate the store from removable media without any network
+     * access.
+     */
+    ImportResult importDirectory(const std::filesystem::path& directory,
+        ReplaceWithView replace);
+
+    /// Calls #verify for all objects in the store
+    VerifyResult verifyAll() const;
+
+private:
+    /// Creates a new unique path in the temporary folder of the store
+    std::filesystem::path temporaryPath() const;
+
+    std::filesystem::path _root;
+};
+
+} // namespace openspace
+
+#endif // __OPENSPACE_MODULE_SYNC___CONTENTSTORE___H__
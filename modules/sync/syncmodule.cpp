@@ -24,6 +24,7 @@
 
 #include <modules/sync/syncmodule.h>
 
+#include <modules/sync/contentstore.h>
 #include <modules/sync/syncs/httpsynchronization.h>
 #include <modules/sync/syncs/urlsynchronization.h>
 #include <openspace/documentation/documentation.h>
@@ -53,6 +54,20 @@ namespace {
 
         // The folder where all of the synchronizations are stored
         std::string synchronizationRoot;
+
+        // If this value is 'true', files are stored in a content-addressed store that is
+        // shared by all synchronizations, and the synchronization folders contain views
+        // of these files. What a view costs depends on the file system. On file systems
+        // with copy-on-write clones (Btrfs, XFS, APFS), each file is stored once and the
+        // views can be changed freely. On other file systems (ext4, NTFS), each file is
+        // stored once and the views are read-only hard links. If the store is on a
+        // different drive than the SynchronizationRoot, each file is stored twice, which
+        // uses more disk space than not using the store. The store is disabled by default
+        std::optional<bool> useContentStore;
+
+        // The folder of the content-addressed store. If this value is not specified, the
+        // store is placed in a 'store' folder in the SynchronizationRoot
+        std::optional<std::string> contentStore;
     };
 #include "syncmodule_codegen.cpp"
 } // namespace
@@ -61,6 +76,8 @@ namespace openspace {
 
 SyncModule::SyncModule() : OpenSpaceModule(Name) {}
 
+SyncModule::~SyncModule() {}
+
 void SyncModule::internalInitialize(const ghoul::Dictionary& configuration) {
     const Parameters p = codegen::bake<Parameters>(configuration);
 
@@ -70,6 +87,14 @@ void SyncModule::internalInitialize(const ghoul::Dictionary& configuration) {
 
     _synchronizationRoot = absPath(p.synchronizationRoot);
 
+    if (p.useContentStore.value_or(false)) {
+        const std::filesystem::path store =
+            p.contentStore.has_value() ?
+            absPath(*p.contentStore) :
+            _synchronizationRoot / "store";
+        _contentStore = std::make_unique<ContentStore>(store);
+    }
+
     ghoul::TemplateFactory<ResourceSynchronization>* fSynchronization =
         FactoryManager::ref().factory<ResourceSynchronization>();
     ghoul_assert(fSynchronization, "ResourceSynchronization factory was not created");
@@ -82,14 +107,16 @@ void SyncModule::internalInitialize(const ghoul::Dictionary& configuration) {
                 return new (ptr) HttpSynchronization(
                     dictionary,
                     _synchronizationRoot,
-                    _synchronizationRepositories
+                    _synchronizationRepositories,
+                    _contentStore.get()
                 );
             }
             else {
                 return new HttpSynchronization(
                     dictionary,
                     _synchronizationRoot,
-                    _synchronizationRepositories
+                    _synchronizationRepositories,
+                    _contentStore.get()
                 );
             }
         }
@@ -100,10 +127,18 @@ void SyncModule::internalInitialize(const ghoul::Dictionary& configuration) {
         [this](bool, const ghoul::Dictionary& dictionary, ghoul::MemoryPoolBase* pool) {
             if (pool) {
                 void* ptr = pool->allocate(sizeof(UrlSynchronization));
-                return new (ptr) UrlSynchronization(dictionary, _synchronizationRoot);
+                return new (ptr) UrlSynchronization(
+                    dictionary,
+                    _synchronizationRoot,
+                    _contentStore.get()
+                );
             }
             else {
-                return new UrlSynchronization(dictionary, _synchronizationRoot);
+                return new UrlSynchronization(
+                    dictionary,
+                    _synchronizationRoot,
+                    _contentStore.get()
+                );
             }
         }
     );
@@ -113,6 +148,10 @@ std::filesystem::path SyncModule::synchronizationRoot() const {
     return _synchronizationRoot;
 }
 
+ContentStore* SyncModule::contentStore() const {
+    return _contentStore.get();
+}
+
 std::vector<documentation::Documentation> SyncModule::documentations() const {
     return {
         HttpSynchronization::Documentation(),
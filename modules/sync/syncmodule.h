@@ -28,17 +28,27 @@
 #include <openspace/util/openspacemodule.h>
 
 #include <filesystem>
+#include <memory>
 
 namespace openspace {
 
+class ContentStore;
+
 class SyncModule : public OpenSpaceModule {
 public:
     constexpr static const char* Name = "Sync";
 
     SyncModule();
+    ~SyncModule() override;
 
     std::filesystem::path synchronizationRoot() const;
 
+    /**
+     * Returns the content-addressed store that is shared by all synchronizations or
+     * `nullptr` if it is disabled in the configuration.
+     */
+    ContentStore* contentStore() const;
+
     std::vector<documentation::Documentation> documentations() const override;
 
     scripting::LuaLibrary luaLibrary() const override;
@@ -49,6 +59,7 @@ protected:
 private:
     std::vector<std::string> _synchronizationRepositories;
     std::filesystem::path _synchronizationRoot;
+    std::unique_ptr<ContentStore> _contentStore;
 };
 
 } // namespace openspace
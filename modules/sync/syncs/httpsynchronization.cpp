@@ -24,11 +24,13 @@
 
 #include <modules/sync/syncs/httpsynchronization.h>
 
+#include <modules/sync/contentstore.h>
 #include <openspace/documentation/documentation.h>
 #include <openspace/documentation/verifier.h>
 #include <openspace/util/httprequest.h>
 #include <ghoul/ext/assimp/contrib/zip/src/zip.h>
 #include <ghoul/logging/logmanager.h>
+#include <sstream>
 #include <unordered_map>
 
 namespace {
@@ -65,10 +67,11 @@ documentation::Documentation HttpSynchronization::Documentation() {
 
 HttpSynchronization::HttpSynchronization(const ghoul::Dictionary& dict,
                                          std::filesystem::path synchronizationRoot,
-                                      std::vector<std::string> synchronizationRepositories
-)
+                                         std::vector<std::string> syncRepositories,
+                                         ContentStore* contentStore)
     : ResourceSynchronization(std::move(synchronizationRoot))
-    , _syncRepositories(std::move(synchronizationRepositories))
+    , _syncRepositories(std::move(syncRepositories))
+    , _contentStore(contentStore)
 {
     const Parameters p = codegen::bake<Parameters>(dict);
 
@@ -95,6 +98,13 @@ void HttpSynchronization::start() {
     if (isSyncing()) {
         return;
     }
+
+    // A synchronization that was rejected or cancelled before is restarted. Its
+    // previous thread has to finish before it can be replaced
+    if (_syncThread.joinable()) {
+        _syncThread.join();
+    }
+    _shouldCancel = false;
     _state = State::Syncing;
 
     if (hasSyncFile()) {
@@ -106,6 +116,10 @@ void HttpSynchronization::start() {
         "?identifier={}&file_version={}&application_version={}",
         _identifier, _version, ApplicationVersion
     );
+    if (_contentStore) {
+        // Asks the server for a manifest that contains the hashes of the files
+        query += "&content_hash=sha256";
+    }
 
     _syncThread = std::thread(
         [this](const std::string& q) {
@@ -142,11 +156,11 @@ bool HttpSynchronization::trySyncFromUrl(std::string listUrl) {
     fileListDownload.start();
     const bool success = fileListDownload.wait();
 
-    const std::vector<char>& buffer = fileListDownload.downloadedData();
     if (!success) {
-        LERRORC("HttpSynchronization", std::string(buffer.begin(), buffer.end()));
+        // The DownloadEngine has already logged the reason for the failure
         return false;
     }
+    const std::vector<char>& buffer = fileListDownload.downloadedData();
 
     _nSynchronizedBytes = 0;
     _nTotalBytes = 0;
@@ -164,38 +178,79 @@ bool HttpSynchronization::trySyncFromUrl(std::string listUrl) {
 
     std::atomic_bool startedAllDownloads = false;
 
+    // The expected hashes of the downloaded files if the manifest provides them
+    std::unordered_map<std::string, std::string> hashes;
+
+    // The files that are completed, either by being taken from the content store or by
+    // being downloaded
+    std::vector<std::filesystem::path> files;
+    int64_t nStoredBytes = 0;
+
     // Yes, it should be possible to store this in a std::vector<HttpFileDownload> but
     // C++ really doesn't like that even though all of the move constructors, move
     // assignments and everything is automatically constructed
     std::vector<std::unique_ptr<HttpFileDownload>> downloads;
 
     std::string line;
-    while (fileList >> line) {
-        if (line.empty() || line[0] == '#') {
+    while (std::getline(fileList, line)) {
+        // Each line is either just a URL or a manifest entry with the URL followed by
+        // the hash of the file and optionally its size
+        std::istringstream entry(line);
+        std::string url;
+        std::string hash;
+        entry >> url >> hash;
+        std::optional<int64_t> size;
+        if (int64_t s = 0; entry >> s) {
+            size = s;
+        }
+
+        if (url.empty() || url[0] == '#') {
             // Skip all empty lines and commented out lines
             continue;
         }
 
-        std::string filename = std::filesystem::path(line).filename().string();
+        if (!hash.empty() && !ContentStore::isValidHash(hash)) {
+            LWARNING(fmt::format("{}: Invalid hash '{}' for {}", _identifier, hash, url));
+            hash.clear();
+        }
+
+        std::string filename = std::filesystem::path(url).filename().string();
         std::filesystem::path destination = directory() / (filename + ".tmp");
 
-        if (sizeData.find(line) != sizeData.end()) {
-            LWARNING(fmt::format("{}: Duplicate entry for {}", _identifier, line));
+        if (sizeData.find(url) != sizeData.end()) {
+            LWARNING(fmt::format("{}: Duplicate entry for {}", _identifier, url));
             continue;
         }
 
+        if (_contentStore && !hash.empty() && _contentStore->verify(hash)) {
+            std::filesystem::path file = directory() / filename;
+            if (_contentStore->createView(hash, file)) {
+                std::error_code ec;
+                const int64_t nBytes = static_cast<int64_t>(
+                    std::filesystem::file_size(file, ec)
+                );
+                sizeData[url] = { nBytes, nBytes };
+                nStoredBytes += nBytes;
+                files.push_back(std::move(file));
+                continue;
+            }
+        }
+        if (!hash.empty()) {
+            hashes[url] = hash;
+        }
+
         auto download = std::make_unique<HttpFileDownload>(
-            line,
+            url,
             destination,
             HttpFileDownload::Overwrite::Yes
         );
         HttpFileDownload* dl = download.get();
         downloads.push_back(std::move(download));
 
-        sizeData[line] = SizeData();
+        sizeData[url] = { 0, size };
 
         dl->onProgress(
-            [this, line, &sizeData, &mutex, &startedAllDownloads](int64_t downloadedBytes,
+            [this, url, &sizeData, &mutex, &startedAllDownloads](int64_t downloadedBytes,
                                                         std::optional<int64_t> totalBytes)
         {
             if (!totalBytes.has_value() || !startedAllDownloads) {
@@ -204,7 +259,7 @@ bool HttpSynchronization::trySyncFromUrl(std::string listUrl) {
 
             std::lock_guard guard(mutex);
 
-            sizeData[line] = { downloadedBytes, totalBytes };
+            sizeData[url] = { downloadedBytes, totalBytes };
 
             _nTotalBytesKnown = true;
             _nTotalBytes = 0;
@@ -222,6 +277,18 @@ bool HttpSynchronization::trySyncFromUrl(std::string listUrl) {
     }
     startedAllDownloads = true;
 
+    if (downloads.empty()) {
+        _nTotalBytesKnown = true;
+        _nTotalBytes = nStoredBytes;
+        _nSynchronizedBytes = nStoredBytes;
+    }
+    if (!files.empty()) {
+        LDEBUG(fmt::format(
+            "{}: Took {} files ({} bytes) from the content store",
+            _identifier, files.size(), nStoredBytes
+        ));
+    }
+
     bool failed = false;
     for (const std::unique_ptr<HttpFileDownload>& d : downloads) {
         d->wait();
@@ -239,16 +306,34 @@ bool HttpSynchronization::trySyncFromUrl(std::string listUrl) {
         // Remove the .tmp extension
         originalName.replace_extension("");
 
-        if (std::filesystem::is_regular_file(originalName)) {
-            std::filesystem::remove(originalName);
+        if (_contentStore) {
+            // Moves the file into the store and places a view at the original name
+            auto it = hashes.find(d->url());
+            std::string_view hash;
+            if (it != hashes.end()) {
+                hash = it->second;
+            }
+            if (!_contentStore->insert(tempName, originalName, hash)) {
+                failed = true;
+                continue;
+            }
         }
-        std::error_code ec;
-        std::filesystem::rename(tempName, originalName, ec);
-        if (ec) {
-            LERROR(fmt::format("Error renaming {} to {}", tempName, originalName));
-            failed = true;
+        else {
+            if (std::filesystem::is_regular_file(originalName)) {
+                std::filesystem::remove(originalName);
+            }
+            std::error_code ec;
+            std::filesystem::rename(tempName, originalName, ec);
+            if (ec) {
+                LERROR(fmt::format("Error renaming {} to {}", tempName, originalName));
+                failed = true;
+                continue;
+            }
         }
+        files.push_back(originalName);
+    }
 
+    for (std::filesystem::path& originalName : files) {
         if (_unzipFiles && originalName.extension() == ".zip") {
             std::string source = originalName.string();
             std::string dest =
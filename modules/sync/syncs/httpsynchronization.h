@@ -33,6 +33,8 @@
 
 namespace openspace {
 
+class ContentStore;
+
 /**
  * A concreate ResourceSynchronization that will request a list of files from a central
  * server (the server list is provided in the constructor) by asking for a specific
@@ -45,6 +47,17 @@ namespace openspace {
  * application version). The identifier is denoting the group of files that is requested,
  * the file version is the specific version of this set of files, and the application
  * version is reserved for changes in the data transfer format.
+ *
+ * If a ContentStore is provided, the server is asked for a manifest in which each URL
+ * can be followed by the lowercase hexadecimal SHA-256 hash of the file and, optionally,
+ * its size in bytes, separated by whitespace:
+ *
+ *     https://data.openspaceproject.com/files/earth.tif 3a6eb07...adc8b7 4194304
+ *
+ * Files whose hash is already in the store are not downloaded, but are placed into the
+ * #directory as views of the stored objects. Downloaded files are verified against their
+ * hash and added to the store. Lines without a hash are downloaded as before and are
+ * deduplicated after they have been downloaded.
  */
 class HttpSynchronization : public ResourceSynchronization {
 public:
@@ -62,10 +75,13 @@ public:
      *        path is constructed
      * \param synchronizationRepositories The list of repositories that will be asked to
      *        resolve the identifier request
+     * \param contentStore The store that deduplicates the downloaded files. If this is
+     *        `nullptr`, the files are stored directly in the #directory
      */
     HttpSynchronization(const ghoul::Dictionary& dict,
         std::filesystem::path synchronizationRoot,
-        std::vector<std::string> synchronizationRepositories);
+        std::vector<std::string> synchronizationRepositories,
+        ContentStore* contentStore = nullptr);
 
     /// Destructor that will close the asynchronous file transfer, if it is still ongoing
     ~HttpSynchronization() override;
@@ -108,6 +124,9 @@ private:
     // The list of all repositories that we'll try to sync from
     const std::vector<std::string> _syncRepositories;
 
+    /// The store in which downloaded files are deduplicated. Might be `nullptr`
+    ContentStore* _contentStore = nullptr;
+
     // The thread that will be doing the synchronization
     std::thread _syncThread;
 };
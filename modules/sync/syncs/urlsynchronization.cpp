@@ -24,6 +24,7 @@
 
 #include <modules/sync/syncs/urlsynchronization.h>
 
+#include <modules/sync/contentstore.h>
 #include <openspace/documentation/documentation.h>
 #include <openspace/documentation/verifier.h>
 #include <openspace/util/httprequest.h>
@@ -73,8 +74,10 @@ documentation::Documentation UrlSynchronization::Documentation() {
 }
 
 UrlSynchronization::UrlSynchronization(const ghoul::Dictionary& dictionary,
-                                       std::filesystem::path synchronizationRoot)
+                                       std::filesystem::path synchronizationRoot,
+                                       ContentStore* contentStore)
     : ResourceSynchronization(std::move(synchronizationRoot))
+    , _contentStore(contentStore)
 {
     const Parameters p = codegen::bake<Parameters>(dictionary);
 
@@ -130,6 +133,13 @@ void UrlSynchronization::start() {
     if (isSyncing()) {
         return;
     }
+
+    // A synchronization that was rejected or cancelled before is restarted. Its
+    // previous thread has to finish before it can be replaced
+    if (_syncThread.joinable()) {
+        _syncThread.join();
+    }
+    _shouldCancel = false;
     _state = State::Syncing;
 
     if (hasSyncFile() && !_forceOverride) {
@@ -216,6 +226,14 @@ void UrlSynchronization::start() {
             // Remove the .tmp extension
             originalName.replace_extension("");
 
+            if (_contentStore && !_forceOverride) {
+                // Moves the file into the store and places a view at the original name
+                if (!_contentStore->insert(tempName, originalName)) {
+                    failed = true;
+                }
+                continue;
+            }
+
             if (std::filesystem::is_regular_file(originalName)) {
                 std::filesystem::remove(originalName);
             }
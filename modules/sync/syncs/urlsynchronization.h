@@ -35,11 +35,18 @@
 
 namespace openspace {
 
+class ContentStore;
+
 /**
  * The UrlSynchronization will download one or more files by directly being provided with
  * the list of URLs to the files that should be downloaded. The `Override` option in the
  * Dictionary determines what should happen in a file with the same name and the same
  * identifier has been previously downloaded.
+ *
+ * If a ContentStore is provided, downloaded files are moved into the store and the
+ * #directory only contains views of them, so that files that are shared with other
+ * synchronizations only use disk space once. Files that are overwritten on every startup
+ * are not added to the store.
  */
 class UrlSynchronization : public ResourceSynchronization {
 public:
@@ -52,9 +59,11 @@ public:
      *        UrlSynchronization needs to download the provided files
      * \param synchronizationRoot The base location based off which the final placement
      *        is calculated
+     * \param contentStore The store that deduplicates the downloaded files. If this is
+     *        `nullptr`, the files are stored directly in the #directory
      */
     UrlSynchronization(const ghoul::Dictionary& dictionary,
-        std::filesystem::path synchronizationRoot);
+        std::filesystem::path synchronizationRoot, ContentStore* contentStore = nullptr);
 
     /// Contructor that will terminate the synchronization thread if it is still running
     ~UrlSynchronization() override;
@@ -91,6 +100,9 @@ private:
     /// Contains a flag whether the current transfer should be cancelled
     std::atomic_bool _shouldCancel = false;
 
+    /// The store in which downloaded files are deduplicated. Might be `nullptr`
+    ContentStore* _contentStore = nullptr;
+
     // The thread that will be doing the synchronization
     std::thread _syncThread;
 };
@@ -0,0 +1,103 @@
+/*****************************************************************************************
+ *                                                                                       *
+ * OpenSpace                                                                             *
+ *                                                                                       *
+ * Copyright (c) 2014-2023                                                               *
+ *                                                                                       *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this  *
+ * software and associated documentation files (the "Software"), to deal in the Software *
+ * without restriction, including without limitation the rights to use, copy, modify,    *
+ * merge, publish, distribute, sublicense, and/or sell copies of the Software, and to    *
+ * permit persons to whom the Software is furnished to do so, subject to the following   *
+ * conditions:                                                                           *
+ *                                                                                       *
+ * The above copyright notice and this permission notice shall be included in all copies *
+ * or substantial portions of the Software.                                              *
+ *                                                                                       *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,   *
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A         *
+ * PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT    *
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF  *
+ * CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE  *
+ * OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                                         *
+ ****************************************************************************************/
+
+
+#ifndef __OPENSPACE_MODULE_VOLUME___MAPPEDRAWVOLUME___H__
+#define __OPENSPACE_MODULE_VOLUME___MAPPEDRAWVOLUME___H__
+
+#include <openspace/util/memorymappedfile.h>
+#include <ghoul/glm.h>
+#include <filesystem>
+#include <functional>
+
+namespace openspace::volume {
+
+/**
+ * A read-only raw volume whose voxels stay in the memory-mapped file instead of being
+ * read into memory. Only the parts of the file that are accessed are paged in by the
+ * operating system. The voxels in the file can either be stored linearly or in cubic
+ * bricks (see RawVolumeWriter::setBrickSize), which keeps voxels that are close to each
+ * other in space also close to each other in the file.
+ */
+template <typename Type>
+class MappedRawVolume {
+public:
+    using VoxelType = Type;
+
+    /**
+     * Called for every z slab that has been copied by #copyTo. \p slab points to the
+     * first of the \p nVoxels voxels of the slab in the destination and \p thread is the
+     * index of the thread that copied the slab.
+     */
+    using SlabCallback =
+        std::function<void(VoxelType* slab, size_t nVoxels, unsigned int thread)>;
+
+    /**
+     * Maps the raw volume file at \p path.
+     *
+     * \param path The path to the raw volume file
+     * \param dimensions The number of voxels in each dimension
+     * \param brickSize The side length of the bricks in which the voxels are stored, or
+     *        0 if they are stored linearly
+     * \throw ghoul::RuntimeError If the file could not be mapped or if it is too small
+     *        for the provided \p dimensions
+     */
+    MappedRawVolume(const std::filesystem::path& path, const glm::uvec3& dimensions,
+        unsigned int brickSize = 0);
+
+    glm::uvec3 dimensions() const;
+    unsigned int brickSize() const;
+    size_t nCells() const;
+    VoxelType get(const glm::uvec3& coordinates) const;
+
+    /**
+     * Copies all voxels into \p destination in the linear order of a RawVolume. The
+     * volume is split into slabs along the z axis that are copied concurrently by up to
+     * \p nThreads threads. If \p onSlab is provided, it is called by the copying thread
+     * right after each slab is copied, which makes it possible to process the voxels
+     * while they are still in the cache.
+     *
+     * \param destination The memory that receives #nCells voxels
+     * \param invertZ If `true`, the order of the slabs is reversed
+     * \param nThreads The maximum number of threads that copy slabs
+     * \param onSlab An optional callback that is called for every copied slab
+     * \pre \p destination must not be nullptr
+     * \pre \p nThreads must be positive
+     */
+    void copyTo(VoxelType* destination, bool invertZ, unsigned int nThreads,
+        const SlabCallback& onSlab = SlabCallback()) const;
+
+private:
+    const VoxelType* voxels() const;
+
+    glm::uvec3 _dimensions;
+    unsigned int _brickSize;
+    MemoryMappedFile _file;
+};
+
+} // namespace openspace::volume
+
+#include "mappedrawvolume.inl"
+
+#endif // __OPENSPACE_MODULE_VOLUME___MAPPEDRAWVOLUME___H__
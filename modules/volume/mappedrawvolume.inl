@@ -0,0 +1,147 @@
+/*****************************************************************************************
+ *                                                                                       *
+ * OpenSpace                                                                             *
+ *                                                                                       *
+ * Copyright (c) 2014-2023                                                               *
+ *                                                                                       *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this  *
+ * software and associated documentation files (the "Software"), to deal in the Software *
+ * without restriction, including without limitation the rights to use, copy, modify,    *
+ * merge, publish, distribute, sublicense, and/or sell copies of the Software, and to    *
+ * permit persons to whom the Software is furnished to do so, subject to the following   *
+ * conditions:                                                                           *
+ *                                                                                       *
+ * The above copyright notice and this permission notice shall be included in all copies *
+ * or substantial portions of the Software.                                              *
+ *                                                                                       *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,   *
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A         *
+ * PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT    *
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF  *
+ * CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE  *
+ * OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                                         *
+ ****************************************************************************************/
+
+
+#include <modules/volume/volumeutils.h>
+#include <ghoul/fmt.h>
+#include <ghoul/misc/assert.h>
+#include <ghoul/misc/exception.h>
+#include <algorithm>
+#include <atomic>
+#include <cstring>
+#include <thread>
+#include <vector>
+
+namespace openspace::volume {
+
+template <typename VoxelType>
+MappedRawVolume<VoxelType>::MappedRawVolume(const std::filesystem::path& path,
+                                             const glm::uvec3& dimensions,
+                                             unsigned int brickSize)
+    : _dimensions(dimensions)
+    , _brickSize(brickSize)
+    , _file(path)
+{
+    const size_t nStored = _brickSize == 0 ?
+        nCells() :
+        nBrickedCells(_dimensions, _brickSize);
+    if (_file.size() < nStored * sizeof(VoxelType)) {
+        throw ghoul::RuntimeError(fmt::format(
+            "Volume file {} is too small for a volume of size {}x{}x{}",
+            path, _dimensions.x, _dimensions.y, _dimensions.z
+        ));
+    }
+}
+
+template <typename VoxelType>
+glm::uvec3 MappedRawVolume<VoxelType>::dimensions() const {
+    return _dimensions;
+}
+
+template <typename VoxelType>
+unsigned int MappedRawVolume<VoxelType>::brickSize() const {
+    return _brickSize;
+}
+
+template <typename VoxelType>
+size_t MappedRawVolume<VoxelType>::nCells() const {
+    return static_cast<size_t>(_dimensions.x) * _dimensions.y * _dimensions.z;
+}
+
+template <typename VoxelType>
+VoxelType MappedRawVolume<VoxelType>::get(const glm::uvec3& coordinates) const {
+    const size_t index = _brickSize == 0 ?
+        coordsToIndex(coordinates, _dimensions) :
+        brickedCoordsToIndex(coordinates, _dimensions, _brickSize);
+    return voxels()[index];
+}
+
+template <typename VoxelType>
+void MappedRawVolume<VoxelType>::copyTo(VoxelType* destination, bool invertZ,
+                                        unsigned int nThreads,
+                                        const SlabCallback& onSlab) const
+{
+    ghoul_precondition(destination, "Destination must not be nullptr");
+    ghoul_precondition(nThreads > 0, "At least one thread is required");
+
+    const glm::uvec3 dims = _dimensions;
+    const size_t slabSize = static_cast<size_t>(dims.x) * dims.y;
+    const VoxelType* source = voxels();
+
+    std::atomic<unsigned int> nextSlab = 0;
+    auto copySlabs = [&](unsigned int thread) {
+        for (unsigned int z = nextSlab++; z < dims.z; z = nextSlab++) {
+            const unsigned int sourceZ = invertZ ? dims.z - z - 1 : z;
+            VoxelType* slab = destination + z * slabSize;
+
+            if (_brickSize == 0) {
+                std::memcpy(
+                    slab,
+                    source + sourceZ * slabSize,
+                    slabSize * sizeof(VoxelType)
+                );
+            }
+            else {
+                // Inside of a brick, up to brickSize voxels along the x axis are stored
+                // next to each other
+                for (unsigned int y = 0; y < dims.y; y++) {
+                    for (unsigned int x = 0; x < dims.x; x += _brickSize) {
+                        const size_t n = std::min(_brickSize, dims.x - x);
+                        const size_t index = brickedCoordsToIndex(
+                            glm::uvec3(x, y, sourceZ),
+                            dims,
+                            _brickSize
+                        );
+                        std::memcpy(
+                            slab + static_cast<size_t>(y) * dims.x + x,
+                            source + index,
+                            n * sizeof(VoxelType)
+                        );
+                    }
+                }
+            }
+
+            if (onSlab) {
+                onSlab(slab, slabSize, thread);
+            }
+        }
+    };
+
+    const unsigned int n = std::max(std::min(nThreads, dims.z), 1u);
+    std::vector<std::thread> threads;
+    for (unsigned int i = 1; i < n; i++) {
+        threads.emplace_back(copySlabs, i);
+    }
+    copySlabs(0);
+    for (std::thread& thread : threads) {
+        thread.join();
+    }
+}
+
+template <typename VoxelType>
+const VoxelType* MappedRawVolume<VoxelType>::voxels() const {
+    return reinterpret_cast<const VoxelType*>(_file.data());
+}
+
+} // namespace openspace::volume
@@ -35,6 +35,10 @@ namespace {
         // Specifies the number of grid cells in each dimension
         glm::ivec3 dimensions;
 
+        // If this value is specified, the voxels in the raw volume file are stored in
+        // cubic bricks with this side length instead of linearly
+        std::optional<int> brickSize [[codegen::greater(0)]];
+
         // Specifies the unit used to specity the domain
         std::optional<std::string> domainUnit;
 
@@ -68,6 +72,7 @@ RawVolumeMetadata RawVolumeMetadata::createFromDictionary(
 
     RawVolumeMetadata metadata;
     metadata.dimensions = p.dimensions;
+    metadata.brickSize = static_cast<unsigned int>(p.brickSize.value_or(0));
 
     metadata.hasDomainBounds =
         p.lowerDomainBound.has_value() &&
@@ -104,6 +109,9 @@ ghoul::Dictionary RawVolumeMetadata::dictionary() {
     ghoul::Dictionary dict;
     dict.setValue("Dimensions", glm::dvec3(dimensions));
     dict.setValue("GridType", gridTypeToString(gridType));
+    if (brickSize > 0) {
+        dict.setValue("BrickSize", static_cast<int>(brickSize));
+    }
 
     if (hasDomainUnit) {
         dict.setValue("DomainUnit", domainUnit);
@@ -41,6 +41,9 @@ struct RawVolumeMetadata {
 
     glm::uvec3 dimensions = glm::uvec3(0);
     VolumeGridType gridType;
+    /// The side length of the bricks in which the voxels are stored, or 0 if the voxels
+    /// are stored linearly
+    unsigned int brickSize = 0;
 
     bool hasTime = false;
     double time = 0.0;
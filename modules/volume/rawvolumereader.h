@@ -31,6 +31,7 @@
 
 namespace openspace::volume {
 
+template <typename T> class MappedRawVolume;
 template <typename T> class RawVolume;
 
 template <typename Type>
@@ -44,15 +45,29 @@ public:
     std::filesystem::path path() const;
     void setPath(std::filesystem::path path);
     void setDimensions(const glm::uvec3& dimensions);
-    //VoxelType get(const glm::ivec3& coordinates) const; // TODO: Implement this
-    //VoxelType get(const size_t index) const; // TODO: Implement this
+
+    /**
+     * Sets the side length of the cubic bricks in which the voxels are stored in the
+     * file, or 0 if they are stored linearly, which is the default.
+     */
+    void setBrickSize(unsigned int brickSize);
     std::unique_ptr<RawVolume<VoxelType>> read(bool invertZ = false);
 
+    /**
+     * Maps the volume file into memory instead of reading it. The voxels are only paged
+     * in from the file when they are accessed.
+     *
+     * 	hrow ghoul::FileNotFoundError If the volume file does not exist
+     * 	hrow ghoul::RuntimeError If the volume file could not be mapped
+     */
+    std::unique_ptr<MappedRawVolume<VoxelType>> map() const;
+
 private:
     size_t coordsToIndex(const glm::uvec3& cartesian) const;
     glm::uvec3 indexToCoords(size_t linear) const;
     glm::uvec3 _dimensions;
     std::filesystem::path _path;
+    unsigned int _brickSize = 0;
 };
 
 } // namespace openspace::volume
@@ -22,8 +22,9 @@
  * OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                                         *
  ****************************************************************************************/
 
+#include <modules/volume/mappedrawvolume.h>
+#include <modules/volume/rawvolume.h>
 #include <ghoul/misc/exception.h>
-#include <fstream>
 
 namespace openspace::volume {
 
@@ -54,19 +55,11 @@ void RawVolumeReader<VoxelType>::setPath(std::filesystem::path path) {
     _path = std::move(path);
 }
 
-/*
-TODO: Implement these methods for random access in raw volume file
 template <typename VoxelType>
-VoxelType RawVolumeReader<VoxelType>::get(const glm::ivec3& coordinates) const {
-    return get(coordsToIndex(coordinates, dimensions()));
+void RawVolumeReader<VoxelType>::setBrickSize(unsigned int brickSize) {
+    _brickSize = brickSize;
 }
 
-template <typename VoxelType>
-VoxelType RawVolumeReader<VoxelType>::get(size_t index) const {
-    // TODO: read from specific position.
-    return VoxelType();
-}*/
-
 template <typename VoxelType>
 size_t RawVolumeReader<VoxelType>::coordsToIndex(const glm::uvec3& cartesian) const {
     return coordsToIndex(cartesian, dimensions());
@@ -79,47 +72,18 @@ glm::uvec3 RawVolumeReader<VoxelType>::indexToCoords(size_t linear) const {
 
 template <typename VoxelType>
 std::unique_ptr<RawVolume<VoxelType>> RawVolumeReader<VoxelType>::read(bool invertZ) {
-    glm::uvec3 dims = dimensions();
-    auto volume = std::make_unique<RawVolume<VoxelType>>(dims);
-
-    std::ifstream file(_path, std::ios::binary);
-    char* buffer = reinterpret_cast<char*>(volume->data());
+    std::unique_ptr<MappedRawVolume<VoxelType>> mapped = map();
+    auto volume = std::make_unique<RawVolume<VoxelType>>(dimensions());
+    mapped->copyTo(volume->data(), invertZ, 1);
+    return volume;
+}
 
-    if (file.fail()) {
+template <typename VoxelType>
+std::unique_ptr<MappedRawVolume<VoxelType>> RawVolumeReader<VoxelType>::map() const {
+    if (!std::filesystem::is_regular_file(_path)) {
         throw ghoul::FileNotFoundError("Volume file not found");
     }
-
-    size_t length = static_cast<size_t>(dims.x) *
-                    static_cast<size_t>(dims.y) *
-                    static_cast<size_t>(dims.z) *
-                    sizeof(VoxelType);
-
-    file.read(buffer, length);
-
-    if (file.fail()) {
-        throw ghoul::RuntimeError("Error reading volume file");
-    }
-
-    if (invertZ) {
-        std::unique_ptr<RawVolume<VoxelType>> newVolume =
-            std::make_unique<RawVolume<VoxelType>>(dims);
-
-        for (size_t i = 0; i < volume->nCells(); ++i) {
-            const glm::uvec3& coords = volume->indexToCoords(i);
-            glm::uvec3 newcoords = glm::uvec3(coords.x, coords.y, dims.z - coords.z - 1);
-
-            // @TODO (emmbr, 2022-02-10) Not sure why they are here, but commented them
-            // out for now as they aren't used
-            //size_t newIndex = volume->coordsToIndex(newcoords);
-            //size_t oldIndex = volume->coordsToIndex(coords);
-
-            newVolume->set(newcoords, volume->get(coords));
-        }
-        return newVolume;
-    }
-    else {
-        return volume;
-    }
+    return std::make_unique<MappedRawVolume<VoxelType>>(_path, _dimensions, _brickSize);
 }
 
 } // namespace openspace::volume
@@ -41,6 +41,13 @@ public:
     void setPath(std::filesystem::path path);
     glm::uvec3 dimensions() const;
     void setDimensions(glm::uvec3 dimensions);
+
+    /**
+     * Sets the side length of the cubic bricks in which #write(const RawVolume&) stores
+     * the voxels. A value of 0 stores the voxels linearly, which is the default. The
+     * brick size has to be stored in the volume's metadata so that it can be read again.
+     */
+    void setBrickSize(unsigned int brickSize);
     void write(const std::function<VoxelType(const glm::uvec3&)>& fn,
                const std::function<void(float)>& onProgress = [](float) {});
     void write(const RawVolume<VoxelType>& volume);
@@ -52,6 +59,7 @@ private:
     glm::ivec3 _dimensions = glm::ivec3(0);
     std::filesystem::path _path;
     size_t _bufferSize = 0;
+    unsigned int _brickSize = 0;
 };
 
 } // namespace openspace::volume
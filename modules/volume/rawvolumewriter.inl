@@ -27,6 +27,7 @@
 #include <ghoul/misc/exception.h>
 #include <ghoul/fmt.h>
 #include <fstream>
+#include <vector>
 
 namespace openspace::volume {
 
@@ -51,6 +52,11 @@ void RawVolumeWriter<VoxelType>::setDimensions(glm::uvec3 dimensions) {
     _dimensions = std::move(dimensions);
 }
 
+template <typename VoxelType>
+void RawVolumeWriter<VoxelType>::setBrickSize(unsigned int brickSize) {
+    _brickSize = brickSize;
+}
+
 template <typename VoxelType>
 glm::uvec3 RawVolumeWriter<VoxelType>::dimensions() const {
     return _dimensions;
@@ -94,16 +100,29 @@ template <typename VoxelType>
 void RawVolumeWriter<VoxelType>::write(const RawVolume<VoxelType>& volume) {
     setDimensions(volume.dimensions());
 
-    const char* const buffer = reinterpret_cast<const char*>(volume.data());
-    size_t length = volume.nCells() * sizeof(VoxelType);
-
     std::ofstream file(_path, std::ios::binary);
 
     if (!file.good()) {
         throw ghoul::RuntimeError(fmt::format("Could not create file {}", _path));
     }
 
-    file.write(buffer, length);
+    if (_brickSize == 0) {
+        const char* const buffer = reinterpret_cast<const char*>(volume.data());
+        size_t length = volume.nCells() * sizeof(VoxelType);
+        file.write(buffer, length);
+    }
+    else {
+        const glm::uvec3 dims = volume.dimensions();
+        std::vector<VoxelType> bricked(nBrickedCells(dims, _brickSize), VoxelType());
+        for (size_t i = 0; i < volume.nCells(); i++) {
+            const glm::uvec3 coords = volume.indexToCoords(i);
+            bricked[brickedCoordsToIndex(coords, dims, _brickSize)] = volume.get(i);
+        }
+        file.write(
+            reinterpret_cast<const char*>(bricked.data()),
+            bricked.size() * sizeof(VoxelType)
+        );
+    }
     file.close();
 }
 
@@ -27,15 +27,18 @@
 #include <modules/volume/rendering/basicvolumeraycaster.h>
 #include <modules/volume/rendering/volumeclipplanes.h>
 #include <modules/volume/transferfunctionhandler.h>
-#include <modules/volume/rawvolume.h>
+#include <modules/volume/mappedrawvolume.h>
 #include <modules/volume/rawvolumereader.h>
 #include <modules/volume/volumegridtype.h>
 #include <openspace/documentation/documentation.h>
 #include <openspace/documentation/verifier.h>
 #include <openspace/engine/globals.h>
+#include <openspace/engine/windowdelegate.h>
 #include <openspace/rendering/raycastermanager.h>
 #include <openspace/rendering/renderengine.h>
+#include <openspace/util/cachefiles.h>
 #include <openspace/util/histogram.h>
+#include <openspace/util/threadpool.h>
 #include <openspace/rendering/transferfunction.h>
 #include <openspace/util/time.h>
 #include <openspace/util/timemanager.h>
@@ -44,14 +47,22 @@
 #include <ghoul/filesystem/filesystem.h>
 #include <ghoul/logging/logmanager.h>
 #include <ghoul/opengl/texture.h>
+#include <algorithm>
+#include <chrono>
 #include <filesystem>
+#include <fstream>
+#include <limits>
 #include <optional>
+#include <thread>
 
 namespace {
     constexpr std::string_view _loggerCat = "RenderableTimeVaryingVolume";
 
     const float SecondsInOneDay = 60 * 60 * 24;
 
+    constexpr int8_t StatisticsCacheVersion = 1;
+    constexpr int NumberOfHistogramBins = 100;
+
     constexpr openspace::properties::Property::PropertyInfo StepSizeInfo = {
         "StepSize",
         "Step Size",
@@ -136,6 +147,145 @@ namespace {
         openspace::properties::Property::Visibility::AdvancedUser
     };
 
+    constexpr openspace::properties::Property::PropertyInfo MemoryBudgetInfo = {
+        "MemoryBudget",
+        "Memory Budget (MB)",
+        "The maximum amount of memory in megabytes that is used by the loaded time "
+        "steps. Time steps are loaded when they are shown and the least recently shown "
+        "time steps are unloaded when the budget is exceeded. The time step that is "
+        "currently shown is never unloaded",
+        openspace::properties::Property::Visibility::AdvancedUser
+    };
+
+    constexpr openspace::properties::Property::PropertyInfo StreamingInfo = {
+        "Streaming",
+        "Streaming",
+        "If this value is enabled, only a window of time steps around the current time "
+        "is kept loaded and the time steps that will be shown next are loaded in the "
+        "background, in the direction and at the rate at which the time is changing",
+        openspace::properties::Property::Visibility::AdvancedUser
+    };
+
+    constexpr openspace::properties::Property::PropertyInfo WindowSizeInfo = {
+        "WindowSize",
+        "Window Size",
+        "When streaming, time steps that are further than this number of time steps away "
+        "from the current time step are unloaded, unless they are being prefetched",
+        openspace::properties::Property::Visibility::AdvancedUser
+    };
+
+    constexpr openspace::properties::Property::PropertyInfo PrefetchDepthInfo = {
+        "PrefetchDepth",
+        "Prefetch Depth",
+        "When streaming, this is the number of time steps ahead of the current time "
+        "step that are loaded in the background",
+        openspace::properties::Property::Visibility::AdvancedUser
+    };
+
+    constexpr openspace::properties::Property::PropertyInfo PrefetchHitsInfo = {
+        "PrefetchHits",
+        "Prefetch Hits",
+        "The number of time steps that were already loaded when they became current",
+        openspace::properties::Property::Visibility::Developer
+    };
+
+    constexpr openspace::properties::Property::PropertyInfo PrefetchMissesInfo = {
+        "PrefetchMisses",
+        "Prefetch Misses",
+        "The number of time steps that had to be loaded or waited for when they became "
+        "current",
+        openspace::properties::Property::Visibility::Developer
+    };
+
+    // The statistics cache file contains the size and modification time of the volume
+    // file it was computed from, the normalization range and the histogram of the
+    // normalized voxels
+    struct StatisticsHeader {
+        int8_t version;
+        uint64_t fileSize;
+        int64_t lastWriteTime;
+        float minValue;
+        float maxValue;
+        int32_t nBins;
+    };
+
+    StatisticsHeader statisticsHeader(const std::filesystem::path& volumeFile,
+                                      const openspace::volume::RawVolumeMetadata& meta)
+    {
+        StatisticsHeader header;
+        header.version = StatisticsCacheVersion;
+        header.fileSize = std::filesystem::file_size(volumeFile);
+        header.lastWriteTime = static_cast<int64_t>(
+            std::filesystem::last_write_time(volumeFile).time_since_epoch().count()
+        );
+        header.minValue = meta.minValue;
+        header.maxValue = meta.maxValue;
+        header.nBins = NumberOfHistogramBins;
+        return header;
+    }
+
+    std::unique_ptr<openspace::Histogram> loadCachedHistogram(
+                                                   const std::filesystem::path& cacheFile,
+                                                   const StatisticsHeader& expected)
+    {
+        std::ifstream file(cacheFile, std::ios::binary);
+        if (!file.good()) {
+            return nullptr;
+        }
+
+        StatisticsHeader header;
+        file.read(reinterpret_cast<char*>(&header.version), sizeof(int8_t));
+        file.read(reinterpret_cast<char*>(&header.fileSize), sizeof(uint64_t));
+        file.read(reinterpret_cast<char*>(&header.lastWriteTime), sizeof(int64_t));
+        file.read(reinterpret_cast<char*>(&header.minValue), sizeof(float));
+        file.read(reinterpret_cast<char*>(&header.maxValue), sizeof(float));
+        file.read(reinterpret_cast<char*>(&header.nBins), sizeof(int32_t));
+        const bool isValid = file.good() &&
+            header.version == expected.version &&
+            header.fileSize == expected.fileSize &&
+            header.lastWriteTime == expected.lastWriteTime &&
+            header.minValue == expected.minValue &&
+            header.maxValue == expected.maxValue &&
+            header.nBins == expected.nBins;
+        if (!isValid) {
+            return nullptr;
+        }
+
+        // The histogram takes ownership of the bins
+        float* bins = new float[header.nBins];
+        file.read(reinterpret_cast<char*>(bins), header.nBins * sizeof(float));
+        if (!file.good()) {
+            delete[] bins;
+            return nullptr;
+        }
+        return std::make_unique<openspace::Histogram>(0.f, 1.f, header.nBins, bins);
+    }
+
+    void saveCachedHistogram(const std::filesystem::path& cacheFile,
+                             const StatisticsHeader& header,
+                             const openspace::Histogram& histogram)
+    {
+        std::ofstream file(cacheFile, std::ios::binary);
+        if (!file.good()) {
+            LWARNING(fmt::format("Could not write statistics cache {}", cacheFile));
+            return;
+        }
+
+        file.write(reinterpret_cast<const char*>(&header.version), sizeof(int8_t));
+        file.write(reinterpret_cast<const char*>(&header.fileSize), sizeof(uint64_t));
+        file.write(
+            reinterpret_cast<const char*>(&header.lastWriteTime),
+            sizeof(int64_t)
+        );
+        file.write(reinterpret_cast<const char*>(&header.minValue), sizeof(float));
+        file.write(reinterpret_cast<const char*>(&header.maxValue), sizeof(float));
+        file.write(reinterpret_cast<const char*>(&header.nBins), sizeof(int32_t));
+        file.write(
+            reinterpret_cast<const char*>(histogram.data()),
+            histogram.numBins() * sizeof(float)
+        );
+    }
+
     struct [[codegen::Dictionary(RenderableTimeVaryingVolume)]] Parameters {
         // [[codegen::verbatim(SourceDirectoryInfo.description)]]
         std::string sourceDirectory;
@@ -163,6 +313,18 @@ namespace {
 
         // @TODO Missing documentation
         std::optional<ghoul::Dictionary> clipPlanes;
+
+        // [[codegen::verbatim(MemoryBudgetInfo.description)]]
+        std::optional<int> memoryBudget [[codegen::greater(0)]];
+
+        // [[codegen::verbatim(StreamingInfo.description)]]
+        std::optional<bool> streaming;
+
+        // [[codegen::verbatim(WindowSizeInfo.description)]]
+        std::optional<int> windowSize [[codegen::greaterequal(0)]];
+
+        // [[codegen::verbatim(PrefetchDepthInfo.description)]]
+        std::optional<int> prefetchDepth [[codegen::greaterequal(0)]];
     };
 #include "renderabletimevaryingvolume_codegen.cpp"
 } // namespace
@@ -187,6 +349,12 @@ RenderableTimeVaryingVolume::RenderableTimeVaryingVolume(
     , _transferFunctionPath(TransferFunctionInfo)
     , _triggerTimeJump(TriggerTimeJumpInfo)
     , _jumpToTimestep(JumpToTimestepInfo, 0, 0, 256)
+    , _memoryBudget(MemoryBudgetInfo, 2048, 1, 65536)
+    , _streaming(StreamingInfo, false)
+    , _windowSize(WindowSizeInfo, 4, 0, 256)
+    , _prefetchDepth(PrefetchDepthInfo, 4, 0, 64)
+    , _prefetchHits(PrefetchHitsInfo, 0, 0, std::numeric_limits<int>::max())
+    , _prefetchMisses(PrefetchMissesInfo, 0, 0, std::numeric_limits<int>::max())
     , _invertDataAtZ(false)
 {
     const Parameters p = codegen::bake<Parameters>(dictionary);
@@ -211,6 +379,10 @@ RenderableTimeVaryingVolume::RenderableTimeVaryingVolume(
     _brightness = p.brightness.value_or(_brightness);
     _secondsBefore = p.secondsBefore.value_or(_secondsBefore);
     _secondsAfter = p.secondsAfter;
+    _memoryBudget = p.memoryBudget.value_or(_memoryBudget);
+    _streaming = p.streaming.value_or(_streaming);
+    _windowSize = p.windowSize.value_or(_windowSize);
+    _prefetchDepth = p.prefetchDepth.value_or(_prefetchDepth);
 
     ghoul::Dictionary clipPlanesDictionary = p.clipPlanes.value_or(ghoul::Dictionary());
     _clipPlanes = std::make_shared<volume::VolumeClipPlanes>(clipPlanesDictionary);
@@ -243,44 +415,11 @@ void RenderableTimeVaryingVolume::initializeGL() {
         }
     }
 
-    // TODO: defer loading of data to later (separate thread or at least not when loading)
-    for (std::pair<const double, Timestep>& p : _volumeTimesteps) {
-        Timestep& t = p.second;
-        std::string path = fmt::format(
-            "{}/{}.rawvolume", _sourceDirectory.value(), t.baseName
-        );
-        RawVolumeReader<float> reader(path, t.metadata.dimensions);
-        t.rawVolume = reader.read(_invertDataAtZ);
-
-        float min = t.metadata.minValue;
-        float diff = t.metadata.maxValue - t.metadata.minValue;
-        float* data = t.rawVolume->data();
-        for (size_t i = 0; i < t.rawVolume->nCells(); ++i) {
-            data[i] = glm::clamp((data[i] - min) / diff, 0.f, 1.f);
-        }
-
-        t.histogram = std::make_shared<Histogram>(0.f, 1.f, 100);
-        for (size_t i = 0; i < t.rawVolume->nCells(); ++i) {
-            t.histogram->add(data[i]);
-        }
-        // TODO: handle normalization properly for different timesteps + transfer function
-
-        t.texture = std::make_shared<ghoul::opengl::Texture>(
-            t.metadata.dimensions,
-            GL_TEXTURE_3D,
-            ghoul::opengl::Texture::Format::Red,
-            GL_RED,
-            GL_FLOAT,
-            ghoul::opengl::Texture::FilterMode::Linear,
-            ghoul::opengl::Texture::WrappingMode::Clamp
-        );
-
-        t.texture->setPixelData(
-            reinterpret_cast<void*>(data),
-            ghoul::opengl::Texture::TakeOwnership::No
-        );
-        t.texture->uploadTexture();
-    }
+    // The time steps are only loaded in the update method once they are shown or, when
+    // streaming, prefetched in the background before they are shown
+    _prefetchPool = std::make_unique<ThreadPool>(
+        std::max(std::thread::hardware_concurrency() / 2, 1u)
+    );
 
     _clipPlanes->initialize();
 
@@ -317,6 +456,15 @@ void RenderableTimeVaryingVolume::initializeGL() {
 
     addProperty(_triggerTimeJump);
     addProperty(_jumpToTimestep);
+    _memoryBudget.onChange([this]() { enforceMemoryBudget(currentTimestep()); });
+    addProperty(_memoryBudget);
+    addProperty(_streaming);
+    addProperty(_windowSize);
+    addProperty(_prefetchDepth);
+    _prefetchHits.setReadOnly(true);
+    addProperty(_prefetchHits);
+    _prefetchMisses.setReadOnly(true);
+    addProperty(_prefetchMisses);
     addProperty(_rNormalization);
     addProperty(_rUpperBound);
     addProperty(_gridType);
@@ -358,6 +506,297 @@ void RenderableTimeVaryingVolume::loadTimestepMetadata(const std::string& path)
     _volumeTimesteps[t.metadata.time] = std::move(t);
 }
 
+std::filesystem::path RenderableTimeVaryingVolume::volumePath(const Timestep& t) const {
+    return fmt::format("{}/{}.rawvolume", _sourceDirectory.value(), t.baseName);
+}
+
+RenderableTimeVaryingVolume::VolumeData
+RenderableTimeVaryingVolume::readVolume(const std::filesystem::path& path,
+                                        const std::filesystem::path& cacheFile,
+                                        const RawVolumeMetadata& metadata, bool invertZ,
+                                        unsigned int nThreads)
+{
+    RawVolumeReader<float> reader(path, metadata.dimensions);
+    reader.setBrickSize(metadata.brickSize);
+    std::unique_ptr<MappedRawVolume<float>> volume = reader.map();
+    const StatisticsHeader header = statisticsHeader(path, metadata);
+
+    std::unique_ptr<Histogram> histogram = loadCachedHistogram(cacheFile, header);
+    const bool computeHistogram = (histogram == nullptr);
+
+    // Every thread accumulates into its own histogram
+    std::vector<std::unique_ptr<Histogram>> histograms;
+    if (computeHistogram) {
+        for (unsigned int i = 0; i < nThreads; i++) {
+            histograms.push_back(
+                std::make_unique<Histogram>(0.f, 1.f, NumberOfHistogramBins)
+            );
+        }
+    }
+
+    // Copy the voxels out of the mapped file and normalize them slab by slab while they
+    // are still in the cache of the thread that copied them
+    // TODO: handle normalization properly for different timesteps + transfer function
+    const float min = metadata.minValue;
+    const float diff = metadata.maxValue - metadata.minValue;
+    VolumeData data;
+    data.voxels.resize(volume->nCells());
+    volume->copyTo(
+        data.voxels.data(),
+        invertZ,
+        nThreads,
+        [&](float* slab, size_t nVoxels, unsigned int thread) {
+            for (size_t i = 0; i < nVoxels; i++) {
+                slab[i] = glm::clamp((slab[i] - min) / diff, 0.f, 1.f);
+                if (computeHistogram) {
+                    histograms[thread]->add(slab[i]);
+                }
+            }
+        }
+    );
+
+    if (computeHistogram) {
+        histogram = std::move(histograms[0]);
+        for (size_t i = 1; i < histograms.size(); i++) {
+            histogram->add(*histograms[i]);
+        }
+        saveCachedHistogram(cacheFile, header, *histogram);
+    }
+    data.histogram = std::move(histogram);
+    return data;
+}
+
+void RenderableTimeVaryingVolume::loadTimestep(Timestep& t) {
+    const std::filesystem::path path = volumePath(t);
+
+    VolumeData data;
+    try {
+        if (!t.prefetch.valid() && t.discardedPrefetch.valid()) {
+            // The time step is still being read by a prefetch that was discarded when
+            // the time step was unloaded, so we use its result instead
+            t.prefetch = std::move(t.discardedPrefetch);
+        }
+
+        const bool isPrefetched = t.prefetch.valid() &&
+            t.prefetch.wait_for(std::chrono::seconds(0)) == std::future_status::ready;
+        if (isPrefetched) {
+            data = t.prefetch.get();
+        }
+        else if (t.prefetch.valid() && !cancelPrefetch(t)) {
+            // The prefetch is already reading the volume and writing its histogram to
+            // the cache file, so reading it a second time would race with the prefetch
+            data = t.prefetch.get();
+        }
+        else {
+            // Instead of waiting for the prefetch, which is still waiting behind other
+            // prefetches and has been cancelled, the time step is loaded using all cores
+            t.prefetch = std::future<VolumeData>();
+            data = readVolume(
+                path,
+                cachedFilename(path),
+                t.metadata,
+                _invertDataAtZ,
+                std::max(std::thread::hardware_concurrency(), 1u)
+            );
+        }
+    }
+    catch (const ghoul::RuntimeError& e) {
+        LERROR(fmt::format("Could not load volume {}: {}", path, e.message));
+        t.hasFailed = true;
+        return;
+    }
+    t.inRam = false;
+    t.histogram = std::move(data.histogram);
+
+    t.texture = std::make_shared<ghoul::opengl::Texture>(
+        t.metadata.dimensions,
+        GL_TEXTURE_3D,
+        ghoul::opengl::Texture::Format::Red,
+        GL_RED,
+        GL_FLOAT,
+        ghoul::opengl::Texture::FilterMode::Linear,
+        ghoul::opengl::Texture::WrappingMode::Clamp,
+        ghoul::opengl::Texture::AllocateData::No,
+        ghoul::opengl::Texture::TakeOwnership::No
+    );
+    t.texture->setPixelData(
+        reinterpret_cast<void*>(data.voxels.data()),
+        ghoul::opengl::Texture::TakeOwnership::No
+    );
+    t.texture->uploadTexture();
+    // The voxels only have to be kept on the GPU
+    t.texture->setPixelData(nullptr, ghoul::opengl::Texture::TakeOwnership::No);
+    t.onGpu = true;
+}
+
+void RenderableTimeVaryingVolume::prefetchTimestep(Timestep& t) {
+    if (t.discardedPrefetch.valid()) {
+        // The time step is still being read by a discarded prefetch, which writes the
+        // same cache file as a new prefetch would, so we pick up its result instead
+        t.prefetch = std::move(t.discardedPrefetch);
+        return;
+    }
+
+    const std::filesystem::path path = volumePath(t);
+    const std::filesystem::path cacheFile = cachedFilename(path);
+
+    // The job only captures copies so that it can outlive this renderable
+    auto promise = std::make_shared<std::promise<VolumeData>>();
+    auto state = std::make_shared<std::atomic<PrefetchState>>(PrefetchState::Queued);
+    t.prefetch = promise->get_future();
+    t.prefetchState = state;
+    _prefetchPool->enqueue(
+        [promise, state, path, cacheFile, metadata = t.metadata,
+         invertZ = _invertDataAtZ]()
+        {
+            PrefetchState expected = PrefetchState::Queued;
+            if (!state->compare_exchange_strong(expected, PrefetchState::Running)) {
+                // The prefetch was cancelled before it started
+                return;
+            }
+            try {
+                promise->set_value(readVolume(path, cacheFile, metadata, invertZ, 1));
+            }
+            catch (...) {
+                promise->set_exception(std::current_exception());
+            }
+        }
+    );
+}
+
+bool RenderableTimeVaryingVolume::cancelPrefetch(Timestep& t) {
+    if (!t.prefetchState) {
+        return false;
+    }
+    PrefetchState expected = PrefetchState::Queued;
+    return t.prefetchState->compare_exchange_strong(expected, PrefetchState::Cancelled);
+}
+
+void RenderableTimeVaryingVolume::streamTimesteps(const Timestep& current) {
+    const int currentIndex = timestepIndex(&current);
+    const double deltaTime = global::timeManager->deltaTime();
+    const int direction = deltaTime < 0.0 ? -1 : 1;
+
+    // When the time passes through several time steps per frame, the steps in between
+    // are never shown, so we only prefetch the ones that are expected to be shown
+    int stride = 1;
+    if (_volumeTimesteps.size() > 1) {
+        const double meanInterval =
+            (_volumeTimesteps.rbegin()->first - _volumeTimesteps.begin()->first) /
+            static_cast<double>(_volumeTimesteps.size() - 1);
+        const double stepsPerFrame =
+            std::abs(deltaTime) * global::windowDelegate->averageDeltaTime() /
+            meanInterval;
+        stride = std::max(static_cast<int>(stepsPerFrame), 1);
+    }
+
+    auto isTarget = [&](int index) {
+        const int offset = (index - currentIndex) * direction;
+        return offset > 0 && offset % stride == 0 &&
+               offset / stride <= _prefetchDepth;
+    };
+    auto isInWindow = [&](int index) {
+        return std::abs(index - currentIndex) <= _windowSize || isTarget(index);
+    };
+
+    size_t usedMemory = 0;
+    int index = 0;
+    for (std::pair<const double, Timestep>& p : _volumeTimesteps) {
+        Timestep& t = p.second;
+        if (t.discardedPrefetch.valid() &&
+            t.discardedPrefetch.wait_for(std::chrono::seconds(0)) ==
+            std::future_status::ready)
+        {
+            // The discarded prefetch has finished writing the cache file
+            t.discardedPrefetch = std::future<VolumeData>();
+        }
+
+        const bool isLoaded = t.onGpu || t.prefetch.valid();
+        if (isLoaded && !isInWindow(index)) {
+            unloadTimestep(t);
+            _loadedTimesteps.remove(&t);
+        }
+        else if (isLoaded) {
+            usedMemory += timestepMemory(t);
+        }
+        index++;
+    }
+
+    const size_t budget = static_cast<size_t>(_memoryBudget) * 1024 * 1024;
+    for (int i = 1; i <= _prefetchDepth; i++) {
+        const int targetIndex = currentIndex + i * stride * direction;
+        if (targetIndex < 0 || targetIndex >= static_cast<int>(_volumeTimesteps.size())) {
+            break;
+        }
+        Timestep* t = timestepFromIndex(targetIndex);
+        if (!t || t->onGpu || t->prefetch.valid() || t->hasFailed) {
+            continue;
+        }
+        if (usedMemory + timestepMemory(*t) > budget) {
+            break;
+        }
+        prefetchTimestep(*t);
+        t->inRam = true;
+        usedMemory += timestepMemory(*t);
+    }
+}
+
+void RenderableTimeVaryingVolume::unloadTimestep(Timestep& t) {
+    // A prefetch that is still queued is cancelled. One that is already running
+    // finishes and its result is discarded, but we keep its future so that the time step
+    // is not read again while the prefetch is still writing the cache file
+    if (t.prefetch.valid() && !cancelPrefetch(t) &&
+        t.prefetch.wait_for(std::chrono::seconds(0)) != std::future_status::ready)
+    {
+        t.discardedPrefetch = std::move(t.prefetch);
+    }
+    t.prefetch = std::future<VolumeData>();
+    t.prefetchState = nullptr;
+    t.inRam = false;
+    t.texture = nullptr;
+    t.onGpu = false;
+}
+
+size_t RenderableTimeVaryingVolume::timestepMemory(const Timestep& t) {
+    const glm::uvec3 dims = t.metadata.dimensions;
+    return static_cast<size_t>(dims.x) * dims.y * dims.z * sizeof(float);
+}
+
+void RenderableTimeVaryingVolume::useTimestep(Timestep& t) {
+    auto it = std::find(_loadedTimesteps.begin(), _loadedTimesteps.end(), &t);
+    if (it != _loadedTimesteps.end()) {
+        _loadedTimesteps.splice(_loadedTimesteps.begin(), _loadedTimesteps, it);
+        return;
+    }
+
+    loadTimestep(t);
+    if (t.onGpu) {
+        _loadedTimesteps.push_front(&t);
+        enforceMemoryBudget(&t);
+    }
+}
+
+void RenderableTimeVaryingVolume::enforceMemoryBudget(const Timestep* keep) {
+    size_t usedMemory = 0;
+    for (const std::pair<const double, Timestep>& p : _volumeTimesteps) {
+        if (p.second.onGpu || p.second.prefetch.valid()) {
+            usedMemory += timestepMemory(p.second);
+        }
+    }
+
+    const size_t budget = static_cast<size_t>(_memoryBudget) * 1024 * 1024;
+    auto it = _loadedTimesteps.end();
+    while (usedMemory > budget && it != _loadedTimesteps.begin()) {
+        --it;
+        if (*it == keep) {
+            continue;
+        }
+        usedMemory -= timestepMemory(**it);
+        unloadTimestep(**it);
+        it = _loadedTimesteps.erase(it);
+    }
+}
+
 RenderableTimeVaryingVolume::Timestep* RenderableTimeVaryingVolume::currentTimestep() {
     if (_volumeTimesteps.empty()) {
         return nullptr;
@@ -432,6 +871,27 @@ void RenderableTimeVaryingVolume::update(const UpdateData&) {
 
     if (_raycaster) {
         Timestep* t = currentTimestep();
+        if (t && t != _previousTimestep && _streaming) {
+            // A time step that has become current is a hit if it was already loaded or
+            // if its prefetch has finished
+            const bool isReady = t->onGpu || (t->prefetch.valid() &&
+                t->prefetch.wait_for(std::chrono::seconds(0)) ==
+                std::future_status::ready);
+            if (isReady) {
+                _prefetchHits = _prefetchHits + 1;
+            }
+            else {
+                _prefetchMisses = _prefetchMisses + 1;
+            }
+        }
+        _previousTimestep = t;
+
+        if (t && !t->hasFailed) {
+            useTimestep(*t);
+        }
+        if (t && _streaming) {
+            streamTimesteps(*t);
+        }
 
         // Set scale and translation matrices:
         // The original data cube is a unit cube centered in 0
@@ -481,6 +941,19 @@ bool RenderableTimeVaryingVolume::isReady() const {
 }
 
 void RenderableTimeVaryingVolume::deinitializeGL() {
+    if (_prefetchPool) {
+        _prefetchPool->clearTasks();
+        _prefetchPool = nullptr;
+    }
+    // The prefetch pool has finished all running jobs, so none of the prefetches are
+    // writing cache files anymore
+    for (std::pair<const double, Timestep>& p : _volumeTimesteps) {
+        unloadTimestep(p.second);
+        p.second.discardedPrefetch = std::future<VolumeData>();
+    }
+    _loadedTimesteps.clear();
+    _previousTimestep = nullptr;
+
     if (_raycaster) {
         global::raycasterManager->detachRaycaster(*_raycaster.get());
         _raycaster = nullptr;
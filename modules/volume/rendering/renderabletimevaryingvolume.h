@@ -30,21 +30,27 @@
 #include <modules/volume/rawvolumemetadata.h>
 #include <openspace/properties/optionproperty.h>
 #include <openspace/properties/stringproperty.h>
+#include <openspace/properties/scalar/boolproperty.h>
 #include <openspace/properties/scalar/floatproperty.h>
 #include <openspace/properties/scalar/intproperty.h>
 #include <openspace/properties/triggerproperty.h>
 #include <openspace/rendering/transferfunction.h>
+#include <atomic>
+#include <filesystem>
+#include <future>
+#include <list>
+#include <vector>
 
 namespace openspace {
     class Histogram;
     struct RenderData;
+    class ThreadPool;
 } // namespace openspace
 
 namespace openspace::volume {
 
 //class TransferFunction;
 class BasicVolumeRaycaster;
-template <typename T> class RawVolume;
 class VolumeClipPlanes;
 
 class RenderableTimeVaryingVolume : public Renderable {
@@ -61,14 +67,33 @@ public:
     static documentation::Documentation Documentation();
 
 private:
+    /// The normalized voxels of a time step and their histogram
+    struct VolumeData {
+        std::vector<float> voxels;
+        std::shared_ptr<Histogram> histogram;
+    };
+
+    /// The state of a prefetch job, which is shared between the job and the renderable
+    enum class PrefetchState {
+        Queued,
+        Running,
+        Cancelled
+    };
+
     struct Timestep {
         std::string baseName;
         bool inRam;
         bool onGpu;
+        bool hasFailed = false;
         RawVolumeMetadata metadata;
-        std::shared_ptr<RawVolume<float>> rawVolume;
         std::shared_ptr<ghoul::opengl::Texture> texture;
         std::shared_ptr<Histogram> histogram;
+        /// Valid while the time step is being prefetched or waits to be uploaded
+        std::future<VolumeData> prefetch;
+        std::shared_ptr<std::atomic<PrefetchState>> prefetchState;
+        /// A prefetch that was still running when the time step was unloaded. It has to
+        /// finish before the time step is read again, as both write the same cache file
+        std::future<VolumeData> discardedPrefetch;
     };
 
     Timestep* currentTimestep();
@@ -78,6 +103,50 @@ private:
 
     void loadTimestepMetadata(const std::string& path);
 
+    /**
+     * Maps the volume file of the time step \p t, normalizes its voxels and uploads them
+     * to the GPU. The histogram of the normalized voxels is read from the cache or
+     * computed while normalizing.
+     */
+    void loadTimestep(Timestep& t);
+    void unloadTimestep(Timestep& t);
+    std::filesystem::path volumePath(const Timestep& t) const;
+    static size_t timestepMemory(const Timestep& t);
+
+    /**
+     * Reads the volume file at \p path and normalizes its voxels using \p nThreads
+     * threads. This function does not access the renderable so that it can be called
+     * from a background thread.
+     *
+     * \throw ghoul::RuntimeError If the volume file could not be read
+     */
+    static VolumeData readVolume(const std::filesystem::path& path,
+        const std::filesystem::path& cacheFile, const RawVolumeMetadata& metadata,
+        bool invertZ, unsigned int nThreads);
+
+    /// Starts reading the time step \p t on one of the prefetch threads
+    void prefetchTimestep(Timestep& t);
+
+    /**
+     * Cancels the prefetch of the time step \p t if it has not started yet. Returns
+     * `true` if the prefetch was cancelled and `false` if it is running or finished.
+     */
+    static bool cancelPrefetch(Timestep& t);
+
+    /**
+     * Unloads the time steps outside of the streaming window around \p current and
+     * prefetches the time steps that are expected to be shown after \p current.
+     */
+    void streamTimesteps(const Timestep& current);
+
+    /**
+     * Marks the time step \p t as the most recently used one and unloads the least
+     * recently used time steps, except for \p t, until the loaded time steps fit in the
+     * memory budget.
+     */
+    void useTimestep(Timestep& t);
+    void enforceMemoryBudget(const Timestep* keep);
+
     properties::OptionProperty _gridType;
     std::shared_ptr<VolumeClipPlanes> _clipPlanes;
 
@@ -92,8 +161,18 @@ private:
 
     properties::TriggerProperty _triggerTimeJump;
     properties::IntProperty _jumpToTimestep;
+    properties::IntProperty _memoryBudget;
+    properties::BoolProperty _streaming;
+    properties::IntProperty _windowSize;
+    properties::IntProperty _prefetchDepth;
+    properties::IntProperty _prefetchHits;
+    properties::IntProperty _prefetchMisses;
 
     std::map<double, Timestep> _volumeTimesteps;
+    // The loaded time steps, ordered from the most to the least recently used
+    std::list<Timestep*> _loadedTimesteps;
+    const Timestep* _previousTimestep = nullptr;
+    std::unique_ptr<ThreadPool> _prefetchPool;
     std::unique_ptr<BasicVolumeRaycaster> _raycaster;
     bool _invertDataAtZ;
 
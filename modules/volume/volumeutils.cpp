@@ -43,4 +43,22 @@ glm::uvec3 indexToCoords(size_t index, const glm::uvec3& dims) {
     return glm::uvec3(x, y, z);
 }
 
+size_t brickedCoordsToIndex(const glm::uvec3& coords, const glm::uvec3& dimensions,
+                            unsigned int brickSize)
+{
+    const glm::uvec3 nBricks = (dimensions + brickSize - 1u) / brickSize;
+    const glm::uvec3 brick = coords / brickSize;
+    const glm::uvec3 local = coords % brickSize;
+
+    const size_t b = brickSize;
+    const size_t brickIndex = coordsToIndex(brick, nBricks);
+    return brickIndex * b * b * b + local.z * b * b + local.y * b + local.x;
+}
+
+size_t nBrickedCells(const glm::uvec3& dimensions, unsigned int brickSize) {
+    const glm::uvec3 nBricks = (dimensions + brickSize - 1u) / brickSize;
+    const size_t b = brickSize;
+    return static_cast<size_t>(nBricks.x) * nBricks.y * nBricks.z * b * b * b;
+}
+
 } // namespace openspace::volume
@@ -32,6 +32,22 @@ namespace openspace::volume {
 size_t coordsToIndex(const glm::uvec3& coords, const glm::uvec3& dimensions);
 glm::uvec3 indexToCoords(size_t index, const glm::uvec3& dimensions);
 
+/**
+ * Returns the index of the voxel at \p coords in a volume with the provided
+ * \p dimensions whose voxels are stored in cubic bricks with a side length of
+ * \p brickSize voxels. Both the bricks and the voxels inside each brick are stored with
+ * x varying fastest and z slowest. Bricks at the upper boundaries of the volume are
+ * padded to the full brick size.
+ */
+size_t brickedCoordsToIndex(const glm::uvec3& coords, const glm::uvec3& dimensions,
+    unsigned int brickSize);
+
+/**
+ * Returns the number of voxels, including the padding, that are stored for a volume with
+ * the provided \p dimensions that is stored in bricks of size \p brickSize.
+ */
+size_t nBrickedCells(const glm::uvec3& dimensions, unsigned int brickSize);
+
 } // namespace openspace::volume
 
 #endif // __OPENSPACE_MODULE_VOLUME___VOLUMEUTILS___H__
@@ -58,6 +58,9 @@ struct WarningCompare {
     }
 };
 
+// The number of SkipSpecificationTests objects that exist on the current thread
+thread_local int nSkippedSpecificationTests = 0;
+
 } // namespace
 
 namespace ghoul {
@@ -263,9 +266,21 @@ TestResult testSpecification(const Documentation& documentation,
     return result;
 }
 
+SkipSpecificationTests::SkipSpecificationTests() {
+    nSkippedSpecificationTests++;
+}
+
+SkipSpecificationTests::~SkipSpecificationTests() {
+    nSkippedSpecificationTests--;
+}
+
 void testSpecificationAndThrow(const Documentation& documentation,
                                const ghoul::Dictionary& dictionary, std::string component)
 {
+    if (nSkippedSpecificationTests > 0) {
+        return;
+    }
+
     // Perform testing against the documentation/specification
     TestResult testResult = testSpecification(documentation, dictionary);
     if (!testResult.success) {
@@ -132,6 +132,13 @@ namespace {
         // from previous runs) will be silently overwritten
         std::optional<std::string> scriptLog;
 
+        // If this value is specified, a timeline of the loading of all assets is written
+        // to this file after the scene has been loaded. For each asset, the file contains
+        // the time it took to parse, synchronize, initialize, and initialize the OpenGL
+        // resources, as well as the critical path through the loading. The file can be
+        // opened with 'chrome://tracing' or https://ui.perfetto.dev
+        std::optional<std::string> startupTrace;
+
         struct Documentation {
             // The path where the documentation files will be stored
             std::optional<std::string> path;
@@ -276,6 +283,13 @@ namespace {
         // debugging support
         std::optional<bool> useMultithreadedInitialization;
 
+        // If this value is set to 'true', the scene graph nodes that were created when a
+        // profile was loaded are recorded in the cache. The next time the same profile is
+        // loaded and none of its asset files have changed, the nodes whose dictionaries
+        // are unchanged are created without testing them against their documentation
+        // again. All other nodes are tested as usual
+        std::optional<bool> useSceneSnapshot;
+
         // If this value is set to 'true', the launcher will not be shown and OpenSpace
         // will start with the provided configuration options directly. Useful in
         // multiprojector setups where a launcher window would be undesired
@@ -365,9 +379,11 @@ void parseLuaState(Configuration& configuration) {
     c.fontSize.cameraInfo = p.fontSize.cameraInfo;
     c.fontSize.versionInfo = p.fontSize.versionInfo;
     c.scriptLog = p.scriptLog.value_or(c.scriptLog);
+    c.startupTrace = p.startupTrace.value_or(c.startupTrace);
     c.versionCheckUrl = p.versionCheckUrl.value_or(c.versionCheckUrl);
     c.useMultithreadedInitialization =
         p.useMultithreadedInitialization.value_or(c.useMultithreadedInitialization);
+    c.useSceneSnapshot = p.useSceneSnapshot.value_or(c.useSceneSnapshot);
     c.isCheckingOpenGLState = p.checkOpenGLState.value_or(c.isCheckingOpenGLState);
     c.isLoggingOpenGLCalls = p.logEachOpenGLCall.value_or(c.isLoggingOpenGLCalls);
     c.isPrintingEvents = p.printEvents.value_or(c.isPrintingEvents);
@@ -58,11 +58,15 @@
 #include <openspace/scene/scenegraphnode.h>
 #include <openspace/scene/sceneinitializer.h>
 #include <openspace/scene/scenelicensewriter.h>
+#include <openspace/scene/scenesnapshot.h>
 #include <openspace/scripting/scriptscheduler.h>
 #include <openspace/scripting/scriptengine.h>
+#include <openspace/util/cachefiles.h>
+#include <openspace/util/downloadengine.h>
 #include <openspace/util/factorymanager.h>
 #include <openspace/util/memorymanager.h>
 #include <openspace/util/spicemanager.h>
+#include <openspace/util/startuptrace.h>
 #include <openspace/util/timemanager.h>
 #include <openspace/util/transformationmanager.h>
 #include <ghoul/ghoul.h>
@@ -87,6 +91,7 @@
 #include <filesystem>
 #include <future>
 #include <numeric>
+#include <optional>
 #include <sstream>
 
 #ifdef WIN32
@@ -174,6 +179,7 @@ OpenSpaceEngine::OpenSpaceEngine()
     FactoryManager::initialize();
     SpiceManager::initialize();
     TransformationManager::initialize();
+    DownloadEngine::initialize();
 
     addProperty(_printEvents);
 
@@ -706,13 +712,15 @@ void OpenSpaceEngine::loadAssets() {
         global::windowDelegate->setBarrier(true);
     };
 
+    _startupTrace = std::make_unique<StartupTrace>();
+
     std::unique_ptr<SceneInitializer> sceneInitializer;
     if (global::configuration->useMultithreadedInitialization) {
-        unsigned int nAvailableThreads = std::min(
-            std::thread::hardware_concurrency() - 1,
-            4u
-        );
-        unsigned int nThreads = nAvailableThreads == 0 ? 2 : nAvailableThreads;
+        // One core is left for the main thread, which runs the assets' Lua code and the
+        // loading screen. A large part of the node initialization is spent waiting for
+        // files to be read, so we use all of the remaining cores
+        const unsigned int nCores = std::thread::hardware_concurrency();
+        const unsigned int nThreads = std::max(nCores, 3u) - 1;
         sceneInitializer = std::make_unique<MultiThreadedSceneInitializer>(nThreads);
     }
     else {
@@ -736,6 +744,37 @@ void OpenSpaceEngine::loadAssets() {
         );
     }
 
+    // If the same profile was loaded before, the nodes whose dictionaries have not
+    // changed since then are created without testing them against their documentation.
+    // The nodes of this load are recorded to be used the next time the profile is loaded
+    std::filesystem::path snapshotFile;
+    std::optional<SceneSnapshot> previousSnapshot;
+    std::optional<SceneSnapshot> snapshot;
+    if (global::configuration->useSceneSnapshot) {
+        const std::string profile = global::profile->serialize();
+        snapshotFile = cachedFilename(
+            fmt::format(
+                "{}.scenesnapshot",
+                std::filesystem::path(global::configuration->profile).stem().string()
+            ),
+            ""
+        );
+
+        previousSnapshot = SceneSnapshot::load(snapshotFile);
+        if (previousSnapshot &&
+            previousSnapshot->isUpToDate(OPENSPACE_VERSION_STRING_FULL, profile))
+        {
+            LDEBUG(fmt::format(
+                "Using {} verified scene graph nodes from '{}'",
+                previousSnapshot->nodes().size(), snapshotFile
+            ));
+            _scene->setVerifiedSnapshot(&*previousSnapshot);
+        }
+
+        snapshot = SceneSnapshot(OPENSPACE_VERSION_STRING_FULL, profile);
+        _scene->setSnapshotRecorder(&*snapshot);
+    }
+
     for (const std::string& a : global::profile->assets) {
         _assetManager->add(a);
     }
@@ -856,7 +895,10 @@ void OpenSpaceEngine::loadAssets() {
         }
     }
     if (_shouldAbortLoading) {
+        _scene->setVerifiedSnapshot(nullptr);
+        _scene->setSnapshotRecorder(nullptr);
         _loadingScreen = nullptr;
+        _startupTrace = nullptr;
         return;
     }
 
@@ -874,6 +916,37 @@ void OpenSpaceEngine::loadAssets() {
 
     global::renderEngine->updateScene();
 
+    // Nodes that are added later, for example from the GUI, are neither tested against
+    // the previous snapshot nor recorded
+    _scene->setVerifiedSnapshot(nullptr);
+    _scene->setSnapshotRecorder(nullptr);
+    if (snapshot) {
+        std::vector<const Asset*> allAssets = _assetManager->allAssets();
+        const bool hasFailed = std::any_of(
+            allAssets.begin(),
+            allAssets.end(),
+            [](const Asset* asset) { return asset->isFailed(); }
+        );
+
+        // A snapshot of a partially loaded scene would be of no use for the next start
+        if (!hasFailed) {
+            try {
+                for (const Asset* asset : allAssets) {
+                    snapshot->addAsset(asset->path());
+                }
+                snapshot->save(snapshotFile);
+            }
+            catch (const ghoul::RuntimeError& e) {
+                LWARNING(fmt::format(
+                    "Could not write scene snapshot '{}': {}", snapshotFile, e.message
+                ));
+            }
+        }
+    }
+
+    writeStartupTrace();
+    _startupTrace = nullptr;
+
     global::syncEngine->addSyncables(global::timeManager->syncables());
     if (_scene && _scene->camera()) {
         global::syncEngine->addSyncables(_scene->camera()->syncables());
@@ -890,6 +963,35 @@ void OpenSpaceEngine::loadAssets() {
     LTRACE("OpenSpaceEngine::loadAsset(end)");
 }
 
+void OpenSpaceEngine::writeStartupTrace() {
+    ghoul_assert(_startupTrace, "No startup trace exists");
+
+    using namespace std::chrono;
+    std::vector<StartupTrace::Segment> path = _startupTrace->criticalPath();
+    LINFO(fmt::format(
+        "Loaded {} assets in {:.2f} s",
+        _assetManager->allAssets().size(),
+        duration<double>(_startupTrace->duration()).count()
+    ));
+    for (const StartupTrace::Segment& s : path) {
+        LDEBUG(fmt::format(
+            "Critical path: {} {} ({:.3f} s - {:.3f} s)",
+            StartupTrace::nameForPhase(s.phase), s.item,
+            duration<double>(s.begin).count(), duration<double>(s.end).count()
+        ));
+    }
+
+    if (!global::configuration->startupTrace.empty()) {
+        std::filesystem::path file = absPath(global::configuration->startupTrace);
+        try {
+            _startupTrace->save(file);
+        }
+        catch (const ghoul::RuntimeError& e) {
+            LERRORC(e.component, e.message);
+        }
+    }
+}
+
 void OpenSpaceEngine::deinitialize() {
     ZoneScoped;
 
@@ -913,6 +1015,10 @@ void OpenSpaceEngine::deinitialize() {
     global::sessionRecording->deinitialize();
     global::versionChecker->cancel();
 
+    // Stopping the download engine aborts all ongoing transfers, which calls back into
+    // the owners of the downloads, so this has to happen while they are still alive
+    DownloadEngine::deinitialize();
+
     _assetManager = nullptr;
 
     global::deinitialize();
@@ -1705,6 +1811,10 @@ LoadingScreen* OpenSpaceEngine::loadingScreen() {
     return _loadingScreen.get();
 }
 
+StartupTrace* OpenSpaceEngine::startupTrace() {
+    return _startupTrace.get();
+}
+
 AssetManager& OpenSpaceEngine::assetManager() {
     ghoul_assert(_assetManager, "Asset Manager must not be nullptr");
     return *_assetManager;
@@ -136,7 +136,7 @@ namespace {
         );
     }
 
-    std::filesystem::path fileName = FileSys.cacheManager()->cachedFilename(
+    std::filesystem::path fileName = openspace::cachedFilename(
         name + ".ppm",
         ""
     );
@@ -29,6 +29,7 @@
 #include <openspace/engine/openspaceengine.h>
 #include <openspace/engine/windowdelegate.h>
 #include <openspace/events/eventengine.h>
+#include <openspace/interaction/sessionrecordingwriter.h>
 #include <openspace/interaction/tasks/convertrecfileversiontask.h>
 #include <openspace/interaction/tasks/convertrecformattask.h>
 #include <openspace/navigation/keyframenavigator.h>
@@ -80,6 +81,25 @@ namespace {
         "computed values are used instead",
         openspace::properties::Property::Visibility::Hidden
     };
+
+    constexpr openspace::properties::Property::PropertyInfo FileSyncPolicyInfo = {
+        "FileSyncPolicy",
+        "File Sync Policy",
+        "Determines when the data of a recording is forced to be written to the storage "
+        "device. 'None' leaves this to the operating system, 'OnFinish' synchronizes "
+        "the file once the recording is stopped, and 'Periodic' additionally "
+        "synchronizes the recorded keyframes every few seconds while recording",
+        openspace::properties::Property::Visibility::AdvancedUser
+    };
+
+    constexpr openspace::properties::Property::PropertyInfo CompressCameraInfo = {
+        "CompressCameraKeyframes",
+        "Compress Camera Keyframes",
+        "If enabled, the camera keyframes of binary recordings are stored as quantized "
+        "deltas to the previous keyframe, which reduces the size of the recording to "
+        "less than half. Such recordings cannot be played back by earlier versions",
+        openspace::properties::Property::Visibility::AdvancedUser
+    };
 } // namespace
 
 namespace openspace::interaction {
@@ -88,17 +108,24 @@ ConversionError::ConversionError(std::string msg)
     : ghoul::RuntimeError(std::move(msg), "conversionError")
 {}
 
-SessionRecording::SessionRecording()
-    : properties::PropertyOwner({ "SessionRecording", "Session Recording" })
-    , _renderPlaybackInformation(RenderPlaybackInfo, false)
-    , _ignoreRecordedScale(IgnoreRecordedScaleInfo, false)
-{}
+SessionRecording::SessionRecording() : SessionRecording(false) {}
 
 SessionRecording::SessionRecording(bool isGlobal)
     : properties::PropertyOwner({ "SessionRecording", "Session Recording" })
     , _renderPlaybackInformation(RenderPlaybackInfo, false)
     , _ignoreRecordedScale(IgnoreRecordedScaleInfo, false)
+    , _fileSyncPolicy(FileSyncPolicyInfo)
+    , _compressCameraKeyframes(CompressCameraInfo, false)
+    , _recordWriter(std::make_unique<SessionRecordingWriter>())
 {
+    using SyncPolicy = SessionRecordingWriter::SyncPolicy;
+    _fileSyncPolicy.addOptions({
+        { static_cast<int>(SyncPolicy::None), "None" },
+        { static_cast<int>(SyncPolicy::OnFinish), "OnFinish" },
+        { static_cast<int>(SyncPolicy::Periodic), "Periodic" }
+    });
+    _fileSyncPolicy = static_cast<int>(SyncPolicy::OnFinish);
+
     if (isGlobal) {
         ghoul::TemplateFactory<Task>* fTask = FactoryManager::ref().factory<Task>();
         ghoul_assert(fTask, "No task factory existed");
@@ -106,6 +133,8 @@ SessionRecording::SessionRecording(bool isGlobal)
         fTask->registerClass<ConvertRecFileVersionTask>("ConvertRecFileVersionTask");
         addProperty(_renderPlaybackInformation);
         addProperty(_ignoreRecordedScale);
+        addProperty(_fileSyncPolicy);
+        addProperty(_compressCameraKeyframes);
     }
 }
 
@@ -115,6 +144,9 @@ SessionRecording::~SessionRecording() {
 void SessionRecording::deinitialize() {
     stopRecording();
     stopPlayback();
+    // The recording file is assembled asynchronously and has to be completed before
+    // the application shuts down
+    _recordWriter->waitForFinish();
 }
 
 void SessionRecording::setRecordDataFormat(DataMode dataMode) {
@@ -178,14 +210,15 @@ bool SessionRecording::handleRecordingFile(std::string filenameIn) {
         ));
         return false;
     }
-    if (_recordingDataMode == DataMode::Binary) {
-        _recordFile.open(absFilename, std::ios::binary);
-    }
-    else {
-        _recordFile.open(absFilename);
-    }
 
-    if (!_recordFile.is_open() || !_recordFile.good()) {
+    // The keyframes are written to disk on a separate thread while recording
+    const bool success = _recordWriter->start(
+        absFilename,
+        _recordingDataMode,
+        static_cast<SessionRecordingWriter::SyncPolicy>(_fileSyncPolicy.value()),
+        _compressCameraKeyframes && _recordingDataMode == DataMode::Binary
+    );
+    if (!success) {
         LERROR(fmt::format("Unable to open file {} for keyframe recording", absFilename));
         return false;
     }
@@ -218,16 +251,6 @@ bool SessionRecording::startRecording(const std::string& filename) {
         _keyframesSavePropertiesBaseline_timeline.clear();
         _recordingEntryNum = 1;
 
-        _recordFile << FileHeaderTitle;
-        _recordFile.write(FileHeaderVersion, FileHeaderVersionLength);
-        if (_recordingDataMode == DataMode::Binary) {
-            _recordFile << DataFormatBinaryTag;
-        }
-        else {
-            _recordFile << DataFormatAsciiTag;
-        }
-        _recordFile << '\n';
-
         _timestampRecordStarted = global::windowDelegate->applicationTime();
 
         // Record the current delta time as the first property to save in the file.
@@ -262,79 +285,45 @@ void SessionRecording::recordCurrentTimeRate() {
 
 void SessionRecording::stopRecording() {
     if (_state == SessionState::Recording) {
-        // Add all property baseline scripts to the beginning of the recording file
-        datamessagestructures::ScriptMessage smTmp;
+        // The header and all property baseline scripts are added to the beginning of
+        // the recording file, followed by the keyframes that were written while recording
+        std::string header = FileHeaderTitle;
+        header.append(
+            _recordWriter->isCompressingCameraKeyframes() ?
+                FileHeaderVersion :
+                FileHeaderVersionUncompressed,
+            FileHeaderVersionLength
+        );
+        header += (_recordingDataMode == DataMode::Binary) ?
+            DataFormatBinaryTag :
+            DataFormatAsciiTag;
+        header += '\n';
+
+        std::vector<SessionRecordingWriter::Entry> baseline;
         for (TimelineEntry& initPropScripts : _keyframesSavePropertiesBaseline_timeline) {
             if (initPropScripts.keyframeType == RecordedType::Script) {
-                smTmp._script = _keyframesSavePropertiesBaseline_scripts
+                SessionRecordingWriter::Entry entry;
+                entry.type = SessionRecordingWriter::Entry::Type::Script;
+                entry.timestamps = _timestamps3RecordStarted;
+                entry.script = _keyframesSavePropertiesBaseline_scripts
                     [initPropScripts.idxIntoKeyframeTypeArray];
-                saveSingleKeyframeScript(
-                    smTmp,
-                    _timestamps3RecordStarted,
-                    _recordingDataMode,
-                    _recordFile,
-                    _keyframeBuffer
-                );
+                baseline.push_back(std::move(entry));
             }
         }
-        for (TimelineEntry entry : _timeline) {
-            switch (entry.keyframeType) {
-                case RecordedType::Camera:
-                {
-                    interaction::KeyframeNavigator::CameraPose kf
-                        = _keyframesCamera[entry.idxIntoKeyframeTypeArray];
-                    datamessagestructures::CameraKeyframe kfMsg(
-                        std::move(kf.position),
-                        std::move(kf.rotation),
-                        std::move(kf.focusNode),
-                        std::move(kf.followFocusNodeRotation),
-                        std::move(kf.scale)
-                    );
-                    saveSingleKeyframeCamera(
-                        kfMsg,
-                        entry.t3stamps,
-                        _recordingDataMode,
-                        _recordFile,
-                        _keyframeBuffer
-                    );
-                    break;
-                }
-                case RecordedType::Time:
-                {
-                    datamessagestructures::TimeKeyframe tf
-                        = _keyframesTime[entry.idxIntoKeyframeTypeArray];
-                    saveSingleKeyframeTime(
-                        tf,
-                        entry.t3stamps,
-                        _recordingDataMode,
-                        _recordFile,
-                        _keyframeBuffer
-                    );
-                    break;
-                }
-                case RecordedType::Script:
-                {
-                    smTmp._script = _keyframesScript[entry.idxIntoKeyframeTypeArray];
-                    saveSingleKeyframeScript(
-                        smTmp,
-                        entry.t3stamps,
-                        _recordingDataMode,
-                        _recordFile,
-                        _keyframeBuffer
-                    );
-                    break;
-                }
-                default:
-                {
-                    break;
-                }
-            }
+        _recordWriter->finish(std::move(header), std::move(baseline));
+        // Callers expect the recording file to be complete once this function returns,
+        // for example when the recording is played back or converted right afterwards
+        _recordWriter->waitForFinish();
+
+        if (_recordWriter->nDroppedEntries() > 0) {
+            LWARNING(fmt::format(
+                "{} camera keyframes were dropped as the recording file could not be "
+                "written fast enough", _recordWriter->nDroppedEntries()
+            ));
         }
         _state = SessionState::Idle;
         LINFO("Session recording stopped");
     }
-    // Close the recording file
-    _recordFile.close();
     _cleanupNeededRecording = true;
 }
 
@@ -371,6 +360,7 @@ bool SessionRecording::startPlayback(std::string& filename,
 
     _playbackLineNum = 1;
     _playbackFilename = absFilename;
+    _playbackCameraDecoder.reset();
     _playbackLoopMode = loop;
     _shouldWaitForFinishLoadingWhenPlayback = shouldWaitForFinishedTiles;
 
@@ -386,7 +376,15 @@ bool SessionRecording::startPlayback(std::string& filename,
         cleanUpPlayback();
         return false;
     }
-    readHeaderElement(_playbackFile, FileHeaderVersionLength);
+    std::string version = readHeaderElement(_playbackFile, FileHeaderVersionLength);
+    if (version > fileFormatVersion()) {
+        LERROR(fmt::format(
+            "Playback file version {} is newer than the supported version {}",
+            version, fileFormatVersion()
+        ));
+        cleanUpPlayback();
+        return false;
+    }
     std::string readDataMode = readHeaderElement(_playbackFile, 1);
     if (readDataMode[0] == DataFormatAsciiTag) {
         _recordingDataMode = DataMode::Ascii;
@@ -712,7 +710,7 @@ void SessionRecording::writeToFileBuffer(unsigned char* buf,
 void SessionRecording::saveStringToFile(const std::string& s,
                                         unsigned char* kfBuffer,
                                         size_t& idx,
-                                        std::ofstream& file)
+                                        std::ostream& file)
 {
     size_t strLen = s.size();
     size_t writeSize_bytes = sizeof(size_t);
@@ -765,9 +763,12 @@ void SessionRecording::saveCameraKeyframeToTimeline() {
     datamessagestructures::CameraKeyframe kf =
         datamessagestructures::generateCameraKeyframe();
 
-    Timestamps times = generateCurrentTimestamp3(kf._timestamp);
-    interaction::KeyframeNavigator::CameraPose pbFrame(std::move(kf));
-    addKeyframe(times, pbFrame, _recordingEntryNum++);
+    SessionRecordingWriter::Entry entry;
+    entry.type = SessionRecordingWriter::Entry::Type::Camera;
+    entry.timestamps = generateCurrentTimestamp3(kf._timestamp);
+    entry.camera = interaction::KeyframeNavigator::CameraPose(std::move(kf));
+    _recordWriter->push(std::move(entry));
+    _recordingEntryNum++;
 }
 
 void SessionRecording::saveHeaderBinary(Timestamps& times,
@@ -794,7 +795,7 @@ void SessionRecording::saveHeaderAscii(Timestamps& times,
 void SessionRecording::saveCameraKeyframeBinary(Timestamps& times,
                                                 datamessagestructures::CameraKeyframe& kf,
                                                 unsigned char* kfBuffer,
-                                                std::ofstream& file)
+                                                std::ostream& file)
 {
     // Writing to a binary session recording file
     size_t idx = 0;
@@ -806,9 +807,26 @@ void SessionRecording::saveCameraKeyframeBinary(Timestamps& times,
     saveKeyframeToFileBinary(kfBuffer, idx, file);
 }
 
+void SessionRecording::saveCameraKeyframeCompressed(Timestamps& times,
+                                                datamessagestructures::CameraKeyframe& kf,
+                                    datamessagestructures::CameraKeyframeEncoder& encoder,
+                                                    unsigned char* kfBuffer,
+                                                    std::ostream& file)
+{
+    size_t idx = 0;
+    saveHeaderBinary(times, HeaderCameraCompressedBinary, kfBuffer, idx);
+    std::vector<char> writeBuffer;
+    encoder.encode(kf, writeBuffer);
+    const uint32_t size = static_cast<uint32_t>(writeBuffer.size());
+    std::memcpy(kfBuffer + idx, &size, sizeof(uint32_t));
+    idx += sizeof(uint32_t);
+    saveKeyframeToFileBinary(kfBuffer, idx, file);
+    file.write(writeBuffer.data(), writeBuffer.size());
+}
+
 void SessionRecording::saveCameraKeyframeAscii(Timestamps& times,
                                                datamessagestructures::CameraKeyframe& kf,
-                                               std::ofstream& file)
+                                               std::ostream& file)
 {
     std::stringstream keyframeLine = std::stringstream();
     saveHeaderAscii(times, HeaderCameraAscii, keyframeLine);
@@ -821,14 +839,18 @@ void SessionRecording::saveTimeKeyframeToTimeline() {
     datamessagestructures::TimeKeyframe kf =
         datamessagestructures::generateTimeKeyframe();
 
-    Timestamps times = generateCurrentTimestamp3(kf._timestamp);
-    addKeyframe(times, kf, _recordingEntryNum++);
+    SessionRecordingWriter::Entry entry;
+    entry.type = SessionRecordingWriter::Entry::Type::Time;
+    entry.timestamps = generateCurrentTimestamp3(kf._timestamp);
+    entry.time = std::move(kf);
+    _recordWriter->push(std::move(entry));
+    _recordingEntryNum++;
 }
 
 void SessionRecording::saveTimeKeyframeBinary(Timestamps& times,
                                               datamessagestructures::TimeKeyframe& kf,
                                               unsigned char* kfBuffer,
-                                              std::ofstream& file)
+                                              std::ostream& file)
 {
     size_t idx = 0;
     saveHeaderBinary(times, HeaderTimeBinary, kfBuffer, idx);
@@ -840,7 +862,7 @@ void SessionRecording::saveTimeKeyframeBinary(Timestamps& times,
 
 void SessionRecording::saveTimeKeyframeAscii(Timestamps& times,
                                              datamessagestructures::TimeKeyframe& kf,
-                                             std::ofstream& file)
+                                             std::ostream& file)
 {
     std::stringstream keyframeLine = std::stringstream();
     saveHeaderAscii(times, HeaderTimeAscii, keyframeLine);
@@ -862,8 +884,11 @@ void SessionRecording::saveScriptKeyframeToTimeline(std::string script) {
     datamessagestructures::ScriptMessage sm
         = datamessagestructures::generateScriptMessage(script);
 
-    Timestamps times = generateCurrentTimestamp3(sm._timestamp);
-    addKeyframe(times, sm._script, _playbackLineNum);
+    SessionRecordingWriter::Entry entry;
+    entry.type = SessionRecordingWriter::Entry::Type::Script;
+    entry.timestamps = generateCurrentTimestamp3(sm._timestamp);
+    entry.script = std::move(sm._script);
+    _recordWriter->push(std::move(entry));
 }
 
 bool SessionRecording::doesStartWithSubstring(const std::string& s,
@@ -910,7 +935,7 @@ void SessionRecording::replaceCommandsFromScriptIfFound(std::string& script) {
 void SessionRecording::saveScriptKeyframeBinary(Timestamps& times,
                                                 datamessagestructures::ScriptMessage& sm,
                                                 unsigned char* smBuffer,
-                                                std::ofstream& file)
+                                                std::ostream& file)
 {
     size_t idx = 0;
     saveHeaderBinary(times, HeaderScriptBinary, smBuffer, idx);
@@ -923,7 +948,7 @@ void SessionRecording::saveScriptKeyframeBinary(Timestamps& times,
 
 void SessionRecording::saveScriptKeyframeAscii(Timestamps& times,
                                                datamessagestructures::ScriptMessage& sm,
-                                               std::ofstream& file)
+                                               std::ostream& file)
 {
     std::stringstream keyframeLine = std::stringstream();
     saveHeaderAscii(times, HeaderScriptAscii, keyframeLine);
@@ -1074,6 +1099,9 @@ bool SessionRecording::playbackAddEntriesToTimeline() {
             if (frameType == HeaderCameraBinary) {
                 parsingStatusOk = playbackCamera();
             }
+            else if (frameType == HeaderCameraCompressedBinary) {
+                parsingStatusOk = playbackCompressedCamera();
+            }
             else if (frameType == HeaderTimeBinary) {
                 parsingStatusOk = playbackTimeChange();
             }
@@ -1242,6 +1270,38 @@ bool SessionRecording::playbackCamera() {
     return success;
 }
 
+bool SessionRecording::playbackCompressedCamera() {
+    Timestamps times;
+    times.timeOs = readFromPlayback<double>(_playbackFile);
+    times.timeRec = readFromPlayback<double>(_playbackFile);
+    times.timeSim = readFromPlayback<double>(_playbackFile);
+    const uint32_t size = readFromPlayback<uint32_t>(_playbackFile);
+    if (!_playbackFile) {
+        LERROR(fmt::format(
+            "Error reading camera playback from keyframe entry {}", _playbackLineNum - 1
+        ));
+        return false;
+    }
+
+    std::vector<char> buffer(size);
+    _playbackFile.read(buffer.data(), size);
+    datamessagestructures::CameraKeyframe kf;
+    size_t offset = 0;
+    if (!_playbackFile || !_playbackCameraDecoder.decode(buffer, offset, kf)) {
+        LERROR(fmt::format(
+            "Error decoding compressed camera keyframe entry {}", _playbackLineNum - 1
+        ));
+        return false;
+    }
+
+    interaction::KeyframeNavigator::CameraPose pbFrame(std::move(kf));
+    return addKeyframe(
+        { times.timeOs, times.timeRec, times.timeSim },
+        pbFrame,
+        _playbackLineNum
+    );
+}
+
 bool SessionRecording::convertCamera(std::stringstream& inStream, DataMode mode,
                                      int lineNum, std::string& inputLine,
                                      std::ofstream& outFile, unsigned char* buffer)
@@ -1269,6 +1329,40 @@ bool SessionRecording::convertCamera(std::stringstream& inStream, DataMode mode,
     return success;
 }
 
+bool SessionRecording::convertCompressedCamera(std::stringstream& inStream, int lineNum,
+                                               std::ofstream& outFile,
+                                               unsigned char* buffer)
+{
+    Timestamps times;
+    times.timeOs = readFromPlayback<double>(inStream);
+    times.timeRec = readFromPlayback<double>(inStream);
+    times.timeSim = readFromPlayback<double>(inStream);
+    const uint32_t size = readFromPlayback<uint32_t>(inStream);
+    if (!inStream) {
+        LERROR(fmt::format(
+            "Error reading camera keyframe entry {} for conversion", lineNum - 1
+        ));
+        return false;
+    }
+
+    std::vector<char> data(size);
+    inStream.read(data.data(), size);
+    datamessagestructures::CameraKeyframe kf;
+    size_t offset = 0;
+    if (!inStream || !_conversionCameraDecoder.decode(data, offset, kf)) {
+        LERROR(fmt::format(
+            "Error decoding compressed camera keyframe entry {} for conversion",
+            lineNum - 1
+        ));
+        return false;
+    }
+
+    // The keyframe is written uncompressed, as the decoder state of the compressed
+    // entries cannot be carried over into a file of a different version
+    saveCameraKeyframeBinary(times, kf, buffer, outFile);
+    return true;
+}
+
 bool SessionRecording::readSingleKeyframeCamera(datamessagestructures::CameraKeyframe& kf,
                                                 Timestamps& times, DataMode mode,
                                                 std::ifstream& file, std::string& inLine,
@@ -2154,13 +2248,13 @@ SessionRecording::RecordedType SessionRecording::getPrevKeyframeType() {
 
 void SessionRecording::saveKeyframeToFileBinary(unsigned char* buffer,
                                                 size_t size,
-                                                std::ofstream& file)
+                                                std::ostream& file)
 {
     file.write(reinterpret_cast<char*>(buffer), size);
 }
 
-void SessionRecording::saveKeyframeToFile(std::string entry, std::ofstream& file) {
-    file << std::move(entry) << std::endl;
+void SessionRecording::saveKeyframeToFile(std::string entry, std::ostream& file) {
+    file << std::move(entry) << '\n';
 }
 
 SessionRecording::CallbackHandle SessionRecording::addStateChangeCallback(
@@ -2330,7 +2424,7 @@ std::string SessionRecording::convertFile(std::string filename, int depth) {
         // correct version of the file to be converted, then call getLegacy() to recurse
         // to the next level down in the legacy subclasses until we get the right
         // version, then proceed with conversion from there.
-        if (fileVersion != fileFormatVersion()) {
+        if (!isNativeFileFormatVersion(fileVersion)) {
             //conversionInStream.seekg(conversionInStream.beg);
             newFilename = getLegacyConversionResult(filename, depth + 1);
             removeTrailingPathSlashes(newFilename);
@@ -2407,6 +2501,7 @@ bool SessionRecording::convertEntries(std::string& inFilename,
 {
     bool conversionStatusOk = true;
     std::string lineParsing;
+    _conversionCameraDecoder.reset();
 
     if (mode == DataMode::Binary) {
         while (conversionStatusOk) {
@@ -2429,6 +2524,14 @@ bool SessionRecording::convertEntries(std::string& inFilename,
                     _keyframeBuffer
                 );
             }
+            else if (frameType == HeaderCameraCompressedBinary) {
+                conversionStatusOk = convertCompressedCamera(
+                    inStream,
+                    lineNum,
+                    outFile,
+                    _keyframeBuffer
+                );
+            }
             else if (frameType == HeaderTimeBinary) {
                 conversionStatusOk = convertTimeChange(
                     inStream,
@@ -2561,6 +2664,10 @@ std::string SessionRecording::targetFileFormatVersion() {
     return std::string(FileHeaderVersion);
 }
 
+bool SessionRecording::isNativeFileFormatVersion(const std::string& version) {
+    return version == FileHeaderVersion || version == FileHeaderVersionUncompressed;
+}
+
 std::string SessionRecording::determineConversionOutFilename(const std::string filename,
                                                              DataMode mode)
 {
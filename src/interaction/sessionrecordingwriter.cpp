@@ -0,0 +1,427 @@
+/*****************************************************************************************
+ *                                                                                       *
+ * OpenSpace                                                                             *
+ *                                                                                       *
+ * Copyright (c) 2014-2023                                                               *
+ *                                                                                       *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this  *
+ * software and associated documentation files (the "Software"), to deal in the Software *
+ * without restriction, including without limitation the rights to use, copy, modify,    *
+ * merge, publish, distribute, sublicense, and/or sell copies of the Software, and to    *
+ * permit persons to whom the Software is furnished to do so, subject to the following   *
+ * conditions:                                                                           *
+ *                                                                                       *
+ * The above copyright notice and this permission notice shall be included in all copies *
+ * or substantial portions of the Software.                                              *
+ *                                                                                       *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,   *
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A         *
+ * PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT    *
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF  *
+ * CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE  *
+ * OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                                         *
+ ****************************************************************************************/
+
+#include <openspace/interaction/sessionrecordingwriter.h>
+
+#include <ghoul/fmt.h>
+#include <ghoul/logging/logmanager.h>
+#include <ghoul/misc/profiling.h>
+#include <algorithm>
+#include <cstring>
+#include <new>
+
+#ifdef WIN32
+#include <io.h>
+#else
+#include <unistd.h>
+#endif // WIN32
+
+namespace {
+    constexpr std::string_view _loggerCat = "SessionRecordingWriter";
+
+    // The amount of serialized data that is collected before it is written to disk
+    constexpr std::streamoff ChunkSize = 1024 * 1024;
+
+    // Entries that are written later than this after they were pushed count as late
+    constexpr std::chrono::seconds LateThreshold = std::chrono::seconds(1);
+
+    // Time between two synchronizations if the SyncPolicy::Periodic is used
+    constexpr std::chrono::seconds SyncInterval = std::chrono::seconds(2);
+
+    // Maximum time the writer thread sleeps before checking for new entries
+    constexpr std::chrono::milliseconds PollInterval = std::chrono::milliseconds(10);
+
+    using DataMode = openspace::interaction::SessionRecording::DataMode;
+
+    // The text mode has to match the one used for synchronous recordings so that the
+    // line endings are identical on all platforms
+    const char* writeMode(DataMode mode) {
+        return mode == DataMode::Binary ? "wb" : "w";
+    }
+
+    const char* readMode(DataMode mode) {
+        return mode == DataMode::Binary ? "rb" : "r";
+    }
+
+    void syncToDisk(std::FILE* file) {
+        std::fflush(file);
+#ifdef WIN32
+        _commit(_fileno(file));
+#else
+        fsync(fileno(file));
+#endif // WIN32
+    }
+
+    bool writeToFile(std::FILE* file, const std::string& data) {
+        if (data.empty()) {
+            return true;
+        }
+        return std::fwrite(data.data(), 1, data.size(), file) == data.size();
+    }
+} // namespace
+
+namespace openspace::interaction {
+
+SessionRecordingWriter::SessionRecordingWriter(size_t queueCapacity)
+    : _queue(queueCapacity)
+    , _buffer(SessionRecording::_saveBufferMaxSize_bytes)
+{}
+
+SessionRecordingWriter::~SessionRecordingWriter() {
+    if (_thread.joinable() && !_finishRequested) {
+        _discard = true;
+        {
+            std::lock_guard lock(_mutex);
+            _finishRequested = true;
+        }
+        _condition.notify_one();
+    }
+    waitForFinish();
+}
+
+bool SessionRecordingWriter::start(std::filesystem::path file,
+                                   SessionRecording::DataMode mode, SyncPolicy policy,
+                                   bool compressCameraKeyframes)
+{
+    // A previous recording might still be in the process of being written
+    waitForFinish();
+
+    _file = std::move(file);
+    _spoolFile = _file;
+    _spoolFile += ".part";
+    _mode = mode;
+    _syncPolicy = policy;
+    _compressCameraKeyframes = compressCameraKeyframes;
+    _cameraKeyframeEncoder.reset();
+
+    _spool = std::fopen(_spoolFile.string().c_str(), writeMode(_mode));
+    if (!_spool) {
+        LERROR(fmt::format("Unable to open spool file {}", _spoolFile));
+        return false;
+    }
+
+    _pending.str(std::string());
+    _pending.clear();
+    _overflow.clear();
+    _header.clear();
+    _prefix.clear();
+    _nDropped = 0;
+    _nLate = 0;
+    _nWritten = 0;
+    _discard = false;
+    _finishRequested = false;
+    _lastSync = std::chrono::steady_clock::now();
+
+    _thread = std::thread([this]() { threadMain(); });
+    return true;
+}
+
+bool SessionRecordingWriter::push(Entry entry) {
+    if (!_thread.joinable() || _finishRequested) {
+        return false;
+    }
+
+    entry.queueTime = std::chrono::steady_clock::now();
+
+    // Entries that did not fit previously have to be written first to retain the order
+    while (!_overflow.empty() && _queue.tryPush(std::move(_overflow.front()))) {
+        _overflow.pop_front();
+    }
+
+    if (_overflow.empty() && _queue.tryPush(std::move(entry))) {
+        return true;
+    }
+
+    if (entry.type == Entry::Type::Camera) {
+        // Losing a camera keyframe only reduces the fidelity of the interpolation, so it
+        // is preferable to dropping scripts or stalling the rendering
+        _nDropped++;
+        return false;
+    }
+
+    _overflow.push_back(std::move(entry));
+    return true;
+}
+
+void SessionRecordingWriter::finish(std::string header, std::vector<Entry> prefix) {
+    if (!_thread.joinable() || _finishRequested) {
+        return;
+    }
+
+    // All remaining entries have to end up in the file, so we need to wait for space
+    while (!_overflow.empty()) {
+        if (_queue.tryPush(std::move(_overflow.front()))) {
+            _overflow.pop_front();
+        }
+        else {
+            std::this_thread::yield();
+        }
+    }
+
+    {
+        std::lock_guard lock(_mutex);
+        _header = std::move(header);
+        _prefix = std::move(prefix);
+        _finishRequested = true;
+    }
+    _condition.notify_one();
+}
+
+void SessionRecordingWriter::waitForFinish() {
+    if (_thread.joinable()) {
+        _thread.join();
+    }
+}
+
+uint64_t SessionRecordingWriter::nDroppedEntries() const {
+    return _nDropped;
+}
+
+uint64_t SessionRecordingWriter::nLateEntries() const {
+    return _nLate;
+}
+
+uint64_t SessionRecordingWriter::nWrittenEntries() const {
+    return _nWritten;
+}
+
+bool SessionRecordingWriter::isCompressingCameraKeyframes() const {
+    return _compressCameraKeyframes;
+}
+
+void SessionRecordingWriter::threadMain() {
+    while (true) {
+        drainQueue();
+
+        if (_finishRequested) {
+            // Entries might have been pushed in between draining and the finish request
+            drainQueue();
+            break;
+        }
+
+        if (_syncPolicy == SyncPolicy::Periodic &&
+            std::chrono::steady_clock::now() - _lastSync > SyncInterval)
+        {
+            flushPending(true);
+        }
+
+        std::unique_lock lock(_mutex);
+        _condition.wait_for(
+            lock,
+            PollInterval,
+            [this]() { return _finishRequested.load(); }
+        );
+    }
+
+    flushPending(false);
+    std::fclose(_spool);
+    _spool = nullptr;
+
+    if (_discard) {
+        std::filesystem::remove(_spoolFile);
+        return;
+    }
+
+    if (assembleFinalFile()) {
+        std::filesystem::remove(_spoolFile);
+        LINFO(fmt::format(
+            "Finished writing {} keyframes to {}", _nWritten.load(), _file
+        ));
+    }
+    if (_nLate > 0) {
+        LWARNING(fmt::format(
+            "{} keyframes were written more than {} seconds after they were recorded",
+            _nLate.load(), LateThreshold.count()
+        ));
+    }
+}
+
+void SessionRecordingWriter::drainQueue() {
+    ZoneScoped;
+
+    Entry entry;
+    while (_queue.tryPop(entry)) {
+        if (std::chrono::steady_clock::now() - entry.queueTime > LateThreshold) {
+            _nLate++;
+        }
+
+        serializeEntry(entry, _pending);
+        _nWritten++;
+
+        if (_pending.tellp() >= ChunkSize) {
+            flushPending(false);
+        }
+    }
+}
+
+void SessionRecordingWriter::serializeEntry(Entry& entry, std::ostream& out) {
+    const bool isBinary = (_mode == DataMode::Binary);
+
+    switch (entry.type) {
+        case Entry::Type::Camera:
+        {
+            KeyframeNavigator::CameraPose& pose = entry.camera;
+            datamessagestructures::CameraKeyframe kf(
+                std::move(pose.position),
+                std::move(pose.rotation),
+                std::move(pose.focusNode),
+                std::move(pose.followFocusNodeRotation),
+                std::move(pose.scale)
+            );
+            const size_t size =
+                SessionRecording::_saveBufferMaxSize_bytes + kf._focusNode.size();
+            _buffer.resize(std::max(_buffer.size(), size));
+            if (isBinary && _compressCameraKeyframes) {
+                SessionRecording::saveCameraKeyframeCompressed(
+                    entry.timestamps,
+                    kf,
+                    _cameraKeyframeEncoder,
+                    _buffer.data(),
+                    out
+                );
+            }
+            else if (isBinary) {
+                SessionRecording::saveCameraKeyframeBinary(
+                    entry.timestamps,
+                    kf,
+                    _buffer.data(),
+                    out
+                );
+            }
+            else {
+                SessionRecording::saveCameraKeyframeAscii(entry.timestamps, kf, out);
+            }
+            break;
+        }
+        case Entry::Type::Time:
+        {
+            if (isBinary) {
+                // The time keyframe is written as raw memory, so the padding bytes are
+                // zeroed to make the recording independent of the copies on the way
+                datamessagestructures::TimeKeyframe kf;
+                std::memset(&kf, 0, sizeof(datamessagestructures::TimeKeyframe));
+                new (&kf) datamessagestructures::TimeKeyframe;
+                kf._time = entry.time._time;
+                kf._dt = entry.time._dt;
+                kf._paused = entry.time._paused;
+                kf._requiresTimeJump = entry.time._requiresTimeJump;
+                kf._timestamp = entry.time._timestamp;
+                SessionRecording::saveTimeKeyframeBinary(
+                    entry.timestamps,
+                    kf,
+                    _buffer.data(),
+                    out
+                );
+            }
+            else {
+                SessionRecording::saveTimeKeyframeAscii(
+                    entry.timestamps,
+                    entry.time,
+                    out
+                );
+            }
+            break;
+        }
+        case Entry::Type::Script:
+        {
+            datamessagestructures::ScriptMessage sm;
+            sm._script = std::move(entry.script);
+            if (isBinary) {
+                const size_t size =
+                    SessionRecording::_saveBufferMaxSize_bytes + sm._script.size();
+                _buffer.resize(std::max(_buffer.size(), size));
+                SessionRecording::saveScriptKeyframeBinary(
+                    entry.timestamps,
+                    sm,
+                    _buffer.data(),
+                    out
+                );
+            }
+            else {
+                SessionRecording::saveScriptKeyframeAscii(entry.timestamps, sm, out);
+            }
+            break;
+        }
+    }
+}
+
+void SessionRecordingWriter::flushPending(bool forceSync) {
+    if (!writeToFile(_spool, _pending.str())) {
+        LERROR(fmt::format("Error writing to spool file {}", _spoolFile));
+    }
+    _pending.str(std::string());
+    _pending.clear();
+
+    if (forceSync) {
+        syncToDisk(_spool);
+        _lastSync = std::chrono::steady_clock::now();
+    }
+}
+
+bool SessionRecordingWriter::assembleFinalFile() {
+    ZoneScoped;
+
+    std::FILE* file = std::fopen(_file.string().c_str(), writeMode(_mode));
+    if (!file) {
+        LERROR(fmt::format("Unable to open file {} for keyframe recording", _file));
+        return false;
+    }
+
+    std::ostringstream prefix;
+    for (Entry& entry : _prefix) {
+        serializeEntry(entry, prefix);
+    }
+    bool success = writeToFile(file, _header) && writeToFile(file, prefix.str());
+
+    // Append the spooled keyframes. The file is read in the same mode that it was
+    // written in, which makes the line ending conversion symmetric
+    std::FILE* spool = std::fopen(_spoolFile.string().c_str(), readMode(_mode));
+    if (spool) {
+        std::vector<char> chunk(static_cast<size_t>(ChunkSize));
+        size_t nRead = std::fread(chunk.data(), 1, chunk.size(), spool);
+        while (nRead > 0 && success) {
+            success = std::fwrite(chunk.data(), 1, nRead, file) == nRead;
+            nRead = std::fread(chunk.data(), 1, chunk.size(), spool);
+        }
+        std::fclose(spool);
+    }
+    else {
+        success = false;
+    }
+
+    if (_syncPolicy != SyncPolicy::None) {
+        syncToDisk(file);
+    }
+    std::fclose(file);
+
+    if (!success) {
+        LERROR(fmt::format(
+            "Error writing recording file {}. The recorded keyframes are kept in {}",
+            _file, _spoolFile
+        ));
+    }
+    return success;
+}
+
+} // namespace openspace::interaction
@@ -186,6 +186,7 @@ void ConvertRecFormatTask::convertToAscii() {
     datamessagestructures::CameraKeyframe ckf;
     datamessagestructures::TimeKeyframe   tkf;
     datamessagestructures::ScriptMessage  skf;
+    datamessagestructures::CameraKeyframeDecoder decoder;
     int lineNum = 1;
     _oFile.open(_outFilePath, std::ifstream::app);
     char tmpType = SessionRecording::DataFormatAsciiTag;
@@ -213,6 +214,25 @@ void ConvertRecFormatTask::convertToAscii() {
                 keyframeLine);
             ckf.write(keyframeLine);
         }
+        else if (frameType == SessionRecording::HeaderCameraCompressedBinary) {
+            times.timeOs = readFromPlayback<double>(_iFile);
+            times.timeRec = readFromPlayback<double>(_iFile);
+            times.timeSim = readFromPlayback<double>(_iFile);
+            const uint32_t size = readFromPlayback<uint32_t>(_iFile);
+            std::vector<char> buffer(_iFile ? size : 0);
+            _iFile.read(buffer.data(), buffer.size());
+            size_t offset = 0;
+            if (!_iFile || !decoder.decode(buffer, offset, ckf)) {
+                LERROR(fmt::format(
+                    "Error decoding compressed camera keyframe @ index {} of file {}",
+                    lineNum - 1, _inFilePath
+                ));
+                break;
+            }
+            sessRec->saveHeaderAscii(times, SessionRecording::HeaderCameraAscii,
+                keyframeLine);
+            ckf.write(keyframeLine);
+        }
         else if (frameType == SessionRecording::HeaderTimeBinary) {
             sessRec->readTimeKeyframeBinary(times, tkf, _iFile, lineNum);
             sessRec->saveHeaderAscii(times, SessionRecording::HeaderTimeAscii,
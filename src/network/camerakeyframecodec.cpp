@@ -0,0 +1,352 @@
+/*****************************************************************************************
+ *                                                                                       *
+ * OpenSpace                                                                             *
+ *                                                                                       *
+ * Copyright (c) 2014-2023                                                               *
+ *                                                                                       *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this  *
+ * software and associated documentation files (the "Software"), to deal in the Software *
+ * without restriction, including without limitation the rights to use, copy, modify,    *
+ * merge, publish, distribute, sublicense, and/or sell copies of the Software, and to    *
+ * permit persons to whom the Software is furnished to do so, subject to the following   *
+ * conditions:                                                                           *
+ *                                                                                       *
+ * The above copyright notice and this permission notice shall be included in all copies *
+ * or substantial portions of the Software.                                              *
+ *                                                                                       *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,   *
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A         *
+ * PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT    *
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF  *
+ * CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE  *
+ * OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                                         *
+ ****************************************************************************************/
+
+#include <openspace/network/camerakeyframecodec.h>
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstring>
+
+namespace {
+    enum Flags : uint8_t {
+        Keyframe = 1 << 0,
+        FollowNodeRotation = 1 << 1,
+        NodeDefinition = 1 << 2,
+        ScaleChanged = 1 << 3
+    };
+
+    // The positions are quantized to this many bits relative to their magnitude, which
+    // results in sub-millimeter precision for a camera that is close to a planet
+    constexpr int PositionPrecisionBits = 32;
+
+    // Quantized deltas that are larger than this cannot be represented exactly and result
+    // in a keyframe instead
+    constexpr double MaxQuantizedDelta = 4503599627370496.0; // 2^52
+
+    // Each of the three smallest quaternion components is stored with this many bits,
+    // which, together with the 2 bit index of the largest component, fill 64 bits
+    constexpr int RotationBits = 20;
+    constexpr uint64_t RotationMask = (uint64_t(1) << RotationBits) - 1;
+    constexpr double RotationRange = 0.70710678118654752440; // 1 / sqrt(2)
+
+    constexpr double TimestampResolution = 1e-6;
+
+    template <typename T>
+    void append(std::vector<char>& buffer, const T& value) {
+        const char* p = reinterpret_cast<const char*>(&value);
+        buffer.insert(buffer.end(), p, p + sizeof(T));
+    }
+
+    template <typename T>
+    bool read(const std::vector<char>& buffer, size_t& offset, T& value) {
+        if (offset + sizeof(T) > buffer.size()) {
+            return false;
+        }
+        std::memcpy(&value, buffer.data() + offset, sizeof(T));
+        offset += sizeof(T);
+        return true;
+    }
+
+    void appendVarint(std::vector<char>& buffer, uint64_t value) {
+        while (value >= 0x80) {
+            buffer.push_back(static_cast<char>((value & 0x7F) | 0x80));
+            value >>= 7;
+        }
+        buffer.push_back(static_cast<char>(value));
+    }
+
+    bool readVarint(const std::vector<char>& buffer, size_t& offset, uint64_t& value) {
+        value = 0;
+        for (int shift = 0; shift < 64; shift += 7) {
+            if (offset >= buffer.size()) {
+                return false;
+            }
+            const uint8_t byte = static_cast<uint8_t>(buffer[offset]);
+            offset++;
+            value |= static_cast<uint64_t>(byte & 0x7F) << shift;
+            if ((byte & 0x80) == 0) {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    uint64_t zigzag(int64_t value) {
+        return (static_cast<uint64_t>(value) << 1) ^ static_cast<uint64_t>(value >> 63);
+    }
+
+    int64_t unzigzag(uint64_t value) {
+        return static_cast<int64_t>(value >> 1) ^ -static_cast<int64_t>(value & 1);
+    }
+
+    int positionExponent(const glm::dvec3& reference, const glm::dvec3& position) {
+        const double magnitude = std::max({
+            std::abs(reference.x), std::abs(reference.y), std::abs(reference.z),
+            std::abs(position.x), std::abs(position.y), std::abs(position.z),
+            1e-6
+        });
+        const int exponent = std::ilogb(magnitude) - PositionPrecisionBits;
+        return std::clamp(exponent, -128, 127);
+    }
+
+    uint64_t packRotation(glm::dquat q) {
+        q = glm::normalize(q);
+
+        int largest = 0;
+        for (int i = 1; i < 4; i++) {
+            if (std::abs(q[i]) > std::abs(q[largest])) {
+                largest = i;
+            }
+        }
+        // q and -q represent the same rotation, so the largest component is made positive
+        const double sign = q[largest] < 0.0 ? -1.0 : 1.0;
+
+        uint64_t packed = static_cast<uint64_t>(largest);
+        int shift = 2;
+        for (int i = 0; i < 4; i++) {
+            if (i == largest) {
+                continue;
+            }
+            const double v = std::clamp(sign * q[i] / RotationRange, -1.0, 1.0);
+            const uint64_t quantized = static_cast<uint64_t>(
+                std::llround((v + 1.0) * 0.5 * static_cast<double>(RotationMask))
+            );
+            packed |= quantized << shift;
+            shift += RotationBits;
+        }
+        return packed;
+    }
+
+    glm::dquat unpackRotation(uint64_t packed) {
+        const int largest = static_cast<int>(packed & 3);
+
+        glm::dquat q;
+        double sumSquared = 0.0;
+        int shift = 2;
+        for (int i = 0; i < 4; i++) {
+            if (i == largest) {
+                continue;
+            }
+            const uint64_t quantized = (packed >> shift) & RotationMask;
+            const double v = static_cast<double>(quantized) /
+                static_cast<double>(RotationMask) * 2.0 - 1.0;
+            q[i] = v * RotationRange;
+            sumSquared += q[i] * q[i];
+            shift += RotationBits;
+        }
+        q[largest] = std::sqrt(std::max(0.0, 1.0 - sumSquared));
+        return glm::normalize(q);
+    }
+} // namespace
+
+namespace openspace::datamessagestructures {
+
+CameraKeyframeEncoder::CameraKeyframeEncoder(int keyframeInterval)
+    : _keyframeInterval(keyframeInterval)
+{}
+
+void CameraKeyframeEncoder::encode(const CameraKeyframe& kf, std::vector<char>& buffer)
+{
+    auto it = _nodeIds.find(kf._focusNode);
+    const bool isNewNode = (it == _nodeIds.end());
+    if (isNewNode) {
+        const uint32_t id = static_cast<uint32_t>(_nodeIds.size());
+        it = _nodeIds.emplace(kf._focusNode, id).first;
+    }
+
+    // Periodic keyframes redefine the focus node so that late decoders can catch up
+    const bool isPeriodicKeyframe =
+        !_reference.has_value() || _nFramesSinceKeyframe >= _keyframeInterval;
+    bool isKeyframe = isPeriodicKeyframe ||
+        _reference->_focusNode != kf._focusNode ||
+        _reference->_followNodeRotation != kf._followNodeRotation;
+
+    int exponent = 0;
+    std::array<int64_t, 3> positionDelta = { 0, 0, 0 };
+    int64_t timestampDelta = 0;
+    if (!isKeyframe) {
+        exponent = positionExponent(_reference->_position, kf._position);
+        for (int i = 0; i < 3; i++) {
+            const double d =
+                std::ldexp(kf._position[i] - _reference->_position[i], -exponent);
+            // The negated comparison also catches NaN values
+            if (!(std::abs(d) < MaxQuantizedDelta)) {
+                isKeyframe = true;
+                break;
+            }
+            positionDelta[i] = std::llround(d);
+        }
+
+        const double dt = (kf._timestamp - _reference->_timestamp) / TimestampResolution;
+        if (!(std::abs(dt) < MaxQuantizedDelta)) {
+            isKeyframe = true;
+        }
+        timestampDelta = std::llround(dt);
+    }
+
+    uint8_t flags = 0;
+    if (isKeyframe) {
+        flags |= Flags::Keyframe;
+        if (isNewNode || isPeriodicKeyframe) {
+            flags |= Flags::NodeDefinition;
+        }
+    }
+    if (kf._followNodeRotation) {
+        flags |= Flags::FollowNodeRotation;
+    }
+    if (!isKeyframe && kf._scale != _reference->_scale) {
+        flags |= Flags::ScaleChanged;
+    }
+    append(buffer, flags);
+
+    if (isKeyframe) {
+        appendVarint(buffer, it->second);
+        if (flags & Flags::NodeDefinition) {
+            appendVarint(buffer, kf._focusNode.size());
+            buffer.insert(buffer.end(), kf._focusNode.begin(), kf._focusNode.end());
+        }
+        append(buffer, kf._position);
+        append(buffer, kf._rotation);
+        append(buffer, kf._scale);
+        append(buffer, kf._timestamp);
+
+        _reference = kf;
+        _nFramesSinceKeyframe = 0;
+        return;
+    }
+
+    append(buffer, static_cast<int8_t>(exponent));
+    for (int i = 0; i < 3; i++) {
+        appendVarint(buffer, zigzag(positionDelta[i]));
+    }
+    const uint64_t packedRotation = packRotation(kf._rotation);
+    append(buffer, packedRotation);
+    if (flags & Flags::ScaleChanged) {
+        append(buffer, kf._scale);
+    }
+    appendVarint(buffer, zigzag(timestampDelta));
+
+    // Update the reference in the same way as the decoder will do it
+    for (int i = 0; i < 3; i++) {
+        _reference->_position[i] +=
+            std::ldexp(static_cast<double>(positionDelta[i]), exponent);
+    }
+    _reference->_rotation = unpackRotation(packedRotation);
+    _reference->_scale = kf._scale;
+    _reference->_timestamp += static_cast<double>(timestampDelta) * TimestampResolution;
+    _nFramesSinceKeyframe++;
+}
+
+void CameraKeyframeEncoder::reset() {
+    _reference = std::nullopt;
+}
+
+bool CameraKeyframeDecoder::decode(const std::vector<char>& buffer, size_t& offset,
+                                   CameraKeyframe& kf)
+{
+    uint8_t flags = 0;
+    if (!read(buffer, offset, flags)) {
+        return false;
+    }
+
+    if (flags & Flags::Keyframe) {
+        uint64_t id = 0;
+        if (!readVarint(buffer, offset, id)) {
+            return false;
+        }
+        if (flags & Flags::NodeDefinition) {
+            uint64_t length = 0;
+            if (!readVarint(buffer, offset, length) || offset + length > buffer.size()) {
+                return false;
+            }
+            _nodeNames[static_cast<uint32_t>(id)] = std::string(
+                buffer.data() + offset,
+                buffer.data() + offset + length
+            );
+            offset += length;
+        }
+
+        CameraKeyframe res;
+        bool success = read(buffer, offset, res._position) &&
+            read(buffer, offset, res._rotation) &&
+            read(buffer, offset, res._scale) &&
+            read(buffer, offset, res._timestamp);
+
+        auto it = _nodeNames.find(static_cast<uint32_t>(id));
+        if (!success || it == _nodeNames.end()) {
+            // We don't know the name of the focus node yet and have to wait for the next
+            // keyframe that defines it
+            _reference = std::nullopt;
+            return false;
+        }
+        res._focusNode = it->second;
+        res._followNodeRotation = (flags & Flags::FollowNodeRotation) != 0;
+
+        _reference = res;
+        kf = res;
+        return true;
+    }
+
+    int8_t exponent = 0;
+    std::array<uint64_t, 3> positionDelta = { 0, 0, 0 };
+    uint64_t packedRotation = 0;
+    float scale = _reference.has_value() ? _reference->_scale : 0.f;
+    uint64_t timestampDelta = 0;
+
+    bool success = read(buffer, offset, exponent) &&
+        readVarint(buffer, offset, positionDelta[0]) &&
+        readVarint(buffer, offset, positionDelta[1]) &&
+        readVarint(buffer, offset, positionDelta[2]) &&
+        read(buffer, offset, packedRotation);
+    if (success && (flags & Flags::ScaleChanged)) {
+        success = read(buffer, offset, scale);
+    }
+    success = success && readVarint(buffer, offset, timestampDelta);
+
+    if (!success || !_reference.has_value()) {
+        return false;
+    }
+
+    for (int i = 0; i < 3; i++) {
+        _reference->_position[i] += std::ldexp(
+            static_cast<double>(unzigzag(positionDelta[i])),
+            exponent
+        );
+    }
+    _reference->_rotation = unpackRotation(packedRotation);
+    _reference->_scale = scale;
+    _reference->_timestamp +=
+        static_cast<double>(unzigzag(timestampDelta)) * TimestampResolution;
+    _reference->_followNodeRotation = (flags & Flags::FollowNodeRotation) != 0;
+
+    kf = *_reference;
+    return true;
+}
+
+void CameraKeyframeDecoder::reset() {
+    _reference = std::nullopt;
+}
+
+} // namespace openspace::datamessagestructures
@@ -115,6 +115,16 @@ namespace {
         // @VISIBILITY(3.5)
         openspace::properties::Property::Visibility::AdvancedUser
     };
+
+    constexpr openspace::properties::Property::PropertyInfo CompressCameraKeyframesInfo =
+    {
+        "CompressCameraKeyframes",
+        "Compress Camera Keyframes",
+        "If enabled, the camera keyframes that are sent while being the host are delta "
+        "encoded against the previous keyframe, which reduces the required bandwidth. "
+        "All connected instances have to support the compressed keyframes",
+        openspace::properties::Property::Visibility::AdvancedUser
+    };
 } // namespace
 
 namespace openspace {
@@ -129,6 +139,7 @@ ParallelPeer::ParallelPeer()
     , _bufferTime(BufferTimeInfo, 0.2f, 0.01f, 5.0f)
     , _timeKeyframeInterval(TimeKeyFrameInfo, 0.1f, 0.f, 1.f)
     , _cameraKeyframeInterval(CameraKeyFrameInfo, 0.1f, 0.f, 1.f)
+    , _compressCameraKeyframes(CompressCameraKeyframesInfo, false)
     , _connectionEvent(std::make_shared<ghoul::Event<>>())
     , _connection(nullptr)
 {
@@ -142,6 +153,9 @@ ParallelPeer::ParallelPeer()
 
     addProperty(_timeKeyframeInterval);
     addProperty(_cameraKeyframeInterval);
+
+    _compressCameraKeyframes.onChange([this]() { _cameraKeyframeEncoder.reset(); });
+    addProperty(_compressCameraKeyframes);
 }
 
 ParallelPeer::~ParallelPeer() {
@@ -163,6 +177,8 @@ void ParallelPeer::connect() {
 
     socket->connect();
     _connection = ParallelConnection(std::move(socket));
+    _cameraKeyframeEncoder.reset();
+    _cameraKeyframeDecoder.reset();
 
     sendAuthentication();
 
@@ -324,23 +340,17 @@ void ParallelPeer::dataMessageReceived(const std::vector<char>& message) {
     switch (static_cast<datamessagestructures::Type>(type)) {
         case datamessagestructures::Type::CameraData: {
             datamessagestructures::CameraKeyframe kf(buffer);
-            const double convertedTimestamp = convertTimestamp(kf._timestamp);
-
-            global::navigationHandler->keyframeNavigator().removeKeyframesAfter(
-                convertedTimestamp
-            );
-
-            interaction::KeyframeNavigator::CameraPose pose;
-            pose.focusNode = kf._focusNode;
-            pose.position = kf._position;
-            pose.rotation = kf._rotation;
-            pose.scale = kf._scale;
-            pose.followFocusNodeRotation = kf._followNodeRotation;
-
-            global::navigationHandler->keyframeNavigator().addKeyframe(
-                convertedTimestamp,
-                pose
-            );
+            addCameraKeyframe(kf);
+            break;
+        }
+        case datamessagestructures::Type::CompressedCameraData: {
+            datamessagestructures::CameraKeyframe kf;
+            size_t kfOffset = 0;
+            // Decoding fails for delta frames until the first full keyframe has been
+            // received after joining a session
+            if (_cameraKeyframeDecoder.decode(buffer, kfOffset, kf)) {
+                addCameraKeyframe(kf);
+            }
             break;
         }
         case datamessagestructures::Type::TimelineData: {
@@ -410,6 +420,26 @@ void ParallelPeer::dataMessageReceived(const std::vector<char>& message) {
     }
 }
 
+void ParallelPeer::addCameraKeyframe(const datamessagestructures::CameraKeyframe& kf) {
+    const double convertedTimestamp = convertTimestamp(kf._timestamp);
+
+    global::navigationHandler->keyframeNavigator().removeKeyframesAfter(
+        convertedTimestamp
+    );
+
+    interaction::KeyframeNavigator::CameraPose pose;
+    pose.focusNode = kf._focusNode;
+    pose.position = kf._position;
+    pose.rotation = kf._rotation;
+    pose.scale = kf._scale;
+    pose.followFocusNodeRotation = kf._followNodeRotation;
+
+    global::navigationHandler->keyframeNavigator().addKeyframe(
+        convertedTimestamp,
+        pose
+    );
+}
+
 void ParallelPeer::connectionStatusMessageReceived(const std::vector<char>& message) {
     if (message.size() < 2 * sizeof(uint8_t)) {
         LERROR("Malformed connection status message");
@@ -453,6 +483,10 @@ void ParallelPeer::connectionStatusMessageReceived(const std::vector<char>& mess
 
     setStatus(status);
 
+    // A different host will start a new stream of camera keyframes
+    _cameraKeyframeEncoder.reset();
+    _cameraKeyframeDecoder.reset();
+
     global::navigationHandler->keyframeNavigator().clearKeyframes();
     global::timeManager->clearKeyframes();
 }
@@ -660,6 +694,9 @@ ParallelConnection::Status ParallelPeer::status() {
 
 void ParallelPeer::setNConnections(size_t nConnections) {
     if (_nConnections != nConnections) {
+        // Send a full keyframe next so that newly connected peers don't have to wait
+        // for the next periodic keyframe
+        _cameraKeyframeEncoder.reset();
         _nConnections = nConnections;
         _connectionEvent->publish("nConnectionsChanged");
     }
@@ -716,12 +753,19 @@ void ParallelPeer::sendCameraKeyframe() {
     std::vector<char> buffer;
 
     // Fill the keyframe buffer
-    kf.serialize(buffer);
+    if (_compressCameraKeyframes) {
+        _cameraKeyframeEncoder.encode(kf, buffer);
+    }
+    else {
+        kf.serialize(buffer);
+    }
 
     const double timestamp = global::windowDelegate->applicationTime();
     // Send message
     _connection.sendDataMessage(ParallelConnection::DataMessage(
-        datamessagestructures::Type::CameraData,
+        _compressCameraKeyframes ?
+            datamessagestructures::Type::CompressedCameraData :
+            datamessagestructures::Type::CameraData,
         timestamp,
         buffer
     ));
@@ -0,0 +1,431 @@
+/*****************************************************************************************
+ *                                                                                       *
+ * OpenSpace                                                                             *
+ *                                                                                       *
+ * Copyright (c) 2014-2023                                                               *
+ *                                                                                       *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this  *
+ * software and associated documentation files (the "Software"), to deal in the Software *
+ * without restriction, including without limitation the rights to use, copy, modify,    *
+ * merge, publish, distribute, sublicense, and/or sell copies of the Software, and to    *
+ * permit persons to whom the Software is furnished to do so, subject to the following   *
+ * conditions:                                                                           *
+ *                                                                                       *
+ * The above copyright notice and this permission notice shall be included in all copies *
+ * or substantial portions of the Software.                                              *
+ *                                                                                       *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,   *
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A         *
+ * PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT    *
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF  *
+ * CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE  *
+ * OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                                         *
+ ****************************************************************************************/
+
+
+#include <openspace/rendering/labellayout.h>
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <numeric>
+
+namespace {
+    // The maximum number of labels that are stored in a leaf node of the hierarchy
+    constexpr uint32_t LeafSize = 16;
+
+    enum class Containment {
+        Outside,
+        Intersecting,
+        Inside
+    };
+
+    // The half-space in which dot(normal, p) + distance >= 0. The planes are not
+    // normalized as only the sign of the result is of interest
+    struct Plane {
+        glm::dvec3 normal;
+        double distance;
+    };
+
+    using Frustum = std::array<Plane, 5>;
+
+    Plane toPlane(const glm::dvec4& v) {
+        return { glm::dvec3(v.x, v.y, v.z), v.w };
+    }
+
+    glm::dvec4 row(const glm::dmat4& m, int r) {
+        return glm::dvec4(m[0][r], m[1][r], m[2][r], m[3][r]);
+    }
+
+    Frustum frustum(const openspace::LabelLayout::Settings& settings) {
+        // The planes follow from the clip space conditions -w <= x, y, z and x, y <= w,
+        // where the conditions for x and y are widened by the margin. There is no far
+        // plane as labels are not clipped against it when they are rendered
+        const glm::dvec2 viewport = glm::dvec2(glm::max(settings.viewportSize, 1));
+        const glm::dvec2 margin =
+            glm::dvec2(1.0) + 2.0 * static_cast<double>(settings.margin) / viewport;
+
+        const glm::dmat4& m = settings.modelViewProjection;
+        const glm::dvec4 x = row(m, 0);
+        const glm::dvec4 y = row(m, 1);
+        const glm::dvec4 z = row(m, 2);
+        const glm::dvec4 w = row(m, 3);
+        return {
+            toPlane(margin.x * w + x),
+            toPlane(margin.x * w - x),
+            toPlane(margin.y * w + y),
+            toPlane(margin.y * w - y),
+            toPlane(w + z)
+        };
+    }
+
+    Containment test(const Frustum& planes, const glm::dvec3& min, const glm::dvec3& max)
+    {
+        Containment res = Containment::Inside;
+        for (const Plane& p : planes) {
+            // The corners of the box that are furthest along and against the normal
+            const glm::dvec3 positive = glm::dvec3(
+                p.normal.x >= 0.0 ? max.x : min.x,
+                p.normal.y >= 0.0 ? max.y : min.y,
+                p.normal.z >= 0.0 ? max.z : min.z
+            );
+            if (glm::dot(p.normal, positive) + p.distance < 0.0) {
+                return Containment::Outside;
+            }
+
+            const glm::dvec3 negative = glm::dvec3(
+                p.normal.x >= 0.0 ? min.x : max.x,
+                p.normal.y >= 0.0 ? min.y : max.y,
+                p.normal.z >= 0.0 ? min.z : max.z
+            );
+            if (glm::dot(p.normal, negative) + p.distance < 0.0) {
+                res = Containment::Intersecting;
+            }
+        }
+        return res;
+    }
+
+    Containment test(const glm::dvec3& center, double maxDistance,
+                     const glm::dvec3& min, const glm::dvec3& max)
+    {
+        const glm::dvec3 closest = glm::clamp(center, min, max);
+        const glm::dvec3 furthest =
+            glm::max(glm::abs(center - min), glm::abs(center - max));
+        const double maxDistance2 = maxDistance * maxDistance;
+
+        if (glm::dot(center - closest, center - closest) > maxDistance2) {
+            return Containment::Outside;
+        }
+        else if (glm::dot(furthest, furthest) > maxDistance2) {
+            return Containment::Intersecting;
+        }
+        else {
+            return Containment::Inside;
+        }
+    }
+
+    Containment combine(Containment lhs, Containment rhs) {
+        return static_cast<Containment>(
+            std::min(static_cast<int>(lhs), static_cast<int>(rhs))
+        );
+    }
+} // namespace
+
+namespace openspace {
+
+void LabelLayout::setLabels(std::vector<Label> labels) {
+    _labels = std::move(labels);
+    _order.resize(_labels.size());
+    std::iota(_order.begin(), _order.end(), 0);
+    _nodes.clear();
+    _nodes.reserve(4 * _labels.size() / LeafSize + 1);
+    _wasPlaced.assign(_labels.size(), 0);
+    _result.clear();
+    _previousResult.clear();
+
+    if (!_labels.empty()) {
+        build(0, static_cast<uint32_t>(_labels.size()));
+    }
+}
+
+const std::vector<LabelLayout::Label>& LabelLayout::labels() const {
+    return _labels;
+}
+
+void LabelLayout::build(uint32_t begin, uint32_t end) {
+    glm::dvec3 min = glm::dvec3(std::numeric_limits<double>::max());
+    glm::dvec3 max = glm::dvec3(-std::numeric_limits<double>::max());
+    for (uint32_t i = begin; i < end; i++) {
+        min = glm::min(min, _labels[_order[i]].position);
+        max = glm::max(max, _labels[_order[i]].position);
+    }
+
+    const uint32_t node = static_cast<uint32_t>(_nodes.size());
+    _nodes.push_back({ min, max, begin, end, 0 });
+    if (end - begin <= LeafSize) {
+        return;
+    }
+
+    // Split at the median along the longest axis of the bounding box
+    const glm::dvec3 extent = max - min;
+    int axis = 0;
+    if (extent.y > extent[axis]) {
+        axis = 1;
+    }
+    if (extent.z > extent[axis]) {
+        axis = 2;
+    }
+    const uint32_t mid = begin + (end - begin) / 2;
+    std::nth_element(
+        _order.begin() + begin,
+        _order.begin() + mid,
+        _order.begin() + end,
+        [this, axis](uint32_t lhs, uint32_t rhs) {
+            return _labels[lhs].position[axis] < _labels[rhs].position[axis];
+        }
+    );
+
+    build(begin, mid);
+    _nodes[node].right = static_cast<uint32_t>(_nodes.size());
+    build(mid, end);
+}
+
+const std::vector<size_t>&
+LabelLayout::layout(const Settings& settings,
+                    const std::function<bool(size_t)>& isEnabled)
+{
+    // The placement of the previous call is needed to order the candidates, so the
+    // flags are only updated once the new result is known
+    std::swap(_result, _previousResult);
+    _result.clear();
+    _candidates.clear();
+
+    if (_nodes.empty()) {
+        _previousResult.clear();
+        return _result;
+    }
+
+    const bool testDistance = std::isfinite(settings.maxDistance);
+    const bool arrange = settings.cullOverlapping || settings.maxLabels > 0;
+    const Frustum planes = frustum(settings);
+    const glm::dmat4& mvp = settings.modelViewProjection;
+    const glm::dvec2 viewport = glm::dvec2(settings.viewportSize);
+
+    auto containment = [&](const glm::dvec3& min, const glm::dvec3& max) {
+        Containment res = Containment::Inside;
+        if (settings.frustumCulling) {
+            res = test(planes, min, max);
+        }
+        if (testDistance && res != Containment::Outside) {
+            res = combine(
+                res,
+                test(settings.cameraPosition, settings.maxDistance, min, max)
+            );
+        }
+        return res;
+    };
+
+    auto addLabel = [&](size_t index) {
+        if (isEnabled && !isEnabled(index)) {
+            return;
+        }
+        if (!arrange) {
+            _result.push_back(index);
+            return;
+        }
+
+        const glm::dvec4 clip = mvp * glm::dvec4(_labels[index].position, 1.0);
+        const glm::dvec2 ndc = glm::dvec2(clip.x, clip.y) / clip.w;
+        _candidates.push_back({
+            .index = index,
+            .priority = _labels[index].priority,
+            .wasPlaced = _wasPlaced[index] != 0,
+            .screen = (ndc * 0.5 + 0.5) * viewport,
+            .depth = clip.w
+        });
+    };
+
+    // Depth-first traversal of the hierarchy. Once a node is known to be completely
+    // inside, none of the labels underneath it need to be tested anymore
+    struct Entry {
+        uint32_t node;
+        bool isInside;
+    };
+    std::vector<Entry> stack;
+    stack.push_back({ 0, false });
+    while (!stack.empty()) {
+        const Entry entry = stack.back();
+        stack.pop_back();
+        const Node& node = _nodes[entry.node];
+
+        Containment c = Containment::Inside;
+        if (!entry.isInside) {
+            c = containment(node.min, node.max);
+            if (c == Containment::Outside) {
+                continue;
+            }
+        }
+
+        if (c == Containment::Inside) {
+            for (uint32_t i = node.begin; i < node.end; i++) {
+                addLabel(_order[i]);
+            }
+        }
+        else if (node.right == 0) {
+            for (uint32_t i = node.begin; i < node.end; i++) {
+                const glm::dvec3& p = _labels[_order[i]].position;
+                if (containment(p, p) != Containment::Outside) {
+                    addLabel(_order[i]);
+                }
+            }
+        }
+        else {
+            stack.push_back({ node.right, false });
+            stack.push_back({ entry.node + 1, false });
+        }
+    }
+
+    // Only labels that have been placed when ordering the candidates are flagged
+    auto finish = [this, arrange]() -> const std::vector<size_t>& {
+        for (size_t i : _previousResult) {
+            _wasPlaced[i] = 0;
+        }
+        if (arrange) {
+            for (size_t i : _result) {
+                _wasPlaced[i] = 1;
+            }
+        }
+        return _result;
+    };
+
+    if (!arrange) {
+        return finish();
+    }
+
+    auto comparePriority = [](const Candidate& lhs, const Candidate& rhs) {
+        if (lhs.priority != rhs.priority) {
+            return lhs.priority > rhs.priority;
+        }
+        if (lhs.wasPlaced != rhs.wasPlaced) {
+            return lhs.wasPlaced;
+        }
+        if (lhs.depth != rhs.depth) {
+            return lhs.depth < rhs.depth;
+        }
+        return lhs.index < rhs.index;
+    };
+
+    const size_t maxLabels = settings.maxLabels > 0 ?
+        static_cast<size_t>(settings.maxLabels) :
+        _candidates.size();
+
+    if (!settings.cullOverlapping) {
+        // Only the first labels are needed, so there is no need to sort all of them
+        const size_t n = std::min(maxLabels, _candidates.size());
+        std::partial_sort(
+            _candidates.begin(),
+            _candidates.begin() + n,
+            _candidates.end(),
+            comparePriority
+        );
+        for (size_t i = 0; i < n; i++) {
+            _result.push_back(_candidates[i].index);
+        }
+        return finish();
+    }
+
+    const int cellSize = std::max(settings.cellSize, 1);
+    _gridSize = (glm::max(settings.viewportSize, 0) + cellSize - 1) / cellSize;
+    _occupancy.assign(static_cast<size_t>(_gridSize.x) * _gridSize.y, 0);
+
+    if (maxLabels < _candidates.size()) {
+        // It is unknown how many candidates have to be tried before enough labels are
+        // placed, but it is usually only a fraction of them. Taking them one by one from
+        // a heap avoids sorting all candidates
+        auto heapCompare = [&](const Candidate& lhs, const Candidate& rhs) {
+            return comparePriority(rhs, lhs);
+        };
+        std::make_heap(_candidates.begin(), _candidates.end(), heapCompare);
+        auto last = _candidates.end();
+        while (last != _candidates.begin() && _result.size() < maxLabels) {
+            std::pop_heap(_candidates.begin(), last, heapCompare);
+            last--;
+            if (place(settings, *last)) {
+                _result.push_back(last->index);
+            }
+        }
+    }
+    else {
+        std::sort(_candidates.begin(), _candidates.end(), comparePriority);
+        for (const Candidate& candidate : _candidates) {
+            if (place(settings, candidate)) {
+                _result.push_back(candidate.index);
+            }
+        }
+    }
+    return finish();
+}
+
+bool LabelLayout::place(const Settings& settings, const Candidate& candidate) {
+    if (candidate.depth <= 0.0) {
+        // The label is behind the camera
+        return false;
+    }
+
+    // The height of the label on screen is estimated by projecting a point that is one
+    // text height above the anchor point
+    const Label& label = _labels[candidate.index];
+    const glm::dvec4 top = settings.modelViewProjection *
+        glm::dvec4(label.position + settings.textUp * settings.textHeight, 1.0);
+    double height = 0.0;
+    if (top.w > 0.0) {
+        const glm::dvec2 ndc = glm::dvec2(top.x, top.y) / top.w;
+        const glm::dvec2 screen = (ndc * 0.5 + 0.5) * glm::dvec2(settings.viewportSize);
+        height = glm::length(screen - candidate.screen);
+    }
+    if (!(height >= settings.minMaxTextHeight.x)) {
+        // Also catches the height being NaN
+        height = settings.minMaxTextHeight.x;
+    }
+    height = std::min(height, static_cast<double>(settings.minMaxTextHeight.y));
+    const double width = std::max(label.textLength, 1) *
+        static_cast<double>(settings.characterAspectRatio) * height;
+
+    // The text extends to the right and upwards from the anchor point
+    const glm::dvec2 lower = candidate.screen;
+    const glm::dvec2 upper = candidate.screen + glm::dvec2(width, height);
+    if (upper.x < 0.0 || upper.y < 0.0 ||
+        lower.x >= settings.viewportSize.x || lower.y >= settings.viewportSize.y)
+    {
+        // The label is not visible on screen
+        return false;
+    }
+
+    const double cellSize = static_cast<double>(std::max(settings.cellSize, 1));
+    const glm::ivec2 first = glm::clamp(
+        glm::ivec2(glm::floor(lower / cellSize)),
+        glm::ivec2(0),
+        _gridSize - 1
+    );
+    const glm::ivec2 last = glm::clamp(
+        glm::ivec2(glm::floor(upper / cellSize)),
+        glm::ivec2(0),
+        _gridSize - 1
+    );
+
+    for (int y = first.y; y <= last.y; y++) {
+        const uint8_t* cells = &_occupancy[static_cast<size_t>(y) * _gridSize.x];
+        for (int x = first.x; x <= last.x; x++) {
+            if (cells[x]) {
+                return false;
+            }
+        }
+    }
+    for (int y = first.y; y <= last.y; y++) {
+        uint8_t* cells = &_occupancy[static_cast<size_t>(y) * _gridSize.x];
+        std::fill(cells + first.x, cells + last.x + 1, uint8_t(1));
+    }
+    return true;
+}
+
+} // namespace openspace
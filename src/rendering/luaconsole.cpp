@@ -29,7 +29,7 @@
 #include <openspace/network/parallelpeer.h>
 #include <openspace/rendering/helper.h>
 #include <openspace/scripting/scriptengine.h>
-#include <ghoul/filesystem/cachemanager.h>
+#include <openspace/util/cachefiles.h>
 #include <ghoul/filesystem/filesystem.h>
 #include <ghoul/font/font.h>
 #include <ghoul/font/fontmanager.h>
@@ -187,7 +187,7 @@ LuaConsole::~LuaConsole() {}
 void LuaConsole::initialize() {
     ZoneScoped;
 
-    const std::filesystem::path filename = FileSys.cacheManager()->cachedFilename(
+    const std::filesystem::path filename = cachedFilename(
         HistoryFile,
         ""
     );
@@ -252,7 +252,7 @@ void LuaConsole::initialize() {
 void LuaConsole::deinitialize() {
     ZoneScoped;
 
-    const std::filesystem::path filename = FileSys.cacheManager()->cachedFilename(
+    const std::filesystem::path filename = cachedFilename(
         HistoryFile,
         ""
     );
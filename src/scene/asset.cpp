@@ -24,7 +24,10 @@
 
 #include <openspace/scene/asset.h>
 
+#include <openspace/engine/globals.h>
+#include <openspace/engine/openspaceengine.h>
 #include <openspace/scene/assetmanager.h>
+#include <openspace/util/startuptrace.h>
 #include <ghoul/fmt.h>
 #include <ghoul/filesystem/filesystem.h>
 #include <ghoul/filesystem/file.h>
@@ -67,6 +70,13 @@ void Asset::setState(State state) {
 
     _state = state;
 
+    if (state == State::Synchronized || state == State::SyncRejected) {
+        StartupTrace* trace = global::openSpaceEngine->startupTrace();
+        if (trace) {
+            trace->end(_assetPath.string(), StartupTrace::Phase::Synchronize);
+        }
+    }
+
     // If we change our state, there might have been a parent of ours that was waiting for
     // us to finish, so we give each asset that required us the chance to update its own
     // state. This might cause a cascade up towards the roo asset in the best/worst case
@@ -111,7 +121,10 @@ void Asset::addSynchronization(ResourceSynchronization* synchronization) {
 void Asset::setSynchronizationStateResolved() {
     ZoneScoped;
 
-    if (!isSynchronized() && isSyncResolveReady()) {
+    // Synchronizations are started as soon as they are requested, so they might finish
+    // while this asset is still being loaded. In that case, the state is determined when
+    // the synchronizations of this asset are started instead
+    if (_state == State::Synchronizing && isSyncResolveReady()) {
         setState(State::Synchronized);
     }
 }
@@ -119,7 +132,9 @@ void Asset::setSynchronizationStateResolved() {
 void Asset::setSynchronizationStateRejected() {
     ZoneScoped;
 
-    setState(State::SyncRejected);
+    if (_state == State::Synchronizing) {
+        setState(State::SyncRejected);
+    }
 }
 
 bool Asset::isSyncResolveReady() const {
@@ -195,6 +210,11 @@ void Asset::startSynchronizations() {
         return;
     }
 
+    StartupTrace* trace = global::openSpaceEngine->startupTrace();
+    if (trace) {
+        trace->begin(_assetPath.string(), StartupTrace::Phase::Synchronize);
+    }
+
     setState(State::Synchronizing);
 
     // Start synchronization of all children first
@@ -202,15 +222,30 @@ void Asset::startSynchronizations() {
         child->startSynchronizations();
     }
 
-    // Now synchronize its own synchronizations
+    // Now synchronize its own synchronizations. Most of them have already been started
+    // when they were requested while loading the asset file. A synchronization that was
+    // rejected, for example during an earlier network failure, is retried
     for (ResourceSynchronization* s : _synchronizations) {
-        if (!s->isResolved()) {
+        if (!s->isSyncing() && !s->isResolved()) {
             s->start();
         }
     }
+
+    // A synchronization might have been rejected again before this asset was ready to be
+    // notified about it
+    const bool anyRejected = std::any_of(
+        _synchronizations.cbegin(),
+        _synchronizations.cend(),
+        std::mem_fn(&ResourceSynchronization::isRejected)
+    );
+    if (anyRejected) {
+        setState(State::SyncRejected);
+        return;
+    }
+
     // If all syncs are resolved (or no syncs exist), mark as resolved. If they are not,
     // this asset will be told by the ResourceSynchronization when it finished instead
-    if (!isInitialized() && isSyncResolveReady()) {
+    if (_state == State::Synchronizing && isSyncResolveReady()) {
         setState(State::Synchronized);
     }
 }
@@ -344,6 +379,10 @@ void Asset::require(Asset* dependency) {
     }
 }
 
+const std::vector<Asset*>& Asset::requiredAssets() const {
+    return _requiredAssets;
+}
+
 void Asset::setMetaInformation(MetaInformation metaInformation) {
     _metaInformation = std::move(metaInformation);
 }
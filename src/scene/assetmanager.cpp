@@ -29,9 +29,14 @@
 #include <openspace/engine/globals.h>
 #include <openspace/scene/asset.h>
 #include <openspace/scripting/lualibrary.h>
+#include <openspace/util/startuptrace.h>
 #include <ghoul/filesystem/filesystem.h>
 #include <ghoul/logging/logmanager.h>
 #include <ghoul/lua/lua_helper.h>
+#include <ghoul/misc/defer.h>
+#include <chrono>
+#include <functional>
+#include <unordered_set>
 
 #include "assetmanager_lua.inl"
 
@@ -43,6 +48,13 @@ namespace {
     constexpr const char* ExportsTableName = "_exports";
     constexpr const char* AssetTableName = "_asset";
 
+    // The maximum time that is spent initializing assets in a single call to the update
+    // function. At least one asset is always initialized if one is ready, but after this
+    // time has passed, the remaining assets are left for the next call so that the
+    // loading screen stays responsive
+    constexpr std::chrono::milliseconds InitializationBudget =
+        std::chrono::milliseconds(50);
+
     enum class PathType {
         RelativeToAsset, ///< Specified as a path relative to the requiring asset
         RelativeToAssetRoot, ///< Specified as a path relative to the root folder
@@ -167,27 +179,47 @@ void AssetManager::update() {
         _toBeDeleted.clear();
     }
 
-    // Initialize all assets that have been loaded and synchronized but that not yet
-    // initialized
-    for (auto it = _toBeInitialized.cbegin(); it != _toBeInitialized.cend(); ++it) {
+    // Initialize all assets that have been loaded and synchronized but that are not yet
+    // initialized. Instead of waiting for all of the assets required by a root asset to
+    // finish their synchronization, each asset is initialized as soon as it and all of
+    // its requirements are synchronized. The dependency graph is traversed depth-first so
+    // that requirements are always initialized before the assets that require them
+    {
         ZoneScopedN("Initializing queued assets");
-        Asset* a = *it;
 
-        if (a->isInitialized() || !a->isSynchronized()) {
-            // nothing to do here
-            continue;
+        using Clock = std::chrono::steady_clock;
+        const Clock::time_point start = Clock::now();
+        std::unordered_set<Asset*> visited;
+        // Returns `false` if the time budget is used up and the traversal should stop
+        std::function<bool(Asset*)> initializeReady = [&](Asset* a) {
+            if (!visited.insert(a).second || a->isInitialized() || a->isFailed()) {
+                return true;
+            }
+            for (Asset* child : a->requiredAssets()) {
+                if (!initializeReady(child)) {
+                    return false;
+                }
+            }
+            if (a->isSynchronized()) {
+                a->initialize();
+                return Clock::now() - start < InitializationBudget;
+            }
+            return true;
+        };
+        for (Asset* a : _toBeInitialized) {
+            if (!initializeReady(a)) {
+                break;
+            }
         }
 
-        a->initialize();
-
-        // We are only doing one asset per frame to keep the loading screen working a bit
-        // smoother, so we remove the current one and then break out of the loop
-        _toBeInitialized.erase(it);
-
-        // OBS: This can't be replaced with a (get the first one and then bail) as the
-        // first asset in the list might wait for its child later in the list to finished.
-        // So if we check the first one over and over again, we'll be in an infinite loop
-        break;
+        _toBeInitialized.erase(
+            std::remove_if(
+                _toBeInitialized.begin(),
+                _toBeInitialized.end(),
+                [](Asset* a) { return a->isInitialized() || a->isFailed(); }
+            ),
+            _toBeInitialized.end()
+        );
     }
 
     // Add all assets that have been queued for loading since the last `update` call
@@ -368,6 +400,16 @@ bool AssetManager::loadAsset(Asset* asset, Asset* parent) {
         return false;
     }
 
+    StartupTrace* trace = global::openSpaceEngine->startupTrace();
+    if (trace) {
+        trace->begin(asset->path().string(), StartupTrace::Phase::Parse);
+    }
+    defer {
+        if (trace) {
+            trace->end(asset->path().string(), StartupTrace::Phase::Parse);
+        }
+    };
+
     try {
         ghoul::lua::runScriptFile(*_luaState, asset->path());
     }
@@ -551,11 +593,26 @@ void AssetManager::setUpAssetLuaTable(Asset* asset) {
                 syncItem->assets.push_back(thisAsset);
             }
 
-            if (!syncItem->synchronization->isResolved()) {
+            ResourceSynchronization* sync = syncItem->synchronization.get();
+            if (!sync->isResolved()) {
                 manager->_unfinishedSynchronizations.push_back(syncItem);
             }
 
-            thisAsset->addSynchronization(syncItem->synchronization.get());
+            thisAsset->addSynchronization(sync);
+
+            // The synchronization is started as soon as it is discovered instead of when
+            // the entire asset tree has been loaded, so that the downloads happen while
+            // the remaining asset files are still being executed
+            StartupTrace* trace = global::openSpaceEngine->startupTrace();
+            if (trace) {
+                trace->begin(
+                    thisAsset->path().string(),
+                    StartupTrace::Phase::Synchronize
+                );
+            }
+            if (!sync->isSyncing() && !sync->isResolved() && !sync->isRejected()) {
+                sync->start();
+            }
             std::filesystem::path path = syncItem->synchronization->directory();
             path += std::filesystem::path::preferred_separator;
             ghoul::lua::push(L, path);
@@ -608,6 +665,14 @@ void AssetManager::setUpAssetLuaTable(Asset* asset) {
                 return 0;
             }
 
+            StartupTrace* trace = global::openSpaceEngine->startupTrace();
+            if (trace) {
+                trace->addDependency(
+                    parent->path().string(),
+                    dependency->path().string()
+                );
+            }
+
             dependency->load(parent);
             if (dependency->isLoaded()) {
                 if (parent->isSynchronized()) {
@@ -862,6 +927,20 @@ void AssetManager::callOnInitialize(Asset* asset) const {
     ZoneScoped;
     ghoul_precondition(asset, "Asset must not be nullptr");
 
+    // Scene graph nodes that are added by the onInitialize functions are attributed to
+    // this asset in the startup trace
+    StartupTrace* trace = global::openSpaceEngine->startupTrace();
+    if (trace) {
+        trace->begin(asset->path().string(), StartupTrace::Phase::Initialize);
+        trace->setActiveItem(asset->path().string());
+    }
+    defer {
+        if (trace) {
+            trace->setActiveItem("");
+            trace->end(asset->path().string(), StartupTrace::Phase::Initialize);
+        }
+    };
+
     auto it = _onInitializeFunctionRefs.find(asset);
     if (it == _onInitializeFunctionRefs.end()) {
         return;
@@ -40,8 +40,10 @@
 #include <openspace/scene/scenegraphnode.h>
 #include <openspace/scene/scenelicensewriter.h>
 #include <openspace/scene/sceneinitializer.h>
+#include <openspace/scene/scenesnapshot.h>
 #include <openspace/scripting/lualibrary.h>
 #include <openspace/scripting/scriptengine.h>
+#include <openspace/util/startuptrace.h>
 #include <openspace/util/updatestructures.h>
 #include <ghoul/opengl/programobject.h>
 #include <ghoul/logging/logmanager.h>
@@ -263,6 +265,10 @@ void Scene::sortTopologically() {
 }
 
 void Scene::initializeNode(SceneGraphNode* node) {
+    StartupTrace* trace = global::openSpaceEngine->startupTrace();
+    if (trace) {
+        trace->addNode(node->identifier());
+    }
     _initializer->initializeNode(node);
 }
 
@@ -270,17 +276,32 @@ bool Scene::isInitializing() const {
     return _initializer->isInitializing();
 }
 
+void Scene::setVerifiedSnapshot(const SceneSnapshot* snapshot) {
+    _verifiedSnapshot = snapshot;
+}
+
+void Scene::setSnapshotRecorder(SceneSnapshot* snapshot) {
+    _snapshotRecorder = snapshot;
+}
+
 void Scene::update(const UpdateData& data) {
     ZoneScoped;
 
     std::vector<SceneGraphNode*> initializedNodes = _initializer->takeInitializedNodes();
+    StartupTrace* trace = global::openSpaceEngine->startupTrace();
     for (SceneGraphNode* node : initializedNodes) {
+        if (trace) {
+            trace->beginNode(node->identifier(), StartupTrace::Phase::InitializeGL);
+        }
         try {
             node->initializeGL();
         }
         catch (const ghoul::RuntimeError& e) {
             LERRORC(e.component, e.message);
         }
+        if (trace) {
+            trace->endNode(node->identifier(), StartupTrace::Phase::InitializeGL);
+        }
     }
     if (_dirtyNodeRegistry) {
         updateNodeRegistry();
@@ -381,9 +402,16 @@ SceneGraphNode* Scene::loadNode(const ghoul::Dictionary& nodeDictionary) {
         }
     }
 
-    ghoul::mm_unique_ptr<SceneGraphNode> node = SceneGraphNode::createFromDictionary(
-        nodeDictionary
-    );
+    ghoul::mm_unique_ptr<SceneGraphNode> node;
+    if (_verifiedSnapshot && _verifiedSnapshot->containsNode(nodeDictionary)) {
+        // The same dictionary passed all specification tests during a previous load of
+        // this scene, so it would pass them again
+        documentation::SkipSpecificationTests skip;
+        node = SceneGraphNode::createFromDictionary(nodeDictionary);
+    }
+    else {
+        node = SceneGraphNode::createFromDictionary(nodeDictionary);
+    }
     if (!node) {
         // TODO: Throw exception
         LERROR("Could not create node from dictionary: " + nodeIdentifier);
@@ -435,6 +463,10 @@ SceneGraphNode* Scene::loadNode(const ghoul::Dictionary& nodeDictionary) {
     }
 
     rawNodePointer->setDependencies(dependencies);
+
+    if (_snapshotRecorder) {
+        _snapshotRecorder->addNode(nodeDictionary);
+    }
     return rawNodePointer;
 }
 
@@ -28,12 +28,20 @@
 #include <openspace/engine/openspaceengine.h>
 #include <openspace/rendering/loadingscreen.h>
 #include <openspace/scene/scenegraphnode.h>
+#include <openspace/util/startuptrace.h>
 #include <ghoul/logging/logmanager.h>
 
 namespace openspace {
 
 void SingleThreadedSceneInitializer::initializeNode(SceneGraphNode* node) {
+    StartupTrace* trace = global::openSpaceEngine->startupTrace();
+    if (trace) {
+        trace->beginNode(node->identifier(), StartupTrace::Phase::Initialize);
+    }
     node->initialize();
+    if (trace) {
+        trace->endNode(node->identifier(), StartupTrace::Phase::Initialize);
+    }
     _initializedNodes.push_back(node);
 }
 
@@ -51,7 +59,11 @@ MultiThreadedSceneInitializer::MultiThreadedSceneInitializer(unsigned int nThrea
 {}
 
 void MultiThreadedSceneInitializer::initializeNode(SceneGraphNode* node) {
-    auto initFunction = [this, node]() {
+    // The trace outlives the initialization of all nodes that are added while the assets
+    // are loaded, so it is safe to use it on the worker thread
+    StartupTrace* trace = global::openSpaceEngine->startupTrace();
+
+    auto initFunction = [this, node, trace]() {
         LoadingScreen* loadingScreen = global::openSpaceEngine->loadingScreen();
 
         LoadingScreen::ProgressInfo progressInfo;
@@ -65,15 +77,22 @@ void MultiThreadedSceneInitializer::initializeNode(SceneGraphNode* node) {
             );
         }
 
+        if (trace) {
+            trace->beginNode(node->identifier(), StartupTrace::Phase::Initialize);
+        }
         try {
             node->initialize();
         }
         catch (const ghoul::RuntimeError& e) {
             LERRORC(e.component, e.message);
         }
+        if (trace) {
+            trace->endNode(node->identifier(), StartupTrace::Phase::Initialize);
+        }
         std::lock_guard g(_mutex);
         _initializedNodes.push_back(node);
         _initializingNodes.erase(node);
+        _nodeInitialized.notify_all();
 
         if (loadingScreen) {
             loadingScreen->updateItem(
@@ -108,11 +127,9 @@ std::vector<SceneGraphNode*> MultiThreadedSceneInitializer::takeInitializedNodes
     // Some of the scene graph nodes might still be in the initialization queue and we
     // should wait for those to finish or we end up in some half-initialized state since
     // other parts of the application already know about their existence
-    while (_threadPool.hasOutstandingTasks()) {
-        std::this_thread::sleep_for(std::chrono::milliseconds(1));
-    }
+    std::unique_lock lock(_mutex);
+    _nodeInitialized.wait(lock, [this]() { return _initializingNodes.empty(); });
 
-    std::lock_guard g(_mutex);
     std::vector<SceneGraphNode*> nodes = std::move(_initializedNodes);
     return nodes;
 }
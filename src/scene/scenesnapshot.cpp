@@ -0,0 +1,268 @@
+/*****************************************************************************************
+ *                                                                                       *
+ * OpenSpace                                                                             *
+ *                                                                                       *
+ * Copyright (c) 2014-2023                                                               *
+ *                                                                                       *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this  *
+ * software and associated documentation files (the "Software"), to deal in the Software *
+ * without restriction, including without limitation the rights to use, copy, modify,    *
+ * merge, publish, distribute, sublicense, and/or sell copies of the Software, and to    *
+ * permit persons to whom the Software is furnished to do so, subject to the following   *
+ * conditions:                                                                           *
+ *                                                                                       *
+ * The above copyright notice and this permission notice shall be included in all copies *
+ * or substantial portions of the Software.                                              *
+ *                                                                                       *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,   *
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A         *
+ * PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT    *
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF  *
+ * CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE  *
+ * OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                                         *
+ ****************************************************************************************/
+
+
+#include <openspace/scene/scenesnapshot.h>
+
+#include <openspace/json.h>
+#include <ghoul/fmt.h>
+#include <ghoul/logging/logmanager.h>
+#include <ghoul/misc/assert.h>
+#include <ghoul/misc/dictionary.h>
+#include <ghoul/misc/dictionaryluaformatter.h>
+#include <ghoul/misc/exception.h>
+#include <algorithm>
+#include <array>
+#include <fstream>
+
+namespace {
+    constexpr std::string_view _loggerCat = "SceneSnapshot";
+
+    // Increase this number whenever the layout of the snapshot file changes
+    constexpr int CurrentFormatVersion = 2;
+
+    // 64-bit FNV-1a hash. The hashes are only used to detect changes in files that we
+    // have written or read ourselves, so there is no need for a cryptographic hash
+    constexpr uint64_t FnvOffsetBasis = 14695981039346656037ull;
+    constexpr uint64_t FnvPrime = 1099511628211ull;
+
+    uint64_t hashBytes(const char* data, size_t size, uint64_t hash = FnvOffsetBasis) {
+        for (size_t i = 0; i < size; i++) {
+            hash ^= static_cast<unsigned char>(data[i]);
+            hash *= FnvPrime;
+        }
+        return hash;
+    }
+
+    std::string hashString(const std::string& s) {
+        return fmt::format("{:016x}", hashBytes(s.data(), s.size()));
+    }
+
+    std::optional<std::string> hashFile(const std::filesystem::path& path) {
+        std::ifstream file(path, std::ios::binary);
+        if (!file.good()) {
+            return std::nullopt;
+        }
+
+        uint64_t hash = FnvOffsetBasis;
+        std::array<char, 16384> buffer;
+        while (file) {
+            file.read(buffer.data(), buffer.size());
+            hash = hashBytes(buffer.data(), static_cast<size_t>(file.gcount()), hash);
+        }
+        return fmt::format("{:016x}", hash);
+    }
+
+    // Collects all string values of the dictionary that name an existing file or
+    // directory. Some of the verifiers test whether a file exists, so a dictionary only
+    // passes the same tests again as long as these files still exist
+    void collectFiles(const ghoul::Dictionary& dictionary,
+                      std::vector<std::filesystem::path>& files)
+    {
+        for (std::string_view key : dictionary.keys()) {
+            if (dictionary.hasValue<ghoul::Dictionary>(key)) {
+                collectFiles(dictionary.value<ghoul::Dictionary>(key), files);
+            }
+            else if (dictionary.hasValue<std::string>(key)) {
+                const std::string value = dictionary.value<std::string>(key);
+                if (value.find_first_of("/\\") == std::string::npos) {
+                    // Identifiers, names, and other strings that are not paths
+                    continue;
+                }
+                std::error_code ec;
+                if (std::filesystem::exists(value, ec)) {
+                    files.emplace_back(value);
+                }
+            }
+        }
+    }
+} // namespace
+
+namespace openspace {
+
+SceneSnapshot::SceneSnapshot(std::string version, const std::string& profile)
+    : _version(std::move(version))
+    , _profileHash(hashString(profile))
+{}
+
+std::optional<SceneSnapshot> SceneSnapshot::load(const std::filesystem::path& path) {
+    if (!std::filesystem::is_regular_file(path)) {
+        return std::nullopt;
+    }
+
+    try {
+        std::ifstream file(path);
+        const nlohmann::json json = nlohmann::json::parse(file);
+        if (json.at("format").get<int>() != CurrentFormatVersion) {
+            return std::nullopt;
+        }
+
+        SceneSnapshot snapshot;
+        snapshot._version = json.at("version").get<std::string>();
+        snapshot._profileHash = json.at("profile").get<std::string>();
+        for (const nlohmann::json& asset : json.at("assets")) {
+            snapshot._assets.push_back({
+                asset.at("path").get<std::string>(),
+                asset.at("hash").get<std::string>()
+            });
+        }
+        for (const nlohmann::json& node : json.at("nodes")) {
+            Node n;
+            n.identifier = node.at("identifier").get<std::string>();
+            n.hash = node.at("hash").get<std::string>();
+            for (const nlohmann::json& f : node.at("files")) {
+                n.files.emplace_back(f.get<std::string>());
+            }
+            snapshot._nodeIndices[n.hash] = snapshot._nodes.size();
+            snapshot._nodes.push_back(std::move(n));
+        }
+        return snapshot;
+    }
+    catch (const nlohmann::json::exception& e) {
+        LWARNING(fmt::format("Could not read scene snapshot {}: {}", path, e.what()));
+        return std::nullopt;
+    }
+}
+
+void SceneSnapshot::save(const std::filesystem::path& path) const {
+    nlohmann::json assets = nlohmann::json::array();
+    for (const Asset& asset : _assets) {
+        assets.push_back({
+            { "path", asset.path.string() },
+            { "hash", asset.hash }
+        });
+    }
+
+    nlohmann::json nodes = nlohmann::json::array();
+    for (const Node& node : _nodes) {
+        nlohmann::json files = nlohmann::json::array();
+        for (const std::filesystem::path& f : node.files) {
+            files.push_back(f.string());
+        }
+        nodes.push_back({
+            { "identifier", node.identifier },
+            { "hash", node.hash },
+            { "files", files }
+        });
+    }
+
+    const nlohmann::json json = {
+        { "format", CurrentFormatVersion },
+        { "version", _version },
+        { "profile", _profileHash },
+        { "assets", assets },
+        { "nodes", nodes }
+    };
+
+    // Write to a temporary file first so that an interrupted write does not leave a
+    // partial snapshot behind
+    std::filesystem::path tmp = path;
+    tmp += ".tmp";
+    {
+        std::ofstream file(tmp);
+        if (!file.good()) {
+            throw ghoul::RuntimeError(
+                fmt::format("Could not open file {} for writing", tmp),
+                "SceneSnapshot"
+            );
+        }
+        file << json.dump();
+    }
+    std::filesystem::rename(tmp, path);
+}
+
+void SceneSnapshot::addAsset(std::filesystem::path path) {
+    ghoul_precondition(std::filesystem::is_regular_file(path), "Asset must exist");
+
+    std::optional<std::string> hash = hashFile(path);
+    if (!hash.has_value()) {
+        throw ghoul::RuntimeError(
+            fmt::format("Could not read asset file {}", path),
+            "SceneSnapshot"
+        );
+    }
+    _assets.push_back({ std::move(path), std::move(*hash) });
+}
+
+void SceneSnapshot::addNode(const ghoul::Dictionary& dictionary) {
+    ghoul_precondition(
+        dictionary.hasValue<std::string>("Identifier"),
+        "Dictionary must contain an Identifier"
+    );
+
+    Node node;
+    node.identifier = dictionary.value<std::string>("Identifier");
+    node.hash = hashDictionary(dictionary);
+    collectFiles(dictionary, node.files);
+    _nodeIndices[node.hash] = _nodes.size();
+    _nodes.push_back(std::move(node));
+}
+
+bool SceneSnapshot::isUpToDate(const std::string& version,
+                               const std::string& profile) const
+{
+    if (_version != version || _profileHash != hashString(profile)) {
+        return false;
+    }
+
+    for (const Asset& asset : _assets) {
+        std::optional<std::string> hash = hashFile(asset.path);
+        if (!hash.has_value() || *hash != asset.hash) {
+            LDEBUG(fmt::format("Asset {} has changed since the snapshot", asset.path));
+            return false;
+        }
+    }
+    return true;
+}
+
+bool SceneSnapshot::containsNode(const ghoul::Dictionary& dictionary) const {
+    const auto it = _nodeIndices.find(hashDictionary(dictionary));
+    if (it == _nodeIndices.end()) {
+        return false;
+    }
+
+    const Node& node = _nodes[it->second];
+    return std::all_of(
+        node.files.begin(),
+        node.files.end(),
+        [](const std::filesystem::path& f) {
+            std::error_code ec;
+            return std::filesystem::exists(f, ec);
+        }
+    );
+}
+
+const std::vector<SceneSnapshot::Asset>& SceneSnapshot::assets() const {
+    return _assets;
+}
+
+const std::vector<SceneSnapshot::Node>& SceneSnapshot::nodes() const {
+    return _nodes;
+}
+
+std::string SceneSnapshot::hashDictionary(const ghoul::Dictionary& dictionary) {
+    return hashString(ghoul::formatLua(dictionary));
+}
+
+} // namespace openspace
@@ -87,6 +87,10 @@ glm::dvec3 Translation::position() const {
     return _cachedPosition;
 }
 
+bool Translation::isThreadSafe() const {
+    return false;
+}
+
 void Translation::notifyObservers() const {
     if (_onParameterChangeCallback) {
         _onParameterChangeCallback();
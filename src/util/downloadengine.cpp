@@ -0,0 +1,646 @@
+/*****************************************************************************************
+ *                                                                                       *
+ * OpenSpace                                                                             *
+ *                                                                                       *
+ * Copyright (c) 2014-2023                                                               *
+ *                                                                                       *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this  *
+ * software and associated documentation files (the "Software"), to deal in the Software *
+ * without restriction, including without limitation the rights to use, copy, modify,    *
+ * merge, publish, distribute, sublicense, and/or sell copies of the Software, and to    *
+ * permit persons to whom the Software is furnished to do so, subject to the following   *
+ * conditions:                                                                           *
+ *                                                                                       *
+ * The above copyright notice and this permission notice shall be included in all copies *
+ * or substantial portions of the Software.                                              *
+ *                                                                                       *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,   *
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A         *
+ * PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT    *
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF  *
+ * CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE  *
+ * OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                                         *
+ ****************************************************************************************/
+
+
+#include <openspace/util/downloadengine.h>
+
+#include <ghoul/fmt.h>
+#include <ghoul/logging/logmanager.h>
+#include <ghoul/misc/assert.h>
+#include <curl/curl.h>
+#include <algorithm>
+
+namespace {
+    constexpr std::string_view _loggerCat = "DownloadEngine";
+
+    // The maximum number of bytes of an error response that are kept for the log
+    constexpr size_t MaxErrorBodySize = 1024;
+
+    // The maximum time in milliseconds the event thread waits for socket activity before
+    // checking for retries that are due. New transfers wake up the thread immediately if
+    // curl_multi_wakeup is available
+    constexpr int PollTimeout = 50;
+
+    bool isRetryable(CURLcode code) {
+        switch (code) {
+            case CURLE_COULDNT_CONNECT:
+            case CURLE_OPERATION_TIMEDOUT:
+            case CURLE_SEND_ERROR:
+            case CURLE_RECV_ERROR:
+            case CURLE_PARTIAL_FILE:
+            case CURLE_GOT_NOTHING:
+            case CURLE_SSL_CONNECT_ERROR:
+            case CURLE_HTTP2:
+                return true;
+            default:
+                return false;
+        }
+    }
+
+    bool isRetryable(long responseCode) {
+        switch (responseCode) {
+            case 408: // Request Timeout
+            case 429: // Too Many Requests
+            case 500: // Internal Server Error
+            case 502: // Bad Gateway
+            case 503: // Service Unavailable
+            case 504: // Gateway Timeout
+                return true;
+            default:
+                return false;
+        }
+    }
+} // namespace
+
+namespace openspace {
+
+struct DownloadEngine::State {
+    TransferId id = 0;
+    Transfer transfer;
+    CURL* handle = nullptr;
+
+    int nAttempts = 0;
+    std::chrono::steady_clock::time_point retryTime;
+
+    // The number of bytes that have been passed to the onData callback in all attempts
+    size_t nDelivered = 0;
+
+    // The first byte that was requested in the current attempt
+    size_t resumeOffset = 0;
+
+    // The number of bytes at the beginning of the current response that were already
+    // delivered in a previous attempt and have to be skipped
+    size_t nSkip = 0;
+
+    bool isFirstWrite = true;
+    long responseCode = 0;
+
+    // Is set when one of the callbacks requested the transfer to be aborted
+    bool isAborted = false;
+
+    std::string errorBody;
+};
+
+DownloadEngine* DownloadEngine::_instance = nullptr;
+
+void DownloadEngine::initialize() {
+    ghoul_assert(!isInitialized(), "DownloadEngine is already initialized");
+    _instance = new DownloadEngine;
+}
+
+void DownloadEngine::deinitialize() {
+    ghoul_assert(isInitialized(), "DownloadEngine is not initialized");
+    delete _instance;
+    _instance = nullptr;
+}
+
+bool DownloadEngine::isInitialized() {
+    return _instance != nullptr;
+}
+
+DownloadEngine& DownloadEngine::shared() {
+    ghoul_assert(isInitialized(), "DownloadEngine is not initialized");
+    return *_instance;
+}
+
+DownloadEngine::DownloadEngine() : DownloadEngine(Settings()) {}
+
+DownloadEngine::DownloadEngine(Settings settings)
+    : _settings(std::move(settings))
+{
+    ghoul_assert(_settings.maxActiveTransfers > 0, "Must allow at least one transfer");
+    ghoul_assert(_settings.maxConnectionsPerHost > 0, "Must allow one connection");
+
+    curl_global_init(CURL_GLOBAL_ALL);
+
+    CURLM* multi = curl_multi_init();
+    curl_multi_setopt(
+        multi,
+        CURLMOPT_MAX_TOTAL_CONNECTIONS,
+        static_cast<long>(_settings.maxActiveTransfers)
+    );
+    curl_multi_setopt(
+        multi,
+        CURLMOPT_MAX_HOST_CONNECTIONS,
+        static_cast<long>(_settings.maxConnectionsPerHost)
+    );
+#ifdef CURLPIPE_MULTIPLEX
+    curl_multi_setopt(multi, CURLMOPT_PIPELINING, CURLPIPE_MULTIPLEX);
+#endif // CURLPIPE_MULTIPLEX
+    _multiHandle = multi;
+
+    _thread = std::thread([this]() { run(); });
+}
+
+DownloadEngine::~DownloadEngine() {
+    {
+        std::lock_guard lock(_mutex);
+        _shouldStop = true;
+    }
+    _condition.notify_one();
+#if LIBCURL_VERSION_NUM >= 0x074400
+    curl_multi_wakeup(_multiHandle);
+#endif
+    if (_thread.joinable()) {
+        _thread.join();
+    }
+
+    curl_multi_cleanup(_multiHandle);
+    curl_global_cleanup();
+}
+
+DownloadEngine::TransferId DownloadEngine::enqueue(Transfer transfer) {
+    ghoul_assert(!transfer.url.empty(), "URL must not be empty");
+
+    auto state = std::make_unique<State>();
+    state->transfer = std::move(transfer);
+
+    TransferId id = 0;
+    {
+        std::lock_guard lock(_mutex);
+        id = _nextId++;
+        state->id = id;
+        const size_t queue = static_cast<size_t>(state->transfer.priority);
+        _queued[queue].push_back(std::move(state));
+        _statistics.nQueued++;
+    }
+    _condition.notify_one();
+#if LIBCURL_VERSION_NUM >= 0x074400
+    curl_multi_wakeup(_multiHandle);
+#endif
+    return id;
+}
+
+void DownloadEngine::cancel(TransferId id) {
+    std::unique_ptr<State> state;
+    {
+        std::lock_guard lock(_mutex);
+        auto matches = [id](const std::unique_ptr<State>& s) { return s->id == id; };
+        for (std::deque<std::unique_ptr<State>>& queue : _queued) {
+            auto it = std::find_if(queue.begin(), queue.end(), matches);
+            if (it != queue.end()) {
+                state = std::move(*it);
+                queue.erase(it);
+                _statistics.nQueued--;
+                break;
+            }
+        }
+        if (!state) {
+            auto it = std::find_if(_retrying.begin(), _retrying.end(), matches);
+            if (it != _retrying.end()) {
+                state = std::move(*it);
+                _retrying.erase(it);
+            }
+        }
+        if (state) {
+            _statistics.nFailed++;
+        }
+        else {
+            // The transfer is either active, in which case only the event thread is
+            // allowed to remove its handle, or it has already finished. Unknown ids are
+            // ignored by the event thread
+            _cancelled.push_back(id);
+        }
+    }
+
+    if (!state) {
+#if LIBCURL_VERSION_NUM >= 0x074400
+        curl_multi_wakeup(_multiHandle);
+#endif
+        return;
+    }
+
+    if (state->transfer.onFinish) {
+        Result result;
+        result.error = "Cancelled";
+        state->transfer.onFinish(result);
+    }
+}
+
+DownloadEngine::Statistics DownloadEngine::statistics() const {
+    std::lock_guard lock(_mutex);
+    return _statistics;
+}
+
+bool DownloadEngine::isEventThread() const {
+    return std::this_thread::get_id() == _thread.get_id();
+}
+
+void DownloadEngine::run() {
+    CURLM* multi = _multiHandle;
+
+    while (true) {
+        {
+            std::unique_lock lock(_mutex);
+            if (_shouldStop) {
+                break;
+            }
+            if (_active.empty() && _queued[0].empty() && _queued[1].empty()) {
+                // Nothing to do until a new transfer is queued or a retry is due
+                auto hasWork = [this]() {
+                    return _shouldStop || !_queued[0].empty() || !_queued[1].empty();
+                };
+                if (_retrying.empty()) {
+                    _condition.wait(lock, hasWork);
+                }
+                else {
+                    auto next = std::min_element(
+                        _retrying.begin(),
+                        _retrying.end(),
+                        [](const std::unique_ptr<State>& a,
+                           const std::unique_ptr<State>& b)
+                        {
+                            return a->retryTime < b->retryTime;
+                        }
+                    );
+                    _condition.wait_until(lock, (*next)->retryTime, hasWork);
+                }
+                if (_shouldStop) {
+                    break;
+                }
+            }
+        }
+
+        startTransfers();
+        // All finished transfers have been read in the previous iteration, so the
+        // handles of cancelled transfers can be removed without losing any messages
+        cancelTransfers();
+
+        int nRunning = 0;
+        curl_multi_perform(multi, &nRunning);
+
+        int nMessages = 0;
+        while (CURLMsg* msg = curl_multi_info_read(multi, &nMessages)) {
+            if (msg->msg != CURLMSG_DONE) {
+                continue;
+            }
+
+            std::unique_ptr<State> state;
+            {
+                std::lock_guard lock(_mutex);
+                auto it = std::find_if(
+                    _active.begin(),
+                    _active.end(),
+                    [h = msg->easy_handle](const std::unique_ptr<State>& s) {
+                        return s->handle == h;
+                    }
+                );
+                ghoul_assert(it != _active.end(), "Finished transfer must be active");
+                state = std::move(*it);
+                _active.erase(it);
+            }
+            // The message is invalidated when the handle is removed
+            const CURLcode result = msg->data.result;
+            curl_multi_remove_handle(multi, state->handle);
+            finishTransfer(std::move(state), result);
+        }
+
+        bool hasActive = false;
+        {
+            std::lock_guard lock(_mutex);
+            hasActive = !_active.empty();
+        }
+        if (hasActive) {
+#if LIBCURL_VERSION_NUM >= 0x074400
+            curl_multi_poll(multi, nullptr, 0, PollTimeout, nullptr);
+#else // ^^^ LIBCURL_VERSION_NUM >= 0x074400 / LIBCURL_VERSION_NUM < 0x074400 vvv
+            curl_multi_wait(multi, nullptr, 0, PollTimeout, nullptr);
+#endif // LIBCURL_VERSION_NUM >= 0x074400
+        }
+    }
+
+    // Abort everything that is still ongoing or waiting
+    std::vector<std::unique_ptr<State>> remaining;
+    {
+        std::lock_guard lock(_mutex);
+        for (std::unique_ptr<State>& state : _active) {
+            curl_multi_remove_handle(multi, state->handle);
+            curl_easy_cleanup(state->handle);
+            state->handle = nullptr;
+            remaining.push_back(std::move(state));
+        }
+        _active.clear();
+        for (std::deque<std::unique_ptr<State>>& queue : _queued) {
+            std::move(queue.begin(), queue.end(), std::back_inserter(remaining));
+            queue.clear();
+        }
+        std::move(_retrying.begin(), _retrying.end(), std::back_inserter(remaining));
+        _retrying.clear();
+    }
+    for (std::unique_ptr<State>& state : remaining) {
+        if (state->transfer.onFinish) {
+            Result result;
+            result.error = "Download engine was shut down";
+            state->transfer.onFinish(result);
+        }
+    }
+}
+
+void DownloadEngine::cancelTransfers() {
+    std::vector<std::unique_ptr<State>> cancelled;
+    {
+        std::lock_guard lock(_mutex);
+        for (TransferId id : _cancelled) {
+            auto it = std::find_if(
+                _active.begin(),
+                _active.end(),
+                [id](const std::unique_ptr<State>& s) { return s->id == id; }
+            );
+            if (it != _active.end()) {
+                cancelled.push_back(std::move(*it));
+                _active.erase(it);
+                _statistics.nFailed++;
+            }
+        }
+        _cancelled.clear();
+        _statistics.nActive = _active.size();
+    }
+
+    for (std::unique_ptr<State>& state : cancelled) {
+        curl_multi_remove_handle(_multiHandle, state->handle);
+        curl_easy_cleanup(state->handle);
+        state->handle = nullptr;
+        if (state->transfer.onFinish) {
+            Result result;
+            result.error = "Cancelled";
+            state->transfer.onFinish(result);
+        }
+    }
+}
+
+void DownloadEngine::startTransfers() {
+    std::vector<std::unique_ptr<State>> starting;
+    {
+        std::lock_guard lock(_mutex);
+
+        // Retries that are due are placed at the front of their queue
+        const auto now = std::chrono::steady_clock::now();
+        for (auto it = _retrying.begin(); it != _retrying.end();) {
+            if ((*it)->retryTime <= now) {
+                const size_t queue = static_cast<size_t>((*it)->transfer.priority);
+                _queued[queue].push_front(std::move(*it));
+                _statistics.nQueued++;
+                it = _retrying.erase(it);
+            }
+            else {
+                it++;
+            }
+        }
+
+        size_t nAvailable = _settings.maxActiveTransfers - _active.size();
+        for (std::deque<std::unique_ptr<State>>& queue : _queued) {
+            while (nAvailable > 0 && !queue.empty()) {
+                starting.push_back(std::move(queue.front()));
+                queue.pop_front();
+                _statistics.nQueued--;
+                nAvailable--;
+            }
+        }
+    }
+
+    for (std::unique_ptr<State>& state : starting) {
+        Transfer& t = state->transfer;
+
+        if (state->nAttempts == 0 && t.onStart && !t.onStart()) {
+            {
+                std::lock_guard lock(_mutex);
+                _statistics.nFailed++;
+            }
+            Result result;
+            result.error = "Transfer setup failed";
+            if (t.onFinish) {
+                t.onFinish(result);
+            }
+            continue;
+        }
+
+        state->nAttempts++;
+        state->resumeOffset = state->nDelivered;
+        state->nSkip = 0;
+        state->isFirstWrite = true;
+        state->responseCode = 0;
+        state->errorBody.clear();
+
+        CURL* curl = curl_easy_init();
+        state->handle = curl;
+        curl_easy_setopt(curl, CURLOPT_URL, t.url.c_str());
+        curl_easy_setopt(curl, CURLOPT_USERAGENT, "OpenSpace");
+        curl_easy_setopt(curl, CURLOPT_FOLLOWLOCATION, 1L);
+        curl_easy_setopt(curl, CURLOPT_NOSIGNAL, 1L);
+        curl_easy_setopt(curl, CURLOPT_TCP_KEEPALIVE, 1L);
+        curl_easy_setopt(curl, CURLOPT_TIMEOUT_MS, static_cast<long>(t.timeout.count()));
+#if LIBCURL_VERSION_NUM >= 0x072B00
+        // Prefer waiting for an existing connection that can be multiplexed over opening
+        // a new one
+        curl_easy_setopt(curl, CURLOPT_PIPEWAIT, 1L);
+#endif // LIBCURL_VERSION_NUM >= 0x072B00
+#if LIBCURL_VERSION_NUM >= 0x072F00
+        curl_easy_setopt(curl, CURLOPT_HTTP_VERSION, CURL_HTTP_VERSION_2TLS);
+#endif // LIBCURL_VERSION_NUM >= 0x072F00
+        if (!t.verifyPeer) {
+            curl_easy_setopt(curl, CURLOPT_SSL_VERIFYPEER, 0L);
+        }
+        if (t.headersOnly) {
+            curl_easy_setopt(curl, CURLOPT_NOBODY, 1L);
+        }
+        if (state->resumeOffset > 0) {
+            // CURLOPT_RESUME_FROM would fail the transfer if the server does not support
+            // range requests, but the full body can still be used by skipping the bytes
+            // that have already been delivered
+            const std::string range = fmt::format("{}-", state->resumeOffset);
+            curl_easy_setopt(curl, CURLOPT_RANGE, range.c_str());
+        }
+
+        // The leading + in all of the lambda expressions are to cause an implicit
+        // conversion to a standard C function pointer (see HttpRequest::perform)
+
+        curl_easy_setopt(curl, CURLOPT_HEADERDATA, state.get());
+        curl_easy_setopt(
+            curl,
+            CURLOPT_HEADERFUNCTION,
+            +[](char* ptr, size_t size, size_t nmemb, void* userData) {
+                State* s = reinterpret_cast<State*>(userData);
+                // Headers are only reported for the first attempt
+                if (s->nAttempts > 1 || !s->transfer.onHeader) {
+                    return size * nmemb;
+                }
+                if (!s->transfer.onHeader(ptr, size * nmemb)) {
+                    s->isAborted = true;
+                    return size_t(0);
+                }
+                return size * nmemb;
+            }
+        );
+
+        curl_easy_setopt(curl, CURLOPT_WRITEDATA, state.get());
+        curl_easy_setopt(
+            curl,
+            CURLOPT_WRITEFUNCTION,
+            +[](char* ptr, size_t size, size_t nmemb, void* userData) {
+                State* s = reinterpret_cast<State*>(userData);
+                const size_t n = size * nmemb;
+
+                if (s->isFirstWrite) {
+                    s->isFirstWrite = false;
+                    curl_easy_getinfo(
+                        s->handle,
+                        CURLINFO_RESPONSE_CODE,
+                        &s->responseCode
+                    );
+                    if (s->resumeOffset > 0 && s->responseCode == 200) {
+                        // The server ignored the range request and sends the full body
+                        s->nSkip = s->resumeOffset;
+                    }
+                }
+
+                if (s->responseCode >= 400 && s->transfer.failOnHttpError) {
+                    const size_t nKeep = std::min(
+                        n,
+                        MaxErrorBodySize - std::min(MaxErrorBodySize, s->errorBody.size())
+                    );
+                    s->errorBody.append(ptr, nKeep);
+                    return n;
+                }
+
+                size_t skip = std::min(s->nSkip, n);
+                s->nSkip -= skip;
+                if (skip == n) {
+                    return n;
+                }
+
+                if (s->transfer.onData && !s->transfer.onData(ptr + skip, n - skip)) {
+                    s->isAborted = true;
+                    return size_t(0);
+                }
+                s->nDelivered += n - skip;
+                return n;
+            }
+        );
+
+        curl_easy_setopt(curl, CURLOPT_NOPROGRESS, 0L);
+        curl_easy_setopt(curl, CURLOPT_XFERINFODATA, state.get());
+        curl_easy_setopt(
+            curl,
+            CURLOPT_XFERINFOFUNCTION,
+            +[](void* userData, curl_off_t nTotalBytes, curl_off_t, curl_off_t,
+                curl_off_t)
+            {
+                State* s = reinterpret_cast<State*>(userData);
+                if (!s->transfer.onProgress) {
+                    return 0;
+                }
+
+                std::optional<size_t> totalBytes;
+                if (nTotalBytes > 0) {
+                    // For a resumed transfer, the total only covers the remaining bytes
+                    const size_t offset = s->responseCode == 206 ? s->resumeOffset : 0;
+                    totalBytes = static_cast<size_t>(nTotalBytes) + offset;
+                }
+                if (!s->transfer.onProgress(s->nDelivered, totalBytes)) {
+                    s->isAborted = true;
+                    return 1;
+                }
+                return 0;
+            }
+        );
+
+        curl_easy_setopt(curl, CURLOPT_PRIVATE, state.get());
+
+        {
+            std::lock_guard lock(_mutex);
+            _active.push_back(std::move(state));
+            _statistics.nActive = _active.size();
+            _statistics.peakActive = std::max(_statistics.peakActive, _active.size());
+        }
+        curl_multi_add_handle(_multiHandle, curl);
+    }
+}
+
+void DownloadEngine::finishTransfer(std::unique_ptr<State> state, int curlCode) {
+    const CURLcode code = static_cast<CURLcode>(curlCode);
+    Transfer& t = state->transfer;
+
+    Result result;
+    curl_easy_getinfo(state->handle, CURLINFO_RESPONSE_CODE, &result.responseCode);
+    char* contentType = nullptr;
+    curl_easy_getinfo(state->handle, CURLINFO_CONTENT_TYPE, &contentType);
+    if (contentType) {
+        result.contentType = contentType;
+    }
+    curl_easy_cleanup(state->handle);
+    state->handle = nullptr;
+
+    result.success =
+        (code == CURLE_OK) && (result.responseCode < 400 || !t.failOnHttpError);
+    if (!result.success) {
+        result.error = (code == CURLE_OK) ?
+            fmt::format("HTTP code {}", result.responseCode) :
+            curl_easy_strerror(code);
+    }
+
+    const bool shouldRetry =
+        !result.success && !state->isAborted &&
+        state->nAttempts <= _settings.maxRetries &&
+        ((code == CURLE_OK) ? isRetryable(result.responseCode) : isRetryable(code));
+
+    {
+        std::lock_guard lock(_mutex);
+        _statistics.nActive = _active.size();
+        _statistics.nBytes += state->nDelivered - state->resumeOffset;
+
+        if (shouldRetry) {
+            const auto delay = _settings.retryDelay * (1 << (state->nAttempts - 1));
+            LDEBUG(fmt::format(
+                "Retrying download {} in {} ms ({}). {} bytes were already received",
+                t.url, delay.count(), result.error, state->nDelivered
+            ));
+            state->retryTime = std::chrono::steady_clock::now() + delay;
+            _retrying.push_back(std::move(state));
+            _statistics.nRetries++;
+            return;
+        }
+
+        if (result.success) {
+            _statistics.nSucceeded++;
+        }
+        else {
+            _statistics.nFailed++;
+        }
+    }
+
+    if (!result.success) {
+        if (!state->isAborted) {
+            LERROR(fmt::format("Failed download {} with error {}", t.url, result.error));
+            if (!state->errorBody.empty()) {
+                LDEBUG(state->errorBody);
+            }
+        }
+    }
+
+    if (t.onFinish) {
+        t.onFinish(result);
+    }
+}
+
+} // namespace openspace
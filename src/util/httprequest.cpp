@@ -28,6 +28,7 @@
 #include <ghoul/filesystem/file.h>
 #include <ghoul/filesystem/filesystem.h>
 #include <ghoul/logging/logmanager.h>
+#include <ghoul/misc/assert.h>
 #include <curl/curl.h>
 #include <filesystem>
 
@@ -149,18 +150,9 @@ const std::string& HttpRequest::url() const {
 
 
 HttpDownload::HttpDownload(std::string url)
-    : _httpRequest(std::move(url))
+    : _url(std::move(url))
 {
-    _httpRequest.onData([this](char* buffer, size_t size) {
-        return handleData(buffer, size) && !_shouldCancel;
-    });
-
-    _httpRequest.onProgress(
-        [this](int64_t downloadedBytes, std::optional<int64_t> totalBytes) {
-            bool cont = _onProgress ? _onProgress(downloadedBytes, totalBytes) : true;
-            return cont && !_shouldCancel;
-        }
-    );
+    ghoul_assert(!_url.empty(), "url must not be empty");
 }
 
 HttpDownload::~HttpDownload() {
@@ -172,6 +164,10 @@ void HttpDownload::onProgress(HttpRequest::ProgressCallback progressCallback) {
     _onProgress = std::move(progressCallback);
 }
 
+void HttpDownload::setPriority(DownloadEngine::Priority priority) {
+    _priority = priority;
+}
+
 bool HttpDownload::hasFailed() const {
     return _isFinished && !_isSuccessful;
 }
@@ -181,60 +177,90 @@ bool HttpDownload::hasSucceeded() const {
 }
 
 void HttpDownload::start(std::chrono::milliseconds timeout) {
+    std::lock_guard lock(_mutex);
     if (_isDownloading) {
         return;
     }
     _isDownloading = true;
-    _downloadThread = std::thread([this, timeout]() {
-        _isFinished = false;
-        LTRACEC("HttpDownload", fmt::format("Start download '{}'", _httpRequest.url()));
-
-        const bool setupSuccess = setup();
-        if (setupSuccess) {
-            _isSuccessful = _httpRequest.perform(timeout);
-
+    _isFinished = false;
+    _isSetUp = false;
+    _shouldCancel = false;
+    LTRACEC("HttpDownload", fmt::format("Start download '{}'", _url));
+
+    DownloadEngine::Transfer transfer;
+    transfer.url = _url;
+    transfer.priority = _priority;
+    transfer.timeout = timeout;
+    transfer.onStart = [this]() {
+        _isSetUp = setup();
+        return _isSetUp;
+    };
+    transfer.onData = [this](char* buffer, size_t size) {
+        return handleData(buffer, size) && !_shouldCancel;
+    };
+    transfer.onProgress =
+        [this](size_t downloadedBytes, std::optional<size_t> totalBytes) {
+            bool cont = _onProgress ? _onProgress(downloadedBytes, totalBytes) : true;
+            return cont && !_shouldCancel;
+        };
+    transfer.onFinish = [this](const DownloadEngine::Result& result) {
+        bool success = result.success;
+        if (_isSetUp) {
             const bool teardownSuccess = teardown();
-            _isSuccessful = _isSuccessful && teardownSuccess;
-        }
-        else {
-            _isSuccessful = false;
+            success = success && teardownSuccess;
         }
+        finish(success);
+    };
+    _transferId = DownloadEngine::shared().enqueue(std::move(transfer));
+}
 
-        _isFinished = true;
-        if (_isSuccessful) {
-            LTRACEC(
-                "HttpDownload",
-                fmt::format("Finished async download '{}'", _httpRequest.url())
-            );
-        }
-        else {
-            LTRACEC(
-                "HttpDownload",
-                fmt::format("Failed async download '{}'", _httpRequest.url())
-            );
-        }
+void HttpDownload::finish(bool success) {
+    if (success) {
+        LTRACEC("HttpDownload", fmt::format("Finished async download '{}'", _url));
+    }
+    else {
+        LTRACEC("HttpDownload", fmt::format("Failed async download '{}'", _url));
+    }
 
-        _downloadFinishCondition.notify_all();
-        _isDownloading = false;
-    });
+    // The notification has to happen while holding the lock as a waiting thread is
+    // allowed to destroy this object as soon as it can observe the finished download
+    std::lock_guard lock(_mutex);
+    _isSuccessful = success;
+    _isFinished = true;
+    _isDownloading = false;
+    _transferId = std::nullopt;
+    _downloadFinishCondition.notify_all();
 }
 
 void HttpDownload::cancel() {
     _shouldCancel = true;
+
+    std::optional<DownloadEngine::TransferId> id;
+    {
+        std::lock_guard lock(_mutex);
+        id = _transferId;
+    }
+    // Downloads that are still queued are removed right away, which will call the finish
+    // function on this thread. Active transfers are removed by the event thread of the
+    // engine, which calls the finish function once the transfer has been stopped
+    if (id.has_value()) {
+        DownloadEngine::shared().cancel(*id);
+    }
 }
 
 bool HttpDownload::wait() {
-    std::mutex conditionMutex;
-    std::unique_lock lock(conditionMutex);
-    _downloadFinishCondition.wait(lock, [this]() { return _isFinished; });
-    if (_downloadThread.joinable()) {
-        _downloadThread.join();
-    }
+    ghoul_assert(
+        !DownloadEngine::isInitialized() || !DownloadEngine::shared().isEventThread(),
+        "Waiting for a download in a download callback would never return"
+    );
+
+    std::unique_lock lock(_mutex);
+    _downloadFinishCondition.wait(lock, [this]() { return !_isDownloading; });
     return _isSuccessful;
 }
 
 const std::string& HttpDownload::url() const {
-    return _httpRequest.url();
+    return _url;
 }
 
 bool HttpDownload::setup() {
@@ -247,7 +273,6 @@ bool HttpDownload::teardown() {
 
 
 
-std::atomic_int HttpFileDownload::nCurrentFileHandles = 0;
 std::mutex HttpFileDownload::_directoryCreationMutex;
 
 HttpFileDownload::HttpFileDownload(std::string url, std::filesystem::path destination,
@@ -269,11 +294,6 @@ bool HttpFileDownload::setup() {
         }
     }
 
-    while (nCurrentFileHandles >= MaxFileHandles) {
-        std::this_thread::sleep_for(std::chrono::milliseconds(50));
-    }
-
-    nCurrentFileHandles++;
     _hasHandle = true;
     _file = std::ofstream(_destination, std::ofstream::binary);
 
@@ -343,8 +363,6 @@ bool HttpFileDownload::teardown() {
     if (_hasHandle) {
         _hasHandle = false;
         _file.close();
-        nCurrentFileHandles--;
-        ghoul_assert(nCurrentFileHandles >= 0, "More handles returned than taken out");
         return _file.good();
     }
     else {
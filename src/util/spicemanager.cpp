@@ -202,6 +202,7 @@ void throwSpiceError(const std::string& errorMessage) {
 }
 
 SpiceManager::KernelHandle SpiceManager::loadKernel(std::string filePath) {
+    std::lock_guard lock(_mutex);
     ghoul_assert(!filePath.empty(), "Empty file path");
     ghoul_assert(
         std::filesystem::is_regular_file(filePath),
@@ -261,6 +262,7 @@ SpiceManager::KernelHandle SpiceManager::loadKernel(std::string filePath) {
 }
 
 void SpiceManager::unloadKernel(KernelHandle kernelId) {
+    std::lock_guard lock(_mutex);
     ghoul_assert(kernelId <= _lastAssignedKernel, "Invalid unassigned kernel");
     ghoul_assert(kernelId != KernelHandle(0), "Invalid zero handle");
 
@@ -287,6 +289,7 @@ void SpiceManager::unloadKernel(KernelHandle kernelId) {
 }
 
 void SpiceManager::unloadKernel(std::string filePath) {
+    std::lock_guard lock(_mutex);
     ghoul_assert(!filePath.empty(), "Empty filename");
 
     std::filesystem::path path = absPath(std::move(filePath));
@@ -322,7 +325,19 @@ void SpiceManager::unloadKernel(std::string filePath) {
     }
 }
 
+std::vector<std::filesystem::path> SpiceManager::loadedKernels() const {
+    std::lock_guard lock(_mutex);
+
+    std::vector<std::filesystem::path> res;
+    res.reserve(_loadedKernels.size());
+    for (const KernelInformation& info : _loadedKernels) {
+        res.emplace_back(info.path);
+    }
+    return res;
+}
+
 bool SpiceManager::hasSpkCoverage(const std::string& target, double et) const {
+    std::lock_guard lock(_mutex);
     ghoul_assert(!target.empty(), "Empty target");
 
     const int id = naifId(target);
@@ -346,6 +361,7 @@ bool SpiceManager::hasSpkCoverage(const std::string& target, double et) const {
 std::vector<std::pair<double, double>> SpiceManager::spkCoverage(
                                                           const std::string& target) const
 {
+    std::lock_guard lock(_mutex);
     ghoul_assert(!target.empty(), "Empty target");
 
     const int id = naifId(target);
@@ -361,6 +377,7 @@ std::vector<std::pair<double, double>> SpiceManager::spkCoverage(
 
 
 bool SpiceManager::hasCkCoverage(const std::string& frame, double et) const {
+    std::lock_guard lock(_mutex);
     ghoul_assert(!frame.empty(), "Empty target");
 
     const int id = frameId(frame);
@@ -379,6 +396,7 @@ bool SpiceManager::hasCkCoverage(const std::string& frame, double et) const {
 std::vector<std::pair<double, double>> SpiceManager::ckCoverage(
                                                           const std::string& target) const
 {
+    std::lock_guard lock(_mutex);
     ghoul_assert(!target.empty(), "Empty target");
 
     int id = naifId(target);
@@ -402,6 +420,7 @@ std::vector<std::pair<double, double>> SpiceManager::ckCoverage(
 std::vector<std::pair<int, std::string>> SpiceManager::spiceBodies(
                                                                  bool builtInFrames) const
 {
+    std::lock_guard lock(_mutex);
     std::vector<std::pair<int, std::string>> bodies;
 
     constexpr int Frnmln = 33;
@@ -456,10 +475,12 @@ std::vector<std::pair<int, std::string>> SpiceManager::spiceBodies(
 }
 
 bool SpiceManager::hasValue(int naifId, const std::string& item) const {
+    std::lock_guard lock(_mutex);
     return bodfnd_c(naifId, item.c_str());
 }
 
 bool SpiceManager::hasValue(const std::string& body, const std::string& item) const {
+    std::lock_guard lock(_mutex);
     ghoul_assert(!body.empty(), "Empty body");
     ghoul_assert(!item.empty(), "Empty item");
 
@@ -468,6 +489,7 @@ bool SpiceManager::hasValue(const std::string& body, const std::string& item) co
 }
 
 int SpiceManager::naifId(const std::string& body) const {
+    std::lock_guard lock(_mutex);
     ghoul_assert(!body.empty(), "Empty body");
 
     SpiceBoolean success;
@@ -480,6 +502,7 @@ int SpiceManager::naifId(const std::string& body) const {
 }
 
 bool SpiceManager::hasNaifId(const std::string& body) const {
+    std::lock_guard lock(_mutex);
     ghoul_assert(!body.empty(), "Empty body");
 
     SpiceBoolean success;
@@ -490,6 +513,7 @@ bool SpiceManager::hasNaifId(const std::string& body) const {
 }
 
 int SpiceManager::frameId(const std::string& frame) const {
+    std::lock_guard lock(_mutex);
     ghoul_assert(!frame.empty(), "Empty frame");
 
     SpiceInt id;
@@ -501,6 +525,7 @@ int SpiceManager::frameId(const std::string& frame) const {
 }
 
 bool SpiceManager::hasFrameId(const std::string& frame) const {
+    std::lock_guard lock(_mutex);
     ghoul_assert(!frame.empty(), "Empty frame");
 
     SpiceInt id;
@@ -528,36 +553,42 @@ void getValueInternal(const std::string& body, const std::string& value, int siz
 void SpiceManager::getValue(const std::string& body, const std::string& value,
                             double& v) const
 {
+    std::lock_guard lock(_mutex);
     getValueInternal(body, value, 1, &v);
 }
 
 void SpiceManager::getValue(const std::string& body, const std::string& value,
                             glm::dvec2& v) const
 {
+    std::lock_guard lock(_mutex);
     getValueInternal(body, value, 2, glm::value_ptr(v));
 }
 
 void SpiceManager::getValue(const std::string& body, const std::string& value,
                             glm::dvec3& v) const
 {
+    std::lock_guard lock(_mutex);
     getValueInternal(body, value, 3, glm::value_ptr(v));
 }
 
 void SpiceManager::getValue(const std::string& body, const std::string& value,
                             glm::dvec4& v) const
 {
+    std::lock_guard lock(_mutex);
     getValueInternal(body, value, 4, glm::value_ptr(v));
 }
 
 void SpiceManager::getValue(const std::string& body, const std::string& value,
                             std::vector<double>& v) const
 {
+    std::lock_guard lock(_mutex);
     ghoul_assert(!v.empty(), "Array for values has to be preallocaed");
 
     getValueInternal(body, value, static_cast<int>(v.size()), v.data());
 }
 
 double SpiceManager::spacecraftClockToET(const std::string& craft, double craftTicks) {
+    std::lock_guard lock(_mutex);
     ghoul_assert(!craft.empty(), "Empty craft");
 
     int craftId = naifId(craft);
@@ -572,12 +603,14 @@ double SpiceManager::spacecraftClockToET(const std::string& craft, double craftT
 }
 
 double SpiceManager::ephemerisTimeFromDate(const std::string& timeString) const {
+    std::lock_guard lock(_mutex);
     ghoul_assert(!timeString.empty(), "Empty timeString");
 
     return ephemerisTimeFromDate(timeString.c_str());
 }
 
 double SpiceManager::ephemerisTimeFromDate(const char* timeString) const {
+    std::lock_guard lock(_mutex);
     double et;
     str2et_c(timeString, &et);
     if (failed_c()) {
@@ -588,6 +621,7 @@ double SpiceManager::ephemerisTimeFromDate(const char* timeString) const {
 
 std::string SpiceManager::dateFromEphemerisTime(double ephemerisTime, const char* format)
 {
+    std::lock_guard lock(_mutex);
     constexpr int BufferSize = 128;
     char Buffer[BufferSize];
     std::memset(Buffer, char(0), BufferSize);
@@ -615,6 +649,7 @@ glm::dvec3 SpiceManager::targetPosition(const std::string& target,
                                         AberrationCorrection aberrationCorrection,
                                         double ephemerisTime, double& lightTime) const
 {
+    std::lock_guard lock(_mutex);
     ghoul_assert(!target.empty(), "Target is not empty");
     ghoul_assert(!observer.empty(), "Observer is not empty");
     ghoul_assert(!referenceFrame.empty(), "Reference frame is not empty");
@@ -683,6 +718,7 @@ glm::dvec3 SpiceManager::targetPosition(const std::string& target,
                                         AberrationCorrection aberrationCorrection,
                                         double ephemerisTime) const
 {
+    std::lock_guard lock(_mutex);
     double unused = 0.0;
     return targetPosition(
         target,
@@ -698,6 +734,7 @@ glm::dmat3 SpiceManager::frameTransformationMatrix(const std::string& from,
                                                    const std::string& to,
                                                    double ephemerisTime) const
 {
+    std::lock_guard lock(_mutex);
     ghoul_assert(!from.empty(), "From must not be empty");
     ghoul_assert(!to.empty(), "To must not be empty");
 
@@ -732,6 +769,7 @@ SpiceManager::SurfaceInterceptResult SpiceManager::surfaceIntercept(
                                                                      double ephemerisTime,
                                                   const glm::dvec3& directionVector) const
 {
+    std::lock_guard lock(_mutex);
     ghoul_assert(!target.empty(), "Target must not be empty");
     ghoul_assert(!observer.empty(), "Observer must not be empty");
     ghoul_assert(target != observer, "Target and observer must be different");
@@ -778,6 +816,7 @@ bool SpiceManager::isTargetInFieldOfView(const std::string& target,
                                          AberrationCorrection aberrationCorrection,
                                          double& ephemerisTime) const
 {
+    std::lock_guard lock(_mutex);
     ghoul_assert(!target.empty(), "Target must not be empty");
     ghoul_assert(!observer.empty(), "Observer must not be empty");
     ghoul_assert(target != observer, "Target and observer must be different");
@@ -811,6 +850,7 @@ SpiceManager::TargetStateResult SpiceManager::targetState(const std::string& tar
                                                 AberrationCorrection aberrationCorrection,
                                                                double ephemerisTime) const
 {
+    std::lock_guard lock(_mutex);
     ghoul_assert(!target.empty(), "Target must not be empty");
     ghoul_assert(!observer.empty(), "Observer must not be empty");
     ghoul_assert(!referenceFrame.empty(), "Reference frame must not be empty");
@@ -848,6 +888,7 @@ SpiceManager::TransformMatrix SpiceManager::stateTransformMatrix(
                                                       const std::string& destinationFrame,
                                                                double ephemerisTime) const
 {
+    std::lock_guard lock(_mutex);
     ghoul_assert(!sourceFrame.empty(), "sourceFrame must not be empty");
     ghoul_assert(!destinationFrame.empty(), "toFrame must not be empty");
 
@@ -872,6 +913,7 @@ glm::dmat3 SpiceManager::positionTransformMatrix(const std::string& sourceFrame,
                                                  const std::string& destinationFrame,
                                                  double ephemerisTime) const
 {
+    std::lock_guard lock(_mutex);
     ghoul_assert(!sourceFrame.empty(), "sourceFrame must not be empty");
     ghoul_assert(!destinationFrame.empty(), "destinationFrame must not be empty");
 
@@ -904,6 +946,7 @@ glm::dmat3 SpiceManager::positionTransformMatrix(const std::string& sourceFrame,
                                                  double ephemerisTimeFrom,
                                                  double ephemerisTimeTo) const
 {
+    std::lock_guard lock(_mutex);
     ghoul_assert(!sourceFrame.empty(), "sourceFrame must not be empty");
     ghoul_assert(!destinationFrame.empty(), "destinationFrame must not be empty");
 
@@ -934,6 +977,7 @@ SpiceManager::fieldOfView(const std::string& instrument) const
 }
 
 SpiceManager::FieldOfViewResult SpiceManager::fieldOfView(int instrument) const {
+    std::lock_guard lock(_mutex);
     constexpr int MaxBoundsSize = 64;
     constexpr int BufferSize = 128;
 
@@ -989,6 +1033,7 @@ SpiceManager::TerminatorEllipseResult SpiceManager::terminatorEllipse(
                                                                      double ephemerisTime,
                                                              int numberOfTerminatorPoints)
 {
+    std::lock_guard lock(_mutex);
     ghoul_assert(!target.empty(), "Target must not be empty");
     ghoul_assert(!observer.empty(), "Observer must not be empty");
     ghoul_assert(!frame.empty(), "Frame must not be empty");
@@ -1350,10 +1395,12 @@ glm::dmat3 SpiceManager::getEstimatedTransformMatrix(const std::string& fromFram
 }
 
 void SpiceManager::setExceptionHandling(UseException useException) {
+    std::lock_guard lock(_mutex);
     _useExceptions = useException;
 }
 
 SpiceManager::UseException SpiceManager::exceptionHandling() const {
+    std::lock_guard lock(_mutex);
     return _useExceptions;
 }
 
@@ -0,0 +1,292 @@
+/*****************************************************************************************
+ *                                                                                       *
+ * OpenSpace                                                                             *
+ *                                                                                       *
+ * Copyright (c) 2014-2023                                                               *
+ *                                                                                       *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this  *
+ * software and associated documentation files (the "Software"), to deal in the Software *
+ * without restriction, including without limitation the rights to use, copy, modify,    *
+ * merge, publish, distribute, sublicense, and/or sell copies of the Software, and to    *
+ * permit persons to whom the Software is furnished to do so, subject to the following   *
+ * conditions:                                                                           *
+ *                                                                                       *
+ * The above copyright notice and this permission notice shall be included in all copies *
+ * or substantial portions of the Software.                                              *
+ *                                                                                       *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,   *
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A         *
+ * PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT    *
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF  *
+ * CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE  *
+ * OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                                         *
+ ****************************************************************************************/
+
+
+#include <openspace/util/startuptrace.h>
+
+#include <openspace/json.h>
+#include <ghoul/fmt.h>
+#include <ghoul/misc/assert.h>
+#include <ghoul/misc/exception.h>
+#include <algorithm>
+#include <fstream>
+#include <set>
+
+namespace {
+    double toMicroseconds(openspace::StartupTrace::Clock::duration d) {
+        return std::chrono::duration<double, std::micro>(d).count();
+    }
+} // namespace
+
+namespace openspace {
+
+StartupTrace::StartupTrace()
+    : _start(Clock::now())
+{}
+
+StartupTrace::Item& StartupTrace::item(const std::string& identifier) {
+    auto it = _items.find(identifier);
+    if (it == _items.end()) {
+        Item i;
+        i.index = _items.size();
+        it = _items.emplace(identifier, std::move(i)).first;
+    }
+    return it->second;
+}
+
+void StartupTrace::begin(const std::string& identifier, Phase phase) {
+    const Clock::duration now = Clock::now() - _start;
+    const int p = static_cast<int>(phase);
+
+    std::lock_guard lock(_mutex);
+    Item& i = item(identifier);
+    if (!i.begin[p].has_value()) {
+        i.begin[p] = now;
+    }
+}
+
+void StartupTrace::end(const std::string& identifier, Phase phase) {
+    const Clock::duration now = Clock::now() - _start;
+    const int p = static_cast<int>(phase);
+
+    std::lock_guard lock(_mutex);
+    Item& i = item(identifier);
+    if (!i.begin[p].has_value()) {
+        i.begin[p] = now;
+    }
+    if (!i.end[p].has_value() || *i.end[p] < now) {
+        i.end[p] = now;
+    }
+}
+
+void StartupTrace::addDependency(const std::string& identifier,
+                                 const std::string& dependency)
+{
+    std::lock_guard lock(_mutex);
+    item(dependency);
+    std::vector<std::string>& deps = item(identifier).dependencies;
+    if (std::find(deps.begin(), deps.end(), dependency) == deps.end()) {
+        deps.push_back(dependency);
+    }
+}
+
+void StartupTrace::setActiveItem(std::string identifier) {
+    std::lock_guard lock(_mutex);
+    _activeItem = std::move(identifier);
+}
+
+void StartupTrace::addNode(const std::string& node) {
+    std::lock_guard lock(_mutex);
+    if (!_activeItem.empty()) {
+        _nodeOwners[node] = _activeItem;
+    }
+}
+
+void StartupTrace::beginNode(const std::string& node, Phase phase) {
+    std::string owner;
+    {
+        std::lock_guard lock(_mutex);
+        auto it = _nodeOwners.find(node);
+        if (it == _nodeOwners.end()) {
+            return;
+        }
+        owner = it->second;
+    }
+    begin(owner, phase);
+}
+
+void StartupTrace::endNode(const std::string& node, Phase phase) {
+    std::string owner;
+    {
+        std::lock_guard lock(_mutex);
+        auto it = _nodeOwners.find(node);
+        if (it == _nodeOwners.end()) {
+            return;
+        }
+        owner = it->second;
+    }
+    end(owner, phase);
+}
+
+std::vector<StartupTrace::Segment> StartupTrace::criticalPath() const {
+    std::lock_guard lock(_mutex);
+    return criticalPathLocked();
+}
+
+std::vector<StartupTrace::Segment> StartupTrace::criticalPathLocked() const {
+    using Key = std::pair<const std::string*, int>;
+
+    auto endOf = [this](const Key& key) -> std::optional<Clock::duration> {
+        return _items.at(*key.first).end[key.second];
+    };
+
+    // Start with the phase that finished last
+    std::optional<Key> current;
+    for (const std::pair<const std::string, Item>& p : _items) {
+        for (int phase = 0; phase < NPhases; phase++) {
+            const std::optional<Clock::duration>& e = p.second.end[phase];
+            if (e.has_value() && (!current.has_value() || *e > *endOf(*current))) {
+                current = Key(&p.first, phase);
+            }
+        }
+    }
+
+    std::vector<Segment> res;
+    std::set<Key> visited;
+    while (current.has_value() && visited.find(*current) == visited.end()) {
+        visited.insert(*current);
+
+        const Item& i = _items.at(*current->first);
+        const int phase = current->second;
+        res.push_back({
+            *current->first,
+            static_cast<Phase>(phase),
+            *i.begin[phase],
+            *i.end[phase]
+        });
+
+        // The predecessors are the closest earlier phase of the same item and the same
+        // phase of all dependencies. Of these, the one that finished last is the one that
+        // held up the current phase
+        std::optional<Key> next;
+        auto consider = [&](const Key& candidate) {
+            std::optional<Clock::duration> e = endOf(candidate);
+            if (e.has_value() && (!next.has_value() || *e > *endOf(*next))) {
+                next = candidate;
+            }
+        };
+        for (int p = phase - 1; p >= 0; p--) {
+            if (i.end[p].has_value()) {
+                consider(Key(current->first, p));
+                break;
+            }
+        }
+        if (static_cast<Phase>(phase) != Phase::Parse) {
+            for (const std::string& dependency : i.dependencies) {
+                consider(Key(&_items.find(dependency)->first, phase));
+            }
+        }
+        current = next;
+    }
+
+    std::reverse(res.begin(), res.end());
+    return res;
+}
+
+StartupTrace::Clock::duration StartupTrace::duration() const {
+    std::lock_guard lock(_mutex);
+    Clock::duration res = Clock::duration::zero();
+    for (const std::pair<const std::string, Item>& p : _items) {
+        for (const std::optional<Clock::duration>& e : p.second.end) {
+            if (e.has_value()) {
+                res = std::max(res, *e);
+            }
+        }
+    }
+    return res;
+}
+
+void StartupTrace::save(const std::filesystem::path& path) const {
+    std::lock_guard lock(_mutex);
+
+    nlohmann::json events = nlohmann::json::array();
+    auto addTrack = [&events](size_t track, std::string_view name) {
+        events.push_back({
+            { "name", "thread_name" },
+            { "ph", "M" },
+            { "pid", 1 },
+            { "tid", track },
+            { "args", { { "name", name } } }
+        });
+        events.push_back({
+            { "name", "thread_sort_index" },
+            { "ph", "M" },
+            { "pid", 1 },
+            { "tid", track },
+            { "args", { { "sort_index", track } } }
+        });
+    };
+    auto addSegment = [&events](size_t track, std::string_view item, Phase phase,
+                                Clock::duration begin, Clock::duration end)
+    {
+        events.push_back({
+            { "name", nameForPhase(phase) },
+            { "cat", "startup" },
+            { "ph", "X" },
+            { "pid", 1 },
+            { "tid", track },
+            { "ts", toMicroseconds(begin) },
+            { "dur", toMicroseconds(end - begin) },
+            { "args", { { "item", item } } }
+        });
+    };
+
+    // The critical path is shown in the first row, followed by one row per item
+    addTrack(0, "Critical path");
+    for (const Segment& s : criticalPathLocked()) {
+        addSegment(0, s.item, s.phase, s.begin, s.end);
+    }
+
+    for (const std::pair<const std::string, Item>& p : _items) {
+        const size_t track = p.second.index + 1;
+        addTrack(track, p.first);
+        for (int phase = 0; phase < NPhases; phase++) {
+            if (p.second.end[phase].has_value()) {
+                addSegment(
+                    track,
+                    p.first,
+                    static_cast<Phase>(phase),
+                    *p.second.begin[phase],
+                    *p.second.end[phase]
+                );
+            }
+        }
+    }
+
+    nlohmann::json json = {
+        { "traceEvents", events },
+        { "displayTimeUnit", "ms" }
+    };
+
+    std::ofstream file(path);
+    if (!file.good()) {
+        throw ghoul::RuntimeError(
+            fmt::format("Could not open file {} for writing", path),
+            "StartupTrace"
+        );
+    }
+    file << json.dump(2);
+}
+
+std::string_view StartupTrace::nameForPhase(Phase phase) {
+    switch (phase) {
+        case Phase::Parse: return "Parse";
+        case Phase::Synchronize: return "Synchronize";
+        case Phase::Initialize: return "Initialize";
+        case Phase::InitializeGL: return "InitializeGL";
+        default: throw ghoul::MissingCaseException();
+    }
+}
+
+} // namespace openspace
@@ -36,6 +36,24 @@ namespace {
         // valid Tasks that are available for creation (see the FactoryDocumentation for a
         // list of possible Tasks), which depends on the configration of the application
         std::string type [[codegen::annotation("A valid Task created by a factory")]];
+
+        // An identifier for this task that other tasks in the same task file can use
+        // to refer to it in their list of dependencies
+        std::optional<std::string> identifier;
+
+        // The identifiers of tasks that have to finish successfully before this task is
+        // started. Tasks that read one of the Outputs of a previous task in the same
+        // task file automatically depend on that task and don't have to list it here
+        std::optional<std::vector<std::string>> dependencies;
+
+        // The files and folders that this task reads. A task depends on every previous
+        // task in the same task file whose Outputs contain or are contained in one of
+        // these paths
+        std::optional<std::vector<std::string>> inputs;
+
+        // The files and folders that this task writes. A task depends on every previous
+        // task in the same task file that writes to the same files or folders
+        std::optional<std::vector<std::string>> outputs;
     };
 #include "task_codegen.cpp"
 } // namespace
@@ -46,6 +64,10 @@ documentation::Documentation Task::documentation() {
     return codegen::doc<Parameters>("core_task");
 }
 
+bool Task::isThreadSafe() const {
+    return false;
+}
+
 std::unique_ptr<Task> Task::createFromDictionary(const ghoul::Dictionary& dictionary) {
     const Parameters p = codegen::bake<Parameters>(dictionary);
 
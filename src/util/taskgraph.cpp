@@ -0,0 +1,318 @@
+/*****************************************************************************************
+ *                                                                                       *
+ * OpenSpace                                                                             *
+ *                                                                                       *
+ * Copyright (c) 2014-2023                                                               *
+ *                                                                                       *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this  *
+ * software and associated documentation files (the "Software"), to deal in the Software *
+ * without restriction, including without limitation the rights to use, copy, modify,    *
+ * merge, publish, distribute, sublicense, and/or sell copies of the Software, and to    *
+ * permit persons to whom the Software is furnished to do so, subject to the following   *
+ * conditions:                                                                           *
+ *                                                                                       *
+ * The above copyright notice and this permission notice shall be included in all copies *
+ * or substantial portions of the Software.                                              *
+ *                                                                                       *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,   *
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A         *
+ * PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT    *
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF  *
+ * CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE  *
+ * OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                                         *
+ ****************************************************************************************/
+
+
+#include <openspace/util/taskgraph.h>
+
+#include <ghoul/fmt.h>
+#include <ghoul/logging/logmanager.h>
+#include <ghoul/misc/assert.h>
+#include <algorithm>
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <numeric>
+#include <thread>
+
+#ifdef WIN32
+#include <Windows.h>
+#include <Psapi.h>
+#elif defined(__APPLE__)
+#include <mach/mach.h>
+#else
+#include <unistd.h>
+#include <fstream>
+#endif
+
+namespace {
+    constexpr std::string_view _loggerCat = "TaskGraph";
+
+    // The interval in which the memory usage is sampled while tasks are running
+    constexpr std::chrono::milliseconds MemorySampleInterval =
+        std::chrono::milliseconds(100);
+
+    // Returns the resident memory of this process in bytes, or 0 if it is not available
+    size_t currentMemoryUsage() {
+#ifdef WIN32
+        PROCESS_MEMORY_COUNTERS counters;
+        if (GetProcessMemoryInfo(GetCurrentProcess(), &counters, sizeof(counters))) {
+            return counters.WorkingSetSize;
+        }
+        return 0;
+#elif defined(__APPLE__)
+        mach_task_basic_info info;
+        mach_msg_type_number_t count = MACH_TASK_BASIC_INFO_COUNT;
+        const kern_return_t res = task_info(
+            mach_task_self(),
+            MACH_TASK_BASIC_INFO,
+            reinterpret_cast<task_info_t>(&info),
+            &count
+        );
+        return res == KERN_SUCCESS ? info.resident_size : 0;
+#else
+        std::ifstream statm("/proc/self/statm");
+        size_t size = 0;
+        size_t resident = 0;
+        if (statm >> size >> resident) {
+            return resident * static_cast<size_t>(sysconf(_SC_PAGESIZE));
+        }
+        return 0;
+#endif
+    }
+} // namespace
+
+namespace openspace {
+
+size_t TaskGraph::addTask(std::unique_ptr<Task> task) {
+    ghoul_precondition(task, "Task must not be nullptr");
+
+    _nodes.push_back({ std::move(task), {} });
+    return _nodes.size() - 1;
+}
+
+void TaskGraph::addDependency(size_t task, size_t dependency) {
+    ghoul_precondition(task < _nodes.size(), "Task index out of range");
+    ghoul_precondition(dependency < _nodes.size(), "Dependency index out of range");
+    ghoul_precondition(task != dependency, "A task cannot depend on itself");
+
+    std::vector<size_t>& deps = _nodes[task].dependencies;
+    if (std::find(deps.begin(), deps.end(), dependency) == deps.end()) {
+        deps.push_back(dependency);
+    }
+}
+
+size_t TaskGraph::nTasks() const {
+    return _nodes.size();
+}
+
+const std::vector<size_t>& TaskGraph::dependencies(size_t task) const {
+    ghoul_precondition(task < _nodes.size(), "Task index out of range");
+    return _nodes[task].dependencies;
+}
+
+std::vector<TaskGraph::Result> TaskGraph::perform(unsigned int nWorkers,
+                                            const Task::ProgressCallback& onProgress)
+{
+    ghoul_precondition(nWorkers > 0, "At least one worker is required");
+
+    const size_t n = _nodes.size();
+    std::vector<Result> results(n);
+    if (n == 0) {
+        return results;
+    }
+
+    // For each task, the number of dependencies that have not finished yet and the tasks
+    // that depend on it
+    std::vector<size_t> nRemaining(n);
+    std::vector<std::vector<size_t>> dependents(n);
+    for (size_t i = 0; i < n; i++) {
+        results[i].description = _nodes[i].task->description();
+        nRemaining[i] = _nodes[i].dependencies.size();
+        for (size_t dep : _nodes[i].dependencies) {
+            dependents[dep].push_back(i);
+        }
+    }
+
+    // All of the following variables are protected by the mutex
+    std::mutex mutex;
+    std::condition_variable cv;
+    std::deque<size_t> ready;
+    std::vector<bool> isRunning(n, false);
+    std::vector<bool> isDone(n, false);
+    std::vector<float> progress(n, 0.f);
+    size_t nRunning = 0;
+    size_t nDone = 0;
+    // Whether a task that is not thread-safe is currently running
+    bool isRunningExclusive = false;
+
+    for (size_t i = 0; i < n; i++) {
+        if (nRemaining[i] == 0) {
+            ready.push_back(i);
+        }
+    }
+
+    auto reportProgress = [&]() {
+        if (onProgress) {
+            const float sum = std::accumulate(progress.begin(), progress.end(), 0.f);
+            onProgress(sum / static_cast<float>(n));
+        }
+    };
+
+    // Marks the task as done and either releases or skips the tasks that depend on it
+    std::function<void(size_t)> finish = [&](size_t i) {
+        isDone[i] = true;
+        nDone++;
+        progress[i] = 1.f;
+
+        const bool success = results[i].status == Status::Succeeded;
+        for (size_t d : dependents[i]) {
+            if (isDone[d]) {
+                continue;
+            }
+
+            if (success) {
+                nRemaining[d]--;
+                if (nRemaining[d] == 0) {
+                    ready.push_back(d);
+                }
+            }
+            else {
+                results[d].status = Status::Skipped;
+                results[d].error = fmt::format(
+                    "Dependency '{}' did not succeed", results[i].description
+                );
+                LWARNING(fmt::format(
+                    "Skipping task '{}': {}", results[d].description, results[d].error
+                ));
+                finish(d);
+            }
+        }
+    };
+
+    // Returns the first ready task that can be started alongside the running tasks. A
+    // task that is not thread-safe can only start when no other task is running, and no
+    // task can start while such a task is running
+    auto nextTask = [&]() {
+        if (isRunningExclusive) {
+            return ready.end();
+        }
+        return std::find_if(
+            ready.begin(),
+            ready.end(),
+            [&](size_t i) { return nRunning == 0 || _nodes[i].task->isThreadSafe(); }
+        );
+    };
+
+    auto work = [&]() {
+        std::unique_lock lock(mutex);
+        while (true) {
+            cv.wait(lock, [&]() { return nextTask() != ready.end() || nRunning == 0; });
+
+            if (ready.empty()) {
+                // No task is running and no task can be started, so every remaining task
+                // is waiting for a dependency cycle to resolve
+                for (size_t i = 0; i < n; i++) {
+                    if (!isDone[i]) {
+                        results[i].status = Status::Skipped;
+                        results[i].error = "The task is part of a dependency cycle";
+                        LERROR(fmt::format(
+                            "Skipping task '{}': {}",
+                            results[i].description, results[i].error
+                        ));
+                        isDone[i] = true;
+                        nDone++;
+                    }
+                }
+                cv.notify_all();
+                return;
+            }
+
+            const auto it = nextTask();
+            const size_t i = *it;
+            ready.erase(it);
+            const bool isExclusive = !_nodes[i].task->isThreadSafe();
+            isRunningExclusive = isExclusive;
+            isRunning[i] = true;
+            nRunning++;
+            results[i].peakMemory = currentMemoryUsage();
+            lock.unlock();
+
+            LINFO(fmt::format("Starting task '{}'", results[i].description));
+            Task::ProgressCallback taskProgress = [&, i](float p) {
+                std::lock_guard g(mutex);
+                progress[i] = p;
+                reportProgress();
+            };
+
+            const auto begin = std::chrono::steady_clock::now();
+            Status status = Status::Failed;
+            std::string error;
+            try {
+                _nodes[i].task->perform(taskProgress);
+                status = Status::Succeeded;
+            }
+            catch (const std::exception& e) {
+                error = e.what();
+            }
+            catch (...) {
+                error = "Unknown error";
+            }
+            const auto end = std::chrono::steady_clock::now();
+            const size_t memory = currentMemoryUsage();
+
+            lock.lock();
+            Result& res = results[i];
+            res.status = status;
+            res.error = std::move(error);
+            res.duration = end - begin;
+            res.peakMemory = std::max(res.peakMemory, memory);
+            if (status == Status::Succeeded) {
+                LINFO(fmt::format(
+                    "Finished task '{}' in {:.2f} s",
+                    res.description, res.duration.count()
+                ));
+            }
+            else {
+                LERROR(fmt::format("Task '{}' failed: {}", res.description, res.error));
+            }
+
+            isRunning[i] = false;
+            nRunning--;
+            if (isExclusive) {
+                isRunningExclusive = false;
+            }
+            finish(i);
+            reportProgress();
+            cv.notify_all();
+        }
+    };
+
+    const size_t nThreads = std::min<size_t>(nWorkers, n);
+    std::vector<std::thread> workers;
+    workers.reserve(nThreads);
+    for (size_t i = 0; i < nThreads; i++) {
+        workers.emplace_back(work);
+    }
+
+    // While the workers are busy, this thread keeps track of the memory usage
+    {
+        std::unique_lock lock(mutex);
+        while (nDone < n) {
+            cv.wait_for(lock, MemorySampleInterval);
+            const size_t memory = currentMemoryUsage();
+            for (size_t i = 0; i < n; i++) {
+                if (isRunning[i]) {
+                    results[i].peakMemory = std::max(results[i].peakMemory, memory);
+                }
+            }
+        }
+    }
+
+    for (std::thread& worker : workers) {
+        worker.join();
+    }
+    return results;
+}
+
+} // namespace openspace
@@ -34,9 +34,128 @@
 #include <ghoul/misc/dictionary.h>
 #include <algorithm>
 #include <filesystem>
+#include <map>
+#include <optional>
 
 namespace {
     constexpr std::string_view _loggerCat = "TaskRunner";
+
+    constexpr std::string_view KeyType = "Type";
+    constexpr std::string_view KeyIdentifier = "Identifier";
+    constexpr std::string_view KeyDependencies = "Dependencies";
+    constexpr std::string_view KeyInputs = "Inputs";
+    constexpr std::string_view KeyOutputs = "Outputs";
+
+    std::optional<ghoul::Dictionary> loadTasksFile(const std::filesystem::path& path) {
+        if (!std::filesystem::is_regular_file(path)) {
+            LERROR(fmt::format("Could not load tasks file {}. File not found", path));
+            return std::nullopt;
+        }
+
+        ghoul::Dictionary tasksDictionary;
+        try {
+            ghoul::lua::loadDictionaryFromFile(path.string(), tasksDictionary);
+        }
+        catch (const ghoul::RuntimeError& e) {
+            LERROR(fmt::format(
+                "Could not load tasks file {}. Lua error: {}: {}",
+                path, e.message, e.component
+            ));
+            return std::nullopt;
+        }
+        return tasksDictionary;
+    }
+
+    // Returns the keys of the dictionary such that the entries of a Lua array are in the
+    // order in which they appear in the file
+    std::vector<std::string_view> orderedKeys(const ghoul::Dictionary& dictionary) {
+        std::vector<std::string_view> keys = dictionary.keys();
+        std::stable_sort(
+            keys.begin(),
+            keys.end(),
+            [](std::string_view lhs, std::string_view rhs) {
+                auto isNumber = [](std::string_view s) {
+                    return !s.empty() && std::all_of(s.begin(), s.end(), ::isdigit);
+                };
+                if (isNumber(lhs) && isNumber(rhs) && lhs.size() != rhs.size()) {
+                    return lhs.size() < rhs.size();
+                }
+                return lhs < rhs;
+            }
+        );
+        return keys;
+    }
+
+    // Collects the dictionaries of all tasks in the order in which they appear, loading
+    // referenced task files along the way
+    bool collectTaskDictionaries(const ghoul::Dictionary& tasksDictionary,
+                                 std::vector<ghoul::Dictionary>& result)
+    {
+        for (std::string_view key : orderedKeys(tasksDictionary)) {
+            if (tasksDictionary.hasValue<std::string>(key)) {
+                const std::string taskName = tasksDictionary.value<std::string>(key);
+                std::optional<ghoul::Dictionary> subTasks =
+                    loadTasksFile(absPath(taskName + ".task"));
+                if (!subTasks.has_value() ||
+                    !collectTaskDictionaries(*subTasks, result))
+                {
+                    return false;
+                }
+            }
+            else if (tasksDictionary.hasValue<ghoul::Dictionary>(key)) {
+                result.push_back(tasksDictionary.value<ghoul::Dictionary>(key));
+            }
+        }
+        return true;
+    }
+
+    struct TaskPaths {
+        std::vector<std::filesystem::path> inputs;
+        std::vector<std::filesystem::path> outputs;
+    };
+
+    // Returns the normalized absolute paths listed in the key of the dictionary
+    std::vector<std::filesystem::path> pathList(const ghoul::Dictionary& dictionary,
+                                                std::string_view key)
+    {
+        std::vector<std::filesystem::path> res;
+        if (!dictionary.hasValue<ghoul::Dictionary>(key)) {
+            return res;
+        }
+        const ghoul::Dictionary list = dictionary.value<ghoul::Dictionary>(key);
+        for (std::string_view k : orderedKeys(list)) {
+            const std::string value = list.value<std::string>(k);
+            res.push_back(std::filesystem::path(absPath(value)).lexically_normal());
+        }
+        return res;
+    }
+
+    // Extracts the paths that are read and written by a task from the explicit Inputs
+    // and Outputs keys of the task dictionary
+    TaskPaths taskPaths(const ghoul::Dictionary& dictionary) {
+        TaskPaths paths;
+        paths.inputs = pathList(dictionary, KeyInputs);
+        paths.outputs = pathList(dictionary, KeyOutputs);
+        return paths;
+    }
+
+    // Returns true if the path is the same as the output or is located inside of it
+    bool isAffectedBy(const std::filesystem::path& path,
+                      const std::filesystem::path& output)
+    {
+        auto it = path.begin();
+        for (const std::filesystem::path& component : output) {
+            if (component.empty()) {
+                // A trailing separator of a folder results in an empty last component
+                continue;
+            }
+            if (it == path.end() || *it != component) {
+                return false;
+            }
+            ++it;
+        }
+        return true;
+    }
 } // namespace
 
 namespace openspace {
@@ -70,32 +189,127 @@ std::vector<std::unique_ptr<Task>> TaskLoader::tasksFromDictionary(
 
 std::vector<std::unique_ptr<Task>> TaskLoader::tasksFromFile(const std::string& path) {
     std::filesystem::path absTasksFile = absPath(path);
-    if (!std::filesystem::is_regular_file(absTasksFile)) {
-        LERROR(fmt::format("Could not load tasks file {}. File not found", absTasksFile));
+    std::optional<ghoul::Dictionary> tasksDictionary = loadTasksFile(absTasksFile);
+    if (!tasksDictionary.has_value()) {
         return std::vector<std::unique_ptr<Task>>();
     }
 
-    ghoul::Dictionary tasksDictionary;
     try {
-        ghoul::lua::loadDictionaryFromFile(absTasksFile.string(), tasksDictionary);
+        return tasksFromDictionary(*tasksDictionary);
     }
-    catch (const ghoul::RuntimeError& e) {
-        LERROR(fmt::format(
-            "Could not load tasks file {}. Lua error: {}: {}",
-            absTasksFile, e.message, e.component
-        ));
+    catch (const documentation::SpecificationError& e) {
+        LERROR(fmt::format("Could not load tasks file {}. {}", absTasksFile, e.what()));
+        logError(e);
+
         return std::vector<std::unique_ptr<Task>>();
     }
+}
+
+TaskGraph TaskLoader::taskGraphFromFile(const std::string& path) {
+    std::filesystem::path absTasksFile = absPath(path);
+    std::optional<ghoul::Dictionary> tasksDictionary = loadTasksFile(absTasksFile);
+    if (!tasksDictionary.has_value()) {
+        return TaskGraph();
+    }
+
+    std::vector<ghoul::Dictionary> dictionaries;
+    if (!collectTaskDictionaries(*tasksDictionary, dictionaries)) {
+        return TaskGraph();
+    }
 
+    TaskGraph graph;
+    std::vector<TaskPaths> paths;
+    std::map<std::string, size_t> identifiers;
+    std::vector<std::vector<std::string>> explicitDependencies;
     try {
-        return tasksFromDictionary(tasksDictionary);
+        for (const ghoul::Dictionary& dictionary : dictionaries) {
+            std::unique_ptr<Task> task = Task::createFromDictionary(dictionary);
+            if (!task) {
+                LERROR(fmt::format(
+                    "Failed to create a Task object of type '{}'",
+                    dictionary.value<std::string>(KeyType)
+                ));
+                continue;
+            }
+            const size_t index = graph.addTask(std::move(task));
+
+            if (dictionary.hasValue<std::string>(KeyIdentifier)) {
+                const std::string id = dictionary.value<std::string>(KeyIdentifier);
+                const bool inserted = identifiers.emplace(id, index).second;
+                if (!inserted) {
+                    LERROR(fmt::format(
+                        "Could not load tasks file {}. Duplicate task identifier '{}'",
+                        absTasksFile, id
+                    ));
+                    return TaskGraph();
+                }
+            }
+
+            std::vector<std::string> deps;
+            if (dictionary.hasValue<ghoul::Dictionary>(KeyDependencies)) {
+                const ghoul::Dictionary d =
+                    dictionary.value<ghoul::Dictionary>(KeyDependencies);
+                for (std::string_view key : d.keys()) {
+                    deps.push_back(d.value<std::string>(key));
+                }
+            }
+            explicitDependencies.push_back(std::move(deps));
+            paths.push_back(taskPaths(dictionary));
+        }
     }
     catch (const documentation::SpecificationError& e) {
         LERROR(fmt::format("Could not load tasks file {}. {}", absTasksFile, e.what()));
         logError(e);
 
-        return std::vector<std::unique_ptr<Task>>();
+        return TaskGraph();
     }
+
+    for (size_t i = 0; i < graph.nTasks(); i++) {
+        for (const std::string& id : explicitDependencies[i]) {
+            auto it = identifiers.find(id);
+            if (it == identifiers.end()) {
+                LERROR(fmt::format(
+                    "Could not load tasks file {}. Unknown task dependency '{}'",
+                    absTasksFile, id
+                ));
+                return TaskGraph();
+            }
+            if (it->second == i) {
+                LERROR(fmt::format(
+                    "Could not load tasks file {}. Task '{}' depends on itself",
+                    absTasksFile, id
+                ));
+                return TaskGraph();
+            }
+            graph.addDependency(i, it->second);
+        }
+
+        // Implicit dependencies are only added to earlier tasks, so they can never
+        // introduce a cycle
+        for (size_t j = 0; j < i; j++) {
+            for (const std::filesystem::path& output : paths[j].outputs) {
+                auto isAffected = [&output](const std::filesystem::path& p) {
+                    return isAffectedBy(p, output) || isAffectedBy(output, p);
+                };
+                const bool readsOutput = std::any_of(
+                    paths[i].inputs.begin(),
+                    paths[i].inputs.end(),
+                    isAffected
+                );
+                const bool writesOutput = std::any_of(
+                    paths[i].outputs.begin(),
+                    paths[i].outputs.end(),
+                    isAffected
+                );
+                if (readsOutput || writesOutput) {
+                    graph.addDependency(i, j);
+                    break;
+                }
+            }
+        }
+    }
+
+    return graph;
 }
 
 } // namespace openspace
@@ -59,6 +59,7 @@ void VersionChecker::requestLatestVersion(const std::string& url) {
     }
 
     _request = std::make_unique<HttpMemoryDownload>(std::move(fullUrl));
+    _request->setPriority(DownloadEngine::Priority::Background);
     _request->start();
 }
 
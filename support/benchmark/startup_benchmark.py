@@ -0,0 +1,118 @@
+# coding=utf-8
+
+"""
+OpenSpace
+
+Copyright (c) 2014-2023
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of this
+software and associated documentation files (the "Software"), to deal in the Software
+without restriction, including without limitation the rights to use, copy, modify,
+merge, publish, distribute, sublicense, and/or sell copies of the Software, and to
+permit persons to whom the Software is furnished to do so, subject to the following
+conditions:
+
+The above copyright notice and this permission notice shall be included in all copies
+or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A
+PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF
+CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE
+OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+
+This script measures the time it takes OpenSpace to load a profile, with and without the
+scene snapshot (the 'UseSceneSnapshot' setting in the openspace.cfg). OpenSpace is started
+repeatedly with the startup trace enabled; the time until the last asset has finished
+loading is read from the trace, after which OpenSpace is terminated.
+
+The first run with the snapshot enabled creates the snapshot, all further runs create the
+scene graph nodes from unchanged dictionaries without testing them against their
+documentation. In order to measure the time that is spent loading the assets rather than
+downloading the data, the profile should be started once before running this script.
+
+Example:
+  python startup_benchmark.py --executable ../../bin/RelWithDebInfo/OpenSpace.exe \
+      --profile default --runs 5
+"""
+
+import argparse
+import json
+import os
+import statistics
+import subprocess
+import tempfile
+import time
+
+def run_openspace(executable, profile, use_snapshot, timeout):
+    with tempfile.TemporaryDirectory() as directory:
+        trace = os.path.join(directory, "StartupTrace.json").replace("\\", "/")
+        config = ";".join([
+            "BypassLauncher=true",
+            f"Profile=[[{profile}]]",
+            f"UseSceneSnapshot={'true' if use_snapshot else 'false'}",
+            f"StartupTrace=[[{trace}]]"
+        ])
+
+        process = subprocess.Popen(
+            [executable, "--config", config],
+            cwd=os.path.dirname(os.path.abspath(executable)),
+            stdout=subprocess.DEVNULL,
+            stderr=subprocess.DEVNULL
+        )
+        try:
+            end_time = time.perf_counter() + timeout
+            while not os.path.exists(trace):
+                if process.poll() is not None:
+                    raise RuntimeError("OpenSpace terminated before the scene was loaded")
+                if time.perf_counter() > end_time:
+                    raise RuntimeError("Timeout while waiting for the scene to load")
+                time.sleep(0.1)
+
+            # The trace is written after the scene is loaded, so there might be a small
+            # window in which the file exists but is not complete yet
+            while True:
+                try:
+                    with open(trace) as f:
+                        events = json.load(f)["traceEvents"]
+                    break
+                except (json.JSONDecodeError, KeyError):
+                    time.sleep(0.1)
+        finally:
+            process.kill()
+            process.wait()
+
+    # All timestamps are in microseconds relative to the beginning of the loading
+    end = max(e["ts"] + e.get("dur", 0) for e in events if "ts" in e)
+    return end / 1e6
+
+def main():
+    parser = argparse.ArgumentParser(description="Measures the startup time of OpenSpace")
+    parser.add_argument("--executable", required=True, help="Path to the executable")
+    parser.add_argument("--profile", default="default")
+    parser.add_argument("--runs", type=int, default=5)
+    parser.add_argument("--timeout", type=float, default=600.0, help="In seconds")
+    args = parser.parse_args()
+
+    results = {}
+    for use_snapshot in [False, True]:
+        name = "Snapshot" if use_snapshot else "No snapshot"
+        times = []
+        # With the snapshot enabled, the first run only creates the snapshot
+        n_runs = args.runs + 1 if use_snapshot else args.runs
+        for i in range(n_runs):
+            t = run_openspace(args.executable, args.profile, use_snapshot, args.timeout)
+            print(f"{name} run {i + 1}: {t:.2f} s")
+            if not use_snapshot or i > 0:
+                times.append(t)
+        results[name] = times
+
+    print()
+    for name, times in results.items():
+        print(f"{name + ':':14} mean {statistics.mean(times):.2f} s, " +
+              f"min {min(times):.2f} s, max {max(times):.2f} s")
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,119 @@
+# coding=utf-8
+
+"""
+OpenSpace
+
+Copyright (c) 2014-2023
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of this
+software and associated documentation files (the "Software"), to deal in the Software
+without restriction, including without limitation the rights to use, copy, modify,
+merge, publish, distribute, sublicense, and/or sell copies of the Software, and to
+permit persons to whom the Software is furnished to do so, subject to the following
+conditions:
+
+The above copyright notice and this permission notice shall be included in all copies
+or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A
+PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF
+CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE
+OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+
+This script runs a local HTTP server that is used by the "[.downloadengine-benchmark]"
+test case. Every URL returns the same 1 MiB body and supports range requests, except for
+a few paths that simulate misbehaving servers:
+  /flaky*    responds with 503 to the first two requests
+  /drop*     drops the connection halfway through the first response
+  /norange*  ignores range requests and drops the first response halfway through
+  /missing*  responds with 404
+  /stall*    sends the first part of the body and then stops sending without closing
+             the connection
+
+Example:
+  python httpfixture.py --port 8765
+"""
+
+import argparse
+import http.server
+import socket
+import socketserver
+import threading
+import time
+
+BodySize = 1 << 20
+DroppedSize = 300000
+Body = bytes((i * 7) % 251 for i in range(BodySize))
+
+request_counts = {}
+request_counts_lock = threading.Lock()
+
+class Handler(http.server.BaseHTTPRequestHandler):
+    protocol_version = "HTTP/1.1"
+
+    def log_message(self, format, *args):
+        pass
+
+    def send_error_body(self, code, body):
+        self.send_response(code)
+        self.send_header("Content-Length", str(len(body)))
+        self.end_headers()
+        self.wfile.write(body)
+
+    def do_GET(self):
+        with request_counts_lock:
+            n = request_counts.get(self.path, 0)
+            request_counts[self.path] = n + 1
+
+        if self.path.startswith("/missing"):
+            self.send_error_body(404, b"not found")
+            return
+        if self.path.startswith("/flaky") and n < 2:
+            self.send_error_body(503, b"unavailable")
+            return
+
+        ignore_range = self.path.startswith("/norange")
+        range_header = self.headers.get("Range")
+        start = 0
+        if range_header and not ignore_range:
+            start = int(range_header.split("=")[1].split("-")[0])
+            self.send_response(206)
+            self.send_header("Content-Range", f"bytes {start}-{BodySize - 1}/{BodySize}")
+        else:
+            self.send_response(200)
+
+        body = Body[start:]
+        self.send_header("Content-Length", str(len(body)))
+        self.send_header("Content-Type", "application/octet-stream")
+        self.end_headers()
+
+        if self.path.startswith("/stall"):
+            self.wfile.write(body[:DroppedSize])
+            self.wfile.flush()
+            time.sleep(60)
+            self.close_connection = True
+            return
+
+        drop = self.path.startswith("/drop") or ignore_range
+        if drop and n == 0:
+            self.wfile.write(body[:DroppedSize])
+            self.wfile.flush()
+            self.close_connection = True
+            self.connection.shutdown(socket.SHUT_RDWR)
+            return
+
+        self.wfile.write(body)
+
+class Server(socketserver.ThreadingMixIn, http.server.HTTPServer):
+    daemon_threads = True
+
+if __name__ == "__main__":
+    parser = argparse.ArgumentParser(description="HTTP fixture for the DownloadEngine")
+    parser.add_argument("--host", default="127.0.0.1")
+    parser.add_argument("--port", type=int, default=8765)
+    args = parser.parse_args()
+
+    Server((args.host, args.port), Handler).serve_forever()
@@ -0,0 +1,192 @@
+/*****************************************************************************************
+ *                                                                                       *
+ * OpenSpace                                                                             *
+ *                                                                                       *
+ * Copyright (c) 2014-2023                                                               *
+ *                                                                                       *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this  *
+ * software and associated documentation files (the "Software"), to deal in the Software *
+ * without restriction, including without limitation the rights to use, copy, modify,    *
+ * merge, publish, distribute, sublicense, and/or sell copies of the Software, and to    *
+ * permit persons to whom the Software is furnished to do so, subject to the following   *
+ * conditions:                                                                           *
+ *                                                                                       *
+ * The above copyright notice and this permission notice shall be included in all copies *
+ * or substantial portions of the Software.                                              *
+ *                                                                                       *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,   *
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A         *
+ * PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT    *
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF  *
+ * CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE  *
+ * OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                                         *
+ ****************************************************************************************/
+
+#include <catch2/catch_test_macros.hpp>
+
+#include <openspace/network/camerakeyframecodec.h>
+#include <ghoul/filesystem/filesystem.h>
+#include <fstream>
+
+using namespace openspace::datamessagestructures;
+
+namespace {
+    // Reads the camera keyframes at the beginning of a binary session recording
+    std::vector<CameraKeyframe> recordedKeyframes(const std::filesystem::path& path) {
+        constexpr size_t HeaderSize = 32;
+        constexpr size_t TimestampsSize = 3 * sizeof(double);
+
+        std::ifstream file(path, std::ios::binary);
+        file.seekg(HeaderSize);
+
+        std::vector<CameraKeyframe> res;
+        char type = 0;
+        while (file.read(&type, sizeof(char)) && type == 'c') {
+            file.seekg(TimestampsSize, std::ios::cur);
+            CameraKeyframe kf;
+            kf.read(&file);
+            if (!file) {
+                break;
+            }
+            res.push_back(std::move(kf));
+        }
+        return res;
+    }
+
+    double rotationError(const glm::dquat& a, const glm::dquat& b) {
+        // q and -q represent the same rotation
+        return 1.0 - std::abs(glm::dot(glm::normalize(a), glm::normalize(b)));
+    }
+
+    struct Measurement {
+        double bytesPerFrame = 0.0;
+        double uncompressedBytesPerFrame = 0.0;
+    };
+
+    Measurement roundTrip(const std::vector<CameraKeyframe>& keyframes) {
+        CameraKeyframeEncoder encoder;
+        CameraKeyframeDecoder decoder;
+
+        size_t nBytes = 0;
+        size_t nUncompressedBytes = 0;
+        for (const CameraKeyframe& kf : keyframes) {
+            std::vector<char> buffer;
+            encoder.encode(kf, buffer);
+            nBytes += buffer.size();
+
+            std::vector<char> uncompressed;
+            kf.serialize(uncompressed);
+            nUncompressedBytes += uncompressed.size();
+
+            CameraKeyframe res;
+            size_t offset = 0;
+            REQUIRE(decoder.decode(buffer, offset, res));
+            CHECK(offset == buffer.size());
+
+            const double magnitude = std::max(glm::length(kf._position), 1.0);
+            CHECK(glm::length(res._position - kf._position) / magnitude < 1e-8);
+            CHECK(rotationError(res._rotation, kf._rotation) < 1e-10);
+            CHECK(std::abs(res._timestamp - kf._timestamp) < 1e-6);
+            CHECK(res._scale == kf._scale);
+            CHECK(res._focusNode == kf._focusNode);
+            CHECK(res._followNodeRotation == kf._followNodeRotation);
+        }
+
+        return {
+            static_cast<double>(nBytes) / keyframes.size(),
+            static_cast<double>(nUncompressedBytes) / keyframes.size()
+        };
+    }
+} // namespace
+
+TEST_CASE("CameraKeyframeCodec: Synthetic Flight", "[camerakeyframecodec]") {
+    std::vector<CameraKeyframe> keyframes;
+    for (int i = 0; i < 2000; i++) {
+        CameraKeyframe kf;
+        // Approach from far away to close to the surface of a planet
+        const double distance = 1e11 * std::exp(-i * 0.01) + 6.4e6;
+        const double angle = i * 0.002;
+        kf._position = glm::dvec3(
+            distance * std::cos(angle),
+            distance * std::sin(angle),
+            1e3 * i
+        );
+        kf._rotation = glm::normalize(glm::dquat(
+            std::cos(angle), 0.3 * std::sin(angle), 0.5 * std::sin(angle), 0.1
+        ));
+        kf._focusNode = (i < 1200) ? "Earth" : "Moon";
+        kf._followNodeRotation = (i % 500) < 250;
+        kf._scale = (i < 1000) ? 1.f : 0.5f;
+        kf._timestamp = 1000.0 + i / 60.0;
+        keyframes.push_back(std::move(kf));
+    }
+
+    Measurement m = roundTrip(keyframes);
+    INFO("Bytes per frame: " << m.bytesPerFrame << " vs " << m.uncompressedBytesPerFrame);
+    CHECK(m.bytesPerFrame < 0.5 * m.uncompressedBytesPerFrame);
+}
+
+TEST_CASE("CameraKeyframeCodec: Recorded Sessions", "[camerakeyframecodec]") {
+    const std::vector<std::filesystem::path> recordings = {
+        absPath("${TESTDIR}/visual/default/RecordingDefaultSolarSystem.osrec"),
+        absPath("${TESTDIR}/visual/newhorizons/RecordingNewHorizionsModel.osrec")
+    };
+
+    for (const std::filesystem::path& recording : recordings) {
+        std::vector<CameraKeyframe> keyframes = recordedKeyframes(recording);
+        REQUIRE(keyframes.size() > 1000);
+
+        Measurement m = roundTrip(keyframes);
+        INFO(
+            recording << ": " << m.bytesPerFrame << " bytes per frame vs " <<
+            m.uncompressedBytesPerFrame
+        );
+        CHECK(m.bytesPerFrame < 0.5 * m.uncompressedBytesPerFrame);
+    }
+}
+
+TEST_CASE("CameraKeyframeCodec: Late Join", "[camerakeyframecodec]") {
+    CameraKeyframeEncoder encoder(10);
+    CameraKeyframeDecoder decoder;
+
+    int nDecoded = 0;
+    for (int i = 0; i < 25; i++) {
+        CameraKeyframe kf;
+        kf._position = glm::dvec3(1e7 + i * 10.0, 0.0, 0.0);
+        kf._focusNode = "Earth";
+        kf._timestamp = i / 60.0;
+
+        std::vector<char> buffer;
+        encoder.encode(kf, buffer);
+
+        // The decoder joins the stream after the first keyframe
+        if (i < 3) {
+            continue;
+        }
+
+        CameraKeyframe res;
+        size_t offset = 0;
+        const bool success = decoder.decode(buffer, offset, res);
+        CHECK(offset == buffer.size());
+        if (success) {
+            nDecoded++;
+            CHECK(std::abs(res._position.x - kf._position.x) < 1e-3);
+            CHECK(res._focusNode == "Earth");
+        }
+        // Frames before the second keyframe cannot be decoded, all after that can
+        CHECK(success == (i >= 11));
+    }
+    CHECK(nDecoded == 14);
+
+    // A reset of the encoder has to produce a keyframe that can be decoded on its own
+    encoder.reset();
+    CameraKeyframe kf;
+    kf._focusNode = "Mars";
+    std::vector<char> buffer;
+    encoder.encode(kf, buffer);
+    CameraKeyframeDecoder newDecoder;
+    size_t offset = 0;
+    CameraKeyframe res;
+    CHECK(newDecoder.decode(buffer, offset, res));
+    CHECK(res._focusNode == "Mars");
+}
@@ -200,6 +200,12 @@ TEST_CASE("Configuration: scriptlog", "[configuration]") {
     CHECK(c.scriptLog == "foobar");
 }
 
+TEST_CASE("Configuration: startuptrace", "[configuration]") {
+    constexpr std::string_view Extra = R"(StartupTrace = "foobar")";
+    const Configuration c = loadConfiguration("startuptrace", Extra);
+    CHECK(c.startupTrace == "foobar");
+}
+
 TEST_CASE("Configuration: documentationpath", "[configuration]") {
     constexpr std::string_view Extra = R"(Documentation = { Path = "foobar" })";
     const Configuration c = loadConfiguration("documentationpath", Extra);
@@ -218,6 +224,12 @@ TEST_CASE("Configuration: useMultithreadedInit", "[configuration]") {
     CHECK(c.useMultithreadedInitialization == true);
 }
 
+TEST_CASE("Configuration: useSceneSnapshot", "[configuration]") {
+    constexpr std::string_view Extra = R"(UseSceneSnapshot = true)";
+    const Configuration c = loadConfiguration("useSceneSnapshot", Extra);
+    CHECK(c.useSceneSnapshot == true);
+}
+
 TEST_CASE("Configuration: loadingscreen", "[configuration]") {
     Configuration defaultConf;
 
@@ -0,0 +1,231 @@
+/*****************************************************************************************
+ *                                                                                       *
+ * OpenSpace                                                                             *
+ *                                                                                       *
+ * Copyright (c) 2014-2023                                                               *
+ *                                                                                       *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this  *
+ * software and associated documentation files (the "Software"), to deal in the Software *
+ * without restriction, including without limitation the rights to use, copy, modify,    *
+ * merge, publish, distribute, sublicense, and/or sell copies of the Software, and to    *
+ * permit persons to whom the Software is furnished to do so, subject to the following   *
+ * conditions:                                                                           *
+ *                                                                                       *
+ * The above copyright notice and this permission notice shall be included in all copies *
+ * or substantial portions of the Software.                                              *
+ *                                                                                       *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,   *
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A         *
+ * PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT    *
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF  *
+ * CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE  *
+ * OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                                         *
+ ****************************************************************************************/
+
+
+#ifdef OPENSPACE_MODULE_SYNC_ENABLED
+
+#include <catch2/catch_test_macros.hpp>
+
+#include <modules/sync/contentstore.h>
+#include <filesystem>
+#include <fstream>
+#include <sstream>
+
+using namespace openspace;
+
+namespace {
+    struct TemporaryStore {
+        TemporaryStore()
+            : directory(std::filesystem::temp_directory_path() / "contentstore-test")
+        {
+            std::filesystem::remove_all(directory);
+            std::filesystem::create_directories(directory);
+            store = std::make_unique<ContentStore>(directory / "store");
+        }
+
+        ~TemporaryStore() {
+            store = nullptr;
+            std::filesystem::remove_all(directory);
+        }
+
+        std::filesystem::path write(const std::string& name, const std::string& content) {
+            const std::filesystem::path path = directory / name;
+            std::filesystem::create_directories(path.parent_path());
+            std::ofstream(path, std::ofstream::binary) << content;
+            return path;
+        }
+
+        std::filesystem::path directory;
+        std::unique_ptr<ContentStore> store;
+    };
+
+    std::string read(const std::filesystem::path& path) {
+        std::ifstream file(path, std::ifstream::binary);
+        std::stringstream buffer;
+        buffer << file.rdbuf();
+        return buffer.str();
+    }
+} // namespace
+
+TEST_CASE("ContentStore: SHA-256", "[contentstore]") {
+    CHECK(
+        ContentStore::hashBuffer("") ==
+        "e3b0c44298fc1c149afbf4c8996fb92427ae41e4649b934ca495991b7852b855"
+    );
+    CHECK(
+        ContentStore::hashBuffer("abc") ==
+        "ba7816bf8f01cfea414140de5dae2223b00361a396177a9cb410ff61f20015ad"
+    );
+    CHECK(
+        ContentStore::hashBuffer(
+            "abcdbcdecdefdefgefghfghighijhijkijkljklmklmnlmnomnopnopq"
+        ) ==
+        "248d6a61d20638b8e5c026930c3e6039a33ce45964ff2167f6ecedd419db06c1"
+    );
+    CHECK(
+        ContentStore::hashBuffer(std::string(1000000, 'a')) ==
+        "cdc76e5c9914fb9281a1c7e284d73e67f1809a48a497200e046d39ccc7112cd0"
+    );
+
+    CHECK(ContentStore::isValidHash(ContentStore::hashBuffer("abc")));
+    CHECK_FALSE(ContentStore::isValidHash("abc"));
+    CHECK_FALSE(ContentStore::isValidHash(std::string(64, 'g')));
+    CHECK_FALSE(ContentStore::isValidHash(std::string(64, 'A')));
+}
+
+TEST_CASE("ContentStore: Insert and deduplicate", "[contentstore]") {
+    TemporaryStore t;
+    const std::string hash = ContentStore::hashBuffer("content");
+
+    std::optional<std::string> first = t.store->insert(
+        t.write("a.tmp", "content"),
+        t.directory / "a" / "file.txt"
+    );
+    REQUIRE(first.has_value());
+    CHECK(*first == hash);
+    CHECK(t.store->contains(hash));
+    CHECK_FALSE(std::filesystem::exists(t.directory / "a.tmp"));
+    CHECK(read(t.directory / "a" / "file.txt") == "content");
+
+    std::optional<std::string> second = t.store->insert(
+        t.write("b.tmp", "content"),
+        t.directory / "b" / "other.txt",
+        hash
+    );
+    REQUIRE(second.has_value());
+    CHECK(*second == hash);
+    CHECK(read(t.directory / "b" / "other.txt") == "content");
+
+    size_t nObjects = 0;
+    const std::filesystem::path objects = t.store->root() / "objects";
+    for (const auto& e : std::filesystem::recursive_directory_iterator(objects)) {
+        nObjects += e.is_regular_file() ? 1 : 0;
+    }
+    CHECK(nObjects == 1);
+
+    CHECK(t.store->createView(hash, t.directory / "c" / "view.txt"));
+    CHECK(read(t.directory / "c" / "view.txt") == "content");
+}
+
+TEST_CASE("ContentStore: Hash mismatch", "[contentstore]") {
+    TemporaryStore t;
+
+    std::optional<std::string> res = t.store->insert(
+        t.write("a.tmp", "content"),
+        t.directory / "a" / "file.txt",
+        ContentStore::hashBuffer("different content")
+    );
+    CHECK_FALSE(res.has_value());
+    CHECK_FALSE(std::filesystem::exists(t.directory / "a" / "file.txt"));
+    CHECK_FALSE(t.store->contains(ContentStore::hashBuffer("content")));
+}
+
+TEST_CASE("ContentStore: Verify", "[contentstore]") {
+    TemporaryStore t;
+    const std::string hash = ContentStore::hashBuffer("content");
+    REQUIRE(t.store->insert(t.write("a.tmp", "content"), t.directory / "file.txt"));
+    CHECK(t.store->verify(hash));
+
+    // Corrupt the object directly
+    std::filesystem::permissions(
+        t.store->objectPath(hash),
+        std::filesystem::perms::owner_write,
+        std::filesystem::perm_options::add
+    );
+    std::ofstream(t.store->objectPath(hash), std::ofstream::binary) << "corrupted";
+    ContentStore::VerifyResult res = t.store->verifyAll();
+    CHECK(res.nObjects == 1);
+    CHECK(res.nCorrupt == 1);
+    CHECK_FALSE(t.store->contains(hash));
+}
+
+TEST_CASE("ContentStore: Objects are read-only", "[contentstore]") {
+    TemporaryStore t;
+    const std::string hash = ContentStore::hashBuffer("content");
+    REQUIRE(t.store->insert(t.write("a.tmp", "content"), t.directory / "file.txt"));
+
+    // A view might be a hard link to the object, so neither must be writable
+    using std::filesystem::perms;
+    const perms object = std::filesystem::status(t.store->objectPath(hash)).permissions();
+    CHECK((object & perms::owner_write) == perms::none);
+    const perms view = std::filesystem::status(t.directory / "file.txt").permissions();
+    CHECK((view & perms::owner_write) == perms::none);
+}
+
+TEST_CASE("ContentStore: Corrupted object is replaced", "[contentstore]") {
+    TemporaryStore t;
+    const std::string hash = ContentStore::hashBuffer("content");
+    REQUIRE(t.store->insert(t.write("a.tmp", "content"), t.directory / "a.txt"));
+
+    std::filesystem::permissions(
+        t.store->objectPath(hash),
+        std::filesystem::perms::owner_write,
+        std::filesystem::perm_options::add
+    );
+    std::ofstream(t.store->objectPath(hash), std::ofstream::binary) << "corrupted";
+
+    // Inserting the same content again replaces the corrupted object instead of creating
+    // a view of it
+    REQUIRE(t.store->insert(t.write("b.tmp", "content"), t.directory / "b.txt"));
+    CHECK(read(t.directory / "b.txt") == "content");
+    CHECK(read(t.store->objectPath(hash)) == "content");
+    CHECK(t.store->verify(hash));
+}
+
+TEST_CASE("ContentStore: Import directory", "[contentstore]") {
+    TemporaryStore t;
+    t.write("data/a/1.txt", "one");
+    t.write("data/b/1.txt", "one");
+    t.write("data/b/2.txt", "two");
+
+    SECTION("Copy") {
+        ContentStore::ImportResult res = t.store->importDirectory(
+            t.directory / "data",
+            ContentStore::ReplaceWithView::No
+        );
+        CHECK(res.nFiles == 3);
+        CHECK(res.nNewObjects == 2);
+        CHECK(res.nDuplicateBytes == 3);
+        CHECK(res.nFailed == 0);
+        CHECK(t.store->contains(ContentStore::hashBuffer("one")));
+        CHECK(t.store->contains(ContentStore::hashBuffer("two")));
+        CHECK(read(t.directory / "data" / "b" / "2.txt") == "two");
+    }
+
+    SECTION("Replace with views") {
+        ContentStore::ImportResult res = t.store->importDirectory(
+            t.directory,
+            ContentStore::ReplaceWithView::Yes
+        );
+        // The store itself is part of the directory but must not be imported
+        CHECK(res.nFiles == 3);
+        CHECK(res.nNewObjects == 2);
+        CHECK(res.nFailed == 0);
+        CHECK(read(t.directory / "data" / "a" / "1.txt") == "one");
+        CHECK(read(t.directory / "data" / "b" / "1.txt") == "one");
+        CHECK(read(t.directory / "data" / "b" / "2.txt") == "two");
+    }
+}
+
+#endif // OPENSPACE_MODULE_SYNC_ENABLED
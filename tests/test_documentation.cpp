@@ -3113,3 +3113,26 @@ TEST_CASE("Documentation: Verifier Documentation Post Conditions", "[documentati
 
     CHECK(ReferencingVerifier("identifier"s).documentation() != "");
 }
+
+TEST_CASE("Documentation: Skip Specification Tests", "[documentation]") {
+    using namespace openspace::documentation;
+
+    Documentation doc;
+    doc.entries.emplace_back("Int", new IntVerifier, Optional::No);
+
+    ghoul::Dictionary negative;
+    negative.setValue("Int", std::string("abc"));
+    CHECK_THROWS_AS(testSpecificationAndThrow(doc, negative, "Test"), SpecificationError);
+
+    {
+        SkipSpecificationTests skip;
+        CHECK_NOTHROW(testSpecificationAndThrow(doc, negative, "Test"));
+        {
+            SkipSpecificationTests nested;
+            CHECK_NOTHROW(testSpecificationAndThrow(doc, negative, "Test"));
+        }
+        CHECK_NOTHROW(testSpecificationAndThrow(doc, negative, "Test"));
+    }
+
+    CHECK_THROWS_AS(testSpecificationAndThrow(doc, negative, "Test"), SpecificationError);
+}
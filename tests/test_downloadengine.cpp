@@ -0,0 +1,347 @@
+/*****************************************************************************************
+ *                                                                                       *
+ * OpenSpace                                                                             *
+ *                                                                                       *
+ * Copyright (c) 2014-2023                                                               *
+ *                                                                                       *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this  *
+ * software and associated documentation files (the "Software"), to deal in the Software *
+ * without restriction, including without limitation the rights to use, copy, modify,    *
+ * merge, publish, distribute, sublicense, and/or sell copies of the Software, and to    *
+ * permit persons to whom the Software is furnished to do so, subject to the following   *
+ * conditions:                                                                           *
+ *                                                                                       *
+ * The above copyright notice and this permission notice shall be included in all copies *
+ * or substantial portions of the Software.                                              *
+ *                                                                                       *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,   *
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A         *
+ * PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT    *
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF  *
+ * CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE  *
+ * OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                                         *
+ ****************************************************************************************/
+
+
+#include <catch2/catch_test_macros.hpp>
+
+#include <openspace/util/downloadengine.h>
+#include <atomic>
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <future>
+#include <iostream>
+#include <thread>
+
+using namespace openspace;
+
+namespace {
+    struct Response {
+        DownloadEngine::Result result;
+        std::vector<char> data;
+    };
+
+    Response fetch(DownloadEngine& engine, std::string url) {
+        auto data = std::make_shared<std::vector<char>>();
+        auto promise = std::make_shared<std::promise<DownloadEngine::Result>>();
+        std::future<DownloadEngine::Result> future = promise->get_future();
+
+        DownloadEngine::Transfer transfer;
+        transfer.url = std::move(url);
+        transfer.onData = [data](char* buffer, size_t size) {
+            data->insert(data->end(), buffer, buffer + size);
+            return true;
+        };
+        transfer.onFinish = [promise](const DownloadEngine::Result& result) {
+            promise->set_value(result);
+        };
+        engine.enqueue(std::move(transfer));
+
+        Response res;
+        res.result = future.get();
+        res.data = std::move(*data);
+        return res;
+    }
+
+    std::vector<char> fileContent(size_t size, int seed) {
+        std::vector<char> res(size);
+        for (size_t i = 0; i < size; i++) {
+            res[i] = static_cast<char>((i * 7 + seed) % 251);
+        }
+        return res;
+    }
+
+    std::string fileUrl(const std::filesystem::path& path) {
+        const std::string p = std::filesystem::absolute(path).generic_string();
+        return p.front() == '/' ? "file://" + p : "file:///" + p;
+    }
+
+    // Creates a number of files in the temporary folder that are downloaded using file://
+    // URLs, which are handled by the same code paths as HTTP transfers
+    struct TemporaryFiles {
+        explicit TemporaryFiles(int n) {
+            directory = std::filesystem::temp_directory_path() / "downloadengine-test";
+            std::filesystem::create_directories(directory);
+            for (int i = 0; i < n; i++) {
+                const std::filesystem::path path =
+                    directory / ("file" + std::to_string(i) + ".bin");
+                const std::vector<char> content = fileContent(65536 + i, i);
+                std::ofstream(path, std::ofstream::binary).write(
+                    content.data(),
+                    content.size()
+                );
+                paths.push_back(path);
+            }
+        }
+
+        ~TemporaryFiles() {
+            std::filesystem::remove_all(directory);
+        }
+
+        std::filesystem::path directory;
+        std::vector<std::filesystem::path> paths;
+    };
+
+    int currentThreadCount() {
+#ifdef __linux__
+        std::ifstream status("/proc/self/status");
+        std::string line;
+        while (std::getline(status, line)) {
+            if (line.rfind("Threads:", 0) == 0) {
+                return std::stoi(line.substr(8));
+            }
+        }
+#endif // __linux__
+        return -1;
+    }
+} // namespace
+
+TEST_CASE("DownloadEngine: Local files", "[downloadengine]") {
+    TemporaryFiles files(64);
+    DownloadEngine engine;
+
+    std::atomic_int nFinished = 0;
+    std::vector<std::vector<char>> data(files.paths.size());
+    std::vector<char> success(files.paths.size(), 0);
+    for (size_t i = 0; i < files.paths.size(); i++) {
+        DownloadEngine::Transfer transfer;
+        transfer.url = fileUrl(files.paths[i]);
+        transfer.priority = (i % 2 == 0) ?
+            DownloadEngine::Priority::Blocking :
+            DownloadEngine::Priority::Background;
+        transfer.onData = [&data, i](char* buffer, size_t size) {
+            data[i].insert(data[i].end(), buffer, buffer + size);
+            return true;
+        };
+        transfer.onFinish = [&success, &nFinished, i](const DownloadEngine::Result& r) {
+            success[i] = r.success;
+            nFinished++;
+        };
+        engine.enqueue(std::move(transfer));
+    }
+
+    while (nFinished < static_cast<int>(files.paths.size())) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+
+    for (size_t i = 0; i < files.paths.size(); i++) {
+        CHECK(success[i]);
+        CHECK(data[i] == fileContent(65536 + i, static_cast<int>(i)));
+    }
+
+    const DownloadEngine::Statistics stats = engine.statistics();
+    CHECK(stats.nSucceeded == files.paths.size());
+    CHECK(stats.nFailed == 0);
+    CHECK(stats.nActive == 0);
+    CHECK(stats.peakActive <= 32);
+}
+
+TEST_CASE("DownloadEngine: Missing file", "[downloadengine]") {
+    TemporaryFiles files(0);
+    DownloadEngine engine;
+
+    Response res = fetch(engine, fileUrl(files.directory / "missing.bin"));
+    CHECK_FALSE(res.result.success);
+    CHECK_FALSE(res.result.error.empty());
+    CHECK(res.data.empty());
+}
+
+TEST_CASE("DownloadEngine: Setup failure", "[downloadengine]") {
+    TemporaryFiles files(1);
+    DownloadEngine engine;
+
+    std::promise<DownloadEngine::Result> promise;
+    bool receivedData = false;
+    DownloadEngine::Transfer transfer;
+    transfer.url = fileUrl(files.paths[0]);
+    transfer.onStart = []() { return false; };
+    transfer.onData = [&receivedData](char*, size_t) {
+        receivedData = true;
+        return true;
+    };
+    transfer.onFinish = [&promise](const DownloadEngine::Result& result) {
+        promise.set_value(result);
+    };
+    engine.enqueue(std::move(transfer));
+
+    CHECK_FALSE(promise.get_future().get().success);
+    CHECK_FALSE(receivedData);
+}
+
+TEST_CASE("DownloadEngine: Cancel queued transfers", "[downloadengine]") {
+    TemporaryFiles files(1);
+
+    // Only one transfer at a time, so that most transfers are still queued when they
+    // are cancelled
+    DownloadEngine::Settings settings;
+    settings.maxActiveTransfers = 1;
+    DownloadEngine engine(settings);
+
+    constexpr int NTransfers = 100;
+    std::atomic_int nFinished = 0;
+    std::vector<DownloadEngine::TransferId> ids;
+    for (int i = 0; i < NTransfers; i++) {
+        DownloadEngine::Transfer transfer;
+        transfer.url = fileUrl(files.paths[0]);
+        transfer.onFinish = [&nFinished](const DownloadEngine::Result&) {
+            nFinished++;
+        };
+        ids.push_back(engine.enqueue(std::move(transfer)));
+    }
+    for (DownloadEngine::TransferId id : ids) {
+        engine.cancel(id);
+    }
+
+    while (nFinished < NTransfers) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    const DownloadEngine::Statistics stats = engine.statistics();
+    CHECK(stats.nSucceeded + stats.nFailed == NTransfers);
+    CHECK(stats.nFailed > 0);
+    CHECK(stats.nQueued == 0);
+}
+
+// Requires the local HTTP server in tests/downloadengine/httpfixture.py. Run with:
+//   python tests/downloadengine/httpfixture.py --port 8765
+//   OpenSpaceTest "[.downloadengine-benchmark]"
+// A different server can be selected with the OPENSPACE_DOWNLOAD_FIXTURE environment
+// variable. The throughput and the peak thread count are printed to the console
+TEST_CASE("DownloadEngine: HTTP fixture", "[.downloadengine-benchmark]") {
+    const char* env = std::getenv("OPENSPACE_DOWNLOAD_FIXTURE");
+    const std::string server = env ? env : "http://127.0.0.1:8765";
+
+    DownloadEngine::Settings settings;
+    settings.retryDelay = std::chrono::milliseconds(100);
+    DownloadEngine engine(settings);
+
+    std::vector<char> body(1 << 20);
+    for (size_t i = 0; i < body.size(); i++) {
+        body[i] = static_cast<char>((i * 7) % 251);
+    }
+
+    SECTION("Retry after server errors") {
+        Response res = fetch(engine, server + "/flaky");
+        CHECK(res.result.success);
+        CHECK(res.data == body);
+        CHECK(engine.statistics().nRetries == 2);
+    }
+
+    SECTION("Resume dropped connection") {
+        Response res = fetch(engine, server + "/drop");
+        CHECK(res.result.success);
+        CHECK(res.result.responseCode == 206);
+        CHECK(res.data == body);
+    }
+
+    SECTION("Resume without range support") {
+        Response res = fetch(engine, server + "/norange");
+        CHECK(res.result.success);
+        CHECK(res.result.responseCode == 200);
+        CHECK(res.data == body);
+    }
+
+    SECTION("Client error") {
+        Response res = fetch(engine, server + "/missing");
+        CHECK_FALSE(res.result.success);
+        CHECK(res.result.responseCode == 404);
+        CHECK(res.data.empty());
+        CHECK(engine.statistics().nRetries == 0);
+    }
+
+    SECTION("Cancel active transfer") {
+        std::atomic_bool receivedData = false;
+        std::promise<DownloadEngine::Result> promise;
+        DownloadEngine::Transfer transfer;
+        transfer.url = server + "/stall";
+        transfer.onData = [&receivedData](char*, size_t) {
+            receivedData = true;
+            return true;
+        };
+        transfer.onFinish = [&promise](const DownloadEngine::Result& result) {
+            promise.set_value(result);
+        };
+        const DownloadEngine::TransferId id = engine.enqueue(std::move(transfer));
+
+        // The server stops sending after the first part of the body, so the transfer
+        // stays active until it is cancelled
+        while (!receivedData) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+        engine.cancel(id);
+
+        std::future<DownloadEngine::Result> future = promise.get_future();
+        REQUIRE(future.wait_for(std::chrono::seconds(5)) == std::future_status::ready);
+        const DownloadEngine::Result result = future.get();
+        CHECK_FALSE(result.success);
+        CHECK(result.error == "Cancelled");
+        CHECK(engine.statistics().nActive == 0);
+    }
+
+    SECTION("Throughput") {
+        constexpr int NTransfers = 1000;
+        std::atomic_int nFinished = 0;
+        std::atomic_int nCorrect = 0;
+        const int threadsBefore = currentThreadCount();
+        const auto start = std::chrono::steady_clock::now();
+        for (int i = 0; i < NTransfers; i++) {
+            DownloadEngine::Transfer transfer;
+            transfer.url = server + "/file" + std::to_string(i);
+            transfer.priority = (i % 2 == 0) ?
+                DownloadEngine::Priority::Blocking :
+                DownloadEngine::Priority::Background;
+            auto size = std::make_shared<size_t>(0);
+            transfer.onData = [size](char*, size_t n) {
+                *size += n;
+                return true;
+            };
+            transfer.onFinish = [&, size](const DownloadEngine::Result& result) {
+                if (result.success && *size == (1 << 20)) {
+                    nCorrect++;
+                }
+                nFinished++;
+            };
+            engine.enqueue(std::move(transfer));
+        }
+
+        int peakThreads = threadsBefore;
+        while (nFinished < NTransfers) {
+            peakThreads = std::max(peakThreads, currentThreadCount());
+            std::this_thread::sleep_for(std::chrono::milliseconds(5));
+        }
+        const double seconds = std::chrono::duration<double>(
+            std::chrono::steady_clock::now() - start
+        ).count();
+
+        CHECK(nCorrect == NTransfers);
+        const DownloadEngine::Statistics stats = engine.statistics();
+        CHECK(stats.peakActive <= static_cast<size_t>(settings.maxActiveTransfers));
+
+        std::cout << "Transfers:          " << NTransfers << " x 1 MiB\n";
+        std::cout << "Time:               " << seconds << " s\n";
+        std::cout << "Throughput:         " << NTransfers / seconds << " MiB/s\n";
+        std::cout << "Peak threads:       " << peakThreads << " (before: " <<
+            threadsBefore << ")\n";
+        std::cout << "Peak active:        " << stats.peakActive << '\n';
+    }
+}
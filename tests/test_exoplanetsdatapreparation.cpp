@@ -0,0 +1,132 @@
+/*****************************************************************************************
+ *                                                                                       *
+ * OpenSpace                                                                             *
+ *                                                                                       *
+ * Copyright (c) 2014-2023                                                               *
+ *                                                                                       *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this  *
+ * software and associated documentation files (the "Software"), to deal in the Software *
+ * without restriction, including without limitation the rights to use, copy, modify,    *
+ * merge, publish, distribute, sublicense, and/or sell copies of the Software, and to    *
+ * permit persons to whom the Software is furnished to do so, subject to the following   *
+ * conditions:                                                                           *
+ *                                                                                       *
+ * The above copyright notice and this permission notice shall be included in all copies *
+ * or substantial portions of the Software.                                              *
+ *                                                                                       *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,   *
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A         *
+ * PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT    *
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF  *
+ * CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE  *
+ * OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                                         *
+ ****************************************************************************************/
+
+
+#include <catch2/catch_test_macros.hpp>
+
+#ifdef OPENSPACE_MODULE_EXOPLANETS_ENABLED
+#include <modules/exoplanets/tasks/exoplanetsdatapreparationtask.h>
+#include <ghoul/filesystem/filesystem.h>
+#include <ghoul/misc/dictionary.h>
+#endif // OPENSPACE_MODULE_EXOPLANETS_ENABLED
+#include <cmath>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <string>
+#include <vector>
+
+#ifdef OPENSPACE_MODULE_EXOPLANETS_ENABLED
+
+using namespace openspace::exoplanets;
+
+namespace {
+    std::string readFile(const std::filesystem::path& path) {
+        std::ifstream file(path, std::ifstream::binary);
+        return std::string(std::istreambuf_iterator<char>(file), {});
+    }
+} // namespace
+
+TEST_CASE("ExoplanetsDataPreparationTask: Golden Output", "[exoplanetsdataprep]") {
+    // The expected files were created by the implementation that parsed the rows one
+    // after another, with the padding bytes of the entries set to zero
+    const std::filesystem::path input =
+        absPath("${TESTDIR}/exoplanetsdatapreparation");
+    const std::filesystem::path output =
+        std::filesystem::temp_directory_path() / "exoplanetsdataprep-test";
+    std::filesystem::remove_all(output);
+    std::filesystem::create_directories(output);
+
+    const std::string expectedBin = readFile(input / "expected.bin");
+    const std::string expectedLut = readFile(input / "expected.txt");
+    REQUIRE(expectedBin.size() == sizeof(int) + 150 * sizeof(ExoplanetDataEntry));
+
+    // More than one chunk of rows is parsed by each thread
+    for (int nThreads : { 1, 4 }) {
+        const std::string name = "output" + std::to_string(nThreads);
+
+        ghoul::Dictionary dict;
+        dict.setValue("Type", std::string("ExoplanetsDataPreparationTask"));
+        dict.setValue("InputDataFile", (input / "input.csv").string());
+        dict.setValue("InputSPECK", (input / "stars.speck").string());
+        dict.setValue("TeffToBvFile", (input / "teff_bv.txt").string());
+        dict.setValue("OutputBIN", (output / (name + ".bin")).string());
+        dict.setValue("OutputLUT", (output / (name + ".txt")).string());
+        dict.setValue("Threads", static_cast<double>(nThreads));
+
+        ExoplanetsDataPreparationTask task(dict);
+        task.perform([](float) {});
+
+        CHECK(readFile(output / (name + ".bin")) == expectedBin);
+        CHECK(readFile(output / (name + ".txt")) == expectedLut);
+        CHECK(std::filesystem::is_regular_file(output / (name + ".idx")));
+    }
+
+    std::filesystem::remove_all(output);
+}
+
+TEST_CASE("ExoplanetsDataPreparationTask: Parse Row", "[exoplanetsdataprep]") {
+    const std::vector<std::string> columns = {
+        "pl_name", "hostname", "pl_letter", "pl_orbsmax", "st_teff", "ra", "dec",
+        "sy_dist"
+    };
+    ExoplanetsDataPreparationTask::StarPositions positions;
+    positions["Star A"] = glm::vec3(1.f, 2.f, 3.f);
+    const ExoplanetsDataPreparationTask::TeffToBvTable teffToBv = {
+        { 3000.f, 1.5f }, { 4000.f, 1.f }, { 5000.f, 0.6f }
+    };
+
+    ExoplanetsDataPreparationTask::PlanetData a =
+        ExoplanetsDataPreparationTask::parseDataRow(
+            "\"Star A b\",\"Star A\",b,0.5,3500,10,20,30",
+            columns,
+            positions,
+            teffToBv
+        );
+    CHECK(a.host == "Star A");
+    CHECK(a.name == "Star A b");
+    CHECK(a.component == "b");
+    CHECK(a.dataEntry.a == 0.5f);
+    CHECK(a.dataEntry.teff == 3500.f);
+    CHECK(a.dataEntry.bmv == 1.25f);
+    // The position from the speck file takes precedence over the ICRS coordinates
+    CHECK(a.dataEntry.positionX == 1.f);
+    CHECK(a.dataEntry.positionY == 2.f);
+    CHECK(a.dataEntry.positionZ == 3.f);
+
+    // Missing values and a star that is not in the speck file
+    ExoplanetsDataPreparationTask::PlanetData b =
+        ExoplanetsDataPreparationTask::parseDataRow(
+            "\"Star B c\",\"Star B\",c,,,10,20,30,",
+            columns,
+            positions,
+            teffToBv
+        );
+    CHECK(b.host == "Star B");
+    CHECK(std::isnan(b.dataEntry.a));
+    CHECK(std::isnan(b.dataEntry.bmv));
+    CHECK_FALSE(std::isnan(b.dataEntry.positionX));
+}
+
+#endif // OPENSPACE_MODULE_EXOPLANETS_ENABLED
@@ -0,0 +1,147 @@
+/*****************************************************************************************
+ *                                                                                       *
+ * OpenSpace                                                                             *
+ *                                                                                       *
+ * Copyright (c) 2014-2023                                                               *
+ *                                                                                       *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this  *
+ * software and associated documentation files (the "Software"), to deal in the Software *
+ * without restriction, including without limitation the rights to use, copy, modify,    *
+ * merge, publish, distribute, sublicense, and/or sell copies of the Software, and to    *
+ * permit persons to whom the Software is furnished to do so, subject to the following   *
+ * conditions:                                                                           *
+ *                                                                                       *
+ * The above copyright notice and this permission notice shall be included in all copies *
+ * or substantial portions of the Software.                                              *
+ *                                                                                       *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,   *
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A         *
+ * PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT    *
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF  *
+ * CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE  *
+ * OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                                         *
+ ****************************************************************************************/
+
+
+#include <catch2/catch_test_macros.hpp>
+
+#ifdef OPENSPACE_MODULE_EXOPLANETS_ENABLED
+#include <modules/exoplanets/exoplanetsindex.h>
+#endif // OPENSPACE_MODULE_EXOPLANETS_ENABLED
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include <vector>
+
+#ifdef OPENSPACE_MODULE_EXOPLANETS_ENABLED
+
+using namespace openspace::exoplanets;
+
+namespace {
+    struct TestData {
+        TestData()
+            : path(std::filesystem::temp_directory_path() / "exoplanetsindex-test")
+        {
+            std::filesystem::remove_all(path);
+            std::filesystem::create_directories(path);
+
+            // The names are deliberately out of order to test the sorting of the index
+            const std::vector<std::pair<std::string, std::string>> planets = {
+                { "Kepler-11", "c" },
+                { "HD 209458", "b" },
+                { "Kepler-11", "b" },
+                { "Kepler-1", "b" },
+                { "51 Peg", "b" }
+            };
+
+            std::ofstream data(dataFile(), std::ofstream::binary);
+            std::ofstream lut(lookUpTable());
+            int version = 1;
+            data.write(reinterpret_cast<char*>(&version), sizeof(int));
+
+            std::vector<ExoplanetsIndex::Record> records;
+            for (size_t i = 0; i < planets.size(); i++) {
+                const std::string name = planets[i].first + " " + planets[i].second;
+                const uint64_t pos = static_cast<uint64_t>(data.tellp());
+                lut << name << "," << pos << '\n';
+                records.push_back({
+                    .name = name,
+                    .hostLength = static_cast<uint32_t>(planets[i].first.size()),
+                    .dataOffset = pos
+                });
+
+                ExoplanetDataEntry entry;
+                entry.a = static_cast<float>(i);
+                data.write(reinterpret_cast<char*>(&entry), sizeof(ExoplanetDataEntry));
+            }
+            ExoplanetsIndex::writeIndex(indexFile(), records);
+        }
+
+        ~TestData() {
+            std::filesystem::remove_all(path);
+        }
+
+        std::filesystem::path dataFile() const { return path / "data.bin"; }
+        std::filesystem::path indexFile() const { return path / "lookup.idx"; }
+        std::filesystem::path lookUpTable() const { return path / "lookup.txt"; }
+
+        std::filesystem::path path;
+    };
+
+    void checkIndex(const ExoplanetsIndex& index) {
+        CHECK(index.size() == 5);
+
+        std::vector<ExoplanetsIndex::Planet> kepler11 = index.system("Kepler-11");
+        REQUIRE(kepler11.size() == 2);
+        CHECK(kepler11[0].host == "Kepler-11");
+        CHECK(kepler11[0].name == "Kepler-11 b");
+        CHECK(kepler11[0].data.a == 2.f);
+        CHECK(kepler11[1].name == "Kepler-11 c");
+        CHECK(kepler11[1].data.a == 0.f);
+
+        std::vector<ExoplanetsIndex::Planet> hd = index.system("HD 209458");
+        REQUIRE(hd.size() == 1);
+        CHECK(hd[0].data.a == 1.f);
+
+        CHECK(index.system("Kepler").empty());
+        CHECK(index.system("Kepler-111").empty());
+        CHECK(index.system("").empty());
+
+        std::vector<ExoplanetsIndex::Planet> kepler = index.planetsWithPrefix("Kepler");
+        REQUIRE(kepler.size() == 3);
+        CHECK(kepler[0].name == "Kepler-1 b");
+        CHECK(kepler[1].name == "Kepler-11 b");
+        CHECK(kepler[2].name == "Kepler-11 c");
+
+        std::vector<ExoplanetsIndex::Planet> all = index.planetsWithPrefix("");
+        REQUIRE(all.size() == 5);
+        CHECK(all[0].name == "51 Peg b");
+        CHECK(all[0].data.a == 4.f);
+        CHECK(all[1].name == "HD 209458 b");
+
+        CHECK(index.planetsWithPrefix("Z").empty());
+    }
+} // namespace
+
+TEST_CASE("ExoplanetsIndex: Binary Index", "[exoplanetsindex]") {
+    TestData data;
+    ExoplanetsIndex index(data.dataFile(), data.indexFile(), data.lookUpTable());
+    checkIndex(index);
+}
+
+TEST_CASE("ExoplanetsIndex: Look-up Table Fallback", "[exoplanetsindex]") {
+    TestData data;
+    std::filesystem::remove(data.indexFile());
+    ExoplanetsIndex index(data.dataFile(), data.indexFile(), data.lookUpTable());
+    checkIndex(index);
+}
+
+TEST_CASE("ExoplanetsIndex: Truncated Data File", "[exoplanetsindex]") {
+    TestData data;
+    std::filesystem::resize_file(data.dataFile(), 3 * sizeof(ExoplanetDataEntry));
+    CHECK_THROWS(
+        ExoplanetsIndex(data.dataFile(), data.indexFile(), data.lookUpTable())
+    );
+}
+
+#endif // OPENSPACE_MODULE_EXOPLANETS_ENABLED
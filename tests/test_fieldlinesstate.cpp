@@ -0,0 +1,237 @@
+/*****************************************************************************************
+ *                                                                                       *
+ * OpenSpace                                                                             *
+ *                                                                                       *
+ * Copyright (c) 2014-2023                                                               *
+ *                                                                                       *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this  *
+ * software and associated documentation files (the "Software"), to deal in the Software *
+ * without restriction, including without limitation the rights to use, copy, modify,    *
+ * merge, publish, distribute, sublicense, and/or sell copies of the Software, and to    *
+ * permit persons to whom the Software is furnished to do so, subject to the following   *
+ * conditions:                                                                           *
+ *                                                                                       *
+ * The above copyright notice and this permission notice shall be included in all copies *
+ * or substantial portions of the Software.                                              *
+ *                                                                                       *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,   *
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A         *
+ * PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT    *
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF  *
+ * CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE  *
+ * OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                                         *
+ ****************************************************************************************/
+
+
+#ifdef OPENSPACE_MODULE_FIELDLINESSEQUENCE_ENABLED
+
+#include <catch2/catch_test_macros.hpp>
+
+#include <modules/fieldlinessequence/util/fieldlinesstate.h>
+#include <openspace/util/spicemanager.h>
+#include <openspace/util/time.h>
+#include <ghoul/filesystem/filesystem.h>
+#include <filesystem>
+#include <fstream>
+
+using namespace openspace;
+
+namespace {
+    // The lines are intentionally not in alphabetical order and contain keys that are
+    // not used by the reader
+    constexpr const char* Json = R"({
+        "b": {
+            "time": "2000-01-01T00:00:00.000",
+            "meta": { "source": "test", "values": [1, 2, 3] },
+            "trace": {
+                "columns": ["x", "y", "z", "rho", "t"],
+                "data": [[1, 2, 3, 0.5, 10], [4, 5, 6, 1.5, 20]]
+            }
+        },
+        "a": {
+            "time": "2000-01-01T00:00:00.000",
+            "trace": {
+                "columns": ["x", "y", "z", "rho", "t"],
+                "data": [[7.0, 8.0, 9.0, 2.5, -30]]
+            }
+        }
+    })";
+
+    struct TestDirectory {
+        TestDirectory()
+            : path(std::filesystem::temp_directory_path() / "fieldlinesstate-test")
+        {
+            std::filesystem::remove_all(path);
+            std::filesystem::create_directories(path);
+
+            SpiceManager::initialize();
+            SpiceManager::ref().loadKernel(
+                absPath("${TESTDIR}/SpiceTest/spicekernels/naif0008.tls").string()
+            );
+        }
+
+        ~TestDirectory() {
+            SpiceManager::deinitialize();
+            std::filesystem::remove_all(path);
+        }
+
+        std::string writeFile(const std::string& name, const std::string& content) const
+        {
+            const std::filesystem::path file = path / name;
+            std::ofstream(file) << content;
+            return file.string();
+        }
+
+        std::filesystem::path path;
+    };
+
+    std::string saveState(FieldlinesState& state, const std::filesystem::path& folder) {
+        state.saveStateToOsfls((folder / "").string());
+        for (const std::filesystem::directory_entry& e :
+             std::filesystem::directory_iterator(folder))
+        {
+            if (e.path().extension() == ".osfls") {
+                return e.path().string();
+            }
+        }
+        return "";
+    }
+} // namespace
+
+TEST_CASE("FieldlinesState: Load Json", "[fieldlinesstate]") {
+    TestDirectory dir;
+    const std::string file = dir.writeFile("state.json", Json);
+
+    FieldlinesState state;
+    REQUIRE(state.loadStateFromJson(file, fls::Model::Batsrus, 2.f));
+
+    CHECK(state.model() == fls::Model::Batsrus);
+    CHECK(state.triggerTime() == Time::convertTime("2000-01-01T00:00:00.000"));
+
+    // The lines are stored in the order in which they appear in the file
+    REQUIRE(state.lineStart() == std::vector<GLint>{ 0, 2 });
+    REQUIRE(state.lineCount() == std::vector<GLsizei>{ 2, 1 });
+    REQUIRE(state.vertexPositions().size() == 3);
+    CHECK(state.vertexPositions()[0] == glm::vec3(2.f, 4.f, 6.f));
+    CHECK(state.vertexPositions()[2] == glm::vec3(14.f, 16.f, 18.f));
+
+    REQUIRE(state.extraQuantityNames() == std::vector<std::string>{ "rho", "t" });
+    bool isSuccessful = false;
+    std::span<const float> rho = state.extraQuantity(0, isSuccessful);
+    CHECK(isSuccessful);
+    CHECK(std::vector<float>(rho.begin(), rho.end()) == std::vector{ 0.5f, 1.5f, 2.5f });
+    std::span<const float> t = state.extraQuantity(1, isSuccessful);
+    CHECK(std::vector<float>(t.begin(), t.end()) == std::vector{ 10.f, 20.f, -30.f });
+
+    state.extraQuantity(2, isSuccessful);
+    CHECK_FALSE(isSuccessful);
+}
+
+TEST_CASE("FieldlinesState: Invalid Json", "[fieldlinesstate]") {
+    TestDirectory dir;
+    FieldlinesState state;
+
+    const std::string broken = dir.writeFile("broken.json", R"({ "a": { "time": )");
+    CHECK_FALSE(state.loadStateFromJson(broken, fls::Model::Batsrus, 1.f));
+
+    const std::string missingColumns = dir.writeFile(
+        "columns.json",
+        R"({ "a": { "time": "2000-01-01T00:00:00.000", "trace": {
+            "columns": ["x", "y"], "data": [[1, 2, 3]]
+        } } })"
+    );
+    CHECK_FALSE(state.loadStateFromJson(missingColumns, fls::Model::Batsrus, 1.f));
+
+    const std::string inconsistent = dir.writeFile(
+        "inconsistent.json",
+        R"({ "a": { "time": "2000-01-01T00:00:00.000", "trace": {
+            "columns": ["x", "y", "z", "rho"], "data": [[1, 2, 3, 4], [1, 2, 3]]
+        } } })"
+    );
+    CHECK_FALSE(state.loadStateFromJson(inconsistent, fls::Model::Batsrus, 1.f));
+
+    const std::string missing = (dir.path / "missing.json").string();
+    CHECK_FALSE(state.loadStateFromJson(missing, fls::Model::Pfss, 1.f));
+}
+
+TEST_CASE("FieldlinesState: Osfls Round Trip", "[fieldlinesstate]") {
+    TestDirectory dir;
+    const std::string json = dir.writeFile("state.json", Json);
+    FieldlinesState state;
+    REQUIRE(state.loadStateFromJson(json, fls::Model::Enlil, 1.f));
+
+    const std::string file = saveState(state, dir.path);
+    REQUIRE_FALSE(file.empty());
+
+    FieldlinesState loaded;
+    REQUIRE(loaded.loadStateFromOsfls(file));
+    CHECK(loaded.model() == fls::Model::Enlil);
+    CHECK(loaded.triggerTime() == state.triggerTime());
+    CHECK(loaded.lineStart() == state.lineStart());
+    CHECK(loaded.lineCount() == state.lineCount());
+    CHECK(loaded.vertexPositions() == state.vertexPositions());
+    CHECK(loaded.extraQuantityNames() == state.extraQuantityNames());
+    REQUIRE(loaded.nExtraQuantities() == 2);
+    for (size_t i = 0; i < loaded.nExtraQuantities(); ++i) {
+        bool isSuccessful = false;
+        std::span<const float> expected = state.extraQuantity(i, isSuccessful);
+        std::span<const float> values = loaded.extraQuantity(i, isSuccessful);
+        REQUIRE(isSuccessful);
+        // The values are used directly from the mapped file, which is aligned
+        CHECK(reinterpret_cast<uintptr_t>(values.data()) % alignof(float) == 0);
+        CHECK(std::equal(values.begin(), values.end(), expected.begin(), expected.end()));
+    }
+
+    // Loading a state into an existing state replaces all of its contents
+    REQUIRE(loaded.loadStateFromJson(json, fls::Model::Pfss, 1.f));
+    CHECK(loaded.model() == fls::Model::Pfss);
+    CHECK(loaded.nExtraQuantities() == 2);
+}
+
+TEST_CASE("FieldlinesState: Osfls Copied Extra Quantities", "[fieldlinesstate]") {
+    TestDirectory dir;
+    const std::string json = dir.writeFile("state.json", Json);
+    FieldlinesState state;
+    REQUIRE(state.loadStateFromJson(json, fls::Model::Enlil, 1.f));
+    const std::string file = saveState(state, dir.path);
+    REQUIRE_FALSE(file.empty());
+
+    FieldlinesState loaded;
+    REQUIRE(loaded.loadStateFromOsfls(file, { 1 }));
+    REQUIRE(loaded.nExtraQuantities() == 2);
+    for (size_t i = 0; i < loaded.nExtraQuantities(); ++i) {
+        bool isSuccessful = false;
+        std::span<const float> expected = state.extraQuantity(i, isSuccessful);
+        std::span<const float> values = loaded.extraQuantity(i, isSuccessful);
+        REQUIRE(isSuccessful);
+        CHECK(std::equal(values.begin(), values.end(), expected.begin(), expected.end()));
+    }
+
+    // Loading the next state reuses the memory of the copied quantity
+    bool isSuccessful = false;
+    const float* copied = loaded.extraQuantity(1, isSuccessful).data();
+    REQUIRE(loaded.loadStateFromOsfls(file, { 1 }));
+    CHECK(loaded.extraQuantity(1, isSuccessful).data() == copied);
+
+    // A quantity that is not copied is read from the file
+    REQUIRE(loaded.loadStateFromOsfls(file));
+    std::span<const float> values = loaded.extraQuantity(1, isSuccessful);
+    std::span<const float> expected = state.extraQuantity(1, isSuccessful);
+    CHECK(values.data() != copied);
+    CHECK(std::equal(values.begin(), values.end(), expected.begin(), expected.end()));
+}
+
+TEST_CASE("FieldlinesState: Corrupt Osfls", "[fieldlinesstate]") {
+    TestDirectory dir;
+    const std::string json = dir.writeFile("state.json", Json);
+    FieldlinesState state;
+    REQUIRE(state.loadStateFromJson(json, fls::Model::Batsrus, 1.f));
+    const std::string file = saveState(state, dir.path);
+    REQUIRE_FALSE(file.empty());
+
+    std::filesystem::resize_file(file, std::filesystem::file_size(file) - 8);
+    FieldlinesState loaded;
+    CHECK_FALSE(loaded.loadStateFromOsfls(file));
+}
+
+#endif // OPENSPACE_MODULE_FIELDLINESSEQUENCE_ENABLED
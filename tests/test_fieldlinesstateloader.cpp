@@ -0,0 +1,150 @@
+/*****************************************************************************************
+ *                                                                                       *
+ * OpenSpace                                                                             *
+ *                                                                                       *
+ * Copyright (c) 2014-2023                                                               *
+ *                                                                                       *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this  *
+ * software and associated documentation files (the "Software"), to deal in the Software *
+ * without restriction, including without limitation the rights to use, copy, modify,    *
+ * merge, publish, distribute, sublicense, and/or sell copies of the Software, and to    *
+ * permit persons to whom the Software is furnished to do so, subject to the following   *
+ * conditions:                                                                           *
+ *                                                                                       *
+ * The above copyright notice and this permission notice shall be included in all copies *
+ * or substantial portions of the Software.                                              *
+ *                                                                                       *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,   *
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A         *
+ * PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT    *
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF  *
+ * CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE  *
+ * OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                                         *
+ ****************************************************************************************/
+
+
+#ifdef OPENSPACE_MODULE_FIELDLINESSEQUENCE_ENABLED
+
+#include <catch2/catch_test_macros.hpp>
+
+#include <modules/fieldlinessequence/util/fieldlinesstateloader.h>
+#include <filesystem>
+#include <fstream>
+#include <thread>
+
+using namespace openspace;
+
+namespace {
+    // Writes a state with a single line of nPoints points to an .osfls file
+    std::string writeState(const std::filesystem::path& path, double time,
+                           size_t nPoints)
+    {
+        std::ofstream file(path, std::ofstream::binary);
+        const int version = 0;
+        const int32_t model = 0;
+        const bool isMorphable = false;
+        const uint64_t nLines = 1;
+        const uint64_t points = nPoints;
+        const uint64_t nExtras = 0;
+        const uint64_t nNameBytes = 0;
+        file.write(reinterpret_cast<const char*>(&version), sizeof(int));
+        file.write(reinterpret_cast<const char*>(&time), sizeof(double));
+        file.write(reinterpret_cast<const char*>(&model), sizeof(int32_t));
+        file.write(reinterpret_cast<const char*>(&isMorphable), sizeof(bool));
+        file.write(reinterpret_cast<const char*>(&nLines), sizeof(uint64_t));
+        file.write(reinterpret_cast<const char*>(&points), sizeof(uint64_t));
+        file.write(reinterpret_cast<const char*>(&nExtras), sizeof(uint64_t));
+        file.write(reinterpret_cast<const char*>(&nNameBytes), sizeof(uint64_t));
+
+        const int32_t lineStart = 0;
+        const uint32_t lineCount = static_cast<uint32_t>(nPoints);
+        file.write(reinterpret_cast<const char*>(&lineStart), sizeof(int32_t));
+        file.write(reinterpret_cast<const char*>(&lineCount), sizeof(uint32_t));
+        const std::vector<float> positions(3 * nPoints, static_cast<float>(time));
+        file.write(
+            reinterpret_cast<const char*>(positions.data()),
+            positions.size() * sizeof(float)
+        );
+        return path.string();
+    }
+
+    struct TestStates {
+        TestStates()
+            : directory(std::filesystem::temp_directory_path() / "fieldlinesloader-test")
+        {
+            std::filesystem::remove_all(directory);
+            std::filesystem::create_directories(directory);
+            for (int i = 0; i < 10; i++) {
+                const std::string name = std::to_string(i) + ".osfls";
+                files.push_back(writeState(directory / name, i, 100 + i));
+            }
+        }
+
+        ~TestStates() {
+            std::filesystem::remove_all(directory);
+        }
+
+        std::filesystem::path directory;
+        std::vector<std::string> files;
+    };
+
+    bool waitForSwap(FieldlinesStateLoader& loader, int index, FieldlinesState& state,
+                     int stateIndex)
+    {
+        for (int i = 0; i < 1000; i++) {
+            if (loader.swap(index, state, stateIndex)) {
+                return true;
+            }
+            std::this_thread::sleep_for(std::chrono::milliseconds(5));
+        }
+        return false;
+    }
+} // namespace
+
+TEST_CASE("FieldlinesStateLoader: Load Requested States", "[fieldlinesstateloader]") {
+    TestStates states;
+    FieldlinesStateLoader loader(states.files, 2, 4);
+
+    loader.request({ 3, 4, 2 });
+    FieldlinesState state;
+    REQUIRE(waitForSwap(loader, 3, state, -1));
+    CHECK(state.triggerTime() == 3.0);
+    CHECK(state.vertexPositions().size() == 103);
+
+    REQUIRE(waitForSwap(loader, 4, state, 3));
+    CHECK(state.triggerTime() == 4.0);
+
+    // The previous state was handed back to the loader and can be swapped in again
+    loader.request({ 3, 4 });
+    REQUIRE(loader.swap(3, state, 4));
+    CHECK(state.triggerTime() == 3.0);
+
+    const FieldlinesStateLoader::Statistics stats = loader.statistics();
+    CHECK(stats.nLoaded >= 2);
+    CHECK(stats.maxLatency >= stats.averageLatency);
+}
+
+TEST_CASE("FieldlinesStateLoader: Unrequested States", "[fieldlinesstateloader]") {
+    TestStates states;
+    FieldlinesStateLoader loader(states.files, 1, 3);
+
+    FieldlinesState state;
+    CHECK_FALSE(loader.swap(0, state, -1));
+
+    loader.request({ 0, 1 });
+    REQUIRE(waitForSwap(loader, 0, state, -1));
+    for (int i = 0; i < 1000 && loader.statistics().nLoaded < 2; i++) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(5));
+    }
+    REQUIRE(loader.statistics().nLoaded == 2);
+
+    // Requesting other states discards the state that was loaded but not swapped in
+    loader.request({ 5 });
+    CHECK_FALSE(loader.swap(1, state, -1));
+
+    // Indices outside of the sequence are ignored
+    loader.request({ -1, 100 });
+    CHECK_FALSE(loader.swap(100, state, -1));
+}
+
+#endif // OPENSPACE_MODULE_FIELDLINESSEQUENCE_ENABLED
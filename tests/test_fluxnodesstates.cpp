@@ -0,0 +1,168 @@
+/*****************************************************************************************
+ *                                                                                       *
+ * OpenSpace                                                                             *
+ *                                                                                       *
+ * Copyright (c) 2014-2023                                                               *
+ *                                                                                       *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this  *
+ * software and associated documentation files (the "Software"), to deal in the Software *
+ * without restriction, including without limitation the rights to use, copy, modify,    *
+ * merge, publish, distribute, sublicense, and/or sell copies of the Software, and to    *
+ * permit persons to whom the Software is furnished to do so, subject to the following   *
+ * conditions:                                                                           *
+ *                                                                                       *
+ * The above copyright notice and this permission notice shall be included in all copies *
+ * or substantial portions of the Software.                                              *
+ *                                                                                       *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,   *
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A         *
+ * PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT    *
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF  *
+ * CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE  *
+ * OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                                         *
+ ****************************************************************************************/
+
+
+#include <catch2/catch_test_macros.hpp>
+
+#ifdef OPENSPACE_MODULE_SPACE_ENABLED
+#include <modules/space/fluxnodesstates.h>
+#include <ghoul/misc/exception.h>
+#endif // OPENSPACE_MODULE_SPACE_ENABLED
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <span>
+
+#ifdef OPENSPACE_MODULE_SPACE_ENABLED
+
+using namespace openspace;
+
+namespace {
+    constexpr uint32_t NStates = 4;
+    constexpr uint32_t NNodes = 5;
+
+    struct TestDirectory {
+        TestDirectory()
+            : path(std::filesystem::temp_directory_path() / "fluxnodesstates-test")
+        {
+            std::filesystem::remove_all(path);
+            std::filesystem::create_directories(path);
+
+            std::ofstream positions(path / "positions", std::ofstream::binary);
+            positions.write(reinterpret_cast<const char*>(&NNodes), sizeof(uint32_t));
+            positions.write(reinterpret_cast<const char*>(&NStates), sizeof(uint32_t));
+            std::ofstream fluxes(path / "fluxes", std::ofstream::binary);
+            std::ofstream radii(path / "radii", std::ofstream::binary);
+            for (uint32_t s = 0; s < NStates; ++s) {
+                for (uint32_t n = 0; n < NNodes; ++n) {
+                    const glm::vec3 p = position(s, n);
+                    positions.write(reinterpret_cast<const char*>(&p), sizeof(glm::vec3));
+                    const float f = flux(s, n);
+                    fluxes.write(reinterpret_cast<const char*>(&f), sizeof(float));
+                    const float r = radius(s, n);
+                    radii.write(reinterpret_cast<const char*>(&r), sizeof(float));
+                }
+            }
+        }
+
+        ~TestDirectory() {
+            std::filesystem::remove_all(path);
+        }
+
+        static glm::vec3 position(uint32_t state, uint32_t node) {
+            return glm::vec3(state, node, state * 100.f + node);
+        }
+
+        static float flux(uint32_t state, uint32_t node) {
+            return -static_cast<float>(state * 10 + node);
+        }
+
+        static float radius(uint32_t state, uint32_t node) {
+            return 0.5f * (state * 10 + node);
+        }
+
+        std::filesystem::path path;
+    };
+
+    void checkStates(const FluxNodesStates& states) {
+        REQUIRE(states.nStates() == NStates);
+        REQUIRE(states.nNodesPerState() == NNodes);
+        CHECK(
+            states.sizeInBytes() ==
+            NStates * NNodes * (sizeof(glm::vec3) + 2 * sizeof(float))
+        );
+
+        for (uint32_t s = 0; s < NStates; ++s) {
+            const std::span<const glm::vec3> positions = states.positions(s);
+            const std::span<const float> fluxes = states.fluxes(s);
+            const std::span<const float> radii = states.radii(s);
+            REQUIRE(positions.size() == NNodes);
+            REQUIRE(fluxes.size() == NNodes);
+            REQUIRE(radii.size() == NNodes);
+            for (uint32_t n = 0; n < NNodes; ++n) {
+                CHECK(positions[n] == TestDirectory::position(s, n));
+                CHECK(fluxes[n] == TestDirectory::flux(s, n));
+                CHECK(radii[n] == TestDirectory::radius(s, n));
+            }
+        }
+    }
+} // namespace
+
+TEST_CASE("FluxNodesStates: Read", "[fluxnodesstates]") {
+    TestDirectory dir;
+    FluxNodesStates states(
+        dir.path / "positions",
+        dir.path / "fluxes",
+        dir.path / "radii",
+        false
+    );
+    CHECK_FALSE(states.isMemoryMapped());
+    checkStates(states);
+}
+
+TEST_CASE("FluxNodesStates: Memory Mapped", "[fluxnodesstates]") {
+    TestDirectory dir;
+    FluxNodesStates states(
+        dir.path / "positions",
+        dir.path / "fluxes",
+        dir.path / "radii",
+        true
+    );
+    CHECK(states.isMemoryMapped());
+    checkStates(states);
+}
+
+TEST_CASE("FluxNodesStates: Invalid Files", "[fluxnodesstates]") {
+    TestDirectory dir;
+    for (bool memoryMap : { false, true }) {
+        CHECK_THROWS_AS(
+            FluxNodesStates(
+                dir.path / "missing",
+                dir.path / "fluxes",
+                dir.path / "radii",
+                memoryMap
+            ),
+            ghoul::RuntimeError
+        );
+    }
+
+    // A flux file that is missing the last value
+    std::filesystem::resize_file(
+        dir.path / "fluxes",
+        NStates * NNodes * sizeof(float) - sizeof(float)
+    );
+    for (bool memoryMap : { false, true }) {
+        CHECK_THROWS_AS(
+            FluxNodesStates(
+                dir.path / "positions",
+                dir.path / "fluxes",
+                dir.path / "radii",
+                memoryMap
+            ),
+            ghoul::RuntimeError
+        );
+    }
+}
+
+#endif // OPENSPACE_MODULE_SPACE_ENABLED
@@ -0,0 +1,166 @@
+/*****************************************************************************************
+ *                                                                                       *
+ * OpenSpace                                                                             *
+ *                                                                                       *
+ * Copyright (c) 2014-2023                                                               *
+ *                                                                                       *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this  *
+ * software and associated documentation files (the "Software"), to deal in the Software *
+ * without restriction, including without limitation the rights to use, copy, modify,    *
+ * merge, publish, distribute, sublicense, and/or sell copies of the Software, and to    *
+ * permit persons to whom the Software is furnished to do so, subject to the following   *
+ * conditions:                                                                           *
+ *                                                                                       *
+ * The above copyright notice and this permission notice shall be included in all copies *
+ * or substantial portions of the Software.                                              *
+ *                                                                                       *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,   *
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A         *
+ * PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT    *
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF  *
+ * CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE  *
+ * OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                                         *
+ ****************************************************************************************/
+
+#include <catch2/catch_test_macros.hpp>
+
+#ifdef OPENSPACE_MODULE_SPACE_ENABLED
+
+#include <modules/space/tasks/generatedebrisvolumetask.h>
+#include <modules/volume/rawvolume.h>
+#include <ghoul/glm.h>
+#include <algorithm>
+#include <cmath>
+#include <random>
+#include <vector>
+
+using namespace openspace::volume;
+
+namespace {
+    const glm::uvec3 Dimensions = glm::uvec3(16, 8, 12);
+    constexpr float MaxApogee = 4.2e7f;
+
+    // Random positions in a box that is slightly larger than the grid, so that some of
+    // the positions fall outside of it
+    std::vector<glm::dvec3> randomPositions(size_t n) {
+        std::mt19937 gen(1337);
+        std::uniform_real_distribution<double> dist(-1.1 * MaxApogee, 1.1 * MaxApogee);
+        std::vector<glm::dvec3> res(n);
+        for (glm::dvec3& p : res) {
+            p = glm::dvec3(dist(gen), dist(gen), dist(gen));
+        }
+        // The center and the boundaries are the interesting edge cases
+        res[0] = glm::dvec3(0.0);
+        res[1] = glm::dvec3(MaxApogee, 0.0, 0.0);
+        res[2] = glm::dvec3(-MaxApogee, -MaxApogee, -MaxApogee);
+        res[3] = glm::dvec3(-1.0, 0.0, 0.0);
+        return res;
+    }
+
+    // The voxel index of a single position, computed one coordinate at a time
+    uint32_t serialVoxelIndex(glm::dvec3 p, bool isSpherical) {
+        const glm::uvec3 dim = Dimensions;
+        const double maxApogee = static_cast<double>(MaxApogee);
+        glm::uvec3 coords = glm::uvec3(0);
+        if (isSpherical) {
+            const double r = std::sqrt(p.x * p.x + p.y * p.y + p.z * p.z);
+            const double cosTheta = r > 0.0 ? std::clamp(p.z / r, -1.0, 1.0) : 1.0;
+            const double theta = std::acos(cosTheta);
+            const double phi = std::atan2(p.y, p.x) + glm::pi<double>();
+
+            const double x = r * (dim.x / maxApogee);
+            const double y = theta * (dim.y / glm::pi<double>());
+            const double z = phi * (dim.z / glm::two_pi<double>());
+            coords.x = std::min(static_cast<uint32_t>(x), dim.x - 1);
+            coords.y = std::min(static_cast<uint32_t>(y), dim.y - 1);
+            coords.z = static_cast<uint32_t>(z) % dim.z;
+        }
+        else {
+            const glm::dvec3 v = (p + maxApogee) * (glm::dvec3(dim) / (2.0 * maxApogee));
+            for (int i = 0; i < 3; i++) {
+                const double maxIdx = static_cast<double>(dim[i] - 1);
+                coords[i] = static_cast<uint32_t>(std::clamp(v[i], 0.0, maxIdx));
+            }
+        }
+        return coords.z * dim.x * dim.y + coords.y * dim.x + coords.x;
+    }
+
+    void compareVoxelIndices(bool isSpherical) {
+        const std::vector<glm::dvec3> positions = randomPositions(1000);
+        std::vector<uint32_t> indices(positions.size());
+        computeVoxelIndices(
+            positions,
+            Dimensions,
+            MaxApogee,
+            isSpherical,
+            indices.data()
+        );
+
+        const uint32_t nCells = Dimensions.x * Dimensions.y * Dimensions.z;
+        for (size_t i = 0; i < positions.size(); i++) {
+            CHECK(indices[i] < nCells);
+            CHECK(indices[i] == serialVoxelIndex(positions[i], isSpherical));
+        }
+    }
+
+    void compareDensities(bool isSpherical) {
+        // Enough positions for each of the threads to process multiple chunks
+        const std::vector<glm::dvec3> positions = randomPositions(10000);
+        const std::vector<double> inverseVolumes =
+            isSpherical ?
+            computeInverseVoxelVolumes(Dimensions, MaxApogee) :
+            std::vector<double>();
+
+        // Serial reference that counts one position after another
+        const size_t nCells = static_cast<size_t>(Dimensions.x) * Dimensions.y *
+            Dimensions.z;
+        std::vector<uint32_t> counts(nCells, 0);
+        for (const glm::dvec3& p : positions) {
+            counts[serialVoxelIndex(p, isSpherical)]++;
+        }
+        std::vector<float> expected(nCells);
+        const size_t sliceSize = static_cast<size_t>(Dimensions.x) * Dimensions.y;
+        for (size_t i = 0; i < nCells; i++) {
+            expected[i] = isSpherical ?
+                static_cast<float>(counts[i] * inverseVolumes[i % sliceSize]) :
+                static_cast<float>(counts[i]);
+        }
+
+        for (size_t nThreads : { 1, 2, 4 }) {
+            std::vector<std::vector<uint32_t>> histograms(
+                nThreads,
+                std::vector<uint32_t>(nCells)
+            );
+            RawVolume<float> raw(Dimensions);
+            mapDensityToVoxels(
+                positions,
+                Dimensions,
+                MaxApogee,
+                isSpherical,
+                inverseVolumes,
+                histograms,
+                raw
+            );
+
+            CHECK(std::equal(expected.begin(), expected.end(), raw.data()));
+        }
+    }
+} // namespace
+
+TEST_CASE("GenerateDebrisVolumeTask: Cartesian Voxel Indices", "[debrisvolume]") {
+    compareVoxelIndices(false);
+}
+
+TEST_CASE("GenerateDebrisVolumeTask: Spherical Voxel Indices", "[debrisvolume]") {
+    compareVoxelIndices(true);
+}
+
+TEST_CASE("GenerateDebrisVolumeTask: Cartesian Densities", "[debrisvolume]") {
+    compareDensities(false);
+}
+
+TEST_CASE("GenerateDebrisVolumeTask: Spherical Densities", "[debrisvolume]") {
+    compareDensities(true);
+}
+
+#endif // OPENSPACE_MODULE_SPACE_ENABLED
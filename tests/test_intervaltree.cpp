@@ -0,0 +1,170 @@
+/*****************************************************************************************
+ *                                                                                       *
+ * OpenSpace                                                                             *
+ *                                                                                       *
+ * Copyright (c) 2014-2023                                                               *
+ *                                                                                       *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this  *
+ * software and associated documentation files (the "Software"), to deal in the Software *
+ * without restriction, including without limitation the rights to use, copy, modify,    *
+ * merge, publish, distribute, sublicense, and/or sell copies of the Software, and to    *
+ * permit persons to whom the Software is furnished to do so, subject to the following   *
+ * conditions:                                                                           *
+ *                                                                                       *
+ * The above copyright notice and this permission notice shall be included in all copies *
+ * or substantial portions of the Software.                                              *
+ *                                                                                       *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,   *
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A         *
+ * PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT    *
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF  *
+ * CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE  *
+ * OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                                         *
+ ****************************************************************************************/
+
+
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/benchmark/catch_benchmark.hpp>
+
+#include <openspace/util/intervaltree.h>
+#include <algorithm>
+#include <random>
+#include <vector>
+
+using namespace openspace;
+
+namespace {
+    std::vector<int> bruteForce(const std::vector<IntervalTree<int>::Interval>& intervals,
+                                double time)
+    {
+        std::vector<int> res;
+        for (const IntervalTree<int>::Interval& i : intervals) {
+            if (i.start <= time && time <= i.end) {
+                res.push_back(i.data);
+            }
+        }
+        std::sort(res.begin(), res.end());
+        return res;
+    }
+
+    std::vector<int> query(const IntervalTree<int>& tree, double time) {
+        std::vector<int> res;
+        tree.query(time, [&res](const IntervalTree<int>::Interval& i) {
+            res.push_back(i.data);
+            return false;
+        });
+        std::sort(res.begin(), res.end());
+        return res;
+    }
+
+    // Creates a timeline similar to that of a mission in which a number of instruments
+    // take short, mostly sequential observations with occasional long observations
+    std::vector<IntervalTree<int>::Interval> missionTimeline(int nIntervals) {
+        std::mt19937 rng(1337);
+        std::uniform_real_distribution<double> gap(0.0, 120.0);
+        std::uniform_real_distribution<double> duration(1.0, 60.0);
+        std::uniform_int_distribution<int> instrument(0, 15);
+
+        std::vector<IntervalTree<int>::Interval> res;
+        double time = 0.0;
+        for (int i = 0; i < nIntervals; i++) {
+            time += gap(rng);
+            const double d = i % 100 == 0 ? 100.0 * duration(rng) : duration(rng);
+            res.push_back({ time, time + d, instrument(rng) });
+        }
+        return res;
+    }
+} // namespace
+
+TEST_CASE("IntervalTree: Empty", "[intervaltree]") {
+    IntervalTree<int> tree;
+    CHECK(tree.empty());
+    CHECK(query(tree, 0.0).empty());
+    CHECK(tree.findFirst(0.0, [](int) { return true; }) == nullptr);
+}
+
+TEST_CASE("IntervalTree: Closed Intervals", "[intervaltree]") {
+    IntervalTree<int> tree({ { 10.0, 20.0, 0 }, { 0.0, 5.0, 1 }, { 15.0, 15.0, 2 } });
+    REQUIRE(tree.size() == 3);
+    CHECK(tree.intervals().front().data == 1);
+
+    CHECK(query(tree, -1.0).empty());
+    CHECK(query(tree, 0.0) == std::vector<int>{ 1 });
+    CHECK(query(tree, 5.0) == std::vector<int>{ 1 });
+    CHECK(query(tree, 7.5).empty());
+    CHECK(query(tree, 15.0) == std::vector<int>{ 0, 2 });
+    CHECK(query(tree, 20.0) == std::vector<int>{ 0 });
+    CHECK(query(tree, 20.5).empty());
+}
+
+TEST_CASE("IntervalTree: Find First", "[intervaltree]") {
+    IntervalTree<int> tree({ { 0.0, 100.0, 0 }, { 10.0, 20.0, 1 }, { 5.0, 50.0, 2 } });
+
+    // The intervals are visited in the order of their start time
+    const IntervalTree<int>::Interval* any =
+        tree.findFirst(15.0, [](int) { return true; });
+    REQUIRE(any);
+    CHECK(any->data == 0);
+
+    const IntervalTree<int>::Interval* odd =
+        tree.findFirst(15.0, [](int i) { return i % 2 == 1; });
+    REQUIRE(odd);
+    CHECK(odd->data == 1);
+    CHECK(tree.findFirst(30.0, [](int i) { return i == 1; }) == nullptr);
+}
+
+TEST_CASE("IntervalTree: Random", "[intervaltree]") {
+    std::mt19937 rng(42);
+    std::uniform_real_distribution<double> start(0.0, 1000.0);
+    std::uniform_real_distribution<double> duration(0.0, 50.0);
+
+    for (int n : { 1, 2, 3, 10, 100, 1000 }) {
+        std::vector<IntervalTree<int>::Interval> intervals;
+        for (int i = 0; i < n; i++) {
+            const double s = start(rng);
+            intervals.push_back({ s, s + duration(rng), i });
+        }
+        IntervalTree<int> tree(intervals);
+
+        for (double t = -10.0; t < 1060.0; t += 0.7) {
+            CHECK(query(tree, t) == bruteForce(intervals, t));
+        }
+    }
+}
+
+// Run explicitly with:  OpenSpaceTest "[.intervaltree-benchmark]"
+// Replays a mission timeline at a fixed frame rate, once with a linear scan over all
+// intervals, as the ImageSequencer used to do, and once with the interval tree
+TEST_CASE("IntervalTree: Benchmark", "[.intervaltree-benchmark]") {
+    constexpr int NIntervals = 50000;
+    const std::vector<IntervalTree<int>::Interval> intervals =
+        missionTimeline(NIntervals);
+    const IntervalTree<int> tree(intervals);
+    const double missionEnd = tree.intervals().back().end;
+
+    // A frame every 5 minutes of mission time
+    constexpr double FrameStep = 300.0;
+
+    BENCHMARK("Linear scan") {
+        int nActive = 0;
+        for (double t = 0.0; t < missionEnd; t += FrameStep) {
+            for (const IntervalTree<int>::Interval& i : intervals) {
+                if (i.start <= t && t <= i.end && i.data == 3) {
+                    nActive++;
+                    break;
+                }
+            }
+        }
+        return nActive;
+    };
+
+    BENCHMARK("Interval tree") {
+        int nActive = 0;
+        for (double t = 0.0; t < missionEnd; t += FrameStep) {
+            if (tree.findFirst(t, [](int i) { return i == 3; })) {
+                nActive++;
+            }
+        }
+        return nActive;
+    };
+}
@@ -0,0 +1,163 @@
+/*****************************************************************************************
+ *                                                                                       *
+ * OpenSpace                                                                             *
+ *                                                                                       *
+ * Copyright (c) 2014-2023                                                               *
+ *                                                                                       *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this  *
+ * software and associated documentation files (the "Software"), to deal in the Software *
+ * without restriction, including without limitation the rights to use, copy, modify,    *
+ * merge, publish, distribute, sublicense, and/or sell copies of the Software, and to    *
+ * permit persons to whom the Software is furnished to do so, subject to the following   *
+ * conditions:                                                                           *
+ *                                                                                       *
+ * The above copyright notice and this permission notice shall be included in all copies *
+ * or substantial portions of the Software.                                              *
+ *                                                                                       *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,   *
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A         *
+ * PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT    *
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF  *
+ * CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE  *
+ * OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                                         *
+ ****************************************************************************************/
+
+
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/benchmark/catch_benchmark.hpp>
+
+#ifdef OPENSPACE_MODULE_SPACE_ENABLED
+#include <modules/space/kepler.h>
+#include <ghoul/fmt.h>
+#endif // OPENSPACE_MODULE_SPACE_ENABLED
+#include <chrono>
+#include <filesystem>
+#include <fstream>
+#include <future>
+#include <string>
+#include <vector>
+
+#ifdef OPENSPACE_MODULE_SPACE_ENABLED
+
+using namespace openspace;
+
+namespace {
+    constexpr const char* Tle =
+        "ISS (ZARYA)\n"
+        "1 25544U 98067A   08264.51782528 -.00002182  00000-0 -11606-4 0  2927\n"
+        "2 25544  51.6416 247.4627 0006703 130.5360 325.0288 15.72125391563537\n"
+        "HST\n"
+        "1 20580U 90037B   23150.41666667  .00001234  00000-0  56789-4 0  9990\n"
+        "2 20580  28.4700  12.3456 0002345 100.0000 260.0000 15.10000000123456\n"
+        "DEB\n"
+        "1 30001U 99025A   23150.41666667  .00001234  00000-0  56789-4 0  9990\n"
+        "2 30001  98.4700  12.3456 0002345 100.0000 260.0000 14.10000000123456\n"
+        "DEB\n"
+        "1 30002U 99025B   23150.41666667  .00001234  00000-0  56789-4 0  9990\n"
+        "2 30002  98.4700  22.3456 0002345 100.0000 260.0000 14.20000000123456\n";
+
+    std::filesystem::path writeTleFile(const std::string& name,
+                                       const std::string& content)
+    {
+        const std::filesystem::path dir =
+            std::filesystem::temp_directory_path() / "keplercatalog-test";
+        std::filesystem::create_directories(dir);
+        const std::filesystem::path file = dir / name;
+        std::ofstream(file) << content;
+        return file;
+    }
+} // namespace
+
+TEST_CASE("KeplerCatalog: Lookup", "[keplercatalog]") {
+    const std::filesystem::path file = writeTleFile("lookup.tle", Tle);
+    std::shared_ptr<const kepler::Catalog> catalog =
+        kepler::loadCatalog(file, kepler::Format::TLE);
+
+    REQUIRE(catalog->parameters().size() == 4);
+    CHECK(catalog->parameters()[1].name == "HST");
+
+    const kepler::Parameters* iss = catalog->findByNoradId(25544);
+    REQUIRE(iss);
+    CHECK(iss->name == "ISS (ZARYA)");
+    CHECK(catalog->findById(iss->id) == iss);
+    CHECK(catalog->findByName("ISS (ZARYA)") == iss);
+
+    // Duplicate names resolve to the first object
+    const kepler::Parameters* deb = catalog->findByName("DEB");
+    REQUIRE(deb);
+    CHECK(deb->noradId == 30001);
+    CHECK(catalog->findByNoradId(30002) == &catalog->parameters()[3]);
+
+    CHECK(catalog->findByName("Voyager") == nullptr);
+    CHECK(catalog->findById("1977-084A") == nullptr);
+    CHECK(catalog->findByNoradId(10321) == nullptr);
+}
+
+TEST_CASE("KeplerCatalog: Shared", "[keplercatalog]") {
+    const std::filesystem::path file = writeTleFile("shared.tle", Tle);
+
+    // Concurrent requests for the same file all receive the same catalog
+    std::vector<std::future<std::shared_ptr<const kepler::Catalog>>> futures;
+    for (int i = 0; i < 8; i++) {
+        futures.push_back(std::async(
+            std::launch::async,
+            [&file]() { return kepler::loadCatalog(file, kepler::Format::TLE); }
+        ));
+    }
+    std::shared_ptr<const kepler::Catalog> catalog = futures.front().get();
+    for (size_t i = 1; i < futures.size(); i++) {
+        CHECK(futures[i].get() == catalog);
+    }
+    CHECK(kepler::loadCatalog(file, kepler::Format::TLE) == catalog);
+
+    // A modified file leads to a new catalog
+    std::string content = Tle;
+    content = content.substr(0, content.find("DEB"));
+    std::ofstream(file) << content;
+    std::filesystem::last_write_time(
+        file,
+        std::filesystem::last_write_time(file) + std::chrono::seconds(10)
+    );
+    std::shared_ptr<const kepler::Catalog> modified =
+        kepler::loadCatalog(file, kepler::Format::TLE);
+    CHECK(modified != catalog);
+    CHECK(modified->parameters().size() == 2);
+    CHECK(catalog->parameters().size() == 4);
+}
+
+// Run explicitly with:  OpenSpaceTest "[.keplercatalog-benchmark]"
+// Compares looking up every object of a large TLE file by reading the file for each of
+// them, as the GPTranslation used to do, with looking them up in the shared catalog
+TEST_CASE("KeplerCatalog: Benchmark", "[.keplercatalog-benchmark]") {
+    constexpr int NObjects = 2000;
+    std::string content;
+    for (int i = 0; i < NObjects; i++) {
+        content += fmt::format(
+            "OBJECT {}\n"
+            "1 {:05}U 99025A   23150.41666667  .00001234  00000-0  56789-4 0  9990\n"
+            "2 {:05}  98.4700  12.3456 0002345 100.0000 260.0000 14.10000000123456\n",
+            i, i + 1, i + 1
+        );
+    }
+    const std::filesystem::path file = writeTleFile("benchmark.tle", content);
+
+    BENCHMARK("Read file per object") {
+        double sum = 0.0;
+        for (int i = 0; i < NObjects; i += 20) {
+            sum += kepler::readFile(file, kepler::Format::TLE)[i].inclination;
+        }
+        return sum;
+    };
+
+    BENCHMARK("Shared catalog") {
+        double sum = 0.0;
+        for (int i = 0; i < NObjects; i += 20) {
+            std::shared_ptr<const kepler::Catalog> catalog =
+                kepler::loadCatalog(file, kepler::Format::TLE);
+            sum += catalog->findByNoradId(i + 1)->inclination;
+        }
+        return sum;
+    };
+}
+
+#endif // OPENSPACE_MODULE_SPACE_ENABLED
@@ -0,0 +1,296 @@
+/*****************************************************************************************
+ *                                                                                       *
+ * OpenSpace                                                                             *
+ *                                                                                       *
+ * Copyright (c) 2014-2023                                                               *
+ *                                                                                       *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this  *
+ * software and associated documentation files (the "Software"), to deal in the Software *
+ * without restriction, including without limitation the rights to use, copy, modify,    *
+ * merge, publish, distribute, sublicense, and/or sell copies of the Software, and to    *
+ * permit persons to whom the Software is furnished to do so, subject to the following   *
+ * conditions:                                                                           *
+ *                                                                                       *
+ * The above copyright notice and this permission notice shall be included in all copies *
+ * or substantial portions of the Software.                                              *
+ *                                                                                       *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,   *
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A         *
+ * PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT    *
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF  *
+ * CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE  *
+ * OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                                         *
+ ****************************************************************************************/
+
+
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/benchmark/catch_benchmark.hpp>
+
+#include <openspace/rendering/labellayout.h>
+#include <algorithm>
+#include <random>
+#include <vector>
+
+using namespace openspace;
+
+namespace {
+    constexpr glm::ivec2 Viewport = glm::ivec2(1920, 1080);
+
+    LabelLayout::Settings cameraSettings(const glm::dvec3& eye,
+                                         const glm::dvec3& center)
+    {
+        const glm::dmat4 projection = glm::perspective(
+            glm::radians(60.0),
+            static_cast<double>(Viewport.x) / Viewport.y,
+            0.1,
+            1000.0
+        );
+        const glm::dmat4 view = glm::lookAt(eye, center, glm::dvec3(0.0, 1.0, 0.0));
+
+        LabelLayout::Settings settings;
+        settings.modelViewProjection = projection * view;
+        settings.viewportSize = Viewport;
+        settings.cameraPosition = eye;
+        return settings;
+    }
+
+    std::vector<LabelLayout::Label> randomLabels(int nLabels, double extent) {
+        std::mt19937 rng(1337);
+        std::uniform_real_distribution<double> position(-extent, extent);
+        std::uniform_real_distribution<float> priority(0.f, 10.f);
+        std::uniform_int_distribution<int> length(3, 20);
+
+        std::vector<LabelLayout::Label> res;
+        for (int i = 0; i < nLabels; i++) {
+            res.push_back({
+                .position = glm::dvec3(position(rng), position(rng), position(rng)),
+                .priority = priority(rng),
+                .textLength = length(rng)
+            });
+        }
+        return res;
+    }
+
+    // Tests every label on its own, as the label components used to do
+    std::vector<size_t> bruteForce(const std::vector<LabelLayout::Label>& labels,
+                                   const LabelLayout::Settings& settings)
+    {
+        std::vector<size_t> res;
+        for (size_t i = 0; i < labels.size(); i++) {
+            const glm::dvec4 clip =
+                settings.modelViewProjection * glm::dvec4(labels[i].position, 1.0);
+            const bool isInFrustum =
+                -clip.w <= clip.x && clip.x <= clip.w &&
+                -clip.w <= clip.y && clip.y <= clip.w &&
+                -clip.w <= clip.z;
+            const bool isInRange =
+                glm::distance(labels[i].position, settings.cameraPosition) <=
+                settings.maxDistance;
+            if (isInFrustum && isInRange) {
+                res.push_back(i);
+            }
+        }
+        return res;
+    }
+
+    std::vector<size_t> sorted(std::vector<size_t> v) {
+        std::sort(v.begin(), v.end());
+        return v;
+    }
+} // namespace
+
+TEST_CASE("LabelLayout: Empty", "[labellayout]") {
+    LabelLayout layout;
+    CHECK(layout.layout(cameraSettings(glm::dvec3(0.0, 0.0, 10.0), glm::dvec3(0.0)))
+        .empty());
+
+    layout.setLabels({});
+    CHECK(layout.labels().empty());
+    CHECK(layout.layout(cameraSettings(glm::dvec3(0.0, 0.0, 10.0), glm::dvec3(0.0)))
+        .empty());
+}
+
+TEST_CASE("LabelLayout: Culling", "[labellayout]") {
+    const std::vector<LabelLayout::Label> labels = randomLabels(20000, 100.0);
+    LabelLayout layout;
+    layout.setLabels(labels);
+    REQUIRE(layout.labels().size() == labels.size());
+
+    const std::vector<std::pair<glm::dvec3, glm::dvec3>> cameras = {
+        { glm::dvec3(0.0, 0.0, 200.0), glm::dvec3(0.0) },
+        { glm::dvec3(0.0), glm::dvec3(1.0, 0.5, 0.0) },
+        { glm::dvec3(80.0, -20.0, 30.0), glm::dvec3(-50.0, 10.0, 90.0) },
+        { glm::dvec3(0.0, 0.0, 500.0), glm::dvec3(0.0, 0.0, 1000.0) }
+    };
+    for (const std::pair<glm::dvec3, glm::dvec3>& camera : cameras) {
+        LabelLayout::Settings settings = cameraSettings(camera.first, camera.second);
+        CHECK(sorted(layout.layout(settings)) == bruteForce(labels, settings));
+
+        settings.maxDistance = 75.0;
+        CHECK(sorted(layout.layout(settings)) == bruteForce(labels, settings));
+    }
+
+    // Without any culling, every enabled label is returned
+    LabelLayout::Settings settings = cameraSettings(glm::dvec3(0.0), glm::dvec3(1.0));
+    settings.frustumCulling = false;
+    const std::vector<size_t> even = sorted(
+        layout.layout(settings, [](size_t i) { return i % 2 == 0; })
+    );
+    REQUIRE(even.size() == labels.size() / 2);
+    for (size_t i = 0; i < even.size(); i++) {
+        CHECK(even[i] == 2 * i);
+    }
+}
+
+TEST_CASE("LabelLayout: Priority And Limit", "[labellayout]") {
+    const std::vector<LabelLayout::Label> labels = randomLabels(5000, 100.0);
+    LabelLayout layout;
+    layout.setLabels(labels);
+
+    LabelLayout::Settings settings =
+        cameraSettings(glm::dvec3(0.0, 0.0, 200.0), glm::dvec3(0.0));
+    std::vector<size_t> visible = bruteForce(labels, settings);
+    std::sort(
+        visible.begin(),
+        visible.end(),
+        [&labels](size_t lhs, size_t rhs) {
+            return labels[lhs].priority > labels[rhs].priority;
+        }
+    );
+    REQUIRE(visible.size() > 100);
+
+    settings.maxLabels = 100;
+    const std::vector<size_t>& res = layout.layout(settings);
+    REQUIRE(res.size() == 100);
+    for (size_t i = 0; i < res.size(); i++) {
+        CHECK(labels[res[i]].priority == labels[visible[i]].priority);
+    }
+}
+
+TEST_CASE("LabelLayout: Overlap", "[labellayout]") {
+    const std::vector<LabelLayout::Label> labels = randomLabels(5000, 100.0);
+    LabelLayout layout;
+    layout.setLabels(labels);
+
+    // Use a constant size on screen to be able to compute the rectangles of the labels
+    constexpr float Height = 12.f;
+    LabelLayout::Settings settings =
+        cameraSettings(glm::dvec3(0.0, 0.0, 200.0), glm::dvec3(0.0));
+    settings.cullOverlapping = true;
+    settings.minMaxTextHeight = glm::vec2(Height);
+
+    const std::vector<size_t> visible = bruteForce(labels, settings);
+    const std::vector<size_t>& res = layout.layout(settings);
+    REQUIRE(!res.empty());
+    CHECK(res.size() < visible.size());
+
+    // The labels are placed in the order of their priority, so the most important
+    // label that is visible is always placed
+    const size_t mostImportant = *std::max_element(
+        visible.begin(),
+        visible.end(),
+        [&labels](size_t lhs, size_t rhs) {
+            return labels[lhs].priority < labels[rhs].priority;
+        }
+    );
+    CHECK(res.front() == mostImportant);
+
+    struct Rect {
+        glm::dvec2 lower;
+        glm::dvec2 upper;
+    };
+    std::vector<Rect> rects;
+    for (size_t i : res) {
+        const glm::dvec4 clip =
+            settings.modelViewProjection * glm::dvec4(labels[i].position, 1.0);
+        const glm::dvec2 screen =
+            (glm::dvec2(clip.x, clip.y) / clip.w * 0.5 + 0.5) * glm::dvec2(Viewport);
+        const double width =
+            labels[i].textLength * settings.characterAspectRatio * Height;
+        rects.push_back({ screen, screen + glm::dvec2(width, Height) });
+    }
+    for (size_t i = 0; i < rects.size(); i++) {
+        for (size_t j = i + 1; j < rects.size(); j++) {
+            const bool overlaps =
+                rects[i].lower.x < rects[j].upper.x &&
+                rects[j].lower.x < rects[i].upper.x &&
+                rects[i].lower.y < rects[j].upper.y &&
+                rects[j].lower.y < rects[i].upper.y;
+            CHECK_FALSE(overlaps);
+        }
+    }
+}
+
+TEST_CASE("LabelLayout: Stable Placement", "[labellayout]") {
+    // Two labels of the same priority that overlap on screen
+    LabelLayout layout;
+    layout.setLabels({
+        { .position = glm::dvec3(0.0, 0.0, 0.0), .priority = 1.f, .textLength = 10 },
+        { .position = glm::dvec3(0.0, 0.0, -1.0), .priority = 1.f, .textLength = 10 }
+    });
+
+    LabelLayout::Settings settings =
+        cameraSettings(glm::dvec3(0.01, 0.0, 100.0), glm::dvec3(0.0, 0.0, -1.0));
+    settings.cullOverlapping = true;
+    settings.minMaxTextHeight = glm::vec2(20.f);
+    CHECK(layout.layout(settings) == std::vector<size_t>{ 0 });
+
+    // Once the camera moves to the other side, the second label is closer, but the
+    // label that was visible before stays to avoid flickering
+    settings = cameraSettings(glm::dvec3(0.01, 0.0, -100.0), glm::dvec3(0.0));
+    settings.cullOverlapping = true;
+    settings.minMaxTextHeight = glm::vec2(20.f);
+    CHECK(layout.layout(settings) == std::vector<size_t>{ 0 });
+
+    // Only when it is no longer a candidate, the other label is chosen
+    CHECK(
+        layout.layout(settings, [](size_t i) { return i == 1; }) ==
+        std::vector<size_t>{ 1 }
+    );
+    CHECK(layout.layout(settings) == std::vector<size_t>{ 1 });
+}
+
+// Run explicitly with:  OpenSpaceTest "[.labellayout-benchmark]"
+// Lays out a star catalog sized label set for a number of camera positions, once with a
+// test of every single label, as the label components used to do, and once with the
+// hierarchy with and without the removal of overlapping labels
+TEST_CASE("LabelLayout: Benchmark", "[.labellayout-benchmark]") {
+    constexpr int NLabels = 100000;
+    const std::vector<LabelLayout::Label> labels = randomLabels(NLabels, 1000.0);
+    LabelLayout layout;
+    layout.setLabels(labels);
+
+    std::vector<LabelLayout::Settings> frames;
+    for (int i = 0; i < 16; i++) {
+        const double angle = glm::radians(22.5 * i);
+        const glm::dvec3 eye = glm::dvec3(std::cos(angle), 0.0, std::sin(angle)) * 500.0;
+        frames.push_back(cameraSettings(eye, glm::dvec3(0.0)));
+    }
+
+    BENCHMARK("Linear scan") {
+        size_t n = 0;
+        for (const LabelLayout::Settings& settings : frames) {
+            n += bruteForce(labels, settings).size();
+        }
+        return n;
+    };
+
+    BENCHMARK("Hierarchy") {
+        size_t n = 0;
+        for (const LabelLayout::Settings& settings : frames) {
+            n += layout.layout(settings).size();
+        }
+        return n;
+    };
+
+    BENCHMARK("Hierarchy and overlap") {
+        size_t n = 0;
+        for (LabelLayout::Settings settings : frames) {
+            settings.cullOverlapping = true;
+            settings.maxLabels = 1000;
+            settings.minMaxTextHeight = glm::vec2(12.f);
+            n += layout.layout(settings).size();
+        }
+        return n;
+    };
+}
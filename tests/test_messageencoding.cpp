@@ -0,0 +1,205 @@
+/*****************************************************************************************
+ *                                                                                       *
+ * OpenSpace                                                                             *
+ *                                                                                       *
+ * Copyright (c) 2014-2023                                                               *
+ *                                                                                       *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this  *
+ * software and associated documentation files (the "Software"), to deal in the Software *
+ * without restriction, including without limitation the rights to use, copy, modify,    *
+ * merge, publish, distribute, sublicense, and/or sell copies of the Software, and to    *
+ * permit persons to whom the Software is furnished to do so, subject to the following   *
+ * conditions:                                                                           *
+ *                                                                                       *
+ * The above copyright notice and this permission notice shall be included in all copies *
+ * or substantial portions of the Software.                                              *
+ *                                                                                       *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,   *
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A         *
+ * PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT    *
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF  *
+ * CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE  *
+ * OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                                         *
+ ****************************************************************************************/
+
+
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/benchmark/catch_benchmark.hpp>
+
+#include <modules/server/include/jsonconverters.h>
+#include <modules/server/include/messageencoding.h>
+#include <openspace/properties/optionproperty.h>
+#include <openspace/properties/propertyowner.h>
+#include <openspace/properties/stringproperty.h>
+#include <openspace/properties/scalar/boolproperty.h>
+#include <openspace/properties/scalar/floatproperty.h>
+#include <openspace/properties/vector/dvec3property.h>
+#include <memory>
+
+using namespace openspace;
+
+namespace {
+    // A property tree that resembles a scene with many nodes that each have a number of
+    // properties of different types
+    struct PropertyTree {
+        PropertyTree(int nNodes) {
+            using namespace properties;
+            root = std::make_unique<PropertyOwner>(PropertyOwner::PropertyOwnerInfo{
+                "Root", "Root", "The \"root\" of the tree"
+            });
+            PropertyOwner* parent = root.get();
+            for (int i = 0; i < nNodes; i++) {
+                const std::string id = "Node" + std::to_string(i);
+                auto owner = std::make_unique<PropertyOwner>(
+                    PropertyOwner::PropertyOwnerInfo{ id, "Node å " + id, "" }
+                );
+                owner->addTag("tag" + std::to_string(i % 3));
+
+                auto f = std::make_unique<FloatProperty>(
+                    Property::PropertyInfo{ "Opacity", "Opacity", "How opaque" },
+                    0.25f * i, 0.f, 1000.f
+                );
+                auto b = std::make_unique<BoolProperty>(
+                    Property::PropertyInfo{ "Enabled", "Enabled", "Is it enabled?" },
+                    i % 2 == 0
+                );
+                auto s = std::make_unique<StringProperty>(
+                    Property::PropertyInfo{ "Text", "Text", "Some \"quoted\" text" },
+                    "Value\nwith a line break " + id
+                );
+                auto v = std::make_unique<DVec3Property>(
+                    Property::PropertyInfo{ "Position", "Position", "Where it is" },
+                    glm::dvec3(i, -1.5 * i, 1e10)
+                );
+                auto o = std::make_unique<OptionProperty>(
+                    Property::PropertyInfo{ "Mode", "Mode", "The mode" }
+                );
+                o->addOptions({ { 0, "First" }, { 1, "Second" } });
+
+                for (Property* p : std::initializer_list<Property*>{
+                    f.get(), b.get(), s.get(), v.get(), o.get()
+                }) {
+                    owner->addProperty(p);
+                }
+                props.push_back(std::move(f));
+                props.push_back(std::move(b));
+                props.push_back(std::move(s));
+                props.push_back(std::move(v));
+                props.push_back(std::move(o));
+
+                parent->addPropertySubOwner(owner.get());
+                // Create a few levels of hierarchy
+                parent = (i % 10 == 9) ? root.get() : owner.get();
+                owners.push_back(std::move(owner));
+            }
+        }
+
+        std::vector<std::unique_ptr<properties::Property>> props;
+        std::unique_ptr<properties::PropertyOwner> root;
+        std::vector<std::unique_ptr<properties::PropertyOwner>> owners;
+    };
+
+    std::string streamed(const properties::PropertyOwner& owner, MessageEncoding enc) {
+        StreamingSerializer serializer(enc);
+        serializer.beginObject(2);
+        serializer.key("payload");
+        serializer.beginObject(1);
+        serializer.key("value");
+        serializer.beginArray(1);
+        serialize(serializer, owner);
+        serializer.endArray();
+        serializer.endObject();
+        serializer.key("topic");
+        serializer.value(42);
+        serializer.endObject();
+        return frameMessage(serializer.finish(), enc);
+    }
+
+    nlohmann::json document(const properties::PropertyOwner& owner) {
+        return {
+            { "topic", 42 },
+            { "payload", { { "value", nlohmann::json::array({ &owner }) } } }
+        };
+    }
+
+    nlohmann::json decode(const std::string& message, MessageEncoding enc) {
+        switch (enc) {
+            case MessageEncoding::Json:
+                return nlohmann::json::parse(message);
+            case MessageEncoding::Cbor:
+                return nlohmann::json::from_cbor(message.substr(4));
+            case MessageEncoding::MessagePack:
+                return nlohmann::json::from_msgpack(message.substr(4));
+            default:
+                throw std::logic_error("Missing case");
+        }
+    }
+} // namespace
+
+TEST_CASE("MessageEncoding: Encoding names", "[messageencoding]") {
+    for (MessageEncoding enc : { MessageEncoding::Json, MessageEncoding::Cbor,
+                                 MessageEncoding::MessagePack })
+    {
+        CHECK(messageEncodingFromString(messageEncodingName(enc)) == enc);
+    }
+    CHECK_FALSE(messageEncodingFromString("bson").has_value());
+}
+
+TEST_CASE("MessageEncoding: Binary framing", "[messageencoding]") {
+    const nlohmann::json json = { { "topic", 1 }, { "payload", { { "a", "\n" } } } };
+
+    CHECK(encodeMessage(json, MessageEncoding::Json) == json.dump());
+
+    const std::string cbor = encodeMessage(json, MessageEncoding::Cbor);
+    REQUIRE(cbor.size() > 4);
+    const uint32_t size = static_cast<uint8_t>(cbor[0]) |
+        static_cast<uint8_t>(cbor[1]) << 8 |
+        static_cast<uint8_t>(cbor[2]) << 16 |
+        static_cast<uint8_t>(cbor[3]) << 24;
+    CHECK(size == cbor.size() - 4);
+    CHECK(nlohmann::json::from_cbor(cbor.substr(4)) == json);
+}
+
+TEST_CASE("MessageEncoding: Streamed property tree", "[messageencoding]") {
+    PropertyTree tree(50);
+    const nlohmann::json expected = document(*tree.root);
+
+    SECTION("JSON") {
+        const std::string message = streamed(*tree.root, MessageEncoding::Json);
+        CHECK(decode(message, MessageEncoding::Json) == expected);
+    }
+
+    SECTION("CBOR") {
+        const std::string message = streamed(*tree.root, MessageEncoding::Cbor);
+        CHECK(decode(message, MessageEncoding::Cbor) == expected);
+        // With known container sizes the result is identical to nlohmann's encoding
+        CHECK(message == encodeMessage(expected, MessageEncoding::Cbor));
+    }
+
+    SECTION("MessagePack") {
+        const std::string message = streamed(*tree.root, MessageEncoding::MessagePack);
+        CHECK(decode(message, MessageEncoding::MessagePack) == expected);
+        CHECK(message == encodeMessage(expected, MessageEncoding::MessagePack));
+    }
+}
+
+// Run explicitly with:  OpenSpaceTest "[.messageencoding-benchmark]"
+// The payload sizes are printed as part of the benchmark names
+TEST_CASE("MessageEncoding: Benchmark", "[.messageencoding-benchmark]") {
+    PropertyTree tree(2000);
+
+    for (MessageEncoding enc : { MessageEncoding::Json, MessageEncoding::Cbor,
+                                 MessageEncoding::MessagePack })
+    {
+        const std::string name = std::string(messageEncodingName(enc));
+        const size_t domSize = encodeMessage(document(*tree.root), enc).size();
+        const size_t streamSize = streamed(*tree.root, enc).size();
+
+        BENCHMARK(name + " document (" + std::to_string(domSize) + " bytes)") {
+            return encodeMessage(document(*tree.root), enc);
+        };
+        BENCHMARK(name + " streamed (" + std::to_string(streamSize) + " bytes)") {
+            return streamed(*tree.root, enc);
+        };
+    }
+}
@@ -24,13 +24,17 @@
 
 #include <catch2/catch_test_macros.hpp>
 
+#include <modules/volume/mappedrawvolume.h>
 #include <modules/volume/rawvolume.h>
 #include <modules/volume/rawvolumereader.h>
 #include <modules/volume/rawvolumewriter.h>
+#include <modules/volume/volumeutils.h>
 #include <openspace/util/time.h>
 #include <openspace/util/timeline.h>
 #include <ghoul/glm.h>
 #include <ghoul/filesystem/filesystem.h>
+#include <atomic>
+#include <vector>
 
 TEST_CASE("RawVolumeIO: TinyInputOutput", "[rawvolumeio]") {
     using namespace openspace::volume;
@@ -81,3 +85,90 @@ TEST_CASE("RawVolumeIO: BasicInputOutput", "[rawvolumeio]") {
         CHECK(v == value(x));
     });
 }
+
+TEST_CASE("RawVolumeIO: BrickedInputOutput", "[rawvolumeio]") {
+    using namespace openspace::volume;
+
+    // The dimensions are not multiples of the brick size to test the padding
+    glm::uvec3 dims(5, 3, 7);
+    auto value = [dims](glm::uvec3 v) {
+        return static_cast<float>(v.z * dims.x * dims.y + v.y * dims.x + v.x);
+    };
+
+    RawVolume<float> vol(dims);
+    vol.forEachVoxel([&vol, &value](glm::uvec3 x, float) { vol.set(x, value(x)); });
+
+    std::filesystem::path volumePath = absPath("${TESTDIR}/brickedvolume.rawvolume");
+
+    RawVolumeWriter<float> writer(volumePath.string());
+    writer.setBrickSize(2);
+    writer.write(vol);
+    CHECK(
+        std::filesystem::file_size(volumePath) == nBrickedCells(dims, 2) * sizeof(float)
+    );
+
+    RawVolumeReader<float> reader(volumePath.string(), dims);
+    reader.setBrickSize(2);
+    std::unique_ptr<RawVolume<float>> storedVolume = reader.read();
+    storedVolume->forEachVoxel([&value](glm::uvec3 x, float v) {
+        CHECK(v == value(x));
+    });
+
+    std::unique_ptr<RawVolume<float>> invertedVolume = reader.read(true);
+    invertedVolume->forEachVoxel([&value, dims](glm::uvec3 x, float v) {
+        CHECK(v == value(glm::uvec3(x.x, x.y, dims.z - x.z - 1)));
+    });
+}
+
+TEST_CASE("RawVolumeIO: MappedAccess", "[rawvolumeio]") {
+    using namespace openspace::volume;
+
+    glm::uvec3 dims(4, 6, 9);
+    auto value = [dims](glm::uvec3 v) {
+        return static_cast<float>(v.z * dims.x * dims.y + v.y * dims.x + v.x);
+    };
+
+    RawVolume<float> vol(dims);
+    vol.forEachVoxel([&vol, &value](glm::uvec3 x, float) { vol.set(x, value(x)); });
+
+    std::filesystem::path volumePath = absPath("${TESTDIR}/mappedvolume.rawvolume");
+    for (unsigned int brickSize : { 0u, 4u }) {
+        RawVolumeWriter<float> writer(volumePath.string());
+        writer.setBrickSize(brickSize);
+        writer.write(vol);
+
+        RawVolumeReader<float> reader(volumePath.string(), dims);
+        reader.setBrickSize(brickSize);
+        std::unique_ptr<MappedRawVolume<float>> mapped = reader.map();
+        REQUIRE(mapped->nCells() == vol.nCells());
+        vol.forEachVoxel([&mapped](glm::uvec3 x, float v) {
+            CHECK(mapped->get(x) == v);
+        });
+
+        // Copy the volume with multiple threads and count the voxels in the callback
+        std::vector<float> copy(vol.nCells());
+        std::atomic<size_t> nCopied = 0;
+        mapped->copyTo(
+            copy.data(),
+            false,
+            4,
+            [&nCopied](float*, size_t n, unsigned int) { nCopied += n; }
+        );
+        CHECK(nCopied == vol.nCells());
+        for (size_t i = 0; i < copy.size(); i++) {
+            CHECK(copy[i] == vol.data()[i]);
+        }
+    }
+}
+
+TEST_CASE("RawVolumeIO: MappedFileTooSmall", "[rawvolumeio]") {
+    using namespace openspace::volume;
+
+    RawVolume<float> vol(glm::uvec3(2));
+    std::filesystem::path volumePath = absPath("${TESTDIR}/smallvolume.rawvolume");
+    RawVolumeWriter<float> writer(volumePath.string());
+    writer.write(vol);
+
+    RawVolumeReader<float> reader(volumePath.string(), glm::uvec3(4));
+    CHECK_THROWS(reader.map());
+}
@@ -0,0 +1,157 @@
+/*****************************************************************************************
+ *                                                                                       *
+ * OpenSpace                                                                             *
+ *                                                                                       *
+ * Copyright (c) 2014-2023                                                               *
+ *                                                                                       *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this  *
+ * software and associated documentation files (the "Software"), to deal in the Software *
+ * without restriction, including without limitation the rights to use, copy, modify,    *
+ * merge, publish, distribute, sublicense, and/or sell copies of the Software, and to    *
+ * permit persons to whom the Software is furnished to do so, subject to the following   *
+ * conditions:                                                                           *
+ *                                                                                       *
+ * The above copyright notice and this permission notice shall be included in all copies *
+ * or substantial portions of the Software.                                              *
+ *                                                                                       *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,   *
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A         *
+ * PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT    *
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF  *
+ * CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE  *
+ * OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                                         *
+ ****************************************************************************************/
+
+
+#include <catch2/catch_test_macros.hpp>
+
+#include <openspace/scene/scenesnapshot.h>
+#include <ghoul/misc/dictionary.h>
+#include <filesystem>
+#include <fstream>
+
+using namespace openspace;
+
+namespace {
+    constexpr const char* Version = "1.2.3";
+    constexpr const char* Profile = R"({ "version": { "major": 1, "minor": 0 } })";
+
+    struct TestDirectory {
+        TestDirectory()
+            : path(std::filesystem::temp_directory_path() / "scenesnapshot-test")
+        {
+            std::filesystem::remove_all(path);
+            std::filesystem::create_directories(path);
+        }
+
+        ~TestDirectory() {
+            std::filesystem::remove_all(path);
+        }
+
+        std::filesystem::path writeFile(const std::string& name,
+                                        const std::string& content) const
+        {
+            const std::filesystem::path file = path / name;
+            std::ofstream(file) << content;
+            return file;
+        }
+
+        std::filesystem::path path;
+    };
+
+    ghoul::Dictionary earth(const std::filesystem::path& texture) {
+        ghoul::Dictionary renderable;
+        renderable.setValue("Type", std::string("RenderableGlobe"));
+        renderable.setValue("Texture", texture.string());
+
+        ghoul::Dictionary node;
+        node.setValue("Identifier", std::string("Earth"));
+        node.setValue("Parent", std::string("SolarSystemBarycenter"));
+        node.setValue("Renderable", renderable);
+        return node;
+    }
+} // namespace
+
+TEST_CASE("SceneSnapshot: Missing File", "[scenesnapshot]") {
+    TestDirectory dir;
+    CHECK_FALSE(SceneSnapshot::load(dir.path / "missing.scenesnapshot").has_value());
+}
+
+TEST_CASE("SceneSnapshot: Broken File", "[scenesnapshot]") {
+    TestDirectory dir;
+    const std::filesystem::path file = dir.writeFile("broken.scenesnapshot", "{ abc");
+    CHECK_FALSE(SceneSnapshot::load(file).has_value());
+}
+
+TEST_CASE("SceneSnapshot: Round Trip", "[scenesnapshot]") {
+    TestDirectory dir;
+    const std::filesystem::path a = dir.writeFile("a.asset", "local a = 1");
+    const std::filesystem::path b = dir.writeFile("b.asset", "local b = 2");
+    const std::filesystem::path texture = dir.writeFile("earth.png", "png");
+
+    SceneSnapshot snapshot(Version, Profile);
+    snapshot.addAsset(a);
+    snapshot.addAsset(b);
+    snapshot.addNode(earth(texture));
+
+    const std::filesystem::path file = dir.path / "test.scenesnapshot";
+    snapshot.save(file);
+    CHECK_FALSE(std::filesystem::exists(dir.path / "test.scenesnapshot.tmp"));
+
+    std::optional<SceneSnapshot> loaded = SceneSnapshot::load(file);
+    REQUIRE(loaded.has_value());
+    CHECK(loaded->isUpToDate(Version, Profile));
+
+    REQUIRE(loaded->assets().size() == 2);
+    CHECK(loaded->assets()[0].path == a);
+    CHECK(loaded->assets()[0].hash == snapshot.assets()[0].hash);
+    CHECK(loaded->assets()[1].path == b);
+    CHECK(loaded->assets()[0].hash != loaded->assets()[1].hash);
+
+    REQUIRE(loaded->nodes().size() == 1);
+    CHECK(loaded->nodes()[0].identifier == "Earth");
+    CHECK(loaded->nodes()[0].hash == SceneSnapshot::hashDictionary(earth(texture)));
+    REQUIRE(loaded->nodes()[0].files.size() == 1);
+    CHECK(loaded->nodes()[0].files[0] == texture);
+    CHECK(loaded->containsNode(earth(texture)));
+}
+
+TEST_CASE("SceneSnapshot: Out Of Date", "[scenesnapshot]") {
+    TestDirectory dir;
+    const std::filesystem::path a = dir.writeFile("a.asset", "local a = 1");
+
+    SceneSnapshot snapshot(Version, Profile);
+    snapshot.addAsset(a);
+    REQUIRE(snapshot.isUpToDate(Version, Profile));
+
+    CHECK_FALSE(snapshot.isUpToDate("1.2.4", Profile));
+    CHECK_FALSE(snapshot.isUpToDate(Version, "{}"));
+
+    dir.writeFile("a.asset", "local a = 2");
+    CHECK_FALSE(snapshot.isUpToDate(Version, Profile));
+
+    std::filesystem::remove(a);
+    CHECK_FALSE(snapshot.isUpToDate(Version, Profile));
+}
+
+TEST_CASE("SceneSnapshot: Contains Node", "[scenesnapshot]") {
+    TestDirectory dir;
+    const std::filesystem::path texture = dir.writeFile("earth.png", "png");
+
+    SceneSnapshot snapshot(Version, Profile);
+    snapshot.addNode(earth(texture));
+    CHECK(snapshot.containsNode(earth(texture)));
+
+    // Any change of the dictionary means that it has to be tested again
+    ghoul::Dictionary changed = earth(texture);
+    changed.setValue("Parent", std::string("Sun"));
+    CHECK_FALSE(snapshot.containsNode(changed));
+
+    ghoul::Dictionary added = earth(texture);
+    added.setValue("GUI", ghoul::Dictionary());
+    CHECK_FALSE(snapshot.containsNode(added));
+
+    // A file that the dictionary refers to no longer exists
+    std::filesystem::remove(texture);
+    CHECK_FALSE(snapshot.containsNode(earth(texture)));
+}
@@ -0,0 +1,299 @@
+/*****************************************************************************************
+ *                                                                                       *
+ * OpenSpace                                                                             *
+ *                                                                                       *
+ * Copyright (c) 2014-2023                                                               *
+ *                                                                                       *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this  *
+ * software and associated documentation files (the "Software"), to deal in the Software *
+ * without restriction, including without limitation the rights to use, copy, modify,    *
+ * merge, publish, distribute, sublicense, and/or sell copies of the Software, and to    *
+ * permit persons to whom the Software is furnished to do so, subject to the following   *
+ * conditions:                                                                           *
+ *                                                                                       *
+ * The above copyright notice and this permission notice shall be included in all copies *
+ * or substantial portions of the Software.                                              *
+ *                                                                                       *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,   *
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A         *
+ * PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT    *
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF  *
+ * CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE  *
+ * OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                                         *
+ ****************************************************************************************/
+
+#include <catch2/catch_test_macros.hpp>
+
+#ifdef OPENSPACE_MODULE_SPACECRAFTINSTRUMENTS_ENABLED
+
+#include <modules/spacecraftinstruments/util/instrumenttimesparser.h>
+#include <modules/spacecraftinstruments/util/sequenceparser.h>
+#include <openspace/util/spicemanager.h>
+#include <ghoul/fmt.h>
+#include <ghoul/filesystem/filesystem.h>
+#include <ghoul/misc/dictionary.h>
+#include <algorithm>
+#include <filesystem>
+#include <fstream>
+#include <random>
+
+using namespace openspace;
+
+namespace {
+    // Exposes the cache functions of the SequenceParser and fills the parsed tables with
+    // values that cover all of the serialized fields
+    class CacheParser : public SequenceParser {
+    public:
+        using SequenceParser::cacheFile;
+        using SequenceParser::loadCache;
+        using SequenceParser::saveCache;
+
+        bool create() override {
+            Image image = {
+                .timeRange = TimeRange(10.0, 20.5),
+                .path = "image/path.png",
+                .activeInstruments = { "INSTRUMENT_A", "INSTRUMENT_B" },
+                .target = "TARGET",
+                .isPlaceholder = true,
+                .projected = false
+            };
+            _subsetMap["TARGET"]._range = TimeRange(10.0, 35.0);
+            _subsetMap["TARGET"]._subset.push_back(image);
+            image.timeRange = TimeRange(30.0, 35.0);
+            image.activeInstruments = { "INSTRUMENT_C" };
+            image.isPlaceholder = false;
+            image.projected = true;
+            _subsetMap["TARGET"]._subset.push_back(image);
+            _subsetMap["OTHER"]._range = TimeRange(-5.0, -1.0);
+
+            _instrumentTimes = {
+                { "INSTRUMENT_A", TimeRange(10.0, 20.5) },
+                { "INSTRUMENT_C", TimeRange(30.0, 35.0) }
+            };
+            _targetTimes = { { 10.0, "TARGET" }, { 30.0, "TARGET" } };
+            _captureProgression = { 10.0, 30.0 };
+            return true;
+        }
+    };
+
+    void checkEqual(const TimeRange& a, const TimeRange& b) {
+        CHECK(a.start == b.start);
+        CHECK(a.end == b.end);
+    }
+
+    void checkEqual(SequenceParser& a, SequenceParser& b) {
+        REQUIRE(a.subsetMap().size() == b.subsetMap().size());
+        for (const auto& [target, subset] : a.subsetMap()) {
+            REQUIRE(b.subsetMap().contains(target));
+            const ImageSubset& other = b.subsetMap()[target];
+            checkEqual(subset._range, other._range);
+            REQUIRE(subset._subset.size() == other._subset.size());
+            for (size_t i = 0; i < subset._subset.size(); i++) {
+                const Image& ia = subset._subset[i];
+                const Image& ib = other._subset[i];
+                checkEqual(ia.timeRange, ib.timeRange);
+                CHECK(ia.path == ib.path);
+                CHECK(ia.activeInstruments == ib.activeInstruments);
+                CHECK(ia.target == ib.target);
+                CHECK(ia.isPlaceholder == ib.isPlaceholder);
+                CHECK(ia.projected == ib.projected);
+            }
+        }
+
+        REQUIRE(a.instrumentTimes().size() == b.instrumentTimes().size());
+        for (size_t i = 0; i < a.instrumentTimes().size(); i++) {
+            CHECK(a.instrumentTimes()[i].first == b.instrumentTimes()[i].first);
+            checkEqual(a.instrumentTimes()[i].second, b.instrumentTimes()[i].second);
+        }
+        CHECK(a.targetTimes() == b.targetTimes());
+        CHECK(a.captureProgression() == b.captureProgression());
+    }
+
+    std::string timeString(int seconds) {
+        return fmt::format(
+            "2015-07-14T{:02}:{:02}:{:02}.000",
+            seconds / 3600, (seconds / 60) % 60, seconds % 60
+        );
+    }
+
+    struct TemporaryDirectory {
+        TemporaryDirectory() {
+            path = std::filesystem::temp_directory_path() / "sequenceparser-test";
+            std::filesystem::remove_all(path);
+            std::filesystem::create_directories(path);
+        }
+
+        ~TemporaryDirectory() {
+            std::filesystem::remove_all(path);
+        }
+
+        std::filesystem::path path;
+    };
+} // namespace
+
+TEST_CASE("SequenceParser: Cache Round Trip", "[sequenceparser]") {
+    SpiceManager::initialize();
+    TemporaryDirectory dir;
+
+    CacheParser original;
+    original.create();
+    const std::filesystem::path file = dir.path / "parser.cache";
+    original.saveCache(file);
+
+    CacheParser loaded;
+    REQUIRE(loaded.loadCache(file));
+    checkEqual(original, loaded);
+
+    SECTION("Truncated file") {
+        const uintmax_t size = std::filesystem::file_size(file);
+        std::filesystem::resize_file(file, size - 4);
+
+        CacheParser truncated;
+        CHECK_FALSE(truncated.loadCache(file));
+        CHECK(truncated.subsetMap().empty());
+        CHECK(truncated.instrumentTimes().empty());
+        CHECK(truncated.targetTimes().empty());
+        CHECK(truncated.captureProgression().empty());
+    }
+
+    SECTION("Missing file") {
+        CacheParser missing;
+        CHECK_FALSE(missing.loadCache(dir.path / "missing.cache"));
+    }
+
+    SpiceManager::deinitialize();
+}
+
+TEST_CASE("SequenceParser: Cache Key Depends On Time Kernels", "[sequenceparser]") {
+    SpiceManager::initialize();
+    TemporaryDirectory dir;
+
+    // The kernel is copied so that its modification time can be changed
+    const std::filesystem::path kernel = dir.path / "naif0012.tls";
+    std::filesystem::copy_file(absPath("${TESTDIR}/horizonsTest/naif0012.tls"), kernel);
+
+    CacheParser parser;
+    const std::filesystem::path source = dir.path / "source";
+    std::filesystem::create_directories(source);
+    const std::filesystem::path withoutKernel = parser.cacheFile(source, "fingerprint");
+
+    SpiceManager::ref().loadKernel(kernel.string());
+    const std::filesystem::path withKernel = parser.cacheFile(source, "fingerprint");
+    CHECK(withKernel != withoutKernel);
+    CHECK(parser.cacheFile(source, "fingerprint") == withKernel);
+    CHECK(parser.cacheFile(source, "other fingerprint") != withKernel);
+
+    std::filesystem::last_write_time(
+        kernel,
+        std::filesystem::last_write_time(kernel) + std::chrono::hours(1)
+    );
+    CHECK(parser.cacheFile(source, "fingerprint") != withKernel);
+
+    SpiceManager::ref().unloadKernel(kernel.string());
+    SpiceManager::deinitialize();
+}
+
+TEST_CASE("SequenceParser: Instrument Times Merged In File Order", "[sequenceparser]") {
+    SpiceManager::initialize();
+    const std::filesystem::path kernel = absPath("${TESTDIR}/horizonsTest/naif0012.tls");
+    SpiceManager::ref().loadKernel(kernel.string());
+    TemporaryDirectory dir;
+
+    // Enough files so that they are spread over all threads. The events of each file
+    // are not sorted, so any merge that depends on the thread scheduling shows up in
+    // the order of the images
+    constexpr int NInstruments = 4;
+    constexpr int NFilesPerInstrument = 8;
+    constexpr int NEventsPerFile = 25;
+    std::mt19937 gen(1337);
+    std::uniform_int_distribution<int> dist(0, 86000);
+
+    ghoul::Dictionary instruments;
+    // Instrument name -> files -> events, in the order in which the parser merges them
+    std::map<std::string, std::vector<std::vector<std::pair<int, int>>>> expected;
+    for (int i = 0; i < NInstruments; i++) {
+        const std::string name = fmt::format("INSTRUMENT_{}", i);
+
+        ghoul::Dictionary files;
+        for (int j = 0; j < NFilesPerInstrument; j++) {
+            const std::string filename = fmt::format("{}_{}.txt", name, j);
+            std::ofstream stream(dir.path / filename);
+            std::vector<std::pair<int, int>> events;
+            for (int k = 0; k < NEventsPerFile; k++) {
+                const int start = dist(gen);
+                const int end = start + 1 + k % 300;
+                stream << fmt::format(
+                    "\"{}\" \"{}\"\n", timeString(start), timeString(end)
+                );
+                events.emplace_back(start, end);
+            }
+            expected[name].push_back(std::move(events));
+            files.setValue(std::to_string(j + 1), filename);
+        }
+
+        ghoul::Dictionary spice;
+        spice.setValue("1", name);
+        ghoul::Dictionary instrument;
+        instrument.setValue("DetectorType", std::string("Camera"));
+        instrument.setValue("Spice", spice);
+        instrument.setValue("Files", files);
+        instruments.setValue(name, instrument);
+    }
+
+    ghoul::Dictionary dictionary;
+    dictionary.setValue("Target", std::string("PLUTO"));
+    dictionary.setValue("Instruments", instruments);
+
+    InstrumentTimesParser parser("Test", dir.path.string(), dictionary);
+    REQUIRE(parser.create());
+
+    const std::vector<Image>& images = parser.subsetMap()["PLUTO"]._subset;
+    REQUIRE(images.size() == NInstruments * NFilesPerInstrument * NEventsPerFile);
+    REQUIRE(parser.instrumentTimes().size() == NInstruments * NFilesPerInstrument);
+
+    SpiceManager& spice = SpiceManager::ref();
+    size_t iImage = 0;
+    size_t iFile = 0;
+    std::vector<double> starts;
+    for (const auto& [name, files] : expected) {
+        for (const std::vector<std::pair<int, int>>& events : files) {
+            TimeRange fileRange;
+            for (const std::pair<int, int>& event : events) {
+                const TimeRange range = TimeRange(
+                    spice.ephemerisTimeFromDate(timeString(event.first)),
+                    spice.ephemerisTimeFromDate(timeString(event.second))
+                );
+                fileRange.include(range);
+                starts.push_back(range.start);
+
+                const Image& image = images[iImage];
+                checkEqual(image.timeRange, range);
+                CHECK(image.activeInstruments == std::vector<std::string>{ name });
+                CHECK(image.target == "PLUTO");
+                CHECK(image.isPlaceholder);
+                iImage++;
+            }
+
+            CHECK(parser.instrumentTimes()[iFile].first == name);
+            checkEqual(parser.instrumentTimes()[iFile].second, fileRange);
+            iFile++;
+        }
+    }
+
+    std::sort(starts.begin(), starts.end());
+    CHECK(parser.captureProgression() == starts);
+    REQUIRE(parser.targetTimes().size() == starts.size());
+    for (size_t i = 0; i < starts.size(); i++) {
+        CHECK(parser.targetTimes()[i].first == starts[i]);
+    }
+
+    // The second parser finds the cache file that was written by the first one
+    InstrumentTimesParser cached("Test", dir.path.string(), dictionary);
+    REQUIRE(cached.create());
+    checkEqual(parser, cached);
+
+    SpiceManager::ref().unloadKernel(kernel.string());
+    SpiceManager::deinitialize();
+}
+
+#endif // OPENSPACE_MODULE_SPACECRAFTINSTRUMENTS_ENABLED
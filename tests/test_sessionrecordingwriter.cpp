@@ -0,0 +1,173 @@
+/*****************************************************************************************
+ *                                                                                       *
+ * OpenSpace                                                                             *
+ *                                                                                       *
+ * Copyright (c) 2014-2023                                                               *
+ *                                                                                       *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this  *
+ * software and associated documentation files (the "Software"), to deal in the Software *
+ * without restriction, including without limitation the rights to use, copy, modify,    *
+ * merge, publish, distribute, sublicense, and/or sell copies of the Software, and to    *
+ * permit persons to whom the Software is furnished to do so, subject to the following   *
+ * conditions:                                                                           *
+ *                                                                                       *
+ * The above copyright notice and this permission notice shall be included in all copies *
+ * or substantial portions of the Software.                                              *
+ *                                                                                       *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,   *
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A         *
+ * PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT    *
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF  *
+ * CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE  *
+ * OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                                         *
+ ****************************************************************************************/
+
+#include <catch2/catch_test_macros.hpp>
+
+#include <openspace/interaction/sessionrecording.h>
+#include <openspace/interaction/sessionrecordingwriter.h>
+#include <openspace/util/lockfreequeue.h>
+#include <ghoul/filesystem/filesystem.h>
+#include <ghoul/fmt.h>
+#include <filesystem>
+#include <fstream>
+#include <sstream>
+#include <thread>
+
+using namespace openspace;
+using namespace openspace::interaction;
+
+namespace {
+    using Entry = SessionRecordingWriter::Entry;
+
+    // A scripted session with camera keyframes every frame, interleaved with time
+    // keyframes and scripts, some of which contain line breaks
+    std::vector<Entry> scriptedSession() {
+        std::vector<Entry> res;
+        for (int i = 0; i < 300; i++) {
+            const double t = i / 60.0;
+
+            Entry camera;
+            camera.type = Entry::Type::Camera;
+            camera.timestamps = { 100.0 + t, t, 7.5e8 + 10.0 * t };
+            camera.camera.position = glm::dvec3(1e7 + i, -2e6 * t, 3.25 * i);
+            camera.camera.rotation = glm::quat(0.5f, 0.5f, -0.5f, 0.5f);
+            camera.camera.focusNode = (i % 100 < 50) ? "Earth" : "Moon";
+            camera.camera.scale = 1.f / (i + 1);
+            camera.camera.followFocusNodeRotation = (i % 2 == 0);
+            res.push_back(std::move(camera));
+
+            if (i % 37 == 0) {
+                Entry time;
+                time.type = Entry::Type::Time;
+                time.timestamps = { 100.0 + t, t, 7.5e8 + 10.0 * t };
+                time.time._dt = 10.0 * i;
+                time.time._paused = (i % 3 == 0);
+                res.push_back(std::move(time));
+            }
+
+            if (i % 100 == 0) {
+                Entry script;
+                script.type = Entry::Type::Script;
+                script.timestamps = { 100.0 + t, t, 7.5e8 + 10.0 * t };
+                script.script = fmt::format(
+                    "openspace.setPropertyValueSingle('Scene.Earth.Scale', {});\n"
+                    "openspace.printInfo('{}')", i, i
+                );
+                res.push_back(std::move(script));
+            }
+        }
+        return res;
+    }
+
+    std::vector<Entry> baselineEntries() {
+        Entry entry;
+        entry.type = Entry::Type::Script;
+        entry.timestamps = { 100.0, 0.0, 7.5e8 };
+        entry.script = "openspace.time.setPause(false)";
+        return { entry };
+    }
+
+    // The expected recordings were written with the serialization functions as they
+    // were before the writer thread was introduced, using the same header
+    std::string header(SessionRecording::DataMode mode) {
+        std::string res = SessionRecording::FileHeaderTitle + "01.00";
+        res += (mode == SessionRecording::DataMode::Binary) ?
+            SessionRecording::DataFormatBinaryTag :
+            SessionRecording::DataFormatAsciiTag;
+        res += '\n';
+        return res;
+    }
+
+    std::string fileContents(const std::filesystem::path& path) {
+        std::ifstream file(path, std::ios::binary);
+        std::stringstream ss;
+        ss << file.rdbuf();
+        return ss.str();
+    }
+
+    void compareWithExpectedRecording(SessionRecording::DataMode mode) {
+        const bool isBinary = (mode == SessionRecording::DataMode::Binary);
+        const std::filesystem::path expectedPath = absPath(fmt::format(
+            "${{TESTDIR}}/sessionrecordingwriter/expected.{}",
+            isBinary ? "osrec" : "osrectxt"
+        ));
+        const std::filesystem::path path =
+            std::filesystem::temp_directory_path() / "test_recording_async.osrec";
+        std::filesystem::remove(path);
+
+        std::vector<Entry> session = scriptedSession();
+
+        SessionRecordingWriter writer;
+        REQUIRE(writer.start(path, mode, SessionRecordingWriter::SyncPolicy::None));
+        size_t nDropped = 0;
+        for (Entry& e : session) {
+            // Retry dropped camera keyframes so that the output is deterministic
+            while (!writer.push(e)) {
+                nDropped++;
+                std::this_thread::yield();
+            }
+        }
+        writer.finish(header(mode), baselineEntries());
+        writer.waitForFinish();
+
+        CHECK(writer.nDroppedEntries() == nDropped);
+        CHECK(writer.nWrittenEntries() == session.size());
+        CHECK(!std::filesystem::exists(path.string() + ".part"));
+
+        const std::string expected = fileContents(expectedPath);
+        const std::string actual = fileContents(path);
+        REQUIRE(!expected.empty());
+        CHECK(expected.size() == actual.size());
+        CHECK(expected == actual);
+
+        std::filesystem::remove(path);
+    }
+} // namespace
+
+TEST_CASE("LockFreeQueue: Capacity", "[sessionrecordingwriter]") {
+    LockFreeQueue<int> queue(2);
+    CHECK(queue.tryPush(1));
+    CHECK(queue.tryPush(2));
+    CHECK_FALSE(queue.tryPush(3));
+    CHECK(queue.size() == 2);
+
+    int value = 0;
+    CHECK(queue.tryPop(value));
+    CHECK(value == 1);
+    CHECK(queue.tryPush(3));
+    CHECK(queue.tryPop(value));
+    CHECK(value == 2);
+    CHECK(queue.tryPop(value));
+    CHECK(value == 3);
+    CHECK_FALSE(queue.tryPop(value));
+    CHECK(queue.empty());
+}
+
+TEST_CASE("SessionRecordingWriter: Binary Identical", "[sessionrecordingwriter]") {
+    compareWithExpectedRecording(SessionRecording::DataMode::Binary);
+}
+
+TEST_CASE("SessionRecordingWriter: Ascii Identical", "[sessionrecordingwriter]") {
+    compareWithExpectedRecording(SessionRecording::DataMode::Ascii);
+}
@@ -0,0 +1,283 @@
+/*****************************************************************************************
+ *                                                                                       *
+ * OpenSpace                                                                             *
+ *                                                                                       *
+ * Copyright (c) 2014-2023                                                               *
+ *                                                                                       *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this  *
+ * software and associated documentation files (the "Software"), to deal in the Software *
+ * without restriction, including without limitation the rights to use, copy, modify,    *
+ * merge, publish, distribute, sublicense, and/or sell copies of the Software, and to    *
+ * permit persons to whom the Software is furnished to do so, subject to the following   *
+ * conditions:                                                                           *
+ *                                                                                       *
+ * The above copyright notice and this permission notice shall be included in all copies *
+ * or substantial portions of the Software.                                              *
+ *                                                                                       *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,   *
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A         *
+ * PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT    *
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF  *
+ * CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE  *
+ * OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                                         *
+ ****************************************************************************************/
+
+
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/benchmark/catch_benchmark.hpp>
+
+#ifdef OPENSPACE_MODULE_SPACE_ENABLED
+#include <modules/space/sgp4.h>
+#include <ghoul/fmt.h>
+#endif // OPENSPACE_MODULE_SPACE_ENABLED
+#include <cmath>
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#ifdef OPENSPACE_MODULE_SPACE_ENABLED
+
+using namespace openspace;
+
+namespace {
+    // The test cases of the revised Spacetrack Report #3 by Vallado et al. (2006)
+    constexpr const char* Tle =
+        "SGP4 TEST\n"
+        "1 88888U          80275.98708465  .00073094  13844-3  66816-4 0    87\n"
+        "2 88888  72.8435 115.9689 0086731  52.6988 110.5714 16.05824518  1058\n"
+        "SDP4 TEST\n"
+        "1 11801U          80230.29629788  .01431103  00000-0  14311-1      13\n"
+        "2 11801  46.7916 230.4354 7318036  47.4722  10.4117  2.28537848    13\n"
+        "VANGUARD 1\n"
+        "1 00005U 58002B   00179.78495062  .00000023  00000-0  28098-4 0  4753\n"
+        "2 00005  34.2682 348.7242 1859667 331.7664  19.3264 10.82419157413667\n";
+
+    std::filesystem::path writeFile(const std::string& name, const std::string& content)
+    {
+        const std::filesystem::path dir =
+            std::filesystem::temp_directory_path() / "sgp4-test";
+        std::filesystem::create_directories(dir);
+        const std::filesystem::path file = dir / name;
+        std::ofstream(file) << content;
+        return file;
+    }
+} // namespace
+
+TEST_CASE("SGP4: Parse TLE", "[sgp4]") {
+    const sgp4::Elements e = sgp4::parseTle(
+        "VANGUARD 1",
+        "1 00005U 58002B   00179.78495062  .00000023  00000-0  28098-4 0  4753",
+        "2 00005  34.2682 348.7242 1859667 331.7664  19.3264 10.82419157413667"
+    );
+    CHECK(e.name == "VANGUARD 1");
+    CHECK(e.id == "1958-002B");
+    CHECK(e.noradId == 5);
+    CHECK(std::abs(e.julianDate - 2451723.28495062) < 1e-8);
+    CHECK(std::abs(e.bstar - 0.28098e-4) < 1e-12);
+    CHECK(e.inclination == 34.2682);
+    CHECK(e.ascendingNode == 348.7242);
+    CHECK(e.eccentricity == 0.1859667);
+    CHECK(e.argumentOfPerigee == 331.7664);
+    CHECK(e.meanAnomaly == 19.3264);
+    CHECK(e.meanMotion == 10.82419157);
+
+    CHECK_THROWS(sgp4::parseTle("", "1 00005U", "2 00005"));
+}
+
+TEST_CASE("SGP4: Spacetrack Report #3", "[sgp4]") {
+    const std::filesystem::path file = writeFile("str3.tle", Tle);
+    sgp4::Propagator propagator(sgp4::readFile(file, kepler::Format::TLE));
+    REQUIRE(propagator.size() == 3);
+
+    struct Reference {
+        int noradId;
+        double minutes;
+        glm::dvec3 position;
+        glm::dvec3 velocity;
+    };
+
+    // The original report lists its values with single precision and they differ from
+    // the revised implementation by a few meters
+    const std::vector<Reference> report = {
+        {
+            88888, 0.0,
+            glm::dvec3(2328.97048951, -5995.22076416, 1719.97067261),
+            glm::dvec3(2.91207230, -0.98341546, -7.09081703)
+        },
+        {
+            88888, 360.0,
+            glm::dvec3(2456.10705566, -6071.93853760, 1222.89727783),
+            glm::dvec3(2.67938992, -0.44829041, -7.22879231)
+        },
+        {
+            88888, 1440.0,
+            glm::dvec3(2742.55133057, -6079.67144775, -326.38095856),
+            glm::dvec3(1.94850778, 1.21106251, -7.35619372)
+        },
+        {
+            11801, 0.0,
+            glm::dvec3(7473.37066650, 428.95261765, 5828.74786377),
+            glm::dvec3(5.10715413, 6.44468284, -0.18613096)
+        },
+        {
+            11801, 720.0,
+            glm::dvec3(14271.28759766, 24110.46411133, -4725.76837158),
+            glm::dvec3(-0.32050445, 2.67984074, -2.08405289)
+        }
+    };
+    for (const Reference& ref : report) {
+        const int index = propagator.findByNoradId(ref.noradId);
+        REQUIRE(index != -1);
+        const sgp4::Propagator::State state = propagator.propagate(index, ref.minutes);
+        CHECK(state.status == sgp4::Propagator::Status::Success);
+        CHECK(glm::distance(state.position, ref.position) < 0.1);
+        CHECK(glm::distance(state.velocity, ref.velocity) < 1e-3);
+    }
+
+    // The verification values of the revised implementation are printed with 8 digits
+    // after the decimal point for the position and with 9 digits for the velocity
+    const std::vector<Reference> revised = {
+        {
+            5, 0.0,
+            glm::dvec3(7022.46529266, -1400.08296755, 0.03995155),
+            glm::dvec3(1.893841015, 6.405893759, 4.534807250)
+        },
+        {
+            5, 360.0,
+            glm::dvec3(-7154.03120202, -3783.17682504, -3536.19412294),
+            glm::dvec3(4.741887409, -4.151817765, -2.093935425)
+        }
+    };
+    for (const Reference& ref : revised) {
+        const int index = propagator.findByNoradId(ref.noradId);
+        REQUIRE(index != -1);
+        const sgp4::Propagator::State state = propagator.propagate(index, ref.minutes);
+        CHECK(state.status == sgp4::Propagator::Status::Success);
+        CHECK(glm::distance(state.position, ref.position) < 1e-6);
+        CHECK(glm::distance(state.velocity, ref.velocity) < 1e-8);
+    }
+}
+
+TEST_CASE("SGP4: TEME To J2000", "[sgp4]") {
+    // Example 3-15 in Vallado, Fundamentals of Astrodynamics and Applications, at
+    // 2004-04-06 07:51:28.386009 UTC, which is 64.184 s later in terrestrial time
+    const double time =
+        (2453101.5 - 2451545.0) * 86400.0 + 7 * 3600 + 51 * 60 + 28.386009 + 64.184;
+    const glm::dmat3 rotation = sgp4::temeToJ2000(time);
+
+    const glm::dvec3 position =
+        rotation * glm::dvec3(5094.18016210, 6127.64465950, 6380.34453270);
+    const glm::dvec3 velocity =
+        rotation * glm::dvec3(-4.746131487, 0.785818041, 5.531931288);
+
+    // The reference values include the observed corrections to the nutation model,
+    // which account for about a meter
+    CHECK(glm::distance(position, glm::dvec3(5102.508958, 6123.011401, 6378.136928)) <
+        0.002);
+    CHECK(glm::distance(velocity, glm::dvec3(-4.74322016, 0.79053650, 5.53375528)) <
+        1e-5);
+
+    // The frames differ by the precession since 2004, which is about 0.06 degrees and
+    // amounts to several kilometers at this distance
+    const glm::dvec3 teme = glm::dvec3(5094.18016210, 6127.64465950, 6380.34453270);
+    CHECK(glm::distance(position, teme) > 5.0);
+    CHECK(std::abs(glm::length(position) - glm::length(teme)) < 1e-8);
+}
+
+TEST_CASE("SGP4: Batched", "[sgp4]") {
+    const std::filesystem::path file = writeFile("batched.tle", Tle);
+    std::shared_ptr<sgp4::Propagator> propagator =
+        sgp4::loadPropagator(file, kepler::Format::TLE);
+    CHECK(sgp4::loadPropagator(file, kepler::Format::TLE) == propagator);
+    CHECK(propagator->findByName("VANGUARD 1") == 2);
+    CHECK(propagator->findByName("EXPLORER 1") == -1);
+
+    // Going forward and backward in time exercises the restart of the integrator
+    const std::vector<double> times = {
+        propagator->elements(1).epoch + 86400.0,
+        propagator->elements(1).epoch + 3600.0,
+        propagator->elements(1).epoch - 43200.0,
+        propagator->elements(1).epoch + 172800.0
+    };
+    std::vector<sgp4::Propagator::State> states(times.size() * propagator->size());
+    propagator->propagate(times, states, 4);
+
+    sgp4::Propagator single(sgp4::readFile(file, kepler::Format::TLE));
+    for (size_t t = 0; t < times.size(); t++) {
+        for (size_t i = 0; i < single.size(); i++) {
+            const double minutes = (times[t] - single.elements(i).epoch) / 60.0;
+            const sgp4::Propagator::State state = single.propagate(i, minutes);
+            CHECK(glm::distance(states[t * single.size() + i].position, state.position) <
+                1e-6);
+        }
+    }
+}
+
+TEST_CASE("SGP4: Osculating Elements", "[sgp4]") {
+    const std::filesystem::path file = writeFile("osculating.tle", Tle);
+    sgp4::Propagator propagator(sgp4::readFile(file, kepler::Format::TLE));
+
+    // At the epoch, the osculating elements are close to the mean elements
+    const int index = propagator.findByNoradId(5);
+    const sgp4::Elements& e = propagator.elements(index);
+    const sgp4::Propagator::State state = propagator.propagate(index, 0.0);
+    const kepler::Parameters p =
+        sgp4::osculatingElements(state.position, state.velocity, e.epoch);
+    CHECK(std::abs(p.inclination - e.inclination) < 0.1);
+    CHECK(std::abs(p.ascendingNode - e.ascendingNode) < 0.1);
+    CHECK(std::abs(p.eccentricity - e.eccentricity) < 1e-3);
+    CHECK(std::abs(p.period - 86400.0 / e.meanMotion) < 10.0);
+    CHECK(p.epoch == e.epoch);
+
+    // The mean anomaly of a circular equatorial orbit is measured from the x axis
+    const double v = std::sqrt(398600.8 / 7000.0);
+    const kepler::Parameters circular = sgp4::osculatingElements(
+        glm::dvec3(0.0, 7000.0, 0.0),
+        glm::dvec3(-v, 0.0, 0.0),
+        0.0
+    );
+    CHECK(std::abs(circular.semiMajorAxis - 7000.0) < 1e-6);
+    CHECK(circular.eccentricity < 1e-9);
+    CHECK(circular.inclination < 1e-9);
+    CHECK(std::abs(circular.meanAnomaly - 90.0) < 1e-6);
+}
+
+// Run explicitly with:  OpenSpaceTest "[.sgp4-benchmark]"
+// Propagates a catalog of 20000 objects to 16 times using one and all threads
+TEST_CASE("SGP4: Benchmark", "[.sgp4-benchmark]") {
+    constexpr int NObjects = 20000;
+    std::string content;
+    for (int i = 0; i < NObjects; i++) {
+        // Every tenth object is in a deep space orbit
+        content += fmt::format(
+            "OBJECT {}\n"
+            "1 {:05}U 99025A   23150.41666667  .00001234  00000-0  56789-4 0  9990\n"
+            "2 {:05} {:8.4f} {:8.4f} {} 100.0000 260.0000 {}\n",
+            i, i + 1, i + 1, 20.0 + (i % 800) * 0.1, (i * 7) % 360,
+            i % 10 == 0 ? "6000000" : "0002345",
+            i % 10 == 0 ? "02.00561973123456" : "14.10000000123456"
+        );
+    }
+    const std::filesystem::path file = writeFile("benchmark.tle", content);
+    sgp4::Propagator propagator(sgp4::readFile(file, kepler::Format::TLE));
+
+    std::vector<double> times;
+    for (int i = 0; i < 16; i++) {
+        times.push_back(propagator.elements(0).epoch + i * 600.0);
+    }
+    std::vector<sgp4::Propagator::State> states(times.size() * propagator.size());
+
+    BENCHMARK("Single thread") {
+        propagator.propagate(times, states, 1);
+        return states.back().position.x;
+    };
+
+    BENCHMARK("All threads") {
+        propagator.propagate(times, states, std::thread::hardware_concurrency());
+        return states.back().position.x;
+    };
+}
+
+#endif // OPENSPACE_MODULE_SPACE_ENABLED
@@ -0,0 +1,174 @@
+/*****************************************************************************************
+ *                                                                                       *
+ * OpenSpace                                                                             *
+ *                                                                                       *
+ * Copyright (c) 2014-2023                                                               *
+ *                                                                                       *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this  *
+ * software and associated documentation files (the "Software"), to deal in the Software *
+ * without restriction, including without limitation the rights to use, copy, modify,    *
+ * merge, publish, distribute, sublicense, and/or sell copies of the Software, and to    *
+ * permit persons to whom the Software is furnished to do so, subject to the following   *
+ * conditions:                                                                           *
+ *                                                                                       *
+ * The above copyright notice and this permission notice shall be included in all copies *
+ * or substantial portions of the Software.                                              *
+ *                                                                                       *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,   *
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A         *
+ * PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT    *
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF  *
+ * CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE  *
+ * OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                                         *
+ ****************************************************************************************/
+
+
+#include <catch2/catch_test_macros.hpp>
+
+#include <openspace/json.h>
+#include <openspace/util/startuptrace.h>
+#include <filesystem>
+#include <fstream>
+#include <thread>
+
+using namespace openspace;
+
+namespace {
+    using Phase = StartupTrace::Phase;
+
+    // Makes sure that consecutive events have distinct timestamps
+    void tick() {
+        std::this_thread::sleep_for(std::chrono::milliseconds(2));
+    }
+} // namespace
+
+TEST_CASE("StartupTrace: Empty", "[startuptrace]") {
+    StartupTrace trace;
+    CHECK(trace.criticalPath().empty());
+    CHECK(trace.duration() == StartupTrace::Clock::duration::zero());
+}
+
+TEST_CASE("StartupTrace: Critical Path", "[startuptrace]") {
+    // 'a' requires 'b' and 'c'. The synchronization of 'b' takes the longest, so the
+    // critical path has to go through it
+    StartupTrace trace;
+    trace.addDependency("a", "b");
+    trace.addDependency("a", "c");
+
+    trace.begin("a", Phase::Parse);
+    tick();
+    trace.begin("b", Phase::Parse);
+    tick();
+    trace.end("b", Phase::Parse);
+    trace.begin("b", Phase::Synchronize);
+    tick();
+    trace.begin("c", Phase::Parse);
+    tick();
+    trace.end("c", Phase::Parse);
+    trace.begin("c", Phase::Synchronize);
+    tick();
+    trace.end("a", Phase::Parse);
+    trace.begin("a", Phase::Synchronize);
+    tick();
+    trace.end("c", Phase::Synchronize);
+    tick();
+    trace.end("b", Phase::Synchronize);
+    tick();
+    trace.end("a", Phase::Synchronize);
+    trace.begin("a", Phase::Initialize);
+    tick();
+    trace.end("a", Phase::Initialize);
+
+    std::vector<StartupTrace::Segment> path = trace.criticalPath();
+    REQUIRE(path.size() == 4);
+    CHECK(path[0].item == "b");
+    CHECK(path[0].phase == Phase::Parse);
+    CHECK(path[1].item == "b");
+    CHECK(path[1].phase == Phase::Synchronize);
+    CHECK(path[2].item == "a");
+    CHECK(path[2].phase == Phase::Synchronize);
+    CHECK(path[3].item == "a");
+    CHECK(path[3].phase == Phase::Initialize);
+
+    for (const StartupTrace::Segment& s : path) {
+        CHECK(s.begin <= s.end);
+    }
+    CHECK(trace.duration() == path.back().end);
+}
+
+TEST_CASE("StartupTrace: Earliest Begin Latest End", "[startuptrace]") {
+    StartupTrace trace;
+    trace.begin("a", Phase::Synchronize);
+    tick();
+    trace.begin("a", Phase::Synchronize);
+    trace.end("a", Phase::Synchronize);
+    tick();
+    trace.end("a", Phase::Synchronize);
+
+    std::vector<StartupTrace::Segment> path = trace.criticalPath();
+    REQUIRE(path.size() == 1);
+    CHECK(path[0].end - path[0].begin >= std::chrono::milliseconds(4));
+}
+
+TEST_CASE("StartupTrace: Nodes", "[startuptrace]") {
+    StartupTrace trace;
+
+    trace.setActiveItem("a");
+    trace.addNode("NodeA");
+    trace.setActiveItem("");
+    trace.addNode("NodeWithoutAsset");
+
+    trace.beginNode("NodeWithoutAsset", Phase::Initialize);
+    trace.endNode("NodeWithoutAsset", Phase::Initialize);
+    CHECK(trace.criticalPath().empty());
+
+    trace.beginNode("NodeA", Phase::InitializeGL);
+    tick();
+    trace.endNode("NodeA", Phase::InitializeGL);
+
+    std::vector<StartupTrace::Segment> path = trace.criticalPath();
+    REQUIRE(path.size() == 1);
+    CHECK(path[0].item == "a");
+    CHECK(path[0].phase == Phase::InitializeGL);
+}
+
+TEST_CASE("StartupTrace: Save", "[startuptrace]") {
+    StartupTrace trace;
+    trace.addDependency("a", "b");
+    trace.begin("b", Phase::Parse);
+    trace.end("b", Phase::Parse);
+    trace.begin("a", Phase::Parse);
+    trace.end("a", Phase::Parse);
+    trace.end("a", Phase::Synchronize);
+
+    const std::filesystem::path file =
+        std::filesystem::temp_directory_path() / "test_startuptrace.json";
+    trace.save(file);
+
+    std::ifstream f(file);
+    const nlohmann::json json = nlohmann::json::parse(f);
+    f.close();
+    std::filesystem::remove(file);
+
+    REQUIRE(json.contains("traceEvents"));
+    int nSegments = 0;
+    int nCriticalSegments = 0;
+    bool hasCriticalPathTrack = false;
+    for (const nlohmann::json& event : json["traceEvents"]) {
+        if (event["ph"] == "X") {
+            nSegments++;
+            if (event["tid"] == 0) {
+                nCriticalSegments++;
+            }
+        }
+        else if (event["name"] == "thread_name" &&
+                 event["args"]["name"] == "Critical path")
+        {
+            hasCriticalPathTrack = true;
+        }
+    }
+    CHECK(hasCriticalPathTrack);
+    // Three phases for the two items plus the two phases of 'a' on the critical path
+    CHECK(nSegments == 5);
+    CHECK(nCriticalSegments == 2);
+}
@@ -0,0 +1,242 @@
+/*****************************************************************************************
+ *                                                                                       *
+ * OpenSpace                                                                             *
+ *                                                                                       *
+ * Copyright (c) 2014-2023                                                               *
+ *                                                                                       *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this  *
+ * software and associated documentation files (the "Software"), to deal in the Software *
+ * without restriction, including without limitation the rights to use, copy, modify,    *
+ * merge, publish, distribute, sublicense, and/or sell copies of the Software, and to    *
+ * permit persons to whom the Software is furnished to do so, subject to the following   *
+ * conditions:                                                                           *
+ *                                                                                       *
+ * The above copyright notice and this permission notice shall be included in all copies *
+ * or substantial portions of the Software.                                              *
+ *                                                                                       *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,   *
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A         *
+ * PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT    *
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF  *
+ * CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE  *
+ * OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                                         *
+ ****************************************************************************************/
+
+
+#include <catch2/catch_test_macros.hpp>
+
+#include <openspace/util/taskgraph.h>
+#include <algorithm>
+#include <mutex>
+#include <stdexcept>
+#include <thread>
+
+using namespace openspace;
+
+namespace {
+    // Records the order in which the tasks are performed and how many of them are
+    // running at the same time
+    struct Recorder {
+        std::mutex mutex;
+        std::vector<std::string> started;
+        std::vector<std::string> finished;
+        int nRunning = 0;
+        int maxRunning = 0;
+        // Set if any task was running at the same time as a task that is not thread-safe
+        bool hasOverlappedExclusive = false;
+        bool isRunningExclusive = false;
+    };
+
+    class TestTask : public Task {
+    public:
+        TestTask(std::string name, Recorder& recorder, bool shouldFail = false,
+                 bool isThreadSafe = true)
+            : _name(std::move(name))
+            , _recorder(recorder)
+            , _shouldFail(shouldFail)
+            , _isThreadSafe(isThreadSafe)
+        {}
+
+        void perform(const ProgressCallback& onProgress) override {
+            {
+                std::lock_guard lock(_recorder.mutex);
+                _recorder.started.push_back(_name);
+                _recorder.nRunning++;
+                _recorder.maxRunning = std::max(_recorder.maxRunning, _recorder.nRunning);
+                if (_recorder.isRunningExclusive ||
+                    (!_isThreadSafe && _recorder.nRunning > 1))
+                {
+                    _recorder.hasOverlappedExclusive = true;
+                }
+                if (!_isThreadSafe) {
+                    _recorder.isRunningExclusive = true;
+                }
+            }
+
+            onProgress(0.5f);
+            std::this_thread::sleep_for(std::chrono::milliseconds(20));
+
+            {
+                std::lock_guard lock(_recorder.mutex);
+                _recorder.finished.push_back(_name);
+                _recorder.nRunning--;
+                if (!_isThreadSafe) {
+                    _recorder.isRunningExclusive = false;
+                }
+            }
+            if (_shouldFail) {
+                throw std::runtime_error("Failure in " + _name);
+            }
+            onProgress(1.f);
+        }
+
+        std::string description() override {
+            return _name;
+        }
+
+        bool isThreadSafe() const override {
+            return _isThreadSafe;
+        }
+
+    private:
+        std::string _name;
+        Recorder& _recorder;
+        bool _shouldFail;
+        bool _isThreadSafe;
+    };
+
+    size_t indexOf(const std::vector<std::string>& v, const std::string& s) {
+        return std::find(v.begin(), v.end(), s) - v.begin();
+    }
+} // namespace
+
+TEST_CASE("TaskGraph: Empty", "[taskgraph]") {
+    TaskGraph graph;
+    CHECK(graph.perform(4).empty());
+}
+
+TEST_CASE("TaskGraph: Independent Tasks", "[taskgraph]") {
+    Recorder recorder;
+    TaskGraph graph;
+    for (int i = 0; i < 8; i++) {
+        graph.addTask(std::make_unique<TestTask>(std::to_string(i), recorder));
+    }
+
+    std::vector<float> progress;
+    std::vector<TaskGraph::Result> results = graph.perform(
+        4,
+        [&progress](float p) { progress.push_back(p); }
+    );
+
+    REQUIRE(results.size() == 8);
+    for (size_t i = 0; i < results.size(); i++) {
+        CHECK(results[i].description == std::to_string(i));
+        CHECK(results[i].status == TaskGraph::Status::Succeeded);
+        CHECK(results[i].error.empty());
+        CHECK(results[i].duration.count() > 0.0);
+    }
+    CHECK(recorder.maxRunning > 1);
+    CHECK(recorder.maxRunning <= 4);
+    REQUIRE_FALSE(progress.empty());
+    CHECK(progress.back() == 1.f);
+}
+
+TEST_CASE("TaskGraph: Dependencies", "[taskgraph]") {
+    Recorder recorder;
+    TaskGraph graph;
+    const size_t a = graph.addTask(std::make_unique<TestTask>("a", recorder));
+    const size_t b = graph.addTask(std::make_unique<TestTask>("b", recorder));
+    const size_t c = graph.addTask(std::make_unique<TestTask>("c", recorder));
+    const size_t d = graph.addTask(std::make_unique<TestTask>("d", recorder));
+    // d -> b, c -> a
+    graph.addDependency(b, a);
+    graph.addDependency(c, a);
+    graph.addDependency(d, b);
+    graph.addDependency(d, c);
+    graph.addDependency(d, c);
+    CHECK(graph.dependencies(d).size() == 2);
+
+    std::vector<TaskGraph::Result> results = graph.perform(4);
+    for (const TaskGraph::Result& res : results) {
+        CHECK(res.status == TaskGraph::Status::Succeeded);
+    }
+
+    // b and c can only start after a has finished and d only after both of them
+    const std::vector<std::string>& s = recorder.started;
+    const std::vector<std::string>& f = recorder.finished;
+    REQUIRE(s.size() == 4);
+    CHECK(s.front() == "a");
+    CHECK(s.back() == "d");
+    CHECK(indexOf(f, "a") < indexOf(s, "b"));
+    CHECK(indexOf(f, "b") < indexOf(s, "d"));
+    CHECK(indexOf(f, "c") < indexOf(s, "d"));
+}
+
+TEST_CASE("TaskGraph: Failure Isolation", "[taskgraph]") {
+    Recorder recorder;
+    TaskGraph graph;
+    const size_t a = graph.addTask(std::make_unique<TestTask>("a", recorder, true));
+    const size_t b = graph.addTask(std::make_unique<TestTask>("b", recorder));
+    const size_t c = graph.addTask(std::make_unique<TestTask>("c", recorder));
+    const size_t d = graph.addTask(std::make_unique<TestTask>("d", recorder));
+    // c depends on the failing a, d depends on c, b is independent
+    graph.addDependency(c, a);
+    graph.addDependency(d, c);
+
+    std::vector<TaskGraph::Result> results = graph.perform(2);
+    CHECK(results[a].status == TaskGraph::Status::Failed);
+    CHECK(results[a].error == "Failure in a");
+    CHECK(results[b].status == TaskGraph::Status::Succeeded);
+    CHECK(results[c].status == TaskGraph::Status::Skipped);
+    CHECK(results[d].status == TaskGraph::Status::Skipped);
+    CHECK(indexOf(recorder.started, "c") == recorder.started.size());
+    CHECK(indexOf(recorder.started, "d") == recorder.started.size());
+}
+
+TEST_CASE("TaskGraph: Cycle", "[taskgraph]") {
+    Recorder recorder;
+    TaskGraph graph;
+    const size_t a = graph.addTask(std::make_unique<TestTask>("a", recorder));
+    const size_t b = graph.addTask(std::make_unique<TestTask>("b", recorder));
+    const size_t c = graph.addTask(std::make_unique<TestTask>("c", recorder));
+    graph.addDependency(b, c);
+    graph.addDependency(c, b);
+
+    std::vector<TaskGraph::Result> results = graph.perform(2);
+    CHECK(results[a].status == TaskGraph::Status::Succeeded);
+    CHECK(results[b].status == TaskGraph::Status::Skipped);
+    CHECK(results[c].status == TaskGraph::Status::Skipped);
+}
+
+TEST_CASE("TaskGraph: Single Worker", "[taskgraph]") {
+    Recorder recorder;
+    TaskGraph graph;
+    for (int i = 0; i < 4; i++) {
+        graph.addTask(std::make_unique<TestTask>(std::to_string(i), recorder));
+    }
+
+    graph.perform(1);
+    CHECK(recorder.maxRunning == 1);
+    const std::vector<std::string> expected = { "0", "1", "2", "3" };
+    CHECK(recorder.started == expected);
+}
+
+TEST_CASE("TaskGraph: Not Thread-Safe Tasks", "[taskgraph]") {
+    Recorder recorder;
+    TaskGraph graph;
+    for (int i = 0; i < 8; i++) {
+        // Every third task is not thread-safe
+        const bool isThreadSafe = i % 3 != 0;
+        graph.addTask(
+            std::make_unique<TestTask>(std::to_string(i), recorder, false, isThreadSafe)
+        );
+    }
+
+    std::vector<TaskGraph::Result> results = graph.perform(4);
+    for (const TaskGraph::Result& res : results) {
+        CHECK(res.status == TaskGraph::Status::Succeeded);
+    }
+    CHECK(recorder.started.size() == 8);
+    CHECK(recorder.maxRunning > 1);
+    CHECK_FALSE(recorder.hasOverlappedExclusive);
+}
@@ -0,0 +1,248 @@
+/*****************************************************************************************
+ *                                                                                       *
+ * OpenSpace                                                                             *
+ *                                                                                       *
+ * Copyright (c) 2014-2023                                                               *
+ *                                                                                       *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this  *
+ * software and associated documentation files (the "Software"), to deal in the Software *
+ * without restriction, including without limitation the rights to use, copy, modify,    *
+ * merge, publish, distribute, sublicense, and/or sell copies of the Software, and to    *
+ * permit persons to whom the Software is furnished to do so, subject to the following   *
+ * conditions:                                                                           *
+ *                                                                                       *
+ * The above copyright notice and this permission notice shall be included in all copies *
+ * or substantial portions of the Software.                                              *
+ *                                                                                       *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,   *
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A         *
+ * PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT    *
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF  *
+ * CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE  *
+ * OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                                         *
+ ****************************************************************************************/
+
+
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/benchmark/catch_benchmark.hpp>
+
+#include <modules/base/rendering/trajectorysampler.h>
+#include <algorithm>
+#include <cmath>
+#include <filesystem>
+#include <fstream>
+#include <limits>
+#include <string>
+
+using namespace openspace;
+
+namespace {
+    using Samples = std::vector<TrajectorySampler::Sample>;
+
+    Samples sample(const TrajectorySampler::Settings& settings,
+                   TrajectorySampler::PositionFunction position)
+    {
+        TrajectorySampler sampler(settings, std::move(position));
+        while (!sampler.step(100)) {}
+        return sampler.samples();
+    }
+
+    glm::dvec3 circle(double t) {
+        return glm::dvec3(std::cos(t), std::sin(t), 0.0) * 1e7;
+    }
+
+    // A hyperbolic flyby past the origin with a closest approach of 1000 km, which
+    // consists of two long straight parts and a sharp turn
+    glm::dvec3 flyby(double t) {
+        const double x = t * 10000.0;
+        return glm::dvec3(x, std::sqrt(x * x + 1e12), 0.0);
+    }
+
+    // The largest distance between the trajectory and the line segments between the
+    // samples, checked at a few points within each segment
+    double maximumError(const Samples& samples,
+                        const TrajectorySampler::PositionFunction& position)
+    {
+        double error = 0.0;
+        for (size_t i = 0; i + 1 < samples.size(); ++i) {
+            const TrajectorySampler::Sample& a = samples[i];
+            const TrajectorySampler::Sample& b = samples[i + 1];
+            const glm::dvec3 chord = b.position - a.position;
+            const double length2 = glm::dot(chord, chord);
+            for (double f : { 0.25, 0.5, 0.75 }) {
+                const glm::dvec3 offset =
+                    position(a.time + f * (b.time - a.time)) - a.position;
+                const double s = length2 > 0.0 ?
+                    std::clamp(glm::dot(offset, chord) / length2, 0.0, 1.0) :
+                    0.0;
+                error = std::max(error, glm::length(offset - s * chord));
+            }
+        }
+        return error;
+    }
+} // namespace
+
+TEST_CASE("TrajectorySampler: Uniform", "[trajectorysampler]") {
+    TrajectorySampler::Settings settings;
+    settings.start = 0.0;
+    settings.end = 10.0;
+    settings.minimumInterval = 3.0;
+    settings.isAdaptive = false;
+
+    const Samples samples = sample(settings, circle);
+    REQUIRE(samples.size() == 5);
+    CHECK(samples[0].time == 0.0);
+    CHECK(samples[1].time == 3.0);
+    CHECK(samples[3].time == 9.0);
+    CHECK(samples[4].time == 10.0);
+    CHECK(samples[4].position == circle(10.0));
+}
+
+TEST_CASE("TrajectorySampler: Uniform Maximum Samples", "[trajectorysampler]") {
+    TrajectorySampler::Settings settings;
+    settings.start = 0.0;
+    settings.end = 1000.0;
+    settings.minimumInterval = 1.0;
+    settings.isAdaptive = false;
+    settings.maximumSamples = 100;
+
+    const Samples samples = sample(settings, circle);
+    REQUIRE(samples.size() == 101);
+    CHECK(samples[1].time == 10.0);
+    CHECK(samples.back().time == 1000.0);
+}
+
+TEST_CASE("TrajectorySampler: Straight Line", "[trajectorysampler]") {
+    TrajectorySampler::Settings settings;
+    settings.start = -1e6;
+    settings.end = 1e6;
+    settings.minimumInterval = 1.0;
+
+    TrajectorySampler sampler(settings, [](double t) { return glm::dvec3(t, 2.0, 3.0); });
+    while (!sampler.step(1000)) {}
+
+    // The coarse grid is not refined, but each of its segments had to be tested once
+    constexpr size_t N = TrajectorySampler::InitialSegments;
+    CHECK(sampler.samples().size() == N + 1);
+    CHECK(sampler.nEvaluations() == 2 * N + 1);
+}
+
+TEST_CASE("TrajectorySampler: Adaptive Error", "[trajectorysampler]") {
+    TrajectorySampler::Settings settings;
+    settings.start = 0.0;
+    settings.end = 20.0;
+    settings.minimumInterval = 1e-6;
+    settings.maximumError = 1e-3;
+
+    TrajectorySampler sampler(settings, circle);
+    CHECK_FALSE(sampler.hasCoarseSamples());
+    CHECK_FALSE(sampler.step(TrajectorySampler::InitialSegments + 1));
+    CHECK(sampler.hasCoarseSamples());
+    CHECK(sampler.samples().size() == TrajectorySampler::InitialSegments + 1);
+
+    // Sampling in small steps has to lead to the same result
+    while (!sampler.step(1)) {}
+    const Samples& samples = sampler.samples();
+    CHECK(samples == sample(settings, circle));
+
+    REQUIRE(samples.size() > TrajectorySampler::InitialSegments + 1);
+    CHECK(samples.front().time == 0.0);
+    CHECK(samples.back().time == 20.0);
+    for (size_t i = 0; i + 1 < samples.size(); ++i) {
+        REQUIRE(samples[i].time < samples[i + 1].time);
+
+        // The trajectory deviates from each segment by at most the maximum error,
+        // relative to the length of the segment
+        const double length = glm::distance(samples[i].position, samples[i + 1].position);
+        const double error = maximumError({ samples[i], samples[i + 1] }, circle);
+        CHECK(error <= settings.maximumError * length * 1.01);
+    }
+}
+
+TEST_CASE("TrajectorySampler: Adaptive Flyby", "[trajectorysampler]") {
+    TrajectorySampler::Settings settings;
+    settings.start = -1e6;
+    settings.end = 1e6;
+    settings.minimumInterval = 1.0;
+    settings.maximumError = 1e-4;
+
+    const Samples samples = sample(settings, flyby);
+
+    // The samples are concentrated around the closest approach
+    const size_t nNear = std::count_if(
+        samples.begin(),
+        samples.end(),
+        [](const TrajectorySampler::Sample& s) { return std::abs(s.time) < 1000.0; }
+    );
+    CHECK(nNear > samples.size() / 4);
+}
+
+TEST_CASE("TrajectorySampler: Cache", "[trajectorysampler]") {
+    const std::filesystem::path path =
+        std::filesystem::temp_directory_path() / "trajectorysampler-test.cache";
+
+    TrajectorySampler::Settings settings;
+    settings.start = 0.0;
+    settings.end = 10.0;
+    const Samples samples = sample(settings, circle);
+    TrajectorySampler::saveCache(path, samples);
+
+    std::optional<Samples> loaded = TrajectorySampler::loadCache(path);
+    REQUIRE(loaded.has_value());
+    CHECK(*loaded == samples);
+
+    std::filesystem::resize_file(path, std::filesystem::file_size(path) - 1);
+    CHECK_FALSE(TrajectorySampler::loadCache(path).has_value());
+
+    std::filesystem::remove(path);
+    CHECK_FALSE(TrajectorySampler::loadCache(path).has_value());
+}
+
+// Run explicitly with:  OpenSpaceTest "[.trajectorysampler-benchmark]"
+// Compares the number of vertices and the sampling time of the uniform sampling with the
+// adaptive sampling of a flyby at the same maximum error. The vertex counts and errors
+// are printed as part of the benchmark names
+TEST_CASE("TrajectorySampler: Benchmark", "[.trajectorysampler-benchmark]") {
+    TrajectorySampler::Settings adaptive;
+    adaptive.start = -1e6;
+    adaptive.end = 1e6;
+    adaptive.minimumInterval = 0.1;
+    adaptive.isAdaptive = true;
+    adaptive.maximumError = 1e-3;
+    const Samples adaptiveSamples = sample(adaptive, flyby);
+    const double adaptiveError = maximumError(adaptiveSamples, flyby);
+
+    // Find the largest interval for which the uniform sampling is at least as accurate
+    // as the adaptive sampling. The error grows with the interval, so we bisect
+    TrajectorySampler::Settings uniform = adaptive;
+    uniform.isAdaptive = false;
+    uniform.maximumSamples = std::numeric_limits<size_t>::max();
+    double accurate = adaptive.minimumInterval;
+    double inaccurate = (adaptive.end - adaptive.start) / 2.0;
+    while (inaccurate - accurate > 1e-3 * accurate) {
+        uniform.minimumInterval = (accurate + inaccurate) / 2.0;
+        if (maximumError(sample(uniform, flyby), flyby) <= adaptiveError) {
+            accurate = uniform.minimumInterval;
+        }
+        else {
+            inaccurate = uniform.minimumInterval;
+        }
+    }
+    uniform.minimumInterval = accurate;
+    const Samples uniformSamples = sample(uniform, flyby);
+    const double uniformError = maximumError(uniformSamples, flyby);
+    REQUIRE(uniformError <= adaptiveError);
+
+    BENCHMARK(
+        "Uniform: " + std::to_string(uniformSamples.size()) + " vertices, " +
+        std::to_string(uniformError) + " m error"
+    ) {
+        return sample(uniform, flyby);
+    };
+    BENCHMARK(
+        "Adaptive: " + std::to_string(adaptiveSamples.size()) + " vertices, " +
+        std::to_string(adaptiveError) + " m error"
+    ) {
+        return sample(adaptive, flyby);
+    };
+}